@@ -1,3 +1,4 @@
+import os
 import re
 
 from ddtrace.internal.logger import get_logger
@@ -14,6 +15,11 @@ from .sql_sensitive_analyzer import sql_sensitive_analyzer
 from .url_sensitive_analyzer import url_sensitive_analyzer
 
 
+try:
+    from .._taint_tracking._native import redaction as _native_redaction  # type: ignore[attr-defined]
+except ImportError:
+    _native_redaction = None
+
 log = get_logger(__name__)
 
 REDACTED_SOURCE_BUFFER = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
@@ -28,6 +34,16 @@ class SensitiveHandler:
         self._name_pattern = re.compile(asm_config._iast_redaction_name_pattern, re.IGNORECASE | re.MULTILINE)
         self._value_pattern = re.compile(asm_config._iast_redaction_value_pattern, re.IGNORECASE | re.MULTILINE)
 
+        # The native prescreen is a single-pass scan for the literal anchors of the
+        # *default* patterns ("no anchor" implies "no regex match"), so it is only
+        # sound while the default patterns are in use; any custom pattern -- via
+        # environment or set_redaction_patterns -- falls back to pure regexes.
+        self._native_prescreen = (
+            _native_redaction is not None
+            and "DD_IAST_REDACTION_NAME_PATTERN" not in os.environ
+            and "DD_IAST_REDACTION_VALUE_PATTERN" not in os.environ
+        )
+
         self._sensitive_analyzers = {
             VULN_CMDI: command_injection_sensitive_analyzer,
             VULN_SQL_INJECTION: sql_sensitive_analyzer,
@@ -100,6 +116,8 @@ class SensitiveHandler:
         Returns:
         - bool: True if the name is sensible, False otherwise.
         """
+        if self._native_prescreen and not _native_redaction.has_name_candidate(name):
+            return False
         return bool(self._name_pattern.search(name))
 
     def is_sensible_value(self, value):
@@ -112,6 +130,8 @@ class SensitiveHandler:
         Returns:
         - bool: True if the value is sensible, False otherwise.
         """
+        if self._native_prescreen and not _native_redaction.has_value_candidate(value):
+            return False
         return bool(self._value_pattern.search(value))
 
     def is_sensible_source(self, source):
@@ -350,6 +370,10 @@ class SensitiveHandler:
             value_parts.append({"redacted": True})
 
     def set_redaction_patterns(self, redaction_name_pattern=None, redaction_value_pattern=None):
+        if redaction_name_pattern or redaction_value_pattern:
+            # Custom patterns invalidate the default-pattern anchors the native
+            # prescreen matches against
+            self._native_prescreen = False
         if redaction_name_pattern:
             try:
                 self._name_pattern = re.compile(redaction_name_pattern, re.IGNORECASE | re.MULTILINE)
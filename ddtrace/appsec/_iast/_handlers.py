@@ -296,17 +296,20 @@ def _on_grpc_response(message):
 def if_iast_taint_yield_tuple_for(origins, wrapped, instance, args, kwargs):
     if _is_iast_enabled():
         from ._iast_request_context import is_iast_request_enabled
-        from ._taint_tracking import taint_pyobject
+        from ._taint_tracking import taint_pyobject_batch
 
         if not is_iast_request_enabled():
             for key, value in wrapped(*args, **kwargs):
                 yield key, value
         else:
-            for key, value in wrapped(*args, **kwargs):
-                new_key = taint_pyobject(pyobject=key, source_name=key, source_value=key, source_origin=origins[0])
-                new_value = taint_pyobject(
-                    pyobject=value, source_name=key, source_value=value, source_origin=origins[1]
-                )
+            items = list(wrapped(*args, **kwargs))
+            keys = [key for key, _ in items]
+            values = [value for _, value in items]
+            # Two native passes for the whole dict (keys, then values)
+            # instead of two map transactions per entry
+            new_keys = taint_pyobject_batch(keys, keys, keys, origins[0])
+            new_values = taint_pyobject_batch(values, keys, values, origins[1])
+            for new_key, new_value in zip(new_keys, new_values):
                 yield new_key, new_value
 
     else:
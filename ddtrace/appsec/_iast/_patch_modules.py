@@ -25,3 +25,7 @@ def patch_iast(patch_modules=IAST_PATCH):
     when_imported("json")(
         _on_import_factory("json_tainting", prefix="ddtrace.appsec._iast._patches", raise_errors=False)
     )
+
+    when_imported("pathlib")(
+        _on_import_factory("pathlib_tainting", prefix="ddtrace.appsec._iast._patches", raise_errors=False)
+    )
@@ -52,7 +52,13 @@ def wrapped_loads(wrapped, instance, args, kwargs):
             try:
                 # take the first source as main source
                 source = ranges[0].source
-                if isinstance(obj, dict):
+                if isinstance(obj, (dict, list)) and isinstance(args[0], str):
+                    # Native pass: maps each extracted string back to its
+                    # span in the document and bulk-taints, no tree walk
+                    from .._taint_tracking import _json_taint_loads
+
+                    obj = _json_taint_loads(obj, args[0])
+                elif isinstance(obj, dict):
                     obj = taint_structure(obj, source.origin, source.origin)
                 elif isinstance(obj, list):
                     obj = taint_structure(obj, source.origin, source.origin)
@@ -0,0 +1,154 @@
+import os
+import pathlib
+import sys
+from typing import Text
+
+from ddtrace.appsec._common_module_patches import try_unwrap
+from ddtrace.internal.logger import get_logger
+from ddtrace.settings.asm import config as asm_config
+
+from .._iast_request_context import is_iast_request_enabled
+from .._patch import set_and_check_module_is_patched
+from .._patch import set_module_unpatched
+from .._patch import try_wrap_function_wrapper
+
+
+log = get_logger(__name__)
+
+
+_DEFAULT_ATTR = "_datadog_pathlib_tainting_patch"
+
+# Accessors whose result is a contiguous piece of str(path): True when the
+# piece sits at the tail of the path (name, suffix), False when it is a
+# prefix (parent).
+_PROPERTY_SPANS = {"name": True, "suffix": True, "parent": False}
+_original_properties = {}
+
+
+def get_version() -> Text:
+    return ""
+
+
+def unpatch_iast():
+    set_module_unpatched("pathlib", default_attr=_DEFAULT_ATTR)
+    if sys.version_info >= (3, 12):
+        try_unwrap("pathlib", "PurePath.__str__")
+    else:
+        try_unwrap("pathlib", "PurePath._from_parts")
+        try_unwrap("pathlib", "PurePath.joinpath")
+        try_unwrap("pathlib", "PurePath.__truediv__")
+        try_unwrap("pathlib", "PurePath.__rtruediv__")
+    for prop_name, original in _original_properties.items():
+        setattr(pathlib.PurePath, prop_name, original)
+    _original_properties.clear()
+
+
+def patch():
+    """Propagate taint through pathlib.PurePath construction, joins and accessors.
+
+    pathlib rebuilds its strings from parsed parts, so taint on the input
+    dies at the first Path() without these hooks. The native aspect family
+    (_pathlib_taint_joined / _pathlib_taint_part) re-attaches the ranges to
+    the string pathlib caches on the instance, so later str()/os.fspath()
+    conversions stay tainted.
+    """
+    if not set_and_check_module_is_patched("pathlib", default_attr=_DEFAULT_ATTR):
+        return
+    if sys.version_info >= (3, 12):
+        # 3.12 keeps the original argument strings in _raw_paths and only
+        # joins them when the string form is first materialized, so one hook
+        # on __str__ covers construction, joinpath and the / operators
+        try_wrap_function_wrapper("pathlib", "PurePath.__str__", wrapped_str)
+    else:
+        # Older versions parse eagerly in _from_parts and build join results
+        # without re-entering it, so the join family needs its own hooks
+        try_wrap_function_wrapper("pathlib", "PurePath._from_parts", wrapped_from_parts)
+        try_wrap_function_wrapper("pathlib", "PurePath.joinpath", wrapped_joinpath)
+        try_wrap_function_wrapper("pathlib", "PurePath.__truediv__", wrapped_truediv)
+        try_wrap_function_wrapper("pathlib", "PurePath.__rtruediv__", wrapped_rtruediv)
+    for prop_name, from_end in _PROPERTY_SPANS.items():
+        original = getattr(pathlib.PurePath, prop_name, None)
+        if isinstance(original, property):
+            _original_properties[prop_name] = original
+            setattr(pathlib.PurePath, prop_name, property(_tainting_fget(original.fget, from_end)))
+
+
+def _as_text(part):
+    if isinstance(part, str):
+        return part
+    try:
+        return os.fspath(part)
+    except TypeError:
+        return part
+
+
+def _taint_path(path, parts):
+    if not (asm_config._iast_enabled and is_iast_request_enabled()):
+        return
+    try:
+        from .._taint_tracking import _pathlib_taint_joined
+
+        # str(path) caches its result on the instance, so tainting the
+        # string it returns taints every later conversion of this path.
+        # Path arguments hand over their own (tainted) cached string.
+        _pathlib_taint_joined(str(path), tuple(_as_text(part) for part in parts))
+    except Exception:  # nosec
+        log.debug("Unexpected exception while tainting pathlib path", exc_info=True)
+
+
+def wrapped_str(wrapped, instance, args, kwargs):
+    result = wrapped(*args, **kwargs)
+    if asm_config._iast_enabled and is_iast_request_enabled():
+        try:
+            from .._taint_tracking import _pathlib_taint_joined
+
+            raw_paths = getattr(instance, "_raw_paths", None)
+            if raw_paths:
+                _pathlib_taint_joined(result, tuple(raw_paths))
+        except Exception:  # nosec
+            log.debug("Unexpected exception while tainting pathlib path", exc_info=True)
+    return result
+
+
+def wrapped_from_parts(wrapped, instance, args, kwargs):
+    result = wrapped(*args, **kwargs)
+    if args:
+        _taint_path(result, tuple(args[0]))
+    return result
+
+
+def wrapped_joinpath(wrapped, instance, args, kwargs):
+    result = wrapped(*args, **kwargs)
+    _taint_path(result, (instance,) + args)
+    return result
+
+
+def wrapped_truediv(wrapped, instance, args, kwargs):
+    result = wrapped(*args, **kwargs)
+    if isinstance(result, pathlib.PurePath):
+        _taint_path(result, (instance,) + args)
+    return result
+
+
+def wrapped_rtruediv(wrapped, instance, args, kwargs):
+    result = wrapped(*args, **kwargs)
+    if isinstance(result, pathlib.PurePath):
+        _taint_path(result, args + (instance,))
+    return result
+
+
+def _tainting_fget(fget, from_end):
+    def tainted_fget(self):
+        result = fget(self)
+        if asm_config._iast_enabled and is_iast_request_enabled():
+            try:
+                from .._taint_tracking import _pathlib_taint_part
+
+                target = result if isinstance(result, str) else str(result)
+                if target:
+                    _pathlib_taint_part(target, str(self), from_end)
+            except Exception:  # nosec
+                log.debug("Unexpected exception while tainting pathlib accessor", exc_info=True)
+        return result
+
+    return tainted_fget
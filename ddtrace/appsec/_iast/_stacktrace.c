@@ -1,6 +1,8 @@
 #include <Python.h>
 #include <frameobject.h>
 #include <patchlevel.h>
+#include <stdint.h>
+#include <string.h>
 
 #ifdef _WIN32
 #define DD_TRACE_INSTALLED_PREFIX "\\ddtrace\\"
@@ -17,27 +19,21 @@
 #define GET_LINENO(frame) PyFrame_GetLineNumber((PyFrameObject*)frame)
 #define GET_FRAME(tstate) PyThreadState_GetFrame(tstate)
 #define GET_PREVIOUS(frame) PyFrame_GetBack(frame)
+#define GET_CODE(frame) PyFrame_GetCode(frame)
+#define CODE_DECREF(code) Py_DecRef((PyObject*)(code))
+#define CODE_FILENAME(code) PyObject_GetAttrString((PyObject*)(code), "co_filename")
 #define FRAME_DECREF(frame) Py_DecRef(frame)
 #define FRAME_XDECREF(frame) Py_XDECREF(frame)
 #define FILENAME_DECREF(filename) Py_DecRef(filename)
 #define FILENAME_XDECREF(filename)                                                                                     \
     if (filename)                                                                                                      \
     Py_DecRef(filename)
-static inline PyObject*
-GET_FILENAME(PyFrameObject* frame)
-{
-    PyCodeObject* code = PyFrame_GetCode(frame);
-    if (!code) {
-        return NULL;
-    }
-    PyObject* filename = PyObject_GetAttrString((PyObject*)code, "co_filename");
-    Py_DecRef(code);
-    return filename;
-}
 #else
 #define GET_FRAME(tstate) tstate->frame
 #define GET_PREVIOUS(frame) frame->f_back
-#define GET_FILENAME(frame) frame->f_code->co_filename
+#define GET_CODE(frame) (frame->f_code)
+#define CODE_DECREF(code)
+#define CODE_FILENAME(code) ((code)->co_filename)
 #define FRAME_DECREF(frame)
 #define FRAME_XDECREF(frame)
 #define FILENAME_DECREF(filename)
@@ -50,6 +46,36 @@ GET_FILENAME(PyFrameObject* frame)
 #endif
 #endif
 
+/*
+ * Per-code-object verdict cache: whether a frame belongs to ddtrace/site-
+ * packages (skip) or is user code (report). Code objects are effectively
+ * immortal for the functions that keep reporting vulnerabilities, so under a
+ * vulnerability storm the repeated walks only pay the filename fetch and the
+ * path comparisons for frames never seen before. Direct-mapped, collisions
+ * just overwrite; the whole cache is dropped when the cwd argument changes,
+ * since the verdict depends on it.
+ */
+#define FRAME_VERDICT_CACHE_SIZE 256
+#define FRAME_VERDICT_CWD_MAX 4096
+/* Deeper frames than this are never reported; give up instead of walking
+ * pathological (e.g. recursive) stacks to the bottom on every capture */
+#define FRAME_WALK_MAX_DEPTH 128
+
+typedef struct
+{
+    void* code;
+    char skip;
+} frame_verdict_t;
+
+static frame_verdict_t frame_verdict_cache[FRAME_VERDICT_CACHE_SIZE];
+static char frame_verdict_cwd[FRAME_VERDICT_CWD_MAX];
+
+static inline frame_verdict_t*
+frame_verdict_slot(void* code)
+{
+    return &frame_verdict_cache[((uintptr_t)code >> 4) & (FRAME_VERDICT_CACHE_SIZE - 1)];
+}
+
 /**
  * get_file_and_line
  *
@@ -80,22 +106,60 @@ get_file_and_line(PyObject* Py_UNUSED(module), PyObject* cwd_obj)
         goto exit_0;
     }
 
+    /* The cached verdicts are only valid for the cwd they were computed
+       against */
+    if (strncmp(frame_verdict_cwd, cwd, FRAME_VERDICT_CWD_MAX) != 0) {
+        memset(frame_verdict_cache, 0, sizeof(frame_verdict_cache));
+        strncpy(frame_verdict_cwd, cwd, FRAME_VERDICT_CWD_MAX - 1);
+        frame_verdict_cwd[FRAME_VERDICT_CWD_MAX - 1] = '\0';
+    }
+
     PyFrameObject* frame = GET_FRAME(tstate);
     if (!frame) {
         goto exit_0;
     }
 
+    int depth = 0;
     while (NULL != frame) {
-        filename_o = GET_FILENAME(frame);
-        if (!filename_o) {
+        if (++depth > FRAME_WALK_MAX_DEPTH) {
+            break;
+        }
+        PyCodeObject* code = GET_CODE(frame);
+        if (!code) {
             goto exit;
         }
-        const char* filename = PyUnicode_AsUTF8(filename_o);
-        if (((strstr(filename, DD_TRACE_INSTALLED_PREFIX) != NULL && strstr(filename, TESTS_PREFIX) == NULL)) ||
-            (strstr(filename, SITE_PACKAGES_PREFIX) != NULL || strstr(filename, cwd) == NULL)) {
+        frame_verdict_t* slot = frame_verdict_slot(code);
+        int skip_frame;
+        if (slot->code == (void*)code) {
+            skip_frame = slot->skip;
+            if (!skip_frame) {
+                filename_o = CODE_FILENAME(code);
+                if (!filename_o) {
+                    CODE_DECREF(code);
+                    goto exit;
+                }
+            }
+        } else {
+            filename_o = CODE_FILENAME(code);
+            if (!filename_o) {
+                CODE_DECREF(code);
+                goto exit;
+            }
+            const char* filename = PyUnicode_AsUTF8(filename_o);
+            skip_frame =
+              ((strstr(filename, DD_TRACE_INSTALLED_PREFIX) != NULL && strstr(filename, TESTS_PREFIX) == NULL)) ||
+              (strstr(filename, SITE_PACKAGES_PREFIX) != NULL || strstr(filename, cwd) == NULL);
+            slot->code = (void*)code;
+            slot->skip = (char)skip_frame;
+        }
+        CODE_DECREF(code);
+        if (skip_frame) {
+            if (filename_o) {
+                FILENAME_DECREF(filename_o);
+                filename_o = NULL;
+            }
             PyFrameObject* prev_frame = GET_PREVIOUS(frame);
             FRAME_DECREF(frame);
-            FILENAME_DECREF(filename_o);
             frame = prev_frame;
             continue;
         }
@@ -0,0 +1,274 @@
+#include "AspectEncodings.h"
+#include "Initializer/Initializer.h"
+
+#include <vector>
+
+using namespace pybind11::literals;
+
+/**
+ * Offset transcoding for bytes.decode / str.encode taint propagation.
+ *
+ * Byte offsets and character offsets diverge as soon as the data leaves
+ * ASCII, so ranges can't just be copied across a decode or encode. The
+ * Python fallback re-runs an incremental codec one unit at a time to learn
+ * where each range lands, which is orders of magnitude slower than the
+ * conversion itself. These helpers instead remap the range boundaries
+ * through a byte<->character index built in one pass over the data:
+ * checkpoints record the translated offset every INDEX_BLOCK units, and a
+ * boundary is resolved by counting from its checkpoint, so each lookup
+ * touches at most one block regardless of input size.
+ *
+ * Only stateless 1:1 codecs are handled natively: ascii and latin-1 map
+ * offsets identically, and utf-8 (with a pure-ASCII bypass read off the
+ * unicode kind) needs only the index. Everything else -- and any conversion
+ * whose lengths don't reconcile, e.g. a non-strict error handler rewrote
+ * data -- returns false so the caller falls back to the incremental codec.
+ */
+
+namespace {
+
+constexpr Py_ssize_t INDEX_BLOCK = 64;
+
+enum class CodecKind
+{
+    Identity, // one byte per character: ascii, latin-1
+    Utf8,
+    Unsupported,
+};
+
+CodecKind
+classify_codec(const std::string& codec)
+{
+    // Same folding codecs.lookup() applies: case and the -/_/space variants
+    string normalized;
+    normalized.reserve(codec.size());
+    for (const char c : codec) {
+        normalized += (c == '_' || c == ' ') ? '-' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    if (normalized == "utf-8" or normalized == "utf8" or normalized == "u8" or normalized == "cp65001") {
+        return CodecKind::Utf8;
+    }
+    if (normalized == "ascii" or normalized == "us-ascii" or normalized == "646") {
+        return CodecKind::Identity;
+    }
+    if (normalized == "latin-1" or normalized == "latin1" or normalized == "latin" or normalized == "iso-8859-1" or
+        normalized == "iso8859-1" or normalized == "8859" or normalized == "cp819" or normalized == "l1") {
+        return CodecKind::Identity;
+    }
+    return CodecKind::Unsupported;
+}
+
+// Copies the source ranges onto the result unchanged, clipped to its length
+void
+copy_ranges_identity(PyObject* result,
+                     const Py_ssize_t result_len,
+                     const TaintRangeRefs& source_ranges,
+                     const TaintRangeMapTypePtr& tx_map)
+{
+    TaintRangeRefs mapped;
+    mapped.reserve(source_ranges.size());
+    for (const auto& range : source_ranges) {
+        const auto start = std::max(range.start, 0L);
+        const auto end = std::min<RANGE_START>(range.start + range.length, static_cast<RANGE_START>(result_len));
+        if (end > start) {
+            mapped.emplace_back(start, end - start, range.source);
+        }
+    }
+    if (not mapped.empty()) {
+        set_ranges(result, mapped, tx_map);
+    }
+}
+
+inline bool
+is_utf8_lead(const unsigned char byte)
+{
+    return (byte & 0xC0U) != 0x80U;
+}
+
+inline Py_ssize_t
+utf8_width(const Py_UCS4 codepoint)
+{
+    return codepoint < 0x80 ? 1 : codepoint < 0x800 ? 2 : codepoint < 0x10000 ? 3 : 4;
+}
+
+} // namespace
+
+bool
+api_remap_ranges_decoded(const py::handle& result, const py::handle& source, const std::string& codec)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not PyUnicode_Check(result.ptr())) {
+        return false;
+    }
+    const char* data;
+    Py_ssize_t nbytes;
+    if (PyBytes_Check(source.ptr())) {
+        data = PyBytes_AS_STRING(source.ptr());
+        nbytes = PyBytes_GET_SIZE(source.ptr());
+    } else if (PyByteArray_Check(source.ptr())) {
+        data = PyByteArray_AS_STRING(source.ptr());
+        nbytes = PyByteArray_GET_SIZE(source.ptr());
+    } else {
+        return false;
+    }
+    const auto codec_kind = classify_codec(codec);
+    if (codec_kind == CodecKind::Unsupported) {
+        return false;
+    }
+
+    const auto [source_ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error) {
+        return false;
+    }
+    if (source_ranges.empty()) {
+        return true; // handled: there is nothing to remap
+    }
+
+    const Py_ssize_t result_len = PyUnicode_GET_LENGTH(result.ptr());
+    if (codec_kind == CodecKind::Identity or (PyUnicode_IS_ASCII(result.ptr()) and nbytes == result_len)) {
+        if (nbytes != result_len) {
+            return false;
+        }
+        copy_ranges_identity(result.ptr(), result_len, source_ranges, tx_map);
+        return true;
+    }
+
+    // Byte -> character index: checkpoints hold the character count at every
+    // INDEX_BLOCK byte boundary, exact resolution counts lead bytes inside
+    // the block. chars(b) = lead bytes in [0, b), which is both the index of
+    // the first character starting at or after b and, at a character
+    // boundary, the count of complete characters before it.
+    std::vector<Py_ssize_t> checkpoints;
+    checkpoints.reserve(static_cast<size_t>(nbytes / INDEX_BLOCK) + 1);
+    Py_ssize_t total_chars = 0;
+    for (Py_ssize_t i = 0; i < nbytes; ++i) {
+        if (i % INDEX_BLOCK == 0) {
+            checkpoints.push_back(total_chars);
+        }
+        total_chars += is_utf8_lead(static_cast<unsigned char>(data[i])) ? 1 : 0;
+    }
+    if (total_chars != result_len) {
+        return false; // a non-strict error handler rewrote the data
+    }
+
+    const auto byte_to_char = [&](const Py_ssize_t byte_pos) -> Py_ssize_t {
+        const auto block = static_cast<size_t>(byte_pos / INDEX_BLOCK);
+        Py_ssize_t chars = checkpoints[block];
+        for (Py_ssize_t i = static_cast<Py_ssize_t>(block) * INDEX_BLOCK; i < byte_pos; ++i) {
+            chars += is_utf8_lead(static_cast<unsigned char>(data[i])) ? 1 : 0;
+        }
+        return chars;
+    };
+
+    TaintRangeRefs mapped;
+    mapped.reserve(source_ranges.size());
+    for (const auto& range : source_ranges) {
+        const Py_ssize_t byte_start = std::max<Py_ssize_t>(range.start, 0);
+        const Py_ssize_t byte_end = std::min<Py_ssize_t>(range.start + range.length, nbytes);
+        if (byte_end <= byte_start) {
+            continue;
+        }
+        const Py_ssize_t char_start = byte_to_char(byte_start);
+        Py_ssize_t char_end = byte_to_char(byte_end);
+        // A range ending mid-character doesn't taint that partial character
+        if (byte_end < nbytes and not is_utf8_lead(static_cast<unsigned char>(data[byte_end]))) {
+            char_end -= 1;
+        }
+        if (char_end > char_start) {
+            mapped.emplace_back(static_cast<RANGE_START>(char_start),
+                                static_cast<RANGE_LENGTH>(char_end - char_start),
+                                range.source);
+        }
+    }
+    if (not mapped.empty()) {
+        set_ranges(result.ptr(), mapped, tx_map);
+    }
+    return true;
+}
+
+bool
+api_remap_ranges_encoded(const py::handle& result, const py::handle& source, const std::string& codec)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not PyUnicode_Check(source.ptr()) or not PyBytes_Check(result.ptr())) {
+        return false;
+    }
+    const auto codec_kind = classify_codec(codec);
+    if (codec_kind == CodecKind::Unsupported) {
+        return false;
+    }
+
+    const auto [source_ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error) {
+        return false;
+    }
+    if (source_ranges.empty()) {
+        return true; // handled: there is nothing to remap
+    }
+
+    const Py_ssize_t nchars = PyUnicode_GET_LENGTH(source.ptr());
+    const Py_ssize_t nbytes = PyBytes_GET_SIZE(result.ptr());
+    if (codec_kind == CodecKind::Identity or (PyUnicode_IS_ASCII(source.ptr()) and nchars == nbytes)) {
+        if (nchars != nbytes) {
+            return false;
+        }
+        copy_ranges_identity(result.ptr(), nbytes, source_ranges, tx_map);
+        return true;
+    }
+
+    // Character -> byte index, mirror of the decode direction: checkpoints
+    // hold the byte offset at every INDEX_BLOCK character boundary, exact
+    // resolution sums utf-8 widths inside the block. Every character
+    // boundary is a byte boundary in the output, so no partials arise.
+    const int kind = PyUnicode_KIND(source.ptr());
+    const void* chars = PyUnicode_DATA(source.ptr());
+    std::vector<Py_ssize_t> checkpoints;
+    checkpoints.reserve(static_cast<size_t>(nchars / INDEX_BLOCK) + 1);
+    Py_ssize_t total_bytes = 0;
+    for (Py_ssize_t i = 0; i < nchars; ++i) {
+        if (i % INDEX_BLOCK == 0) {
+            checkpoints.push_back(total_bytes);
+        }
+        total_bytes += utf8_width(PyUnicode_READ(kind, chars, i));
+    }
+    if (total_bytes != nbytes) {
+        return false; // surrogates or a non-strict error handler interfered
+    }
+
+    const auto char_to_byte = [&](const Py_ssize_t char_pos) -> Py_ssize_t {
+        const auto block = static_cast<size_t>(char_pos / INDEX_BLOCK);
+        Py_ssize_t bytes = checkpoints[block];
+        for (Py_ssize_t i = static_cast<Py_ssize_t>(block) * INDEX_BLOCK; i < char_pos; ++i) {
+            bytes += utf8_width(PyUnicode_READ(kind, chars, i));
+        }
+        return bytes;
+    };
+
+    TaintRangeRefs mapped;
+    mapped.reserve(source_ranges.size());
+    for (const auto& range : source_ranges) {
+        const Py_ssize_t char_start = std::max<Py_ssize_t>(range.start, 0);
+        const Py_ssize_t char_end = std::min<Py_ssize_t>(range.start + range.length, nchars);
+        if (char_end <= char_start) {
+            continue;
+        }
+        const Py_ssize_t byte_start = char_to_byte(char_start);
+        const Py_ssize_t byte_end = char_to_byte(char_end);
+        if (byte_end > byte_start) {
+            mapped.emplace_back(static_cast<RANGE_START>(byte_start),
+                                static_cast<RANGE_LENGTH>(byte_end - byte_start),
+                                range.source);
+        }
+    }
+    if (not mapped.empty()) {
+        set_ranges(result.ptr(), mapped, tx_map);
+    }
+    return true;
+}
+
+void
+pyexport_encodings_aspects(py::module& m)
+{
+    m.def("_remap_ranges_decoded", &api_remap_ranges_decoded, "result"_a, "source"_a, "codec"_a);
+    m.def("_remap_ranges_encoded", &api_remap_ranges_encoded, "result"_a, "source"_a, "codec"_a);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Helpers.h"
+
+bool
+api_remap_ranges_decoded(const py::handle& result, const py::handle& source, const std::string& codec);
+
+bool
+api_remap_ranges_encoded(const py::handle& result, const py::handle& source, const std::string& codec);
+
+void
+pyexport_encodings_aspects(py::module& m);
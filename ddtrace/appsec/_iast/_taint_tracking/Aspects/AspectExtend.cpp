@@ -1,5 +1,6 @@
 #include "AspectExtend.h"
 
+#include "AspectMetrics.h"
 #include "Helpers.h"
 
 /**
@@ -13,6 +14,7 @@
 PyObject*
 api_extend_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::EXTEND);
     if (nargs != 2 or !args) {
         throw py::value_error(MSG_ERROR_N_PARAMS);
     }
@@ -40,7 +42,11 @@ api_extend_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
         }
         Py_DecRef(method_name);
     } else {
-        const auto& to_candidate = get_tainted_object(candidate_text, ctx_map);
+        timer.slow_path();
+        // Non-settling lookup: a deferred-hash entry left by a previous
+        // extend is reused as-is, since it is re-stored deferred right below
+        const auto& to_candidate = ctx_map->get_lazy_hash(
+          get_unique_id(candidate_text), [candidate_text] { return get_internal_hash(candidate_text); }, false);
         auto to_result = initializer->allocate_tainted_object_copy(to_candidate);
         const auto& to_toadd = get_tainted_object(to_add, ctx_map);
 
@@ -60,7 +66,11 @@ api_extend_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
         if (to_toadd) {
             to_result->add_ranges_shifted(to_toadd, (long)len_candidate_text);
         }
-        set_tainted_object(candidate_text, to_result, ctx_map);
+        // Deferred-hash store: re-hashing the bytearray here would cost
+        // O(total length) per extend in a build loop; the hash is settled by
+        // the next lookup that needs to validate the address instead
+        set_fast_tainted_if_bytes(candidate_text);
+        ctx_map->put_deferred_hash(get_unique_id(candidate_text), std::move(to_result));
     }
     Py_RETURN_NONE;
 }
@@ -1,5 +1,217 @@
 #include "Aspects/AspectFormat.h"
 
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/**
+ * Parsed layout of a format string: each segment is a literal piece followed
+ * by the positional argument substituted after it (field == -1 for the
+ * trailing literal with no placeholder).
+ */
+struct FormatSegment
+{
+    py::str literal;
+    int field{ -1 };
+};
+
+struct ParsedFormat
+{
+    // Strong reference: while the entry lives the keyed pointer can't be
+    // reused for a different string
+    py::str fmt;
+    std::vector<FormatSegment> segments;
+    int max_field{ -1 };
+};
+
+// Per-process cache keyed on the format-string object. Code-object constants
+// stay alive (and keep their address) for the process lifetime, so repeated
+// calls with the same literal hit on the pointer alone. Guarded by the GIL.
+constexpr size_t FORMAT_CACHE_MAX_ENTRIES = 512;
+std::unordered_map<PyObject*, ParsedFormat> format_cache; // NOLINT(cert-err58-cpp)
+
+/**
+ * Parses fmt into literal/placeholder segments. Only the simple positional
+ * subset is supported ("{}", "{0}" and the "{{"/"}}" escapes): anything with
+ * a field name, conversion or format spec returns nullopt so the generic
+ * path keeps handling it.
+ */
+std::optional<ParsedFormat> parse_format_string(PyObject* fmt)
+{
+    const auto kind = PyUnicode_KIND(fmt);
+    const void* data = PyUnicode_DATA(fmt);
+    const Py_ssize_t len = PyUnicode_GET_LENGTH(fmt);
+
+    ParsedFormat parsed;
+    parsed.fmt = py::reinterpret_borrow<py::str>(fmt);
+    std::vector<Py_UCS4> literal;
+    int next_auto = 0;
+    bool saw_auto = false;
+    bool saw_manual = false;
+
+    const auto flush_segment = [&](const int field) {
+        FormatSegment segment;
+        segment.literal = py::reinterpret_steal<py::str>(
+          PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, literal.data(), static_cast<Py_ssize_t>(literal.size())));
+        segment.field = field;
+        literal.clear();
+        parsed.segments.emplace_back(std::move(segment));
+    };
+
+    for (Py_ssize_t i = 0; i < len; i++) {
+        const Py_UCS4 ch = PyUnicode_READ(kind, data, i);
+        if (ch == '{') {
+            if (i + 1 < len and PyUnicode_READ(kind, data, i + 1) == '{') {
+                literal.push_back('{');
+                i++;
+                continue;
+            }
+            int field;
+            Py_ssize_t j = i + 1;
+            if (j < len and PyUnicode_READ(kind, data, j) == '}') {
+                // Auto-numbered "{}"
+                field = next_auto++;
+                saw_auto = true;
+            } else {
+                // Manual "{N}": digits only, anything else is unsupported
+                field = 0;
+                while (j < len and PyUnicode_READ(kind, data, j) >= '0' and PyUnicode_READ(kind, data, j) <= '9') {
+                    if (field > 0xFFFF) {
+                        return std::nullopt;
+                    }
+                    field = field * 10 + static_cast<int>(PyUnicode_READ(kind, data, j) - '0');
+                    j++;
+                }
+                if (j == i + 1 or j >= len or PyUnicode_READ(kind, data, j) != '}') {
+                    return std::nullopt;
+                }
+                saw_manual = true;
+            }
+            if (saw_auto and saw_manual) {
+                // Mixing numbering modes raises in str.format, defer to it
+                return std::nullopt;
+            }
+            parsed.max_field = std::max(parsed.max_field, field);
+            flush_segment(field);
+            i = j;
+        } else if (ch == '}') {
+            if (i + 1 < len and PyUnicode_READ(kind, data, i + 1) == '}') {
+                literal.push_back('}');
+                i++;
+                continue;
+            }
+            return std::nullopt;
+        } else {
+            literal.push_back(ch);
+        }
+    }
+    flush_segment(-1);
+    return parsed;
+}
+
+const ParsedFormat* get_cached_format(PyObject* fmt)
+{
+    if (const auto it = format_cache.find(fmt); it != format_cache.end()) {
+        return &it->second;
+    }
+    auto parsed = parse_format_string(fmt);
+    if (not parsed or parsed->segments.empty()) {
+        return nullptr;
+    }
+    if (format_cache.size() >= FORMAT_CACHE_MAX_ENTRIES) {
+        format_cache.clear();
+    }
+    return &format_cache.emplace(fmt, std::move(*parsed)).first->second;
+}
+
+/**
+ * Fast path for the cached layout: pure substitution plus range arithmetic,
+ * with the output buffer sized once from the summed piece lengths. Returns
+ * nullptr (no error set) when the call needs the generic machinery.
+ */
+PyObject* format_fast(PyObject* fmt, PyObject* const* format_args, const Py_ssize_t n_format_args, PyObject* kwnames)
+{
+    if (kwnames != nullptr and PyTuple_GET_SIZE(kwnames) > 0) {
+        return nullptr;
+    }
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty()) {
+        return nullptr;
+    }
+    if (get_tainted_object(fmt, tx_map)) {
+        // A tainted template needs the evidence-escaping remap
+        return nullptr;
+    }
+    const auto* parsed = get_cached_format(fmt);
+    if (parsed == nullptr or parsed->max_field >= n_format_args) {
+        return nullptr;
+    }
+
+    Py_UCS4 max_char = 0;
+    Py_ssize_t total_len = 0;
+    for (const auto& segment : parsed->segments) {
+        if (const Py_ssize_t literal_len = PyUnicode_GET_LENGTH(segment.literal.ptr()); literal_len > 0) {
+            max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(segment.literal.ptr()));
+            total_len += literal_len;
+        }
+        if (segment.field >= 0) {
+            PyObject* arg = format_args[segment.field];
+            if (not PyUnicode_CheckExact(arg)) {
+                // Non-str arguments go through __format__, defer to it
+                return nullptr;
+            }
+            if (const Py_ssize_t arg_len = PyUnicode_GET_LENGTH(arg); arg_len > 0) {
+                max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(arg));
+                total_len += arg_len;
+            }
+        }
+    }
+
+    PyObject* result = PyUnicode_New(total_len, max_char);
+    if (result == nullptr) {
+        return nullptr;
+    }
+
+    TaintedObjectPtr result_to = nullptr;
+    Py_ssize_t current_pos = 0;
+    const auto copy_piece = [&](PyObject* piece) {
+        const Py_ssize_t piece_len = PyUnicode_GET_LENGTH(piece);
+        if (piece_len > 0 and PyUnicode_CopyCharacters(result, current_pos, piece, 0, piece_len) < 0) {
+            return false;
+        }
+        current_pos += piece_len;
+        return true;
+    };
+
+    for (const auto& segment : parsed->segments) {
+        if (not copy_piece(segment.literal.ptr())) {
+            Py_DECREF(result);
+            return nullptr;
+        }
+        if (segment.field >= 0) {
+            PyObject* arg = format_args[segment.field];
+            if (const auto& to_arg = get_tainted_object(arg, tx_map)) {
+                if (result_to == nullptr) {
+                    result_to = initializer->allocate_tainted_object();
+                }
+                result_to->add_ranges_shifted(to_arg, current_pos);
+            }
+            if (not copy_piece(arg)) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+        }
+    }
+
+    if (result_to) {
+        set_tainted_object(result, result_to, tx_map);
+    }
+    return result;
+}
+
+} // namespace
+
 /**
  * @brief This function is used to format the candidate_text with the given parameter_list, args and kwargs.
  *
@@ -11,11 +223,11 @@
  * @return StrType
  */
 template<class StrType>
-StrType
-api_format_aspect(StrType& candidate_text,
-                  const py::tuple& parameter_list,
-                  const py::args& args,
-                  const py::kwargs& kwargs)
+static StrType
+format_aspect_common(StrType& candidate_text,
+                     const py::tuple& parameter_list,
+                     const py::args& args,
+                     const py::kwargs& kwargs)
 {
     const auto tx_map = Initializer::get_tainting_map();
 
@@ -60,12 +272,60 @@ api_format_aspect(StrType& candidate_text,
     return py::reinterpret_steal<StrType>(new_result);
 }
 
+PyObject*
+api_format_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
+{
+    if (nargs < 2) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+    if (not PyUnicode_Check(args[0]) or not PyTuple_Check(args[1])) {
+        py::set_error(PyExc_TypeError, "format_aspect expects (str, tuple, *args, **kwargs)");
+        return nullptr;
+    }
+
+    if (PyObject* fast_result = format_fast(args[0], args + 2, nargs - 2, kwnames)) {
+        return fast_result;
+    }
+    if (PyErr_Occurred()) {
+        return nullptr;
+    }
+
+    PyObject* rest = PyTuple_New(nargs - 2);
+    if (rest == nullptr) {
+        return nullptr;
+    }
+    for (Py_ssize_t i = 2; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(rest, i - 2, args[i]);
+    }
+    const auto py_args = py::reinterpret_steal<py::args>(rest);
+
+    PyObject* kwargs_dict = kwnames_to_kwargs(args, static_cast<int>(nargs), kwnames);
+    if (kwargs_dict == nullptr) {
+        return nullptr;
+    }
+    const auto py_kwargs = py::reinterpret_steal<py::kwargs>(kwargs_dict);
+
+    try {
+        auto candidate_text = py::reinterpret_borrow<py::str>(args[0]);
+        return format_aspect_common<py::str>(
+                 candidate_text, py::reinterpret_borrow<py::tuple>(args[1]), py_args, py_kwargs)
+          .release()
+          .ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+static PyMethodDef FormatMethods[] = {
+    { "_format_aspect", (PyCFunction)api_format_aspect, METH_FASTCALL | METH_KEYWORDS, "aspect format" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
 void
 pyexport_format_aspect(py::module& m)
 {
-    m.def("_format_aspect",
-          &api_format_aspect<py::str>,
-          "candidate_text"_a,
-          "parameter_list"_a,
-          py::return_value_policy::move);
+    PyModule_AddFunctions(m.ptr(), FormatMethods);
 }
\ No newline at end of file
@@ -2,12 +2,8 @@
 #include "Aspects/Helpers.h"
 #include "Initializer/Initializer.h"
 
-template<class StrType>
-StrType
-api_format_aspect(StrType& candidate_text,
-                  const py::tuple& parameter_list,
-                  const py::args& args,
-                  const py::kwargs& kwargs);
+PyObject*
+api_format_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
 
 void
-pyexport_format_aspect(py::module& m);
\ No newline at end of file
+pyexport_format_aspect(py::module& m);
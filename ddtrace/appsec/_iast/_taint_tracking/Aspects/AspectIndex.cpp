@@ -1,4 +1,5 @@
 #include "AspectIndex.h"
+#include "AspectMetrics.h"
 #include "Helpers.h"
 #include "Utils/StringUtils.h"
 
@@ -22,19 +23,35 @@ index_aspect(PyObject* result_o,
     TaintRangeRefs ranges_to_set;
 
     if (is_text(candidate_text)) {
-        for (const auto& current_range : ranges) {
-            const auto idx_long = PyLong_AsLong(idx);
-            if (current_range->start <= idx_long and idx_long < (current_range->start + current_range->length)) {
-                ranges_to_set.emplace_back(initializer->allocate_taint_range(0l, 1l, current_range->source));
-                break;
+        const auto idx_long = PyLong_AsLong(idx);
+        // One probe over the start-ordered range list for the containing
+        // range (TaintedObject keeps them sorted); overlapping ranges set
+        // through the public API fall back to the linear scan
+        const auto* it =
+          std::lower_bound(ranges.begin(), ranges.end(), idx_long, [](const TaintRange& range, const long value) {
+              return range.start + range.length <= value;
+          });
+        if (it != ranges.end() and it->start <= idx_long) {
+            ranges_to_set.emplace_back(0l, 1l, it->source);
+        } else {
+            for (const auto& current_range : ranges) {
+                if (current_range.start <= idx_long and idx_long < (current_range.start + current_range.length)) {
+                    ranges_to_set.emplace_back(0l, 1l, current_range.source);
+                    break;
+                }
             }
         }
+        if (ranges_to_set.empty()) {
+            // Untainted position: keep the (possibly cached one-char) result
+            // as is and skip the new object and the taint-map write entirely
+            return result_o;
+        }
 
     } else if (PyReMatch_Check(candidate_text)) { // For re.Match objects, taint the whole output
         try {
             const size_t& len_result_o{ get_pyobject_size(result_o) };
             const auto& current_range = ranges.at(0);
-            ranges_to_set.emplace_back(initializer->allocate_taint_range(0l, len_result_o, current_range->source));
+            ranges_to_set.emplace_back(0l, static_cast<RANGE_LENGTH>(len_result_o), current_range.source);
         } catch (const std::out_of_range& ex) {
             if (nullptr == result_o) {
                 throw py::index_error();
@@ -61,6 +78,7 @@ index_aspect(PyObject* result_o,
 PyObject*
 api_index_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::INDEX);
     if (nargs != 2) {
         iast_taint_log_error(MSG_ERROR_N_PARAMS);
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
@@ -84,10 +102,13 @@ api_index_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
             return result_o;
         }
 
-        auto [ranges, ranges_error] = get_ranges(candidate_text, tx_map);
-        if (ranges_error or ranges.empty()) {
+        // Borrow the tainted object's range list instead of copying it: the
+        // inner-loop s[i] case only needs one probe into it
+        const auto& to_candidate = get_tainted_object(candidate_text, tx_map);
+        if (to_candidate == nullptr or to_candidate->get_ranges().empty()) {
             return result_o;
         }
+        const auto& ranges = to_candidate->get_ranges();
 
         if (const auto error = has_pyerr_as_string(); !error.empty()) {
             iast_taint_log_error(error);
@@ -98,6 +119,7 @@ api_index_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
             return result_o;
         }
 
+        timer.slow_path();
         return index_aspect(result_o, candidate_text, idx, ranges, tx_map);
     });
 }
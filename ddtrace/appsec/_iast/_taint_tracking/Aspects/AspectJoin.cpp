@@ -1,5 +1,6 @@
 #include "AspectJoin.h"
 
+#include "AspectMetrics.h"
 #include "Helpers.h"
 
 PyObject*
@@ -59,6 +60,130 @@ aspect_join_str(PyObject* sep,
     return new_result;
 }
 
+/**
+ * Fused single-pass join for a str separator and a list/tuple of str
+ * fragments: sizes the output buffer once from the summed lengths, then
+ * copies characters and emits shifted ranges in the same walk, instead of
+ * delegating to PyUnicode_Join and re-walking the pieces afterwards.
+ *
+ * Returns the joined (and, when needed, tainted) string, or nullptr with no
+ * error set when the inputs need the generic path (exotic element types,
+ * empty output, no active taint map).
+ */
+static PyObject*
+aspect_join_str_fast(PyObject* sep, PyObject* iterable_elements)
+{
+    const auto tx_taint_map = Initializer::get_tainting_map();
+    if (not tx_taint_map or tx_taint_map->empty()) {
+        return nullptr;
+    }
+
+    auto GetElement = PyList_GetItem;
+    Py_ssize_t len_iterable{ 0 };
+    if (PyList_Check(iterable_elements)) {
+        len_iterable = PyList_Size(iterable_elements);
+    } else if (PyTuple_Check(iterable_elements)) {
+        len_iterable = PyTuple_Size(iterable_elements);
+        GetElement = PyTuple_GetItem;
+    } else {
+        return nullptr;
+    }
+    if (len_iterable == 0) {
+        return nullptr;
+    }
+
+    // Sizing pass: sum the lengths and widen the character kind only with
+    // the pieces that actually contribute characters, so the result keeps
+    // the canonical (narrowest) representation
+    const Py_ssize_t len_sep = PyUnicode_GET_LENGTH(sep);
+    Py_UCS4 max_char = 0;
+    Py_ssize_t total_len = 0;
+
+    if (len_sep > 0 and len_iterable > 1) {
+        max_char = PyUnicode_MAX_CHAR_VALUE(sep);
+        total_len = (len_iterable - 1) * len_sep;
+    }
+    for (Py_ssize_t i = 0; i < len_iterable; i++) {
+        PyObject* element = GetElement(iterable_elements, i);
+        if (element == nullptr or not PyUnicode_Check(element)) {
+            // Let the generic path raise the proper TypeError
+            PyErr_Clear();
+            return nullptr;
+        }
+        const Py_ssize_t element_len = PyUnicode_GET_LENGTH(element);
+        if (element_len > 0) {
+            max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(element));
+            if (total_len > PY_SSIZE_T_MAX - element_len) {
+                return nullptr;
+            }
+            total_len += element_len;
+        }
+    }
+    if (total_len == 0) {
+        // Empty result cannot have taint ranges
+        return nullptr;
+    }
+
+    PyObject* result = PyUnicode_New(total_len, max_char);
+    if (result == nullptr) {
+        return nullptr;
+    }
+
+    // Copy pass: move each fragment into place and collect its shifted
+    // ranges at the same offset
+    const auto& to_joiner = get_tainted_object(sep, tx_taint_map);
+    TaintedObjectPtr result_to = nullptr;
+    TaintedObjectPtr first_tainted_to = nullptr;
+    unsigned long current_pos{ 0L };
+
+    const auto add_shifted = [&](const TaintedObjectPtr& to_element) {
+        if (current_pos == 0 and !first_tainted_to and result_to == nullptr) {
+            first_tainted_to = to_element;
+            return;
+        }
+        if (result_to == nullptr) {
+            // If first_tainted_to is null, it's ranges won't be copied
+            result_to = initializer->allocate_tainted_object_copy(first_tainted_to);
+            first_tainted_to = nullptr;
+        }
+        result_to->add_ranges_shifted(to_element, current_pos);
+    };
+
+    for (Py_ssize_t i = 0; i < len_iterable; i++) {
+        PyObject* element = GetElement(iterable_elements, i);
+        const Py_ssize_t element_len = PyUnicode_GET_LENGTH(element);
+        if (element_len > 0) {
+            if (PyUnicode_CopyCharacters(result, current_pos, element, 0, element_len) < 0) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+            if (const auto& to_element = get_tainted_object(element, tx_taint_map)) {
+                add_shifted(to_element);
+            }
+            current_pos += element_len;
+        }
+        if (len_sep > 0 and i < len_iterable - 1) {
+            if (PyUnicode_CopyCharacters(result, current_pos, sep, 0, len_sep) < 0) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+            if (to_joiner) {
+                add_shifted(to_joiner);
+            }
+            current_pos += len_sep;
+        }
+    }
+
+    if (result_to == nullptr and first_tainted_to) {
+        result_to = initializer->allocate_tainted_object_copy(first_tainted_to);
+    }
+    if (result_to) {
+        // The result is a fresh object, no new_pyobject_id copy is needed
+        set_tainted_object(result, result_to, tx_taint_map);
+    }
+    return result;
+}
+
 PyObject*
 aspect_join(PyObject* sep, PyObject* result, PyObject* iterable_elements, const TaintRangeMapTypePtr& tx_taint_map)
 {
@@ -141,6 +266,7 @@ aspect_join(PyObject* sep, PyObject* result, PyObject* iterable_elements, const
 PyObject*
 api_join_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::JOIN);
     if (nargs != 2) {
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
         return nullptr;
@@ -167,7 +293,17 @@ api_join_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
     }
     PyObject* result = nullptr;
     if (PyUnicode_Check(sep)) {
-        result = PyUnicode_Join(sep, arg0);
+        result = aspect_join_str_fast(sep, arg0);
+        if (result != nullptr) {
+            // Joined and tainted in a single pass
+            if (decref_arg0) {
+                Py_DECREF(arg0);
+            }
+            return result;
+        }
+        if (not has_pyerr()) {
+            result = PyUnicode_Join(sep, arg0);
+        }
     } else if (PyBytes_Check(sep)) {
         py::bytes result_ptr =
           py::reinterpret_borrow<py::bytes>(sep).attr("join")(py::reinterpret_borrow<py::object>(arg0));
@@ -195,6 +331,7 @@ api_join_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
             }
             return result;
         }
+        timer.slow_path();
         auto res = aspect_join(sep, result, arg0, ctx_map);
         if (decref_arg0) {
             Py_DECREF(arg0);
@@ -202,3 +339,108 @@ api_join_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
         return res;
     });
 }
+
+/**
+ * Aspect behind the BUILD_STRING (f-string) rewrite: concatenates the
+ * formatted parts taken straight from the vectorcall argument vector, sizing
+ * the output buffer once from the summed lengths and collecting each tainted
+ * part's shifted ranges in the same copy pass, ending in a single map
+ * insertion. Replaces the former "".join Python wrapper, which paid two
+ * interpreter frames and a tuple pack per f-string for the same work.
+ */
+PyObject*
+api_build_string_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    AspectTimer timer(AspectKind::BUILD_STRING);
+    if (nargs == 0) {
+        return PyUnicode_New(0, 0);
+    }
+
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        // BUILD_STRING operands are always str: FormattedValue applies
+        // format()/conversion before the parts reach this call
+        if (args[i] == nullptr or not PyUnicode_Check(args[i])) {
+            py::set_error(PyExc_TypeError, "build_string_aspect arguments must be str");
+            return nullptr;
+        }
+    }
+    if (nargs == 1) {
+        // str is immutable, so the single part (ranges included) is the result
+        Py_INCREF(args[0]);
+        return args[0];
+    }
+
+    // Sizing pass: as in aspect_join_str_fast, widen the character kind only
+    // with the parts that actually contribute characters
+    Py_UCS4 max_char = 0;
+    Py_ssize_t total_len = 0;
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        const Py_ssize_t part_len = PyUnicode_GET_LENGTH(args[i]);
+        if (part_len > 0) {
+            max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(args[i]));
+            if (total_len > PY_SSIZE_T_MAX - part_len) {
+                py::set_error(PyExc_OverflowError, "join() result is too long for a Python string");
+                return nullptr;
+            }
+            total_len += part_len;
+        }
+    }
+    if (total_len == 0) {
+        // Empty result cannot have taint ranges
+        return PyUnicode_New(0, 0);
+    }
+
+    PyObject* result = PyUnicode_New(total_len, max_char);
+    if (result == nullptr) {
+        return nullptr;
+    }
+
+    const auto tx_taint_map = Initializer::get_tainting_map();
+    const bool tracking = tx_taint_map and not tx_taint_map->empty();
+
+    TaintedObjectPtr result_to = nullptr;
+    TaintedObjectPtr first_tainted_to = nullptr;
+    unsigned long current_pos{ 0L };
+
+    const auto add_shifted = [&](const TaintedObjectPtr& to_part) {
+        if (current_pos == 0 and !first_tainted_to and result_to == nullptr) {
+            first_tainted_to = to_part;
+            return;
+        }
+        if (result_to == nullptr) {
+            // If first_tainted_to is null, it's ranges won't be copied
+            result_to = initializer->allocate_tainted_object_copy(first_tainted_to);
+            first_tainted_to = nullptr;
+        }
+        result_to->add_ranges_shifted(to_part, current_pos);
+    };
+
+    TRY_CATCH_ASPECT("build_string_aspect", return result, , {
+        for (Py_ssize_t i = 0; i < nargs; i++) {
+            const Py_ssize_t part_len = PyUnicode_GET_LENGTH(args[i]);
+            if (part_len == 0) {
+                continue;
+            }
+            if (PyUnicode_CopyCharacters(result, current_pos, args[i], 0, part_len) < 0) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+            if (tracking) {
+                if (const auto& to_part = get_tainted_object(args[i], tx_taint_map)) {
+                    add_shifted(to_part);
+                }
+            }
+            current_pos += part_len;
+        }
+
+        if (result_to == nullptr and first_tainted_to) {
+            result_to = initializer->allocate_tainted_object_copy(first_tainted_to);
+        }
+        if (result_to) {
+            timer.slow_path();
+            // The result is a fresh object, no new_pyobject_id copy is needed
+            set_tainted_object(result, result_to, tx_taint_map);
+        }
+        return result;
+    });
+}
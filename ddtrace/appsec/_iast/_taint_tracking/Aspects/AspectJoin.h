@@ -5,3 +5,6 @@ namespace py = pybind11;
 
 PyObject*
 api_join_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
+
+PyObject*
+api_build_string_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
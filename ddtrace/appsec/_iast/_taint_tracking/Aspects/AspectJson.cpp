@@ -0,0 +1,93 @@
+#include "AspectJson.h"
+#include "AspectRegex.h"
+#include "Initializer/Initializer.h"
+
+#include <vector>
+
+using namespace pybind11::literals;
+
+/**
+ * Taint every string json.loads extracted from a tainted document in one
+ * native pass, replacing the Python-level tree walk. The parser yields
+ * strings in document order (dicts preserve insertion order, which is
+ * document order), so walking the result while locating each string in the
+ * source with a moving cursor recovers the parser's offsets without
+ * re-tokenizing: one incremental find per extracted string. Each located
+ * string gets the source's ranges clipped to its span, the same machinery
+ * the re and pathlib aspects use.
+ *
+ * Strings the decoder rewrote (escape sequences, \uXXXX) don't appear
+ * verbatim and are skipped without advancing the cursor, so they stay
+ * untainted rather than mis-attributed. Repeated dict keys are memoized to
+ * one object by the C scanner; tainting it once covers every occurrence.
+ */
+py::object
+api_json_taint_loads(const py::object& result, const py::handle& source)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not PyUnicode_Check(source.ptr())) {
+        return result;
+    }
+    const auto source_len = PyUnicode_GET_LENGTH(source.ptr());
+    if (source_len == 0) {
+        return result;
+    }
+    const auto [source_ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error or source_ranges.empty()) {
+        return result;
+    }
+
+    // Explicit stack, document order: dict items are pushed in reverse so
+    // key pops before value, and pairs before later pairs
+    std::vector<PyObject*> pending{ result.ptr() };
+    Py_ssize_t cursor = 0;
+
+    while (not pending.empty()) {
+        PyObject* node = pending.back();
+        pending.pop_back();
+
+        if (PyUnicode_Check(node)) {
+            const auto node_len = PyUnicode_GET_LENGTH(node);
+            if (node_len == 0) {
+                continue;
+            }
+            const auto pos = PyUnicode_Find(source.ptr(), node, cursor, source_len, 1);
+            if (pos == -2) {
+                throw py::error_already_set();
+            }
+            if (pos < 0) {
+                continue;
+            }
+            if (auto clipped = ranges_for_span(
+                  source_ranges, static_cast<RANGE_START>(pos), static_cast<RANGE_START>(pos + node_len));
+                not clipped.empty()) {
+                set_ranges(node, clipped, tx_map);
+            }
+            cursor = pos + node_len;
+        } else if (PyDict_Check(node)) {
+            PyObject* key;
+            PyObject* value;
+            Py_ssize_t dict_pos = 0;
+            const auto first_pending = pending.size();
+            while (PyDict_Next(node, &dict_pos, &key, &value)) {
+                pending.push_back(key);
+                pending.push_back(value);
+            }
+            std::reverse(pending.begin() + static_cast<ptrdiff_t>(first_pending), pending.end());
+        } else if (PyList_Check(node)) {
+            for (Py_ssize_t i = PyList_GET_SIZE(node) - 1; i >= 0; i--) {
+                pending.push_back(PyList_GET_ITEM(node, i));
+            }
+        }
+        // Numbers, booleans and nulls carry no taint and don't need the
+        // cursor advanced past them: the next find skips them naturally
+    }
+
+    return result;
+}
+
+void
+pyexport_json_aspects(py::module& m)
+{
+    m.def("_json_taint_loads", &api_json_taint_loads, "result"_a, "source"_a, py::return_value_policy::move);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Helpers.h"
+
+py::object
+api_json_taint_loads(const py::object& result, const py::handle& source);
+
+void
+pyexport_json_aspects(py::module& m);
@@ -0,0 +1,63 @@
+#include "AspectMetrics.h"
+
+#include <mutex>
+#include <vector>
+
+namespace {
+// Keep in sync with AspectKind; these are the keys of the metrics() dict
+constexpr const char* ASPECT_KIND_NAMES[ASPECT_KIND_COUNT] = {
+    "add_aspect", "str_aspect", "add_inplace_aspect", "extend_aspect",
+    "index_aspect", "join_aspect", "slice_aspect", "modulo_aspect",
+    "build_string_aspect",
+};
+
+std::mutex blocks_mutex;
+// One block per thread that has ever executed an aspect. Blocks are
+// intentionally never freed (bounded by the peak thread count, a few hundred
+// bytes each) so metrics() keeps the totals of finished threads
+std::vector<AspectMetricsBlock*> blocks;
+}
+
+AspectMetricsBlock&
+aspect_metrics_block()
+{
+    thread_local AspectMetricsBlock* block = nullptr;
+    if (block == nullptr) {
+        block = new AspectMetricsBlock();
+        std::lock_guard<std::mutex> lock(blocks_mutex);
+        blocks.push_back(block);
+    }
+    return *block;
+}
+
+void
+pyexport_aspect_metrics(py::module& m)
+{
+    m.def("metrics", [] {
+        // Flush-on-read: sum every thread's block into one snapshot. The
+        // writers don't take the lock, so counters from threads running
+        // concurrently with this call may be off by the calls in flight.
+        AspectCounters totals[ASPECT_KIND_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(blocks_mutex);
+            for (const auto* block : blocks) {
+                for (size_t i = 0; i < ASPECT_KIND_COUNT; ++i) {
+                    totals[i].calls += block->counters[i].calls;
+                    totals[i].fast_path += block->counters[i].fast_path;
+                    totals[i].slow_path += block->counters[i].slow_path;
+                    totals[i].total_ns += block->counters[i].total_ns;
+                }
+            }
+        }
+        py::dict result;
+        for (size_t i = 0; i < ASPECT_KIND_COUNT; ++i) {
+            py::dict entry;
+            entry["calls"] = totals[i].calls;
+            entry["fast_path"] = totals[i].fast_path;
+            entry["slow_path"] = totals[i].slow_path;
+            entry["total_ns"] = totals[i].total_ns;
+            result[ASPECT_KIND_NAMES[i]] = entry;
+        }
+        return result;
+    });
+}
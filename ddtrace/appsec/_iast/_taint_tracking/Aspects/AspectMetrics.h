@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+// Aspects instrumented with hit/latency counters, in the order they are
+// registered in AspectsMethods (_native.cpp); used to index the per-thread
+// counter blocks
+enum class AspectKind : uint8_t
+{
+    ADD = 0,
+    STR,
+    ADD_INPLACE,
+    EXTEND,
+    INDEX,
+    JOIN,
+    SLICE,
+    MODULO,
+    BUILD_STRING,
+    NUM_KINDS,
+};
+
+inline constexpr size_t ASPECT_KIND_COUNT = static_cast<size_t>(AspectKind::NUM_KINDS);
+
+// Plain (non-atomic) counters: each block is only ever written by the thread
+// that owns it, and metrics() reads foreign blocks without synchronization,
+// tolerating a slightly stale snapshot in exchange for uncontended increments
+// on the aspect hot path
+struct AspectCounters
+{
+    uint64_t calls{ 0 };
+    uint64_t fast_path{ 0 };
+    uint64_t slow_path{ 0 };
+    uint64_t total_ns{ 0 };
+};
+
+struct AspectMetricsBlock
+{
+    AspectCounters counters[ASPECT_KIND_COUNT]{};
+};
+
+// Counter block owned by the calling thread, registered for metrics() on
+// first use
+AspectMetricsBlock&
+aspect_metrics_block();
+
+/**
+ * RAII scope placed at the top of each api_*_aspect entry point: counts the
+ * invocation, accumulates its wall time, and classifies it as a fast-path hit
+ * unless the aspect marks the tracking (slow) path before returning.
+ */
+class AspectTimer
+{
+  public:
+    explicit AspectTimer(const AspectKind kind)
+      : counters_(aspect_metrics_block().counters[static_cast<size_t>(kind)])
+      , start_(std::chrono::steady_clock::now())
+    {
+    }
+    AspectTimer(const AspectTimer&) = delete;
+    AspectTimer& operator=(const AspectTimer&) = delete;
+
+    // The tracking path was taken: taint ranges were read or written for this
+    // call, not just passed through
+    void slow_path() { slow_ = true; }
+
+    ~AspectTimer()
+    {
+        counters_.calls += 1;
+        if (slow_) {
+            counters_.slow_path += 1;
+        } else {
+            counters_.fast_path += 1;
+        }
+        counters_.total_ns += static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+  private:
+    AspectCounters& counters_;
+    std::chrono::steady_clock::time_point start_;
+    bool slow_{ false };
+};
+
+void
+pyexport_aspect_metrics(py::module& m);
@@ -1,6 +1,209 @@
+#include "AspectMetrics.h"
 #include "AspectModulo.h"
 #include "Helpers.h"
 
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/**
+ * Parsed layout of a %-format string: each segment is a literal piece
+ * followed by one "%s" slot (slot == false for the trailing literal).
+ * Parameters are positional, so slots are numbered by order of appearance.
+ */
+struct ModuloSegment
+{
+    py::str literal;
+    bool slot{ false };
+};
+
+struct ParsedModulo
+{
+    // Strong reference: while the entry lives the keyed pointer can't be
+    // reused for a different string
+    py::str fmt;
+    std::vector<ModuloSegment> segments;
+    Py_ssize_t n_slots{ 0 };
+};
+
+// Per-process cache keyed on the format-string object, same scheme as the
+// AspectFormat one: literals keep their address for the process lifetime,
+// so repeat calls hit on the pointer alone. Guarded by the GIL.
+constexpr size_t MODULO_CACHE_MAX_ENTRIES = 512;
+std::unordered_map<PyObject*, ParsedModulo> modulo_cache; // NOLINT(cert-err58-cpp)
+
+/**
+ * Parses fmt into literal/"%s"-slot segments. Only plain "%s" directives and
+ * the "%%" escape are supported: flags, widths, other conversion types and
+ * mapping keys return nullopt so the generic path keeps handling them.
+ */
+std::optional<ParsedModulo> parse_modulo_format(PyObject* fmt)
+{
+    const auto kind = PyUnicode_KIND(fmt);
+    const void* data = PyUnicode_DATA(fmt);
+    const Py_ssize_t len = PyUnicode_GET_LENGTH(fmt);
+
+    ParsedModulo parsed;
+    parsed.fmt = py::reinterpret_borrow<py::str>(fmt);
+    std::vector<Py_UCS4> literal;
+
+    const auto flush_segment = [&](const bool slot) {
+        ModuloSegment segment;
+        segment.literal = py::reinterpret_steal<py::str>(
+          PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, literal.data(), static_cast<Py_ssize_t>(literal.size())));
+        segment.slot = slot;
+        literal.clear();
+        parsed.segments.emplace_back(std::move(segment));
+    };
+
+    for (Py_ssize_t i = 0; i < len; i++) {
+        const Py_UCS4 ch = PyUnicode_READ(kind, data, i);
+        if (ch != '%') {
+            literal.push_back(ch);
+            continue;
+        }
+        if (i + 1 >= len) {
+            return std::nullopt;
+        }
+        const Py_UCS4 directive = PyUnicode_READ(kind, data, i + 1);
+        if (directive == '%') {
+            literal.push_back('%');
+            i++;
+        } else if (directive == 's') {
+            parsed.n_slots++;
+            flush_segment(true);
+            i++;
+        } else {
+            return std::nullopt;
+        }
+    }
+    flush_segment(false);
+    return parsed;
+}
+
+const ParsedModulo* get_cached_modulo(PyObject* fmt)
+{
+    if (const auto it = modulo_cache.find(fmt); it != modulo_cache.end()) {
+        return &it->second;
+    }
+    auto parsed = parse_modulo_format(fmt);
+    if (not parsed or parsed->segments.empty()) {
+        return nullptr;
+    }
+    if (modulo_cache.size() >= MODULO_CACHE_MAX_ENTRIES) {
+        modulo_cache.clear();
+    }
+    return &modulo_cache.emplace(fmt, std::move(*parsed)).first->second;
+}
+
+/**
+ * Fast path for the cached layout: presized substitution plus range
+ * arithmetic from the precomputed slot offsets, in one scan. Returns
+ * nullptr (no error set) when the call needs the generic machinery.
+ */
+PyObject* modulo_fast(PyObject* text, PyObject* insert_tuple_or_obj)
+{
+    if (not PyUnicode_CheckExact(text)) {
+        return nullptr;
+    }
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty()) {
+        return nullptr;
+    }
+    if (get_tainted_object(text, tx_map)) {
+        // A tainted template needs the evidence-escaping remap
+        return nullptr;
+    }
+    const auto* parsed = get_cached_modulo(text);
+    if (parsed == nullptr) {
+        return nullptr;
+    }
+
+    // Gather the positional parameters; arity mismatches and mappings fall
+    // back so the generic path raises the usual errors
+    std::vector<PyObject*> params;
+    if (PyTuple_CheckExact(insert_tuple_or_obj)) {
+        const Py_ssize_t n = PyTuple_GET_SIZE(insert_tuple_or_obj);
+        params.reserve(n);
+        for (Py_ssize_t i = 0; i < n; i++) {
+            params.push_back(PyTuple_GET_ITEM(insert_tuple_or_obj, i));
+        }
+    } else {
+        params.push_back(insert_tuple_or_obj);
+    }
+    if (static_cast<Py_ssize_t>(params.size()) != parsed->n_slots) {
+        return nullptr;
+    }
+    for (PyObject* param : params) {
+        if (not PyUnicode_CheckExact(param)) {
+            // Non-str parameters go through str() and friends, defer to it
+            return nullptr;
+        }
+    }
+
+    Py_UCS4 max_char = 0;
+    Py_ssize_t total_len = 0;
+    size_t slot = 0;
+    for (const auto& segment : parsed->segments) {
+        if (const Py_ssize_t literal_len = PyUnicode_GET_LENGTH(segment.literal.ptr()); literal_len > 0) {
+            max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(segment.literal.ptr()));
+            total_len += literal_len;
+        }
+        if (segment.slot) {
+            PyObject* param = params[slot++];
+            if (const Py_ssize_t param_len = PyUnicode_GET_LENGTH(param); param_len > 0) {
+                max_char = std::max(max_char, PyUnicode_MAX_CHAR_VALUE(param));
+                total_len += param_len;
+            }
+        }
+    }
+
+    PyObject* result = PyUnicode_New(total_len, max_char);
+    if (result == nullptr) {
+        return nullptr;
+    }
+
+    TaintedObjectPtr result_to = nullptr;
+    Py_ssize_t current_pos = 0;
+    const auto copy_piece = [&](PyObject* piece) {
+        const Py_ssize_t piece_len = PyUnicode_GET_LENGTH(piece);
+        if (piece_len > 0 and PyUnicode_CopyCharacters(result, current_pos, piece, 0, piece_len) < 0) {
+            return false;
+        }
+        current_pos += piece_len;
+        return true;
+    };
+
+    slot = 0;
+    for (const auto& segment : parsed->segments) {
+        if (not copy_piece(segment.literal.ptr())) {
+            Py_DECREF(result);
+            return nullptr;
+        }
+        if (segment.slot) {
+            PyObject* param = params[slot++];
+            if (const auto& to_param = get_tainted_object(param, tx_map)) {
+                if (result_to == nullptr) {
+                    result_to = initializer->allocate_tainted_object();
+                }
+                result_to->add_ranges_shifted(to_param, current_pos);
+            }
+            if (not copy_piece(param)) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+        }
+    }
+
+    if (result_to) {
+        set_tainted_object(result, result_to, tx_map);
+    }
+    return result;
+}
+
+} // namespace
+
 static PyObject*
 do_modulo(PyObject* text, PyObject* insert_tuple_or_obj)
 {
@@ -65,6 +268,7 @@ do_modulo(PyObject* text, PyObject* insert_tuple_or_obj)
 PyObject*
 api_modulo_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::MODULO);
     if (nargs != 2) {
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
         return nullptr;
@@ -72,6 +276,13 @@ api_modulo_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
     PyObject* candidate_text = args[0];
     PyObject* candidate_tuple = args[1];
 
+    if (PyObject* fast_result = modulo_fast(candidate_text, candidate_tuple)) {
+        return fast_result;
+    }
+    if (PyErr_Occurred()) {
+        return nullptr;
+    }
+
     const auto py_candidate_text = py::reinterpret_borrow<py::object>(candidate_text);
     auto py_candidate_tuple = py::reinterpret_borrow<py::object>(candidate_tuple);
 
@@ -119,6 +330,7 @@ api_modulo_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
             return get_result();
         }
 
+        timer.slow_path();
         auto std_candidate_text = py_candidate_text.cast<string>();
         auto fmttext = as_formatted_evidence(std_candidate_text, candidate_text_ranges, TagMappingMode::Mapper);
         py::list list_formatted_parameters;
@@ -1,5 +1,6 @@
 #include "AspectOperatorAdd.h"
 
+#include "AspectMetrics.h"
 #include "Helpers.h"
 
 /**
@@ -80,6 +81,7 @@ add_aspect(PyObject* result_o,
 PyObject*
 api_add_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::ADD);
     PyObject* result_o = nullptr;
 
     if (nargs != 2) {
@@ -119,6 +121,7 @@ api_add_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
             return result_o;
         }
 
+        timer.slow_path();
         return add_aspect(result_o, candidate_text, text_to_add, tx_map);
     });
 }
@@ -126,6 +129,7 @@ api_add_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
 PyObject*
 api_add_inplace_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::ADD_INPLACE);
     if (nargs != 2) {
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
         return nullptr;
@@ -163,6 +167,7 @@ api_add_inplace_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
             is_notinterned_notfasttainted_unicode(text_to_add)) {
             return result_o;
         }
+        timer.slow_path();
         return add_aspect(result_o, candidate_text, text_to_add, tx_map);
     });
 }
\ No newline at end of file
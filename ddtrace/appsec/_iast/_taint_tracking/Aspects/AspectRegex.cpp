@@ -0,0 +1,129 @@
+#include "AspectRegex.h"
+#include "Initializer/Initializer.h"
+
+using namespace pybind11::literals;
+
+/**
+ * Ranges of parent_ranges clipped to [span_start, span_end) and rebased to
+ * start at 0: exactly the taint a substring extracted at that span carries.
+ * Spans come straight from re.Match.regs, so they use the same indexing as
+ * the parent's ranges (code points for str, bytes for bytes subjects).
+ * Shared with the pathlib aspects, whose accessor results are spans too.
+ */
+TaintRangeRefs
+ranges_for_span(const TaintRangeRefs& parent_ranges, const RANGE_START span_start, const RANGE_START span_end)
+{
+    TaintRangeRefs result;
+    if (span_end <= span_start) {
+        return result;
+    }
+    for (const auto& trange : parent_ranges) {
+        // Ranges are kept sorted by start, nothing after this can intersect
+        if (trange.start >= span_end) {
+            break;
+        }
+        const auto start = std::max(trange.start, span_start);
+        if (const auto end = std::min(trange.start + trange.length, span_end); end > start) {
+            result.emplace_back(start - span_start, end - start, trange.source);
+        }
+    }
+    return result;
+}
+
+static void
+taint_with_span(PyObject* target,
+                const TaintRangeRefs& parent_ranges,
+                const RANGE_START span_start,
+                const RANGE_START span_end,
+                const TaintRangeMapTypePtr& tx_map)
+{
+    if (not is_text(target)) {
+        return;
+    }
+    if (auto clipped = ranges_for_span(parent_ranges, span_start, span_end); not clipped.empty()) {
+        set_ranges(target, clipped, tx_map);
+    }
+}
+
+py::object
+api_re_taint_span(const py::object& target, const py::handle& source, const RANGE_START span_start, const RANGE_START span_end)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty()) {
+        return target;
+    }
+    const auto [ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error or ranges.empty()) {
+        return target;
+    }
+    taint_with_span(target.ptr(), ranges, span_start, span_end, tx_map);
+    return target;
+}
+
+py::object
+api_re_taint_groups(const py::object& groups_result, const py::handle& source, const py::handle& match)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty()) {
+        return groups_result;
+    }
+    const auto [ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error or ranges.empty()) {
+        return groups_result;
+    }
+
+    // regs[0] is the whole match, regs[1:] line up with groups()
+    const auto regs = py::tuple(match.attr("regs"));
+    const auto groups = py::sequence(groups_result);
+    const auto n_groups = std::min(py::len(groups), regs.size() > 0 ? regs.size() - 1 : 0);
+    for (size_t i = 0; i < n_groups; i++) {
+        const auto span = py::tuple(regs[i + 1]);
+        const auto span_start = span[0].cast<RANGE_START>();
+        const auto span_end = span[1].cast<RANGE_START>();
+        // (-1, -1): the group didn't participate, its result is a default
+        if (span_start < 0 or span_end < 0) {
+            continue;
+        }
+        taint_with_span(groups[i].ptr(), ranges, span_start, span_end, tx_map);
+    }
+    return groups_result;
+}
+
+py::object
+api_re_taint_sub(const py::object& result, const py::handle& string, const py::handle& repl)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not is_text(result.ptr())) {
+        return result;
+    }
+    // Preference order matches the Python aspect: the subject's taint wins
+    // over the replacement's, both clamped to the output length
+    for (auto* origin : { string.ptr(), repl.ptr() }) {
+        if (auto [ranges, ranges_error] = get_ranges(origin, tx_map); not ranges_error and not ranges.empty()) {
+            // The copy from get_ranges is ours; clamp the lengths in place
+            shift_taint_ranges_inplace(ranges, 0, static_cast<RANGE_LENGTH>(py::len(result)));
+            set_ranges(result.ptr(), ranges, tx_map);
+            break;
+        }
+    }
+    return result;
+}
+
+void
+pyexport_aspect_regex(py::module& m)
+{
+    m.def("_re_taint_span",
+          &api_re_taint_span,
+          "target"_a,
+          "source"_a,
+          "span_start"_a,
+          "span_end"_a,
+          py::return_value_policy::move);
+    m.def("_re_taint_groups",
+          &api_re_taint_groups,
+          "groups_result"_a,
+          "source"_a,
+          "match"_a,
+          py::return_value_policy::move);
+    m.def("_re_taint_sub", &api_re_taint_sub, "result"_a, "string"_a, "repl"_a, py::return_value_policy::move);
+}
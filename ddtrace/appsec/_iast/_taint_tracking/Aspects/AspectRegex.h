@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Helpers.h"
+
+TaintRangeRefs
+ranges_for_span(const TaintRangeRefs& parent_ranges, RANGE_START span_start, RANGE_START span_end);
+
+py::object
+api_re_taint_span(const py::object& target, const py::handle& source, RANGE_START span_start, RANGE_START span_end);
+
+py::object
+api_re_taint_groups(const py::object& groups_result, const py::handle& source, const py::handle& match);
+
+py::object
+api_re_taint_sub(const py::object& result, const py::handle& string, const py::handle& repl);
+
+void
+pyexport_aspect_regex(py::module& m);
@@ -0,0 +1,239 @@
+#include "AspectReplace.h"
+#include "Initializer/Initializer.h"
+
+#include <cstring>
+
+/**
+ * All non-overlapping occurrences of needle in haystack, up to count
+ * (count < 0 scans everything). memchr narrows to first-byte candidates and
+ * memcmp confirms, so the scan runs at libc's vectorized speed without a
+ * platform-specific memmem.
+ */
+static void
+find_all_offsets(const char* haystack,
+                 const Py_ssize_t haystack_len,
+                 const char* needle,
+                 const Py_ssize_t needle_len,
+                 const long count,
+                 vector<Py_ssize_t>& offsets)
+{
+    const char* pos = haystack;
+    const char* const end = haystack + haystack_len;
+    while (needle_len <= end - pos) {
+        const auto* hit = static_cast<const char*>(memchr(pos, needle[0], end - pos - needle_len + 1));
+        if (hit == nullptr) {
+            return;
+        }
+        if (memcmp(hit, needle, needle_len) == 0) {
+            offsets.push_back(hit - haystack);
+            if (count >= 0 and offsets.size() >= static_cast<size_t>(count)) {
+                return;
+            }
+            pos = hit + needle_len;
+        } else {
+            pos = hit + 1;
+        }
+    }
+}
+
+static bool
+bytes_like_buffer(PyObject* obj, const char** data, Py_ssize_t* len)
+{
+    if (PyBytes_Check(obj)) {
+        *data = PyBytes_AS_STRING(obj);
+        *len = PyBytes_GET_SIZE(obj);
+        return true;
+    }
+    if (PyByteArray_Check(obj)) {
+        *data = PyByteArray_AS_STRING(obj);
+        *len = PyByteArray_GET_SIZE(obj);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Occurrence offsets of old_value in candidate_text, in the same units as
+ * the candidate's taint ranges (code points for str, bytes otherwise).
+ * Returns false for type combinations the scan doesn't cover, in which case
+ * the caller falls back to the Python path.
+ */
+static bool
+replacement_offsets(PyObject* candidate_text, PyObject* old_value, const long count, vector<Py_ssize_t>& offsets)
+{
+    if (PyUnicode_Check(candidate_text) and PyUnicode_Check(old_value)) {
+        if (PyUnicode_READY(candidate_text) != 0 or PyUnicode_READY(old_value) != 0) {
+            return false;
+        }
+        if (PyUnicode_IS_ASCII(candidate_text) and PyUnicode_IS_ASCII(old_value)) {
+            // One byte per code point: byte offsets are code-point offsets
+            find_all_offsets(reinterpret_cast<const char*>(PyUnicode_1BYTE_DATA(candidate_text)),
+                             PyUnicode_GET_LENGTH(candidate_text),
+                             reinterpret_cast<const char*>(PyUnicode_1BYTE_DATA(old_value)),
+                             PyUnicode_GET_LENGTH(old_value),
+                             count,
+                             offsets);
+            return true;
+        }
+        // Mixed-kind text: PyUnicode_Find is still a C-level scan per hit
+        const auto candidate_len = PyUnicode_GET_LENGTH(candidate_text);
+        const auto old_len = PyUnicode_GET_LENGTH(old_value);
+        Py_ssize_t pos = 0;
+        while (pos + old_len <= candidate_len) {
+            const auto hit = PyUnicode_Find(candidate_text, old_value, pos, candidate_len, 1);
+            if (hit < 0) {
+                break;
+            }
+            offsets.push_back(hit);
+            if (count >= 0 and offsets.size() >= static_cast<size_t>(count)) {
+                break;
+            }
+            pos = hit + old_len;
+        }
+        return not PyErr_Occurred();
+    }
+
+    const char* haystack = nullptr;
+    Py_ssize_t haystack_len = 0;
+    const char* needle = nullptr;
+    Py_ssize_t needle_len = 0;
+    if (bytes_like_buffer(candidate_text, &haystack, &haystack_len) and
+        bytes_like_buffer(old_value, &needle, &needle_len)) {
+        find_all_offsets(haystack, haystack_len, needle, needle_len, count, offsets);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Output ranges of candidate.replace(old, new) in one forward pass over the
+ * (sorted) candidate ranges and the match offsets: kept segments carry the
+ * candidate's ranges clipped and shifted by the accumulated length delta,
+ * and every inserted replacement carries new_value's own ranges at its
+ * output position.
+ */
+static TaintRangeRefs
+remap_replace_ranges(const TaintRangeRefs& text_ranges,
+                     const TaintRangeRefs& repl_ranges,
+                     const vector<Py_ssize_t>& offsets,
+                     const Py_ssize_t text_len,
+                     const Py_ssize_t old_len,
+                     const Py_ssize_t new_len)
+{
+    TaintRangeRefs out;
+    size_t idx = 0;
+    const auto emit_segment = [&](const Py_ssize_t seg_start, const Py_ssize_t seg_end, const Py_ssize_t shift) {
+        if (seg_end <= seg_start) {
+            return;
+        }
+        // Ranges fully before this segment are done for good
+        while (idx < text_ranges.size() and text_ranges[idx].start + text_ranges[idx].length <= seg_start) {
+            idx++;
+        }
+        for (size_t i = idx; i < text_ranges.size() and text_ranges[i].start < seg_end; i++) {
+            const auto start = std::max(text_ranges[i].start, static_cast<RANGE_START>(seg_start));
+            if (const auto end =
+                  std::min<RANGE_START>(text_ranges[i].start + text_ranges[i].length, static_cast<RANGE_START>(seg_end));
+                end > start) {
+                out.emplace_back(start + shift, end - start, text_ranges[i].source);
+            }
+        }
+    };
+
+    Py_ssize_t prev_end = 0;
+    Py_ssize_t shift = 0;
+    for (const auto offset : offsets) {
+        emit_segment(prev_end, offset, shift);
+        for (const auto& repl_range : repl_ranges) {
+            const auto start = std::max<RANGE_START>(repl_range.start, 0);
+            if (const auto end = std::min<RANGE_START>(repl_range.start + repl_range.length, new_len); end > start) {
+                out.emplace_back(offset + shift + start, end - start, repl_range.source);
+            }
+        }
+        prev_end = offset + old_len;
+        shift += new_len - old_len;
+    }
+    emit_segment(prev_end, text_len, shift);
+    return out;
+}
+
+PyObject*
+api_replace_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
+{
+    if (nargs != 5) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+    PyObject* candidate_text = args[0];
+    PyObject* old_value = args[1];
+    PyObject* new_value = args[2];
+    PyObject* result = args[4];
+
+    const long count = PyLong_AsLong(args[3]);
+    if (count == -1 and PyErr_Occurred()) {
+        return nullptr;
+    }
+
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty()) {
+        Py_INCREF(result);
+        return result;
+    }
+
+    const auto text_ranges = get_ranges_view(candidate_text, tx_map);
+    const auto repl_ranges = get_ranges_view(new_value, tx_map);
+    if (text_ranges.error or repl_ranges.error or (text_ranges.empty() and repl_ranges.empty())) {
+        Py_INCREF(result);
+        return result;
+    }
+
+    const auto old_len = get_pyobject_size(old_value);
+    if (old_len <= 0) {
+        // Empty needle inserts between every character; that shape stays on
+        // the Python path
+        Py_RETURN_NONE;
+    }
+
+    vector<Py_ssize_t> offsets;
+    if (not replacement_offsets(candidate_text, old_value, count, offsets)) {
+        if (PyErr_Occurred()) {
+            return nullptr;
+        }
+        // Unsupported type combination, let the Python path handle it
+        Py_RETURN_NONE;
+    }
+
+    if (offsets.empty()) {
+        // No match: the result is the unmodified text, propagate the ranges
+        // as-is without any rebuild
+        if (not text_ranges.empty() and result != candidate_text) {
+            set_ranges(result, *text_ranges, tx_map);
+        }
+        Py_INCREF(result);
+        return result;
+    }
+
+    static const TaintRangeRefs EMPTY_RANGES{};
+    if (auto out_ranges = remap_replace_ranges(text_ranges.empty() ? EMPTY_RANGES : *text_ranges,
+                                               repl_ranges.empty() ? EMPTY_RANGES : *repl_ranges,
+                                               offsets,
+                                               get_pyobject_size(candidate_text),
+                                               old_len,
+                                               get_pyobject_size(new_value));
+        not out_ranges.empty()) {
+        set_ranges(result, out_ranges, tx_map);
+    }
+    Py_INCREF(result);
+    return result;
+}
+
+static PyMethodDef ReplaceMethods[] = {
+    { "_aspect_replace", (PyCFunction)api_replace_aspect, METH_FASTCALL | METH_KEYWORDS, "aspect replace" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
+void
+pyexport_aspect_replace(py::module& m)
+{
+    PyModule_AddFunctions(m.ptr(), ReplaceMethods);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Helpers.h"
+
+PyObject*
+api_replace_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+
+void
+pyexport_aspect_replace(py::module& m);
@@ -1,5 +1,6 @@
 #include "AspectSlice.h"
 
+#include "AspectMetrics.h"
 #include "Helpers.h"
 
 /**
@@ -9,27 +10,33 @@
  *
  * @return A map of taint ranges for the given index range map.
  */
+// One entry per character index; nullptr marks untainted positions. The
+// pointers alias the ranges vector of the sliced text, which outlives the map.
+using TaintRangeIndexMap = std::vector<const TaintRange*>;
+
 TaintRangeRefs
-reduce_ranges_from_index_range_map(const TaintRangeRefs& index_range_map)
+reduce_ranges_from_index_range_map(const TaintRangeIndexMap& index_range_map)
 {
     TaintRangeRefs new_ranges;
-    TaintRangePtr current_range;
+    const TaintRange* current_range = nullptr;
     size_t current_start = 0;
     size_t index;
 
     for (index = 0; index < index_range_map.size(); ++index) {
-        if (const auto& taint_range{ index_range_map.at(index) }; taint_range != current_range) {
+        if (const auto* taint_range{ index_range_map[index] }; taint_range != current_range) {
             if (current_range) {
-                new_ranges.emplace_back(
-                  initializer->allocate_taint_range(current_start, index - current_start, current_range->source));
+                new_ranges.emplace_back(static_cast<RANGE_START>(current_start),
+                                        static_cast<RANGE_LENGTH>(index - current_start),
+                                        current_range->source);
             }
             current_range = taint_range;
             current_start = index;
         }
     }
     if (current_range != nullptr) {
-        new_ranges.emplace_back(
-          initializer->allocate_taint_range(current_start, index - current_start, current_range->source));
+        new_ranges.emplace_back(static_cast<RANGE_START>(current_start),
+                                static_cast<RANGE_LENGTH>(index - current_start),
+                                current_range->source);
     }
     return new_ranges;
 }
@@ -45,19 +52,18 @@ reduce_ranges_from_index_range_map(const TaintRangeRefs& index_range_map)
  *
  * @return A map of taint ranges for the given text object.
  */
-TaintRangeRefs
-build_index_range_map(PyObject* text, TaintRangeRefs& ranges, PyObject* start, PyObject* stop, PyObject* step)
+TaintRangeIndexMap
+build_index_range_map(PyObject* text, const TaintRangeRefs& ranges, PyObject* start, PyObject* stop, PyObject* step)
 {
-    TaintRangeRefs index_range_map;
+    TaintRangeIndexMap index_range_map;
     long long index = 0;
     for (const auto& taint_range : ranges) {
-        auto shared_range = taint_range;
-        while (index < taint_range->start) {
+        while (index < taint_range.start) {
             index_range_map.emplace_back(nullptr);
             index++;
         }
-        while (index < (taint_range->start + taint_range->length)) {
-            index_range_map.emplace_back(shared_range);
+        while (index < (taint_range.start + taint_range.length)) {
+            index_range_map.emplace_back(&taint_range);
             index++;
         }
     }
@@ -66,7 +72,7 @@ build_index_range_map(PyObject* text, TaintRangeRefs& ranges, PyObject* start, P
         index_range_map.emplace_back(nullptr);
         index++;
     }
-    TaintRangeRefs index_range_map_result;
+    TaintRangeIndexMap index_range_map_result;
     long start_int = 0;
     if (start != nullptr and start != Py_None) {
         start_int = PyLong_AsLong(start);
@@ -103,6 +109,55 @@ build_index_range_map(PyObject* text, TaintRangeRefs& ranges, PyObject* start, P
     return index_range_map_result;
 }
 
+/**
+ * Intersects the slice window [start, stop) against a start-ordered, disjoint
+ * range list: a binary search finds the first overlapping range, then only
+ * the k overlapping ranges are visited, O(log n + k) instead of one map entry
+ * per character of the parent string.
+ */
+static TaintRangeRefs
+slice_ranges_sorted(const TaintRangeRefs& ranges, const long start_int, const long stop_int)
+{
+    TaintRangeRefs new_ranges;
+    const auto slice_len = static_cast<RANGE_START>(stop_int - start_int);
+    if (slice_len <= 0) {
+        return new_ranges;
+    }
+
+    // Ranges are ordered by start and disjoint, so their ends are ordered
+    // too and "ends at or before the window" is a valid partition predicate
+    const auto* it = std::lower_bound(
+      ranges.begin(), ranges.end(), start_int, [](const TaintRange& range, const long value) {
+          return range.start + range.length <= value;
+      });
+
+    for (; it != ranges.end() and it->start < stop_int; ++it) {
+        const RANGE_START new_start = std::max(it->start - start_int, 0L);
+        const RANGE_START new_end = std::min(it->start + it->length - start_int, slice_len);
+        if (new_end > new_start) {
+            new_ranges.emplace_back(new_start, new_end - new_start, it->source);
+        }
+    }
+    return new_ranges;
+}
+
+/**
+ * The binary-search path needs the ranges ordered by start and
+ * non-overlapping; TaintedObject keeps them that way, but ranges set
+ * directly through the public API may not be. One linear check is still far
+ * cheaper than materializing the per-character map.
+ */
+static bool
+ranges_are_sorted_and_disjoint(const TaintRangeRefs& ranges)
+{
+    for (size_t i = 1; i < ranges.size(); i++) {
+        if (ranges[i - 1].start + ranges[i - 1].length > ranges[i].start) {
+            return false;
+        }
+    }
+    return true;
+}
+
 PyObject*
 slice_aspect(PyObject* result_o, PyObject* candidate_text, PyObject* start, PyObject* stop, PyObject* step)
 {
@@ -111,10 +166,40 @@ slice_aspect(PyObject* result_o, PyObject* candidate_text, PyObject* start, PyOb
     if (not ctx_map or ctx_map->empty()) {
         return result_o;
     }
-    auto [ranges, ranges_error] = get_ranges(candidate_text, ctx_map);
-    if (ranges_error or ranges.empty()) {
+    // Borrow the parent's range list; the intersection below only reads it
+    const auto ranges_view = get_ranges_view(candidate_text, ctx_map);
+    if (ranges_view.error or ranges_view.empty()) {
+        return result_o;
+    }
+    const TaintRangeRefs& ranges = *ranges_view;
+
+    // Step-1 slices (the overwhelmingly common case) intersect the ordered
+    // range list directly; other steps keep the per-character map
+    const long step_int = (step != nullptr and step != Py_None) ? PyLong_AsLong(step) : 1;
+    if (step_int == 1 and ranges_are_sorted_and_disjoint(ranges)) {
+        const auto length_text = static_cast<long>(py::len(candidate_text));
+        long start_int = 0;
+        if (start != nullptr and start != Py_None) {
+            start_int = PyLong_AsLong(start);
+            if (start_int < 0) {
+                start_int = std::max(length_text + start_int, 0L);
+            }
+        }
+        long stop_int = length_text;
+        if (stop != nullptr and stop != Py_None) {
+            stop_int = PyLong_AsLong(stop);
+            if (stop_int > length_text) {
+                stop_int = length_text;
+            } else if (stop_int < 0) {
+                stop_int = std::max(length_text + stop_int, 0L);
+            }
+        }
+        if (auto new_ranges = slice_ranges_sorted(ranges, start_int, stop_int); not new_ranges.empty()) {
+            set_ranges(result_o, new_ranges, ctx_map);
+        }
         return result_o;
     }
+
     set_ranges(result_o,
                reduce_ranges_from_index_range_map(build_index_range_map(candidate_text, ranges, start, stop, step)),
                ctx_map);
@@ -124,6 +209,7 @@ slice_aspect(PyObject* result_o, PyObject* candidate_text, PyObject* start, PyOb
 PyObject*
 api_slice_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
 {
+    AspectTimer timer(AspectKind::SLICE);
     if (nargs < 3) {
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
         iast_taint_log_error(MSG_ERROR_N_PARAMS);
@@ -155,6 +241,7 @@ api_slice_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
             return result_o;
         }
 
+        timer.slow_path();
         auto res = slice_aspect(result_o, candidate_text, start, stop, step);
         Py_XDECREF(slice);
         return res;
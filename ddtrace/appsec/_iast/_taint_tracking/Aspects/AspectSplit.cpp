@@ -2,39 +2,51 @@
 #include "Initializer/Initializer.h"
 #include "TaintedOps/TaintedOps.h"
 
-static std::optional<py::object>
+/**
+ * Returns true when args described a re.split call (pattern or re module as
+ * first argument), with `result` set to the taint-propagated split outcome;
+ * false means the caller proceeds with the plain str.split path. Error-code
+ * style on purpose, matching process_flag_added_args_fastcall: this probe
+ * runs on every split aspect invocation and used to box its outcome in an
+ * optional and import two modules per call just to answer "not re.split".
+ */
+static bool
 handle_potential_re_split(const py::tuple& args,
                           const py::tuple& sliced_args,
                           const py::kwargs& kwargs,
-                          const TaintRangeMapTypePtr& tx_map)
+                          const TaintRangeMapTypePtr& tx_map,
+                          py::object& result)
 {
-    const py::module re = py::module::import("re");
-    const py::object re_pattern_type = re.attr("Pattern");
-    const py::object types_module = py::module::import("types");
-
-    // re.split aspect, either with pattern as first arg or with re module
-    if (const py::object module_type = types_module.attr("ModuleType");
-        isinstance(args[0], re_pattern_type) ||
-        (isinstance(args[0], module_type) && std::string(py::str(args[0].attr("__name__"))) == "re" &&
-         (std::string(py::str(args[0].attr("__package__"))).empty() ||
-          std::string(py::str(args[0].attr("__package__"))) == "re"))) {
-
-        const py::object split_func = args[0].attr("split");
-        // Create a py::slice object to slice the args from index 1 to the end
-        py::list result = split_func(*sliced_args, **kwargs);
-
-        if (const int offset = isinstance(args[0], re_pattern_type) ? -1 : 0;
-            args.size() >= (static_cast<size_t>(3) + offset) && is_tainted(args[2 + offset].ptr(), tx_map)) {
-            for (auto& i : result) {
-                if (!i.is_none() and len(i) > 0) {
-                    copy_and_shift_ranges_from_strings(args[2 + offset], i, 0, len(i), tx_map);
-                }
+    // Resolved once per process and leaked, like the cached os.path
+    // attributes; guarded by the GIL
+    static PyObject* const re_pattern_type = safe_import("re", "Pattern").release().ptr();
+    static PyObject* const module_type = safe_import("types", "ModuleType").release().ptr();
+
+    const bool is_pattern = PyObject_IsInstance(args[0].ptr(), re_pattern_type) == 1;
+    bool is_re_module = false;
+    if (!is_pattern && PyObject_IsInstance(args[0].ptr(), module_type) == 1) {
+        is_re_module = std::string(py::str(args[0].attr("__name__"))) == "re" &&
+                       (std::string(py::str(args[0].attr("__package__"))).empty() ||
+                        std::string(py::str(args[0].attr("__package__"))) == "re");
+    }
+    if (!is_pattern && !is_re_module) {
+        return false;
+    }
+
+    const py::object split_func = args[0].attr("split");
+    // Create a py::slice object to slice the args from index 1 to the end
+    py::list split_result = split_func(*sliced_args, **kwargs);
+
+    if (const int offset = is_pattern ? -1 : 0;
+        args.size() >= (static_cast<size_t>(3) + offset) && is_tainted(args[2 + offset].ptr(), tx_map)) {
+        for (auto& i : split_result) {
+            if (!i.is_none() and len(i) > 0) {
+                copy_and_shift_ranges_from_strings(args[2 + offset], i, 0, len(i), tx_map);
             }
         }
-        return result;
     }
-
-    return std::nullopt;
+    result = split_result;
+    return true;
 }
 
 static py::object
@@ -64,9 +76,9 @@ split_text_common(const py::object& orig_function,
 
     TRY_CATCH_ASPECT("split_aspect", return result_o, , {
         if (split_func == "split") {
-            if (auto re_split_result = handle_potential_re_split(args_tuple, sliced_args, kwargs, tx_map);
-                re_split_result.has_value()) {
-                return *re_split_result;
+            if (py::object re_split_result;
+                handle_potential_re_split(args_tuple, sliced_args, kwargs, tx_map, re_split_result)) {
+                return re_split_result;
             }
         }
 
@@ -78,11 +90,11 @@ split_text_common(const py::object& orig_function,
     return result_o;
 }
 
-py::object
-api_splitlines_text(const py::object& orig_function,
-                    const int flag_added_args,
-                    const py::args& args,
-                    const py::kwargs& kwargs)
+static py::object
+splitlines_text_common(const py::object& orig_function,
+                       const int flag_added_args,
+                       const py::args& args,
+                       const py::kwargs& kwargs)
 {
     const auto result_or_args = py::reinterpret_borrow<py::object>(
       process_flag_added_args(orig_function.ptr(), flag_added_args, args.ptr(), kwargs.ptr()));
@@ -130,36 +142,101 @@ api_splitlines_text(const py::object& orig_function,
         }
 
         if (!keepends_is_other_type) {
-            set_ranges_on_splitted(text, ranges, result_o, tx_map, keepends);
+            // Exact per-line offsets (handles "\r\n" and the full splitlines
+            // terminator set); only an unscannable parent falls back to the
+            // generic one-separator approximation
+            if (!set_ranges_on_splitlines(text, ranges, result_o, tx_map, keepends)) {
+                set_ranges_on_splitted(text, ranges, result_o, tx_map, keepends);
+            }
         }
     });
     return result_o;
 }
 
+// The AST visitor always calls the split aspects with the layout
+// (orig_function, flag_added_args, *args, **kwargs); rebuild the tuple/dict
+// pair the implementations expect without going through pybind11 dispatch.
+static PyObject*
+split_aspect_fastcall(PyObject* const* args,
+                      const Py_ssize_t nargs,
+                      PyObject* kwnames,
+                      const std::string& split_func)
+{
+    PyObject* orig_function = nargs > 0 ? args[0] : Py_None;
+    int flag_added_args = 0;
+    if (nargs > 1 and PyLong_Check(args[1])) {
+        flag_added_args = static_cast<int>(PyLong_AsLong(args[1]));
+    }
+
+    const Py_ssize_t skip_args = nargs < 2 ? nargs : 2;
+
+    // Unexpected-patch delegation straight off the borrowed fastcall window:
+    // no tuple or kwargs dict is built unless the aspect path actually runs
+    if (PyObject* delegated = nullptr; process_flag_added_args_fastcall(
+          orig_function, flag_added_args, args + skip_args, nargs - skip_args, kwnames, &delegated)) {
+        return delegated;
+    }
+
+    PyObject* args_tuple = PyTuple_New(nargs - skip_args);
+    if (args_tuple == nullptr) {
+        return nullptr;
+    }
+    for (Py_ssize_t i = skip_args; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(args_tuple, i - skip_args, args[i]);
+    }
+    const auto py_args = py::reinterpret_steal<py::args>(args_tuple);
+
+    PyObject* kwargs_dict = kwnames_to_kwargs(args, static_cast<int>(nargs), kwnames);
+    if (kwargs_dict == nullptr) {
+        return nullptr;
+    }
+    const auto py_kwargs = py::reinterpret_steal<py::kwargs>(kwargs_dict);
+
+    try {
+        if (split_func == "splitlines") {
+            return splitlines_text_common(
+                     py::reinterpret_borrow<py::object>(orig_function), flag_added_args, py_args, py_kwargs)
+              .release()
+              .ptr();
+        }
+        return split_text_common(
+                 py::reinterpret_borrow<py::object>(orig_function), flag_added_args, py_args, py_kwargs, split_func)
+          .release()
+          .ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+PyObject*
+api_split_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
+{
+    return split_aspect_fastcall(args, nargs, kwnames, "split");
+}
+
+PyObject*
+api_rsplit_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
+{
+    return split_aspect_fastcall(args, nargs, kwnames, "rsplit");
+}
+
+PyObject*
+api_splitlines_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
+{
+    return split_aspect_fastcall(args, nargs, kwnames, "splitlines");
+}
+
+static PyMethodDef SplitMethods[] = {
+    { "_aspect_split", (PyCFunction)api_split_aspect, METH_FASTCALL | METH_KEYWORDS, "aspect split" },
+    { "_aspect_rsplit", (PyCFunction)api_rsplit_aspect, METH_FASTCALL | METH_KEYWORDS, "aspect rsplit" },
+    { "_aspect_splitlines", (PyCFunction)api_splitlines_aspect, METH_FASTCALL | METH_KEYWORDS, "aspect splitlines" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
 void
 pyexport_aspect_split(py::module& m)
 {
-    m.def(
-      "_aspect_split",
-      [](const py::object& orig_function, const int flag_added_args, const py::args& args, const py::kwargs& kwargs) {
-          return split_text_common(orig_function, flag_added_args, args, kwargs, "split");
-      },
-      "orig_function"_a = py::none(),
-      "flag_added_args"_a = 0,
-      py::return_value_policy::move);
-
-    m.def(
-      "_aspect_rsplit",
-      [](const py::object& orig_function, const int flag_added_args, const py::args& args, const py::kwargs& kwargs) {
-          return split_text_common(orig_function, flag_added_args, args, kwargs, "rsplit");
-      },
-      "orig_function"_a = py::none(),
-      "flag_added_args"_a = 0,
-      py::return_value_policy::move);
-
-    m.def("_aspect_splitlines",
-          &api_splitlines_text,
-          "orig_function"_a = py::none(),
-          "flag_added_args"_a = 0,
-          py::return_value_policy::move);
+    PyModule_AddFunctions(m.ptr(), SplitMethods);
 }
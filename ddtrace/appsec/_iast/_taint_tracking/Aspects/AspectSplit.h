@@ -2,11 +2,14 @@
 
 #include "Helpers.h"
 
-py::object
-api_splitlines_text(const py::object& orig_function,
-                    int flag_added_args,
-                    const py::args& args,
-                    const py::kwargs& kwargs);
+PyObject*
+api_split_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+
+PyObject*
+api_rsplit_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
+
+PyObject*
+api_splitlines_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
 
 void
-pyexport_aspect_split(py::module& m);
\ No newline at end of file
+pyexport_aspect_split(py::module& m);
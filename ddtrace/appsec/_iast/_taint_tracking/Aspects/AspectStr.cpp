@@ -1,3 +1,4 @@
+#include <Aspects/AspectMetrics.h>
 #include <Aspects/AspectStr.h>
 #include <Aspects/Helpers.h>
 
@@ -13,7 +14,7 @@ set_lengthupdated_ranges(PyObject* result,
 
     TaintRangeRefs copy_ranges(ranges);
     for (auto& range : copy_ranges) {
-        range->length = result_len;
+        range.length = result_len;
     }
 
     set_ranges(result, copy_ranges, tx_map);
@@ -26,8 +27,18 @@ call_original_function(PyObject* orig_function,
                        PyObject* const* args,
                        PyObject* kwnames)
 {
-    int skip_args = 2 + flag_added_args;
+    Py_ssize_t skip_args = 2 + flag_added_args;
+    if (skip_args < 0) {
+        skip_args = 0;
+    } else if (skip_args > nargs) {
+        skip_args = nargs;
+    }
 
+#if PY_VERSION_HEX >= 0x03090000
+    // The borrowed window is already vectorcall-shaped (keyword values right
+    // after the positionals), so the delegation builds no tuple or dict
+    return PyObject_Vectorcall(orig_function, args + skip_args, nargs - skip_args, kwnames);
+#else
     // convert ** args to *args
     py::list py_args_list;
     for (Py_ssize_t i = skip_args; i < nargs; ++i) {
@@ -36,9 +47,10 @@ call_original_function(PyObject* orig_function,
     py::args py_args(py_args_list);
 
     PyObject* kwargs = kwnames_to_kwargs(args, nargs, kwnames);
-    auto res = PyObject_Call(orig_function, py_args.ptr(), kwnames_to_kwargs(args, nargs, kwnames));
+    auto res = PyObject_Call(orig_function, py_args.ptr(), kwargs);
     Py_DECREF(kwargs);
     return res;
+#endif
 }
 
 static std::tuple<int, int, PyObject*, PyObject*, PyObject*, PyObject*>
@@ -103,6 +115,7 @@ get_args(PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
 PyObject*
 api_str_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
 {
+    AspectTimer timer(AspectKind::STR);
     if (nargs < 2 or nargs > 5) {
         py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
         return nullptr;
@@ -136,6 +149,16 @@ api_str_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, Py
         return call_original_function(orig_function, nargs, flag_added_args, args, kwnames);
     }
 
+    // Identity fast path: str() of an exact str with no encoding/errors
+    // arguments returns the object itself (CPython guarantees this), which
+    // already carries its taint-map entry. Propagating by pointer avoids the
+    // conversion helpers, the ranges lookup and the redundant re-taint.
+    // Subclasses may override __str__, so only the exact type qualifies.
+    if (not has_encoding and not has_errors and PyUnicode_CheckExact(text)) {
+        Py_INCREF(text);
+        return text;
+    }
+
     // Call the original if not a text type and has no encoding
     if (not is_text(text)) {
         PyObject* as_str = PyObject_Str(text);
@@ -188,6 +211,7 @@ api_str_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, Py
         if (ranges_error || ranges.empty()) {
             return result_o;
         }
+        timer.slow_path();
 
         if (PyUnicode_Check(text)) {
             set_ranges(result_o, ranges, tx_map);
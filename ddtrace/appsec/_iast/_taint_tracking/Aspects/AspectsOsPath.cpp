@@ -1,22 +1,66 @@
 #include "AspectsOsPath.h"
 #include <string>
+#include <unordered_map>
 
 #include "Helpers.h"
 #include "Initializer/Initializer.h"
 
+/**
+ * os.path attributes resolved once per process: these aspects run on every
+ * request and the per-call import lookup round trip dominated the actual
+ * range math. References are deliberately leaked so no destructor runs
+ * after interpreter shutdown. Guarded by the GIL.
+ */
+static py::handle
+os_path_attr(const char* name)
+{
+    static std::unordered_map<std::string, PyObject*> cache;
+    const auto [it, inserted] = cache.emplace(name, nullptr);
+    if (inserted) {
+        try {
+            it->second = safe_import("os.path", name).release().ptr();
+        } catch (...) {
+            cache.erase(it);
+            throw;
+        }
+    }
+    return { it->second };
+}
+
+static const std::string&
+os_path_sep()
+{
+    static const std::string separator = py::cast<std::string>(os_path_attr("sep"));
+    return separator;
+}
+
+// The canonical separator str object, for the identity check below
+static PyObject*
+os_path_sep_str()
+{
+    static PyObject* const sep_str = py::str(os_path_sep()).release().ptr();
+    return sep_str;
+}
+
 static bool
-starts_with_separator(const py::handle& arg, const std::string& separator)
+starts_with_separator(PyObject* arg, const std::string& separator)
 {
-    const auto carg = py::cast<std::string>(arg);
-    return carg.substr(0, 1) == separator;
+    if (PyUnicode_Check(arg)) {
+        return PyUnicode_GET_LENGTH(arg) > 0 and PyUnicode_ReadChar(arg, 0) == static_cast<Py_UCS4>(separator[0]);
+    }
+    if (PyBytes_Check(arg)) {
+        return PyBytes_GET_SIZE(arg) > 0 and PyBytes_AS_STRING(arg)[0] == separator[0];
+    }
+    if (PyByteArray_Check(arg)) {
+        return PyByteArray_GET_SIZE(arg) > 0 and PyByteArray_AS_STRING(arg)[0] == separator[0];
+    }
+    return false;
 }
 
-template<class StrType>
-StrType
-api_ospathjoin_aspect(StrType& first_part, const py::args& args)
+static py::object
+ospathjoin_aspect(const py::object& first_part, const py::tuple& args)
 {
-    auto join = safe_import("os.path", "join");
-    auto result_o = join(first_part, *args);
+    auto result_o = os_path_attr("join")(first_part, *args);
 
     const auto tx_map = Initializer::get_tainting_map();
     if (not tx_map or tx_map->empty()) {
@@ -24,32 +68,45 @@ api_ospathjoin_aspect(StrType& first_part, const py::args& args)
     }
 
     TRY_CATCH_ASPECT("ospathjoin_aspect", return result_o, , {
-        const auto separator = safe_import("os.path", "sep").cast<std::string>();
+        const auto& separator = os_path_sep();
         const auto sepsize = separator.size();
 
-        // Find the initial iteration point. This will be the first argument that has the separator ("/foo")
-        // as a first character or first_part (the first element) if no such argument is found.
+        // One traversal fetches every component's length, rootedness and
+        // ranges; the separator/offset math below then runs purely over the
+        // cached values, with no further Python round trips.
+        struct ComponentInfo
+        {
+            unsigned long length;
+            TaintRangeRefs ranges;
+        };
+        std::vector<ComponentInfo> components;
+        components.reserve(args.size());
+
+        // The initial iteration point is the first argument that has the
+        // separator ("/foo") as a first character, or first_part (the first
+        // element) if no such argument is found.
         auto initial_arg_pos = -1;
         bool root_is_after_first = false;
         for (auto& arg : args) {
             if (not is_text(arg.ptr())) {
                 return result_o;
             }
-
-            if (starts_with_separator(arg, separator)) {
+            if (not root_is_after_first and starts_with_separator(arg.ptr(), separator)) {
                 root_is_after_first = true;
-                initial_arg_pos++;
-                break;
+                initial_arg_pos = static_cast<int>(components.size());
+            }
+            ComponentInfo info;
+            info.length = py::len(arg);
+            if (auto [ranges, ranges_error] = get_ranges(arg.ptr(), tx_map); not ranges_error) {
+                info.ranges = std::move(ranges);
             }
-            initial_arg_pos++;
+            components.emplace_back(std::move(info));
         }
 
         TaintRangeRefs result_ranges;
         result_ranges.reserve(args.size());
-
-        std::vector<TaintRangeRefs> all_ranges;
         unsigned long current_offset = 0;
-        auto first_part_len = py::len(first_part);
+        const auto first_part_len = py::len(first_part);
 
         if (not root_is_after_first) {
             // Get the ranges of first_part and set them to the result, skipping the first character position
@@ -61,48 +118,37 @@ api_ospathjoin_aspect(StrType& first_part, const py::args& args)
                 }
             }
 
-            if (not first_part.is(py::str(separator))) {
-                current_offset = py::len(first_part);
+            if (first_part.ptr() != os_path_sep_str()) {
+                current_offset = first_part_len;
             }
 
             current_offset += sepsize;
             initial_arg_pos = 0;
         }
 
-        const unsigned long unsigned_initial_arg_pos = max(0, initial_arg_pos);
-
-        // Now go trough the arguments and do the same
-        for (unsigned long i = 0; i < args.size(); i++) {
-            if (i >= unsigned_initial_arg_pos) {
-                // Set the ranges from the corresponding argument
-                if (auto [ranges, ranges_error] = get_ranges(args[i].ptr(), tx_map);
-                    not ranges_error and not ranges.empty()) {
-                    const auto len_args_i = py::len(args[i]);
-                    for (auto& range : ranges) {
-                        result_ranges.emplace_back(shift_taint_range(range, current_offset, len_args_i));
-                    }
-                }
-                current_offset += py::len(args[i]);
-                current_offset += sepsize;
+        // Now go through the cached components and do the same
+        for (auto i = static_cast<unsigned long>(max(0, initial_arg_pos)); i < components.size(); i++) {
+            for (auto& range : components[i].ranges) {
+                result_ranges.emplace_back(shift_taint_range(range, current_offset, components[i].length));
             }
+            current_offset += components[i].length;
+            current_offset += sepsize;
         }
 
         if (not result_ranges.empty()) {
             PyObject* new_result = new_pyobject_id(result_o.ptr());
             set_ranges(new_result, result_ranges, tx_map);
-            return py::reinterpret_steal<StrType>(new_result);
+            return py::reinterpret_steal<py::object>(new_result);
         }
 
         return result_o;
     });
 }
 
-template<class StrType>
-StrType
-api_ospathbasename_aspect(const StrType& path)
+static py::object
+ospathbasename_aspect(const py::object& path)
 {
-    auto basename = safe_import("os.path", "basename");
-    auto result_o = basename(path);
+    auto result_o = os_path_attr("basename")(path);
 
     TRY_CATCH_ASPECT("ospathbasename_aspect", return result_o, , {
         const auto tx_map = Initializer::get_tainting_map();
@@ -129,12 +175,10 @@ api_ospathbasename_aspect(const StrType& path)
     });
 }
 
-template<class StrType>
-StrType
-api_ospathdirname_aspect(const StrType& path)
+static py::object
+ospathdirname_aspect(const py::object& path)
 {
-    auto dirname = safe_import("os.path", "dirname");
-    auto result_o = dirname(path);
+    auto result_o = os_path_attr("dirname")(path);
 
     TRY_CATCH_ASPECT("ospathdirname_aspect", return result_o, , {
         const auto tx_map = Initializer::get_tainting_map();
@@ -161,12 +205,10 @@ api_ospathdirname_aspect(const StrType& path)
     });
 }
 
-template<class StrType>
-static py::tuple
-forward_to_set_ranges_on_splitted(const char* function_name, const StrType& path, bool includeseparator = false)
+static py::object
+forward_to_set_ranges_on_splitted(const char* function_name, const py::object& path, bool includeseparator = false)
 {
-    auto function = safe_import("os.path", function_name);
-    auto result_o = function(path);
+    auto result_o = os_path_attr(function_name)(path);
 
     TRY_CATCH_ASPECT("forward_to_set_ranges_on_splitted", return result_o, , {
         const auto tx_map = Initializer::get_tainting_map();
@@ -184,79 +226,161 @@ forward_to_set_ranges_on_splitted(const char* function_name, const StrType& path
     });
 }
 
-template<class StrType>
-py::tuple
-api_ospathsplit_aspect(const StrType& path)
+static py::object
+ospathnormcase_aspect(const py::object& path)
+{
+    auto result_o = os_path_attr("normcase")(path);
+
+    TRY_CATCH_ASPECT("ospathnormcase_aspect", return result_o, , {
+        const auto tx_map = Initializer::get_tainting_map();
+        if (not tx_map or tx_map->empty()) {
+            return result_o;
+        }
+
+        auto [ranges, ranges_error] = get_ranges(path.ptr(), tx_map);
+        if (ranges_error or ranges.empty()) {
+            return result_o;
+        }
+
+        const TaintRangeRefs result_ranges = ranges;
+        if (PyObject* new_result = new_pyobject_id(result_o.ptr())) {
+            set_ranges(new_result, result_ranges, tx_map);
+            return py::reinterpret_steal<py::object>(new_result);
+        }
+
+        return result_o;
+    });
+}
+
+// Fastcall entry points. The common implementations above work on generic
+// py::objects (os.path itself rejects non-path arguments), so the former
+// str/bytes template dispatch through pybind11 is not needed.
+
+PyObject*
+api_ospathjoin_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    if (nargs < 1) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+
+    PyObject* rest = PyTuple_New(nargs - 1);
+    if (rest == nullptr) {
+        return nullptr;
+    }
+    for (Py_ssize_t i = 1; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(rest, i - 1, args[i]);
+    }
+
+    try {
+        return ospathjoin_aspect(py::reinterpret_borrow<py::object>(args[0]),
+                                 py::reinterpret_steal<py::tuple>(rest))
+          .release()
+          .ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+// Shared wrapper for the single-path aspects
+template<py::object (*Impl)(const py::object&)>
+static PyObject*
+single_path_fastcall(PyObject* const* args, const Py_ssize_t nargs)
+{
+    if (nargs != 1) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+    try {
+        return Impl(py::reinterpret_borrow<py::object>(args[0])).release().ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+static py::object
+ospathsplit_aspect(const py::object& path)
 {
     return forward_to_set_ranges_on_splitted("split", path);
 }
 
-template<class StrType>
-py::tuple
-api_ospathsplitext_aspect(const StrType& path)
+static py::object
+ospathsplitext_aspect(const py::object& path)
 {
     return forward_to_set_ranges_on_splitted("splitext", path, true);
 }
 
-template<class StrType>
-py::tuple
-api_ospathsplitdrive_aspect(const StrType& path)
+static py::object
+ospathsplitdrive_aspect(const py::object& path)
 {
     return forward_to_set_ranges_on_splitted("splitdrive", path, true);
 }
 
-template<class StrType>
-py::tuple
-api_ospathsplitroot_aspect(const StrType& path)
+static py::object
+ospathsplitroot_aspect(const py::object& path)
 {
     return forward_to_set_ranges_on_splitted("splitroot", path, true);
 }
 
-template<class StrType>
-StrType
-api_ospathnormcase_aspect(const StrType& path)
+PyObject*
+api_ospathbasename_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
 {
-    auto normcase = safe_import("os.path", "normcase");
-    auto result_o = normcase(path);
+    return single_path_fastcall<&ospathbasename_aspect>(args, nargs);
+}
 
-    TRY_CATCH_ASPECT("ospathnormcase_aspect", return result_o, , {
-        const auto tx_map = Initializer::get_tainting_map();
-        if (not tx_map or tx_map->empty()) {
-            return result_o;
-        }
+PyObject*
+api_ospathdirname_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathdirname_aspect>(args, nargs);
+}
 
-        auto [ranges, ranges_error] = get_ranges(path.ptr(), tx_map);
-        if (ranges_error or ranges.empty()) {
-            return result_o;
-        }
+PyObject*
+api_ospathsplit_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathsplit_aspect>(args, nargs);
+}
 
-        const TaintRangeRefs result_ranges = ranges;
-        if (PyObject* new_result = new_pyobject_id(result_o.ptr())) {
-            set_ranges(new_result, result_ranges, tx_map);
-            return py::reinterpret_steal<StrType>(new_result);
-        }
+PyObject*
+api_ospathsplitext_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathsplitext_aspect>(args, nargs);
+}
 
-        return result_o;
-    });
+PyObject*
+api_ospathsplitdrive_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathsplitdrive_aspect>(args, nargs);
+}
+
+PyObject*
+api_ospathsplitroot_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathsplitroot_aspect>(args, nargs);
 }
 
+PyObject*
+api_ospathnormcase_aspect(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    return single_path_fastcall<&ospathnormcase_aspect>(args, nargs);
+}
+
+static PyMethodDef OsPathMethods[] = {
+    { "_aspect_ospathjoin", (PyCFunction)api_ospathjoin_aspect, METH_FASTCALL, "aspect ospathjoin" },
+    { "_aspect_ospathnormcase", (PyCFunction)api_ospathnormcase_aspect, METH_FASTCALL, "aspect ospathnormcase" },
+    { "_aspect_ospathbasename", (PyCFunction)api_ospathbasename_aspect, METH_FASTCALL, "aspect ospathbasename" },
+    { "_aspect_ospathdirname", (PyCFunction)api_ospathdirname_aspect, METH_FASTCALL, "aspect ospathdirname" },
+    { "_aspect_ospathsplit", (PyCFunction)api_ospathsplit_aspect, METH_FASTCALL, "aspect ospathsplit" },
+    { "_aspect_ospathsplitext", (PyCFunction)api_ospathsplitext_aspect, METH_FASTCALL, "aspect ospathsplitext" },
+    { "_aspect_ospathsplitdrive", (PyCFunction)api_ospathsplitdrive_aspect, METH_FASTCALL, "aspect ospathsplitdrive" },
+    { "_aspect_ospathsplitroot", (PyCFunction)api_ospathsplitroot_aspect, METH_FASTCALL, "aspect ospathsplitroot" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
 void
 pyexport_ospath_aspects(py::module& m)
 {
-    m.def("_aspect_ospathjoin", &api_ospathjoin_aspect<py::str>, "first_part"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathjoin", &api_ospathjoin_aspect<py::bytes>, "first_part"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathnormcase", &api_ospathnormcase_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathnormcase", &api_ospathnormcase_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathbasename", &api_ospathbasename_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathbasename", &api_ospathbasename_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathdirname", &api_ospathdirname_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathdirname", &api_ospathdirname_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplit", &api_ospathsplit_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplit", &api_ospathsplit_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitext", &api_ospathsplitext_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitext", &api_ospathsplitext_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitdrive", &api_ospathsplitdrive_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitdrive", &api_ospathsplitdrive_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitroot", &api_ospathsplitroot_aspect<py::str>, "path"_a, py::return_value_policy::move);
-    m.def("_aspect_ospathsplitroot", &api_ospathsplitroot_aspect<py::bytes>, "path"_a, py::return_value_policy::move);
+    PyModule_AddFunctions(m.ptr(), OsPathMethods);
 }
@@ -3,37 +3,29 @@
 
 namespace py = pybind11;
 
-template<class StrType>
-StrType
-api_ospathjoin_aspect(StrType& first_part, const py::args& args);
+PyObject*
+api_ospathjoin_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-StrType
-api_ospathbasename_aspect(const StrType& path);
+PyObject*
+api_ospathbasename_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-StrType
-api_ospathdirname_aspect(const StrType& path);
+PyObject*
+api_ospathdirname_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-py::tuple
-api_ospathsplit_aspect(const StrType& path);
+PyObject*
+api_ospathsplit_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-py::tuple
-api_ospathsplitext_aspect(const StrType& path);
+PyObject*
+api_ospathsplitext_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-py::tuple
-api_ospathsplitdrive_aspect(const StrType& path);
+PyObject*
+api_ospathsplitdrive_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-py::tuple
-api_ospathsplitroot_aspect(const StrType& path);
+PyObject*
+api_ospathsplitroot_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
-template<class StrType>
-StrType
-api_ospathnormcase_aspect(const StrType& path);
+PyObject*
+api_ospathnormcase_aspect(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
 void
 pyexport_ospath_aspects(py::module& m);
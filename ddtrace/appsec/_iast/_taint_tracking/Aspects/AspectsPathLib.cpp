@@ -0,0 +1,118 @@
+#include "AspectsPathLib.h"
+#include "AspectRegex.h"
+#include "Initializer/Initializer.h"
+
+using namespace pybind11::literals;
+
+/**
+ * pathlib builds its strings internally from parsed parts, so unlike the
+ * os.path aspects there is never a call with both operands in hand: these
+ * helpers retro-taint an already-built result from the strings that went
+ * into it. The wrappers in _patches/pathlib_tainting.py decide where to
+ * hook per Python version; the offset math lives here.
+ */
+
+/**
+ * Taint the joined string from the components it was built from: each text
+ * component is located inside the result (left to right, so repeated names
+ * resolve to their own occurrence) and its ranges are shifted to the match
+ * offset, exactly the per-component math of the os.path.join aspect.
+ * Components the parser dropped or rewrote ("." entries, collapsed
+ * separators) are simply skipped. The result is tainted in place: pathlib
+ * caches the string on the instance, so every later conversion (str(),
+ * os.fspath(), open()) observes the ranges.
+ */
+py::object
+api_pathlib_taint_joined(const py::object& result, const py::tuple& parts)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not PyUnicode_Check(result.ptr())) {
+        return result;
+    }
+    const auto result_len = PyUnicode_GET_LENGTH(result.ptr());
+    if (result_len == 0) {
+        return result;
+    }
+
+    TaintRangeRefs result_ranges;
+    Py_ssize_t cursor = 0;
+    for (const auto& part : parts) {
+        if (not PyUnicode_Check(part.ptr())) {
+            continue;
+        }
+        const auto part_len = PyUnicode_GET_LENGTH(part.ptr());
+        if (part_len == 0) {
+            continue;
+        }
+        const auto pos = PyUnicode_Find(result.ptr(), part.ptr(), cursor, result_len, 1);
+        if (pos == -2) {
+            throw py::error_already_set();
+        }
+        if (pos < 0) {
+            continue;
+        }
+        if (auto [ranges, ranges_error] = get_ranges(part.ptr(), tx_map); not ranges_error) {
+            for (auto& trange : ranges) {
+                result_ranges.emplace_back(
+                  shift_taint_range(trange, static_cast<RANGE_START>(pos), static_cast<RANGE_LENGTH>(part_len)));
+            }
+        }
+        cursor = pos + part_len;
+    }
+
+    if (not result_ranges.empty()) {
+        set_ranges(result.ptr(), result_ranges, tx_map);
+    }
+    return result;
+}
+
+/**
+ * Taint an accessor result that is a contiguous piece of str(path): name and
+ * suffix sit at the tail (from_end), parent and drive at the head. The piece
+ * is located in the source and the source's ranges are clipped to that span
+ * with the same machinery the re aspects use for match groups.
+ */
+py::object
+api_pathlib_taint_part(const py::object& target, const py::handle& source, const bool from_end)
+{
+    const auto tx_map = Initializer::get_tainting_map();
+    if (not tx_map or tx_map->empty() or not PyUnicode_Check(target.ptr()) or not PyUnicode_Check(source.ptr())) {
+        return target;
+    }
+    const auto target_len = PyUnicode_GET_LENGTH(target.ptr());
+    const auto source_len = PyUnicode_GET_LENGTH(source.ptr());
+    if (target_len == 0 or source_len == 0) {
+        return target;
+    }
+    const auto [ranges, ranges_error] = get_ranges(source.ptr(), tx_map);
+    if (ranges_error or ranges.empty()) {
+        return target;
+    }
+
+    const auto pos = PyUnicode_Find(source.ptr(), target.ptr(), 0, source_len, from_end ? -1 : 1);
+    if (pos == -2) {
+        throw py::error_already_set();
+    }
+    if (pos < 0) {
+        return target;
+    }
+
+    if (auto clipped =
+          ranges_for_span(ranges, static_cast<RANGE_START>(pos), static_cast<RANGE_START>(pos + target_len));
+        not clipped.empty()) {
+        set_ranges(target.ptr(), clipped, tx_map);
+    }
+    return target;
+}
+
+void
+pyexport_pathlib_aspects(py::module& m)
+{
+    m.def("_pathlib_taint_joined", &api_pathlib_taint_joined, "result"_a, "parts"_a, py::return_value_policy::move);
+    m.def("_pathlib_taint_part",
+          &api_pathlib_taint_part,
+          "target"_a,
+          "source"_a,
+          "from_end"_a,
+          py::return_value_policy::move);
+}
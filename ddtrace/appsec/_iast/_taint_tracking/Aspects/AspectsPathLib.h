@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Helpers.h"
+
+py::object
+api_pathlib_taint_joined(const py::object& result, const py::tuple& parts);
+
+py::object
+api_pathlib_taint_part(const py::object& target, const py::handle& source, bool from_end);
+
+void
+pyexport_pathlib_aspects(py::module& m);
@@ -3,40 +3,127 @@
 #include "Utils/PythonErrorGuard.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
 
 using namespace pybind11::literals;
 namespace py = pybind11;
 
 /**
- * @brief This function is used to get the taint ranges for the given text object.
+ * @brief Calls the given string method on candidate_text and copies the taint
+ * ranges of candidate_text onto the result.
  *
- * @param string_method The string method to be used.
- * @param candidate_text The text object for which the taint ranges are to be built.
- * @param args The arguments to be passed to the string method.
- * @param kwargs The keyword arguments to be passed to the string method.
+ * Fastcall layout: (string_method, candidate_text, *args, **kwargs).
  */
-template<class StrType>
-StrType
-api_common_replace(const py::str& string_method,
-                   const StrType& candidate_text,
-                   const py::args& args,
-                   const py::kwargs& kwargs)
+PyObject*
+api_common_replace(PyObject* self, PyObject* const* args, const Py_ssize_t nargs, PyObject* kwnames)
 {
-    const StrType res = py::getattr(candidate_text, string_method)(*args, **kwargs);
+    if (nargs < 2) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+    PyObject* string_method = args[0];
+    PyObject* candidate_text = args[1];
+
+#if PY_VERSION_HEX >= 0x03090000
+    // args[1:] is already a vectorcall frame with candidate_text as self, so
+    // the method call needs no argument tuple, kwargs dict or getattr
+    PyObject* res_ptr = PyObject_VectorcallMethod(string_method, args + 1, nargs - 1, kwnames);
+    if (res_ptr == nullptr) {
+        return nullptr;
+    }
+    try {
+        auto res = py::reinterpret_steal<py::object>(res_ptr);
+#else
+    PyObject* rest = PyTuple_New(nargs - 2);
+    if (rest == nullptr) {
+        return nullptr;
+    }
+    for (Py_ssize_t i = 2; i < nargs; ++i) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(rest, i - 2, args[i]);
+    }
+    const auto py_args = py::reinterpret_steal<py::args>(rest);
 
-    const auto tx_map = Initializer::get_tainting_map();
-    if (not tx_map or tx_map->empty()) {
-        return res;
+    PyObject* kwargs_dict = kwnames_to_kwargs(args, static_cast<int>(nargs), kwnames);
+    if (kwargs_dict == nullptr) {
+        return nullptr;
     }
-    auto [candidate_text_ranges, ranges_error] = get_ranges(candidate_text.ptr(), tx_map);
+    const auto py_kwargs = py::reinterpret_steal<py::kwargs>(kwargs_dict);
+
+    try {
+        py::object res =
+          py::getattr(py::reinterpret_borrow<py::object>(candidate_text), string_method)(*py_args, **py_kwargs);
+#endif
+
+        const auto tx_map = Initializer::get_tainting_map();
+        if (not tx_map or tx_map->empty()) {
+            return res.release().ptr();
+        }
+        // Borrowed view: set_ranges copies into the result's own tainted
+        // object, so the identity shift_taint_ranges(.., 0, -1) copy is gone
+        const auto candidate_text_ranges = get_ranges_view(candidate_text, tx_map);
+
+        if (candidate_text_ranges.error or candidate_text_ranges.empty()) {
+            return res.release().ptr();
+        }
+
+        // The wrapped methods (upper/lower/title/...) preserve the length for
+        // ASCII-dominant data, and equal lengths mean the offsets are valid
+        // as-is: share the input's range list copy-on-write (one refcount
+        // bump) instead of copying it range by range. Length-changing results
+        // (rare Unicode case folds) keep the copying path.
+        const Py_ssize_t res_len = PyObject_Length(res.ptr());
+        const Py_ssize_t text_len = res_len == -1 ? -1 : PyObject_Length(candidate_text);
+        if (res_len != -1 and res_len == text_len) {
+            set_fast_tainted_if_notinterned_unicode(res.ptr());
+            set_fast_tainted_if_bytes(res.ptr());
+            tx_map->put(get_unique_id(res.ptr()),
+                        get_internal_hash(res.ptr()),
+                        initializer->allocate_tainted_object_copy(candidate_text_ranges.owner));
+            return res.release().ptr();
+        }
+        if (res_len == -1) {
+            PyErr_Clear();
+        }
 
-    if (ranges_error or candidate_text_ranges.empty()) {
-        return res;
+        set_ranges(res.ptr(), *candidate_text_ranges, tx_map);
+        return res.release().ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
     }
+}
 
-    set_ranges(res.ptr(), shift_taint_ranges(candidate_text_ranges, 0, -1), tx_map);
-    return res;
+/**
+ * Resolves the byte offset in UTF-8 text of each code-point position in
+ * `positions` (sorted, unique, clamped to [0, code-point count]) with a
+ * single forward walk; positions past the end map to text.size().
+ */
+static vector<size_t>
+utf8_byte_offsets(const string& text, const vector<long>& positions)
+{
+    vector<size_t> offsets(positions.size());
+    size_t wanted = 0;
+    size_t byte = 0;
+    long cp = 0;
+    while (wanted < positions.size()) {
+        if (cp == positions[wanted]) {
+            offsets[wanted++] = byte;
+            continue;
+        }
+        if (byte >= text.size()) {
+            offsets[wanted++] = text.size();
+            continue;
+        }
+        // Advance one code point: skip the lead byte plus its continuations
+        do {
+            ++byte;
+        } while (byte < text.size() and (static_cast<unsigned char>(text[byte]) & 0xC0) == 0x80);
+        cp++;
+    }
+    return offsets;
 }
 
 string
@@ -45,58 +132,134 @@ as_formatted_evidence(const string& text,
                       const optional<TagMappingMode>& tag_mapping_mode,
                       const optional<const py::dict>& new_ranges)
 {
-    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map) {
+    // A pending lazy context counts as active: explicit ranges must still be
+    // formatted, as an eagerly created (empty) map would have allowed
+    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map and not Initializer::context_is_pending()) {
         return text;
     }
 
     if (text_ranges.empty() or text.empty()) {
         return text;
     }
-    vector<string> res_vector;
-    long index = 0;
 
     sort(text_ranges.begin(), text_ranges.end(), &range_sort);
-    auto pystr = py::str(text);
 
-    for (const auto& taint_range : text_ranges) {
-        string content;
+    // Tags first: their sizes are part of the exact output size. Normal mode
+    // reuses the tag cached on the interned source; the mapper modes build
+    // per-range tags into stable owned storage.
+    static const string EMPTY_TAG{};
+    vector<const string*> tags(text_ranges.size(), &EMPTY_TAG);
+    vector<string> owned_tags;
+    owned_tags.reserve(text_ranges.size());
+    for (size_t i = 0; i < text_ranges.size(); i++) {
+        const auto& taint_range = text_ranges[i];
         if (!tag_mapping_mode or tag_mapping_mode.value() == TagMappingMode::Normal) {
-            content = get_default_content(taint_range);
+            if (taint_range.source) {
+                tags[i] = &taint_range.source->evidence_tag();
+            }
         } else
             switch (*tag_mapping_mode) {
                 case TagMappingMode::Mapper: {
-                    content = to_string(taint_range->get_hash());
+                    owned_tags.emplace_back(get_tag(to_string(taint_range.get_hash())));
+                    tags[i] = &owned_tags.back();
                     break;
                 }
                 case TagMappingMode::Mapper_Replace: {
-                    content = mapper_replace(taint_range, new_ranges);
+                    owned_tags.emplace_back(get_tag(mapper_replace(taint_range, new_ranges)));
+                    tags[i] = &owned_tags.back();
                     break;
                 }
                 default: {
                     // Nothing
                 }
             }
+    }
 
-        const auto tag = get_tag(content);
-
-        const auto range_end = taint_range->start + taint_range->length;
-
-        res_vector.push_back(slice_pystr_to_string(pystr, index, taint_range->start));
-        res_vector.emplace_back(EVIDENCE_MARKS::START_EVIDENCE);
-        res_vector.push_back(tag);
-        res_vector.push_back(slice_pystr_to_string(pystr, taint_range->start, range_end));
-        res_vector.push_back(tag);
-        res_vector.emplace_back(EVIDENCE_MARKS::END_EVIDENCE);
+    // Range positions are code points but the output is assembled in UTF-8
+    // bytes: for pure ASCII they coincide, otherwise one walk over the text
+    // resolves every range boundary to its byte offset
+    const bool is_ascii =
+      std::none_of(text.begin(), text.end(), [](const char c) { return static_cast<unsigned char>(c) >= 0x80; });
+    long cp_count = static_cast<long>(text.size());
+    if (not is_ascii) {
+        cp_count = 0;
+        for (const char c : text) {
+            cp_count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        }
+    }
+    const auto clamp_cp = [cp_count](const long position) {
+        return position < 0 ? 0L : (position > cp_count ? cp_count : position);
+    };
+
+    vector<long> boundaries;
+    vector<size_t> boundary_bytes;
+    if (not is_ascii) {
+        boundaries.reserve(text_ranges.size() * 2 + 2);
+        boundaries.push_back(0);
+        for (const auto& taint_range : text_ranges) {
+            boundaries.push_back(clamp_cp(taint_range.start));
+            boundaries.push_back(clamp_cp(taint_range.start + taint_range.length));
+        }
+        boundaries.push_back(cp_count);
+        sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(unique(boundaries.begin(), boundaries.end()), boundaries.end());
+        boundary_bytes = utf8_byte_offsets(text, boundaries);
+    }
+    const auto byte_at = [&](const long position) -> size_t {
+        const long clamped = clamp_cp(position);
+        if (is_ascii) {
+            return static_cast<size_t>(clamped);
+        }
+        const auto it = std::lower_bound(boundaries.begin(), boundaries.end(), clamped);
+        return boundary_bytes[static_cast<size_t>(it - boundaries.begin())];
+    };
+
+    // First pass computes the exact output size, second pass writes the
+    // segments into the single pre-sized buffer
+    const size_t marks_size = strlen(EVIDENCE_MARKS::START_EVIDENCE) + strlen(EVIDENCE_MARKS::END_EVIDENCE);
+    size_t total_size = 0;
+    long index = 0;
+    for (size_t i = 0; i < text_ranges.size(); i++) {
+        const auto& taint_range = text_ranges[i];
+        const long range_end = taint_range.start + taint_range.length;
+        if (taint_range.start > index) {
+            total_size += byte_at(taint_range.start) - byte_at(index);
+        }
+        if (range_end > taint_range.start) {
+            total_size += byte_at(range_end) - byte_at(taint_range.start);
+        }
+        total_size += tags[i]->size() * 2 + marks_size;
+        index = range_end;
+    }
+    if (cp_count > index) {
+        total_size += text.size() - byte_at(index);
+    }
 
+    string result;
+    result.reserve(total_size);
+    index = 0;
+    for (size_t i = 0; i < text_ranges.size(); i++) {
+        const auto& taint_range = text_ranges[i];
+        const long range_end = taint_range.start + taint_range.length;
+        if (taint_range.start > index) {
+            const size_t from = byte_at(index);
+            result.append(text, from, byte_at(taint_range.start) - from);
+        }
+        result.append(EVIDENCE_MARKS::START_EVIDENCE);
+        result.append(*tags[i]);
+        if (range_end > taint_range.start) {
+            const size_t from = byte_at(taint_range.start);
+            result.append(text, from, byte_at(range_end) - from);
+        }
+        result.append(*tags[i]);
+        result.append(EVIDENCE_MARKS::END_EVIDENCE);
         index = range_end;
     }
-    res_vector.push_back(slice_pystr_to_string(pystr, index, py::len(pystr)));
-    ostringstream oss;
-    for (const auto& str : res_vector) {
-        oss << str;
+    if (cp_count > index) {
+        result.append(text, byte_at(index), string::npos);
     }
 
-    return oss.str();
+    return result;
 }
 
 template<class StrType>
@@ -106,7 +269,7 @@ api_as_formatted_evidence(const StrType& text,
                           const optional<TagMappingMode>& tag_mapping_mode,
                           const optional<const py::dict>& new_ranges)
 {
-    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map) {
+    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map and not Initializer::context_is_pending()) {
         return text;
     }
 
@@ -122,8 +285,8 @@ api_as_formatted_evidence(const StrType& text,
 py::bytearray
 api_convert_escaped_text_to_taint_text(const py::bytearray& taint_escaped_text, const TaintRangeRefs& ranges_orig)
 {
-
-    const auto tx_map = Initializer::get_tainting_map();
+    // Writes caller-provided ranges: materializes a lazily created context
+    const auto tx_map = Initializer::get_or_create_tainting_map();
 
     const py::bytes bytes_text = py::bytes() + taint_escaped_text;
 
@@ -137,7 +300,7 @@ template<class StrType>
 StrType
 api_convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const TaintRangeRefs& ranges_orig)
 {
-    const auto tx_map = Initializer::get_tainting_map();
+    const auto tx_map = Initializer::get_or_create_tainting_map();
 
     auto [result_text, result_ranges] = convert_escaped_text_to_taint_text<StrType>(taint_escaped_text, ranges_orig);
     PyObject* new_result = new_pyobject_id(result_text.ptr());
@@ -192,7 +355,19 @@ convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const Tain
 
     string taint_escaped_string = py::cast<string>(taint_escaped_text);
     vector<string> texts_and_marks = split_taints(taint_escaped_string);
-    optional<TaintRangeRefs> optional_ranges_orig = ranges_orig;
+
+    // Hash-indexed lookup built once per conversion: every tag occurrence
+    // used to rescan the whole range list, rehashing each candidate, which
+    // made the walk O(tags x ranges)
+    unordered_map<size_t, const TaintRange*> ranges_by_hash;
+    ranges_by_hash.reserve(ranges_orig.size());
+    for (const auto& range : ranges_orig) {
+        ranges_by_hash.emplace(range.get_hash(), &range);
+    }
+    const auto find_range = [&ranges_by_hash](const size_t range_hash) -> const TaintRange* {
+        const auto it = ranges_by_hash.find(range_hash);
+        return it == ranges_by_hash.end() ? nullptr : it->second;
+    };
 
     vector<tuple<string, int>> context_stack;
     int length = 0;
@@ -215,8 +390,7 @@ convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const Tain
         }
         if (element.rfind(startswith_element, 0) == 0) {
             id_evidence = element.substr(4, element.length() - 5);
-            if (auto range_by_id = get_range_by_hash(getNum(id_evidence), optional_ranges_orig);
-                range_by_id == nullptr) {
+            if (find_range(getNum(id_evidence)) == nullptr) {
                 result += element;
                 length = py::len(StrType(element));
                 end += length;
@@ -236,9 +410,8 @@ convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const Tain
 
                 if (start != end) {
                     id_evidence = get<0>(previous_context);
-                    const shared_ptr<TaintRange>& original_range =
-                      get_range_by_hash(getNum(id_evidence), optional_ranges_orig);
-                    ranges.emplace_back(initializer->allocate_taint_range(start, length, original_range->source));
+                    const auto* original_range = find_range(getNum(id_evidence));
+                    ranges.emplace_back(start, length, original_range->source);
                 }
                 latest_end = end;
             }
@@ -247,8 +420,7 @@ convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const Tain
             context_stack.emplace_back(id_evidence, start);
         } else {
             id_evidence = element.substr(1, element.length() - 5);
-            if (auto range_by_id = get_range_by_hash(getNum(id_evidence), optional_ranges_orig);
-                range_by_id == nullptr) {
+            if (find_range(getNum(id_evidence)) == nullptr) {
                 result += element;
                 length = py::len(StrType(element));
                 end += length;
@@ -267,9 +439,8 @@ convert_escaped_text_to_taint_text(const StrType& taint_escaped_text, const Tain
 
             if (start != end) {
                 id_evidence = get<0>(context);
-                const shared_ptr<TaintRange>& original_range =
-                  get_range_by_hash(getNum(id_evidence), optional_ranges_orig);
-                ranges.emplace_back(initializer->allocate_taint_range(start, end - start, original_range->source));
+                const auto* original_range = find_range(getNum(id_evidence));
+                ranges.emplace_back(start, end - start, original_range->source);
             }
             latest_end = end;
         }
@@ -296,42 +467,61 @@ set_ranges_on_splitted(const py::object& source_str,
                        bool include_separator)
 {
     RANGE_START offset = 0;
-    bool some_set = false;
 
     if (source_ranges.empty() or py::len(split_result) == 0 or py::len(source_str) == 0 or not tx_map or
         tx_map->empty()) {
         return false;
     }
 
+    // Single pass: sort the parent ranges by start once and advance a cursor
+    // as the fragment offsets grow, instead of rescanning the whole range
+    // list for every produced fragment.
+    TaintRangeRefs sorted_ranges(source_ranges);
+    std::sort(sorted_ranges.begin(), sorted_ranges.end(), &range_sort);
+
+    std::vector<TaintRangeMapType::BatchEntry> batch;
+    // One reservation up front: at most one entry per fragment, so splitting
+    // a large document never regrows the batch mid-pass
+    batch.reserve(static_cast<size_t>(py::len(split_result)));
+    size_t cursor = 0;
+
     for (const auto& item : split_result) {
         if (not is_text(item.ptr()) or py::len(item) == 0) {
             continue;
         }
+        const RANGE_START part_len = py::len(item);
+        const RANGE_START part_start = offset;
+        const RANGE_START part_end = part_start + part_len;
+
+        // A range ending at or before this fragment can't overlap any later
+        // fragment either, since fragment offsets only grow
+        while (cursor < sorted_ranges.size() and
+               sorted_ranges[cursor].start + sorted_ranges[cursor].length <= part_start) {
+            ++cursor;
+        }
+
         TaintRangeRefs item_ranges;
-        RANGE_START part_len = py::len(item);
-        RANGE_START part_start = offset;
-        RANGE_START part_end = part_start + part_len;
-
-        // bool first = true;
-        for (const auto& range : source_ranges) {
-            RANGE_START range_start = range->start;
-            RANGE_START range_end = range->start + range->length;
-
-            // Check for overlap
-            if (range_start < part_end && range_end > part_start) {
-                RANGE_START new_start = std::max(range_start - part_start, 0L);
-                RANGE_START new_end = std::min(range_end - part_start, part_len);
-                RANGE_START new_length = std::min(new_end - new_start, part_len);
-
-                if (new_length > 0) {
-                    item_ranges.emplace_back(initializer->allocate_taint_range(new_start, new_length, range->source));
-                }
+        for (size_t i = cursor; i < sorted_ranges.size(); ++i) {
+            const auto& range = sorted_ranges[i];
+            if (range.start >= part_end) {
+                break;
+            }
+            const RANGE_START range_end = range.start + range.length;
+            const RANGE_START new_start = std::max(range.start - part_start, 0L);
+            const RANGE_START new_end = std::min(range_end - part_start, part_len);
+            const RANGE_START new_length = std::min(new_end - new_start, part_len);
+
+            if (new_length > 0) {
+                item_ranges.emplace_back(new_start, new_length, range.source);
             }
         }
 
         if (not item_ranges.empty()) {
-            set_ranges(item.ptr(), item_ranges, tx_map);
-            some_set = true;
+            set_fast_tainted_if_notinterned_unicode(item.ptr());
+            set_fast_tainted_if_bytes(item.ptr());
+            batch.emplace_back(get_unique_id(item.ptr()),
+                               get_internal_hash(item.ptr()),
+                               initializer->allocate_ranges_into_taint_object(std::move(item_ranges)));
         }
         offset += part_len;
 
@@ -340,7 +530,122 @@ set_ranges_on_splitted(const py::object& source_str,
         }
     }
 
-    return some_set;
+    if (batch.empty()) {
+        return false;
+    }
+    // Store all the fragments in one taint-map transaction
+    tx_map->put_batch(batch);
+    return true;
+}
+
+/**
+ * Splitlines variant of set_ranges_on_splitted with exact fragment offsets.
+ *
+ * The generic helper assumes one separator character between fragments, which
+ * drifts on "\r\n" pairs (two characters): every range after the first pair
+ * lands one position early in the following lines. Instead of guessing, the
+ * exact start of each line is recovered from the parent buffer in a single
+ * forward pass: splitlines fragments are verbatim substrings in document
+ * order, so only the terminator width after each one has to be read -- one
+ * code point, or two for "\r\n", the only multi-character terminator of both
+ * str.splitlines and bytes.splitlines. With keepends the fragments are
+ * contiguous and no terminator is consumed.
+ *
+ * Returns false when the parent buffer cannot be scanned (not str/bytes/
+ * bytearray, or the fragments don't fit the buffer, e.g. a subclass rewrote
+ * them); the caller can then fall back to the generic approximation.
+ */
+bool
+set_ranges_on_splitlines(const py::object& source_str,
+                         const TaintRangeRefs& source_ranges,
+                         const py::list& split_result,
+                         const TaintRangeMapTypePtr& tx_map,
+                         const bool keepends)
+{
+    if (source_ranges.empty() or py::len(split_result) == 0 or py::len(source_str) == 0 or not tx_map or
+        tx_map->empty()) {
+        return true; // nothing to taint, but nothing the fallback could do better
+    }
+
+    PyObject* const text = source_str.ptr();
+    const auto text_len = static_cast<RANGE_START>(py::len(source_str));
+    int kind = 0;
+    const void* data = nullptr;
+    const char* raw = nullptr;
+    if (PyUnicode_Check(text)) {
+        kind = PyUnicode_KIND(text);
+        data = PyUnicode_DATA(text);
+    } else if (PyBytes_Check(text)) {
+        raw = PyBytes_AS_STRING(text);
+    } else if (PyByteArray_Check(text)) {
+        raw = PyByteArray_AS_STRING(text);
+    } else {
+        return false;
+    }
+    const auto char_at = [kind, data, raw](const RANGE_START pos) -> Py_UCS4 {
+        return data != nullptr ? PyUnicode_READ(kind, data, pos)
+                               : static_cast<Py_UCS4>(static_cast<unsigned char>(raw[pos]));
+    };
+
+    TaintRangeRefs sorted_ranges(source_ranges);
+    std::sort(sorted_ranges.begin(), sorted_ranges.end(), &range_sort);
+
+    std::vector<TaintRangeMapType::BatchEntry> batch;
+    batch.reserve(static_cast<size_t>(py::len(split_result)));
+    size_t cursor = 0;
+    RANGE_START offset = 0;
+
+    for (const auto& item : split_result) {
+        const RANGE_START part_len = is_text(item.ptr()) ? static_cast<RANGE_START>(py::len(item)) : -1;
+        const RANGE_START part_start = offset;
+        const RANGE_START part_end = part_start + part_len;
+        if (part_len < 0 or part_end > text_len) {
+            return false;
+        }
+
+        while (cursor < sorted_ranges.size() and
+               sorted_ranges[cursor].start + sorted_ranges[cursor].length <= part_start) {
+            ++cursor;
+        }
+
+        TaintRangeRefs item_ranges;
+        for (size_t i = cursor; i < sorted_ranges.size(); ++i) {
+            const auto& range = sorted_ranges[i];
+            if (range.start >= part_end) {
+                break;
+            }
+            const RANGE_START new_start = std::max(range.start - part_start, 0L);
+            const RANGE_START new_end = std::min(range.start + range.length - part_start, part_len);
+
+            if (new_end > new_start) {
+                item_ranges.emplace_back(new_start, new_end - new_start, range.source);
+            }
+        }
+
+        if (not item_ranges.empty()) {
+            set_fast_tainted_if_notinterned_unicode(item.ptr());
+            set_fast_tainted_if_bytes(item.ptr());
+            batch.emplace_back(get_unique_id(item.ptr()),
+                               get_internal_hash(item.ptr()),
+                               initializer->allocate_ranges_into_taint_object(std::move(item_ranges)));
+        }
+
+        // Unlike the generic helper, empty fragments still advance the offset:
+        // a blank line's terminator is part of the document too
+        offset += part_len;
+        if (not keepends and offset < text_len) {
+            const Py_UCS4 terminator = char_at(offset);
+            offset += 1;
+            if (terminator == '\r' and offset < text_len and char_at(offset) == '\n') {
+                offset += 1;
+            }
+        }
+    }
+
+    if (not batch.empty()) {
+        tx_map->put_batch(batch);
+    }
+    return true;
 }
 
 template<class StrType>
@@ -360,8 +665,8 @@ api_set_ranges_on_splitted(const StrType& source_str,
 bool
 has_pyerr()
 {
-    PythonErrorGuard error_guard;
-    return error_guard.has_error();
+    // Pure boolean check: no need to fetch/restore the error state
+    return PyErr_Occurred() != nullptr;
 }
 
 std::string
@@ -386,24 +691,15 @@ has_pyerr_as_pystr()
     return error_guard.error_as_pystr();
 }
 
+static PyMethodDef CommonReplaceMethods[] = {
+    { "common_replace", (PyCFunction)api_common_replace, METH_FASTCALL | METH_KEYWORDS, "common replace" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
 void
 pyexport_aspect_helpers(py::module& m)
 {
-    m.def("common_replace",
-          &api_common_replace<py::bytes>,
-          "string_method"_a,
-          "candidate_text"_a,
-          py::return_value_policy::move);
-    m.def("common_replace",
-          &api_common_replace<py::str>,
-          "string_method"_a,
-          "candidate_text"_a,
-          py::return_value_policy::move);
-    m.def("common_replace",
-          &api_common_replace<py::bytearray>,
-          "string_method"_a,
-          "candidate_text"_a,
-          py::return_value_policy::move);
+    PyModule_AddFunctions(m.ptr(), CommonReplaceMethods);
     m.def("set_ranges_on_splitted",
           &api_set_ranges_on_splitted<py::bytes>,
           "source_str"_a,
@@ -13,12 +13,8 @@ namespace py = pybind11;
 // Calls the specified method and applies the same ranges to the result. Used
 // for wrapping simple methods that doesn't change the string size like upper(),
 // lower() and similar.
-template<class StrType>
-StrType
-api_common_replace(const py::str& string_method,
-                   const StrType& candidate_text,
-                   const py::args& args,
-                   const py::kwargs& kwargs);
+PyObject*
+api_common_replace(PyObject* self, PyObject* const* args, Py_ssize_t nargs, PyObject* kwnames);
 
 template<class StrType>
 StrType
@@ -35,7 +31,9 @@ template<class StrType>
 StrType
 int_as_formatted_evidence(const StrType& text, TaintRangeRefs& text_ranges, TagMappingMode tag_mapping_mode)
 {
-    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map) {
+    // A pending lazy context counts as active: the caller's explicit ranges
+    // must still be formatted, as an eagerly created (empty) map would
+    if (const auto tx_map = Initializer::get_tainting_map(); !tx_map and not Initializer::context_is_pending()) {
         return text;
     }
     return StrType(as_formatted_evidence(AnyTextObjectToString(text), text_ranges, tag_mapping_mode, nullopt));
@@ -72,6 +70,13 @@ set_ranges_on_splitted(const py::object& source_str,
                        const TaintRangeMapTypePtr& tx_map,
                        bool include_separator = false);
 
+bool
+set_ranges_on_splitlines(const py::object& source_str,
+                         const TaintRangeRefs& source_ranges,
+                         const py::list& split_result,
+                         const TaintRangeMapTypePtr& tx_map,
+                         bool keepends);
+
 template<class StrType>
 bool
 api_set_ranges_on_splitted(const StrType& source_str,
@@ -102,9 +107,9 @@ struct EVIDENCE_MARKS
 };
 
 inline bool
-range_sort(const TaintRangePtr& t1, const TaintRangePtr& t2)
+range_sort(const TaintRange& t1, const TaintRange& t2)
 {
-    return t1->start < t2->start;
+    return t1.start < t2.start;
 }
 
 inline string
@@ -118,10 +123,10 @@ get_tag(const string& content)
 }
 
 inline string
-get_default_content(const TaintRangePtr& taint_range)
+get_default_content(const TaintRange& taint_range)
 {
-    if (!taint_range->source.name.empty()) {
-        return taint_range->source.name;
+    if (taint_range.source and !taint_range.source->name.empty()) {
+        return taint_range.source->name;
     }
 
     return {};
@@ -132,19 +137,19 @@ get_default_content(const TaintRangePtr& taint_range)
 /**
  * @brief Replaces a taint range with a new range from the provided dictionary.
  *
- * This function takes a `TaintRangePtr` and an optional dictionary of new ranges.
+ * This function takes a `TaintRange` and an optional dictionary of new ranges.
  * If the `taint_range` is found in the dictionary, it is replaced with the corresponding new range.
  * If the `taint_range` is not found or if `new_ranges` is null, an empty string is returned.
  *
- * @param taint_range A shared pointer to the original taint range.
+ * @param taint_range The original taint range.
  * @param new_ranges An optional dictionary containing new taint ranges.
  * @return A string representation of the hash of the new taint range if replaced, otherwise an empty string.
  */
 inline string
-mapper_replace(const TaintRangePtr& taint_range, const optional<const py::dict>& new_ranges)
+mapper_replace(const TaintRange& taint_range, const optional<const py::dict>& new_ranges)
 {
 
-    if (!taint_range or !new_ranges.has_value() or py::len(new_ranges.value()) == 0) {
+    if (!new_ranges.has_value() or py::len(new_ranges.value()) == 0) {
         return {};
     }
 
@@ -226,17 +231,64 @@ process_flag_added_args(PyObject* orig_function, const int flag_added_args, PyOb
  * std::vector<std::string> result = split_taints(tainted_str);
  * // result will be: ["This ", ":+-<123>-+:", "is a ", ":+-<456>-+:", "test."]
  */
+// Length of a "<id>" group at position i (id chars are [0-9.a-z-]), or 0 when
+// there is none
+inline size_t
+evidence_id_group_length(const string& str, const size_t i)
+{
+    if (i >= str.size() or str[i] != '<') {
+        return 0;
+    }
+    size_t j = i + 1;
+    while (j < str.size() and
+           ((str[j] >= '0' and str[j] <= '9') or (str[j] >= 'a' and str[j] <= 'z') or str[j] == '.' or str[j] == '-')) {
+        j++;
+    }
+    if (j == i + 1 or j >= str.size() or str[j] != '>') {
+        return 0;
+    }
+    return j - i + 1;
+}
+
 inline vector<string>
 split_taints(const string& str_to_split)
 {
-    const std::regex rgx(R"((:\+-(<[0-9.a-z\-]+>)?|(<[0-9.a-z\-]+>)?-\+:))");
-    std::sregex_token_iterator iter(str_to_split.begin(), str_to_split.end(), rgx, { -1, 0 });
+    // Single indexed pass instead of a std::regex scan: the markers are plain
+    // literals (":+-", "-+:") with an optional "<id>" group, so matching them
+    // by hand avoids compiling the pattern and the regex engine's per-call
+    // allocations. Token order and boundaries match the previous pattern
+    // (:\+-(<id>)? | (<id>)?-\+:), including the empty text segments between
+    // back-to-back markers.
     vector<string> res;
-
-    for (const std::sregex_token_iterator end; iter != end; ++iter) {
-        res.push_back(*iter);
+    const size_t size = str_to_split.size();
+    size_t text_start = 0;
+    size_t i = 0;
+    while (i < size) {
+        size_t token_length = 0;
+        if (str_to_split.compare(i, 3, ":+-") == 0) {
+            token_length = 3 + evidence_id_group_length(str_to_split, i + 3);
+        } else if (str_to_split[i] == '<') {
+            if (const size_t id_length = evidence_id_group_length(str_to_split, i);
+                id_length != 0 and str_to_split.compare(i + id_length, 3, "-+:") == 0) {
+                token_length = id_length + 3;
+            }
+        } else if (str_to_split.compare(i, 3, "-+:") == 0) {
+            token_length = 3;
+        }
+        if (token_length == 0) {
+            ++i;
+            continue;
+        }
+        res.emplace_back(str_to_split, text_start, i - text_start);
+        res.emplace_back(str_to_split, i, token_length);
+        i += token_length;
+        text_start = i;
+    }
+    // The suffix is emitted when non-empty, and also for a marker-less input
+    // (the old tokenizer returned the whole string as a single element)
+    if (text_start < size or res.empty()) {
+        res.emplace_back(str_to_split, text_start, size - text_start);
     }
-
     return res;
 }
 
@@ -309,6 +361,53 @@ kwnames_to_kwargs(PyObject* const* args, int nargs, PyObject* kwnames)
     return kwargs;
 }
 
+/**
+ * Fast-path variant of process_flag_added_args for METH_FASTCALL aspects.
+ * When the call must be delegated to orig_function it is vectorcalled on the
+ * borrowed argument window: keyword values already sit right after the
+ * positional ones in `args`, exactly the vectorcall layout, so slicing off
+ * the flag arguments is free and no tuple or dict is built. Returns true
+ * when the call was delegated, with *result holding the outcome (nullptr on
+ * error); false means the caller proceeds with the aspect on the same
+ * borrowed window.
+ */
+inline bool
+process_flag_added_args_fastcall(PyObject* orig_function,
+                                 const int flag_added_args,
+                                 PyObject* const* args,
+                                 const Py_ssize_t nargs,
+                                 PyObject* kwnames,
+                                 PyObject** result)
+{
+    if (const auto orig_function_type = Py_TYPE(orig_function);
+        orig_function != Py_None && orig_function_type != &PyUnicode_Type && orig_function_type != &PyByteArray_Type &&
+        orig_function_type != &PyBytes_Type) {
+        Py_ssize_t skip = flag_added_args > 0 ? flag_added_args : 0;
+        if (skip > nargs) {
+            skip = nargs;
+        }
+#if PY_VERSION_HEX >= 0x03090000
+        *result = PyObject_Vectorcall(orig_function, args + skip, nargs - skip, kwnames);
+#else
+        PyObject* args_tuple = PyTuple_New(nargs - skip);
+        if (args_tuple == nullptr) {
+            *result = nullptr;
+            return true;
+        }
+        for (Py_ssize_t i = skip; i < nargs; ++i) {
+            Py_INCREF(args[i]);
+            PyTuple_SET_ITEM(args_tuple, i - skip, args[i]);
+        }
+        PyObject* kwargs = kwnames != nullptr ? kwnames_to_kwargs(args, static_cast<int>(nargs), kwnames) : nullptr;
+        *result = PyObject_Call(orig_function, args_tuple, kwargs);
+        Py_DECREF(args_tuple);
+        Py_XDECREF(kwargs);
+#endif
+        return true;
+    }
+    return false;
+}
+
 void
 pyexport_aspect_helpers(py::module& m);
 
@@ -1,7 +1,13 @@
 #pragma once
+#include "AspectEncodings.h"
 #include "AspectFormat.h"
+#include "AspectJson.h"
+#include "AspectMetrics.h"
+#include "AspectRegex.h"
+#include "AspectReplace.h"
 #include "AspectSplit.h"
 #include "AspectsOsPath.h"
+#include "AspectsPathLib.h"
 #include "Helpers.h"
 #include <pybind11/pybind11.h>
 
@@ -17,6 +23,24 @@ pyexport_m_aspect_helpers(py::module& m)
     py::module m_aspects_ospath = m.def_submodule("aspects_ospath", "Aspect os.path.join");
     pyexport_ospath_aspects(m_aspects_ospath);
 
+    py::module m_aspect_pathlib = m.def_submodule("aspect_pathlib", "Aspect pathlib");
+    pyexport_pathlib_aspects(m_aspect_pathlib);
+
+    py::module m_aspect_json = m.def_submodule("aspect_json", "Aspect json");
+    pyexport_json_aspects(m_aspect_json);
+
+    py::module m_aspect_encodings = m.def_submodule("aspect_encodings", "Aspect encodings");
+    pyexport_encodings_aspects(m_aspect_encodings);
+
     py::module m_aspect_split = m.def_submodule("aspect_split", "Aspect split");
     pyexport_aspect_split(m_aspect_split);
+
+    py::module m_aspect_regex = m.def_submodule("aspect_regex", "Aspect re");
+    pyexport_aspect_regex(m_aspect_regex);
+
+    py::module m_aspect_replace = m.def_submodule("aspect_replace", "Aspect replace");
+    pyexport_aspect_replace(m_aspect_replace);
+
+    // _native.metrics(): per-aspect hit/latency counters, top-level on purpose
+    pyexport_aspect_metrics(m);
 }
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Bump allocator backing the per-context TaintRange/TaintedObject storage.
+ *
+ * Objects are carved sequentially out of contiguous blocks, so allocations are
+ * a pointer bump and consecutive ranges stay cache-adjacent. Individual
+ * deallocations are no-ops: every live allocation holds a reference to the
+ * arena (through ArenaAllocator), so the blocks are released wholesale once
+ * the context is reset and the last referenced object dies.
+ */
+class Arena
+{
+  public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    void* allocate(size_t size)
+    {
+        // Keep every allocation maximally aligned so the same block can serve
+        // TaintRange and TaintedObject (and their shared_ptr control blocks).
+        size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+        if (blocks_.empty() or blocks_.back().used + size > blocks_.back().capacity) {
+            grow(size);
+        }
+        Block& block = blocks_.back();
+        void* ptr = block.data() + block.used;
+        block.used += size;
+        return ptr;
+    }
+
+    [[nodiscard]] size_t num_blocks() const { return blocks_.size(); }
+
+  private:
+    struct Block
+    {
+        unique_ptr<max_align_t[]> storage;
+        size_t used = 0;
+        size_t capacity = 0;
+
+        [[nodiscard]] char* data() const { return reinterpret_cast<char*>(storage.get()); }
+    };
+
+    void grow(const size_t min_size)
+    {
+        const size_t capacity = min_size > BLOCK_SIZE ? min_size : BLOCK_SIZE;
+        const size_t units = (capacity + sizeof(max_align_t) - 1) / sizeof(max_align_t);
+        blocks_.push_back(Block{ make_unique<max_align_t[]>(units), 0, units * sizeof(max_align_t) });
+    }
+
+    vector<Block> blocks_;
+};
+
+using ArenaPtr = shared_ptr<Arena>;
+
+/**
+ * STL-compatible allocator drawing from a shared Arena, meant to be used with
+ * allocate_shared so object and control block land in the same bump block.
+ */
+template<typename T>
+class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ArenaPtr arena) noexcept
+      : arena_(std::move(arena))
+    {
+    }
+
+    template<typename U>
+    explicit ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena_(other.arena())
+    {
+    }
+
+    T* allocate(const size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T))); }
+
+    // No-op: memory is reclaimed wholesale when the arena itself dies.
+    void deallocate(T*, size_t) noexcept {}
+
+    [[nodiscard]] const ArenaPtr& arena() const { return arena_; }
+
+  private:
+    ArenaPtr arena_;
+};
+
+template<typename T, typename U>
+bool
+operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template<typename T, typename U>
+bool
+operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return not(lhs == rhs);
+}
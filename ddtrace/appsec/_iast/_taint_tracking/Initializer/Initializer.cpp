@@ -1,32 +1,163 @@
 #include "Initializer.h"
 
+#include <atomic>
+#include <cstring>
 #include <thread>
 
 using namespace std;
 using namespace pybind11::literals;
 
-struct ThreadContextCache_
+struct TaintContextState_
 {
     TaintRangeMapTypePtr tx_map = nullptr;
-} ThreadContextCache;
+    // Bump arenas owning the TaintRange/TaintedObject storage of the current
+    // context, one per thread that has allocated in it; all dropped wholesale
+    // (together with any outstanding references) on reset_context().
+    // Registration is rare -- first allocation per thread per context -- and
+    // takes arenas_mutex; the hot allocation path only reads the
+    // thread-local cache below.
+    vector<ArenaPtr> arenas;
+    mutex arenas_mutex;
+    // Bumped on create_context and zeroed on reset so threads can detect
+    // that their cached arena belongs to a finished context
+    atomic<uint64_t> generation{ 0 };
+    // Allocation counters for the current context: charged against the taint
+    // budget (once over budget the context flips to pass-through and aspects
+    // propagate values without tracking) and exposed as O(1) telemetry via
+    // taint_stats(). Counted at allocation time rather than in
+    // set_tainted_object so the accounting never forces a deferred
+    // concatenation rope to flatten.
+    atomic<size_t> tainted_objects_allocated{ 0 };
+    atomic<size_t> taint_ranges_allocated{ 0 };
+    // Sum of the lengths of all allocated ranges, i.e. tainted text bytes
+    atomic<size_t> tainted_bytes{ 0 };
+    atomic<bool> saturated{ false };
+    // Set by create_context() instead of allocating anything: the map and
+    // arena generation materialize on the first actual taint write, so
+    // requests that never taint anything never build a context
+    atomic<bool> pending{ false };
+    // Per-context Source intern pool, keyed by Source::hash; dropped with the
+    // rest of the context state
+    unordered_map<size_t, SourcePtr> source_interns;
+};
+
+// Ceiling on tainted objects + ranges per context. A request tainting
+// pathological amounts of data stops being tracked past this point instead of
+// degrading the whole worker; bounded memory and latency, IAST stays enabled
+// for every other request.
+static constexpr size_t DEFAULT_CONTEXT_TAINT_BUDGET = 1000000;
+
+/**
+ * Everything the taint engine keeps per interpreter: the engine itself (map
+ * pools, active maps), the current context state, and the taint budget.
+ * Subinterpreters (PEP 684) each get their own instance, so they never
+ * contend on shared pools or clobber each other's contexts.
+ */
+struct InterpreterTaintState
+{
+    Initializer engine;
+    TaintContextState_ context;
+    size_t taint_budget = DEFAULT_CONTEXT_TAINT_BUDGET;
+};
+
+// Registry of per-interpreter state, keyed by the interpreter. Entries are
+// created lazily on first use from an interpreter and dropped by
+// InitializerHandle::reset() at that interpreter's teardown.
+static mutex interpreter_states_mutex;
+static unordered_map<PyInterpreterState*, unique_ptr<InterpreterTaintState>> interpreter_states;
+
+struct ThreadInterpCache_
+{
+    PyInterpreterState* interp = nullptr;
+    InterpreterTaintState* state = nullptr;
+};
+// Hot-path cache: one pointer compare instead of a lock + map probe. A thread
+// hopping between interpreters just refreshes it on the next access.
+thread_local ThreadInterpCache_ ThreadInterpCache;
+
+// Callers hold the GIL (all taint entry points do), which is what makes
+// PyInterpreterState_Get() and the registry access safe
+static InterpreterTaintState&
+interpreter_taint_state()
+{
+    auto* const interp = PyInterpreterState_Get();
+    if (ThreadInterpCache.interp == interp) {
+        return *ThreadInterpCache.state;
+    }
+    lock_guard<mutex> lock(interpreter_states_mutex);
+    auto& slot = interpreter_states[interp];
+    if (!slot) {
+        slot = make_unique<InterpreterTaintState>();
+    }
+    ThreadInterpCache = { interp, slot.get() };
+    return *slot;
+}
 
-Initializer::Initializer()
+static inline void
+charge_taint_budget(InterpreterTaintState& state, std::atomic<size_t>& counter)
 {
-    // Fill the taintedobjects stack
-    for (int i = 0; i < TAINTEDOBJECTS_STACK_SIZE; i++) {
-        available_taintedobjects_stack.push(make_shared<TaintedObject>());
+    counter.fetch_add(1, std::memory_order_relaxed);
+    if (state.context.tainted_objects_allocated.load(std::memory_order_relaxed) +
+          state.context.taint_ranges_allocated.load(std::memory_order_relaxed) >
+        state.taint_budget) {
+        state.context.saturated.store(true, std::memory_order_relaxed);
     }
+}
 
-    // Fill the ranges stack
-    for (int i = 0; i < TAINTRANGES_STACK_SIZE; i++) {
-        available_ranges_stack.push(make_shared<TaintRange>());
+struct ThreadArenaCache_
+{
+    ArenaPtr arena = nullptr;
+    uint64_t generation = 0;
+};
+// A stale entry (its generation no longer matching the context's) keeps at
+// most one empty-ish arena alive per idle thread until that thread allocates
+// again; live objects keep their arena referenced regardless.
+thread_local ThreadArenaCache_ ThreadArenaCache;
+
+/**
+ * Arena serving this thread's allocations in the current context, attaching a
+ * fresh one on the thread's first allocation so the bump pointer is never
+ * shared between threads. Returns nullptr when no context is active.
+ * Generations are process-unique (see create_context), so a matching cached
+ * generation implies the same context of the same interpreter.
+ */
+static ArenaPtr
+current_thread_arena(TaintContextState_& context)
+{
+    const uint64_t generation = context.generation.load(std::memory_order_acquire);
+    if (generation == 0) {
+        return nullptr;
+    }
+    if (ThreadArenaCache.generation == generation) {
+        return ThreadArenaCache.arena;
+    }
+    auto arena = make_shared<Arena>();
+    {
+        lock_guard<mutex> lock(context.arenas_mutex);
+        context.arenas.push_back(arena);
     }
+    ThreadArenaCache.arena = std::move(arena);
+    ThreadArenaCache.generation = generation;
+    return ThreadArenaCache.arena;
 }
 
+Initializer::Initializer() = default;
+
 TaintRangeMapTypePtr
 Initializer::create_tainting_map()
 {
-    auto map_ptr = make_shared<TaintRangeMapType>();
+    TaintRangeMapTypePtr map_ptr;
+    {
+        std::lock_guard<std::mutex> lock(active_map_addreses_mutex);
+        if (!available_maps_stack.empty()) {
+            // Maps in the pool are already cleared
+            map_ptr = available_maps_stack.top();
+            available_maps_stack.pop();
+        }
+    }
+    if (map_ptr == nullptr) {
+        map_ptr = make_shared<TaintRangeMapType>();
+    }
     active_map_addreses[map_ptr.get()] = map_ptr;
     return map_ptr;
 }
@@ -43,13 +174,17 @@ Initializer::clear_tainting_map(const TaintRangeMapTypePtr& tx_map)
     std::lock_guard<std::mutex> lock(active_map_addreses_mutex);
     tx_map->clear();
     active_map_addreses.erase(tx_map.get());
+    if (available_maps_stack.size() < TAINT_MAPS_POOL_SIZE) {
+        // Recycle the (cleared) map for the next create_context()
+        available_maps_stack.push(tx_map);
+    }
 }
 
 void
 Initializer::clear_tainting_maps()
 {
     // Need to copy because free_tainting_map changes the set inside the iteration
-    auto copy_active_map_addreses(initializer->active_map_addreses);
+    auto copy_active_map_addreses(active_map_addreses);
     for (auto& [fst, snd] : copy_active_map_addreses) {
         if (copy_active_map_addreses.empty()) {
             break;
@@ -59,13 +194,68 @@ Initializer::clear_tainting_maps()
     }
     std::lock_guard<std::mutex> lock(active_map_addreses_mutex);
     active_map_addreses.clear();
+    // Interpreter finishing (or explicit full reset), drop the recycled maps too
+    while (!available_maps_stack.empty()) {
+        available_maps_stack.pop();
+    }
 }
 
+// How many interpreters currently have a taint context. Unsampled requests
+// never create one, so while the process handles only unsampled traffic the
+// whole aspect prelude is the single relaxed load below: no interpreter
+// lookup, no thread cache probe, no shared_ptr copy. Process-global rather
+// than per interpreter on purpose, so the gate needs no interpreter
+// resolution; another interpreter's context merely disables the shortcut.
+static atomic<int> active_contexts{ 0 };
+
 // User must check for nullptr return
 TaintRangeMapTypePtr
 Initializer::get_tainting_map()
 {
-    return ThreadContextCache.tx_map;
+    if (active_contexts.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    auto& context = interpreter_taint_state().context;
+    // A saturated context behaves as if no context were active: every aspect
+    // falls back to its untracked pass-through path
+    if (context.saturated.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return context.tx_map;
+}
+
+// Materialization half of the lazy context: create_context() only records
+// the pending marker, and the map plus a fresh arena generation spring into
+// existence here on the first actual taint write. Runs under the GIL, like
+// every write path.
+TaintRangeMapTypePtr
+Initializer::get_or_create_tainting_map()
+{
+    auto& context = interpreter_taint_state().context;
+    if (context.pending.load(std::memory_order_relaxed) and context.tx_map == nullptr) {
+        // Pulls a recycled map from the pool when one is available
+        context.tx_map = initializer->create_tainting_map();
+        active_contexts.fetch_add(1, std::memory_order_relaxed);
+        // New generation: threads attach their own arena on first allocation.
+        // The counter is process-global (not per interpreter) so generations
+        // are unique across interpreters and the thread arena cache can't
+        // match a context of another interpreter.
+        {
+            lock_guard<mutex> lock(context.arenas_mutex);
+            context.arenas.clear();
+        }
+        static atomic<uint64_t> context_counter{ 0 };
+        context.generation.store(context_counter.fetch_add(1, std::memory_order_relaxed) + 1,
+                                 std::memory_order_release);
+        context.pending.store(false, std::memory_order_relaxed);
+    }
+    return get_tainting_map();
+}
+
+bool
+Initializer::context_is_pending()
+{
+    return interpreter_taint_state().context.pending.load(std::memory_order_relaxed);
 }
 
 int
@@ -78,7 +268,7 @@ Initializer::num_objects_tainted()
 }
 
 string
-Initializer::debug_taint_map()
+Initializer::debug_taint_map(const size_t max_entries)
 {
     const auto ctx_map = get_tainting_map();
     if (!ctx_map) {
@@ -87,14 +277,206 @@ Initializer::debug_taint_map()
 
     std::stringstream output;
     output << "[";
-    for (const auto& [fst, snd] : *ctx_map) {
-        output << "{ 'Id-Key': " << fst << ",";
-        output << "'Value': { 'Hash': " << snd.first << ", 'TaintedObject': '" << snd.second->toString() << "'}},";
-    }
+    // Bounded dump: a heavily tainted request holds tens of thousands of
+    // entries and each one renders its whole range list, so an unbounded
+    // build is both slow and huge
+    size_t emitted = 0;
+    ctx_map->for_each([&output, &emitted, max_entries](const uintptr_t key,
+                                                       const std::pair<Py_hash_t, TaintedObjectPtr>& value) {
+        if (emitted >= max_entries) {
+            output << "{ 'Truncated': true },";
+            return false;
+        }
+        output << "{ 'Id-Key': " << key << ",";
+        output << "'Value': { 'Hash': " << value.first << ", 'TaintedObject': '" << value.second->toString() << "'}},";
+        emitted++;
+        return true;
+    });
     output << "]";
     return output.str();
 }
 
+// Snapshot framing: magic + version header, then the interned source table,
+// then one {identity key, content hash, flat range array} record per tainted
+// object. Fixed-width host-endian fields throughout; loading is one forward
+// memcpy pass with no per-field parsing state.
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x43544444; // "DDTC"
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+// Ranges without a source (never produced by the aspects, but representable)
+static constexpr uint32_t SNAPSHOT_NO_SOURCE = 0xFFFFFFFF;
+
+template<typename T>
+static inline void
+snapshot_write(string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static inline void
+snapshot_write_string(string& out, const string& str)
+{
+    snapshot_write<uint32_t>(out, static_cast<uint32_t>(str.size()));
+    out.append(str);
+}
+
+// Bounds-checked forward reader over the snapshot buffer; any truncation or
+// overrun surfaces as a ValueError instead of reading past the bytes object
+struct SnapshotReader
+{
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+
+    template<typename T>
+    T read()
+    {
+        if (pos + sizeof(T) > size) {
+            throw py::value_error("[IAST] Truncated taint context snapshot");
+        }
+        T value;
+        memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    string read_string()
+    {
+        const auto length = read<uint32_t>();
+        if (pos + length > size) {
+            throw py::value_error("[IAST] Truncated taint context snapshot");
+        }
+        string str(data + pos, length);
+        pos += length;
+        return str;
+    }
+};
+
+py::bytes
+Initializer::save_taint_context()
+{
+    string out;
+    snapshot_write<uint32_t>(out, SNAPSHOT_MAGIC);
+    snapshot_write<uint32_t>(out, SNAPSHOT_VERSION);
+
+    const auto ctx_map = get_tainting_map();
+    if (!ctx_map) {
+        snapshot_write<uint32_t>(out, 0); // sources
+        snapshot_write<uint32_t>(out, 0); // objects
+        return py::bytes(out);
+    }
+
+    // Pin the tainted objects first: get_ranges() below may flatten a pending
+    // concatenation rope, and holding the shared_ptrs keeps every Source
+    // pointer in the table valid until serialization is done
+    vector<pair<uintptr_t, pair<Py_hash_t, TaintedObjectPtr>>> entries;
+    entries.reserve(ctx_map->size());
+    ctx_map->for_each([&entries](const uintptr_t key, const std::pair<Py_hash_t, TaintedObjectPtr>& value) {
+        entries.emplace_back(key, value);
+        return true;
+    });
+
+    // Interned sources collapse to one table entry per shared instance
+    unordered_map<const Source*, uint32_t> source_index;
+    vector<const Source*> sources;
+    for (const auto& [key, value] : entries) {
+        for (const auto& trange : value.second->get_ranges()) {
+            if (trange.source and source_index.emplace(trange.source.get(), sources.size()).second) {
+                sources.push_back(trange.source.get());
+            }
+        }
+    }
+
+    snapshot_write<uint32_t>(out, static_cast<uint32_t>(sources.size()));
+    for (const auto* source : sources) {
+        snapshot_write<uint8_t>(out, static_cast<uint8_t>(source->origin));
+        snapshot_write_string(out, source->name);
+        snapshot_write_string(out, source->value);
+    }
+
+    snapshot_write<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+    for (const auto& [key, value] : entries) {
+        const auto& ranges = value.second->get_ranges();
+        snapshot_write<uint64_t>(out, static_cast<uint64_t>(key));
+        snapshot_write<int64_t>(out, static_cast<int64_t>(value.first));
+        snapshot_write<uint32_t>(out, static_cast<uint32_t>(ranges.size()));
+        for (const auto& trange : ranges) {
+            snapshot_write<int64_t>(out, static_cast<int64_t>(trange.start));
+            snapshot_write<int64_t>(out, static_cast<int64_t>(trange.length));
+            snapshot_write<uint32_t>(out, trange.source ? source_index[trange.source.get()] : SNAPSHOT_NO_SOURCE);
+        }
+    }
+    return py::bytes(out);
+}
+
+size_t
+Initializer::load_taint_context(const py::bytes& snapshot, const py::object& relocations)
+{
+    // A restore is a taint write: materialize a lazily created context
+    const auto ctx_map = get_or_create_tainting_map();
+    if (!ctx_map) {
+        throw py::value_error(MSG_ERROR_TAINT_MAP);
+    }
+
+    const auto view = static_cast<std::string_view>(snapshot);
+    SnapshotReader reader{ view.data(), view.size() };
+    if (reader.read<uint32_t>() != SNAPSHOT_MAGIC) {
+        throw py::value_error("[IAST] Not a taint context snapshot");
+    }
+    if (reader.read<uint32_t>() != SNAPSHOT_VERSION) {
+        throw py::value_error("[IAST] Unsupported taint context snapshot version");
+    }
+
+    const auto n_sources = reader.read<uint32_t>();
+    vector<SourcePtr> sources;
+    sources.reserve(n_sources);
+    for (uint32_t i = 0; i < n_sources; i++) {
+        const auto origin = static_cast<OriginType>(reader.read<uint8_t>());
+        auto name = reader.read_string();
+        auto value = reader.read_string();
+        sources.push_back(initializer->intern_source(Source(std::move(name), std::move(value), origin)));
+    }
+
+    size_t restored = 0;
+    const auto n_objects = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < n_objects; i++) {
+        const auto key = static_cast<uintptr_t>(reader.read<uint64_t>());
+        const auto obj_hash = static_cast<Py_hash_t>(reader.read<int64_t>());
+        const auto n_ranges = reader.read<uint32_t>();
+
+        TaintRangeRefs ranges;
+        ranges.reserve(n_ranges);
+        for (uint32_t j = 0; j < n_ranges; j++) {
+            const auto start = static_cast<RANGE_START>(reader.read<int64_t>());
+            const auto length = static_cast<RANGE_LENGTH>(reader.read<int64_t>());
+            const auto src_idx = reader.read<uint32_t>();
+            if (length <= 0 or (src_idx != SNAPSHOT_NO_SOURCE and src_idx >= sources.size())) {
+                throw py::value_error("[IAST] Corrupt taint context snapshot");
+            }
+            // Same accounting as allocate_taint_range, without bouncing each
+            // range through an arena allocation just to copy it out again
+            auto& state = interpreter_taint_state();
+            charge_taint_budget(state, state.context.taint_ranges_allocated);
+            state.context.tainted_bytes.fetch_add(static_cast<size_t>(length), std::memory_order_relaxed);
+            ranges.emplace_back(start, length, src_idx != SNAPSHOT_NO_SOURCE ? sources[src_idx] : SourcePtr{});
+        }
+
+        const auto tainted = initializer->allocate_ranges_into_taint_object(std::move(ranges));
+        if (relocations.is_none()) {
+            // Fork path: the saved identity keys are still the live addresses
+            // of the parent's objects, and their fast-taint markers came along
+            // with the copied address space
+            ctx_map->put(key, obj_hash, tainted);
+            restored++;
+        } else if (const auto reloc = relocations.cast<py::dict>(); reloc.contains(py::int_(key))) {
+            // Sidecar path: re-key onto the replaying process' own object,
+            // which also sets its fast-taint marker
+            set_tainted_object(reloc[py::int_(key)].ptr(), tainted, ctx_map);
+            restored++;
+        }
+    }
+    return restored;
+}
+
 int
 Initializer::initializer_size() const
 {
@@ -110,13 +492,17 @@ Initializer::active_map_addreses_size() const
 TaintedObjectPtr
 Initializer::allocate_tainted_object()
 {
-    if (!available_taintedobjects_stack.empty()) {
-        const auto toptr = available_taintedobjects_stack.top();
-        available_taintedobjects_stack.pop();
-        return toptr;
+    auto& state = interpreter_taint_state();
+    charge_taint_budget(state, state.context.tainted_objects_allocated);
+    if (const auto arena = current_thread_arena(state.context)) {
+        auto* tainted = new (arena->allocate(sizeof(TaintedObject))) TaintedObject();
+        // One arena reference per object (an atomic bump at allocation time
+        // only); every later TaintedObjectPtr copy is just the intrusive count
+        tainted->arena_keepalive_ = arena;
+        return TaintedObjectPtr(tainted);
     }
-    // Stack is empty, create new object
-    return make_shared<TaintedObject>();
+    // No active context (e.g. allocation before create_context), fall back to the heap
+    return make_refcounted<TaintedObject>();
 }
 
 TaintedObjectPtr
@@ -138,24 +524,51 @@ Initializer::allocate_ranges_into_taint_object_copy(const TaintRangeRefs& ranges
 TaintedObjectPtr
 Initializer::allocate_tainted_object_copy(const TaintedObjectPtr& from)
 {
-    if (!from) {
-        return allocate_tainted_object();
+    const auto toptr = allocate_tainted_object();
+    if (from) {
+        // Copy-on-write: share the source's range list, it is only cloned if
+        // either side mutates it afterwards
+        toptr->share_values(*from);
+    }
+    return toptr;
+}
+
+SourcePtr
+Initializer::intern_source(const Source& source)
+{
+    auto& source_interns = interpreter_taint_state().context.source_interns;
+    const auto source_hash = Source::hash(source.name, source.value, source.origin);
+    if (const auto it = source_interns.find(source_hash); it != source_interns.end()) {
+        if (*it->second == source) {
+            return it->second;
+        }
+        // Hash collision with a different source, don't intern this one
+        return make_refcounted<const Source>(source);
     }
-    return allocate_ranges_into_taint_object_copy(from->ranges_);
+    auto interned = make_refcounted<const Source>(source);
+    source_interns.emplace(source_hash, interned);
+    return interned;
 }
 
 TaintRangePtr
 Initializer::allocate_taint_range(const RANGE_START start, const RANGE_LENGTH length, const Source& origin)
 {
-    if (!available_ranges_stack.empty()) {
-        auto rptr = available_ranges_stack.top();
-        available_ranges_stack.pop();
-        rptr->set_values(start, length, origin);
-        return rptr;
-    }
+    return allocate_taint_range(start, length, intern_source(origin));
+}
 
-    // Stack is empty, create new object
-    return make_shared<TaintRange>(start, length, origin);
+TaintRangePtr
+Initializer::allocate_taint_range(const RANGE_START start, const RANGE_LENGTH length, SourcePtr origin)
+{
+    auto& state = interpreter_taint_state();
+    charge_taint_budget(state, state.context.taint_ranges_allocated);
+    if (length > 0) {
+        state.context.tainted_bytes.fetch_add(static_cast<size_t>(length), std::memory_order_relaxed);
+    }
+    if (const auto arena = current_thread_arena(state.context)) {
+        return allocate_shared<TaintRange>(ArenaAllocator<TaintRange>(arena), start, length, std::move(origin));
+    }
+    // No active context (e.g. allocation before create_context), fall back to the heap
+    return make_shared<TaintRange>(start, length, std::move(origin));
 }
 
 void
@@ -165,29 +578,35 @@ Initializer::release_taint_range(TaintRangePtr rangeptr)
         return;
 
     if (rangeptr.use_count() == 1) {
+        // The arena reclaims the memory wholesale on context reset; releasing
+        // the Source strings early just keeps peak memory down.
         rangeptr->reset();
-        if (available_ranges_stack.size() < TAINTRANGES_STACK_SIZE) {
-            // Move the range to the allocated ranges stack
-            available_ranges_stack.push(rangeptr);
-            return;
-        }
-
-        // Stack full or initializer already cleared (interpreter finishing), just
-        // release the object
-        rangeptr.reset(); // Not duplicated or typo, calling reset on the shared_ptr, not the TaintRange
     }
 }
 
+static void
+reset_context_counters(TaintContextState_& context)
+{
+    context.tainted_objects_allocated.store(0, std::memory_order_relaxed);
+    context.taint_ranges_allocated.store(0, std::memory_order_relaxed);
+    context.tainted_bytes.store(0, std::memory_order_relaxed);
+    context.saturated.store(false, std::memory_order_relaxed);
+}
+
 void
 Initializer::create_context()
 {
-    auto tx_map = get_tainting_map();
-    if (tx_map != nullptr) {
-        reset_context(tx_map);
+    auto& context = interpreter_taint_state().context;
+    if (context.tx_map != nullptr) {
+        reset_context();
     }
-    // Create a new taint_map
-    auto map_ptr = create_tainting_map();
-    ThreadContextCache.tx_map = map_ptr;
+    // Only a pending marker: the map and a fresh arena generation materialize
+    // in get_or_create_tainting_map() on the first actual taint write of the
+    // request. Requests that never taint anything (static assets, health
+    // checks, no tainted sources) never pay for a context, and aspects keep
+    // seeing active_contexts == 0 so their prelude stays the single load.
+    context.pending.store(true, std::memory_order_relaxed);
+    reset_context_counters(context);
 }
 
 void
@@ -202,38 +621,120 @@ Initializer::reset_context(const TaintRangeMapTypePtr& tx_map)
 void
 Initializer::reset_context()
 {
-    reset_context(ThreadContextCache.tx_map);
-    ThreadContextCache.tx_map = nullptr;
+    auto& context = interpreter_taint_state().context;
+    if (context.tx_map != nullptr) {
+        // O(1): clear_tainting_map() bumps the map generation (shards purge
+        // themselves lazily on next touch) and recycles the map through the
+        // pool instead of tearing it down inline
+        clear_tainting_map(context.tx_map);
+        context.tx_map = nullptr;
+        active_contexts.fetch_sub(1, std::memory_order_relaxed);
+    }
+    context.pending.store(false, std::memory_order_relaxed);
+    context.generation.store(0, std::memory_order_release);
+    {
+        lock_guard<mutex> lock(context.arenas_mutex);
+        context.arenas.clear();
+    }
+    reset_context_counters(context);
+    context.source_interns.clear();
 }
 
 void
 Initializer::reset_contexts()
 {
+    // Clear even when no map was ever materialized, so a pending lazy
+    // context can't resurrect after a global reset
+    interpreter_taint_state().context.pending.store(false, std::memory_order_relaxed);
     if (active_map_addreses_size() <= 0) {
         return;
     }
 
     clear_tainting_maps();
 
-    if (ThreadContextCache.tx_map != nullptr) {
-        ThreadContextCache.tx_map = nullptr;
+    auto& context = interpreter_taint_state().context;
+    if (context.tx_map != nullptr) {
+        context.tx_map = nullptr;
+        active_contexts.fetch_sub(1, std::memory_order_relaxed);
+    }
+    context.pending.store(false, std::memory_order_relaxed);
+    context.generation.store(0, std::memory_order_release);
+    {
+        lock_guard<mutex> lock(context.arenas_mutex);
+        context.arenas.clear();
     }
+    reset_context_counters(context);
+    context.source_interns.clear();
 }
 
-// Created in the PYBIND11_MODULE in _native.cpp
-unique_ptr<Initializer> initializer;
+Initializer*
+InitializerHandle::operator->() const
+{
+    return &interpreter_taint_state().engine;
+}
+
+void
+InitializerHandle::create()
+{
+    // Forces creation of this interpreter's state so the first request
+    // doesn't pay for it; also what PYBIND11_MODULE calls on (re)import in a
+    // fresh subinterpreter
+    interpreter_taint_state();
+}
+
+void
+InitializerHandle::reset()
+{
+    // Called at interpreter teardown (atexit / test fixtures), when no other
+    // thread of this interpreter is still running taint code
+    auto* const interp = PyInterpreterState_Get();
+    lock_guard<mutex> lock(interpreter_states_mutex);
+    interpreter_states.erase(interp);
+    if (ThreadInterpCache.interp == interp) {
+        ThreadInterpCache = {};
+    }
+}
+
+InitializerHandle initializer;
 
 void
 pyexport_initializer(py::module& m)
 {
     m.def("clear_tainting_maps", [] { initializer->clear_tainting_maps(); });
-    m.def("debug_taint_map", [] { return Initializer::debug_taint_map(); });
+    m.def(
+      "debug_taint_map",
+      [](const size_t max_entries) { return Initializer::debug_taint_map(max_entries); },
+      "max_entries"_a = 512);
 
     m.def("num_objects_tainted", [] { return Initializer::num_objects_tainted(); });
+    m.def("save_taint_context", [] { return Initializer::save_taint_context(); });
+    m.def(
+      "load_taint_context",
+      [](const py::bytes& snapshot, const py::object& relocations) {
+          return Initializer::load_taint_context(snapshot, relocations);
+      },
+      "snapshot"_a,
+      "relocations"_a = py::none());
+    m.def("taint_stats", [] {
+        const auto& context = interpreter_taint_state().context;
+        py::dict stats;
+        stats["objects_live"] = Initializer::num_objects_tainted();
+        stats["objects_allocated"] = context.tainted_objects_allocated.load(std::memory_order_relaxed);
+        stats["ranges_allocated"] = context.taint_ranges_allocated.load(std::memory_order_relaxed);
+        stats["tainted_bytes"] = context.tainted_bytes.load(std::memory_order_relaxed);
+        return stats;
+    });
     m.def("initializer_size", [] { return initializer->initializer_size(); });
     m.def("active_map_addreses_size", [] { return initializer->active_map_addreses_size(); });
 
     m.def("create_context", []() { return initializer->create_context(); }, py::return_value_policy::reference);
     m.def("reset_context", [] { initializer->reset_context(); });
     m.def("reset_contexts", [] { initializer->reset_contexts(); });
+
+    m.def("set_context_taint_budget", [](const size_t budget) {
+        interpreter_taint_state().taint_budget = budget > 0 ? budget : DEFAULT_CONTEXT_TAINT_BUDGET;
+    });
+    m.def("get_context_taint_budget", [] { return interpreter_taint_state().taint_budget; });
+    m.def("context_is_saturated",
+          [] { return interpreter_taint_state().context.saturated.load(std::memory_order_relaxed); });
 }
@@ -2,6 +2,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "Initializer/Arena.h"
 #include "TaintTracking/TaintRange.h"
 #include "TaintTracking/TaintedObject.h"
 
@@ -16,18 +17,18 @@ namespace py = pybind11;
 class Initializer
 {
   private:
-    py::object pyfunc_get_settings;
-    py::object pyfunc_get_python_lib;
-    static constexpr int TAINTRANGES_STACK_SIZE = 4096;
-    static constexpr int TAINTEDOBJECTS_STACK_SIZE = 4096;
-    stack<TaintedObjectPtr> available_taintedobjects_stack;
-    stack<TaintRangePtr> available_ranges_stack;
     // This is a map instead of a set so we can change the contents on iteration; otherwise
     // keys and values are the same pointer.
     unordered_map<TaintRangeMapType*, TaintRangeMapTypePtr> active_map_addreses;
 
     std::mutex active_map_addreses_mutex;
 
+    // Pool of cleared tainting maps recycled across requests, so
+    // create_context()/reset_context() don't construct and tear down the
+    // sharded structure (and its buckets) on every request
+    static constexpr int TAINT_MAPS_POOL_SIZE = 8;
+    stack<TaintRangeMapTypePtr> available_maps_stack;
+
   public:
     /**
      * Constructor for the Initializer class.
@@ -55,6 +56,23 @@ class Initializer
      */
     static TaintRangeMapTypePtr get_tainting_map();
 
+    /**
+     * Like get_tainting_map(), but first materializes the map of a lazily
+     * created context (see create_context()). For APIs that write
+     * caller-provided ranges into the map; aspects keep using
+     * get_tainting_map() so pure propagation never forces materialization.
+     *
+     * @return A pointer to the current taint range map.
+     */
+    static TaintRangeMapTypePtr get_or_create_tainting_map();
+
+    /**
+     * True while a lazily created context has not materialized its map yet.
+     * Lets read APIs distinguish "context active but nothing tainted" from
+     * "no context" without materializing anything.
+     */
+    static bool context_is_pending();
+
     /**
      * Clears all active taint maps.
      */
@@ -67,7 +85,37 @@ class Initializer
      */
     static int num_objects_tainted();
 
-    static string debug_taint_map();
+    // Bounded: emits at most max_entries entries plus a truncation marker
+    static string debug_taint_map(size_t max_entries = 512);
+
+    /**
+     * Serializes the current tainting map into a compact binary snapshot:
+     * an interned source table followed by one flat range array per tainted
+     * object, keyed by the object's identity and content hash. The format is
+     * host-endian and host-width, intended for a forked worker or a sidecar
+     * on the same machine, not for storage or transport across architectures.
+     *
+     * @return The snapshot bytes; a headers-only snapshot when no context is
+     *         active.
+     */
+    static py::bytes save_taint_context();
+
+    /**
+     * Restores a snapshot produced by save_taint_context() into the current
+     * context in a single pass, without going back through the per-object
+     * Python tainting calls.
+     *
+     * With relocations=None the entries keep their saved identity keys: valid
+     * in a forked child, where the tainted objects still live at the parent's
+     * addresses (and keep their fast-taint markers). A sidecar replaying the
+     * snapshot against its own objects passes a dict mapping saved identity
+     * keys to the live objects; entries without a mapping are skipped.
+     *
+     * @param snapshot The snapshot bytes.
+     * @param relocations None, or a dict of saved identity key to live object.
+     * @return The number of restored entries.
+     */
+    static size_t load_taint_context(const py::bytes& snapshot, const py::object& relocations);
 
     /**
      * Gets the size of the Initializer object.
@@ -84,7 +132,9 @@ class Initializer
     int active_map_addreses_size() const;
 
     /**
-     * Creates a new taint tracking context.
+     * Creates a new taint tracking context. Lazy: only a pending marker is
+     * recorded here, the map and arena state materialize on the first actual
+     * taint write.
      */
     void create_context();
 
@@ -103,14 +153,10 @@ class Initializer
     void reset_contexts();
 
     /**
-     * Allocates a new tainted object.
+     * Allocates a new tainted object out of the current context arena.
 
-     * IMPORTANT: if the returned object is not assigned to the map, you have responsibility of calling
-     * release_tainted_object on it or you'll have a leak.
-     *
-     * IMPORTANT2: allocate_ranges_into_taint_object moves the owner of the ranges, if you know the ranges of the
-     original
-     * tainted object should be used more times, use instead allocate_ranges_into_taint_object_copy.
+     * IMPORTANT: allocate_ranges_into_taint_object moves the owner of the ranges, if you know the ranges of the
+     * original tainted object should be used more times, use instead allocate_ranges_into_taint_object_copy.
      *
      * @return A pointer to the allocated tainted object.
      */
@@ -133,7 +179,10 @@ class Initializer
     TaintedObjectPtr allocate_ranges_into_taint_object_copy(const TaintRangeRefs& ranges);
 
     /**
-     * Allocates and copy taint ranges from a Tainted Object into new tainted object.
+     * Allocates a new tainted object sharing the range list of an existing one.
+     *
+     * The list is shared copy-on-write, so this is O(1); it is only cloned if
+     * one of the two objects mutates its ranges later.
      *
      * @param from The existing tainted object to copy.
      * @return A pointer to the allocated tainted object.
@@ -141,14 +190,45 @@ class Initializer
     TaintedObjectPtr allocate_tainted_object_copy(const TaintedObjectPtr& from);
 
     // FIXME: these should be static functions of TaintRange
-    // IMPORTANT: if the returned object is not assigned to the map, you have
-    // responsibility of calling release_taint_range on it or you'll have a leak.
+    // The Source& overload interns the source in the per-context pool; the
+    // SourcePtr one reuses an already-interned handle without copying strings
     TaintRangePtr allocate_taint_range(RANGE_START start, RANGE_LENGTH length, const Source& source);
+    TaintRangePtr allocate_taint_range(RANGE_START start, RANGE_LENGTH length, SourcePtr source);
+
+    /**
+     * Returns the shared immutable instance for source, creating it in the
+     * per-context intern pool on first sight.
+     */
+    SourcePtr intern_source(const Source& source);
 
     void release_taint_range(TaintRangePtr rangeptr);
 };
 
-extern unique_ptr<Initializer> initializer;
+/**
+ * Per-interpreter handle to the taint engine. `initializer->` resolves to the
+ * calling interpreter's own Initializer (created lazily on first use), so
+ * subinterpreters (PEP 684) get independent engines, pools and contexts while
+ * call sites keep reading like the old process-global pointer.
+ */
+class InitializerHandle
+{
+  public:
+    Initializer* operator->() const;
+
+    /**
+     * Eagerly creates the calling interpreter's taint state; called from the
+     * module init of each importing interpreter.
+     */
+    void create();
+
+    /**
+     * Drops the calling interpreter's taint state; called at interpreter
+     * teardown, once no other thread of that interpreter runs taint code.
+     */
+    void reset();
+};
+
+extern InitializerHandle initializer;
 
 void
 pyexport_initializer(py::module& m);
@@ -39,7 +39,12 @@ Source::operator std::string() const
 int
 Source::get_hash() const
 {
-    return std::hash<size_t>()(std::hash<string>()(name) ^ static_cast<long>(origin) ^ std::hash<string>()(value));
+    if (not hash_built_) {
+        hash_ = static_cast<int>(
+          std::hash<size_t>()(std::hash<string>()(name) ^ static_cast<long>(origin) ^ std::hash<string>()(value)));
+        hash_built_ = true;
+    }
+    return hash_;
 };
 
 void
@@ -2,6 +2,7 @@
 #include <sstream>
 
 #include "../Constants.h"
+#include "../Utils/RefCounted.h"
 
 // #define PY_MODULE_NAME_SOURCE PY_MODULE_NAME "." "Source"
 using namespace std;
@@ -30,7 +31,7 @@ enum class TagMappingMode
     Mapper_Replace
 };
 
-struct Source
+struct Source : RefCounted<Source>
 {
     Source(string, string, OriginType);
     Source(int, string, OriginType);
@@ -46,6 +47,8 @@ struct Source
         name = std::move(name_);
         value = std::move(value_);
         origin = origin_;
+        evidence_tag_built_ = false;
+        hash_built_ = false;
     }
 
     void reset()
@@ -53,6 +56,23 @@ struct Source
         name = "";
         value = "";
         origin = OriginType::EMPTY;
+        evidence_tag_built_ = false;
+        hash_built_ = false;
+    }
+
+    /**
+     * Evidence tag of this source ("<name>", or "" for a blank name), built
+     * lazily and cached: sources are interned per context and shared const,
+     * so vulnerability serialization stops reassembling the same tag for
+     * every range. Accessed under the GIL like the rest of the taint state.
+     */
+    [[nodiscard]] const string& evidence_tag() const
+    {
+        if (not evidence_tag_built_) {
+            evidence_tag_ = name.empty() ? string{} : "<" + name + ">";
+            evidence_tag_built_ = true;
+        }
+        return evidence_tag_;
     }
 
     [[nodiscard]] int get_hash() const;
@@ -63,8 +83,33 @@ struct Source
     };
 
     explicit operator std::string() const;
+
+    bool operator==(const Source& other) const
+    {
+        return origin == other.origin and name == other.name and value == other.value;
+    }
+
+    // Interned sources are heap objects; value instances (the pybind class,
+    // TaintRange construction temporaries) never reach a zero count
+    void dispose() const { delete this; }
+
+  private:
+    mutable string evidence_tag_;
+    mutable bool evidence_tag_built_{ false };
+    // get_hash() hashes both strings, and ranges re-derive their own hash
+    // from it for every evidence tag during conversion; like the evidence
+    // tag it is built once and cached, since interned sources never change
+    mutable int hash_{ 0 };
+    mutable bool hash_built_{ false };
 };
 
+// Sources repeat massively in real traffic (same parameter names, same
+// origins), so ranges share one immutable instance through the per-context
+// intern pool in Initializer instead of embedding their own copy. Every
+// TaintRange copy bumps this count, so it uses the intrusive GIL-guarded
+// refcount instead of shared_ptr's always-atomic one.
+using SourcePtr = RcPtr<const Source>;
+
 inline string
 origin_to_str(const OriginType origin_type)
 {
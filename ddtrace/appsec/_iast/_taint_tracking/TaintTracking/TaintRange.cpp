@@ -17,7 +17,7 @@ TaintRange::toString() const
 {
     ostringstream ret;
     ret << "TaintRange at " << this << " "
-        << "[start=" << start << ", length=" << length << " source=" << source.toString() << "]";
+        << "[start=" << start << ", length=" << length << " source=" << (source ? source->toString() : "None") << "]";
     return ret.str();
 }
 
@@ -33,18 +33,34 @@ TaintRange::get_hash() const
 {
     const uint hstart = hash<uint>()(this->start);
     const uint hlength = hash<uint>()(this->length);
-    const uint hsource = hash<uint>()(this->source.get_hash());
+    const uint hsource = hash<uint>()(this->source ? this->source->get_hash() : 0);
     return hstart ^ hlength ^ hsource;
 };
 
-TaintRangePtr
-shift_taint_range(const TaintRangePtr& source_taint_range, const RANGE_START offset, const RANGE_LENGTH new_length = -1)
+TaintRange
+shift_taint_range(const TaintRange& source_taint_range, const RANGE_START offset, const RANGE_LENGTH new_length = -1)
 {
-    const auto new_length_to_use = new_length == -1 ? source_taint_range->length : new_length;
-    auto tptr = initializer->allocate_taint_range(source_taint_range->start + offset, // start
-                                                  new_length_to_use,                  // length
-                                                  source_taint_range->source);        // origin
-    return tptr;
+    const auto new_length_to_use = new_length == -1 ? source_taint_range.length : new_length;
+    return { source_taint_range.start + offset, // start
+             new_length_to_use,                 // length
+             source_taint_range.source };       // origin (already interned, shared)
+}
+
+void
+shift_taint_ranges_inplace(TaintRangeRefs& ranges, const RANGE_START offset, const RANGE_LENGTH new_length)
+{
+    // Bulk shift over the flat storage: two add/store passes the compiler can
+    // unroll, with no per-range construction and no source refcount traffic.
+    // Callers that own their range list (get_ranges hands back a copy) should
+    // prefer this over shift_taint_ranges to skip the second copy entirely.
+    for (auto& trange : ranges) {
+        trange.start += offset;
+    }
+    if (new_length != -1) {
+        for (auto& trange : ranges) {
+            trange.length = new_length;
+        }
+    }
 }
 
 TaintRangeRefs
@@ -52,12 +68,8 @@ shift_taint_ranges(const TaintRangeRefs& source_taint_ranges,
                    const RANGE_START offset,
                    const RANGE_LENGTH new_length = -1)
 {
-    TaintRangeRefs new_ranges;
-    new_ranges.reserve(source_taint_ranges.size());
-
-    for (const auto& trange : source_taint_ranges) {
-        new_ranges.emplace_back(shift_taint_range(trange, offset, new_length));
-    }
+    TaintRangeRefs new_ranges(source_taint_ranges);
+    shift_taint_ranges_inplace(new_ranges, offset, new_length);
     return new_ranges;
 }
 
@@ -72,7 +84,15 @@ api_shift_taint_ranges(const TaintRangeRefs& source_taint_ranges,
 py::object
 api_set_ranges(py::handle& str, const TaintRangeRefs& ranges)
 {
-    const auto tx_map = Initializer::get_tainting_map();
+    // Reject no-op inputs before touching the initializer or the map:
+    // instrumentation probes this for every source candidate and most are
+    // empty or not tainteable at all
+    if (ranges.empty() or not is_tainteable(str.ptr())) {
+        return py::none();
+    }
+
+    // A taint write: materializes a lazily created context
+    const auto tx_map = Initializer::get_or_create_tainting_map();
 
     if (not tx_map) {
         throw py::value_error(MSG_ERROR_TAINT_MAP);
@@ -111,22 +131,24 @@ api_set_ranges_from_values(PyObject* self, PyObject* const* args, const Py_ssize
 
     if (nargs == 5) {
         PyObject* tainted_object = args[0];
-        const auto tx_map = Initializer::get_tainting_map();
-        if (not tx_map) {
-            py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
-            return nullptr;
-        }
-
-        pyobject_n = new_pyobject_id(tainted_object);
-        PyObject* len_pyobject_py = args[1];
-
-        const long len_pyobject = PyLong_AsLong(len_pyobject_py);
+        // Validate everything that can be rejected before touching the
+        // initializer, the taint map or cloning the object: the
+        // instrumentation probes every source candidate through here and
+        // rejections are the common outcome
+        const long len_pyobject = PyLong_AsLong(args[1]);
         if (const string source_name = PyObjectToString(args[2]); not source_name.empty()) {
             if (const string source_value = PyObjectToString(args[3]); not source_value.empty()) {
+                const auto tx_map = Initializer::get_or_create_tainting_map();
+                if (not tx_map) {
+                    py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+                    return nullptr;
+                }
+
+                pyobject_n = new_pyobject_id(tainted_object);
                 const auto source_origin = static_cast<OriginType>(PyLong_AsLong(args[4]));
                 const auto source = Source(source_name, source_value, source_origin);
-                const auto range = initializer->allocate_taint_range(0, len_pyobject, source);
-                const auto ranges = vector{ range };
+                TaintRangeRefs ranges;
+                ranges.emplace_back(0, len_pyobject, initializer->intern_source(source));
                 result = set_ranges(pyobject_n, ranges, tx_map);
                 if (not result) {
                     result_error_msg = MSG_ERROR_SET_RANGES;
@@ -146,6 +168,105 @@ api_set_ranges_from_values(PyObject* self, PyObject* const* args, const Py_ssize
     return pyobject_n;
 }
 
+/**
+ * Batch form of set_ranges_from_values: taints a whole group of source
+ * objects (request headers, cookies, form fields) in one native call,
+ * inserting every entry through a single put_batch pass instead of one
+ * map transaction per object. Entries that can't be tainted (non-text,
+ * empty, empty name or value) pass through unchanged rather than raising,
+ * since rejections are routine for instrumentation-fed batches.
+ *
+ * @param args[0] list. Objects to taint.
+ * @param args[1] list. Source names, parallel to args[0].
+ * @param args[2] list. Source values, parallel to args[0].
+ * @param args[3] int or list. Origin type for every entry, or parallel origins.
+ * @return list. For each input, the tainted clone or the original object.
+ */
+PyObject*
+api_taint_pyobject_batch(PyObject* self, PyObject* const* args, const Py_ssize_t nargs)
+{
+    if (nargs != 4 or not PyList_Check(args[0]) or not PyList_Check(args[1]) or not PyList_Check(args[2])) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_N_PARAMS);
+        return nullptr;
+    }
+    PyObject* objects = args[0];
+    PyObject* names = args[1];
+    PyObject* values = args[2];
+    PyObject* origins = args[3];
+
+    const Py_ssize_t count = PyList_GET_SIZE(objects);
+    const bool per_entry_origin = PyList_Check(origins);
+    if (PyList_GET_SIZE(names) != count or PyList_GET_SIZE(values) != count or
+        (per_entry_origin and PyList_GET_SIZE(origins) != count)) {
+        py::set_error(PyExc_ValueError, "[IAST] taint_pyobject_batch lists must have the same length");
+        return nullptr;
+    }
+
+    const auto tx_map = Initializer::get_or_create_tainting_map();
+    if (not tx_map) {
+        py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+        return nullptr;
+    }
+
+    long shared_origin = 0;
+    if (not per_entry_origin) {
+        shared_origin = PyLong_AsLong(origins);
+        if (shared_origin == -1 and PyErr_Occurred()) {
+            return nullptr;
+        }
+    }
+
+    PyObject* result = PyList_New(count);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    std::vector<TaintRangeMapType::BatchEntry> batch;
+    batch.reserve(static_cast<size_t>(count));
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject* obj = PyList_GET_ITEM(objects, i);
+        Py_ssize_t len_pyobject = 0;
+        bool taintable = is_text(obj) and (len_pyobject = PyObject_Length(obj)) > 0;
+        std::string source_name;
+        std::string source_value;
+        if (taintable) {
+            source_name = PyObjectToString(PyList_GET_ITEM(names, i));
+            source_value = PyObjectToString(PyList_GET_ITEM(values, i));
+            taintable = not source_name.empty() and not source_value.empty();
+        }
+        if (not taintable) {
+            Py_INCREF(obj);
+            PyList_SET_ITEM(result, i, obj);
+            continue;
+        }
+
+        long origin_value = shared_origin;
+        if (per_entry_origin) {
+            origin_value = PyLong_AsLong(PyList_GET_ITEM(origins, i));
+            if (origin_value == -1 and PyErr_Occurred()) {
+                Py_DECREF(result);
+                return nullptr;
+            }
+        }
+
+        PyObject* pyobject_n = new_pyobject_id(obj);
+        const auto source = Source(source_name, source_value, static_cast<OriginType>(origin_value));
+        TaintRangeRefs ranges;
+        ranges.emplace_back(0, static_cast<RANGE_LENGTH>(len_pyobject), initializer->intern_source(source));
+        set_fast_tainted_if_notinterned_unicode(pyobject_n);
+        set_fast_tainted_if_bytes(pyobject_n);
+        batch.emplace_back(get_unique_id(pyobject_n),
+                           get_internal_hash(pyobject_n),
+                           initializer->allocate_ranges_into_taint_object(std::move(ranges)));
+        PyList_SET_ITEM(result, i, pyobject_n);
+    }
+
+    if (not batch.empty()) {
+        tx_map->put_batch(batch);
+    }
+    return result;
+}
+
 std::pair<TaintRangeRefs, bool>
 get_ranges(PyObject* string_input, const TaintRangeMapTypePtr& tx_map)
 {
@@ -154,43 +275,84 @@ get_ranges(PyObject* string_input, const TaintRangeMapTypePtr& tx_map)
         return std::make_pair(result, true);
     }
 
-    if (tx_map->empty()) {
+    if (is_notfasttainted_bytes(string_input)) {
+        // Unmarked bytes-like objects were never tainted: skip the map probe
         return std::make_pair(result, false);
     }
-    const auto it = tx_map->find(get_unique_id(string_input));
-    if (it == tx_map->end()) {
+
+    // A null map is a lazily created context with no taint writes yet: same
+    // answer as its materialized (empty) map would give
+    const auto obj_id = get_unique_id(string_input);
+    if (not tx_map or tx_map->empty() or not tx_map->maybe_contains(obj_id)) {
         return std::make_pair(result, false);
     }
-
-    if (get_internal_hash(string_input) != it->second.first) {
-        tx_map->erase(it);
+    const auto tainted = tx_map->get_lazy_hash(obj_id, [string_input] { return get_internal_hash(string_input); });
+    if (!tainted) {
         return std::make_pair(result, false);
     }
 
-    return std::make_pair(it->second.second->get_ranges(), false);
+    return std::make_pair(tainted->get_ranges(), false);
+}
+
+/**
+ * Borrowing variant of get_ranges for read-only consumers (evidence
+ * formatting, slice intersection): the returned view points straight at the
+ * tainted object's range list instead of copying it out.
+ */
+TaintRangesView
+get_ranges_view(PyObject* string_input, const TaintRangeMapTypePtr& tx_map)
+{
+    static const TaintRangeRefs empty_ranges{};
+    if (not is_tainteable(string_input)) {
+        return { nullptr, &empty_ranges, true };
+    }
+
+    if (is_notfasttainted_bytes(string_input)) {
+        return { nullptr, &empty_ranges, false };
+    }
+
+    const auto obj_id = get_unique_id(string_input);
+    if (not tx_map or tx_map->empty() or not tx_map->maybe_contains(obj_id)) {
+        return { nullptr, &empty_ranges, false };
+    }
+    auto tainted = tx_map->get_lazy_hash(obj_id, [string_input] { return get_internal_hash(string_input); });
+    if (!tainted) {
+        return { nullptr, &empty_ranges, false };
+    }
+    const auto& ranges = tainted->get_ranges();
+    return { std::move(tainted), &ranges, false };
 }
 
 bool
 set_ranges(PyObject* str, const TaintRangeRefs& ranges, const TaintRangeMapTypePtr& tx_map)
 {
-    if (ranges.empty()) {
+    if (ranges.empty() or not tx_map) {
         return false;
     }
     auto obj_id = get_unique_id(str);
-    const auto it = tx_map->find(obj_id);
     auto new_tainted_object = initializer->allocate_ranges_into_taint_object(ranges);
 
     set_fast_tainted_if_notinterned_unicode(str);
-    if (it != tx_map->end()) {
-        it->second.second.reset();
-        it->second = std::make_pair(get_internal_hash(str), new_tainted_object);
-        return true;
-    }
-
-    tx_map->insert({ obj_id, std::make_pair(get_internal_hash(str), new_tainted_object) });
+    set_fast_tainted_if_bytes(str);
+    tx_map->put(obj_id, get_internal_hash(str), std::move(new_tainted_object));
     return true;
 }
 
+/**
+ * Phase-one probe: false means the object is definitely not tainted in this
+ * context -- interned/fast-taint marker for unicode, Bloom filter for
+ * everything else -- with no hashing and no shard lock taken.
+ */
+static bool
+possibly_tainted(PyObject* obj, const TaintRangeMapTypePtr& tx_map)
+{
+    if (not tx_map or not is_tainteable(obj) or is_notinterned_notfasttainted_unicode(obj) or
+        is_notfasttainted_bytes(obj)) {
+        return false;
+    }
+    return tx_map->maybe_contains(get_unique_id(obj));
+}
+
 // Returns a tuple with (all ranges, ranges of candidate_text)
 // FIXME: Take a PyList as parameter_list instead of a py::tuple (same for the
 // result)
@@ -200,16 +362,30 @@ are_all_text_all_ranges(PyObject* candidate_text, const py::tuple& parameter_lis
     if (not is_tainteable(candidate_text))
         return {};
 
-    TaintRangeRefs all_ranges;
     const auto tx_map = Initializer::get_tainting_map();
     if (not tx_map or tx_map->empty()) {
         return { {}, {} };
     }
 
+    // Phase one: walk the tuple over borrowed references checking the cheap
+    // markers only, so the overwhelmingly common nothing-is-tainted call
+    // returns before any hash or range copy happens
+    PyObject* parameters = parameter_list.ptr();
+    const Py_ssize_t n_parameters = PyTuple_GET_SIZE(parameters);
+    bool any_possibly_tainted = possibly_tainted(candidate_text, tx_map);
+    for (Py_ssize_t i = 0; not any_possibly_tainted and i < n_parameters; i++) {
+        any_possibly_tainted = possibly_tainted(PyTuple_GET_ITEM(parameters, i), tx_map);
+    }
+    if (not any_possibly_tainted) {
+        return { {}, {} };
+    }
+
+    // Phase two: something may be tainted, collect the actual ranges
+    TaintRangeRefs all_ranges;
     auto [candidate_text_ranges, ranges_error] = get_ranges(candidate_text, tx_map);
     if (not ranges_error) {
-        for (const auto& param_handler : parameter_list) {
-            if (const auto param = param_handler.cast<py::object>().ptr(); is_tainteable(param)) {
+        for (Py_ssize_t i = 0; i < n_parameters; i++) {
+            if (PyObject* param = PyTuple_GET_ITEM(parameters, i); is_tainteable(param)) {
                 if (auto [ranges, ranges_error] = get_ranges(param, tx_map); not ranges_error) {
                     all_ranges.insert(all_ranges.end(), ranges.begin(), ranges.end());
                 }
@@ -228,13 +404,12 @@ get_range_by_hash(const size_t range_hash, optional<TaintRangeRefs>& taint_range
     }
     // TODO: Replace this loop with a efficient function, vector.find() is O(n)
     // too.
-    TaintRangePtr null_range = nullptr;
     for (const auto& range : taint_ranges.value()) {
-        if (range_hash == range->get_hash()) {
-            return range;
+        if (range_hash == range.get_hash()) {
+            return make_shared<TaintRange>(range);
         }
     }
-    return null_range;
+    return nullptr;
 }
 
 TaintRangeRefs
@@ -243,6 +418,11 @@ api_get_ranges(const py::handle& string_input)
     const auto tx_map = Initializer::get_tainting_map();
 
     if (not tx_map) {
+        // A lazily created context with no taint events yet reads as empty,
+        // the same result its materialized (empty) map would give
+        if (Initializer::context_is_pending()) {
+            return {};
+        }
         throw py::value_error(MSG_ERROR_TAINT_MAP);
     }
 
@@ -259,7 +439,11 @@ api_copy_ranges_from_strings(py::handle& str_1, py::handle& str_2)
     const auto tx_map = Initializer::get_tainting_map();
 
     if (not tx_map) {
-        py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+        // Nothing is tainted in a pending lazy context, so there is nothing
+        // to copy; don't materialize and don't error
+        if (not Initializer::context_is_pending()) {
+            py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+        }
         return;
     }
 
@@ -281,7 +465,9 @@ api_copy_and_shift_ranges_from_strings(py::handle& str_1,
 {
     const auto tx_map = Initializer::get_tainting_map();
     if (not tx_map) {
-        py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+        if (not Initializer::context_is_pending()) {
+            py::set_error(PyExc_ValueError, MSG_ERROR_TAINT_MAP);
+        }
         return;
     }
     auto [ranges, ranges_error] = get_ranges(str_1.ptr(), tx_map);
@@ -289,8 +475,10 @@ api_copy_and_shift_ranges_from_strings(py::handle& str_1,
         py::set_error(PyExc_TypeError, MSG_ERROR_TAINT_MAP);
         return;
     }
-    if (const bool result = set_ranges(str_2.ptr(), shift_taint_ranges(ranges, offset, new_length), tx_map);
-        not result) {
+    // get_ranges handed back our own copy; shift it in place rather than
+    // copying it a second time
+    shift_taint_ranges_inplace(ranges, offset, new_length);
+    if (const bool result = set_ranges(str_2.ptr(), ranges, tx_map); not result) {
         py::set_error(PyExc_TypeError, MSG_ERROR_SET_RANGES);
     }
 }
@@ -301,28 +489,86 @@ get_tainted_object(PyObject* str, const TaintRangeMapTypePtr& tx_map)
     if (not str)
         return nullptr;
 
-    if (is_notinterned_notfasttainted_unicode(str) or tx_map->empty()) {
+    if (not tx_map or is_notinterned_notfasttainted_unicode(str) or is_notfasttainted_bytes(str) or tx_map->empty()) {
         return nullptr;
     }
 
-    const auto it = tx_map->find(get_unique_id(str));
-    if (it == tx_map->end()) {
+    const auto obj_id = get_unique_id(str);
+    if (not tx_map->maybe_contains(obj_id)) {
+        // Definitely never tainted in this context, skip the hash computation
+        // and the shard probe (this covers bytes/bytearray, which have no
+        // fast-taint mark)
         return nullptr;
     }
+    // Lazy hash: entries stored with a deferred hash (the bytearray extend
+    // loop) settle it here, others compute it only when a probe actually hits
+    return tx_map->get_lazy_hash(obj_id, [str] { return get_internal_hash(str); });
+}
 
-    if (get_internal_hash(str) != it->second.first) {
-        tx_map->erase(it);
-        return nullptr;
+namespace {
+
+struct ByteArrayHashEntry
+{
+    Py_ssize_t size;
+    uint64_t witness;
+    Py_hash_t hash;
+};
+
+// Per-process content-hash cache for bytearrays, GIL-guarded like the parse
+// caches. Keys are raw addresses and entries are validated by the witness, so
+// no references are held and eviction is a wholesale clear.
+std::unordered_map<PyObject*, ByteArrayHashEntry> bytearray_hash_cache;
+constexpr size_t BYTEARRAY_HASH_CACHE_MAX_ENTRIES = 256;
+constexpr Py_ssize_t WITNESS_SAMPLE_BYTES = 64;
+
+/**
+ * Cheap change witness: FNV-1a over the first and last WITNESS_SAMPLE_BYTES
+ * of the buffer. Constant cost regardless of the bytearray size; mutations
+ * that only touch the untouched middle of a large buffer can slip by, which
+ * matches the probabilistic role the hash already plays in the taint map.
+ */
+uint64_t
+bytearray_witness(const char* buffer, const Py_ssize_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const auto mix = [&hash](const char byte) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 1099511628211ULL;
+    };
+    const auto head = min(size, WITNESS_SAMPLE_BYTES);
+    for (Py_ssize_t i = 0; i < head; i++) {
+        mix(buffer[i]);
+    }
+    for (Py_ssize_t i = max(size - WITNESS_SAMPLE_BYTES, head); i < size; i++) {
+        mix(buffer[i]);
     }
-    return it == tx_map->end() ? nullptr : it->second.second;
+    return hash;
 }
 
+} // namespace
+
 Py_hash_t
 bytearray_hash(PyObject* bytearray)
 {
-    // Bytearrays don't have hash by default so we will generate one by getting the internal str hash
-    auto str = py::str(bytearray);
-    return PyObject_Hash(str.ptr());
+    // Bytearrays don't hash by default; hash the raw buffer directly and
+    // cache the result keyed on (size, sampled checksum) so the streaming
+    // case of repeated lookups on a large, mostly-stable buffer doesn't
+    // rehash the full contents every time
+    const char* buffer = PyByteArray_AS_STRING(bytearray);
+    const Py_ssize_t size = PyByteArray_GET_SIZE(bytearray);
+    const uint64_t witness = bytearray_witness(buffer, size);
+
+    if (const auto it = bytearray_hash_cache.find(bytearray);
+        it != bytearray_hash_cache.end() and it->second.size == size and it->second.witness == witness) {
+        return it->second.hash;
+    }
+
+    const Py_hash_t hash = _Py_HashBytes(buffer, size);
+    if (bytearray_hash_cache.size() >= BYTEARRAY_HASH_CACHE_MAX_ENTRIES) {
+        bytearray_hash_cache.clear();
+    }
+    bytearray_hash_cache[bytearray] = { size, witness, hash };
+    return hash;
 }
 
 Py_hash_t
@@ -354,26 +600,15 @@ get_internal_hash(PyObject* obj)
 void
 set_tainted_object(PyObject* str, TaintedObjectPtr tainted_object, const TaintRangeMapTypePtr& tx_map)
 {
-    if (not str or not is_tainteable(str)) {
+    if (not str or not is_tainteable(str) or not tx_map) {
         return;
     }
     auto obj_id = get_unique_id(str);
     set_fast_tainted_if_notinterned_unicode(str);
-    if (const auto it = tx_map->find(obj_id); it != tx_map->end()) {
-        // The same memory address was probably re-used for a different PyObject, so
-        // we need to overwrite it.
-        if (it->second.second != tainted_object) {
-            // If the tainted object is different, we need to decref the previous one
-            // and incref the new one. But if it's the same object, we can avoid both
-            // operations, since they would be redundant.
-            it->second.second.reset();
-            it->second = std::make_pair(get_internal_hash(str), tainted_object);
-        }
-        // Update the hash, because for bytearrays it could have changed after the extend operation
-        it->second.first = get_internal_hash(str);
-        return;
-    }
-    tx_map->insert({ obj_id, std::make_pair(get_internal_hash(str), tainted_object) });
+    set_fast_tainted_if_bytes(str);
+    // put() overwrites any entry left behind by a re-used memory address, and
+    // refreshes the hash, which for bytearrays can change after an extend
+    tx_map->put(obj_id, get_internal_hash(str), std::move(tainted_object));
 }
 
 // OPTIMIZATION TODO: export the variant of these functions taking a PyObject*
@@ -449,7 +684,10 @@ pyexport_taintrange(py::module& m)
       // Normal constructor disabled on the Python side, see above
       .def_readonly("start", &TaintRange::start)
       .def_readonly("length", &TaintRange::length)
-      .def_readonly("source", &TaintRange::source)
+      // The interned Source is immutable and shared between ranges; hand a
+      // value copy to Python like def_readonly used to
+      .def_property_readonly("source",
+                             [](const TaintRange& self) { return self.source ? *self.source : Source("", "", OriginType::EMPTY); })
       .def("__str__", &TaintRange::toString)
       .def("__repr__", &TaintRange::toString)
       .def("__hash__", &TaintRange::get_hash)
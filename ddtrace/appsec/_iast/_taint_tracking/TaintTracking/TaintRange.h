@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <sstream>
 #include <utility>
 
@@ -8,6 +9,7 @@
 
 #include "Constants.h"
 #include "TaintTracking/Source.h"
+#include "Utils/SmallVector.h"
 #include "Utils/StringUtils.h"
 
 using namespace std;
@@ -16,33 +18,271 @@ namespace py = pybind11;
 // Forward declarations
 class TaintedObject;
 
-// Alias
-using TaintedObjectPtr = shared_ptr<TaintedObject>;
+// Alias. Intrusive GIL-guarded refcount (see Utils/RefCounted.h): map
+// lookups, batch entries and aspect locals copy this pointer constantly
+using TaintedObjectPtr = RcPtr<TaintedObject>;
+
+// Map keys are object addresses: the low bits are dead (allocation
+// alignment) and the rest is already close to uniform, so one multiplicative
+// mix of the alignment-stripped pointer beats a general-purpose string-style
+// hash. The same mix feeds the bloom filter's bit positions.
+struct PointerKeyHash
+{
+    size_t operator()(const uintptr_t key) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(key) >> 4) * 0x9E3779B97F4A7C15ULL);
+    }
+};
 
 #ifdef NDEBUG // Decide wether to use abseil
 
 #include "absl/container/node_hash_map.h"
-using TaintRangeMapType = absl::node_hash_map<uintptr_t, std::pair<Py_hash_t, TaintedObjectPtr>>;
+using TaintMapShardType = absl::node_hash_map<uintptr_t, std::pair<Py_hash_t, TaintedObjectPtr>, PointerKeyHash>;
 
 #else
 
-#include <unordered_map>
-using TaintRangeMapType = std::map<uintptr_t, std::pair<Py_hash_t, TaintedObjectPtr>>;
+#include <map>
+using TaintMapShardType = std::map<uintptr_t, std::pair<Py_hash_t, TaintedObjectPtr>>;
 
 #endif // NDEBUG
 
+#include <array>
+#include <atomic>
+#include <mutex>
+
+/**
+ * Tainting map sharded by pointer bits, with a mutex per shard, so concurrent
+ * request threads (and eventually free-threaded CPython) don't serialize every
+ * lookup through a single structure. Lookups and stores go through get()/put()
+ * so the atomic size counter stays consistent; empty()/size() never take a
+ * lock.
+ */
+class TaintRangeMapType
+{
+  public:
+    static constexpr size_t SHARD_COUNT = 16; // Must be a power of two
+
+    /**
+     * Bloom pre-check: false means the key was never stored in this map, so
+     * callers can skip both the object-hash computation and the shard probe.
+     * False positives just fall through to the normal lookup; stale bits from
+     * erased entries only cost the same. The filter is rebuilt from scratch on
+     * clear().
+     */
+    [[nodiscard]] bool maybe_contains(const uintptr_t key) const
+    {
+        const auto [first_bit, second_bit] = bloom_positions(key);
+        if ((bloom_[first_bit / 64].load(std::memory_order_relaxed) & (1ULL << (first_bit % 64))) == 0) {
+            return false;
+        }
+        return (bloom_[second_bit / 64].load(std::memory_order_relaxed) & (1ULL << (second_bit % 64))) != 0;
+    }
+
+    // Sentinel for entries stored with the hash recompute deferred (mutable
+    // bytearray builders): PyObject_Hash never returns -1 on success
+    static constexpr Py_hash_t DEFERRED_HASH = -1;
+
+    TaintedObjectPtr get(const uintptr_t key, const Py_hash_t obj_hash)
+    {
+        return get_lazy_hash(key, [obj_hash] { return obj_hash; });
+    }
+
+    /**
+     * Same as get(), but the object hash is only computed when the entry
+     * actually needs validating. For bytearrays the hash is O(len) of the
+     * whole buffer, so callers in hot paths pass a lazy callback; entries
+     * stored with put_deferred_hash() take their hash from the first read.
+     */
+    template<typename HashFn>
+    TaintedObjectPtr get_lazy_hash(const uintptr_t key, HashFn&& obj_hash_fn, const bool settle_deferred = true)
+    {
+        if (not maybe_contains(key)) {
+            return nullptr;
+        }
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        purge_if_stale(shard);
+        const auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return nullptr;
+        }
+        if (it->second.first == DEFERRED_HASH) {
+            // Deferred entry: settle the hash so later lookups validate
+            // address reuse again, unless the caller is about to re-store it
+            // deferred anyway (the extend loop)
+            if (settle_deferred) {
+                it->second.first = obj_hash_fn();
+            }
+            return it->second.second;
+        }
+        if (it->second.first != obj_hash_fn()) {
+            // The address was re-used by a different object (or the object was
+            // mutated); drop the stale entry
+            shard.map.erase(it);
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return it->second.second;
+    }
+
+    void put(const uintptr_t key, const Py_hash_t obj_hash, TaintedObjectPtr tainted)
+    {
+        const auto [first_bit, second_bit] = bloom_positions(key);
+        bloom_[first_bit / 64].fetch_or(1ULL << (first_bit % 64), std::memory_order_relaxed);
+        bloom_[second_bit / 64].fetch_or(1ULL << (second_bit % 64), std::memory_order_relaxed);
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        purge_if_stale(shard);
+        const auto [it, inserted] = shard.map.insert_or_assign(key, std::make_pair(obj_hash, std::move(tainted)));
+        if (inserted) {
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Stores an entry without computing the object's content hash: the next
+     * get_lazy_hash() settles it. Used by the bytearray extend aspect, where
+     * re-hashing the growing buffer on every append is O(total built).
+     */
+    void put_deferred_hash(const uintptr_t key, TaintedObjectPtr tainted)
+    {
+        put(key, DEFERRED_HASH, std::move(tainted));
+    }
+
+    // One batch entry per object: {key, object hash, tainted object}
+    using BatchEntry = std::tuple<uintptr_t, Py_hash_t, TaintedObjectPtr>;
+
+    /**
+     * Stores a whole batch of entries taking each shard lock at most once,
+     * instead of once per entry. Used by the splitters, where one operation
+     * can produce thousands of tainted fragments.
+     */
+    void put_batch(std::vector<BatchEntry>& entries)
+    {
+        for (const auto& [key, obj_hash, tainted] : entries) {
+            const auto [first_bit, second_bit] = bloom_positions(key);
+            bloom_[first_bit / 64].fetch_or(1ULL << (first_bit % 64), std::memory_order_relaxed);
+            bloom_[second_bit / 64].fetch_or(1ULL << (second_bit % 64), std::memory_order_relaxed);
+        }
+        // Group the entries per shard so each lock is taken a single time
+        std::stable_sort(entries.begin(), entries.end(), [](const BatchEntry& a, const BatchEntry& b) {
+            return shard_index(std::get<0>(a)) < shard_index(std::get<0>(b));
+        });
+        for (size_t i = 0; i < entries.size();) {
+            const size_t shard_idx = shard_index(std::get<0>(entries[i]));
+            Shard& shard = shards_[shard_idx];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            purge_if_stale(shard);
+            for (; i < entries.size() and shard_index(std::get<0>(entries[i])) == shard_idx; ++i) {
+                auto& [key, obj_hash, tainted] = entries[i];
+                const auto [it, inserted] = shard.map.insert_or_assign(key, std::make_pair(obj_hash, std::move(tainted)));
+                if (inserted) {
+                    size_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool empty() const { return size_.load(std::memory_order_relaxed) == 0; }
+
+    [[nodiscard]] size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    /**
+     * O(1) generation-based reset: instead of iterating the shards (50k
+     * entries under a heavily tainted request), bump the generation counter;
+     * each shard drops its stale contents lazily the first time it is locked
+     * afterwards. Entries of the old generation keep their TaintedObjects (and
+     * thus the old context arena) alive until that purge, which is bounded by
+     * one request's footprint.
+     */
+    void clear()
+    {
+        // Remember how big this context got: warm requests tend to look like
+        // the last one, so the next generation reserves each shard at its
+        // share of this size and inserts without rehashing
+        last_context_size_.store(size_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_relaxed);
+        for (auto& word : bloom_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+    // Debug-only iteration; holds each shard lock in turn. func returns
+    // false to stop early (bounded dumps don't walk the whole map).
+    template<typename Func>
+    void for_each(Func&& func)
+    {
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            purge_if_stale(shard);
+            for (const auto& [key, value] : shard.map) {
+                if (not func(key, value)) {
+                    return;
+                }
+            }
+        }
+    }
+
+  private:
+    struct Shard
+    {
+        std::mutex mutex;
+        TaintMapShardType map;
+        uint32_t generation = 0;
+    };
+
+    // Must be called with the shard lock held
+    void purge_if_stale(Shard& shard)
+    {
+        if (const auto current = generation_.load(std::memory_order_relaxed); shard.generation != current) {
+            shard.map.clear();
+            shard.generation = current;
+#ifdef NDEBUG
+            // Pre-size from the per-context history the first time the shard
+            // is touched in the new generation (std::map in debug builds has
+            // no capacity to reserve)
+            shard.map.reserve(last_context_size_.load(std::memory_order_relaxed) / SHARD_COUNT);
+#endif
+        }
+    }
+
+    // The low pointer bits are dead (allocation alignment), shard on the bits
+    // above them
+    static size_t shard_index(const uintptr_t key) { return (key >> 4) & (SHARD_COUNT - 1); }
+
+    Shard& shard_for(const uintptr_t key) { return shards_[shard_index(key)]; }
+
+    static constexpr size_t BLOOM_BITS = 1 << 16;
+
+    // Two independent 16-bit positions taken from the same pointer mix the
+    // shard maps hash with
+    static std::pair<uint32_t, uint32_t> bloom_positions(const uintptr_t key)
+    {
+        const uint64_t mixed = PointerKeyHash{}(key);
+        return { static_cast<uint32_t>(mixed >> 48) & (BLOOM_BITS - 1),
+                 static_cast<uint32_t>(mixed >> 32) & (BLOOM_BITS - 1) };
+    }
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::array<std::atomic<uint64_t>, BLOOM_BITS / 64> bloom_{};
+    std::atomic<size_t> size_{ 0 };
+    std::atomic<uint32_t> generation_{ 0 };
+    // Final size of the previous generation, feeding the shard reservations
+    std::atomic<size_t> last_context_size_{ 0 };
+};
+
 using TaintRangeMapTypePtr = shared_ptr<TaintRangeMapType>;
-// using TaintRangeMapTypePtr = TaintRangeMapType*;
 
 struct TaintRange
 {
     RANGE_START start = 0;
     RANGE_LENGTH length = 0;
-    Source source;
+    SourcePtr source;
 
     TaintRange() = default;
 
-    TaintRange(const RANGE_START start, const RANGE_LENGTH length, Source source)
+    TaintRange(const RANGE_START start, const RANGE_LENGTH length, SourcePtr source)
       : start(start)
       , length(length)
       , source(std::move(source))
@@ -52,7 +292,14 @@ struct TaintRange
         }
     }
 
-    inline void set_values(const RANGE_START start_, const RANGE_LENGTH length_, Source source_)
+    // Convenience overload for callers holding a Source by value (tests, the
+    // pybind constructor); prefer the SourcePtr one on hot paths
+    TaintRange(const RANGE_START start, const RANGE_LENGTH length, Source source)
+      : TaintRange(start, length, make_refcounted<const Source>(std::move(source)))
+    {
+    }
+
+    inline void set_values(const RANGE_START start_, const RANGE_LENGTH length_, SourcePtr source_)
     {
         if (length_ <= 0) {
             throw std::invalid_argument("Error: Length cannot be set to 0.");
@@ -71,27 +318,58 @@ struct TaintRange
     explicit operator std::string() const;
 };
 
+// Only used at the pybind boundary (the TaintRange_ Python class is held by
+// shared_ptr); all internal range lists carry TaintRange by value
 using TaintRangePtr = shared_ptr<TaintRange>;
-using TaintRangeRefs = vector<TaintRangePtr>;
+// Flat value storage: a TaintRange is {start, length, interned source}, so
+// range scans are cache-linear with no pointer chasing or refcount traffic.
+// Inline capacity sized so the 1-2 ranges carried by >90% of tainted strings
+// never hit the heap.
+using TaintRangeRefs = SmallVector<TaintRange, 4>;
 
-TaintRangePtr
-shift_taint_range(const TaintRangePtr& source_taint_range, RANGE_START offset, RANGE_LENGTH new_length);
+TaintRange
+shift_taint_range(const TaintRange& source_taint_range, RANGE_START offset, RANGE_LENGTH new_length);
 
 inline TaintRangePtr
 api_shift_taint_range(const TaintRangePtr& source_taint_range, const RANGE_START offset, const RANGE_LENGTH new_length)
 {
-    return shift_taint_range(source_taint_range, offset, new_length);
+    return make_shared<TaintRange>(shift_taint_range(*source_taint_range, offset, new_length));
 }
 
 TaintRangeRefs
 shift_taint_ranges(const TaintRangeRefs& source_taint_ranges, RANGE_START offset, RANGE_LENGTH new_length);
 
+// In-place bulk variant for callers that own their range list: adds the
+// offset (and optionally rewrites the length) across the flat storage with no
+// copies or refcount traffic
+void
+shift_taint_ranges_inplace(TaintRangeRefs& ranges, RANGE_START offset, RANGE_LENGTH new_length = -1);
+
 TaintRangeRefs
 api_shift_taint_ranges(const TaintRangeRefs&, RANGE_START offset, RANGE_LENGTH new_length);
 
 std::pair<TaintRangeRefs, bool>
 get_ranges(PyObject* string_input, const TaintRangeMapTypePtr& tx_map);
 
+/**
+ * Borrowing result of get_ranges_view: `*view` is the TaintedObject's own
+ * range list, kept alive by `owner`, so read-only consumers do no per-range
+ * copies or refcount traffic. Valid while the view (and the map reference it
+ * was obtained from) is held; `error` mirrors get_ranges' second element.
+ */
+struct TaintRangesView
+{
+    TaintedObjectPtr owner;
+    const TaintRangeRefs* ranges{ nullptr };
+    bool error{ false };
+
+    [[nodiscard]] bool empty() const { return ranges == nullptr or ranges->empty(); }
+    const TaintRangeRefs& operator*() const { return *ranges; }
+};
+
+TaintRangesView
+get_ranges_view(PyObject* string_input, const TaintRangeMapTypePtr& tx_map);
+
 bool
 set_ranges(PyObject* str, const TaintRangeRefs& ranges, const TaintRangeMapTypePtr& tx_map);
 
@@ -110,6 +388,9 @@ api_copy_and_shift_ranges_from_strings(py::handle& str_1, py::handle& str_2, int
 PyObject*
 api_set_ranges_from_values(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
 
+PyObject*
+api_taint_pyobject_batch(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
+
 // Returns a tuple with (all ranges, ranges of candidate_text)
 std::tuple<TaintRangeRefs, TaintRangeRefs>
 are_all_text_all_ranges(PyObject* candidate_text, const py::tuple& parameter_list);
@@ -11,21 +11,20 @@ namespace py = pybind11;
  *
  * @return A new taint range with the given offset and maximum length.
  */
-TaintRangePtr
-allocate_limited_taint_range_with_offset(const TaintRangePtr& source_taint_range,
+TaintRange
+allocate_limited_taint_range_with_offset(const TaintRange& source_taint_range,
                                          const RANGE_START offset,
                                          const RANGE_LENGTH max_length)
 {
     RANGE_LENGTH length;
     if (max_length != -1)
-        length = min(max_length, source_taint_range->length);
+        length = min(max_length, source_taint_range.length);
     else
-        length = source_taint_range->length;
+        length = source_taint_range.length;
 
-    auto tptr = initializer->allocate_taint_range(offset,                      // start
-                                                  length,                      // length
-                                                  source_taint_range->source); // source
-    return tptr;
+    return { offset,                      // start
+             length,                      // length
+             source_taint_range.source }; // source
 }
 
 /**
@@ -33,17 +32,45 @@ allocate_limited_taint_range_with_offset(const TaintRangePtr& source_taint_range
  * @param source_taint_range The source taint range.
  * @param offset The offset to be applied.
  */
-TaintRangePtr
-shift_taint_range(const TaintRangePtr& source_taint_range, const RANGE_START offset)
+TaintRange
+shift_taint_range(const TaintRange& source_taint_range, const RANGE_START offset)
 {
-    auto tptr = initializer->allocate_taint_range(source_taint_range->start + offset, // start
-                                                  source_taint_range->length,         // length
-                                                  source_taint_range->source);        // source
-    return tptr;
+    return { source_taint_range.start + offset, // start
+             source_taint_range.length,         // length
+             source_taint_range.source };       // source
 }
 
 /**
- * This function shifts the taint ranges by the given offset.
+ * Merges next into the tail of own_ranges when the two intervals touch and
+ * their sources compare equal. Repeated concatenation of fragments of one
+ * logical source (templating builds hundreds of adjacent ranges otherwise)
+ * collapses into a single growing range, keeping every later scan short.
+ * Sources are interned per context, so the pointer comparison is the common
+ * hit and the deep comparison only runs for equal-by-value duplicates.
+ */
+static inline bool
+coalesce_with_tail(TaintRangeRefs& own_ranges, const TaintRange& next)
+{
+    if (own_ranges.empty()) {
+        return false;
+    }
+    auto& tail = own_ranges.back();
+    if (tail.start + tail.length != next.start) {
+        return false;
+    }
+    if (tail.source != next.source and
+        (not tail.source or not next.source or not(*tail.source == *next.source))) {
+        return false;
+    }
+    tail.length += next.length;
+    return true;
+}
+
+/**
+ * This function records the other object's ranges as a deferred rope
+ * fragment: the shift is only applied when the ranges are actually read, so
+ * building a string with repeated `+`/`+=` (or bytearray extend) is
+ * amortized O(1) per append.
  *
  * @param tainted_object The tainted object.
  * @param offset The offset to be applied.
@@ -56,8 +83,20 @@ TaintedObject::add_ranges_shifted(const TaintedObjectPtr tainted_object,
                                   const RANGE_LENGTH max_length,
                                   const RANGE_START orig_offset)
 {
-    const auto& ranges = tainted_object->get_ranges();
-    add_ranges_shifted(ranges, offset, max_length, orig_offset);
+    // The operand resolves its own rope first, so the recorded fragment is a
+    // plain shared list and chains never nest
+    if (tainted_object->pending_) {
+        tainted_object->flatten_pending();
+    }
+    if (!tainted_object->ranges_ or tainted_object->ranges_->empty()) {
+        return;
+    }
+    const int depth = pending_ ? pending_->depth + 1 : 1;
+    pending_ = std::make_shared<RangeFragment>(
+      RangeFragment{ std::move(pending_), tainted_object->ranges_, offset, max_length, orig_offset, depth });
+    if (depth >= PENDING_FRAGMENT_LIMIT) {
+        flatten_pending();
+    }
 }
 
 /**
@@ -74,23 +113,54 @@ TaintedObject::add_ranges_shifted(TaintRangeRefs ranges,
                                   const RANGE_LENGTH max_length,
                                   const RANGE_START orig_offset)
 {
-    if (const auto to_add = static_cast<long>(min(ranges.size(), TAINT_RANGE_LIMIT - ranges_.size()));
+    if (pending_) {
+        // Earlier deferred appends must land first to keep the range order
+        flatten_pending();
+    }
+    append_shifted(ranges, offset, max_length, orig_offset);
+}
+
+/**
+ * Eager worker shared by the direct append path and the rope flattening:
+ * shifts the given ranges and appends them to the own (COW) list, honoring
+ * TAINT_RANGE_LIMIT.
+ */
+void
+TaintedObject::append_shifted(const TaintRangeRefs& ranges,
+                              const RANGE_START offset,
+                              const RANGE_LENGTH max_length,
+                              const RANGE_START orig_offset) const
+{
+    const size_t own_size = ranges_ ? ranges_->size() : 0;
+    if (const auto to_add = static_cast<long>(min(ranges.size(), TAINT_RANGE_LIMIT - own_size));
         !ranges.empty() and to_add > 0) {
-        ranges_.reserve(ranges_.size() + to_add);
+        auto& own_ranges = mutable_ranges();
+        own_ranges.reserve(own_ranges.size() + to_add);
         if (offset == 0 and max_length == -1) {
-            ranges_.insert(ranges_.end(), ranges.begin(), ranges.end());
+            auto begin = ranges.begin();
+            // Only the seam can touch: adjacency within the operand's own
+            // list was already coalesced when that operand was built
+            if (coalesce_with_tail(own_ranges, *begin)) {
+                ++begin;
+            }
+            own_ranges.insert(own_ranges.end(), begin, ranges.end());
         } else {
             int i = 0;
             for (const auto& trange : ranges) {
                 if (max_length != -1 and orig_offset != -1) {
                     // Make sure original position (orig_offset) is covered by the range
-                    if (trange->start <= orig_offset and
-                        ((trange->start + trange->length) >= orig_offset + max_length)) {
-                        ranges_.emplace_back(allocate_limited_taint_range_with_offset(trange, offset, max_length));
+                    if (trange.start <= orig_offset and ((trange.start + trange.length) >= orig_offset + max_length)) {
+                        if (const auto limited = allocate_limited_taint_range_with_offset(trange, offset, max_length);
+                            not coalesce_with_tail(own_ranges, limited)) {
+                            own_ranges.emplace_back(limited);
+                        }
                         i++;
                     }
                 } else {
-                    ranges_.emplace_back(shift_taint_range(trange, offset));
+                    if (const auto shifted = shift_taint_range(trange, offset);
+                        not coalesce_with_tail(own_ranges, shifted)) {
+                        own_ranges.emplace_back(shifted);
+                    }
                     i++;
                 }
                 if (i >= to_add) {
@@ -101,16 +171,34 @@ TaintedObject::add_ranges_shifted(TaintRangeRefs ranges,
     }
 }
 
+/**
+ * Applies the pending fragment chain, oldest first, onto the own list. The
+ * chain nodes stay untouched, so other objects sharing a prefix of the rope
+ * keep their view.
+ */
+void
+TaintedObject::flatten_pending() const
+{
+    std::vector<const RangeFragment*> fragments;
+    for (const auto* fragment = pending_.get(); fragment != nullptr; fragment = fragment->prev.get()) {
+        fragments.push_back(fragment);
+    }
+    for (auto it = fragments.rbegin(); it != fragments.rend(); ++it) {
+        append_shifted(*(*it)->ranges, (*it)->offset, (*it)->max_length, (*it)->orig_offset);
+    }
+    pending_.reset();
+}
+
 std::string
 TaintedObject::toString() const
 {
     stringstream ss;
 
     ss << "TaintedObject [";
-    if (not ranges_.empty()) {
+    if (not get_ranges().empty()) {
         ss << ", ranges=[";
-        for (const auto& range : ranges_) {
-            ss << range->toString() << ", ";
+        for (const auto& range : get_ranges()) {
+            ss << range.toString() << ", ";
         }
         ss << "]";
     }
@@ -125,24 +213,18 @@ TaintedObject::operator string() const
 }
 
 void
-TaintedObject::move_ranges_to_stack()
+TaintedObject::release_ranges()
 {
-    for (const auto& range_ptr : ranges_) {
-        if (!range_ptr) {
-            continue;
-        }
-        initializer->release_taint_range(range_ptr);
-    }
-    ranges_.clear();
+    // Drops this object's references to the (possibly shared) range list
+    // and rope; other objects sharing them keep their view
+    ranges_.reset();
+    pending_.reset();
 }
 
 void
 TaintedObject::reset()
 {
-    move_ranges_to_stack();
-    if (initializer) {
-        ranges_.reserve(RANGES_INITIAL_RESERVE);
-    }
+    release_ranges();
 }
 
 void
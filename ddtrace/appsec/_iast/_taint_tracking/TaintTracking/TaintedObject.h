@@ -1,39 +1,120 @@
 #pragma once
+#include "Initializer/Arena.h"
 #include "TaintTracking/TaintRange.h"
 #include <Python.h>
 
-class TaintedObject
+class TaintedObject : public RefCounted<TaintedObject>
 {
     friend class Initializer;
 
   private:
-    TaintRangeRefs ranges_;
+    // Range lists are shared copy-on-write between tainted objects:
+    // allocate_tainted_object_copy only bumps the refcount and the list is
+    // cloned lazily on the first mutation while it is still shared.
+    using SharedRanges = std::shared_ptr<TaintRangeRefs>;
+
+    /**
+     * One deferred concatenation fragment: the shared range list of an
+     * appended operand plus the shift parameters it was appended with.
+     * `prev` links to the fragment appended before it, so repeated `+`/`+=`
+     * appends build an immutable rope that the intermediate results share
+     * structurally; nothing is copied until the ranges are actually read.
+     */
+    struct RangeFragment
+    {
+        std::shared_ptr<RangeFragment> prev;
+        SharedRanges ranges;
+        RANGE_START offset;
+        RANGE_LENGTH max_length;
+        RANGE_START orig_offset;
+        int depth;
+    };
+
+    // Both mutable because flattening happens on the first (const) read
+    mutable SharedRanges ranges_;
+    mutable std::shared_ptr<RangeFragment> pending_;
+
+    // Set by Initializer for arena-backed objects: keeps the arena alive
+    // while this object does, replacing the per-object reference the
+    // ArenaAllocator used to hold inside the shared_ptr control block.
+    // Mutable so dispose() can move it out.
+    mutable ArenaPtr arena_keepalive_;
+
+    TaintRangeRefs& mutable_ranges() const
+    {
+        if (!ranges_) {
+            ranges_ = std::make_shared<TaintRangeRefs>();
+            ranges_->reserve(RANGES_INITIAL_RESERVE);
+        } else if (ranges_.use_count() > 1) {
+            ranges_ = std::make_shared<TaintRangeRefs>(*ranges_);
+        }
+        return *ranges_;
+    }
+
+    // Ranges are kept ordered by start so consumers (e.g. the slice aspect)
+    // can binary-search for a window. Aspect-propagated ranges already come
+    // ordered, so the common case is just the is_sorted scan.
+    void sort_if_needed()
+    {
+        if (ranges_ and not std::is_sorted(ranges_->begin(), ranges_->end(), [](const TaintRange& a, const TaintRange& b) {
+                return a.start < b.start;
+            })) {
+            std::sort(ranges_->begin(), ranges_->end(), [](const TaintRange& a, const TaintRange& b) {
+                return a.start < b.start;
+            });
+        }
+    }
+
+    void append_shifted(const TaintRangeRefs& ranges,
+                        RANGE_START offset,
+                        RANGE_LENGTH max_length,
+                        RANGE_START orig_offset) const;
+
+    void flatten_pending() const;
 
   public:
     constexpr static int TAINT_RANGE_LIMIT = 100;
     constexpr static int RANGES_INITIAL_RESERVE = 16;
+    // Pending fragment chains are flattened eagerly past this depth: it
+    // keeps the per-read flatten cost bounded without giving up the
+    // amortized O(1) append
+    constexpr static int PENDING_FRAGMENT_LIMIT = 128;
 
-    TaintedObject() { ranges_.reserve(RANGES_INITIAL_RESERVE); };
+    TaintedObject() = default;
 
     TaintedObject& operator=(const TaintedObject&) = delete;
 
     inline void set_values(TaintRangeRefs ranges)
     {
-        // Move back the ranges to the ranges stack
-        move_ranges_to_stack();
-        ranges_ = std::move(ranges);
+        ranges_ = std::make_shared<TaintRangeRefs>(std::move(ranges));
+        pending_.reset();
+        sort_if_needed();
     }
 
     inline void copy_values(const TaintRangeRefs& ranges)
     {
-        // Move back the ranges to the ranges stack
-        move_ranges_to_stack();
-        ranges_ = ranges;
+        ranges_ = std::make_shared<TaintRangeRefs>(ranges);
+        pending_.reset();
+        sort_if_needed();
     }
 
-    [[nodiscard]] const TaintRangeRefs& get_ranges() const { return ranges_; }
+    /** Shares the other object's range list (and rope) without copying. */
+    inline void share_values(const TaintedObject& other)
+    {
+        ranges_ = other.ranges_;
+        pending_ = other.pending_;
+    }
+
+    [[nodiscard]] const TaintRangeRefs& get_ranges() const
+    {
+        static const TaintRangeRefs empty_ranges{};
+        if (pending_) {
+            flatten_pending();
+        }
+        return ranges_ ? *ranges_ : empty_ranges;
+    }
 
-    [[nodiscard]] TaintRangeRefs get_ranges_copy() const { return ranges_; }
+    [[nodiscard]] TaintRangeRefs get_ranges_copy() const { return get_ranges(); }
 
     void add_ranges_shifted(TaintedObjectPtr tainted_object,
                             RANGE_START offset,
@@ -49,9 +130,23 @@ class TaintedObject
 
     explicit operator string() const;
 
-    void move_ranges_to_stack();
+    void release_ranges();
 
     void reset();
+
+    void dispose() const
+    {
+        if (arena_keepalive_) {
+            // Arena-backed: run the destructor only, the block is reclaimed
+            // wholesale when the arena itself dies. The local reference keeps
+            // the arena (and with it this object's storage) alive until the
+            // destructor has finished.
+            const ArenaPtr keepalive = std::move(arena_keepalive_);
+            this->~TaintedObject();
+        } else {
+            delete this;
+        }
+    }
 };
 
 void
@@ -0,0 +1,95 @@
+#include "EvidenceRedaction.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+using namespace pybind11::literals;
+
+namespace {
+
+inline unsigned char
+ascii_lower(const char c)
+{
+    const auto uc = static_cast<unsigned char>(c);
+    return (uc >= 'A' && uc <= 'Z') ? static_cast<unsigned char>(uc + ('a' - 'A')) : uc;
+}
+
+// Case-insensitive multi-literal matcher with a first-byte index: each scan
+// position dispatches on its lowercased byte to the (usually empty) list of
+// literals starting with it, so the common case is one table lookup per byte.
+// Literals must be given lowercase.
+class LiteralSet
+{
+  public:
+    LiteralSet(std::initializer_list<std::string_view> literals)
+      : literals_{ literals }
+    {
+        for (size_t i = 0; i < literals_.size(); ++i) {
+            by_first_byte_[static_cast<unsigned char>(literals_[i].front())].push_back(i);
+        }
+    }
+
+    [[nodiscard]] bool contains_any(std::string_view text) const
+    {
+        for (size_t i = 0; i < text.size(); ++i) {
+            const auto& candidates = by_first_byte_[ascii_lower(text[i])];
+            for (const auto idx : candidates) {
+                const auto& literal = literals_[idx];
+                if (literal.size() > text.size() - i) {
+                    continue;
+                }
+                size_t k = 1;
+                while (k < literal.size() && ascii_lower(text[i + k]) == static_cast<unsigned char>(literal[k])) {
+                    ++k;
+                }
+                if (k == literal.size()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::vector<std::string_view> literals_;
+    std::array<std::vector<size_t>, 256> by_first_byte_{};
+};
+
+// Anchors for the default name pattern: every alternative of the regex
+// ((?i)^.*(p(ass)?w(or)?d|pass(_?phrase)?|secret|..._key(_?id)?|token|
+// username|user_id|last.name|consumer_...|sign...|auth...)) contains one of
+// these literals, so "no anchor" implies "no match".
+const LiteralSet sensitive_name_literals{
+    "pwd", "pword", "pass", "secret", "key", "token", "user", "last", "consumer", "sign", "auth",
+};
+
+// Anchors for the default value pattern (bearer tokens, gh* tokens, JWTs,
+// PEM private keys, ssh keys); "ey" + [i-l] anchors the two JWT segments.
+const LiteralSet sensitive_value_literals{
+    "bearer", "token:", "password", "gho_", "ghp_", "ghs_", "ghu_",
+    "eyi",    "eyj",    "eyk",      "eyl",  "-----begin", "ssh-rsa",
+};
+
+} // namespace
+
+bool
+has_sensitive_name_candidate(std::string_view text)
+{
+    return sensitive_name_literals.contains_any(text);
+}
+
+bool
+has_sensitive_value_candidate(std::string_view text)
+{
+    return sensitive_value_literals.contains_any(text);
+}
+
+py::module
+pyexport_m_evidence_redaction(py::module& m)
+{
+    py::module m_redaction = m.def_submodule("redaction", "Evidence redaction candidate prescreen");
+    m_redaction.def("has_name_candidate", &has_sensitive_name_candidate, "text"_a);
+    m_redaction.def("has_value_candidate", &has_sensitive_value_candidate, "text"_a);
+    return m_redaction;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include <string_view>
+
+namespace py = pybind11;
+
+// Candidate prescreen for evidence redaction.  The default redaction regexes
+// (asm.py: DD_IAST_REDACTION_NAME_PATTERN / DD_IAST_REDACTION_VALUE_PATTERN)
+// can only match a string that contains at least one of a small set of
+// case-insensitive literal anchors ("pass", "token", "bearer", ...).  These
+// scanners answer "could the regex possibly match?" in one pass with no
+// Python allocation, so the common clean-evidence case skips the Python
+// regex machinery entirely; on a hit the Python pattern stays authoritative.
+// They are only sound for the default patterns -- the caller must fall back
+// to the regexes whenever custom patterns are configured.
+bool
+has_sensitive_name_candidate(std::string_view text);
+
+bool
+has_sensitive_value_candidate(std::string_view text);
+
+py::module
+pyexport_m_evidence_redaction(py::module& m);
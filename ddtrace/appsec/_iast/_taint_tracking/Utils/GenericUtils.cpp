@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 
 #include "GenericUtils.h"
@@ -29,14 +30,43 @@ asbool(const char* value)
     if (value == nullptr) {
         return false;
     }
-    const py::object debug_value_py = py::str(value);
-    return asbool(debug_value_py);
+    // Plain C++ on purpose: the settings snapshot below runs this and must
+    // not construct Python objects just to parse an environment flag
+    std::string str_value(value);
+    std::transform(str_value.begin(), str_value.end(), str_value.begin(), ::tolower);
+    return str_value == "true" || str_value == "1";
 }
 
+namespace NativeSettings {
+
+// Snapshot of the settings the native error/telemetry paths consult. These
+// values change at most once per process, so they are read into atomics at
+// module init (and on explicit refresh) instead of crossing into Python, or
+// even getenv, every time an error path asks whether to log.
+static std::atomic<bool> iast_debug{ false };
+
+void
+refresh()
+{
+    iast_debug.store(asbool(std::getenv("_DD_IAST_DEBUG")), std::memory_order_relaxed);
+}
+
+bool
+debug_enabled()
+{
+    return iast_debug.load(std::memory_order_relaxed);
+}
+
+} // namespace NativeSettings
+
 void
 iast_taint_log_error(const std::string& msg)
 {
-    safe_import("ddtrace.appsec._iast._metrics", "_set_iast_error_metric")("[IAST] Propagation error. " + msg);
+    // Resolved once and leaked: the metric hook lives at a fixed location
+    // and the error path shouldn't pay the import machinery on every report
+    static PyObject* const set_error_metric =
+      safe_import("ddtrace.appsec._iast._metrics", "_set_iast_error_metric").release().ptr();
+    py::reinterpret_borrow<py::object>(set_error_metric)("[IAST] Propagation error. " + msg);
     try {
         if (!is_iast_debug_enabled()) {
             return;
@@ -12,17 +12,24 @@ asbool(const py::object&);
 bool
 asbool(const char*);
 
+namespace NativeSettings {
+// Re-reads the snapshotted settings from the environment. Called at module
+// init and exported as _native.refresh_native_settings for tests and for
+// the rare process that flips flags after startup.
+void
+refresh();
+
+bool
+debug_enabled();
+} // namespace NativeSettings
+
 void
 iast_taint_log_error(const std::string&);
 
 inline bool
 is_iast_debug_enabled()
 {
-    const char* debug_value = std::getenv("_DD_IAST_DEBUG");
-    if (debug_value == nullptr) {
-        return false;
-    }
-    return asbool(debug_value);
+    return NativeSettings::debug_enabled();
 }
 
 inline py::object
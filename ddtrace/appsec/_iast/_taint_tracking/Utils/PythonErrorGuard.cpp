@@ -31,12 +31,25 @@ PythonErrorGuard::PythonErrorGuard()
 {
     py::gil_scoped_acquire acquire;
 
+    // No pending error (the usual case): nothing to fetch, clear or restore
+    if (PyErr_Occurred() == nullptr) {
+        return;
+    }
+
     PyErr_Fetch(&ptype, &pvalue, &ptraceback);
     had_exception = (ptype != nullptr || pvalue != nullptr || ptraceback != nullptr);
-    if (had_exception) {
+    PyErr_Clear();
+}
+
+void
+PythonErrorGuard::normalize_if_needed() const
+{
+    // Normalization (exception instantiation) is only needed to format the
+    // error, so it is deferred until an accessor actually asks for it
+    if (not normalized) {
         PyErr_NormalizeException(&ptype, &pvalue, &ptraceback);
+        normalized = true;
     }
-    PyErr_Clear();
 }
 
 PythonErrorGuard::~PythonErrorGuard()
@@ -50,6 +63,7 @@ PythonErrorGuard::error_as_pystr() const
     if (not had_exception) {
         return {};
     }
+    normalize_if_needed();
 
     const auto pyo = PyObject_Str(pvalue);
     if (pyo == nullptr) {
@@ -64,7 +78,6 @@ PythonErrorGuard::error_as_stdstring() const
     if (not had_exception) {
         return {};
     }
-    auto pystr = error_as_pystr();
     return error_as_pystr().cast<std::string>();
 }
 
@@ -74,8 +87,8 @@ PythonErrorGuard::traceback_as_pystr() const
     if (not had_exception or ptraceback == nullptr) {
         return {};
     }
+    normalize_if_needed();
 
-    auto res = format_traceback(ptraceback, ptype, pvalue);
     return format_traceback(ptraceback, ptype, pvalue);
 }
 
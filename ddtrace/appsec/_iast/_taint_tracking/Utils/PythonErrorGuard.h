@@ -20,7 +20,10 @@ class PythonErrorGuard
     /**
      * @brief Constructs the PythonErrorGuard.
      *
-     * Fetches any existing Python error, stores it, and clears the error state.
+     * When a Python error is pending it is fetched, stored and cleared;
+     * normalization is deferred to the accessors. With no pending error
+     * (the usual case around every aspect) construction is a single
+     * PyErr_Occurred() check.
      */
     PythonErrorGuard();
 
@@ -46,10 +49,12 @@ class PythonErrorGuard
     [[nodiscard]] std::string traceback_as_stdstring() const;
 
   private:
-    PyObject* ptype;
-    PyObject* pvalue;
-    PyObject* ptraceback;
+    mutable PyObject* ptype;
+    mutable PyObject* pvalue;
+    mutable PyObject* ptraceback;
     bool had_exception;
+    mutable bool normalized{ false };
 
+    void normalize_if_needed() const;
     void restore_or_decref();
 };
\ No newline at end of file
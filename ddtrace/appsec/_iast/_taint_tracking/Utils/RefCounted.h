@@ -0,0 +1,142 @@
+#pragma once
+#include <Python.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#ifdef Py_GIL_DISABLED
+#include <atomic>
+#endif
+
+/**
+ * Intrusive refcount for the taint engine's internal shared objects.
+ *
+ * std::shared_ptr pays a lock-prefixed atomic read-modify-write on every
+ * copy and every destruction, but under the GIL those operations are already
+ * serialized -- and taint pointers are copied on every aspect, shift and map
+ * operation, so the synchronization is pure cost. RefCounted keeps a plain
+ * integer count on normal builds and compiles the atomic variant only for
+ * free-threaded CPython (Py_GIL_DISABLED), where the GIL guarantee is gone.
+ * Like CPython's own refcounting, the mode is fixed by the ABI the module is
+ * built against; a free-threaded interpreter cannot import a normal-build
+ * extension, so the non-atomic count can never run without the GIL.
+ *
+ * The derived class implements dispose() const, called when the count drops
+ * to zero: `delete this` for heap objects; arena-backed objects run only
+ * their destructor and let the arena reclaim the memory wholesale.
+ */
+template<typename Derived>
+class RefCounted
+{
+  public:
+    void incref() const noexcept
+    {
+#ifdef Py_GIL_DISABLED
+        count_.fetch_add(1, std::memory_order_relaxed);
+#else
+        ++count_;
+#endif
+    }
+
+    void decref() const
+    {
+#ifdef Py_GIL_DISABLED
+        if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+#else
+        if (--count_ == 0) {
+#endif
+            static_cast<const Derived*>(this)->dispose();
+        }
+    }
+
+  protected:
+    RefCounted() = default;
+    ~RefCounted() = default;
+    // The count tracks pointers to an object, not its contents: copies and
+    // assignments start/keep their own count
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+
+  private:
+#ifdef Py_GIL_DISABLED
+    mutable std::atomic<Py_ssize_t> count_{ 0 };
+#else
+    mutable Py_ssize_t count_{ 0 };
+#endif
+};
+
+/**
+ * Owning pointer to a RefCounted object, drop-in for the previous
+ * shared_ptr usage: copyable, movable, null-comparable. One raw pointer
+ * wide (no separate control block), so map entries and batch tuples also
+ * shrink by a word.
+ */
+template<typename T>
+class RcPtr
+{
+  public:
+    constexpr RcPtr() noexcept = default;
+    constexpr RcPtr(std::nullptr_t) noexcept {}
+
+    explicit RcPtr(T* ptr) noexcept
+      : ptr_(ptr)
+    {
+        if (ptr_) {
+            ptr_->incref();
+        }
+    }
+
+    RcPtr(const RcPtr& other) noexcept
+      : ptr_(other.ptr_)
+    {
+        if (ptr_) {
+            ptr_->incref();
+        }
+    }
+
+    RcPtr(RcPtr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr))
+    {
+    }
+
+    ~RcPtr()
+    {
+        if (ptr_) {
+            ptr_->decref();
+        }
+    }
+
+    // Copy-and-swap covers copy assignment, move assignment and nullptr
+    RcPtr& operator=(RcPtr other) noexcept
+    {
+        std::swap(ptr_, other.ptr_);
+        return *this;
+    }
+
+    void reset() noexcept { RcPtr().swap(*this); }
+
+    void swap(RcPtr& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+    [[nodiscard]] T* get() const noexcept { return ptr_; }
+    T& operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    bool operator==(const RcPtr& other) const noexcept { return ptr_ == other.ptr_; }
+    bool operator!=(const RcPtr& other) const noexcept { return ptr_ != other.ptr_; }
+    bool operator==(std::nullptr_t) const noexcept { return ptr_ == nullptr; }
+    bool operator!=(std::nullptr_t) const noexcept { return ptr_ != nullptr; }
+
+  private:
+    T* ptr_{ nullptr };
+};
+
+// make_shared analogue; `new const T` is fine, so RcPtr<const Source> and
+// friends construct directly
+template<typename T, typename... Args>
+RcPtr<T>
+make_refcounted(Args&&... args)
+{
+    return RcPtr<T>(new std::remove_const_t<T>(std::forward<Args>(args)...));
+}
@@ -0,0 +1,271 @@
+#pragma once
+#include <pybind11/stl.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+/**
+ * Small-size-optimized vector used for TaintRangeRefs.
+ *
+ * Most tainted strings carry only one or two ranges, so the first N elements
+ * live inline in the object itself and the common case performs zero heap
+ * allocations. Only when a string accumulates more than N ranges does the
+ * storage spill to the heap, with the usual geometric growth.
+ */
+template<typename T, size_t N>
+class SmallVector
+{
+  public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // User-provided (not defaulted) so that const-qualified default
+    // construction is well-formed despite the uninitialized inline storage.
+    SmallVector() {}
+
+    SmallVector(std::initializer_list<T> init)
+    {
+        reserve(init.size());
+        for (const auto& item : init) {
+            push_back(item);
+        }
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; i++) {
+            new (data_ + i) T(other.data_[i]);
+        }
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept { take_contents(other); }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; i++) {
+                new (data_ + i) T(other.data_[i]);
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other) {
+            destroy_storage();
+            data_ = inline_data();
+            capacity_ = N;
+            size_ = 0;
+            take_contents(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { destroy_storage(); }
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    [[nodiscard]] const_iterator begin() const { return data_; }
+    [[nodiscard]] const_iterator end() const { return data_ + size_; }
+
+    T& operator[](const size_t pos) { return data_[pos]; }
+    const T& operator[](const size_t pos) const { return data_[pos]; }
+
+    T& at(const size_t pos)
+    {
+        if (pos >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[pos];
+    }
+
+    [[nodiscard]] const T& at(const size_t pos) const
+    {
+        if (pos >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[pos];
+    }
+
+    T& front() { return data_[0]; }
+    [[nodiscard]] const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    [[nodiscard]] const T& back() const { return data_[size_ - 1]; }
+
+    void reserve(const size_t new_capacity)
+    {
+        if (new_capacity > capacity_) {
+            grow(new_capacity);
+        }
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < size_; i++) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    void push_back(const T& value)
+    {
+        grow_if_full();
+        new (data_ + size_) T(value);
+        size_++;
+    }
+
+    void push_back(T&& value)
+    {
+        grow_if_full();
+        new (data_ + size_) T(std::move(value));
+        size_++;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        grow_if_full();
+        T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+        return *slot;
+    }
+
+    void pop_back()
+    {
+        size_--;
+        data_[size_].~T();
+    }
+
+    template<typename InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_t idx = pos - data_;
+        const size_t count = std::distance(first, last);
+        if (count == 0) {
+            return data_ + idx;
+        }
+        reserve(size_ + count);
+        // Shift the tail right, back to front, to open the gap
+        for (size_t i = size_; i > idx; i--) {
+            new (data_ + i + count - 1) T(std::move(data_[i - 1]));
+            data_[i - 1].~T();
+        }
+        size_t i = idx;
+        for (auto it = first; it != last; ++it, i++) {
+            new (data_ + i) T(*it);
+        }
+        size_ += count;
+        return data_ + idx;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        const size_t idx = pos - data_;
+        for (size_t i = idx; i + 1 < size_; i++) {
+            data_[i] = std::move(data_[i + 1]);
+        }
+        pop_back();
+        return data_ + idx;
+    }
+
+    bool operator==(const SmallVector& other) const
+    {
+        if (size_ != other.size_) {
+            return false;
+        }
+        for (size_t i = 0; i < size_; i++) {
+            if (not(data_[i] == other.data_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const SmallVector& other) const { return not(*this == other); }
+
+  private:
+    T* inline_data() { return reinterpret_cast<T*>(inline_storage_); }
+
+    [[nodiscard]] bool is_inline() const { return capacity_ == N; }
+
+    void grow_if_full()
+    {
+        if (size_ == capacity_) {
+            grow(capacity_ * 2);
+        }
+    }
+
+    void grow(const size_t new_capacity)
+    {
+        T* new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+        for (size_t i = 0; i < size_; i++) {
+            new (new_data + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        if (not is_inline()) {
+            ::operator delete(data_);
+        }
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    // Destroys the elements and frees any heap block, leaving the object in an
+    // unusable state; callers must re-point data_ at the inline storage after.
+    void destroy_storage()
+    {
+        clear();
+        if (not is_inline()) {
+            ::operator delete(data_);
+        }
+    }
+
+    // Steal the heap block (or move the inline elements) out of other,
+    // assuming our own storage is empty and inline.
+    void take_contents(SmallVector& other) noexcept
+    {
+        if (other.is_inline()) {
+            for (size_t i = 0; i < other.size_; i++) {
+                new (data_ + i) T(std::move(other.data_[i]));
+                other.data_[i].~T();
+            }
+            size_ = other.size_;
+            other.size_ = 0;
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.data_ = other.inline_data();
+            other.capacity_ = N;
+            other.size_ = 0;
+        }
+    }
+
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    T* data_ = inline_data();
+    alignas(T) unsigned char inline_storage_[N * sizeof(T)];
+};
+
+namespace pybind11 {
+namespace detail {
+// Convert to/from Python lists the same way stl.h does for std::vector
+template<typename Type, size_t N>
+struct type_caster<SmallVector<Type, N>> : list_caster<SmallVector<Type, N>, Type>
+{
+};
+} // namespace detail
+} // namespace pybind11
@@ -57,6 +57,53 @@ set_fast_tainted_if_notinterned_unicode(PyObject* objptr)
     }
 }
 
+// Bytes and bytearrays have no spare bits to hide a mark in, so the
+// equivalent of the unicode fast-taint mark is a side table: a small
+// direct-mapped array of address-derived tags, written whenever a
+// bytes-like object enters the taint map. A missing tag means "definitely
+// never tainted" (writes always mark); a matching tag falls through to the
+// map probe, so collisions and stale marks from freed objects only cost the
+// probe they would have cost without the table. GIL-guarded like the marks.
+static uint8_t fast_tainted_bytes_marks[1 << 16];
+
+static inline size_t
+bytes_mark_slot(const uintptr_t obj_id)
+{
+    return (obj_id >> 4) & ((1 << 16) - 1);
+}
+
+static inline uint8_t
+bytes_mark_tag(const uintptr_t obj_id)
+{
+    // Tag from higher address bits, never zero (zero means empty slot)
+    return static_cast<uint8_t>((obj_id >> 20) | 0x01);
+}
+
+__attribute__((flatten)) bool
+is_notfasttainted_bytes(const PyObject* objptr)
+{
+    if (!objptr) {
+        return true; // cannot taint a nullptr
+    }
+
+    if (!PyBytes_Check(objptr) and !PyByteArray_Check(objptr)) {
+        return false; // not bytes-like, continue evaluation
+    }
+
+    const auto obj_id = get_unique_id(objptr);
+    return fast_tainted_bytes_marks[bytes_mark_slot(obj_id)] != bytes_mark_tag(obj_id);
+}
+
+__attribute__((flatten)) void
+set_fast_tainted_if_bytes(PyObject* objptr)
+{
+    if (not objptr or (!PyBytes_Check(objptr) and !PyByteArray_Check(objptr))) {
+        return;
+    }
+    const auto obj_id = get_unique_id(objptr);
+    fast_tainted_bytes_marks[bytes_mark_slot(obj_id)] = bytes_mark_tag(obj_id);
+}
+
 string
 AnyTextObjectToString(PyObject* py_string_like)
 {
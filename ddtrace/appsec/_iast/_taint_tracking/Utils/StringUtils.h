@@ -44,6 +44,12 @@ is_notinterned_notfasttainted_unicode(const PyObject* objptr);
 void
 set_fast_tainted_if_notinterned_unicode(PyObject* objptr);
 
+bool
+is_notfasttainted_bytes(const PyObject* objptr);
+
+void
+set_fast_tainted_if_bytes(PyObject* objptr);
+
 inline bool
 is_text(const PyObject* pyptr)
 {
@@ -21,12 +21,21 @@ log = get_logger(__name__)
 
 if _is_python_version_supported():
     from ._native import ops
+    from ._native.aspect_encodings import _remap_ranges_decoded
+    from ._native.aspect_encodings import _remap_ranges_encoded
     from ._native.aspect_format import _format_aspect
     from ._native.aspect_helpers import _convert_escaped_text_to_tainted_text
     from ._native.aspect_helpers import as_formatted_evidence
     from ._native.aspect_helpers import common_replace
     from ._native.aspect_helpers import parse_params
     from ._native.aspect_helpers import set_ranges_on_splitted
+    from ._native.aspect_json import _json_taint_loads
+    from ._native.aspect_pathlib import _pathlib_taint_joined
+    from ._native.aspect_pathlib import _pathlib_taint_part
+    from ._native.aspect_regex import _re_taint_groups
+    from ._native.aspect_regex import _re_taint_span
+    from ._native.aspect_regex import _re_taint_sub
+    from ._native.aspect_replace import _aspect_replace
     from ._native.aspect_split import _aspect_rsplit
     from ._native.aspect_split import _aspect_split
     from ._native.aspect_split import _aspect_splitlines
@@ -65,6 +74,7 @@ if _is_python_version_supported():
 
     new_pyobject_id = ops.new_pyobject_id
     set_ranges_from_values = ops.set_ranges_from_values
+    _taint_pyobject_batch = ops.taint_pyobject_batch
 
 __all__ = [
     "OriginType",
@@ -80,12 +90,21 @@ __all__ = [
     "_aspect_ospathsplitdrive",
     "_aspect_ospathsplitext",
     "_aspect_ospathsplitroot",
+    "_aspect_replace",
     "_aspect_rsplit",
     "_aspect_split",
     "_aspect_splitlines",
     "_aspect_str",
     "_convert_escaped_text_to_tainted_text",
     "_format_aspect",
+    "_json_taint_loads",
+    "_pathlib_taint_joined",
+    "_pathlib_taint_part",
+    "_re_taint_groups",
+    "_re_taint_span",
+    "_re_taint_sub",
+    "_remap_ranges_decoded",
+    "_remap_ranges_encoded",
     "active_map_addreses_size",
     "are_all_text_all_ranges",
     "as_formatted_evidence",
@@ -116,6 +135,7 @@ __all__ = [
     "shift_taint_ranges",
     "str_to_origin",
     "taint_pyobject",
+    "taint_pyobject_batch",
 ]
 
 
@@ -187,6 +207,29 @@ def taint_pyobject(pyobject: Any, source_name: Any, source_value: Any, source_or
     return pyobject
 
 
+def taint_pyobject_batch(pyobjects: list, source_names: list, source_values: list, source_origin=None) -> list:
+    """Taint a whole group of source objects in one native call.
+
+    Parallel lists of objects, source names and source values go through a
+    single reserved taint-map pass, instead of one map transaction and one
+    Source construction per object as taint_pyobject does. source_origin may
+    be one OriginType for the whole batch or a parallel list. Objects that
+    can't be tainted are returned unchanged in their slot.
+    """
+    if not is_iast_request_enabled():
+        return list(pyobjects)
+    try:
+        if source_origin is None:
+            source_origin = OriginType.PARAMETER
+
+        res = _taint_pyobject_batch(list(pyobjects), list(source_names), list(source_values), source_origin)
+        _set_metric_iast_executed_source(source_origin if isinstance(source_origin, OriginType) else source_origin[0])
+        return res
+    except ValueError as e:
+        log.debug("Tainting object batch error: %s", e)
+    return list(pyobjects)
+
+
 def taint_pyobject_with_ranges(pyobject: Any, ranges: Tuple) -> bool:
     if not is_iast_request_enabled():
         return False
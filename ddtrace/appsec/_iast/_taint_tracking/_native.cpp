@@ -6,6 +6,8 @@
  * - Taint ranges: Information related to tainted values.
  */
 #include <memory>
+#include <string_view>
+
 #include <pybind11/pybind11.h>
 
 #include "Aspects/AspectExtend.h"
@@ -20,6 +22,7 @@
 #include "Initializer/_initializer.h"
 #include "TaintTracking/_taint_tracking.h"
 #include "TaintedOps/TaintedOps.h"
+#include "Utils/EvidenceRedaction.h"
 #include "Utils/GenericUtils.h"
 
 #define PY_MODULE_NAME_ASPECTS                                                                                         \
@@ -38,6 +41,7 @@ static PyMethodDef AspectsMethods[] = {
     { "join_aspect", ((PyCFunction)api_join_aspect), METH_FASTCALL, "aspect join" },
     { "slice_aspect", ((PyCFunction)api_slice_aspect), METH_FASTCALL, "aspect slice" },
     { "modulo_aspect", ((PyCFunction)api_modulo_aspect), METH_FASTCALL, "aspect modulo" },
+    { "build_string_aspect", ((PyCFunction)api_build_string_aspect), METH_FASTCALL, "aspect build_string" },
     { nullptr, nullptr, 0, nullptr }
 };
 
@@ -50,6 +54,7 @@ static struct PyModuleDef aspects = { PyModuleDef_HEAD_INIT,
 static PyMethodDef OpsMethods[] = {
     { "new_pyobject_id", (PyCFunction)api_new_pyobject_id, METH_FASTCALL, "new pyobject id" },
     { "set_ranges_from_values", ((PyCFunction)api_set_ranges_from_values), METH_FASTCALL, "set_ranges_from_values" },
+    { "taint_pyobject_batch", ((PyCFunction)api_taint_pyobject_batch), METH_FASTCALL, "taint_pyobject_batch" },
     { nullptr, nullptr, 0, nullptr }
 };
 
@@ -59,6 +64,67 @@ static struct PyModuleDef ops = { PyModuleDef_HEAD_INIT,
                                   .m_size = -1,
                                   .m_methods = OpsMethods };
 
+/* Deferred pyexport registration.  Building the pybind11 bindings (classes,
+ * function signatures, docstrings) dominates the import time of this module,
+ * and `import ddtrace` pulls it in even in processes where IAST never
+ * activates.  Only the aspect/ops method tables above -- what code patched by
+ * the aspects actually calls -- are registered eagerly.  Each pybind
+ * submodule is created as an empty shell up front (def_submodule also
+ * registers it in sys.modules, which the dotted imports in
+ * _taint_tracking/__init__.py rely on) and is populated on first attribute
+ * access through a PEP 562 module __getattr__.
+ */
+namespace {
+
+// One deferral per pyexport function; several shells share a group when a
+// single pyexport populates them all (the aspect submodules)
+struct DeferredExport
+{
+    void (*populate)(py::module&);
+    bool done{ false };
+};
+
+// Run the group's pyexport once.  The GIL serializes callers; `done` is set
+// before populating so a throwing pyexport surfaces once instead of retrying
+// on every access.
+void
+deferred_populate(py::module& root, const std::shared_ptr<DeferredExport>& group)
+{
+    if (!group->done) {
+        group->done = true;
+        group->populate(root);
+    }
+}
+
+// __getattr__ only runs after the regular lookup missed, which predates
+// population; answer from the (now populated) module dict directly, since a
+// getattr() here would recurse right back into this hook.
+py::object
+module_dict_lookup(const py::module& mod, const char* attr)
+{
+    PyObject* value = PyDict_GetItemString(PyModule_GetDict(mod.ptr()), attr);
+    if (value == nullptr) {
+        PyErr_Format(PyExc_AttributeError, "module '%s' has no attribute '%s'", PyModule_GetName(mod.ptr()), attr);
+        throw py::error_already_set();
+    }
+    return py::reinterpret_borrow<py::object>(value);
+}
+
+void
+defer_pyexport(py::module& m, const std::shared_ptr<DeferredExport>& group, std::initializer_list<const char*> names)
+{
+    for (const char* name : names) {
+        py::module shell = m.def_submodule(name);
+        shell.attr("__getattr__") = py::cpp_function([m, shell, group](const char* attr) -> py::object {
+            py::module root = m;
+            deferred_populate(root, group);
+            return module_dict_lookup(shell, attr);
+        });
+    }
+}
+
+} // namespace
+
 /**
  * This function initializes the native module.
  */
@@ -77,7 +143,14 @@ PYBIND11_MODULE(_native, m)
         }
     }
 
-    initializer = make_unique<Initializer>();
+    // Creates this interpreter's taint state: module init runs once per
+    // importing (sub)interpreter, so each one gets its own engine
+    initializer.create();
+
+    // Settings the native error/telemetry paths consult are snapshotted
+    // here so those paths never call back into Python (or getenv)
+    NativeSettings::refresh();
+    m.def("refresh_native_settings", &NativeSettings::refresh);
 
     // Create a atexit callback to cleanup the Initializer before the interpreter finishes
     auto atexit_register = safe_import("atexit", "register");
@@ -88,10 +161,47 @@ PYBIND11_MODULE(_native, m)
 
     m.doc() = "Native Python module";
 
-    py::module m_initializer = pyexport_m_initializer(m);
-    pyexport_m_taint_tracking(m);
+    // Shells now, bindings on first access; see DeferredExport above
+    defer_pyexport(
+      m, std::make_shared<DeferredExport>(DeferredExport{ [](py::module& root) { pyexport_m_initializer(root); } }), {
+          "initializer",
+      });
+    defer_pyexport(
+      m, std::make_shared<DeferredExport>(DeferredExport{ [](py::module& root) { pyexport_m_taint_tracking(root); } }), {
+          "taint_tracking",
+      });
+    defer_pyexport(
+      m,
+      std::make_shared<DeferredExport>(DeferredExport{ [](py::module& root) { pyexport_m_evidence_redaction(root); } }),
+      {
+          "redaction",
+      });
 
-    pyexport_m_aspect_helpers(m);
+    auto aspects_group =
+      std::make_shared<DeferredExport>(DeferredExport{ [](py::module& root) { pyexport_m_aspect_helpers(root); } });
+    defer_pyexport(m,
+                   aspects_group,
+                   {
+                     "aspect_helpers",
+                     "aspect_format",
+                     "aspects_ospath",
+                     "aspect_pathlib",
+                     "aspect_json",
+                     "aspect_encodings",
+                     "aspect_split",
+                     "aspect_regex",
+                     "aspect_replace",
+                   });
+
+    // pyexport_m_aspect_helpers also defines the top-level metrics(); route
+    // its first access through the same deferral
+    m.attr("__getattr__") = py::cpp_function([m, aspects_group](const char* attr) -> py::object {
+        if (std::string_view{ attr } == "metrics") {
+            py::module root = m;
+            deferred_populate(root, aspects_group);
+        }
+        return module_dict_lookup(m, attr);
+    });
 
     // Note: the order of these definitions matter. For example,
     // stacktrace_element definitions must be before the ones of the
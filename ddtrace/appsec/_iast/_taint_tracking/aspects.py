@@ -30,11 +30,17 @@ from .._taint_tracking import _aspect_ospathsplit
 from .._taint_tracking import _aspect_ospathsplitdrive
 from .._taint_tracking import _aspect_ospathsplitext
 from .._taint_tracking import _aspect_ospathsplitroot
+from .._taint_tracking import _aspect_replace
 from .._taint_tracking import _aspect_rsplit
 from .._taint_tracking import _aspect_split
 from .._taint_tracking import _aspect_splitlines
 from .._taint_tracking import _convert_escaped_text_to_tainted_text
 from .._taint_tracking import _format_aspect
+from .._taint_tracking import _re_taint_groups
+from .._taint_tracking import _re_taint_span
+from .._taint_tracking import _re_taint_sub
+from .._taint_tracking import _remap_ranges_decoded
+from .._taint_tracking import _remap_ranges_encoded
 from .._taint_tracking import are_all_text_all_ranges
 from .._taint_tracking import as_formatted_evidence
 from .._taint_tracking import common_replace
@@ -60,6 +66,7 @@ _extend_aspect = aspects.extend_aspect
 _join_aspect = aspects.join_aspect
 add_aspect = aspects.add_aspect
 add_inplace_aspect = aspects.add_inplace_aspect
+build_string_aspect = aspects.build_string_aspect
 index_aspect = aspects.index_aspect
 modulo_aspect = aspects.modulo_aspect
 ospathbasename_aspect = _aspect_ospathbasename
@@ -82,6 +89,7 @@ __all__ = [
     "_aspect_splitlines",
     "add_aspect",
     "add_inplace_aspect",
+    "build_string_aspect",
     "bytearray_aspect",
     "bytearray_extend_aspect",
     "bytes_aspect",
@@ -242,10 +250,6 @@ def bytearray_extend_aspect(orig_function: Optional[Callable], flag_added_args:
         return op1.extend(op2)
 
 
-def build_string_aspect(*args: List[Any]) -> TEXT_TYPES:
-    return join_aspect("".join, 1, "", args)
-
-
 def ljust_aspect(
     orig_function: Optional[Callable], flag_added_args: int, *args: Any, **kwargs: Any
 ) -> Union[TEXT_TYPES]:
@@ -551,6 +555,12 @@ def decode_aspect(
     if is_pyobject_tainted(self) and isinstance(self, bytes):
         try:
             codec = args[0] if args else "utf-8"
+            errors = args[1] if len(args) > 1 else kwargs.get("errors", "strict")
+            # Native offset transcoding covers the stateless 1:1 codecs and
+            # utf-8 under strict errors; anything it declines falls back to
+            # replaying the incremental codec
+            if isinstance(codec, str) and errors == "strict" and _remap_ranges_decoded(result, self, codec):
+                return result
             inc_dec = codecs.getincrementaldecoder(codec)(**kwargs)
             return incremental_translation(self, inc_dec, inc_dec.decode, "")
         except Exception as e:
@@ -574,6 +584,9 @@ def encode_aspect(
     if is_pyobject_tainted(self) and isinstance(self, str):
         try:
             codec = args[0] if args else "utf-8"
+            errors = args[1] if len(args) > 1 else kwargs.get("errors", "strict")
+            if isinstance(codec, str) and errors == "strict" and _remap_ranges_encoded(result, self, codec):
+                return result
             inc_enc = codecs.getincrementalencoder(codec)(**kwargs)
             return incremental_translation(self, inc_enc, inc_enc.encode, b"")
         except Exception as e:
@@ -834,6 +847,13 @@ def replace_aspect(
         if count < -1:
             count = -1
 
+        # Native fast path: one scan finds every replacement offset and remaps
+        # the ranges onto orig_result in a single pass; returns None for the
+        # shapes it doesn't cover (empty old_value, mixed text types)
+        aspect_result = _aspect_replace(candidate_text, old_value, new_value, count, orig_result)
+        if aspect_result is not None:
+            return aspect_result
+
         aspect_result = aspect_replace_api(candidate_text, old_value, new_value, count, orig_result)
 
         if aspect_result != orig_result:
@@ -1061,12 +1081,11 @@ def re_sub_aspect(
     if len(args) >= 2 and len(result):
         repl = args[0]
         string = args[1]
-        if is_pyobject_tainted(string):
-            # Taint result
-            copy_and_shift_ranges_from_strings(string, result, 0, len(result))
-        elif is_pyobject_tainted(repl):
-            # Taint result
-            copy_and_shift_ranges_from_strings(repl, result, 0, len(result))
+        try:
+            # Single native pass: probes string then repl and taints the result
+            result = _re_taint_sub(result, string, repl)
+        except Exception as e:
+            iast_taint_log_error("re_sub_aspect. {}".format(e))
 
     return result
 
@@ -1102,12 +1121,11 @@ def re_subn_aspect(
     if len(args) >= 2:
         repl = args[0]
         string = args[1]
-        if is_pyobject_tainted(string):
-            # Taint result
-            copy_and_shift_ranges_from_strings(string, new_string, 0, len(new_string))
-        elif is_pyobject_tainted(repl):
-            # Taint result
-            copy_and_shift_ranges_from_strings(repl, new_string, 0, len(new_string))
+        try:
+            # Single native pass: probes string then repl and taints the result
+            new_string = _re_taint_sub(new_string, string, repl)
+        except Exception as e:
+            iast_taint_log_error("re_subn_aspect. {}".format(e))
 
     return (new_string, number)
 
@@ -1203,7 +1221,9 @@ def re_groups_aspect(orig_function: Optional[Callable], flag_added_args: int, *a
         return result
 
     try:
-        return copy_ranges_to_iterable_with_strings(result, get_ranges(self))
+        # One native pass over Match.regs: each group gets the match's ranges
+        # clipped to its own span instead of the full-length copy
+        return _re_taint_groups(result, self, self)
     except Exception as e:
         iast_taint_log_error("re_groups_aspect. {}".format(e))
         return result
@@ -1225,10 +1245,13 @@ def re_group_aspect(orig_function: Optional[Callable], flag_added_args: int, *ar
         return result
 
     try:
+        # Span-precise: each group result carries the match's ranges clipped
+        # and rebased to its own span
         if isinstance(result, tuple):
-            result = copy_ranges_to_iterable_with_strings(result, get_ranges(self))
+            for group_id, element in zip(args, result):
+                _re_taint_span(element, self, *self.span(group_id))
         else:
-            result = copy_ranges_to_string(result, get_ranges(self))
+            result = _re_taint_span(result, self, *self.span(args[0] if args else 0))
     except Exception as e:
         iast_taint_log_error("re_group_aspect. {}".format(e))
 
@@ -0,0 +1,258 @@
+/**
+ * Microbenchmarks for the hot taint-tracking aspects (add, join, split,
+ * slice, format, modulo) across string sizes, range counts and taint
+ * densities, plus map-pressure scenarios with thousands of live tainted
+ * objects.
+ *
+ * Configure with -DNATIVE_BENCHMARKING=ON and run `make bench` from the
+ * build directory. Benchmarks run against an embedded interpreter with a
+ * fresh taint context per benchmark, so numbers are comparable across
+ * commits as long as the Python version matches.
+ */
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <pybind11/embed.h>
+
+#include <Aspects/AspectFormat.h>
+#include <Aspects/AspectJoin.h>
+#include <Aspects/AspectModulo.h>
+#include <Aspects/AspectOperatorAdd.h>
+#include <Aspects/AspectSlice.h>
+#include <Aspects/AspectSplit.h>
+#include <Initializer/Initializer.h>
+#include <TaintedOps/TaintedOps.h>
+
+namespace {
+
+/**
+ * Non-identifier content (dashes, bangs) so CPython doesn't intern the
+ * strings: interned literals short-circuit the fast-tainted checks and would
+ * make the benchmark unrepresentative of real request data.
+ */
+PyObject*
+make_text(const size_t length)
+{
+    std::string value;
+    value.reserve(length);
+    static const char pattern[] = "ab-cd!ef gh/";
+    while (value.size() < length) {
+        value.append(pattern, std::min(sizeof(pattern) - 1, length - value.size()));
+    }
+    return PyUnicode_FromStringAndSize(value.c_str(), static_cast<Py_ssize_t>(value.size()));
+}
+
+/**
+ * Taints text with num_ranges evenly spaced single-source ranges. No-op when
+ * num_ranges is 0 so the same benchmark covers the untainted fast path.
+ */
+void
+taint_text(PyObject* text, const size_t num_ranges)
+{
+    if (num_ranges == 0) {
+        return;
+    }
+    const auto tx_map = Initializer::get_tainting_map();
+    const auto length = static_cast<size_t>(PyUnicode_GET_LENGTH(text));
+    const Source source("bench-param!", "bench-value/", OriginType::PARAMETER);
+    TaintRangeRefs ranges;
+    const size_t stride = std::max<size_t>(1, length / num_ranges);
+    const size_t range_length = std::max<size_t>(1, stride / 2);
+    for (size_t i = 0; i < num_ranges and i * stride < length; ++i) {
+        ranges.emplace_back(*initializer->allocate_taint_range(static_cast<RANGE_START>(i * stride),
+                                                               static_cast<RANGE_LENGTH>(range_length),
+                                                               source));
+    }
+    set_ranges(text, ranges, tx_map);
+}
+
+/** Fresh taint context per benchmark so map pressure doesn't leak across. */
+struct ContextScope
+{
+    ContextScope() { initializer->create_context(); }
+    ~ContextScope() { initializer->reset_context(); }
+};
+
+/** Args: {string length, ranges per operand (0 = untainted fast path)}. */
+void
+BM_AddAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* left = make_text(static_cast<size_t>(state.range(0)));
+    PyObject* right = make_text(static_cast<size_t>(state.range(0)));
+    taint_text(left, static_cast<size_t>(state.range(1)));
+    taint_text(right, static_cast<size_t>(state.range(1)));
+    PyObject* args[] = { left, right };
+    for (auto _ : state) {
+        PyObject* result = api_add_aspect(nullptr, args, 2);
+        Py_DecRef(result);
+    }
+    Py_DecRef(left);
+    Py_DecRef(right);
+}
+BENCHMARK(BM_AddAspect)->Args({ 16, 0 })->Args({ 16, 2 })->Args({ 256, 0 })->Args({ 256, 4 })->Args({ 4096, 16 });
+
+/** Args: {number of joined items, taint density (every Nth item, 0 = none)}. */
+void
+BM_JoinAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* sep = PyUnicode_FromString("-/");
+    const auto num_items = static_cast<size_t>(state.range(0));
+    const auto tainted_every = static_cast<size_t>(state.range(1));
+    PyObject* items = PyList_New(static_cast<Py_ssize_t>(num_items));
+    for (size_t i = 0; i < num_items; ++i) {
+        PyObject* item = make_text(24);
+        if (tainted_every != 0 and i % tainted_every == 0) {
+            taint_text(item, 1);
+        }
+        PyList_SET_ITEM(items, static_cast<Py_ssize_t>(i), item);
+    }
+    PyObject* args[] = { sep, items };
+    for (auto _ : state) {
+        PyObject* result = api_join_aspect(nullptr, args, 2);
+        Py_DecRef(result);
+    }
+    Py_DecRef(sep);
+    Py_DecRef(items);
+}
+BENCHMARK(BM_JoinAspect)->Args({ 8, 0 })->Args({ 8, 2 })->Args({ 64, 0 })->Args({ 64, 4 })->Args({ 512, 8 });
+
+/** Args: {string length, range count}. Splits on the spaces in the pattern. */
+void
+BM_SplitAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* text = make_text(static_cast<size_t>(state.range(0)));
+    taint_text(text, static_cast<size_t>(state.range(1)));
+    PyObject* flag = PyLong_FromLong(0);
+    PyObject* sep = PyUnicode_FromString(" ");
+    PyObject* args[] = { Py_None, flag, text, sep };
+    for (auto _ : state) {
+        PyObject* result = api_split_aspect(nullptr, args, 4, nullptr);
+        Py_DecRef(result);
+    }
+    Py_DecRef(flag);
+    Py_DecRef(sep);
+    Py_DecRef(text);
+}
+BENCHMARK(BM_SplitAspect)->Args({ 64, 0 })->Args({ 64, 2 })->Args({ 1024, 8 })->Args({ 8192, 32 });
+
+/** Args: {string length, range count}. Slices the middle half of the text. */
+void
+BM_SliceAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* text = make_text(static_cast<size_t>(state.range(0)));
+    taint_text(text, static_cast<size_t>(state.range(1)));
+    PyObject* start = PyLong_FromLong(state.range(0) / 4);
+    PyObject* stop = PyLong_FromLong(3 * state.range(0) / 4);
+    PyObject* args[] = { text, start, stop };
+    for (auto _ : state) {
+        PyObject* result = api_slice_aspect(nullptr, args, 3);
+        Py_DecRef(result);
+    }
+    Py_DecRef(start);
+    Py_DecRef(stop);
+    Py_DecRef(text);
+}
+BENCHMARK(BM_SliceAspect)->Args({ 64, 0 })->Args({ 64, 2 })->Args({ 1024, 8 })->Args({ 8192, 64 });
+
+/** Args: {argument length, ranges per argument}. Two-placeholder format. */
+void
+BM_FormatAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* fmt = PyUnicode_FromString("pre-{}/mid-{}!post");
+    PyObject* empty_tuple = PyTuple_New(0);
+    PyObject* first = make_text(static_cast<size_t>(state.range(0)));
+    PyObject* second = make_text(static_cast<size_t>(state.range(0)));
+    taint_text(first, static_cast<size_t>(state.range(1)));
+    taint_text(second, static_cast<size_t>(state.range(1)));
+    PyObject* args[] = { fmt, empty_tuple, first, second };
+    for (auto _ : state) {
+        PyObject* result = api_format_aspect(nullptr, args, 4, nullptr);
+        Py_DecRef(result);
+    }
+    Py_DecRef(fmt);
+    Py_DecRef(empty_tuple);
+    Py_DecRef(first);
+    Py_DecRef(second);
+}
+BENCHMARK(BM_FormatAspect)->Args({ 16, 0 })->Args({ 16, 1 })->Args({ 256, 4 })->Args({ 4096, 16 });
+
+/** Args: {argument length, ranges per argument}. Two-%s modulo template. */
+void
+BM_ModuloAspect(benchmark::State& state)
+{
+    ContextScope ctx;
+    PyObject* fmt = PyUnicode_FromString("pre-%s/mid-%s!post");
+    PyObject* first = make_text(static_cast<size_t>(state.range(0)));
+    PyObject* second = make_text(static_cast<size_t>(state.range(0)));
+    taint_text(first, static_cast<size_t>(state.range(1)));
+    taint_text(second, static_cast<size_t>(state.range(1)));
+    PyObject* params = PyTuple_Pack(2, first, second);
+    PyObject* args[] = { fmt, params };
+    for (auto _ : state) {
+        PyObject* result = api_modulo_aspect(nullptr, args, 2);
+        Py_DecRef(result);
+    }
+    Py_DecRef(fmt);
+    Py_DecRef(params);
+    Py_DecRef(first);
+    Py_DecRef(second);
+}
+BENCHMARK(BM_ModuloAspect)->Args({ 16, 0 })->Args({ 16, 1 })->Args({ 256, 4 })->Args({ 4096, 16 });
+
+/**
+ * Args: {live tainted objects in the map}. Measures add on a tainted string
+ * while the map holds thousands of other entries, the shape of a request that
+ * taints most of a large parsed payload.
+ */
+void
+BM_AddAspectUnderMapPressure(benchmark::State& state)
+{
+    ContextScope ctx;
+    const auto live_objects = static_cast<size_t>(state.range(0));
+    std::vector<PyObject*> alive;
+    alive.reserve(live_objects);
+    for (size_t i = 0; i < live_objects; ++i) {
+        PyObject* filler = make_text(32 + i % 64);
+        taint_text(filler, 1);
+        alive.push_back(filler);
+    }
+    PyObject* left = make_text(64);
+    PyObject* right = make_text(64);
+    taint_text(left, 2);
+    PyObject* args[] = { left, right };
+    for (auto _ : state) {
+        PyObject* result = api_add_aspect(nullptr, args, 2);
+        Py_DecRef(result);
+    }
+    Py_DecRef(left);
+    Py_DecRef(right);
+    for (PyObject* filler : alive) {
+        Py_DecRef(filler);
+    }
+}
+BENCHMARK(BM_AddAspectUnderMapPressure)->Arg(1000)->Arg(10000)->Arg(100000);
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    py::scoped_interpreter guard{};
+    initializer.create();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    initializer->reset_contexts();
+    initializer.reset();
+    return 0;
+}
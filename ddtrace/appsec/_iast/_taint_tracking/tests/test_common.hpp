@@ -18,8 +18,10 @@ class PyEnvWithContext : public ::testing::Test
   protected:
     void SetUp() override
     {
-        initializer = make_unique<Initializer>();
+        // The handle resolves per interpreter, so the interpreter must exist
+        // before any taint state is touched
         py::initialize_interpreter();
+        initializer.create();
         initializer->create_context();
     }
 
@@ -66,29 +68,29 @@ EXPECT_RANGESEQ(const TaintRangeRefs& r1, const TaintRangeRefs& r2)
 
     // Iterate over the ranges at r1 and check that they are the same as the range in the same position at r2
     for (size_t i = 0; i < r1.size(); i++) {
-        if (r1[i]->start != r2[i]->start) {
-            FAIL() << "Ranges have different start values at position " << i << ": " << r1[i]->start
-                   << " != " << r2[i]->start;
+        if (r1[i].start != r2[i].start) {
+            FAIL() << "Ranges have different start values at position " << i << ": " << r1[i].start
+                   << " != " << r2[i].start;
         }
 
-        if (r1[i]->length != r2[i]->length) {
-            FAIL() << "Ranges have different length values at position " << i << ": " << r1[i]->length
-                   << " != " << r2[i]->length;
+        if (r1[i].length != r2[i].length) {
+            FAIL() << "Ranges have different length values at position " << i << ": " << r1[i].length
+                   << " != " << r2[i].length;
         }
 
-        if (r1[i]->source.name != r2[i]->source.name) {
-            FAIL() << "Ranges have different source names at position " << i << ": " << r1[i]->source.name
-                   << " != " << r2[i]->source.name;
+        if (r1[i].source->name != r2[i].source->name) {
+            FAIL() << "Ranges have different source names at position " << i << ": " << r1[i].source->name
+                   << " != " << r2[i].source->name;
         }
 
-        if (r1[i]->source.value != r2[i]->source.value) {
-            FAIL() << "Ranges have different source values at position " << i << ": " << r1[i]->source.value
-                   << " != " << r2[i]->source.value;
+        if (r1[i].source->value != r2[i].source->value) {
+            FAIL() << "Ranges have different source values at position " << i << ": " << r1[i].source->value
+                   << " != " << r2[i].source->value;
         }
 
-        if (r1[i]->source.origin != r2[i]->source.origin) {
+        if (r1[i].source->origin != r2[i].source->origin) {
             FAIL() << "Ranges have different source origins at position " << i << ": "
-                   << origin_to_str(r1[i]->source.origin) << " != " << origin_to_str(r2[i]->source.origin);
+                   << origin_to_str(r1[i].source->origin) << " != " << origin_to_str(r2[i].source->origin);
         }
     }
 }
@@ -168,45 +168,39 @@ using GetDefaultContentCheck = ::testing::Test;
 
 TEST_F(GetDefaultContentCheck, HandlesEmptySourceName)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->source.name = "";
+    TaintRange taint_range;
+    taint_range.source = make_refcounted<const Source>("", "", OriginType::EMPTY);
     std::string expected_output = "";
     EXPECT_STREQ(get_default_content(taint_range).c_str(), expected_output.c_str());
 }
 
 TEST_F(GetDefaultContentCheck, HandlesNonEmptySourceName)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     std::string expected_output = "example";
     EXPECT_STREQ(get_default_content(taint_range).c_str(), expected_output.c_str());
 }
 
 TEST_F(GetDefaultContentCheck, HandlesSpecialCharactersInSourceName)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->source.name = "special!@#";
+    TaintRange taint_range;
+    taint_range.source = make_refcounted<const Source>("special!@#", "", OriginType::EMPTY);
     std::string expected_output = "special!@#";
     EXPECT_STREQ(get_default_content(taint_range).c_str(), expected_output.c_str());
 }
 
 using MapperReplaceCheck = PyEnvCheck;
 
-TEST_F(MapperReplaceCheck, HandlesNullTaintRange)
-{
-    optional<const py::dict> new_ranges = py::dict();
-    EXPECT_STREQ(mapper_replace(nullptr, new_ranges).c_str(), "");
-}
-
 TEST_F(MapperReplaceCheck, HandlesNullNewRanges)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
+    TaintRange taint_range;
     EXPECT_STREQ(mapper_replace(taint_range, nullopt).c_str(), "");
 }
 
 TEST_F(MapperReplaceCheck, HandlesNonExistingRange)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
+    TaintRange taint_range;
     optional<const py::dict> new_ranges = py::dict();
     EXPECT_STREQ(mapper_replace(taint_range, new_ranges).c_str(), "");
 }
@@ -214,20 +208,20 @@ TEST_F(MapperReplaceCheck, HandlesNonExistingRange)
 // FIXME: not working, check with Alberto
 TEST_F(MapperReplaceCheck, DISABLED_HandlesExistingRange)
 {
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 5;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 5;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
 
-    TaintRangePtr new_range = std::make_shared<TaintRange>();
-    new_range->start = 0;
-    new_range->length = 5;
-    new_range->source.name = "new_example";
+    TaintRange new_range;
+    new_range.start = 0;
+    new_range.length = 5;
+    new_range.source = make_refcounted<const Source>("new_example", "", OriginType::EMPTY);
 
     py::dict new_ranges;
     new_ranges[py::cast(taint_range)] = py::cast(new_range);
 
-    EXPECT_STREQ(mapper_replace(taint_range, new_ranges).c_str(), std::to_string(new_range->get_hash()).c_str());
+    EXPECT_STREQ(mapper_replace(taint_range, new_ranges).c_str(), std::to_string(new_range.get_hash()).c_str());
 }
 
 using GetNumTest = PyEnvCheck;
@@ -274,7 +268,7 @@ TEST_F(AsFormattedEvidenceCheckNoContext, NoTaintMapSameString)
 {
     const py::str text("This is a test string.");
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 4, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 4, source) };
     const py::str result = as_formatted_evidence(text, taint_ranges);
     EXPECT_STREQ(AnyTextObjectToString(result).c_str(), AnyTextObjectToString(text).c_str());
 }
@@ -291,7 +285,7 @@ TEST_F(AsFormattedEvidenceCheck, SingleTaintRangeWithNoMapper)
 {
     const std::string text = "This is a test string.";
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 4, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 4, source) };
     const std::string expected_result = "This :+-<source1>is a<source1>-+: test string."; // Expected tagged output
     const std::string result = as_formatted_evidence(text, taint_ranges, nullopt, nullopt);
     EXPECT_STREQ(result.c_str(), expected_result.c_str());
@@ -302,8 +296,8 @@ TEST_F(AsFormattedEvidenceCheck, MultipleTaintRangesWithNoMapper)
     const std::string text = "This is a test string.";
     Source source1("source1", "sample_value1", OriginType::BODY);
     Source source2("source2", "sample_value2", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source1),
-                                    std::make_shared<TaintRange>(10, 4, source2) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source1),
+                                    TaintRange(10, 4, source2) };
     const std::string expected_result = "This :+-<source1>is<source1>-+: a :+-<source2>test<source2>-+: string.";
     const std::string result = as_formatted_evidence(text, taint_ranges, nullopt, nullopt);
     EXPECT_STREQ(result.c_str(), expected_result.c_str());
@@ -313,9 +307,9 @@ TEST_F(AsFormattedEvidenceCheck, DefaultTagMappingModeIsMapper)
 {
     const std::string text = "This is a test string.";
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source) };
 
-    auto taint_range_1_hash = taint_ranges[0]->get_hash();
+    auto taint_range_1_hash = taint_ranges[0].get_hash();
     const std::string expected_result = "This :+-<" + std::to_string(taint_range_1_hash) + ">is<" +
                                         std::to_string(taint_range_1_hash) + ">-+: a test string.";
     const std::string result = as_formatted_evidence(text, taint_ranges);
@@ -328,12 +322,12 @@ TEST_F(AsFormattedEvidenceCheck, MultipleRangesWithMapper)
     Source source1("source1", "sample_value", OriginType::BODY);
     Source source2("source2", "sample_value", OriginType::PARAMETER);
     TaintRangeRefs taint_ranges = {
-        std::make_shared<TaintRange>(5, 2, source1),
-        std::make_shared<TaintRange>(10, 4, source2),
+        TaintRange(5, 2, source1),
+        TaintRange(10, 4, source2),
     };
 
-    auto taint_range_1_hash = taint_ranges[0]->get_hash();
-    auto taint_range_2_hash = taint_ranges[1]->get_hash();
+    auto taint_range_1_hash = taint_ranges[0].get_hash();
+    auto taint_range_2_hash = taint_ranges[1].get_hash();
     const std::string expected_result =
       "This :+-<" + std::to_string(taint_range_1_hash) + ">is<" + std::to_string(taint_range_1_hash) + ">-+: a :+-<" +
       std::to_string(taint_range_2_hash) + ">test<" + std::to_string(taint_range_2_hash) + ">-+: string.";
@@ -346,7 +340,7 @@ TEST_F(AsFormattedEvidenceCheck, DISABLED_SingleTaintRangeWithMapperReplace)
 {
     const std::string text = "This is a test string.";
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source) };
 
     py::dict new_ranges;
     TaintRange new_range(5, 2, Source("new_source", "sample_value", OriginType::BODY));
@@ -361,7 +355,7 @@ TEST_F(AsFormattedEvidenceCheck, EmptyTextWithTaintRanges)
 {
     const std::string text;
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(0, 1, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(0, 1, source) };
     const std::string expected_result;
     const std::string result = as_formatted_evidence(text, taint_ranges, nullopt, nullopt);
     EXPECT_STREQ(result.c_str(), expected_result.c_str());
@@ -388,7 +382,7 @@ TEST_F(AllAsFormattedEvidenceCheck, SingleTaintRangeWithNormalMapper)
 {
     py::str text("This is a test string.");
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source) };
     api_set_ranges(text, taint_ranges);
 
     const py::str expected_result("This :+-<source1>is<source1>-+: a test string.");
@@ -401,10 +395,10 @@ TEST_F(AllAsFormattedEvidenceCheck, SingleTaintRangeWithMapper)
 {
     py::str text("This is a test string.");
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source) };
     api_set_ranges(text, taint_ranges);
 
-    auto taint_range_1_hash = taint_ranges[0]->get_hash();
+    auto taint_range_1_hash = taint_ranges[0].get_hash();
     const py::str expected_result("This :+-<" + std::to_string(taint_range_1_hash) + ">is<" +
                                   std::to_string(taint_range_1_hash) + ">-+: a test string.");
     const py::str result = all_as_formatted_evidence(text, TagMappingMode::Mapper);
@@ -417,7 +411,7 @@ TEST_F(AllAsFormattedEvidenceCheck, DISABLED_SingleTaintRangeWithMapperReplace)
 {
     py::str text("This is a test string.");
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs taint_ranges = { std::make_shared<TaintRange>(5, 2, source) };
+    TaintRangeRefs taint_ranges = { TaintRange(5, 2, source) };
     api_set_ranges(text, taint_ranges);
 
     py::dict new_ranges;
@@ -568,7 +562,7 @@ TEST_F(SetRangesOnSplittedCheck, SingleSplitWithoutSeparator)
     split_result.append(py::str("is a test string."));
 
     Source source("source1", "sample_value", OriginType::BODY);
-    TaintRangeRefs source_ranges = { std::make_shared<TaintRange>(0, 4, source) };
+    TaintRangeRefs source_ranges = { TaintRange(0, 4, source) };
     api_set_ranges(source_str, source_ranges);
     auto tx_map = Initializer::get_tainting_map();
     bool result = set_ranges_on_splitted(source_str, source_ranges, split_result, tx_map, false);
@@ -577,8 +571,8 @@ TEST_F(SetRangesOnSplittedCheck, SingleSplitWithoutSeparator)
     auto first = split_result[0];
     auto first_ranges = get_ranges(first.ptr(), tx_map);
     EXPECT_EQ(first_ranges.first.size(), 1);
-    EXPECT_EQ(first_ranges.first[0]->start, 0);
-    EXPECT_EQ(first_ranges.first[0]->length, 4);
+    EXPECT_EQ(first_ranges.first[0].start, 0);
+    EXPECT_EQ(first_ranges.first[0].length, 4);
 
     auto last = split_result[1];
     auto last_ranges = get_ranges(last.ptr(), tx_map);
@@ -598,8 +592,8 @@ TEST_F(SetRangesOnSplittedCheck, MultipleSplitsNoSeparator)
     Source source1("source1", "sample_value1", OriginType::BODY);
     Source source2("source2", "sample_value2", OriginType::BODY);
     TaintRangeRefs source_ranges = {
-        std::make_shared<TaintRange>(0, 4, source1), // Taint "This"
-        std::make_shared<TaintRange>(10, 4, source2) // Taint "test"
+        TaintRange(0, 4, source1), // Taint "This"
+        TaintRange(10, 4, source2) // Taint "test"
     };
     api_set_ranges(source_str, source_ranges);
     auto tx_map = Initializer::get_tainting_map();
@@ -611,15 +605,15 @@ TEST_F(SetRangesOnSplittedCheck, MultipleSplitsNoSeparator)
     auto first = split_result[0];
     auto first_ranges = get_ranges(first.ptr(), tx_map);
     EXPECT_EQ(first_ranges.first.size(), 1);
-    EXPECT_EQ(first_ranges.first[0]->start, 0);
-    EXPECT_EQ(first_ranges.first[0]->length, 4);
+    EXPECT_EQ(first_ranges.first[0].start, 0);
+    EXPECT_EQ(first_ranges.first[0].length, 4);
 
     // Check middle split part "test"
     auto test_part = split_result[3];
     auto test_ranges = get_ranges(test_part.ptr(), tx_map);
     EXPECT_EQ(test_ranges.first.size(), 1);
-    EXPECT_EQ(test_ranges.first[0]->start, 0); // Position within "test"
-    EXPECT_EQ(test_ranges.first[0]->length, 4);
+    EXPECT_EQ(test_ranges.first[0].start, 0); // Position within "test"
+    EXPECT_EQ(test_ranges.first[0].length, 4);
 
     // Check that other parts have no ranges
     for (int i : { 1, 2, 4 }) {
@@ -642,8 +636,8 @@ TEST_F(SetRangesOnSplittedCheck, SplitWithSeparatorIncluded)
     Source source1("source1", "sample_value1", OriginType::BODY);
     Source source2("source2", "sample_value2", OriginType::BODY);
     TaintRangeRefs source_ranges = {
-        std::make_shared<TaintRange>(0, 4, source1), // Taint "This"
-        std::make_shared<TaintRange>(10, 4, source2) // Taint "test"
+        TaintRange(0, 4, source1), // Taint "This"
+        TaintRange(10, 4, source2) // Taint "test"
     };
     api_set_ranges(source_str, source_ranges);
     auto tx_map = Initializer::get_tainting_map();
@@ -655,15 +649,15 @@ TEST_F(SetRangesOnSplittedCheck, SplitWithSeparatorIncluded)
     auto first = split_result[0];
     auto first_ranges = get_ranges(first.ptr(), tx_map);
     EXPECT_EQ(first_ranges.first.size(), 1);
-    EXPECT_EQ(first_ranges.first[0]->start, 0);
-    EXPECT_EQ(first_ranges.first[0]->length, 4);
+    EXPECT_EQ(first_ranges.first[0].start, 0);
+    EXPECT_EQ(first_ranges.first[0].length, 4);
 
     // Check middle split part "test"
     auto test_part = split_result[3];
     auto test_ranges = get_ranges(test_part.ptr(), tx_map);
     EXPECT_EQ(test_ranges.first.size(), 1);
-    EXPECT_EQ(test_ranges.first[0]->start, 1); // Position within "test"
-    EXPECT_EQ(test_ranges.first[0]->length, 4);
+    EXPECT_EQ(test_ranges.first[0].start, 1); // Position within "test"
+    EXPECT_EQ(test_ranges.first[0].length, 4);
 
     // Check that other parts have no ranges
     for (int i : { 1, 2, 4 }) {
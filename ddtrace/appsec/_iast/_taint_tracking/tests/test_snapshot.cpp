@@ -0,0 +1,81 @@
+#include <Initializer/Initializer.h>
+#include <TaintTracking/TaintRange.h>
+#include <tests/test_common.hpp>
+
+using TaintContextSnapshotCheck = PyEnvWithContext;
+
+static void
+taint_test_object(PyObject* obj, const Source& source, const RANGE_START start, const RANGE_LENGTH length)
+{
+    // Writing caller-provided ranges: materialize the lazily created context
+    const auto tx_map = Initializer::get_or_create_tainting_map();
+    const auto tainted =
+      initializer->allocate_ranges_into_taint_object(TaintRangeRefs{ TaintRange(start, length, source) });
+    set_tainted_object(obj, tainted, tx_map);
+}
+
+TEST_F(TaintContextSnapshotCheck, fork_round_trip_restores_ranges)
+{
+    PyObject* text = this->StringToPyObjectStr("snapshot-text!");
+    const Source source("snap-name", "snap-value", OriginType::PARAMETER);
+    taint_test_object(text, source, 2, 5);
+
+    const py::bytes snapshot = Initializer::save_taint_context();
+
+    initializer->reset_context();
+    initializer->create_context();
+    EXPECT_TRUE(get_ranges(text, Initializer::get_tainting_map()).first.empty());
+
+    // No relocations: the saved identity keys are reused, fork semantics
+    EXPECT_EQ(Initializer::load_taint_context(snapshot, py::none()), 1u);
+    const auto ranges = get_ranges(text, Initializer::get_tainting_map()).first;
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].start, 2);
+    EXPECT_EQ(ranges[0].length, 5);
+    ASSERT_NE(ranges[0].source, nullptr);
+    EXPECT_EQ(ranges[0].source->name, "snap-name");
+    Py_DecRef(text);
+}
+
+TEST_F(TaintContextSnapshotCheck, relocation_rekeys_onto_live_objects)
+{
+    PyObject* original = this->StringToPyObjectStr("relocated-text!");
+    const Source source("reloc-name", "reloc-value", OriginType::BODY);
+    taint_test_object(original, source, 0, 3);
+
+    const py::bytes snapshot = Initializer::save_taint_context();
+
+    initializer->reset_context();
+    initializer->create_context();
+    PyObject* replacement = this->StringToPyObjectStr("relocated-text!?");
+    py::dict relocations;
+    relocations[py::int_(get_unique_id(original))] = py::reinterpret_borrow<py::object>(replacement);
+
+    EXPECT_EQ(Initializer::load_taint_context(snapshot, relocations), 1u);
+    // Only the relocated object is tainted, under its own identity key
+    EXPECT_TRUE(get_ranges(original, Initializer::get_tainting_map()).first.empty());
+    const auto ranges = get_ranges(replacement, Initializer::get_tainting_map()).first;
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].length, 3);
+    Py_DecRef(original);
+    Py_DecRef(replacement);
+}
+
+TEST_F(TaintContextSnapshotCheck, garbage_and_truncated_snapshots_are_rejected)
+{
+    EXPECT_THROW(Initializer::load_taint_context(py::bytes("not-a-snapshot!"), py::none()), py::value_error);
+
+    PyObject* text = this->StringToPyObjectStr("truncation-text!");
+    const Source source("trunc-name", "trunc-value", OriginType::PARAMETER);
+    taint_test_object(text, source, 1, 4);
+    const auto snapshot = static_cast<std::string>(Initializer::save_taint_context());
+    const py::bytes truncated(snapshot.substr(0, snapshot.size() - 3));
+    EXPECT_THROW(Initializer::load_taint_context(truncated, py::none()), py::value_error);
+    Py_DecRef(text);
+}
+
+TEST_F(TaintContextSnapshotCheck, empty_context_snapshot_loads_zero_entries)
+{
+    const py::bytes snapshot = Initializer::save_taint_context();
+    EXPECT_EQ(Initializer::load_taint_context(snapshot, py::none()), 0u);
+}
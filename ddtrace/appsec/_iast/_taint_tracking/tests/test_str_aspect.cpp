@@ -150,10 +150,10 @@ TEST_F(CheckAspectStr, StrWithTuple)
 TEST_F(CheckAspectStr, StrWithTaintedStringNoEncoding)
 {
     auto str = py::str("example");
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 7;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 7;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     api_set_ranges(str, TaintRangeRefs{ taint_range });
     auto ranges = api_get_ranges(str);
     EXPECT_EQ(ranges.size(), 1);
@@ -166,10 +166,10 @@ TEST_F(CheckAspectStr, StrWithTaintedStringNoEncoding)
 TEST_F(CheckAspectStr, StrWithTaintedBytesNoEncoding)
 {
     auto bytes = py::bytes("example");
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 7;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 7;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     api_set_ranges(bytes, TaintRangeRefs{ taint_range });
     auto ranges = api_get_ranges(bytes);
     EXPECT_EQ(ranges.size(), 1);
@@ -177,17 +177,17 @@ TEST_F(CheckAspectStr, StrWithTaintedBytesNoEncoding)
     EXPECT_STREQ(PyUnicode_AsUTF8(result), "b'example'");
     auto ranges2 = api_get_ranges(result);
     EXPECT_EQ(ranges2.size(), 1);
-    EXPECT_EQ(ranges2[0]->start, 0);
-    EXPECT_EQ(ranges2[0]->length, 10);
+    EXPECT_EQ(ranges2[0].start, 0);
+    EXPECT_EQ(ranges2[0].length, 10);
 }
 
 TEST_F(CheckAspectStr, StrWithTaintedByteArrayNoEncoding)
 {
     auto bytearray = py::bytearray("example");
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 7;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 7;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     api_set_ranges(bytearray, TaintRangeRefs{ taint_range });
     auto ranges = api_get_ranges(bytearray);
     EXPECT_EQ(ranges.size(), 1);
@@ -196,17 +196,17 @@ TEST_F(CheckAspectStr, StrWithTaintedByteArrayNoEncoding)
     EXPECT_STREQ(PyUnicode_AsUTF8(result), "bytearray(b'example')");
     auto ranges2 = api_get_ranges(result);
     EXPECT_EQ(ranges2.size(), 1);
-    EXPECT_EQ(ranges2[0]->start, 0);
-    EXPECT_EQ(ranges2[0]->length, 21);
+    EXPECT_EQ(ranges2[0].start, 0);
+    EXPECT_EQ(ranges2[0].length, 21);
 }
 
 TEST_F(CheckAspectStr, StrWithTaintedBytesAndEncodingSameSize)
 {
     auto bytes = py::bytes("example");
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 7;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 7;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     api_set_ranges(bytes, TaintRangeRefs{ taint_range });
     auto ranges = api_get_ranges(bytes);
     EXPECT_EQ(ranges.size(), 1);
@@ -229,10 +229,10 @@ TEST_F(CheckAspectStr, StrWithTaintedBytesAndEncodingDifferentSize)
         '\x65', '\x00'  // 'e'
     };
     auto bytes = py::bytes(utf16le_example, sizeof(utf16le_example));
-    TaintRangePtr taint_range = std::make_shared<TaintRange>();
-    taint_range->start = 0;
-    taint_range->length = 14;
-    taint_range->source.name = "example";
+    TaintRange taint_range;
+    taint_range.start = 0;
+    taint_range.length = 14;
+    taint_range.source = make_refcounted<const Source>("example", "", OriginType::EMPTY);
     api_set_ranges(bytes, TaintRangeRefs{ taint_range });
     auto ranges = api_get_ranges(bytes);
     EXPECT_EQ(ranges.size(), 1);
@@ -241,6 +241,6 @@ TEST_F(CheckAspectStr, StrWithTaintedBytesAndEncodingDifferentSize)
     EXPECT_STREQ(PyUnicode_AsUTF8(result), "example");
     auto ranges2 = api_get_ranges(result);
     EXPECT_EQ(ranges2.size(), 1);
-    EXPECT_EQ(ranges2[0]->start, 0);
-    EXPECT_EQ(ranges2[0]->length, 7);
+    EXPECT_EQ(ranges2[0].start, 0);
+    EXPECT_EQ(ranges2[0].length, 7);
 }
\ No newline at end of file
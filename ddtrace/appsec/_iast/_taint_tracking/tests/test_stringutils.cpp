@@ -160,6 +160,54 @@ TEST_F(SetFastTaintedCheck, NonInternedUnicodeWithHashMinusOneSetsHidden)
     Py_DECREF(non_interned_unicode);
 }
 
+using BytesFastTaintedCheck = PyEnvCheck;
+
+TEST_F(BytesFastTaintedCheck, NullptrReturnsTrue)
+{
+    EXPECT_TRUE(is_notfasttainted_bytes(nullptr));
+}
+
+TEST_F(BytesFastTaintedCheck, NonBytesReturnsFalse)
+{
+    PyObject* unicode_obj = PyUnicode_FromString("not bytes");
+    EXPECT_FALSE(is_notfasttainted_bytes(unicode_obj));
+    Py_DECREF(unicode_obj);
+}
+
+TEST_F(BytesFastTaintedCheck, UnmarkedBytesReturnsTrue)
+{
+    PyObject* bytes_obj = PyBytes_FromString("unmarked bytes");
+    EXPECT_TRUE(is_notfasttainted_bytes(bytes_obj));
+    Py_DECREF(bytes_obj);
+}
+
+TEST_F(BytesFastTaintedCheck, MarkedBytesReturnsFalse)
+{
+    PyObject* bytes_obj = PyBytes_FromString("marked bytes");
+    set_fast_tainted_if_bytes(bytes_obj);
+    EXPECT_FALSE(is_notfasttainted_bytes(bytes_obj));
+    Py_DECREF(bytes_obj);
+}
+
+TEST_F(BytesFastTaintedCheck, MarkedByteArrayReturnsFalse)
+{
+    PyObject* bytes_obj = PyBytes_FromString("marked bytearray");
+    PyObject* bytearray_obj = PyByteArray_FromObject(bytes_obj);
+    EXPECT_TRUE(is_notfasttainted_bytes(bytearray_obj));
+    set_fast_tainted_if_bytes(bytearray_obj);
+    EXPECT_FALSE(is_notfasttainted_bytes(bytearray_obj));
+    Py_DECREF(bytearray_obj);
+    Py_DECREF(bytes_obj);
+}
+
+TEST_F(BytesFastTaintedCheck, SetOnNonBytesDoesNothing)
+{
+    PyObject* non_bytes = PyLong_FromLong(42);
+    set_fast_tainted_if_bytes(non_bytes);
+    // No assertion needed, just ensure no crash
+    Py_DECREF(non_bytes);
+}
+
 using IsTextCheck = PyEnvCheck;
 
 TEST_F(IsTextCheck, NullptrReturnsFalse)
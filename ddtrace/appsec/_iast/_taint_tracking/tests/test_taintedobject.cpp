@@ -0,0 +1,59 @@
+#include <Initializer/Initializer.h>
+#include <TaintTracking/TaintedObject.h>
+#include <tests/test_common.hpp>
+
+using TaintedObjectCoalesceCheck = PyEnvWithContext;
+
+TEST_F(TaintedObjectCoalesceCheck, adjacent_same_source_ranges_are_merged)
+{
+    const Source source("name", "value", OriginType::PARAMETER);
+    const auto tainted = initializer->allocate_tainted_object();
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 3, source) }, 0);
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 4, source) }, 3);
+
+    const auto& ranges = tainted->get_ranges();
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].start, 0);
+    EXPECT_EQ(ranges[0].length, 7);
+}
+
+TEST_F(TaintedObjectCoalesceCheck, adjacent_different_source_ranges_are_kept)
+{
+    const Source source1("name1", "value1", OriginType::PARAMETER);
+    const Source source2("name2", "value2", OriginType::BODY);
+    const auto tainted = initializer->allocate_tainted_object();
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 3, source1) }, 0);
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 4, source2) }, 3);
+
+    const auto& ranges = tainted->get_ranges();
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0].length, 3);
+    EXPECT_EQ(ranges[1].start, 3);
+}
+
+TEST_F(TaintedObjectCoalesceCheck, non_touching_same_source_ranges_are_kept)
+{
+    const Source source("name", "value", OriginType::PARAMETER);
+    const auto tainted = initializer->allocate_tainted_object();
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 3, source) }, 0);
+    // One untainted character between the two ranges
+    tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 4, source) }, 4);
+
+    const auto& ranges = tainted->get_ranges();
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[1].start, 4);
+}
+
+TEST_F(TaintedObjectCoalesceCheck, repeated_appends_of_one_source_stay_one_range)
+{
+    const Source source("name", "value", OriginType::PARAMETER);
+    const auto tainted = initializer->allocate_tainted_object();
+    for (int i = 0; i < 200; i++) {
+        tainted->add_ranges_shifted(TaintRangeRefs{ TaintRange(0, 5, source) }, i * 5);
+    }
+
+    const auto& ranges = tainted->get_ranges();
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].start, 0);
+    EXPECT_EQ(ranges[0].length, 1000);
+}
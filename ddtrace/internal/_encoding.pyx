@@ -1,4 +1,5 @@
 from cpython cimport *
+from cpython.buffer cimport PyBuffer_FillInfo
 from cpython.bytearray cimport PyByteArray_CheckExact
 from libc cimport stdint
 from libc.string cimport strlen
@@ -27,10 +28,12 @@ from .constants import MAX_UINT_64BITS
 
 DEF MSGPACK_ARRAY_LENGTH_PREFIX_SIZE = 5
 DEF MSGPACK_STRING_TABLE_LENGTH_PREFIX_SIZE = 6
+DEF MSGPACK_TAG_BATCH_SIZE = 64
 
 
 cdef extern from "Python.h":
     const char* PyUnicode_AsUTF8(object o)
+    const char* PyUnicode_AsUTF8AndSize(object o, Py_ssize_t* size)
 
 cdef extern from "pack.h":
     struct msgpack_packer:
@@ -38,6 +41,8 @@ cdef extern from "pack.h":
         size_t length
         size_t buf_size
 
+    int msgpack_packer_init(msgpack_packer* pk, size_t min_size)
+    void msgpack_packer_destroy(msgpack_packer* pk)
     int msgpack_pack_nil(msgpack_packer* pk)
     int msgpack_pack_long(msgpack_packer* pk, long d)
     int msgpack_pack_long_long(msgpack_packer* pk, long long d)
@@ -56,6 +61,36 @@ cdef extern from "pack.h":
     int msgpack_pack_true(msgpack_packer* pk)
     int msgpack_pack_false(msgpack_packer* pk)
 
+    ctypedef struct msgpack_string_view:
+        const char* data
+        size_t length
+
+    int msgpack_pack_str_array(msgpack_packer* pk, const msgpack_string_view* views, size_t n)
+    int msgpack_pack_kv_uint64(msgpack_packer* pk, const char* key, size_t key_len, stdint.uint64_t d)
+
+    ctypedef struct msgpack_fragment:
+        size_t length
+        char bytes[40]
+
+    int msgpack_fragment_init_str(msgpack_fragment* f, const char* s, size_t l)
+    int msgpack_pack_fragment(msgpack_packer* pk, const msgpack_fragment* f)
+
+    int msgpack_pack_write(msgpack_packer* pk, const char* data, size_t l)
+
+    int json_pack_str(msgpack_packer* pk, PyObject* o)
+    int json_pack_ll(msgpack_packer* pk, long long v)
+    int json_pack_double(msgpack_packer* pk, double d)
+
+    ctypedef struct msgpack_strtable:
+        pass
+
+    int msgpack_strtable_init(msgpack_strtable* t)
+    void msgpack_strtable_clear(msgpack_strtable* t)
+    void msgpack_strtable_destroy(msgpack_strtable* t)
+    int msgpack_strtable_insert(msgpack_strtable* t, PyObject* key, stdint.uint32_t id)
+    int msgpack_strtable_pack(msgpack_strtable* t, msgpack_packer* pk, PyObject* key)
+    void msgpack_strtable_evict_from(msgpack_strtable* t, stdint.uint32_t first_id)
+
 
 cdef long long ITEM_LIMIT = (2**32)-1
 
@@ -85,6 +120,29 @@ cdef const char * _ORIGIN_KEY = string_to_buff(ORIGIN_KEY)
 cdef size_t _ORIGIN_KEY_LEN = <size_t> len(ORIGIN_KEY)
 
 
+# Well-known span map keys, pre-encoded once at module init so packing one is
+# a single memcpy of the canned bytes instead of re-encoding the same header
+# and payload for every span
+cdef msgpack_fragment _KEY_SERVICE
+cdef msgpack_fragment _KEY_RESOURCE
+cdef msgpack_fragment _KEY_NAME
+cdef msgpack_fragment _KEY_ERROR
+cdef msgpack_fragment _KEY_TYPE
+cdef msgpack_fragment _KEY_SPAN_LINKS
+cdef msgpack_fragment _KEY_META
+cdef msgpack_fragment _KEY_META_STRUCT
+cdef msgpack_fragment _KEY_METRICS
+msgpack_fragment_init_str(&_KEY_SERVICE, "service", 7)
+msgpack_fragment_init_str(&_KEY_RESOURCE, "resource", 8)
+msgpack_fragment_init_str(&_KEY_NAME, "name", 4)
+msgpack_fragment_init_str(&_KEY_ERROR, "error", 5)
+msgpack_fragment_init_str(&_KEY_TYPE, "type", 4)
+msgpack_fragment_init_str(&_KEY_SPAN_LINKS, "span_links", 10)
+msgpack_fragment_init_str(&_KEY_META, "meta", 4)
+msgpack_fragment_init_str(&_KEY_META_STRUCT, "meta_struct", 11)
+msgpack_fragment_init_str(&_KEY_METRICS, "metrics", 7)
+
+
 cdef inline int array_prefix_size(stdint.uint32_t l):
     if l < 16:
         return 1
@@ -125,6 +183,25 @@ cdef inline int pack_number(msgpack_packer *pk, object n) except? -1:
     raise TypeError("Unhandled numeric type: %r" % type(n))
 
 
+cdef inline int pack_uint_field(msgpack_packer *pk, const char *key, size_t key_len, object n) except? -1:
+    # Fast path for the fixed numeric span fields: key and value are emitted
+    # with a single bounds check when the value fits in an unsigned 64-bit
+    # integer, which ids and timestamps always do in practice
+    cdef unsigned long long ull
+    cdef int ret
+
+    if PyLong_CheckExact(n):
+        ull = PyLong_AsUnsignedLongLong(n)
+        if ull != <unsigned long long> -1 or not PyErr_Occurred():
+            return msgpack_pack_kv_uint64(pk, key, key_len, ull)
+        PyErr_Clear()
+
+    ret = pack_bytes(pk, <char *> key, key_len)
+    if ret != 0:
+        return ret
+    return pack_number(pk, n)
+
+
 cdef inline int pack_text(msgpack_packer *pk, object text) except? -1:
     cdef Py_ssize_t L
     cdef int ret
@@ -159,6 +236,156 @@ cdef inline int pack_text(msgpack_packer *pk, object text) except? -1:
     raise TypeError("Unhandled text type: %r" % type(text))
 
 
+cdef int json_pack(msgpack_packer* pk, object o) except -1:
+    # Recursive JSON emission over the telemetry payload types (dict, list,
+    # tuple, str, int, float, bool, None); the scalar emitters live next to
+    # the packer in pack.h. Output is compact (no separator whitespace) and
+    # keeps non-ASCII text as raw UTF-8.
+    cdef PyObject* key = NULL
+    cdef PyObject* value = NULL
+    cdef Py_ssize_t pos = 0
+    cdef long long ll
+    cdef int first = 1
+    cdef int ret
+
+    if o is None:
+        return msgpack_pack_write(pk, "null", 4)
+    if o is True:
+        return msgpack_pack_write(pk, "true", 4)
+    if o is False:
+        return msgpack_pack_write(pk, "false", 5)
+
+    if PyUnicode_Check(o):
+        return json_pack_str(pk, <PyObject *> o)
+
+    if PyLong_Check(o):
+        ll = PyLong_AsLongLong(o)
+        if ll == -1 and PyErr_Occurred() != NULL:
+            # Out of 64-bit range: fall back to the decimal digits
+            PyErr_Clear()
+            digits = str(o).encode("ascii")
+            return msgpack_pack_write(pk, <const char *> digits, len(digits))
+        return json_pack_ll(pk, ll)
+
+    if PyFloat_Check(o):
+        return json_pack_double(pk, <double> o)
+
+    if PyDict_Check(o):
+        ret = msgpack_pack_write(pk, "{", 1)
+        if ret != 0:
+            return ret
+        while PyDict_Next(o, &pos, &key, &value):
+            if not PyUnicode_Check(<object> key):
+                raise TypeError("JSON keys must be str, not %s" % type(<object> key).__name__)
+            if not first:
+                ret = msgpack_pack_write(pk, ",", 1)
+                if ret != 0:
+                    return ret
+            first = 0
+            ret = json_pack_str(pk, key)
+            if ret != 0:
+                return ret
+            ret = msgpack_pack_write(pk, ":", 1)
+            if ret != 0:
+                return ret
+            ret = json_pack(pk, <object> value)
+            if ret != 0:
+                return ret
+        return msgpack_pack_write(pk, "}", 1)
+
+    if PyList_Check(o) or PyTuple_Check(o):
+        ret = msgpack_pack_write(pk, "[", 1)
+        if ret != 0:
+            return ret
+        for item in o:
+            if not first:
+                ret = msgpack_pack_write(pk, ",", 1)
+                if ret != 0:
+                    return ret
+            first = 0
+            ret = json_pack(pk, item)
+            if ret != 0:
+                return ret
+        return msgpack_pack_write(pk, "]", 1)
+
+    raise TypeError("Object of type %s is not JSON serializable" % type(o).__name__)
+
+
+cpdef bytes json_encode(object o):
+    """Serialize ``o`` to compact JSON bytes.
+
+    Native counterpart of ``json.dumps`` for the telemetry payload shapes
+    (nested dicts and lists of strings and numbers), built on the pooled
+    packer buffer so a heartbeat's worth of series and dependency entries is
+    emitted without any per-value Python work.
+    """
+    cdef msgpack_packer pk
+
+    if msgpack_packer_init(&pk, 1 << 12) != 0:
+        raise MemoryError("Unable to allocate internal buffer.")
+    try:
+        json_pack(&pk, o)
+        return PyBytes_FromStringAndSize(pk.buf, pk.length)
+    finally:
+        msgpack_packer_destroy(&pk)
+
+
+cdef class PackedPayload:
+    """Zero-copy view over a detached packer buffer.
+
+    Flush hands the encode buffer over to this object instead of copying it
+    into a bytes object, so a payload is never copied again after encoding:
+    the HTTP layer writes it to the agent socket straight from the encode
+    buffer through the buffer protocol. The buffer goes back to the packer
+    pool when the payload is garbage collected, typically right after the
+    send completes.
+    """
+
+    cdef msgpack_packer pk
+    cdef size_t offset
+
+    @staticmethod
+    cdef PackedPayload take(msgpack_packer* pk, size_t offset):
+        """Take ownership of `pk`'s buffer, leaving the packer empty"""
+        cdef PackedPayload p = PackedPayload.__new__(PackedPayload)
+        p.pk = pk[0]
+        p.offset = offset
+        pk.buf = NULL
+        pk.buf_size = 0
+        pk.length = 0
+        return p
+
+    def __dealloc__(self):
+        msgpack_packer_destroy(&self.pk)
+
+    def __len__(self):
+        return self.pk.length - self.offset
+
+    def __getbuffer__(self, Py_buffer *view, int flags):
+        PyBuffer_FillInfo(view, self, self.pk.buf + self.offset, self.pk.length - self.offset, 1, flags)
+
+    def __releasebuffer__(self, Py_buffer *view):
+        pass
+
+    def __bytes__(self):
+        return PyBytes_FromStringAndSize(self.pk.buf + self.offset, self.pk.length - self.offset)
+
+    def __add__(left, right):
+        # Concatenation materializes a bytes copy; bytes-style consumers
+        # (tests, diagnostics) keep working, the send path never calls this
+        if isinstance(left, PackedPayload):
+            return bytes(left) + right
+        return left + bytes(right)
+
+    def __eq__(self, other):
+        if other is None:
+            return False
+        try:
+            return memoryview(self).tobytes() == memoryview(other).tobytes()
+        except TypeError:
+            return NotImplemented
+
+
 cdef class StringTable(object):
     cdef dict _table
     cdef stdint.uint32_t _next_id
@@ -224,6 +451,7 @@ cdef class ListStringTable(StringTable):
 
 cdef class MsgpackStringTable(StringTable):
     cdef msgpack_packer pk
+    cdef msgpack_strtable _cache
     cdef int max_size
     cdef int _max_string_length
     cdef int _sp_len
@@ -232,10 +460,11 @@ cdef class MsgpackStringTable(StringTable):
     cdef size_t _reset_size
 
     def __init__(self, max_size):
-        self.pk.buf_size = min(max_size, 1 << 20)
-        self.pk.buf = <char*> PyMem_Malloc(self.pk.buf_size)
-        if self.pk.buf == NULL:
+        if msgpack_packer_init(&self.pk, min(max_size, 1 << 20)) != 0:
             raise MemoryError("Unable to allocate internal buffer.")
+        if msgpack_strtable_init(&self._cache) != 0:
+            msgpack_packer_destroy(&self.pk)
+            raise MemoryError("Unable to allocate native string table.")
         self.max_size = max_size
         self._max_string_length = int(0.1*max_size)
         self.pk.length = MSGPACK_STRING_TABLE_LENGTH_PREFIX_SIZE
@@ -247,8 +476,8 @@ cdef class MsgpackStringTable(StringTable):
         self._reset_size = self.pk.length
 
     def __dealloc__(self):
-        PyMem_Free(self.pk.buf)
-        self.pk.buf = NULL
+        msgpack_packer_destroy(&self.pk)
+        msgpack_strtable_destroy(&self._cache)
 
     cdef insert(self, object string):
         cdef int ret
@@ -269,6 +498,25 @@ cdef class MsgpackStringTable(StringTable):
         if ret != 0:
             raise RuntimeError("Failed to add string to msgpack string table")
 
+    cdef int pack_index(self, msgpack_packer* pk, object string) except? -1:
+        # Emit the string-table index of `string` into `pk`. Repeated strings
+        # hit the native cache: one pointer probe and one canned-bytes copy,
+        # with no dict lookup and no boxed integer round-trip. Misses resolve
+        # through the dict-backed table and prime the cache for next time; a
+        # failed cache insert is harmless, the string just misses again.
+        cdef stdint.uint32_t _id
+        cdef int ret
+
+        if string is not None:
+            ret = msgpack_strtable_pack(&self._cache, pk, <PyObject *> string)
+            if ret <= 0:
+                return ret
+
+        _id = self._index(string)
+        if string is not None:
+            msgpack_strtable_insert(&self._cache, <PyObject *> string, _id)
+        return msgpack_pack_uint32(pk, _id)
+
     cdef savepoint(self):
         self._sp_len = self.pk.length
         self._sp_id = self._next_id
@@ -287,30 +535,9 @@ cdef class MsgpackStringTable(StringTable):
         #    trace can not be decoded without accessing an invalid index. In this scenario the agent will
         #    return a 400 status code.
         self._table = {s: idx for s, idx in self._table.items() if idx < self._next_id}
-
-    cdef get_bytes(self):
-        cdef int ret
-        cdef stdint.uint32_t table_size
-        cdef int offset
-        cdef int old_pos
-        with self._lock:
-            table_size = self._next_id
-            offset = MSGPACK_STRING_TABLE_LENGTH_PREFIX_SIZE - array_prefix_size(table_size)
-            old_pos = self.pk.length
-
-            # Update table size prefix
-            self.pk.length = offset
-            ret = msgpack_pack_array(&self.pk, table_size)
-            if ret:
-                return None
-            # Add root array size prefix
-            self.pk.length = offset = offset - 1
-            ret = msgpack_pack_array(&self.pk, 2)
-            if ret:
-                return None
-            self.pk.length = old_pos
-
-            return PyBytes_FromStringAndSize(self.pk.buf + offset, self.pk.length - offset)
+        # The native cache must drop the same ids, or its canned bytes would
+        # alias whatever strings claim them next
+        msgpack_strtable_evict_from(&self._cache, self._next_id)
 
     @property
     def size(self):
@@ -338,13 +565,47 @@ cdef class MsgpackStringTable(StringTable):
         self._next_id = 2
         self.pk.length = self._reset_size
         self._sp_len = 0
+        # Ids restart from scratch; the cache re-primes lazily
+        msgpack_strtable_clear(&self._cache)
+
+    cdef _seed_buffer(self):
+        # Rebuild the constant head of a fresh buffer: the table length
+        # prefix, the empty string at id 0 and the origin key at id 1 -- the
+        # same bytes __init__ wrote, so _reset_size stays valid
+        self.pk.length = MSGPACK_STRING_TABLE_LENGTH_PREFIX_SIZE
+        if pack_text(&self.pk, "") != 0 or pack_text(&self.pk, ORIGIN_KEY) != 0:
+            raise RuntimeError("Failed to seed msgpack string table buffer")
 
     cpdef flush(self):
+        cdef int ret
+        cdef stdint.uint32_t table_size
+        cdef int offset
+        cdef int old_pos
         with self._lock:
-            try:
-                return self.get_bytes()
-            finally:
-                self.reset()
+            # Patch the table and root array prefixes, then detach the buffer
+            # into a zero-copy payload and restart from a fresh (typically
+            # recycled) buffer, instead of copying the whole payload into a
+            # bytes object
+            table_size = self._next_id
+            offset = MSGPACK_STRING_TABLE_LENGTH_PREFIX_SIZE - array_prefix_size(table_size)
+            old_pos = self.pk.length
+
+            self.pk.length = offset
+            ret = msgpack_pack_array(&self.pk, table_size)
+            if ret:
+                raise RuntimeError("Failed to update string table size prefix")
+            self.pk.length = offset = offset - 1
+            ret = msgpack_pack_array(&self.pk, 2)
+            if ret:
+                raise RuntimeError("Failed to update payload array prefix")
+            self.pk.length = old_pos
+
+            payload = PackedPayload.take(&self.pk, <size_t> offset)
+            if msgpack_packer_init(&self.pk, min(self.max_size, 1 << 20)) != 0:
+                raise MemoryError("Unable to allocate internal buffer.")
+            self._seed_buffer()
+            self.reset()
+            return payload
 
 
 cdef class BufferedEncoder(object):
@@ -421,20 +682,16 @@ cdef class MsgpackEncoderBase(BufferedEncoder):
     cdef stdint.uint32_t _count
 
     def __cinit__(self, size_t max_size, size_t max_item_size):
-        cdef int buf_size = 1024*1024
-        self.pk.buf = <char*> PyMem_Malloc(buf_size)
-        if self.pk.buf == NULL:
+        if msgpack_packer_init(&self.pk, 1024*1024) != 0:
             raise MemoryError("Unable to allocate internal buffer.")
 
         self.max_size = max_size
-        self.pk.buf_size = buf_size
         self.max_item_size = max_item_size if max_item_size < max_size else max_size
         self._lock = threading.RLock()
         self._reset_buffer()
 
     def __dealloc__(self):
-        PyMem_Free(self.pk.buf)
-        self.pk.buf = NULL
+        msgpack_packer_destroy(&self.pk)
 
     def __len__(self):  # TODO: Use a better name?
         return self._count
@@ -554,11 +811,19 @@ cdef class MsgpackEncoderBase(BufferedEncoder):
 
 cdef class MsgpackEncoderV04(MsgpackEncoderBase):
     cpdef flush(self):
+        cdef size_t offset
+        cdef stdint.uint32_t count
         with self._lock:
-            try:
-                return self.get_bytes(), len(self)
-            finally:
-                self._reset_buffer()
+            # Detach the encode buffer into a zero-copy payload and restart
+            # from a fresh (typically recycled) buffer, instead of copying the
+            # whole payload into a bytes object
+            offset = <size_t> self._update_array_len()
+            count = self._count
+            payload = PackedPayload.take(&self.pk, offset)
+            if msgpack_packer_init(&self.pk, 1024*1024) != 0:
+                raise MemoryError("Unable to allocate internal buffer.")
+            self._reset_buffer()
+            return payload, count
 
     cdef void * get_dd_origin_ref(self, str dd_origin):
         return string_to_buff(dd_origin)
@@ -620,6 +885,11 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
         cdef Py_ssize_t L
         cdef int ret
         cdef dict d
+        cdef msgpack_string_view views[MSGPACK_TAG_BATCH_SIZE]
+        cdef size_t nviews
+        cdef Py_ssize_t klen, vlen
+        cdef const char *kbuf
+        cdef const char *vbuf
 
         if PyDict_CheckExact(meta):
             d = <dict> meta
@@ -629,13 +899,45 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
 
             ret = msgpack_pack_map(&self.pk, L)
             if ret == 0:
+                # Tag keys and values are almost always str: batch them into
+                # string views and emit each batch with a single reservation
+                # and wide copies, falling back to the generic packer for
+                # anything else
+                nviews = 0
                 for k, v in d.items():
+                    if PyUnicode_CheckExact(k) and PyUnicode_CheckExact(v):
+                        kbuf = PyUnicode_AsUTF8AndSize(k, &klen)
+                        if kbuf == NULL:
+                            return -1
+                        vbuf = PyUnicode_AsUTF8AndSize(v, &vlen)
+                        if vbuf == NULL:
+                            return -1
+                        if klen <= ITEM_LIMIT and vlen <= ITEM_LIMIT:
+                            views[nviews].data = kbuf
+                            views[nviews].length = klen
+                            views[nviews + 1].data = vbuf
+                            views[nviews + 1].length = vlen
+                            nviews += 2
+                            if nviews == MSGPACK_TAG_BATCH_SIZE:
+                                ret = msgpack_pack_str_array(&self.pk, views, nviews)
+                                nviews = 0
+                                if ret != 0:
+                                    break
+                            continue
+                    # Flush pending views first so the map stays in order
+                    if nviews > 0:
+                        ret = msgpack_pack_str_array(&self.pk, views, nviews)
+                        nviews = 0
+                        if ret != 0:
+                            break
                     ret = pack_text(&self.pk, k)
                     if ret != 0:
                         break
                     ret = pack_text(&self.pk, v)
                     if ret != 0:
                         break
+                if ret == 0 and nviews > 0:
+                    ret = msgpack_pack_str_array(&self.pk, views, nviews)
                 if dd_origin is not NULL:
                     ret = pack_bytes(&self.pk, _ORIGIN_KEY, _ORIGIN_KEY_LEN)
                     if ret == 0:
@@ -695,65 +997,50 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
         ret = msgpack_pack_map(&self.pk, L)
 
         if ret == 0:
-            ret = pack_bytes(&self.pk, <char *> b"trace_id", 8)
-            if ret != 0:
-                return ret
-            ret = pack_number(&self.pk, span._trace_id_64bits)
+            ret = pack_uint_field(&self.pk, "trace_id", 8, span._trace_id_64bits)
             if ret != 0:
                 return ret
 
             if has_parent_id:
-                ret = pack_bytes(&self.pk, <char *> b"parent_id", 9)
-                if ret != 0:
-                    return ret
-                ret = pack_number(&self.pk, span.parent_id)
+                ret = pack_uint_field(&self.pk, "parent_id", 9, span.parent_id)
                 if ret != 0:
                     return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"span_id", 7)
-            if ret != 0:
-                return ret
-            ret = pack_number(&self.pk, span.span_id)
+            ret = pack_uint_field(&self.pk, "span_id", 7, span.span_id)
             if ret != 0:
                 return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"service", 7)
+            ret = msgpack_pack_fragment(&self.pk, &_KEY_SERVICE)
             if ret != 0:
                 return ret
             ret = pack_text(&self.pk, span.service)
             if ret != 0:
                 return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"resource", 8)
+            ret = msgpack_pack_fragment(&self.pk, &_KEY_RESOURCE)
             if ret != 0:
                 return ret
             ret = pack_text(&self.pk, span.resource)
             if ret != 0:
                 return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"name", 4)
+            ret = msgpack_pack_fragment(&self.pk, &_KEY_NAME)
             if ret != 0:
                 return ret
             ret = pack_text(&self.pk, span.name)
             if ret != 0:
                 return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"start", 5)
-            if ret != 0:
-                return ret
-            ret = pack_number(&self.pk, span.start_ns)
+            ret = pack_uint_field(&self.pk, "start", 5, span.start_ns)
             if ret != 0:
                 return ret
 
-            ret = pack_bytes(&self.pk, <char *> b"duration", 8)
-            if ret != 0:
-                return ret
-            ret = pack_number(&self.pk, span.duration_ns)
+            ret = pack_uint_field(&self.pk, "duration", 8, span.duration_ns)
             if ret != 0:
                 return ret
 
             if has_error:
-                ret = pack_bytes(&self.pk, <char *> b"error", 5)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_ERROR)
                 if ret != 0:
                     return ret
                 ret = msgpack_pack_long(&self.pk, <long> 1)
@@ -761,7 +1048,7 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
                     return ret
 
             if has_span_type:
-                ret = pack_bytes(&self.pk, <char *> b"type", 4)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_TYPE)
                 if ret != 0:
                     return ret
                 ret = pack_text(&self.pk, span.span_type)
@@ -769,7 +1056,7 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
                     return ret
 
             if has_links:
-                ret = pack_bytes(&self.pk, <char *> b"span_links", 10)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_SPAN_LINKS)
                 if ret != 0:
                     return ret
                 ret = self._pack_links(span._links)
@@ -777,7 +1064,7 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
                     return ret
 
             if has_meta:
-                ret = pack_bytes(&self.pk, <char *> b"meta", 4)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_META)
                 if ret != 0:
                     return ret
 
@@ -789,7 +1076,7 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
                     return ret
 
             if has_meta_struct:
-                ret = pack_bytes(&self.pk, <char *> b"meta_struct", 11)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_META_STRUCT)
                 if ret != 0:
                     return ret
 
@@ -808,7 +1095,7 @@ cdef class MsgpackEncoderV04(MsgpackEncoderBase):
                         return ret
 
             if has_metrics:
-                ret = pack_bytes(&self.pk, <char *> b"metrics", 7)
+                ret = msgpack_pack_fragment(&self.pk, &_KEY_METRICS)
                 if ret != 0:
                     return ret
                 ret = self._pack_metrics(span._metrics)
@@ -851,7 +1138,7 @@ cdef class MsgpackEncoderV05(MsgpackEncoderBase):
                 raise
 
     cdef inline int _pack_string(self, object string) except? -1:
-        return msgpack_pack_uint32(&self.pk, self._st._index(string))
+        return self._st.pack_index(&self.pk, string)
 
     cdef void * get_dd_origin_ref(self, str dd_origin):
         return <void *> PyLong_AsLong(self._st._index(dd_origin))
@@ -987,12 +1274,8 @@ cdef class Packer(object):
     cdef const char *unicode_errors
 
     def __cinit__(self):
-        cdef int buf_size = 1024*1024
-        self.pk.buf = <char*> PyMem_Malloc(buf_size)
-        if self.pk.buf == NULL:
+        if msgpack_packer_init(&self.pk, 1024*1024) != 0:
             raise MemoryError("Unable to allocate internal buffer.")
-        self.pk.buf_size = buf_size
-        self.pk.length = 0
 
     def __init__(self, default=None):
         if default is not None:
@@ -1006,8 +1289,7 @@ cdef class Packer(object):
             self.encoding = NULL
 
     def __dealloc__(self):
-        PyMem_Free(self.pk.buf)
-        self.pk.buf = NULL
+        msgpack_packer_destroy(&self.pk)
 
     cdef int _pack(self, object o) except -1:
         cdef long long llval
@@ -0,0 +1,454 @@
+#include <stdint.h>
+#include <string.h>
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Memory-mapped disk spool for encoded trace payloads.
+
+   The writer drops fully encoded msgpack payloads when the agent stays
+   unreachable past its retries. The Spool object gives those payloads a
+   bounded, durable parking spot: a size-capped ring file holding
+   length-prefixed records, appended and consumed through a shared mapping so
+   the steady-state cost of a write is a memcpy plus page faults, with no
+   per-record syscalls.
+
+   The ring keeps the oldest records at `head` and appends at `tail`; when an
+   append does not fit, whole records are evicted oldest-first until it does.
+   The header page is only written after a record's bytes are in place, so a
+   crash mid-append at worst loses the record being written; a header that
+   fails validation on open resets the spool rather than replaying garbage. */
+
+#define SPOOL_MAGIC 0x314C4F4F50534444ULL /* "DDSPOOL1" */
+/* One page, so record data starts page-aligned */
+#define SPOOL_HEADER_SIZE 4096
+/* Per record: u32 payload length + u32 trace count */
+#define SPOOL_RECORD_HEADER 8
+
+typedef struct
+{
+    uint64_t magic;
+    uint64_t capacity; /* Size of the data region, in bytes */
+    uint64_t head;     /* Offset of the oldest record in the data region */
+    uint64_t tail;     /* Offset one past the newest record */
+    uint64_t count;    /* Number of records */
+    uint64_t used;     /* Bytes occupied by records; disambiguates head == tail */
+} spool_header_t;
+
+typedef struct
+{
+    PyObject_HEAD int fd;
+    uint8_t* map;        /* Whole mapping: header page plus data region */
+    uint8_t* data;       /* map + SPOOL_HEADER_SIZE */
+    spool_header_t* hdr; /* Lives in the mapped header page */
+} Spool;
+
+static inline int
+spool_is_closed(const Spool* self)
+{
+    return self->map == NULL;
+}
+
+/* Copy into the ring at a logical offset, splitting at the wrap point */
+static void
+spool_write_bytes(Spool* self, uint64_t pos, const uint8_t* src, uint64_t len)
+{
+    const uint64_t capacity = self->hdr->capacity;
+    pos %= capacity;
+    if (pos + len <= capacity) {
+        memcpy(self->data + pos, src, len);
+    } else {
+        const uint64_t first = capacity - pos;
+        memcpy(self->data + pos, src, first);
+        memcpy(self->data, src + first, len - first);
+    }
+}
+
+static void
+spool_read_bytes(const Spool* self, uint64_t pos, uint8_t* dst, uint64_t len)
+{
+    const uint64_t capacity = self->hdr->capacity;
+    pos %= capacity;
+    if (pos + len <= capacity) {
+        memcpy(dst, self->data + pos, len);
+    } else {
+        const uint64_t first = capacity - pos;
+        memcpy(dst, self->data + pos, first);
+        memcpy(dst + first, self->data, len - first);
+    }
+}
+
+/* Length and trace count of the record at `pos` */
+static void
+spool_read_record_header(const Spool* self, uint64_t pos, uint32_t* payload_len, uint32_t* trace_count)
+{
+    uint8_t buf[SPOOL_RECORD_HEADER];
+    spool_read_bytes(self, pos, buf, SPOOL_RECORD_HEADER);
+    memcpy(payload_len, buf, 4);
+    memcpy(trace_count, buf + 4, 4);
+}
+
+/* Remove the oldest record; the caller must know the spool is non-empty */
+static void
+spool_evict_oldest(Spool* self)
+{
+    spool_header_t* hdr = self->hdr;
+    uint32_t payload_len, trace_count;
+    spool_read_record_header(self, hdr->head, &payload_len, &trace_count);
+    const uint64_t record_len = SPOOL_RECORD_HEADER + (uint64_t)payload_len;
+    hdr->head = (hdr->head + record_len) % hdr->capacity;
+    hdr->used -= record_len;
+    hdr->count -= 1;
+    if (hdr->count == 0) {
+        /* Keep an empty ring rooted at the start of the file so validation
+           and wrap arithmetic stay simple */
+        hdr->head = hdr->tail = 0;
+    }
+}
+
+/* Walk the records from head and confirm they add up to the header's
+   accounting; a mismatch means a torn or foreign header */
+static int
+spool_header_valid(const Spool* self, uint64_t file_size)
+{
+    const spool_header_t* hdr = self->hdr;
+    if (hdr->magic != SPOOL_MAGIC)
+        return 0;
+    if (hdr->capacity == 0 || SPOOL_HEADER_SIZE + hdr->capacity != file_size)
+        return 0;
+    if (hdr->head >= hdr->capacity || hdr->tail >= hdr->capacity || hdr->used > hdr->capacity)
+        return 0;
+    if ((hdr->head + hdr->used) % hdr->capacity != hdr->tail)
+        return 0;
+
+    uint64_t pos = hdr->head;
+    uint64_t remaining = hdr->used;
+    uint64_t records = 0;
+    while (remaining > 0) {
+        if (remaining < SPOOL_RECORD_HEADER)
+            return 0;
+        uint32_t payload_len, trace_count;
+        spool_read_record_header(self, pos, &payload_len, &trace_count);
+        const uint64_t record_len = SPOOL_RECORD_HEADER + (uint64_t)payload_len;
+        if (record_len > remaining)
+            return 0;
+        pos = (pos + record_len) % hdr->capacity;
+        remaining -= record_len;
+        records++;
+    }
+    return records == hdr->count;
+}
+
+static void
+spool_reset_header(Spool* self, uint64_t capacity)
+{
+    spool_header_t* hdr = self->hdr;
+    hdr->magic = SPOOL_MAGIC;
+    hdr->capacity = capacity;
+    hdr->head = 0;
+    hdr->tail = 0;
+    hdr->count = 0;
+    hdr->used = 0;
+}
+
+static void
+spool_unmap(Spool* self)
+{
+    if (self->map != NULL) {
+        munmap(self->map, SPOOL_HEADER_SIZE + self->hdr->capacity);
+        self->map = NULL;
+        self->data = NULL;
+        self->hdr = NULL;
+    }
+    if (self->fd >= 0) {
+        close(self->fd);
+        self->fd = -1;
+    }
+}
+
+static int
+spool_init(Spool* self, PyObject* args, PyObject* kwargs)
+{
+    static char* kwlist[] = { "path", "capacity", NULL };
+    const char* path;
+    Py_ssize_t capacity;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sn", kwlist, &path, &capacity))
+        return -1;
+    if (capacity <= SPOOL_RECORD_HEADER) {
+        PyErr_SetString(PyExc_ValueError, "spool capacity is too small");
+        return -1;
+    }
+
+    self->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (self->fd < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(self->fd, &st) < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        spool_unmap(self);
+        return -1;
+    }
+    const uint64_t file_size = SPOOL_HEADER_SIZE + (uint64_t)capacity;
+    const int existing = (uint64_t)st.st_size == file_size;
+    if (!existing && ftruncate(self->fd, (off_t)file_size) < 0) {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        spool_unmap(self);
+        return -1;
+    }
+
+    self->map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, self->fd, 0);
+    if (self->map == MAP_FAILED) {
+        self->map = NULL;
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        spool_unmap(self);
+        return -1;
+    }
+    self->hdr = (spool_header_t*)self->map;
+    self->data = self->map + SPOOL_HEADER_SIZE;
+
+    /* A pre-existing file with a consistent header keeps its records; this is
+       what makes spooled payloads survive a restart. Anything else (new file,
+       resized capacity, torn header) starts empty. */
+    if (!existing || !spool_header_valid(self, file_size))
+        spool_reset_header(self, (uint64_t)capacity);
+
+    return 0;
+}
+
+static void
+spool_dealloc(Spool* self)
+{
+    spool_unmap(self);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int
+spool_check_open(Spool* self)
+{
+    if (spool_is_closed(self)) {
+        PyErr_SetString(PyExc_ValueError, "spool is closed");
+        return -1;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(spool_append__doc__,
+             "append(payload, trace_count)\n"
+             "--\n"
+             "\n"
+             "Append an encoded payload, evicting the oldest records if the ring is\n"
+             "full. Returns the number of records evicted to make room.");
+
+static PyObject*
+spool_append(Spool* self, PyObject* args)
+{
+    Py_buffer payload;
+    unsigned int trace_count;
+
+    if (!PyArg_ParseTuple(args, "y*I", &payload, &trace_count))
+        return NULL;
+    if (spool_check_open(self) < 0) {
+        PyBuffer_Release(&payload);
+        return NULL;
+    }
+
+    spool_header_t* hdr = self->hdr;
+    const uint64_t record_len = SPOOL_RECORD_HEADER + (uint64_t)payload.len;
+    if (record_len > hdr->capacity) {
+        PyBuffer_Release(&payload);
+        PyErr_Format(PyExc_ValueError, "payload (%zdB) larger than spool capacity (%lluB)", payload.len,
+                     (unsigned long long)hdr->capacity);
+        return NULL;
+    }
+
+    uint64_t evicted = 0;
+    while (hdr->used + record_len > hdr->capacity) {
+        spool_evict_oldest(self);
+        evicted++;
+    }
+
+    uint8_t record_header[SPOOL_RECORD_HEADER];
+    const uint32_t payload_len = (uint32_t)payload.len;
+    memcpy(record_header, &payload_len, 4);
+    memcpy(record_header + 4, &trace_count, 4);
+    spool_write_bytes(self, hdr->tail, record_header, SPOOL_RECORD_HEADER);
+    spool_write_bytes(self, hdr->tail + SPOOL_RECORD_HEADER, payload.buf, (uint64_t)payload.len);
+    /* Publish the record only once its bytes are in place */
+    hdr->tail = (hdr->tail + record_len) % hdr->capacity;
+    hdr->used += record_len;
+    hdr->count += 1;
+
+    PyBuffer_Release(&payload);
+    return PyLong_FromUnsignedLongLong(evicted);
+}
+
+PyDoc_STRVAR(spool_peek__doc__,
+             "peek()\n"
+             "--\n"
+             "\n"
+             "Return the oldest record as a (payload, trace_count) tuple without\n"
+             "removing it, or None if the spool is empty.");
+
+static PyObject*
+spool_peek(Spool* self, PyObject* Py_UNUSED(args))
+{
+    if (spool_check_open(self) < 0)
+        return NULL;
+    const spool_header_t* hdr = self->hdr;
+    if (hdr->count == 0)
+        Py_RETURN_NONE;
+
+    uint32_t payload_len, trace_count;
+    spool_read_record_header(self, hdr->head, &payload_len, &trace_count);
+
+    PyObject* payload = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)payload_len);
+    if (payload == NULL)
+        return NULL;
+    spool_read_bytes(self, hdr->head + SPOOL_RECORD_HEADER, (uint8_t*)PyBytes_AS_STRING(payload), payload_len);
+
+    PyObject* result = Py_BuildValue("(NI)", payload, trace_count);
+    if (result == NULL)
+        Py_DECREF(payload);
+    return result;
+}
+
+PyDoc_STRVAR(spool_drop__doc__,
+             "drop()\n"
+             "--\n"
+             "\n"
+             "Discard the oldest record, typically after peek() and a successful\n"
+             "send. No-op on an empty spool.");
+
+static PyObject*
+spool_drop(Spool* self, PyObject* Py_UNUSED(args))
+{
+    if (spool_check_open(self) < 0)
+        return NULL;
+    if (self->hdr->count > 0)
+        spool_evict_oldest(self);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(spool_clear__doc__,
+             "clear()\n"
+             "--\n"
+             "\n"
+             "Discard every spooled record.");
+
+static PyObject*
+spool_clear(Spool* self, PyObject* Py_UNUSED(args))
+{
+    if (spool_check_open(self) < 0)
+        return NULL;
+    spool_header_t* hdr = self->hdr;
+    hdr->head = hdr->tail = 0;
+    hdr->count = 0;
+    hdr->used = 0;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(spool_close__doc__,
+             "close()\n"
+             "--\n"
+             "\n"
+             "Flush the mapping to disk and close the file. Idempotent.");
+
+static PyObject*
+spool_close(Spool* self, PyObject* Py_UNUSED(args))
+{
+    if (self->map != NULL)
+        msync(self->map, SPOOL_HEADER_SIZE + self->hdr->capacity, MS_SYNC);
+    spool_unmap(self);
+    Py_RETURN_NONE;
+}
+
+static Py_ssize_t
+spool_len(Spool* self)
+{
+    if (spool_check_open(self) < 0)
+        return -1;
+    return (Py_ssize_t)self->hdr->count;
+}
+
+static PyObject*
+spool_get_size(Spool* self, void* Py_UNUSED(closure))
+{
+    if (spool_check_open(self) < 0)
+        return NULL;
+    return PyLong_FromUnsignedLongLong(self->hdr->used);
+}
+
+static PyObject*
+spool_get_capacity(Spool* self, void* Py_UNUSED(closure))
+{
+    if (spool_check_open(self) < 0)
+        return NULL;
+    return PyLong_FromUnsignedLongLong(self->hdr->capacity);
+}
+
+static PyMethodDef spool_methods[] = {
+    { "append", (PyCFunction)spool_append, METH_VARARGS, spool_append__doc__ },
+    { "peek", (PyCFunction)spool_peek, METH_NOARGS, spool_peek__doc__ },
+    { "drop", (PyCFunction)spool_drop, METH_NOARGS, spool_drop__doc__ },
+    { "clear", (PyCFunction)spool_clear, METH_NOARGS, spool_clear__doc__ },
+    { "close", (PyCFunction)spool_close, METH_NOARGS, spool_close__doc__ },
+    { NULL, NULL, 0, NULL }
+};
+
+static PyGetSetDef spool_getset[] = {
+    { "size", (getter)spool_get_size, NULL, "Bytes occupied by spooled records", NULL },
+    { "capacity", (getter)spool_get_capacity, NULL, "Size of the record ring, in bytes", NULL },
+    { NULL, NULL, NULL, NULL, NULL }
+};
+
+static PySequenceMethods spool_as_sequence = {
+    .sq_length = (lenfunc)spool_len,
+};
+
+static PyTypeObject SpoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "ddtrace.internal._spool.Spool",
+    .tp_doc = "Size-capped memory-mapped ring file of length-prefixed payload records",
+    .tp_basicsize = sizeof(Spool),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)spool_init,
+    .tp_dealloc = (destructor)spool_dealloc,
+    .tp_methods = spool_methods,
+    .tp_getset = spool_getset,
+    .tp_as_sequence = &spool_as_sequence,
+};
+
+PyDoc_STRVAR(module__doc__, "Memory-mapped disk spool for encoded trace payloads");
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, "_spool", module__doc__, 0, NULL, NULL, NULL, NULL, NULL,
+};
+
+PyMODINIT_FUNC
+PyInit__spool(void)
+{
+    if (PyType_Ready(&SpoolType) < 0)
+        return NULL;
+
+    PyObject* m = PyModule_Create(&module_def);
+    if (m == NULL)
+        return NULL;
+
+    Py_INCREF(&SpoolType);
+    if (PyModule_AddObject(m, "Spool", (PyObject*)&SpoolType) < 0) {
+        Py_DECREF(&SpoolType);
+        Py_DECREF(m);
+        return NULL;
+    }
+    return m;
+}
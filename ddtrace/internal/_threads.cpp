@@ -5,11 +5,36 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#define getpid _getpid
+typedef int pid_t;
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "dd_wrapper/include/coarse_clock.hpp"
 
 // ----------------------------------------------------------------------------
 /**
@@ -52,25 +77,87 @@ class AllowThreads
     }
 
   private:
-    PyThreadState* _state;
+    PyThreadState* _state = nullptr;
 };
 
 // ----------------------------------------------------------------------------
-class PyRef
+#if defined(__linux__) || defined(_WIN32)
+/**
+ * Event with an atomic fast path: set() is a store plus a wake of any
+ * sleepers, clear() is a plain store, and waits only enter the kernel to
+ * actually sleep, instead of taking a mutex on every operation. Backed by
+ * futex on Linux and WaitOnAddress on Windows; platforms without a
+ * wait-on-address primitive fall back to the mutex and condition variable
+ * implementation below.
+ */
+class Event
 {
   public:
-    inline PyRef(PyObject* obj)
-      : _obj(obj)
+    void set()
     {
-        Py_INCREF(_obj);
+        if (_state.exchange(1, std::memory_order_release) == 0)
+#ifdef __linux__
+            syscall(SYS_futex, &_state, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+            WakeByAddressAll(&_state);
+#endif
     }
-    inline ~PyRef() { Py_DECREF(_obj); }
+
+    void wait()
+    {
+        while (_state.load(std::memory_order_acquire) == 0)
+            park(NULL);
+    }
+
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (_state.load(std::memory_order_acquire) == 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+                return false;
+
+            auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+            park(&remaining);
+        }
+
+        return true;
+    }
+
+    void clear() { _state.store(0, std::memory_order_release); }
 
   private:
-    PyObject* _obj;
-};
+    // Sleep until the state leaves 0, the timeout expires, or a spurious
+    // wakeup; callers re-check the state in a loop.
+    void park(const std::chrono::nanoseconds* timeout)
+    {
+#ifdef __linux__
+        struct timespec ts;
+        struct timespec* tsp = NULL;
+
+        if (timeout != NULL) {
+            ts.tv_sec = (time_t)(timeout->count() / 1000000000LL);
+            ts.tv_nsec = (long)(timeout->count() % 1000000000LL);
+            tsp = &ts;
+        }
 
-// ----------------------------------------------------------------------------
+        syscall(SYS_futex, &_state, FUTEX_WAIT_PRIVATE, 0, tsp, NULL, 0);
+#else
+        uint32_t undesired = 0;
+        DWORD ms = INFINITE;
+
+        if (timeout != NULL)
+            // Round up so we never spin on a sub-millisecond remainder.
+            ms = (DWORD)((timeout->count() + 999999) / 1000000);
+
+        WaitOnAddress(&_state, &undesired, sizeof(undesired), ms);
+#endif
+    }
+
+    std::atomic<uint32_t> _state{ 0 };
+};
+#else
 class Event
 {
   public:
@@ -104,6 +191,7 @@ class Event
     std::mutex _mutex;
     bool _set = false;
 };
+#endif
 
 // ----------------------------------------------------------------------------
 typedef struct periodic_thread
@@ -111,6 +199,7 @@ typedef struct periodic_thread
     PyObject_HEAD
 
       double interval;
+    double slack;
     PyObject* name;
     PyObject* ident;
 
@@ -119,28 +208,54 @@ typedef struct periodic_thread
 
     PyObject* _ddtrace_profiling_ignore;
 
+    bool _started;
     bool _stopping;
     bool _atexit;
     bool _after_fork;
+    bool _error;
+
+    // Scheduler state, protected by the scheduler mutex while the task is
+    // registered.
+    bool _awake_pending;
+    std::chrono::steady_clock::time_point _deadline;
 
-    std::unique_ptr<Event> _started;
     std::unique_ptr<Event> _stopped;
-    std::unique_ptr<Event> _request;
     std::unique_ptr<Event> _served;
 
     std::unique_ptr<std::mutex> _awake_mutex;
-
-    std::unique_ptr<std::thread> _thread;
 } PeriodicThread;
 
 // ----------------------------------------------------------------------------
-// Maintain a mapping of thread ID to PeriodicThread objects. This is similar
-// to threading._active.
+// Maintain a mapping of PeriodicThread objects, keyed by object identity.
+// This is similar to threading._active, except that all periodic threads
+// share a single native thread, so the thread ID cannot be used as the key.
 static PyObject* _periodic_threads = NULL;
 
+// ----------------------------------------------------------------------------
+// Shared scheduler. All PeriodicThread callbacks are multiplexed onto a
+// single native thread that sleeps until the earliest deadline among the
+// registered tasks, then runs the due callbacks in one batch, under a single
+// GIL acquisition. This replaces one native thread, with its own condition
+// variable wakeups and GIL round trips, per PeriodicThread. With the handful
+// of periodic tasks a process runs, a linear scan for the nearest deadline is
+// cheaper than maintaining a timer wheel.
+// The synchronization primitives are heap-allocated and intentionally leaked:
+// the scheduler thread may be parked on the condition variable when the
+// process exits, and destroying a condition variable with waiters blocks
+// exit-time static destruction indefinitely.
+static std::mutex& sched_mutex = *new std::mutex();
+static std::condition_variable& sched_cond = *new std::condition_variable();
+static std::vector<PeriodicThread*>& sched_tasks = *new std::vector<PeriodicThread*>();
+static Event& sched_ready = *new Event();
+static bool sched_running = false;
+static pid_t sched_pid = 0;
+static unsigned long sched_thread_id = 0;
+static std::thread::id sched_native_id;
+
 // ----------------------------------------------------------------------------
 static PyMemberDef PeriodicThread_members[] = {
     { "interval", T_DOUBLE, offsetof(PeriodicThread, interval), 0, "thread interval" },
+    { "slack", T_DOUBLE, offsetof(PeriodicThread, slack), 0, "scheduling slack" },
 
     { "name", T_OBJECT_EX, offsetof(PeriodicThread, name), 0, "thread name" },
     { "ident", T_OBJECT_EX, offsetof(PeriodicThread, ident), 0, "thread ID" },
@@ -158,13 +273,21 @@ static PyMemberDef PeriodicThread_members[] = {
 static int
 PeriodicThread_init(PeriodicThread* self, PyObject* args, PyObject* kwargs)
 {
-    static const char* kwlist[] = { "interval", "target", "name", "on_shutdown", NULL };
+    static const char* kwlist[] = { "interval", "target", "name", "on_shutdown", "slack", NULL };
 
     self->name = Py_None;
     self->_on_shutdown = Py_None;
-
-    if (!PyArg_ParseTupleAndKeywords(
-          args, kwargs, "dO|OO", (char**)kwlist, &self->interval, &self->_target, &self->name, &self->_on_shutdown))
+    self->slack = 0.05;
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "dO|OOd",
+                                     (char**)kwlist,
+                                     &self->interval,
+                                     &self->_target,
+                                     &self->name,
+                                     &self->_on_shutdown,
+                                     &self->slack))
         return -1;
 
     Py_INCREF(self->_target);
@@ -177,13 +300,15 @@ PeriodicThread_init(PeriodicThread* self, PyObject* args, PyObject* kwargs)
     Py_INCREF(Py_True);
     self->_ddtrace_profiling_ignore = Py_True;
 
+    self->_started = false;
     self->_stopping = false;
     self->_atexit = false;
     self->_after_fork = false;
+    self->_error = false;
+
+    self->_awake_pending = false;
 
-    self->_started = std::make_unique<Event>();
     self->_stopped = std::make_unique<Event>();
-    self->_request = std::make_unique<Event>();
     self->_served = std::make_unique<Event>();
 
     self->_awake_mutex = std::make_unique<std::mutex>();
@@ -220,80 +345,242 @@ PeriodicThread__on_shutdown(PeriodicThread* self)
 }
 
 // ----------------------------------------------------------------------------
-static PyObject*
-PeriodicThread_start(PeriodicThread* self, PyObject* args)
+// Deadlines are computed and compared on the coarse clock: intervals are
+// fractions of a second and tasks already run anywhere within their slack
+// window (50 ms by default), so scheduler-tick resolution is plenty.
+static inline std::chrono::steady_clock::time_point
+PeriodicThread__next_deadline(PeriodicThread* self)
 {
-    if (self->_thread != nullptr) {
-        PyErr_SetString(PyExc_RuntimeError, "Thread already started");
-        return NULL;
-    }
+    return Datadog::coarse_steady_now() + std::chrono::milliseconds((long long)(self->interval * 1000));
+}
 
-    if (self->_stopping)
-        Py_RETURN_NONE;
+// ----------------------------------------------------------------------------
+// How far ahead of its deadline a task may be pulled into the current batch.
+// Capped at half the interval so that a large slack can neither make the
+// scheduler spin on a short-interval task nor keep eroding its cadence.
+static inline std::chrono::milliseconds
+PeriodicThread__slack(PeriodicThread* self)
+{
+    double slack = self->slack;
 
-    // Start the thread
-    self->_thread = std::make_unique<std::thread>([self]() {
+    if (slack > self->interval / 2)
+        slack = self->interval / 2;
+
+    return std::chrono::milliseconds((long long)(slack * 1000));
+}
+
+// ----------------------------------------------------------------------------
+// Retire a task that is stopping, or whose callback raised. Called with the
+// GIL held, after the task has been removed from the scheduler list.
+static void
+scheduler_retire(PeriodicThread* task, bool error)
+{
+    task->_error = error;
+
+    // Run the shutdown callback if there was no error and we are not at
+    // Python shutdown.
+    if (!error && !task->_atexit && task->_on_shutdown != Py_None && !_Py_IsFinalizing())
+        PeriodicThread__on_shutdown(task);
+
+    // Release any awake() caller that raced with the retirement.
+    task->_served->set();
+
+    // Notify the join method that the task has stopped
+    task->_stopped->set();
+
+    // Drop the strong reference the scheduler held while the task was
+    // registered.
+    Py_DECREF(task);
+}
+
+// ----------------------------------------------------------------------------
+static void
+scheduler_loop()
+{
+#if defined(__linux__)
+    // Name the thread so it is identifiable in ps/top and in profiles
+    pthread_setname_np(pthread_self(), "ddtrace.sched");
+#elif defined(__APPLE__)
+    pthread_setname_np("ddtrace.sched");
+#endif
+
+    // Register with the interpreter to get a thread ID, and publish it so
+    // that tasks can report it as their ident.
+    {
         GILGuard _gil;
 
-        PyRef _((PyObject*)self);
+        sched_thread_id = (unsigned long)PyThreadState_Get()->thread_id;
+    }
 
-        // Retrieve the thread ID
-        {
-            Py_DECREF(self->ident);
-            self->ident = PyLong_FromLong((long)PyThreadState_Get()->thread_id);
+    sched_ready.set();
 
-            // Map the PeriodicThread object to its thread ID
-            PyDict_SetItem(_periodic_threads, self->ident, (PyObject*)self);
-        }
+    std::vector<PeriodicThread*> due;
+    std::vector<PeriodicThread*> retired;
 
-        // Mark the thread as started from this point.
-        self->_started->set();
+    for (;;) {
+        due.clear();
+        retired.clear();
 
-        bool error = false;
-        auto interval = std::chrono::milliseconds((long long)(self->interval * 1000));
+        {
+            std::unique_lock<std::mutex> lock(sched_mutex);
 
-        while (!self->_stopping) {
-            {
-                AllowThreads _;
+            auto now = Datadog::coarse_steady_now();
+            auto next = std::chrono::steady_clock::time_point::max();
 
-                if (self->_request->wait(interval)) {
-                    if (self->_stopping)
-                        break;
+            for (auto it = sched_tasks.begin(); it != sched_tasks.end();) {
+                PeriodicThread* task = *it;
 
-                    // Awake signal
-                    self->_request->clear();
-                    self->_served->set();
+                if (task->_stopping) {
+                    retired.push_back(task);
+                    it = sched_tasks.erase(it);
+                    continue;
                 }
+
+                // Tasks due within their slack window ride along with the
+                // batch that woke the scheduler, under the same GIL
+                // acquisition, instead of forcing another wakeup moments
+                // later. Tasks with slack=0 only run at their deadline.
+                if (task->_awake_pending || now + PeriodicThread__slack(task) >= task->_deadline)
+                    due.push_back(task);
+                else if (task->_deadline < next)
+                    next = task->_deadline;
+
+                ++it;
+            }
+
+            if (due.empty() && retired.empty()) {
+                if (next == std::chrono::steady_clock::time_point::max())
+                    // Nothing scheduled; park until a task is registered.
+                    sched_cond.wait(lock);
+                else
+                    sched_cond.wait_until(lock, next);
+                continue;
             }
+        }
+
+        if (_Py_IsFinalizing())
+            break;
+
+        // Run the whole due batch under a single GIL acquisition.
+        GILGuard _gil;
+
+        for (PeriodicThread* task : retired)
+            scheduler_retire(task, /* error */ false);
+
+        for (PeriodicThread* task : due) {
+            bool serve;
+            {
+                std::lock_guard<std::mutex> lock(sched_mutex);
+                serve = task->_awake_pending;
+                task->_awake_pending = false;
+            }
+
+            // An awake() caller is released as soon as its request has been
+            // picked up, before the callback runs.
+            if (serve)
+                task->_served->set();
 
             if (_Py_IsFinalizing())
                 break;
 
-            if (PeriodicThread__periodic(self)) {
-                // Error
-                error = true;
-                break;
+            if (PeriodicThread__periodic(task)) {
+                // The callback raised; retire the task without running the
+                // shutdown callback.
+                {
+                    std::lock_guard<std::mutex> lock(sched_mutex);
+                    auto it = std::find(sched_tasks.begin(), sched_tasks.end(), task);
+                    if (it != sched_tasks.end())
+                        sched_tasks.erase(it);
+                }
+                scheduler_retire(task, /* error */ true);
+                continue;
             }
+
+            std::lock_guard<std::mutex> lock(sched_mutex);
+            task->_deadline = PeriodicThread__next_deadline(task);
         }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Start the scheduler thread if it is not running in this process. Called
+// with the GIL held, which serializes access to the scheduler start state.
+static void
+scheduler_ensure_started()
+{
+    if (sched_running && sched_pid == getpid())
+        return;
+
+    // First use, or first use in a child process after a fork. Any tasks
+    // inherited from the parent belong to the dead parent scheduler; forget
+    // them without touching their reference counts, trading a rare leak for
+    // not running their callbacks again, as the per-thread implementation
+    // this replaces did.
+    if (sched_pid != 0) {
+        // The parent's scheduler thread was likely parked on sched_cond (and
+        // holding sched_mutex internals) at fork time, so the primitives were
+        // inherited with another thread's state baked in; the first notify on
+        // the stale condition variable can block forever. Only this thread
+        // exists in the child at this point, so reconstruct them in place.
+        new (&sched_mutex) std::mutex();
+        new (&sched_cond) std::condition_variable();
+    }
+    sched_tasks.clear();
+    sched_ready.clear();
+
+    sched_pid = getpid();
+    sched_running = true;
+
+    // Detach the thread. It parks when it has no tasks and is reclaimed at
+    // process exit.
+    std::thread scheduler(scheduler_loop);
+    sched_native_id = scheduler.get_id();
+    scheduler.detach();
+
+    // Wait for the scheduler to register with the interpreter.
+    AllowThreads _;
+
+    sched_ready.wait();
+}
+
+// ----------------------------------------------------------------------------
+static PyObject*
+PeriodicThread_start(PeriodicThread* self, PyObject* args)
+{
+    if (self->_started) {
+        PyErr_SetString(PyExc_RuntimeError, "Thread already started");
+        return NULL;
+    }
+
+    if (self->_stopping)
+        Py_RETURN_NONE;
+
+    scheduler_ensure_started();
 
-        // Run the shutdown callback if there was no error and we are not
-        // at Python shutdown.
-        if (!self->_atexit && !error && self->_on_shutdown != Py_None && !_Py_IsFinalizing())
-            PeriodicThread__on_shutdown(self);
+    self->_started = true;
 
-        // Notify the join method that the thread has stopped
-        self->_stopped->set();
-    });
+    // All periodic tasks run on the scheduler thread, so they all report its
+    // thread ID.
+    Py_DECREF(self->ident);
+    self->ident = PyLong_FromUnsignedLong(sched_thread_id);
 
-    // Detach the thread. We will make our own joinable mechanism.
-    self->_thread->detach();
+    // Map the PeriodicThread object by identity
+    PyObject* key = PyLong_FromVoidPtr(self);
+    if (key == NULL)
+        return NULL;
+    PyDict_SetItem(_periodic_threads, key, (PyObject*)self);
+    Py_DECREF(key);
 
-    // Wait for the thread to start
+    // The scheduler holds a strong reference to the task until it retires it.
+    Py_INCREF(self);
     {
-        AllowThreads _;
+        std::lock_guard<std::mutex> lock(sched_mutex);
 
-        self->_started->wait();
+        self->_awake_pending = false;
+        self->_deadline = PeriodicThread__next_deadline(self);
+        sched_tasks.push_back(self);
     }
+    sched_cond.notify_all();
 
     Py_RETURN_NONE;
 }
@@ -302,20 +589,34 @@ PeriodicThread_start(PeriodicThread* self, PyObject* args)
 static PyObject*
 PeriodicThread_awake(PeriodicThread* self, PyObject* args)
 {
-    if (self->_thread == nullptr) {
+    if (!self->_started) {
         PyErr_SetString(PyExc_RuntimeError, "Thread not started");
         return NULL;
     }
 
-    if (!self->_after_fork) {
-        AllowThreads _;
-        std::lock_guard<std::mutex> lock(*self->_awake_mutex);
+    if (self->_after_fork)
+        Py_RETURN_NONE;
 
-        self->_served->clear();
-        self->_request->set();
-        self->_served->wait();
+    if (std::this_thread::get_id() == sched_native_id) {
+        // We are on the scheduler thread, inside a periodic callback that
+        // awoke another task. Waiting for the scheduler to serve the request
+        // would deadlock, so run the callback inline instead.
+        if (!self->_stopping && !self->_error)
+            PeriodicThread__periodic(self);
+        Py_RETURN_NONE;
     }
 
+    AllowThreads _;
+    std::lock_guard<std::mutex> lock(*self->_awake_mutex);
+
+    self->_served->clear();
+    {
+        std::lock_guard<std::mutex> sched_lock(sched_mutex);
+        self->_awake_pending = true;
+    }
+    sched_cond.notify_all();
+    self->_served->wait();
+
     Py_RETURN_NONE;
 }
 
@@ -323,13 +624,16 @@ PeriodicThread_awake(PeriodicThread* self, PyObject* args)
 static PyObject*
 PeriodicThread_stop(PeriodicThread* self, PyObject* args)
 {
-    if (self->_thread == nullptr) {
+    if (!self->_started) {
         PyErr_SetString(PyExc_RuntimeError, "Thread not started");
         return NULL;
     }
 
-    self->_stopping = true;
-    self->_request->set();
+    {
+        std::lock_guard<std::mutex> lock(sched_mutex);
+        self->_stopping = true;
+    }
+    sched_cond.notify_all();
 
     Py_RETURN_NONE;
 }
@@ -338,12 +642,12 @@ PeriodicThread_stop(PeriodicThread* self, PyObject* args)
 static PyObject*
 PeriodicThread_join(PeriodicThread* self, PyObject* args, PyObject* kwargs)
 {
-    if (self->_thread == nullptr) {
+    if (!self->_started) {
         PyErr_SetString(PyExc_RuntimeError, "Periodic thread not started");
         return NULL;
     }
 
-    if (self->_thread->get_id() == std::this_thread::get_id()) {
+    if (std::this_thread::get_id() == sched_native_id) {
         PyErr_SetString(PyExc_RuntimeError, "Cannot join the current periodic thread");
         return NULL;
     }
@@ -415,22 +719,20 @@ PeriodicThread__after_fork(PeriodicThread* self, PyObject* args)
 static void
 PeriodicThread_dealloc(PeriodicThread* self)
 {
-    // Since the native thread holds a strong reference to this object, we
-    // can only get here if the thread has actually stopped.
+    // Since the scheduler holds a strong reference to this object while it
+    // is registered, we can only get here once the task has been retired.
 
     if (_Py_IsFinalizing())
         // Do nothing. We are about to terminate and release resources anyway.
         return;
 
-    // If we are trying to stop from the same thread, then we are still running.
-    // This should happen rarely, so we don't worry about the memory leak this
-    // will cause.
-    if (self->_thread != NULL && self->_thread->get_id() == std::this_thread::get_id())
-        return;
-
     // Unmap the PeriodicThread
-    if (self->ident != NULL && PyDict_Contains(_periodic_threads, self->ident))
-        PyDict_DelItem(_periodic_threads, self->ident);
+    PyObject* key = PyLong_FromVoidPtr(self);
+    if (key != NULL) {
+        if (PyDict_Contains(_periodic_threads, key))
+            PyDict_DelItem(_periodic_threads, key);
+        Py_DECREF(key);
+    }
 
     Py_XDECREF(self->name);
     Py_XDECREF(self->_target);
@@ -439,11 +741,7 @@ PeriodicThread_dealloc(PeriodicThread* self)
     Py_XDECREF(self->ident);
     Py_XDECREF(self->_ddtrace_profiling_ignore);
 
-    self->_thread = nullptr;
-
-    self->_started = nullptr;
     self->_stopped = nullptr;
-    self->_request = nullptr;
     self->_served = nullptr;
 
     self->_awake_mutex = nullptr;
@@ -470,15 +768,115 @@ static PyTypeObject PeriodicThreadType = {
     .tp_itemsize = 0,
     .tp_dealloc = (destructor)PeriodicThread_dealloc,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-    .tp_doc = PyDoc_STR("Native thread calling a Python function periodically"),
+    .tp_doc = PyDoc_STR("Python function called periodically on a shared native thread"),
     .tp_methods = PeriodicThread_methods,
     .tp_members = PeriodicThread_members,
     .tp_init = (initproc)PeriodicThread_init,
     .tp_new = PyType_GenericNew,
 };
 
+// ----------------------------------------------------------------------------
+// Coordinated shutdown of every registered periodic thread. Stopping tasks
+// one by one from Python serializes the waits: each join can sit behind the
+// callback the scheduler is currently running. Here all tasks are marked
+// stopping under one lock with a single wakeup, so the scheduler retires the
+// whole batch in one pass, and the stop events are then waited on against a
+// single shared deadline. Total latency is bounded by the slowest callback in
+// flight plus the deadline as a backstop; tasks still running when the
+// deadline expires are abandoned to the (detached) scheduler thread.
+// This is the interpreter-exit path, so the tasks are marked _atexit and
+// their shutdown callbacks are not run, as with PeriodicThread._atexit().
+static PyObject*
+_threads_shutdown(PyObject* Py_UNUSED(module), PyObject* args, PyObject* kwargs)
+{
+    static const char* argnames[] = { "timeout", NULL };
+
+    PyObject* timeout = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", (char**)argnames, &timeout))
+        return NULL;
+
+    double timeout_value = -1.0;
+
+    if (timeout != Py_None) {
+        if (PyFloat_Check(timeout)) {
+            timeout_value = PyFloat_AsDouble(timeout);
+        } else if (PyLong_Check(timeout)) {
+            timeout_value = PyLong_AsDouble(timeout);
+        } else {
+            PyErr_SetString(PyExc_TypeError, "timeout must be a float or an int");
+            return NULL;
+        }
+    }
+
+    if (std::this_thread::get_id() == sched_native_id) {
+        PyErr_SetString(PyExc_RuntimeError, "Cannot shut down periodic threads from a periodic thread");
+        return NULL;
+    }
+
+    // Snapshot the registered threads with strong references; retirement
+    // shrinks the mapping as entries are deallocated.
+    std::vector<PeriodicThread*> tasks;
+    {
+        PyObject* key;
+        PyObject* value;
+        Py_ssize_t pos = 0;
+
+        while (PyDict_Next(_periodic_threads, &pos, &key, &value)) {
+            PeriodicThread* task = (PeriodicThread*)value;
+
+            if (!task->_started || task->_after_fork)
+                continue;
+
+            Py_INCREF(task);
+            tasks.push_back(task);
+        }
+    }
+
+    // Signal every task first, then wake the scheduler once for the batch.
+    {
+        std::lock_guard<std::mutex> lock(sched_mutex);
+
+        for (PeriodicThread* task : tasks) {
+            task->_atexit = true;
+            task->_stopping = true;
+        }
+    }
+    sched_cond.notify_all();
+
+    {
+        AllowThreads _;
+
+        if (timeout_value < 0) {
+            for (PeriodicThread* task : tasks)
+                task->_stopped->wait();
+        } else {
+            auto deadline =
+              std::chrono::steady_clock::now() + std::chrono::milliseconds((long long)(timeout_value * 1000));
+
+            for (PeriodicThread* task : tasks) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= deadline)
+                    // Deadline expired; abandon this task and the rest.
+                    break;
+
+                task->_stopped->wait(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+            }
+        }
+    }
+
+    for (PeriodicThread* task : tasks)
+        Py_DECREF(task);
+
+    Py_RETURN_NONE;
+}
+
 // ----------------------------------------------------------------------------
 static PyMethodDef _threads_methods[] = {
+    { "shutdown",
+      (PyCFunction)_threads_shutdown,
+      METH_VARARGS | METH_KEYWORDS,
+      "Stop all periodic threads and wait for them against a shared deadline" },
     { NULL, NULL, 0, NULL } /* Sentinel */
 };
 
@@ -19,4 +19,6 @@ class PeriodicThread:
     def _atexit(self) -> None: ...
     def _after_fork(self) -> None: ...
 
+# Keyed by object identity, not thread id: all periodic tasks share one
+# native thread, so the thread id cannot be used as the key.
 periodic_threads: t.Dict[int, PeriodicThread]
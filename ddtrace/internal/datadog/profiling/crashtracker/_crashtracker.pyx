@@ -36,6 +36,7 @@ cdef extern from "crashtracker_interface.hpp":
     void crashtracker_set_resolve_frames_safe()
     bint crashtracker_set_receiver_binary_path(string_view path)
     void crashtracker_set_tag(string_view key, string_view value)
+    bint crashtracker_reconfigure()
     void crashtracker_profiling_state_sampling_start()
     void crashtracker_profiling_state_sampling_stop()
     void crashtracker_profiling_state_unwinding_start()
@@ -150,6 +151,13 @@ def set_tag(key: StringType, value: StringType) -> None:
     )
 
 
+def reconfigure() -> bool:
+    # Applies any set_* changes made since start() to the running crashtracker in place.
+    # Much cheaper than a restart: no receiver re-resolution, no signal handler changes.
+    # Returns False if the crashtracker was never started (or the update failed).
+    return crashtracker_reconfigure()
+
+
 def start() -> bool:
     crashtracker_filename_raw = crashtracker_get_exe_name()
     crashtracker_filename = crashtracker_filename_raw.decode("utf-8")
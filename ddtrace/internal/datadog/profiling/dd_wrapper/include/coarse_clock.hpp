@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <ctime>
+#endif
+
+namespace Datadog {
+
+// Coarse monotonic clock for accuracy-insensitive consumers.
+//
+// The kernel already maintains exactly the cached timestamp a user-space
+// clock service would: CLOCK_MONOTONIC_COARSE is CLOCK_MONOTONIC as of the
+// last scheduler tick, read through the vDSO without the cycle-counter read
+// and scaling the precise clock pays. Reads cost a few nanoseconds at the
+// price of tick resolution (1-4 ms, HZ-dependent). Consumers that schedule
+// or attribute time at millisecond granularity (periodic task deadlines,
+// per-pass sample timestamps) belong here; anything measuring
+// sub-millisecond durations stays on the precise clock.
+//
+// Both readers fall back to the precise clock where no coarse clock exists,
+// so they are always safe to call: they only trade accuracy for cost on
+// platforms where that trade is real.
+
+// Nanoseconds on the CLOCK_MONOTONIC timeline, coarse where available.
+// CLOCK_MONOTONIC_COARSE shares CLOCK_MONOTONIC's epoch, so readings mix
+// with precise ones, lagging them by at most one tick.
+inline int64_t
+coarse_monotonic_ns()
+{
+#ifndef _WIN32
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec coarse_ts;
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &coarse_ts) == 0) {
+        return static_cast<int64_t>(coarse_ts.tv_sec) * 1'000'000'000LL + static_cast<int64_t>(coarse_ts.tv_nsec);
+    }
+#endif
+    timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000LL + static_cast<int64_t>(ts.tv_nsec);
+    }
+    return 0;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// Coarse reading expressed on std::chrono::steady_clock's timeline, for
+// chrono deadline math. On Linux, steady_clock is CLOCK_MONOTONIC, which
+// CLOCK_MONOTONIC_COARSE lags by at most one tick: a deadline computed from
+// this and waited on with the precise clock fires up to one tick early,
+// never late.
+inline std::chrono::steady_clock::time_point
+coarse_steady_now()
+{
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+        const auto d = std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+        return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(d));
+    }
+#endif
+    return std::chrono::steady_clock::now();
+}
+
+} // namespace Datadog
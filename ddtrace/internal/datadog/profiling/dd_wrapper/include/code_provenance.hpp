@@ -1,9 +1,10 @@
 #pragma once
 
+#include "path_trie.hpp"
+
 #include <atomic>
 #include <memory>
 #include <mutex>
-#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
@@ -42,7 +43,19 @@ class CodeProvenance
     void set_stdlib_path(std::string_view stdlib_path);
     void add_packages(std::unordered_map<std::string_view, std::string_view> packages);
     void add_filename(std::string_view filename);
-    std::optional<std::string> try_serialize_to_json_str();
+    // Returns the cached JSON buffer unchanged when the package/file set has
+    // not moved since the last call; only a change re-encodes.  The returned
+    // buffer is shared, not copied, so exports don't pay for the ~2000
+    // distributions a large service can accumulate.
+    std::shared_ptr<const std::string> try_serialize_to_json_str();
+
+    // Classifies a path ("stdlib", a registered distribution name, or nullptr
+    // for anything unclassifiable) via the path trie; the returned pointer is
+    // interned (it aliases a Package name owned by the singleton) and stays
+    // valid for the life of the process, so callers can compare or keep it
+    // without copying.  Shared entry point for per-frame provenance labels and
+    // frame filtering outside the profiler.
+    const char* classify_path(std::string_view path);
 
   private:
     // Mutex to protect the state
@@ -55,13 +68,26 @@ class CodeProvenance
     std::unordered_map<std::string_view, std::unique_ptr<Package>> packages;
     // Mapping from Package object to list of filenames that are associated with the package
     std::unordered_map<const Package*, std::set<std::string>> packages_to_files;
+    // Serialized form of the state above; regenerated lazily when dirty
+    std::shared_ptr<const std::string> cached_json;
+    bool dirty{ true };
+
+    // Longest-prefix classification of frame filenames, populated lazily: the
+    // first file seen under a directory pays the "site-packages/" scan, then
+    // the directory (or the site-packages/<pkg> prefix) is interned so every
+    // later frame from the same tree resolves in O(path components).  Guarded
+    // by mtx, like the maps its values point into.
+    PathPrefixTrie<const Package*> path_trie;
+    static inline Package stdlib_package{ STDLIB, "" };
 
     // Private Constructor/Destructor to prevent instantiation/deletion from outside
     CodeProvenance() = default;
     ~CodeProvenance() = default;
 
     void reset();
-    std::string_view get_package_name(std::string_view filename);
+    // Trie-first classification; requires mtx held.  Returns &stdlib_package,
+    // a registered package, or nullptr (unregistered or unparseable path).
+    const Package* classify_locked(std::string_view filename);
     const Package* add_new_package(std::string_view package_name, std::string_view version);
 };
 }
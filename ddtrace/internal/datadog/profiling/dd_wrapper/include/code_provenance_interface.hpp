@@ -12,6 +12,11 @@ extern "C"
     void code_provenance_set_runtime_version(std::string_view runtime_version);
     void code_provenance_set_stdlib_path(std::string_view stdlib_path);
     void code_provenance_add_packages(std::unordered_map<std::string_view, std::string_view> packages);
+    // Longest-prefix classification of a frame filename: "stdlib", a
+    // registered distribution name, or nullptr.  The pointer is interned and
+    // process-lifetime stable, so callers (per-frame provenance labels, frame
+    // filtering in other products) can hold or compare it without copying.
+    const char* code_provenance_classify_path(std::string_view path);
 
 #ifdef __cplusplus
 } // extern "C"
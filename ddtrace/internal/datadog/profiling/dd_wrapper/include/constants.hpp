@@ -17,6 +17,57 @@ constexpr uint64_t g_crashtracker_timeout_secs = 5;
 // Default value for the max number of samples to keep in the SynchronizedSamplePool
 constexpr size_t g_default_sample_pool_capacity = 4;
 
+// The sample pool adapts between its configured capacity and this multiple of
+// it, growing after observed exhaustion and shrinking after quiet windows
+constexpr size_t g_sample_pool_max_growth_factor = 16;
+
+// Maximum number of encoded profiles queued for the exporter thread before
+// the oldest payload is dropped (drop-oldest backpressure for a slow agent)
+constexpr size_t g_upload_queue_depth = 4;
+
+// Bounded retry for failed network uploads (routine agent restarts lose whole
+// 60s windows otherwise): re-send attempts per payload, the base backoff
+// (doubled per attempt, jittered), and how many failed payloads may wait for
+// retry at once -- kept small because a waiting payload holds its raw
+// serialized profile, not just compressed bytes
+constexpr uint32_t g_upload_retry_max_attempts = 3;
+constexpr uint64_t g_upload_retry_base_ms = 1000;
+constexpr size_t g_upload_retry_queue_depth = 2;
+
+// Bytes reserved per Sample for transient label strings (thread/task/class
+// names); oversized strings spill to the interned table instead
+constexpr size_t g_sample_string_arena_capacity = 4096;
+
+// Minimum spacing between emitted error messages on hot paths (LogRateLimiter);
+// a failure storm degrades to one line per interval instead of one per sample
+constexpr int64_t g_error_log_interval_ns = 1'000'000'000;
+
+// Bounded waits used when fork or interpreter exit must not hang on a slow
+// agent: how long prefork waits for a cancelled send to release the upload
+// lock, and how long shutdown lets queued payloads drain before cancelling
+constexpr uint64_t g_upload_cancel_grace_ms = 250;
+constexpr uint64_t g_upload_shutdown_grace_ms = 1000;
+
+// Upper bound on recycled aggregation entries kept across upload cycles; the
+// steady-state working set is the number of distinct stacks per window, so
+// this mostly guards against one pathological window pinning memory forever
+constexpr size_t g_aggregation_freelist_max = 4096;
+
+// Upload cycles a persistent (delta-exported) aggregation entry may sit with
+// no new samples before it is retired. Recurring stacks keep their warm entry
+// across cycles; stacks that stop appearing are reclaimed after this many
+// idle cycles.
+constexpr uint32_t g_delta_retire_cycles = 8;
+
+// Timeline timestamps are quantized to this granularity so samples within the
+// same window collapse to one pprof entry; 10ms trades sub-millisecond
+// resolution for a large cut in serialized profile size
+constexpr int64_t g_default_timeline_granularity_ns = 10'000'000;
+
+// Default window size for the ring-file export target (see ring_file.hpp):
+// enough for a few hours of typical profiles, bounded and known up front
+constexpr uint64_t g_ringfile_default_capacity = 8 * 1024 * 1024;
+
 // Default name of the runtime.  This will almost certainly get overridden by the caller, but we set it here
 // as a reasonable default just in case.
 constexpr std::string_view g_runtime_name = "CPython";
@@ -27,6 +78,13 @@ constexpr std::string_view g_language_name = "python";
 // Name of the library
 constexpr std::string_view g_library_name = "dd-trace-py";
 
+// Default size of the preallocated alternate signal stack for the crash handler:
+// mmap'd, pre-faulted and (best effort) locked at start() so the handler never
+// allocates or page-faults while the process is in whatever state caused the
+// crash. 64 KiB comfortably covers the collector plus signal frames on every
+// supported platform; overridable through crashtracker_set_alt_stack_size.
+constexpr uint64_t g_crashtracker_altstack_size = 64 * 1024;
+
 // These are default settings for crashtracker tags.  These will be moved internally to crashtracker in the near future.
 constexpr std::string_view g_crashtracker_is_crash = "true";
 constexpr std::string_view g_crashtracker_severity = "crash";
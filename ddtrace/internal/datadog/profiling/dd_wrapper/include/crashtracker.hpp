@@ -7,6 +7,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <sys/types.h>
 #include <unordered_map>
 
 #include "datadog/crashtracker.h"
@@ -39,6 +40,25 @@ class Crashtracker
     ddog_crasht_StacktraceCollection resolve_frames = DDOG_CRASHT_STACKTRACE_COLLECTION_WITHOUT_SYMBOLS;
     uint64_t timeout_secs = g_crashtracker_timeout_secs;
 
+    // When the receiver could be pre-spawned at start(), this is the unix socket it listens on;
+    // empty means we fell back to the crash-time fork/exec path.
+    std::string receiver_socket_path;
+    pid_t receiver_pid = -1;
+
+    // Preallocated alternate signal stack (guard page + usable pages), mapped at start().
+    // Pre-faulted and best-effort mlock'd so the handler runs on memory that is already
+    // resident -- under OOM a page fault inside the handler is as fatal as the crash itself.
+    // When installed, libdatadog is told not to allocate its own alt stack.
+    void* alt_stack_mapping = nullptr;
+    size_t alt_stack_mapping_size = 0;
+    uint64_t alt_stack_size = g_crashtracker_altstack_size;
+
+    // Monotonic version of the locally-stored config/metadata.  Setters bump it; a
+    // successful reconfigure() records the version it pushed, so redundant refreshes
+    // (e.g. a config poller that found nothing new) skip the re-serialization entirely.
+    std::atomic<uint64_t> pending_generation{ 0 };
+    uint64_t applied_generation = 0;
+
     ProfilingState profiling_state;
 
     std::string env;
@@ -61,6 +81,19 @@ class Crashtracker
     ddog_crasht_Metadata get_metadata(ddog_Vec_Tag& tags);
     ddog_crasht_ReceiverConfig get_receiver_config();
 
+    // Fork/exec the receiver binary up-front, listening on a unix socket.  Doing this at start()
+    // rather than at crash time means the signal handler only has to write to an already-open fd,
+    // which matters because fork/exec is exactly the kind of work that fails under OOM.
+    bool spawn_receiver();
+
+    // Map, pre-fault and install the alternate signal stack described above.  Returns true when
+    // installed (start() then clears create_alt_stack in the libdatadog config).
+    bool setup_alt_stack();
+
+    // Re-dirty (and re-lock) the alt stack pages in a forked child: the mapping is inherited
+    // copy-on-write, and breaking the COW at crash time is an allocation we must not depend on.
+    void refault_alt_stack();
+
   public:
     // Setters
     void set_env(std::string_view _env);
@@ -75,6 +108,7 @@ class Crashtracker
     void set_wait_for_receiver(bool _wait);
 
     void set_create_alt_stack(bool _create_alt_stack);
+    void set_alt_stack_size(uint64_t _alt_stack_size);
     void set_stderr_filename(std::string_view _stderr_filename);
     void set_stdout_filename(std::string_view _stdout_filename);
     bool set_receiver_binary_path(std::string_view _path_to_receiver_binary);
@@ -85,6 +119,11 @@ class Crashtracker
     bool start();
     bool atfork_child();
 
+    // Push accumulated setter changes (tags, endpoint, runtime-id, ...) into the live
+    // crash handler without tearing it down: libdatadog swaps its config and metadata
+    // atomically, so this never re-resolves the receiver or re-installs signal handlers.
+    bool reconfigure();
+
     // State transition
     void sampling_start();
     void sampling_stop();
@@ -14,6 +14,43 @@ class Sample;
 extern "C"
 {
 #endif
+    // Plain-data descriptions of a complete sample, so collectors that already know the whole
+    // sample up-front (stack, lock) can cross the extension boundary once per sampling round
+    // via ddup_push_batch instead of once per ddup_push_* call
+    struct ddup_FrameSpec
+    {
+        std::string_view name;
+        std::string_view filename;
+        uint64_t address;
+        int64_t line;
+    };
+
+    // Zero/empty fields are simply not pushed, mirroring how the per-call API is used
+    struct ddup_SampleSpec
+    {
+        int64_t walltime;
+        int64_t cputime;
+        int64_t count;
+        int64_t thread_id;
+        int64_t thread_native_id;
+        std::string_view thread_name;
+        int64_t task_id;
+        std::string_view task_name;
+        uint64_t span_id;
+        uint64_t local_root_span_id;
+        std::string_view trace_type;
+        std::string_view exception_type;
+        int64_t exception_count;
+        std::string_view class_name;
+        std::string_view lock_name;
+        int64_t lock_acquire_time;
+        int64_t lock_release_time;
+        int64_t monotonic_ns;
+        const ddup_FrameSpec* frames;
+        size_t nframes;
+        bool reverse_locations;
+    };
+
     void ddup_config_env(std::string_view dd_env);
     void ddup_config_service(std::string_view service);
     void ddup_config_version(std::string_view version);
@@ -23,8 +60,21 @@ extern "C"
     void ddup_config_url(std::string_view url);
     void ddup_config_max_nframes(int max_nframes);
     void ddup_config_timeline(bool enable);
+    void ddup_config_timeline_granularity_ns(int64_t granularity_ns);
     void ddup_config_output_filename(std::string_view filename);
+    // Flight-recorder mode: sealed profiles are appended to a fixed-size
+    // memory-mapped ring file (last-N-minutes retention) instead of being
+    // uploaded; capacity 0 keeps the default window (see ring_file.hpp)
+    void ddup_config_output_ringfile(std::string_view filename, uint64_t capacity);
     void ddup_config_sample_pool_capacity(uint64_t capacity);
+    // Registers a known-hot string (framework dispatch frames and the like)
+    // to be interned up front at ddup_start
+    void ddup_config_prewarm_string(std::string_view str);
+    // Scheduling attributes for the native helper threads (sampler, flush,
+    // upload): niceness and an optional cpuset to confine them to, so
+    // profiler overhead can be kept off latency-critical cores
+    void ddup_config_helper_thread_niceness(int niceness);
+    void ddup_config_helper_thread_cpu_affinity(const int* cpus, size_t ncpus);
 
     void ddup_config_user_tag(std::string_view key, std::string_view val);
     void ddup_config_sample_type(unsigned int type);
@@ -34,8 +84,42 @@ extern "C"
     void ddup_set_runtime_id(std::string_view runtime_id);
     void ddup_profile_set_endpoints(std::map<int64_t, std::string_view> span_ids_to_endpoints);
     void ddup_profile_add_endpoint_counts(std::map<std::string_view, int64_t> trace_endpoints_to_counts);
+
+    // Flat variants of the endpoint APIs: the caller fills one contiguous
+    // array (reservable up front on the Cython side) instead of building a
+    // std::map node by node, and registration is a single pass under one
+    // profile borrow
+    struct ddup_EndpointSpec
+    {
+        int64_t span_id;
+        std::string_view endpoint;
+    };
+    struct ddup_EndpointCountSpec
+    {
+        std::string_view endpoint;
+        int64_t count;
+    };
+    void ddup_profile_set_endpoints_batch(const ddup_EndpointSpec* specs, size_t nspecs);
+    void ddup_profile_add_endpoint_counts_batch(const ddup_EndpointCountSpec* specs, size_t nspecs);
     bool ddup_upload();
 
+    // Sample pool health: cumulative counts of takes that fell back to the
+    // heap (exhaustion) and returns dropped on a full pool (overflow), plus
+    // the pool's current (adaptive) capacity
+    uint64_t ddup_get_sample_pool_exhaustion_count();
+    uint64_t ddup_get_sample_pool_overflow_count();
+    uint64_t ddup_get_sample_pool_capacity();
+
+    // One-call snapshot of every counter registered in the shared native
+    // telemetry registry (see telemetry_counters.hpp); returns how many
+    // entries were written
+    struct ddup_CounterEntry
+    {
+        const char* name;
+        uint64_t value;
+    };
+    size_t ddup_counter_snapshot(ddup_CounterEntry* entries, size_t max_entries);
+
     // Proxy functions to the underlying sample
     Datadog::Sample* ddup_start_sample();
     void ddup_push_walltime(Datadog::Sample* sample, int64_t walltime, int64_t count);
@@ -43,6 +127,7 @@ extern "C"
     void ddup_push_acquire(Datadog::Sample* sample, int64_t acquire_time, int64_t count);
     void ddup_push_release(Datadog::Sample* sample, int64_t release_time, int64_t count);
     void ddup_push_alloc(Datadog::Sample* sample, int64_t size, int64_t count);
+    void ddup_push_gil_wait(Datadog::Sample* sample, int64_t wait_time, int64_t count);
     void ddup_push_heap(Datadog::Sample* sample, int64_t size);
     void ddup_push_lock_name(Datadog::Sample* sample, std::string_view lock_name);
     void ddup_push_threadinfo(Datadog::Sample* sample,
@@ -51,6 +136,24 @@ extern "C"
                               std::string_view thread_name);
     void ddup_push_task_id(Datadog::Sample* sample, int64_t task_id);
     void ddup_push_task_name(Datadog::Sample* sample, std::string_view task_name);
+    // Handle-based pushes for repeated metadata: intern the string once, then
+    // push the returned id per sample with no per-sample string traffic
+    uint64_t ddup_intern_string(std::string_view str);
+    void ddup_push_threadinfo_id(Datadog::Sample* sample,
+                                 int64_t thread_id,
+                                 int64_t thread_native_id,
+                                 uint64_t thread_name_id);
+    void ddup_push_task_name_id(Datadog::Sample* sample, uint64_t task_name_id);
+    void ddup_push_trace_type_id(Datadog::Sample* sample, uint64_t trace_type_id);
+    void ddup_push_exceptioninfo_id(Datadog::Sample* sample, uint64_t exception_type_id, int64_t count);
+    // Label-set handles: build the labels of a recurring thread/task/span
+    // context once, then attach the whole set to each sample with one call.
+    // Keys take ExportLabelKey values (see types.hpp); out-of-range keys and
+    // ids are ignored.
+    uint64_t ddup_labelset_new();
+    void ddup_labelset_add_str(uint64_t labelset_id, unsigned int key, std::string_view val);
+    void ddup_labelset_add_num(uint64_t labelset_id, unsigned int key, int64_t val);
+    void ddup_push_labelset(Datadog::Sample* sample, uint64_t labelset_id);
     void ddup_push_span_id(Datadog::Sample* sample, uint64_t span_id);
     void ddup_push_local_root_span_id(Datadog::Sample* sample, uint64_t local_root_span_id);
     void ddup_push_trace_type(Datadog::Sample* sample, std::string_view trace_type);
@@ -62,6 +165,8 @@ extern "C"
                          uint64_t address,
                          int64_t line);
     void ddup_push_monotonic_ns(Datadog::Sample* sample, int64_t monotonic_ns);
+    // Submit a whole batch of fully-described samples in one boundary crossing
+    void ddup_push_batch(const ddup_SampleSpec* specs, size_t nspecs);
     void ddup_flush_sample(Datadog::Sample* sample);
     // Stack v2 specific flush, which reverses the locations
     void ddup_flush_sample_v2(Datadog::Sample* sample);
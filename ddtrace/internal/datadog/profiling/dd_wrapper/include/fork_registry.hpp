@@ -0,0 +1,50 @@
+#pragma once
+
+namespace Datadog {
+
+// Ordered fork-handler registry shared by the native extensions.
+//
+// Each extension used to install its own pthread_atfork() handlers, which
+// left the post-fork execution order at the mercy of module import order and
+// made deadlocks between, say, the uploader and sampler handlers possible.
+// The registry installs a single set of pthread_atfork() handlers and runs
+// registered callbacks in declared phases, so the relative order of the
+// cross-extension fork work is explicit:
+//
+//   prefork         phases run in order; quiesce producers and take any locks
+//                   that must not be held mid-fork
+//   postfork parent phases run in order; release what prefork took
+//   postfork child  phases run in order: StopThreads, then ResetState, then
+//                   Restart
+//
+// Within a phase, handlers run in registration order. Registration is
+// idempotent per callback set, so one-time-start patterns that may run again
+// after a fork do not double-register.
+class ForkRegistry
+{
+  public:
+    enum class Phase
+    {
+        StopThreads, // quiesce worker threads and block new work
+        ResetState,  // drop or reinitialize state torn by the fork
+        Restart,     // relaunch workers and re-arm services in the child
+    };
+
+    struct Handlers
+    {
+        void (*prefork)() = nullptr;
+        void (*postfork_parent)() = nullptr;
+        void (*postfork_child)() = nullptr;
+    };
+
+    // Registers a callback set into the given phase and installs the process
+    // pthread_atfork() hooks on first use. Safe to call from any thread.
+    static void register_handlers(Phase phase, const Handlers& handlers);
+
+  private:
+    static void run_prefork();
+    static void run_postfork_parent();
+    static void run_postfork_child();
+};
+
+} // namespace Datadog
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Datadog {
+namespace HelperThreads {
+
+// Scheduling attributes for the native helper threads the library spawns
+// (sampler, flush, upload).  By default these run at normal priority on any
+// core and compete with request threads; on CPU-pinned deployments the
+// profiler's overhead can instead be confined to leftover cores by lowering
+// the helpers' priority and restricting their cpuset.
+//
+// Configuration happens once from Python (ddup_config_* before ddup_start);
+// each helper thread applies the attributes to itself at the top of its
+// thread body.  Everything is best-effort: naming and self-deprioritization
+// need no privileges, and a failed sched_setaffinity (e.g. a cpu outside the
+// container's cpuset) silently leaves the default placement.
+
+// Sentinel for "no niceness configured"; valid niceness is -20..19
+constexpr int no_niceness = -128;
+
+void set_niceness(int niceness);
+void set_cpu_affinity(const int* cpus, size_t ncpus);
+
+// Called from the helper thread itself.  Names the thread (truncated to the
+// platform limit) and applies the configured niceness and cpuset.  When no
+// niceness was configured, default_niceness is used instead; pass no_niceness
+// to leave the priority alone.
+void apply_attributes(const char* name, int default_niceness = no_niceness);
+
+} // namespace HelperThreads
+} // namespace Datadog
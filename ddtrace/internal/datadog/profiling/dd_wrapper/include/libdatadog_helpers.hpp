@@ -1,6 +1,10 @@
 #pragma once
 
+#include "constants.hpp"
+
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -92,6 +96,30 @@ err_to_msg(const ddog_Error* err, std::string_view msg)
     return std::string{ msg } + " (" + err_msg.assign(ddog_err.ptr, ddog_err.ptr + ddog_err.len) + ")";
 }
 
+// Hot paths report failures as codes/counters and gate any textual logging on
+// should_log(), so formatting (err_to_msg allocates) and IO only happen once
+// per interval: a failure storm (agent down, exhausted pool) degrades to one
+// line per second instead of allocating and logging at sample rate.
+class LogRateLimiter
+{
+  private:
+    std::atomic<int64_t> next_log_ns{ 0 };
+
+  public:
+    bool should_log()
+    {
+        const int64_t now_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+        int64_t next = next_log_ns.load(std::memory_order_relaxed);
+        if (now_ns < next) {
+            return false;
+        }
+        // One thread wins the slot for this interval; the rest stay quiet
+        return next_log_ns.compare_exchange_strong(next, now_ns + g_error_log_interval_ns, std::memory_order_relaxed);
+    }
+};
+
 inline std::string_view
 to_string(ExportTagKey key)
 {
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Datadog {
+
+// Component-wise path-prefix trie: prefixes registered with insert() classify
+// a full path by longest-prefix match in O(path components), with no substring
+// scans over the whole path.  Values are small copyable labels (interned
+// pointers, enums); a deeper insertion shadows a coarser one, which is how
+// "site-packages/<pkg>" entries override the interpreter prefix they live
+// under.  Shared by code provenance (frame-to-package classification) and
+// usable by any other consumer that needs fast path labeling.
+//
+// Children are kept in a std::map with a transparent comparator so lookups
+// run on string_views without allocating (the unordered containers don't get
+// heterogeneous lookup until gcc-10, same constraint as profile.hpp);
+// fan-out per directory level is small, so the tree beats hashing here anyway.
+//
+// Not internally synchronized; callers guard it with whatever lock protects
+// the data the values point into.
+template<typename Value>
+class PathPrefixTrie
+{
+  private:
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+        std::optional<Value> value;
+    };
+    Node root;
+
+  public:
+    struct Match
+    {
+        Value value;
+        // Bytes of the input covered by the matched prefix, so the caller can
+        // inspect the unmatched remainder
+        size_t prefix_length;
+    };
+
+    void insert(std::string_view prefix, Value value)
+    {
+        Node* node = &root;
+        size_t start = 0;
+        while (start < prefix.size()) {
+            size_t end = prefix.find('/', start);
+            if (end == std::string_view::npos) {
+                end = prefix.size();
+            }
+            if (end > start) {
+                const std::string_view component = prefix.substr(start, end - start);
+                auto it = node->children.find(component);
+                if (it == node->children.end()) {
+                    it = node->children.emplace(std::string(component), std::make_unique<Node>()).first;
+                }
+                node = it->second.get();
+            }
+            start = end + 1;
+        }
+        node->value = value;
+    }
+
+    std::optional<Match> longest_prefix(std::string_view path) const
+    {
+        const Node* node = &root;
+        std::optional<Match> best;
+        size_t start = 0;
+        while (start < path.size()) {
+            size_t end = path.find('/', start);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            if (end > start) {
+                const std::string_view component = path.substr(start, end - start);
+                auto it = node->children.find(component);
+                if (it == node->children.end()) {
+                    break;
+                }
+                node = it->second.get();
+                if (node->value) {
+                    best = Match{ *node->value, end };
+                }
+            }
+            start = end + 1;
+        }
+        return best;
+    }
+
+    void clear() { root = Node{}; }
+};
+
+} // namespace Datadog
@@ -9,6 +9,7 @@
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -33,11 +34,23 @@ class Profile
     std::atomic<bool> first_time{ true };
     std::mutex profile_mtx{};
 
+    // Serializes exports against each other.  Samplers never take this lock:
+    // an export rotates the buffers under profile_mtx (brief) and then
+    // serializes the sealed profile under upload_mtx only, so sample writers
+    // keep flowing into the fresh active profile while the upload runs.
+    std::mutex upload_mtx{};
+
     // Storage for strings
     std::deque<std::string> string_storage{};
     StringTable strings{};
     std::mutex string_table_mtx{};
 
+    // Handle-based access to the interned table: callers that see the same
+    // few strings over and over (task names, trace types, exception types)
+    // intern once and push a small integer id per sample afterwards
+    std::vector<std::string_view> interned_by_id{};
+    std::unordered_map<std::string_view, uint64_t> id_by_string{};
+
     // Configuration
     SampleType type_mask{ 0 };
     unsigned int max_nframes{ g_default_max_nframes };
@@ -46,6 +59,11 @@ class Profile
     // Sampler setup
     void setup_samplers();
 
+    // Strings registered before init to be interned up front, on top of the
+    // built-in well-known runtime frames; see prewarm_string_table
+    std::vector<std::string> user_prewarm{};
+    void prewarm_string_table();
+
     // Lookup for values
     ValueIndex val_idx{};
 
@@ -57,6 +75,54 @@ class Profile
     ddog_prof_Profile cur_profile{};
     ddog_prof_Profile last_profile{};
 
+    // Pre-aggregation of identical (locations, labels, timestamp) samples:
+    // steady-state workloads submit the same stack over and over within one
+    // upload window, so values are accumulated here and handed to
+    // ddog_prof_Profile_add once per export instead of once per sample.
+    // Timeline samples participate too: their timestamps are quantized
+    // upstream (see Sample::push_monotonic_ns), so samples in the same
+    // granule collapse; with timeline off the timestamp is always zero.
+    struct AggregatedSample
+    {
+        std::vector<ddog_prof_Location> locations{};
+        std::vector<ddog_prof_Label> labels{};
+        std::vector<int64_t> values{};
+        // Delta baseline and idle-cycle count, used only by entries in the
+        // persistent (cumulative) table; see below
+        std::vector<int64_t> exported{};
+        uint32_t idle_cycles{ 0 };
+        int64_t endtime_ns{ 0 };
+    };
+    // Keyed by a hash of the locations and labels; entries sharing a hash are
+    // disambiguated by full comparison, which is cheap because the string
+    // slices are interned and compare by pointer.
+    //
+    // Two tables with the same layout: timestamped (timeline) samples
+    // accumulate in aggregated_samples, which is flushed and emptied every
+    // cycle -- their timestamps never repeat across cycles, so persistence
+    // would buy nothing.  Timestamp-free samples (allocation, lock and heap
+    // statistics, and wall/cpu with timeline off -- semantically cumulative
+    // counters keyed by stack identity) live in cumulative_samples, which
+    // persists across cycles: values accumulate for the life of the entry and
+    // each export emits the delta against what was already exported.  A
+    // recurring stack therefore keeps its warm entry, vectors and re-homed
+    // label strings across cycles, instead of being torn down and rebuilt
+    // every upload; entries idle for g_delta_retire_cycles are retired.
+    std::unordered_map<uint64_t, std::vector<AggregatedSample>> aggregated_samples{};
+    std::unordered_map<uint64_t, std::vector<AggregatedSample>> cumulative_samples{};
+
+    // Entries recycled across upload cycles so the first samples after an
+    // export reuse warm vector storage instead of reallocating it; see
+    // flush_aggregated_locked
+    std::vector<AggregatedSample> aggregated_freelist{};
+
+    // Requires profile_mtx
+    void recycle_aggregated_locked(AggregatedSample& agg);
+    bool flush_aggregated_locked();
+    bool flush_deltas_locked();
+    bool cycle_buffers_locked();
+    bool reset_profile_locked(ddog_prof_Profile& profile);
+
   public:
     // State management
     void one_time_init(SampleType type, unsigned int _max_nframes);
@@ -69,13 +135,28 @@ class Profile
     ddog_prof_Profile& profile_borrow();
     void profile_release();
 
+    // Rotates the buffers and returns the sealed (now inactive) profile for
+    // export.  Samplers are only blocked for the rotation itself; the caller
+    // serializes and uploads the sealed profile without holding profile_mtx
+    // and must call profile_unseal() when done with the reference.
+    ddog_prof_Profile& profile_seal();
+    void profile_unseal();
+
     // String table manipulation
     std::string_view insert_or_get(std::string_view str);
+    uint64_t intern_string_id(std::string_view str);
+    std::string_view get_interned_string(uint64_t id);
+    void add_prewarm_string(std::string_view str);
 
     // constref getters
     const ValueIndex& val();
 
     // collect
     bool collect(const ddog_prof_Sample& sample, int64_t endtime_ns);
+
+    // Accumulates a sample into the aggregation table instead of adding it to
+    // the profile right away; aggregated entries are flushed by
+    // cycle_buffers() at export time.
+    bool collect_aggregated(const ddog_prof_Sample& sample, int64_t endtime_ns);
 };
 } // namespace Datadog
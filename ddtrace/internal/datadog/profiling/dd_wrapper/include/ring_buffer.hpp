@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Datadog {
+
+// Header-only bounded ring buffers for the native pipelines, so each
+// subsystem stops hand-rolling its own queue. Two flavors:
+//
+//   SPSCRingBuffer  single producer, single consumer; plain head/tail
+//                   indices, no atomic read-modify-write on either path
+//   MPSCRingBuffer  multiple producers, single consumer; Vyukov-style
+//                   per-cell sequence numbers so producers never contend on
+//                   more than one CAS
+//
+// Both round the capacity up to a power of two, keep the producer and
+// consumer cursors on their own cache lines to avoid false sharing, support
+// batch push/pop to amortize the cursor traffic, and accept a backpressure
+// callback that runs on the producer when an item does not fit (instead of
+// silently dropping it or blocking).
+//
+// Elements are moved in and out; T should be cheap to move (the native
+// pipelines pass pointers).
+
+// std::hardware_destructive_interference_size would be the portable spelling,
+// but GCC warns on any use of it in a header (-Winterference-size) since the
+// value can differ between TUs; 64 covers every target we build for.
+constexpr size_t cacheline_size = 64;
+
+namespace ring_buffer_detail {
+
+inline size_t
+roundup_pow2(size_t n)
+{
+    size_t size = 2;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace ring_buffer_detail
+
+template<typename T>
+class SPSCRingBuffer
+{
+  public:
+    explicit SPSCRingBuffer(size_t capacity)
+      : mask{ ring_buffer_detail::roundup_pow2(capacity) - 1 }
+      , cells{ std::make_unique<T[]>(mask + 1) }
+    {
+    }
+
+    // Runs on the producer whenever a push finds the buffer full, before the
+    // push reports failure; wire up the subsystem's shed/flush-inline policy
+    // here instead of checking return codes at every call site.
+    void set_backpressure_callback(std::function<void(size_t)> callback) { on_backpressure = std::move(callback); }
+
+    bool push(T item) { return push_batch(&item, 1) == 1; }
+
+    // Pushes up to n items and returns how many fit; on a partial push the
+    // backpressure callback (if any) is invoked with the number that did not.
+    size_t push_batch(T* items, size_t n)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t free_slots = mask + 1 - (h - tail.load(std::memory_order_acquire));
+
+        const size_t pushed = n < free_slots ? n : free_slots;
+        for (size_t i = 0; i < pushed; i++) {
+            cells[(h + i) & mask] = std::move(items[i]);
+        }
+        // One cursor update publishes the whole batch
+        head.store(h + pushed, std::memory_order_release);
+
+        if (pushed < n && on_backpressure) {
+            on_backpressure(n - pushed);
+        }
+        return pushed;
+    }
+
+    bool pop(T& out) { return pop_batch(&out, 1) == 1; }
+
+    // Pops up to max_n items and returns how many were available
+    size_t pop_batch(T* out, size_t max_n)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t available = head.load(std::memory_order_acquire) - t;
+
+        const size_t popped = max_n < available ? max_n : available;
+        for (size_t i = 0; i < popped; i++) {
+            out[i] = std::move(cells[(t + i) & mask]);
+        }
+        tail.store(t + popped, std::memory_order_release);
+
+        return popped;
+    }
+
+    size_t capacity() const { return mask + 1; }
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+  private:
+    const size_t mask;
+    std::unique_ptr<T[]> cells;
+    std::function<void(size_t)> on_backpressure;
+
+    alignas(cacheline_size) std::atomic<size_t> head{ 0 };
+    alignas(cacheline_size) std::atomic<size_t> tail{ 0 };
+};
+
+template<typename T>
+class MPSCRingBuffer
+{
+  public:
+    explicit MPSCRingBuffer(size_t capacity)
+      : mask{ ring_buffer_detail::roundup_pow2(capacity) - 1 }
+      , cells{ std::make_unique<Cell[]>(mask + 1) }
+    {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void set_backpressure_callback(std::function<void(size_t)> callback) { on_backpressure = std::move(callback); }
+
+    // Safe to call from any number of producer threads. A full buffer fails
+    // the push after running the backpressure callback.
+    bool push(T item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[h & mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+            if (seq == h) {
+                // The cell is free; claim it
+                if (head.compare_exchange_weak(h, h + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(item);
+                    cell.sequence.store(h + 1, std::memory_order_release);
+                    return true;
+                }
+                // Lost the race; h was reloaded by compare_exchange_weak
+            } else if (seq < h) {
+                // The consumer has not freed this cell yet: full
+                if (on_backpressure) {
+                    on_backpressure(1);
+                }
+                return false;
+            } else {
+                // Another producer claimed h; chase the cursor
+                h = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pushes each item individually (producers may interleave) and returns
+    // how many fit; the backpressure callback sees one call with the count
+    // that did not.
+    size_t push_batch(T* items, size_t n)
+    {
+        // Suspend the per-push callback so a partial batch reports once
+        size_t pushed = 0;
+        auto callback = std::move(on_backpressure);
+        on_backpressure = nullptr;
+        while (pushed < n && push(std::move(items[pushed]))) {
+            pushed++;
+        }
+        on_backpressure = std::move(callback);
+
+        if (pushed < n && on_backpressure) {
+            on_backpressure(n - pushed);
+        }
+        return pushed;
+    }
+
+    // Single consumer only
+    bool pop(T& out)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        Cell& cell = cells[t & mask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+        if (seq != t + 1) {
+            return false; // empty (or the producer has not published yet)
+        }
+
+        out = std::move(cell.data);
+        // Free the cell for the producer one lap ahead
+        cell.sequence.store(t + mask + 1, std::memory_order_release);
+        tail.store(t + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t pop_batch(T* out, size_t max_n)
+    {
+        size_t popped = 0;
+        while (popped < max_n && pop(out[popped])) {
+            popped++;
+        }
+        return popped;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T data{};
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    std::function<void(size_t)> on_backpressure;
+
+    alignas(cacheline_size) std::atomic<size_t> head{ 0 };
+    alignas(cacheline_size) std::atomic<size_t> tail{ 0 };
+};
+
+} // namespace Datadog
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace Datadog {
+
+// Flight-recorder export target: a fixed-size memory-mapped file that sealed
+// profiles are appended to as length-prefixed records with wraparound.  The
+// hot path is a memcpy into the mapping -- no write syscalls, no growth --
+// and the kernel flushes dirty pages on its own schedule, so an always-on
+// local capture costs near-zero I/O and a bounded, known amount of disk.
+// When the window fills, the oldest records are overwritten first; the file
+// always holds the last N minutes of profiles.
+//
+// On-disk layout (little-endian, fields 8-byte aligned):
+//
+//   header page (4096 bytes):
+//     [0]  char[8]  magic "DDPROFRG"
+//     [8]  u32      version (1)
+//     [12] u32      header size (4096)
+//     [16] u64      capacity of the data region in bytes
+//     [24] u64      head: monotonic count of bytes ever appended
+//     [32] u64      tail: monotonic offset of the oldest intact record
+//   data region (capacity bytes), records wrapping byte-wise:
+//     u64 payload length, u64 wall-clock timestamp (ns), payload
+//
+// A record's position in the file is its monotonic offset modulo capacity.
+// Single writer per file: the writer embeds its pid in the path (mirroring
+// export_to_file) so a forked child opens its own ring.  head is published
+// last with release ordering; the reader treats [tail, head) as the valid
+// window and re-checks tail after copying a record to detect overwrite races.
+class RingFile
+{
+  public:
+    // Opens (or resumes, when magic and capacity match) the ring at
+    // `path`.<pid>.ring.  Returns an error message on failure.
+    static std::variant<std::shared_ptr<RingFile>, std::string> open(std::string_view path, uint64_t capacity);
+
+    // Appends one record; drops it (with a telemetry count) when it alone
+    // exceeds the window.  Writer-side bookkeeping only; never blocks on I/O.
+    bool append(const uint8_t* data, size_t len);
+
+    ~RingFile();
+    RingFile(const RingFile&) = delete;
+    RingFile& operator=(const RingFile&) = delete;
+
+  private:
+    RingFile() = default;
+
+    // Copy `len` bytes into/out of the data region starting at monotonic
+    // offset `pos`, wrapping at the capacity boundary
+    void wrap_copy(uint64_t pos, const void* src, size_t len);
+    void wrap_read(uint64_t pos, void* dst, size_t len) const;
+    void publish_cursors();
+
+    uint8_t* mapping = nullptr; // header page + data region
+    size_t mapping_size = 0;
+    uint64_t capacity = 0;
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    int fd = -1;
+
+    // Sizes of live records in window order, so tail can step over whole
+    // records as they are overwritten.  Rebuilt by walking the window when an
+    // existing ring is resumed.
+    std::deque<uint64_t> record_sizes;
+};
+
+} // namespace Datadog
@@ -4,6 +4,10 @@
 #include "profile.hpp"
 #include "types.hpp"
 
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -23,7 +27,6 @@ class Sample
     static inline Profile profile_state{}; // TODO pointer to global state?
     unsigned int max_nframes;
     SampleType type_mask;
-    std::string errmsg;
 
     // Timeline support works by endowing each sample with a timestamp. Collection of this data this data is cheap, but
     // due to the underlying pprof format, timeline support increases the sample cardinality. Rather than switching
@@ -31,24 +34,64 @@ class Sample
     // 0 value suppresses the tag). However, Sample objects are short-lived, so we make the flag static.
     static inline bool timeline_enabled = false;
 
+    // Quantization step for timeline timestamps; see push_monotonic_ns
+    static inline int64_t timeline_granularity_ns = g_default_timeline_granularity_ns;
+
     // Keeps temporary buffer of frames in the stack
     std::vector<ddog_prof_Location> locations;
     size_t dropped_frames = 0;
     uint64_t samples = 0;
 
-    // Storage for labels
-    std::vector<ddog_prof_Label> labels{};
-
-    // Storage for values
-    std::vector<int64_t> values = {};
+    // Storage for labels.  The set of possible labels is fixed and small
+    // (ExportLabelKey), so rather than a push-vector that can reallocate on
+    // the sampling hot path, each key gets a dedicated slot and presence is
+    // tracked in a bitmask; flush compacts only the set slots.
+    static constexpr size_t num_label_slots = static_cast<size_t>(ExportLabelKey::Length_);
+    static_assert(num_label_slots <= 32, "label presence bitmask is 32 bits");
+    std::array<ddog_prof_Label, num_label_slots> label_slots{};
+    uint32_t label_mask{ 0 };
+
+    // Bump arena backing the label strings for the duration of one sample.
+    // Values like task and thread names can be high-cardinality, so parking
+    // them in the process-lifetime interned table on every push would grow it
+    // without bound; instead callers copy once into the arena (a pointer
+    // bump, no frees) and clear_buffers() resets it.  Capacity is reserved up
+    // front and never exceeded, so views into it stay stable; anything that
+    // would overflow falls back to the interned table.
+    std::vector<char> string_arena{};
+
+    // Copies str into the arena and returns a view valid until clear_buffers()
+    std::string_view arena_store(std::string_view str);
+
+    // Storage for values.  The slot count is bounded at compile time
+    // (g_max_value_slots); only the first values_len slots, fixed at
+    // ddup_start by the enabled sample types, are ever used, so per-push
+    // stores are direct array writes with no per-Sample heap allocation
+    std::array<int64_t, g_max_value_slots> values = {};
+    size_t values_len = 0;
 
     // Additional metadata
     int64_t endtime_ns = 0; // end of the event
 
+    // Prebuilt label sets addressed by handle; see labelset_new.  Stored
+    // string slices point into the process-lifetime interned table, so sets
+    // outlive every sample and survive fork.  The deque keeps entries at
+    // stable addresses as the registry grows; creation and per-sample reads
+    // share the mutex, the same discipline as the interned-string registry.
+    struct LabelSet
+    {
+        std::array<ddog_prof_Label, num_label_slots> slots{};
+        uint32_t mask{ 0 };
+    };
+    static inline std::deque<LabelSet> labelsets{};
+    static inline std::mutex labelsets_mtx{};
+
   public:
     // Helpers
     bool push_label(ExportLabelKey key, std::string_view val);
     bool push_label(ExportLabelKey key, int64_t val);
+    // Variant for values that already live in the profile's interned table; skips the arena copy
+    bool push_label_interned(ExportLabelKey key, std::string_view val);
     void push_frame_impl(std::string_view name, std::string_view filename, uint64_t address, int64_t line);
     void clear_buffers();
 
@@ -59,6 +102,7 @@ class Sample
     bool push_release(int64_t lock_time, int64_t count);
     bool push_alloc(int64_t size, int64_t count);
     bool push_heap(int64_t size);
+    bool push_gil_wait(int64_t wait_time, int64_t count);
 
     // Adds metadata to sample
     bool push_lock_name(std::string_view lock_name);
@@ -72,9 +116,29 @@ class Sample
     bool push_class_name(std::string_view class_name);
     bool push_monotonic_ns(int64_t monotonic_ns);
 
+    // Handle-based variants for repeated metadata: callers intern once via
+    // intern_string() and push the returned id per sample, skipping the
+    // per-sample string copy entirely
+    static uint64_t intern_string(std::string_view str);
+    bool push_threadinfo_id(int64_t thread_id, int64_t thread_native_id, uint64_t thread_name_id);
+    bool push_task_name_id(uint64_t task_name_id);
+    bool push_trace_type_id(uint64_t trace_type_id);
+    bool push_exceptioninfo_id(uint64_t exception_type_id, int64_t count);
+
+    // Label-set handles for repeated label contexts: samples from the same
+    // thread/task/span context carry identical label sets, so callers
+    // assemble the set once (e.g. per thread-context per upload cycle), get
+    // an id, and attach the whole set per sample with push_labelset --
+    // collapsing the field-by-field pushes to one copy of prebuilt slots
+    static uint64_t labelset_new();
+    static bool labelset_add(uint64_t labelset_id, ExportLabelKey key, std::string_view val);
+    static bool labelset_add(uint64_t labelset_id, ExportLabelKey key, int64_t val);
+    bool push_labelset(uint64_t labelset_id);
+
     // Interacts with static Sample state
     bool is_timeline_enabled() const;
     static void set_timeline(bool enabled);
+    static void set_timeline_granularity(int64_t granularity_ns);
 
     // Assumes frames are pushed in leaf-order
     void push_frame(std::string_view name,     // for ddog_prof_Function
@@ -83,11 +147,17 @@ class Sample
                     int64_t line               // for ddog_prof_Location
     );
 
+    // Account for truncated frames in bulk; callers that know the whole stack
+    // up-front (ddup_push_batch) use this to skip walking the dropped tail
+    void add_dropped_frames(int64_t count);
+
     // Flushes the current buffer, clearing it
     bool flush_sample(bool reverse_locations = false);
 
     static ddog_prof_Profile& profile_borrow();
     static void profile_release();
+    static ddog_prof_Profile& profile_seal();
+    static void profile_unseal();
     static void profile_clear_state();
     static void postfork_child();
     Sample(SampleType _type_mask, unsigned int _max_nframes);
@@ -28,12 +28,21 @@ class SampleManager
     static void add_type(unsigned int type);
     static void set_max_nframes(unsigned int _max_nframes);
     static void set_timeline(bool enable);
+    static void set_timeline_granularity(int64_t granularity_ns);
     static void set_sample_pool_capacity(size_t capacity);
+    static unsigned int get_max_nframes() { return max_nframes; }
+    static void add_prewarm_string(std::string_view str);
 
     // Sampling entrypoint (this could also be called `build_ptr()`)
     static Sample* start_sample();
     static void drop_sample(Sample* sample);
 
+    // Adaptive pool maintenance, called off the hot path at export time
+    static void adjust_pool_capacity();
+    static uint64_t get_pool_exhaustion_count();
+    static uint64_t get_pool_overflow_count();
+    static size_t get_pool_capacity();
+
     // Handles state management after forks
     static void postfork_child();
 
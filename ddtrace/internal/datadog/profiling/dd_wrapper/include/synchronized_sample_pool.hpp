@@ -1,13 +1,16 @@
 #pragma once
 
 #include "sample.hpp"
+#include "telemetry_counters.hpp"
 
 extern "C"
 {
 #include "datadog/common.h"
 }
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <shared_mutex>
 
 namespace Datadog {
 
@@ -21,10 +24,37 @@ class SynchronizedSamplePool
   private:
     std::unique_ptr<ddog_ArrayQueue, Deleter> pool;
 
+    // Adaptive sizing: the pool grows after a window with exhaustion events
+    // and shrinks back after quiet windows, within [min_capacity,
+    // max_capacity].  The shared lock covers take/return (uncontended in
+    // steady state); resizing takes it exclusively.
+    size_t capacity;
+    size_t min_capacity;
+    size_t max_capacity;
+    std::shared_mutex pool_mtx;
+
+    // Per-window pressure counters, swapped out by adjust_capacity()
+    std::atomic<uint64_t> window_exhaustions{ 0 };
+    std::atomic<uint64_t> window_overflows{ 0 };
+
+    // Process-lifetime totals, for visibility into sampling degradation.
+    // The cells live in the shared telemetry registry so they also show up
+    // in ddup_counter_snapshot() alongside the other extensions' counters.
+    std::atomic<uint64_t>* total_exhaustions = Telemetry::register_counter("sample_pool.exhaustions");
+    std::atomic<uint64_t>* total_overflows = Telemetry::register_counter("sample_pool.overflows");
+
   public:
     SynchronizedSamplePool(size_t capacity);
 
     std::optional<Sample*> take_sample();
     std::optional<Sample*> return_sample(Sample* sample);
+
+    // Called off the hot path (at export boundaries): applies the grow/shrink
+    // policy based on the pressure observed since the previous call
+    void adjust_capacity();
+
+    uint64_t get_exhaustion_count() { return total_exhaustions->load(); }
+    uint64_t get_overflow_count() { return total_overflows->load(); }
+    size_t get_capacity() { return capacity; }
 };
 } // namespace Datadog
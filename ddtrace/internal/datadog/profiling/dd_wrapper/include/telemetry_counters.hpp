@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace Datadog {
+namespace Telemetry {
+
+// Always-on counter registry shared by the native extensions that link
+// dd_wrapper. Counters live in a fixed array of slots, registered by name at
+// module init; the hot path holds the returned cell and pays exactly one
+// relaxed atomic increment, so counters can stay enabled in production.
+// Python reads all registered counters in one snapshot call through
+// ddup_counter_snapshot().
+
+constexpr size_t max_counters = 64;
+
+struct CounterEntry
+{
+    const char* name;
+    uint64_t value;
+};
+
+// Registers a counter by name and returns its cell; registering an already
+// known name returns the existing cell. Never returns nullptr: when the
+// fixed slots are exhausted, further registrations share a spill cell named
+// "telemetry.overflow" so callers need no error handling on the hot path.
+std::atomic<uint64_t>* register_counter(std::string_view name);
+
+// Copies up to max_entries registered counters into entries and returns how
+// many were written. The names point at registry-owned storage and stay
+// valid for the life of the process.
+size_t snapshot(CounterEntry* entries, size_t max_entries);
+
+} // namespace Telemetry
+} // namespace Datadog
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace Datadog {
 enum SampleType : unsigned int
 {
@@ -11,7 +13,8 @@ enum SampleType : unsigned int
     LockRelease = 1 << 4,
     Allocation = 1 << 5,
     Heap = 1 << 6,
-    All = CPU | Wall | Exception | LockAcquire | LockRelease | Allocation | Heap
+    GILWait = 1 << 7,
+    All = CPU | Wall | Exception | LockAcquire | LockRelease | Allocation | Heap | GILWait
 };
 
 // Every Sample object has a corresponding `values` vector, since libdatadog expects contiguous values per sample.
@@ -30,6 +33,13 @@ struct ValueIndex
     unsigned short alloc_space;
     unsigned short alloc_count;
     unsigned short heap_space;
+    unsigned short gil_wait_time;
+    unsigned short gil_wait_count;
 };
 
+// Compile-time upper bound on the number of value slots: one per ValueIndex
+// member, reached when every SampleType is enabled.  This lets Sample keep its
+// values in a fixed array instead of a per-object heap allocation.
+constexpr size_t g_max_value_slots = sizeof(ValueIndex) / sizeof(unsigned short);
+
 } // namespace Datadog
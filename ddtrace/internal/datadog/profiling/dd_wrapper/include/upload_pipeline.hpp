@@ -0,0 +1,78 @@
+#pragma once
+
+#include "constants.hpp"
+#include "uploader.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+extern "C"
+{
+#include "datadog/profiling.h"
+}
+
+namespace Datadog {
+
+// Decouples the network half of an export from the profiler's upload cadence.
+// ddup_upload() serializes the sealed profile on its own thread (the sealed
+// buffer cannot outlive the next rotation, so serialization has to finish
+// under the seal), then hands the encoded payload here by move; a dedicated
+// exporter thread builds the request and performs the send.  When the agent
+// is slower than the upload cadence the queue drops its oldest payload
+// instead of stalling the producer or growing without bound.  Failed network
+// sends (agent restarts, mostly) get a bounded number of re-attempts with
+// jittered exponential backoff, all waited out on the exporter thread.
+class UploadPipeline
+{
+  private:
+    struct Payload
+    {
+        Uploader uploader;
+        ddog_prof_EncodedProfile encoded;
+        // Retry bookkeeping: failed sends go back on retry_queue with a
+        // jittered exponential backoff deadline
+        uint32_t attempts{ 0 };
+        std::chrono::steady_clock::time_point not_before{};
+    };
+
+    // Single producer (the profiler's upload thread), single consumer (the
+    // exporter thread); the lock is only ever held for queue bookkeeping,
+    // never across a send.
+    static inline std::mutex queue_mtx{};
+    static inline std::condition_variable queue_cv{};
+    // Signaled by the worker when a send finishes; shutdown waits on it so the
+    // final profile gets a bounded chance to drain before cancellation
+    static inline std::condition_variable drain_cv{};
+    static inline std::deque<Payload> queue{};
+    // Failed network sends waiting out their backoff; small and size-capped
+    // (drop-oldest) because each entry holds a raw serialized profile.  Fresh
+    // payloads always take priority, and retries never hold up shutdown.
+    static inline std::deque<Payload> retry_queue{};
+    static inline std::thread worker{};
+    static inline bool worker_started{ false };
+    static inline bool stopping{ false };
+    static inline bool sending{ false };
+
+    static void worker_loop();
+    static void ensure_worker();                  // Requires queue_mtx
+    static void schedule_retry(Payload&& payload); // Requires queue_mtx
+    static void drop_queued_locked();             // Requires queue_mtx
+
+  public:
+    // Takes ownership of both the uploader and the encoded profile
+    static void enqueue(Uploader&& uploader, ddog_prof_EncodedProfile encoded);
+
+    // Lets queued payloads drain for a bounded grace period, then cancels any
+    // in-flight send and joins the exporter thread (atexit).  Exit latency is
+    // a constant, not a multiple of the agent timeout.
+    static void shutdown();
+
+    static void prefork();
+    static void postfork_parent();
+    static void postfork_child();
+};
+
+} // namespace Datadog
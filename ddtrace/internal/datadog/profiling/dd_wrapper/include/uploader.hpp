@@ -1,11 +1,13 @@
 #pragma once
 
+#include "ring_file.hpp"
 #include "sample.hpp"
 #include "types.hpp"
 
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 extern "C"
 {
@@ -22,17 +24,51 @@ struct DdogCancellationTokenDeleter
 class Uploader
 {
   private:
-    static inline std::mutex upload_lock{};
+    // Timed so prefork can bound its wait on an in-flight (cancelled) send
+    // instead of inheriting the agent's timeout as fork latency
+    static inline std::timed_mutex upload_lock{};
+    static inline std::atomic<bool> prefork_locked{ false };
     std::string errmsg;
+    // cancel_mtx serializes token replacement between the sending thread and
+    // the fork/shutdown paths that signal cancellation
+    static inline std::mutex cancel_mtx{};
     static inline std::unique_ptr<ddog_CancellationToken, DdogCancellationTokenDeleter> cancel;
     static inline std::atomic<uint64_t> upload_seq{ 0 };
     std::string output_filename;
-    std::unique_ptr<ddog_prof_Exporter, DdogProfExporterDeleter> ddog_exporter;
+    // Shared with UploaderBuilder's cache so the exporter (and its keep-alive
+    // connections) survives across upload cycles
+    std::shared_ptr<ddog_prof_Exporter> ddog_exporter;
+    // Flight-recorder target; when set, sealed profiles go into the mapped
+    // ring instead of over the network or into per-cycle files
+    std::shared_ptr<RingFile> ring_file;
 
     bool export_to_file(ddog_prof_EncodedProfile* encoded);
 
   public:
     bool upload(ddog_prof_Profile& profile);
+
+    // Split pipeline used by the asynchronous exporter: serialization happens
+    // while the caller holds the profile seal, the send runs on the exporter
+    // thread from the encoded payload alone.  The encoded profile is consumed
+    // (dropped) by upload_encoded.
+    std::optional<ddog_prof_EncodedProfile> serialize(ddog_prof_Profile& profile);
+    bool upload_encoded(ddog_prof_EncodedProfile* encoded);
+
+    // Like upload_encoded, but a failed network send leaves the encoded
+    // profile intact and sets *retryable so the exporter thread can
+    // re-attempt it after a backoff.  Successes, build errors and the local
+    // (file/ring) targets consume the payload as usual.
+    bool upload_encoded_retryable(ddog_prof_EncodedProfile* encoded, bool* retryable);
+
+    // The two stages behind upload_encoded, exposed separately so the exporter
+    // thread can be explicit about where the work happens.  build_request() is
+    // the compression stage: libdatadog zstd-compresses each attached file
+    // inside Request_build, and the raw serialized profile (the large
+    // allocation, 10-20MB with timeline on) is consumed and dropped before it
+    // returns, so a slow send only ever holds compressed bytes.  send_request()
+    // is the network stage and takes ownership of the request.
+    ddog_prof_Exporter_Request* build_request(ddog_prof_EncodedProfile* encoded, bool consume_encoded = true);
+    bool send_request(ddog_prof_Exporter_Request* req);
     static void cancel_inflight();
     static void lock();
     static void unlock();
@@ -40,7 +76,9 @@ class Uploader
     static void postfork_parent();
     static void postfork_child();
 
-    Uploader(std::string_view _url, ddog_prof_Exporter* ddog_exporter);
+    Uploader(std::string_view _url,
+             std::shared_ptr<ddog_prof_Exporter> ddog_exporter,
+             std::shared_ptr<RingFile> ring_file = nullptr);
 };
 
 } // namespace Datadog
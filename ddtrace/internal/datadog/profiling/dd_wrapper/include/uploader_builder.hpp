@@ -2,7 +2,9 @@
 
 #include "uploader.hpp"
 
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -27,9 +29,34 @@ class UploaderBuilder
     static inline ExporterTagset user_tags{};
     static inline std::string output_filename{ "" };
 
+    // Ring-file (flight recorder) mode; the writer is opened lazily on the
+    // first build and shared across uploaders, like the exporter.  The child
+    // of a fork reopens its own ring (the path is pid-suffixed).
+    static inline std::string ring_file_path{ "" };
+    static inline uint64_t ring_file_capacity{ g_ringfile_default_capacity };
+    static inline std::shared_ptr<RingFile> cached_ring_file{};
+
     static constexpr std::string_view language{ g_language_name };
     static constexpr std::string_view family{ g_language_name };
 
+    // The exporter is expensive to stand up (endpoint/tag setup, and its
+    // HTTP client loses connection keep-alive when torn down), so it is
+    // built once and shared across upload cycles.  Setters that feed the
+    // exporter invalidate it when a value actually changes.
+    static inline std::mutex exporter_mutex{};
+    static inline std::shared_ptr<ddog_prof_Exporter> cached_exporter{};
+
+    static void invalidate_exporter();
+
+    // The assembled exporter tag set, cached separately from the exporter: a rebuild
+    // that wasn't caused by a tag change (post-fork, endpoint-only) reuses it instead
+    // of re-validating and re-formatting every tag.  Guarded by tag_mutex; dropped
+    // whenever a tag-feeding setter changes a value.
+    static inline std::optional<ddog_Vec_Tag> cached_tags{};
+
+    static void invalidate_tags();
+    static void invalidate_tags_locked(); // requires tag_mutex held
+
   public:
     static void set_env(std::string_view _dd_env);
     static void set_service(std::string_view _service);
@@ -41,8 +68,12 @@ class UploaderBuilder
     static void set_url(std::string_view _url);
     static void set_tag(std::string_view _key, std::string_view _val);
     static void set_output_filename(std::string_view _output_filename);
+    static void set_output_ringfile(std::string_view _path, uint64_t _capacity);
 
     static std::variant<Uploader, std::string> build();
+
+    // The child's inherited exporter references the parent's client state
+    static void postfork_child();
 };
 
 } // namespace Datadog
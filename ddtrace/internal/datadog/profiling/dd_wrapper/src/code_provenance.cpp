@@ -36,6 +36,7 @@ Datadog::CodeProvenance::set_runtime_version(std::string_view _runtime_version)
 {
     std::lock_guard<std::mutex> lock(mtx);
     this->runtime_version = _runtime_version;
+    dirty = true;
 }
 
 void
@@ -43,6 +44,7 @@ Datadog::CodeProvenance::set_stdlib_path(std::string_view _stdlib_path)
 {
     std::lock_guard<std::mutex> lock(mtx);
     this->stdlib_path = _stdlib_path;
+    dirty = true;
 }
 
 void
@@ -59,6 +61,7 @@ CodeProvenance::add_packages(std::unordered_map<std::string_view, std::string_vi
         auto it = packages.find(package_name);
         if (it == packages.end()) {
             add_new_package(package_name, version);
+            dirty = true;
         }
     }
 }
@@ -70,36 +73,49 @@ CodeProvenance::add_filename(std::string_view filename)
         return;
     }
 
-    std::string_view package_name = get_package_name(filename);
-    if (package_name.empty() or package_name == STDLIB) {
-        return;
-    }
-
     std::lock_guard<std::mutex> lock(mtx);
 
-    auto it = packages.find(package_name);
-    if (it == packages.end()) {
+    const Package* package = classify_locked(filename);
+    if (package == nullptr or package == &stdlib_package) {
         return;
     }
 
-    const Package* package = it->second.get();
-    if (package) {
-        if (packages_to_files.find(package) == packages_to_files.end()) {
-            packages_to_files[package] = std::set<std::string>();
-        }
-        packages_to_files[package].insert(std::string(filename));
+    if (packages_to_files.find(package) == packages_to_files.end()) {
+        packages_to_files[package] = std::set<std::string>();
+    }
+    // Only a file we have not seen before invalidates the cached JSON
+    if (packages_to_files[package].insert(std::string(filename)).second) {
+        dirty = true;
     }
 }
 
-std::optional<std::string>
+const char*
+CodeProvenance::classify_path(std::string_view path)
+{
+    if (!is_enabled()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    const Package* package = classify_locked(path);
+    return package ? package->name.c_str() : nullptr;
+}
+
+std::shared_ptr<const std::string>
 CodeProvenance::try_serialize_to_json_str()
 {
     if (!is_enabled()) {
-        return std::nullopt;
+        return nullptr;
     }
 
     std::lock_guard<std::mutex> lock(mtx);
 
+    // Steady state: nothing new was registered or touched since the last
+    // export, so the previous buffer is still correct byte-for-byte
+    if (!dirty and cached_json) {
+        return cached_json;
+    }
+
     std::ostringstream out;
     // DEV: Simple JSON serialization, maybe consider using a JSON library.
     out << "{\"v1\":["; // Start of the JSON array
@@ -129,9 +145,11 @@ CodeProvenance::try_serialize_to_json_str()
     out << "}";  // End of stdlib JSON object
     out << "]}"; // End of the JSON array
 
-    // Clear the state
-    packages_to_files.clear();
-    return out.str();
+    // Keep the state: the package/file mapping is maintained incrementally
+    // and the encoded form is reused until something changes
+    cached_json = std::make_shared<const std::string>(out.str());
+    dirty = false;
+    return cached_json;
 }
 
 void
@@ -139,26 +157,51 @@ CodeProvenance::reset()
 {
     std::lock_guard<std::mutex> lock(mtx);
     packages_to_files.clear();
+    cached_json.reset();
+    dirty = true;
 }
 
-std::string_view
-CodeProvenance::get_package_name(std::string_view filename)
+const Package*
+CodeProvenance::classify_locked(std::string_view filename)
 {
-    // std::regex is slow, so we use a simple string search
     static const std::string site_packages = "site-packages/";
 
+    // Fast path: a previously interned prefix covers this file.  A match can
+    // only be trusted when the unmatched remainder holds no deeper
+    // site-packages directory (the interpreter prefix we intern for stdlib
+    // files is usually also a prefix of the site-packages tree beneath it);
+    // the remainder is at most a few components, so the check is cheap.
+    if (auto hit = path_trie.longest_prefix(filename)) {
+        const std::string_view remainder = filename.substr(hit->prefix_length);
+        if (remainder.find(site_packages) == std::string_view::npos) {
+            return hit->value;
+        }
+    }
+
+    // Slow path, paid once per directory: classify by scanning for
+    // site-packages, then intern the governing prefix so siblings hit the trie
     size_t start = filename.find(site_packages);
     if (start == std::string::npos) {
-        return std::string_view(STDLIB);
+        const size_t slash = filename.rfind('/');
+        if (slash != std::string_view::npos and slash > 0) {
+            path_trie.insert(filename.substr(0, slash), &stdlib_package);
+        }
+        return &stdlib_package;
     }
 
     start += site_packages.length();
-    size_t end = filename.find('/', start);
-    if (end == std::string::npos) {
-        return {};
+    const size_t end = filename.find('/', start);
+    if (end == std::string_view::npos) {
+        return nullptr;
     }
 
-    return filename.substr(start, end - start);
+    const std::string_view package_name = filename.substr(start, end - start);
+    auto it = packages.find(package_name);
+    if (it == packages.end()) {
+        return nullptr;
+    }
+    path_trie.insert(filename.substr(0, end), it->second.get());
+    return it->second.get();
 }
 
 const Package*
@@ -28,3 +28,9 @@ code_provenance_add_packages(std::unordered_map<std::string_view, std::string_vi
 {
     Datadog::CodeProvenance::get_instance().add_packages(distributions);
 }
+
+const char*
+code_provenance_classify_path(std::string_view path)
+{
+    return Datadog::CodeProvenance::get_instance().classify_path(path);
+}
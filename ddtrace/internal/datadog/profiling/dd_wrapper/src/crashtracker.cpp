@@ -1,9 +1,17 @@
 #include "crashtracker.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 void
@@ -12,6 +20,13 @@ Datadog::Crashtracker::set_create_alt_stack(bool _create_alt_stack)
     create_alt_stack = _create_alt_stack;
 }
 
+void
+Datadog::Crashtracker::set_alt_stack_size(uint64_t _alt_stack_size)
+{
+    // Clamped to the platform minimum; setup_alt_stack() rounds up to whole pages
+    alt_stack_size = std::max<uint64_t>(_alt_stack_size, MINSIGSTKSZ);
+}
+
 void
 Datadog::Crashtracker::set_wait_for_receiver(bool _wait)
 {
@@ -22,42 +37,49 @@ void
 Datadog::Crashtracker::set_env(std::string_view _env)
 {
     env = std::string(_env);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_service(std::string_view _service)
 {
     service = std::string(_service);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_version(std::string_view _version)
 {
     version = std::string(_version);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_runtime(std::string_view _runtime)
 {
     runtime = std::string(_runtime);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_runtime_id(std::string_view _runtime_id)
 {
     runtime_id = std::string(_runtime_id);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_runtime_version(std::string_view _runtime_version)
 {
     runtime_version = std::string(_runtime_version);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
 Datadog::Crashtracker::set_url(std::string_view _url)
 {
     url = std::string(_url);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
@@ -90,6 +112,7 @@ void
 Datadog::Crashtracker::set_library_version(std::string_view _library_version)
 {
     library_version = std::string(_library_version);
+    pending_generation.fetch_add(1, std::memory_order_release);
 }
 
 void
@@ -99,6 +122,7 @@ Datadog::Crashtracker::set_tag(std::string_view key, std::string_view value)
     // and we have another refactor incoming anyway, so let's just kick the can for now
     if (!key.empty() && !value.empty()) {
         user_tags[std::string(key)] = std::string(value);
+        pending_generation.fetch_add(1, std::memory_order_release);
     }
 }
 
@@ -197,15 +221,141 @@ Datadog::Crashtracker::get_metadata(ddog_Vec_Tag& tags)
     return metadata;
 }
 
+bool
+Datadog::Crashtracker::spawn_receiver()
+{
+    if (path_to_receiver_binary.empty()) {
+        return false;
+    }
+
+    // The receiver listens on a per-process socket; embedding the pid keeps concurrent
+    // tracked processes from colliding and makes stale sockets easy to attribute
+    receiver_socket_path = "/tmp/ddtrace_crashtracker_" + std::to_string(getpid()) + ".sock";
+
+    auto pid = fork();
+    if (pid == -1) {
+        std::cerr << "Failed to fork crashtracker receiver: " << strerror(errno) << std::endl;
+        receiver_socket_path.clear();
+        return false;
+    }
+    if (pid == 0) {
+        // Child.  Honor the same stdio redirection the crash-time path would have applied,
+        // then exec the receiver binary.  Socket mode is signaled through the environment
+        // (see crashtracker_receiver_entry in receiver_interface.cpp).
+        if (stdout_filename.has_value()) {
+            int fd = open(stdout_filename.value().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd != -1) {
+                dup2(fd, STDOUT_FILENO);
+                close(fd);
+            }
+        }
+        if (stderr_filename.has_value()) {
+            int fd = open(stderr_filename.value().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd != -1) {
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+        }
+        setenv("DD_CRASHTRACKER_RECEIVER_SOCKET", receiver_socket_path.c_str(), 1);
+        execl(path_to_receiver_binary.c_str(), path_to_receiver_binary.c_str(), static_cast<char*>(nullptr));
+
+        // exec failed; there's nothing useful this child can do
+        _exit(127);
+    }
+
+    receiver_pid = pid;
+    return true;
+}
+
+bool
+Datadog::Crashtracker::setup_alt_stack()
+{
+    if (alt_stack_mapping != nullptr) {
+        return true; // already installed (e.g., restart after fork)
+    }
+
+    // Round the usable region up to whole pages and add one guard page below it, so a
+    // handler that overruns the stack faults deterministically instead of corrupting
+    // whatever the allocator placed next door.
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t usable = ((alt_stack_size + page_size - 1) / page_size) * page_size;
+    const size_t total = usable + page_size;
+
+    void* mapping = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map crashtracker alt stack: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (mprotect(mapping, page_size, PROT_NONE) != 0) {
+        std::cerr << "Failed to guard crashtracker alt stack: " << strerror(errno) << std::endl;
+        munmap(mapping, total);
+        return false;
+    }
+
+    char* stack_base = static_cast<char*>(mapping) + page_size;
+
+    // Touch every page now so the handler never takes a fault on this memory: at crash
+    // time (especially OOM) a page fault is as likely to fail as the crash that got us
+    // there.  mlock is best-effort--RLIMIT_MEMLOCK is often tiny in containers, and the
+    // pre-fault already covers everything short of swap-out.
+    memset(stack_base, 0, usable);
+    (void)mlock(stack_base, usable);
+
+    stack_t ss{};
+    ss.ss_sp = stack_base;
+    ss.ss_size = usable;
+    ss.ss_flags = 0;
+    if (sigaltstack(&ss, nullptr) != 0) {
+        std::cerr << "Failed to install crashtracker alt stack: " << strerror(errno) << std::endl;
+        munmap(mapping, total);
+        return false;
+    }
+
+    alt_stack_mapping = mapping;
+    alt_stack_mapping_size = total;
+    return true;
+}
+
+void
+Datadog::Crashtracker::refault_alt_stack()
+{
+    if (alt_stack_mapping == nullptr) {
+        return;
+    }
+
+    // fork() made our pages copy-on-write and dropped the mlock; re-dirty and re-lock
+    // them here, while we can still afford a failed allocation, rather than in a handler
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    char* stack_base = static_cast<char*>(alt_stack_mapping) + page_size;
+    const size_t usable = alt_stack_mapping_size - page_size;
+    memset(stack_base, 0, usable);
+    (void)mlock(stack_base, usable);
+}
+
 bool
 Datadog::Crashtracker::start()
 {
+    const uint64_t target_generation = pending_generation.load(std::memory_order_acquire);
     auto config = get_config();
-    auto receiver_config = get_receiver_config();
     auto tags = get_tags();
     auto metadata = get_metadata(tags);
 
-    auto result = ddog_crasht_init_with_receiver(config, receiver_config, metadata);
+    // When we can preallocate the alternate signal stack ourselves (pre-faulted, locked,
+    // guard-paged), tell libdatadog not to allocate its own at install time.
+    if (create_alt_stack && setup_alt_stack()) {
+        config.create_alt_stack = false;
+    }
+
+    // Prefer a receiver pre-spawned at startup over crash-time fork/exec: at crash time
+    // (especially OOM) process creation is the least reliable syscall we could lean on,
+    // whereas writing to an already-listening socket requires no new resources.
+    ddog_crasht_Result result;
+    if (spawn_receiver()) {
+        result = ddog_crasht_init_with_unix_socket(config, to_slice(receiver_socket_path), metadata);
+    } else {
+        auto receiver_config = get_receiver_config();
+        result = ddog_crasht_init_with_receiver(config, receiver_config, metadata);
+    }
     ddog_Vec_Tag_drop(tags);
     if (result.tag != DDOG_CRASHT_RESULT_OK) { // NOLINT (cppcoreguidelines-pro-type-union-access)
         auto err = result.err;                 // NOLINT (cppcoreguidelines-pro-type-union-access)
@@ -214,18 +364,38 @@ Datadog::Crashtracker::start()
         ddog_Error_drop(&err);
         return false;
     }
+    applied_generation = target_generation;
     return true;
 }
 
 bool
 Datadog::Crashtracker::atfork_child()
 {
+    const uint64_t target_generation = pending_generation.load(std::memory_order_acquire);
     auto config = get_config();
-    auto receiver_config = get_receiver_config();
     auto tags = get_tags();
     auto metadata = get_metadata(tags);
 
-    auto result = ddog_crasht_update_on_fork(config, receiver_config, metadata);
+    // The mapping and the sigaltstack registration survive fork, but the pages are now
+    // copy-on-write and unlocked; make them crash-ready again before re-initializing.
+    if (alt_stack_mapping != nullptr) {
+        refault_alt_stack();
+        config.create_alt_stack = false;
+    }
+
+    // The pre-spawned receiver belongs to the parent; give the child its own.  If that
+    // fails (or we were never in socket mode), fall back to the crash-time fork/exec path.
+    const bool was_socket_mode = !receiver_socket_path.empty();
+    receiver_pid = -1;
+    receiver_socket_path.clear();
+
+    ddog_crasht_Result result;
+    if (was_socket_mode && spawn_receiver()) {
+        result = ddog_crasht_init_with_unix_socket(config, to_slice(receiver_socket_path), metadata);
+    } else {
+        auto receiver_config = get_receiver_config();
+        result = ddog_crasht_update_on_fork(config, receiver_config, metadata);
+    }
     ddog_Vec_Tag_drop(tags);
     if (result.tag != DDOG_CRASHT_RESULT_OK) { // NOLINT (cppcoreguidelines-pro-type-union-access)
         auto err = result.err;                 // NOLINT (cppcoreguidelines-pro-type-union-access)
@@ -248,6 +418,50 @@ Datadog::Crashtracker::atfork_child()
     auto res_serializing = ddog_crasht_end_op(DDOG_CRASHT_OP_TYPES_PROFILER_SERIALIZING);
     (void)res_serializing;
 
+    applied_generation = target_generation;
+    return true;
+}
+
+bool
+Datadog::Crashtracker::reconfigure()
+{
+    // Push tag/endpoint/runtime-id changes into the live handler.  libdatadog swaps the
+    // stored config and metadata atomically under the hood, so this is safe against a
+    // concurrent crash and costs only the re-serialization below--no receiver resolution,
+    // no signal handler churn.  The generation check makes a no-change refresh free.
+    const uint64_t target = pending_generation.load(std::memory_order_acquire);
+    if (target == applied_generation) {
+        return true;
+    }
+
+    auto config = get_config();
+    if (alt_stack_mapping != nullptr) {
+        config.create_alt_stack = false;
+    }
+    auto config_result = ddog_crasht_update_config(config);
+    if (config_result.tag != DDOG_CRASHT_RESULT_OK) { // NOLINT (cppcoreguidelines-pro-type-union-access)
+        auto err = config_result.err;                 // NOLINT (cppcoreguidelines-pro-type-union-access)
+        std::string errmsg = err_to_msg(&err, "Error updating crash tracker config");
+        std::cerr << errmsg << std::endl;
+        ddog_Error_drop(&err);
+        return false;
+    }
+
+    auto tags = get_tags();
+    auto metadata = get_metadata(tags);
+    auto metadata_result = ddog_crasht_update_metadata(metadata);
+    ddog_Vec_Tag_drop(tags);
+    if (metadata_result.tag != DDOG_CRASHT_RESULT_OK) { // NOLINT (cppcoreguidelines-pro-type-union-access)
+        auto err = metadata_result.err;                 // NOLINT (cppcoreguidelines-pro-type-union-access)
+        std::string errmsg = err_to_msg(&err, "Error updating crash tracker metadata");
+        std::cerr << errmsg << std::endl;
+        ddog_Error_drop(&err);
+        return false;
+    }
+
+    // Setters racing with this apply bump the generation past `target` and the next
+    // refresh picks them up; that is the intended eventually-consistent behavior.
+    applied_generation = target;
     return true;
 }
 
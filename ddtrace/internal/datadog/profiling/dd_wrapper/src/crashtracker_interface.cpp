@@ -1,5 +1,6 @@
 #include "crashtracker_interface.hpp"
 #include "crashtracker.hpp"
+#include "fork_registry.hpp"
 
 #include <fcntl.h>
 #include <pthread.h>
@@ -93,6 +94,12 @@ crashtracker_set_alt_stack(bool alt_stack) // cppcheck-suppress unusedFunction
     crashtracker.set_create_alt_stack(alt_stack);
 }
 
+void
+crashtracker_set_alt_stack_size(uint64_t size) // cppcheck-suppress unusedFunction
+{
+    crashtracker.set_alt_stack_size(size);
+}
+
 void
 crashtracker_set_wait_for_receiver(bool wait) // cppcheck-suppress unusedFunction
 {
@@ -173,13 +180,27 @@ crashtracker_start() // cppcheck-suppress unusedFunction
         sa.sa_sigaction = close_stderr_chainer;
         sigaction(SIGBUS, &sa, nullptr);
 
-        // Also install the post-fork handler for the child process
-        pthread_atfork(nullptr, nullptr, crashtracker_postfork_child);
+        // Also install the post-fork handler for the child process. The
+        // crashtracker re-arms its receiver, which is restart work that must
+        // come after the other extensions have reset their state.
+        Datadog::ForkRegistry::register_handlers(Datadog::ForkRegistry::Phase::Restart,
+                                                 { nullptr, nullptr, crashtracker_postfork_child });
         return true;
     }();
     (void)initialized;
 }
 
+bool
+crashtracker_reconfigure() // cppcheck-suppress unusedFunction
+{
+    // Tag/endpoint refreshes (config poller, DD_TAGS reload) go through the in-place
+    // update path; a full crashtracker_start() is only needed the first time.
+    if (!crashtracker_initialized) {
+        return false;
+    }
+    return crashtracker.reconfigure();
+}
+
 void
 crashtracker_profiling_state_sampling_start() // cppcheck-suppress unusedFunction
 {
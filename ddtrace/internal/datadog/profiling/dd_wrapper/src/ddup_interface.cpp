@@ -1,13 +1,18 @@
 #include "ddup_interface.hpp"
 
 #include "code_provenance.hpp"
+#include "fork_registry.hpp"
+#include "helper_threads.hpp"
+#include "telemetry_counters.hpp"
 #include "libdatadog_helpers.hpp"
 #include "profile.hpp"
 #include "sample.hpp"
 #include "sample_manager.hpp"
+#include "upload_pipeline.hpp"
 #include "uploader.hpp"
 #include "uploader_builder.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <unistd.h>
@@ -21,7 +26,9 @@ std::once_flag ddup_init_flag;    // NOLINT (cppcoreguidelines-avoid-non-const-g
 void
 ddup_postfork_child()
 {
+    Datadog::UploadPipeline::postfork_child();
     Datadog::Uploader::postfork_child();
+    Datadog::UploaderBuilder::postfork_child();
     Datadog::SampleManager::postfork_child();
     Datadog::CodeProvenance::postfork_child();
 }
@@ -29,6 +36,7 @@ ddup_postfork_child()
 void
 ddup_postfork_parent()
 {
+    Datadog::UploadPipeline::postfork_parent();
     Datadog::Uploader::postfork_parent();
 }
 
@@ -39,6 +47,7 @@ ddup_postfork_parent()
 void
 ddup_prefork()
 {
+    Datadog::UploadPipeline::prefork();
     Datadog::Uploader::prefork();
 }
 
@@ -115,18 +124,48 @@ ddup_config_timeline(bool enabled) // cppcheck-suppress unusedFunction
     Datadog::SampleManager::set_timeline(enabled);
 }
 
+void
+ddup_config_timeline_granularity_ns(int64_t granularity_ns) // cppcheck-suppress unusedFunction
+{
+    Datadog::SampleManager::set_timeline_granularity(granularity_ns);
+}
+
 void
 ddup_config_output_filename(std::string_view output_filename) // cppcheck-suppress unusedFunction
 {
     Datadog::UploaderBuilder::set_output_filename(output_filename);
 }
 
+void
+ddup_config_output_ringfile(std::string_view filename, uint64_t capacity) // cppcheck-suppress unusedFunction
+{
+    Datadog::UploaderBuilder::set_output_ringfile(filename, capacity);
+}
+
 void
 ddup_config_sample_pool_capacity(uint64_t capacity) // cppcheck-suppress unusedFunction
 {
     Datadog::SampleManager::set_sample_pool_capacity(capacity);
 }
 
+void
+ddup_config_prewarm_string(std::string_view str) // cppcheck-suppress unusedFunction
+{
+    Datadog::SampleManager::add_prewarm_string(str);
+}
+
+void
+ddup_config_helper_thread_niceness(int niceness) // cppcheck-suppress unusedFunction
+{
+    Datadog::HelperThreads::set_niceness(niceness);
+}
+
+void
+ddup_config_helper_thread_cpu_affinity(const int* cpus, size_t ncpus) // cppcheck-suppress unusedFunction
+{
+    Datadog::HelperThreads::set_cpu_affinity(cpus, ncpus);
+}
+
 bool
 ddup_is_initialized() // cppcheck-suppress unusedFunction
 {
@@ -140,9 +179,14 @@ ddup_start() // cppcheck-suppress unusedFunction
         // Perform any one-time startup operations
         Datadog::SampleManager::init();
 
-        // install the ddup_fork_handler for pthread_atfork
-        // Right now, only do things in the child _after_ fork
-        pthread_atfork(ddup_prefork, ddup_postfork_parent, ddup_postfork_child);
+        // Register the fork handlers: quiescing uploads belongs to the
+        // stop-threads phase, rebuilding the child's upload state to the
+        // reset-state phase, so the shared registry orders them against the
+        // other extensions' handlers.
+        Datadog::ForkRegistry::register_handlers(Datadog::ForkRegistry::Phase::StopThreads,
+                                                 { ddup_prefork, ddup_postfork_parent, nullptr });
+        Datadog::ForkRegistry::register_handlers(Datadog::ForkRegistry::Phase::ResetState,
+                                                 { nullptr, nullptr, ddup_postfork_child });
 
         // Set the global initialization flag
         is_ddup_initialized = true;
@@ -169,6 +213,12 @@ ddup_push_cputime(Datadog::Sample* sample, int64_t cputime, int64_t count) // cp
     sample->push_cputime(cputime, count);
 }
 
+void
+ddup_push_gil_wait(Datadog::Sample* sample, int64_t wait_time, int64_t count) // cppcheck-suppress unusedFunction
+{
+    sample->push_gil_wait(wait_time, count);
+}
+
 void
 ddup_push_acquire(Datadog::Sample* sample, int64_t acquire_time, int64_t count) // cppcheck-suppress unusedFunction
 {
@@ -220,6 +270,71 @@ ddup_push_task_name(Datadog::Sample* sample, std::string_view task_name) // cppc
     sample->push_task_name(task_name);
 }
 
+uint64_t
+ddup_intern_string(std::string_view str) // cppcheck-suppress unusedFunction
+{
+    return Datadog::Sample::intern_string(str);
+}
+
+void
+ddup_push_threadinfo_id(Datadog::Sample* sample, // cppcheck-suppress unusedFunction
+                        int64_t thread_id,
+                        int64_t thread_native_id,
+                        uint64_t thread_name_id)
+{
+    sample->push_threadinfo_id(thread_id, thread_native_id, thread_name_id);
+}
+
+void
+ddup_push_task_name_id(Datadog::Sample* sample, uint64_t task_name_id) // cppcheck-suppress unusedFunction
+{
+    sample->push_task_name_id(task_name_id);
+}
+
+void
+ddup_push_trace_type_id(Datadog::Sample* sample, uint64_t trace_type_id) // cppcheck-suppress unusedFunction
+{
+    sample->push_trace_type_id(trace_type_id);
+}
+
+uint64_t
+ddup_labelset_new() // cppcheck-suppress unusedFunction
+{
+    return Datadog::Sample::labelset_new();
+}
+
+void
+ddup_labelset_add_str(uint64_t labelset_id, unsigned int key, std::string_view val) // cppcheck-suppress unusedFunction
+{
+    if (key >= static_cast<unsigned int>(Datadog::ExportLabelKey::Length_)) {
+        return;
+    }
+    Datadog::Sample::labelset_add(labelset_id, static_cast<Datadog::ExportLabelKey>(key), val);
+}
+
+void
+ddup_labelset_add_num(uint64_t labelset_id, unsigned int key, int64_t val) // cppcheck-suppress unusedFunction
+{
+    if (key >= static_cast<unsigned int>(Datadog::ExportLabelKey::Length_)) {
+        return;
+    }
+    Datadog::Sample::labelset_add(labelset_id, static_cast<Datadog::ExportLabelKey>(key), val);
+}
+
+void
+ddup_push_labelset(Datadog::Sample* sample, uint64_t labelset_id) // cppcheck-suppress unusedFunction
+{
+    sample->push_labelset(labelset_id);
+}
+
+void
+ddup_push_exceptioninfo_id(Datadog::Sample* sample, // cppcheck-suppress unusedFunction
+                           uint64_t exception_type_id,
+                           int64_t count)
+{
+    sample->push_exceptioninfo_id(exception_type_id, count);
+}
+
 void
 ddup_push_span_id(Datadog::Sample* sample, uint64_t span_id) // cppcheck-suppress unusedFunction
 {
@@ -268,6 +383,79 @@ ddup_push_monotonic_ns(Datadog::Sample* sample, int64_t monotonic_ns) // cppchec
     sample->push_monotonic_ns(monotonic_ns);
 }
 
+void
+ddup_push_batch(const ddup_SampleSpec* specs, size_t nspecs) // cppcheck-suppress unusedFunction
+{
+    if (specs == nullptr) {
+        return;
+    }
+
+    for (size_t i = 0; i < nspecs; i++) {
+        const ddup_SampleSpec& spec = specs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        Datadog::Sample* sample = Datadog::SampleManager::start_sample();
+
+        if (spec.walltime != 0) {
+            sample->push_walltime(spec.walltime, spec.count);
+        }
+        if (spec.cputime != 0) {
+            sample->push_cputime(spec.cputime, spec.count);
+        }
+        if (spec.lock_acquire_time != 0) {
+            sample->push_acquire(spec.lock_acquire_time, spec.count);
+        }
+        if (spec.lock_release_time != 0) {
+            sample->push_release(spec.lock_release_time, spec.count);
+        }
+        if (spec.thread_id != 0 || spec.thread_native_id != 0 || !spec.thread_name.empty()) {
+            sample->push_threadinfo(spec.thread_id, spec.thread_native_id, spec.thread_name);
+        }
+        if (spec.task_id != 0) {
+            sample->push_task_id(spec.task_id);
+        }
+        if (!spec.task_name.empty()) {
+            sample->push_task_name(spec.task_name);
+        }
+        if (spec.span_id != 0) {
+            sample->push_span_id(spec.span_id);
+        }
+        if (spec.local_root_span_id != 0) {
+            sample->push_local_root_span_id(spec.local_root_span_id);
+        }
+        if (!spec.trace_type.empty()) {
+            sample->push_trace_type(spec.trace_type);
+        }
+        if (!spec.exception_type.empty()) {
+            sample->push_exceptioninfo(spec.exception_type, spec.exception_count);
+        }
+        if (!spec.class_name.empty()) {
+            sample->push_class_name(spec.class_name);
+        }
+        if (!spec.lock_name.empty()) {
+            sample->push_lock_name(spec.lock_name);
+        }
+
+        // We know the whole stack up-front, so don't walk the tail that
+        // push_frame would drop anyway; the +1 matches push_frame's limit
+        // (one extra slot for the truncation sentinel's replacement frame)
+        const size_t nkeep =
+          std::min(spec.nframes, static_cast<size_t>(Datadog::SampleManager::get_max_nframes()) + 1);
+        for (size_t j = 0; j < nkeep; j++) {
+            const ddup_FrameSpec& frame = spec.frames[j]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            sample->push_frame(frame.name, frame.filename, frame.address, frame.line);
+        }
+        if (spec.nframes > nkeep) {
+            sample->add_dropped_frames(static_cast<int64_t>(spec.nframes - nkeep));
+        }
+
+        if (spec.monotonic_ns != 0) {
+            sample->push_monotonic_ns(spec.monotonic_ns);
+        }
+
+        sample->flush_sample(spec.reverse_locations);
+        Datadog::SampleManager::drop_sample(sample);
+    }
+}
+
 void
 ddup_flush_sample(Datadog::Sample* sample) // cppcheck-suppress unusedFunction
 {
@@ -286,6 +474,32 @@ ddup_drop_sample(Datadog::Sample* sample) // cppcheck-suppress unusedFunction
     Datadog::SampleManager::drop_sample(sample);
 }
 
+uint64_t
+ddup_get_sample_pool_exhaustion_count() // cppcheck-suppress unusedFunction
+{
+    return Datadog::SampleManager::get_pool_exhaustion_count();
+}
+
+uint64_t
+ddup_get_sample_pool_overflow_count() // cppcheck-suppress unusedFunction
+{
+    return Datadog::SampleManager::get_pool_overflow_count();
+}
+
+uint64_t
+ddup_get_sample_pool_capacity() // cppcheck-suppress unusedFunction
+{
+    return static_cast<uint64_t>(Datadog::SampleManager::get_pool_capacity());
+}
+
+size_t
+ddup_counter_snapshot(ddup_CounterEntry* entries, size_t max_entries) // cppcheck-suppress unusedFunction
+{
+    static_assert(sizeof(ddup_CounterEntry) == sizeof(Datadog::Telemetry::CounterEntry),
+                  "interface struct must mirror the registry entry");
+    return Datadog::Telemetry::snapshot(reinterpret_cast<Datadog::Telemetry::CounterEntry*>(entries), max_entries);
+}
+
 bool
 ddup_upload() // cppcheck-suppress unusedFunction
 {
@@ -297,23 +511,33 @@ ddup_upload() // cppcheck-suppress unusedFunction
     bool success = false;
     {
         // There are a few things going on here.
-        //   * profile_borrow takes a reference in a way that locks the areas where the profile might
-        //     be modified.  It gets released and cleared after uploading.
-        //   * Uploading cancels inflight uploads. There are better ways to do this, but this is what
-        //     we have for now.
+        //   * profile_seal rotates the double-buffered profile state and hands back the sealed
+        //     half; samplers keep writing into the fresh active half in the meantime.
+        //   * Serialization has to finish before profile_unseal (the sealed buffer is reused by
+        //     the next rotation), but the encoded payload is self-contained, so the network send
+        //     is handed to the exporter thread and this call returns without touching the wire.
         auto uploader = Datadog::UploaderBuilder::build();
         struct
         {
+            bool enqueued = false;
             void operator()(Datadog::Uploader& uploader)
             {
-                uploader.upload(Datadog::Sample::profile_borrow());
-                Datadog::Sample::profile_release();
-                Datadog::Sample::profile_clear_state();
+                auto encoded = uploader.serialize(Datadog::Sample::profile_seal());
+                Datadog::Sample::profile_unseal();
+                if (encoded.has_value()) {
+                    Datadog::UploadPipeline::enqueue(std::move(uploader), encoded.value());
+                    enqueued = true;
+                }
             }
             void operator()(const std::string& err) { std::cerr << "Failed to create uploader: " << err << std::endl; }
         } visitor;
         std::visit(visitor, uploader);
+        success = visitor.enqueued;
     }
+
+    // Export boundaries are the natural off-hot-path point to let the sample
+    // pool react to the pressure observed during the window
+    Datadog::SampleManager::adjust_pool_capacity();
     return success;
 }
 
@@ -335,6 +559,51 @@ ddup_profile_set_endpoints(
     Datadog::Sample::profile_release();
 }
 
+void
+ddup_profile_set_endpoints_batch(const ddup_EndpointSpec* specs, size_t nspecs) // cppcheck-suppress unusedFunction
+{
+    if (specs == nullptr) {
+        return;
+    }
+
+    ddog_prof_Profile& profile = Datadog::Sample::profile_borrow();
+    for (size_t i = 0; i < nspecs; i++) {
+        const ddup_EndpointSpec& spec = specs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const ddog_CharSlice endpoint_slice = Datadog::to_slice(spec.endpoint);
+        auto res = ddog_prof_Profile_set_endpoint(&profile, spec.span_id, endpoint_slice);
+        if (!res.ok) {
+            auto err = res.err;
+            const std::string errmsg = Datadog::err_to_msg(&err, "Error setting endpoint");
+            std::cerr << errmsg << std::endl;
+            ddog_Error_drop(&err);
+        }
+    }
+    Datadog::Sample::profile_release();
+}
+
+void
+ddup_profile_add_endpoint_counts_batch(const ddup_EndpointCountSpec* specs, // cppcheck-suppress unusedFunction
+                                       size_t nspecs)
+{
+    if (specs == nullptr) {
+        return;
+    }
+
+    ddog_prof_Profile& profile = Datadog::Sample::profile_borrow();
+    for (size_t i = 0; i < nspecs; i++) {
+        const ddup_EndpointCountSpec& spec = specs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const ddog_CharSlice endpoint_slice = Datadog::to_slice(spec.endpoint);
+        auto res = ddog_prof_Profile_add_endpoint_count(&profile, endpoint_slice, spec.count);
+        if (!res.ok) {
+            auto err = res.err;
+            const std::string errmsg = Datadog::err_to_msg(&err, "Error adding endpoint count");
+            std::cerr << errmsg << std::endl;
+            ddog_Error_drop(&err);
+        }
+    }
+    Datadog::Sample::profile_release();
+}
+
 void
 ddup_profile_add_endpoint_counts(std::map<std::string_view, int64_t> trace_endpoints_to_counts)
 {
@@ -0,0 +1,91 @@
+#include "fork_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t phase_count = 3;
+
+// Heap-allocated and intentionally leaked so the atfork callbacks, which
+// stay installed for the life of the process, never run against destroyed
+// statics during exit.
+std::mutex&
+registry_mtx()
+{
+    static auto* mtx = new std::mutex();
+    return *mtx;
+}
+
+std::array<std::vector<Datadog::ForkRegistry::Handlers>, phase_count>&
+phase_lists()
+{
+    static auto* lists = new std::array<std::vector<Datadog::ForkRegistry::Handlers>, phase_count>();
+    return *lists;
+}
+
+} // namespace
+
+void
+Datadog::ForkRegistry::run_prefork()
+{
+    // pthread_atfork prepare handlers run to completion before the fork, so
+    // the registry lock is free again by the time the process forks.
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+    for (const auto& list : phase_lists()) {
+        for (const auto& handlers : list) {
+            if (handlers.prefork != nullptr) {
+                handlers.prefork();
+            }
+        }
+    }
+}
+
+void
+Datadog::ForkRegistry::run_postfork_parent()
+{
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+    for (const auto& list : phase_lists()) {
+        for (const auto& handlers : list) {
+            if (handlers.postfork_parent != nullptr) {
+                handlers.postfork_parent();
+            }
+        }
+    }
+}
+
+void
+Datadog::ForkRegistry::run_postfork_child()
+{
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+    for (const auto& list : phase_lists()) {
+        for (const auto& handlers : list) {
+            if (handlers.postfork_child != nullptr) {
+                handlers.postfork_child();
+            }
+        }
+    }
+}
+
+void
+Datadog::ForkRegistry::register_handlers(Phase phase, const Handlers& handlers)
+{
+    static std::once_flag atfork_once;
+    std::call_once(atfork_once, []() { pthread_atfork(run_prefork, run_postfork_parent, run_postfork_child); });
+
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+    auto& list = phase_lists()[static_cast<size_t>(phase)];
+
+    // Idempotent: one-time-start blocks can re-run after a fork without
+    // stacking duplicate handlers.
+    const auto is_same = [&handlers](const Handlers& other) {
+        return other.prefork == handlers.prefork && other.postfork_parent == handlers.postfork_parent &&
+               other.postfork_child == handlers.postfork_child;
+    };
+    if (std::none_of(list.begin(), list.end(), is_same)) {
+        list.push_back(handlers);
+    }
+}
@@ -0,0 +1,82 @@
+#include "helper_threads.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <pthread.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<int> configured_niceness{ Datadog::HelperThreads::no_niceness };
+
+// The cpuset is written once at configuration time (before any helper thread
+// starts) and only read afterwards, but guard it anyway since configuration
+// and a post-fork thread relaunch can in principle overlap
+std::mutex cpuset_mtx; // NOLINT (cppcoreguidelines-avoid-non-const-global-variables)
+std::vector<int> configured_cpus; // NOLINT (cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
+void
+Datadog::HelperThreads::set_niceness(int niceness)
+{
+    configured_niceness.store(niceness, std::memory_order_relaxed);
+}
+
+void
+Datadog::HelperThreads::set_cpu_affinity(const int* cpus, size_t ncpus)
+{
+    const std::lock_guard<std::mutex> lock(cpuset_mtx);
+    configured_cpus.assign(cpus, cpus + ncpus);
+}
+
+void
+Datadog::HelperThreads::apply_attributes(const char* name, int default_niceness)
+{
+    // Thread names are limited to 15 characters + NUL on Linux; truncate
+    // rather than fail
+    char truncated[16];
+    std::strncpy(truncated, name, sizeof(truncated) - 1);
+    truncated[sizeof(truncated) - 1] = '\0';
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), truncated);
+#elif defined(__APPLE__)
+    pthread_setname_np(truncated);
+#endif
+
+#ifdef __linux__
+    // Raising one's own niceness requires no privileges and failure is
+    // harmless, so return values are ignored throughout
+    int niceness = configured_niceness.load(std::memory_order_relaxed);
+    if (niceness == no_niceness) {
+        niceness = default_niceness;
+    }
+    if (niceness != no_niceness) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), niceness);
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(cpuset_mtx);
+        if (!configured_cpus.empty()) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            for (const int cpu : configured_cpus) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                    CPU_SET(cpu, &cpuset);
+                }
+            }
+            sched_setaffinity(0, sizeof(cpuset), &cpuset);
+        }
+    }
+#else
+    (void)default_niceness;
+#endif
+}
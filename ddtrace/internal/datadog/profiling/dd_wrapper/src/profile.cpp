@@ -1,6 +1,8 @@
 #include "profile.hpp"
 #include "libdatadog_helpers.hpp"
 
+#include <array>
+#include <cstring>
 #include <functional>
 #include <iostream>
 
@@ -30,17 +32,286 @@ make_profile(const ddog_prof_Slice_ValueType& sample_types,
     return true;
 }
 
+// FNV-1a style mixing for the aggregation key.  Hash quality matters less
+// than speed here: a collision only costs an extra equality check within the
+// bucket.
+inline uint64_t
+hash_combine(uint64_t hash, uint64_t value)
+{
+    constexpr uint64_t fnv_prime = 0x100000001b3ULL;
+    return (hash ^ value) * fnv_prime;
+}
+
+// Frame string slices point into the interned string table, so the pointer
+// identifies the content and there is no need to hash the bytes themselves.
+inline uint64_t
+hash_slice(uint64_t hash, const ddog_CharSlice& slice)
+{
+    hash = hash_combine(hash, reinterpret_cast<uint64_t>(slice.ptr));
+    return hash_combine(hash, slice.len);
+}
+
+// Label strings live in the sample's transient arena and are not interned, so
+// they are hashed and compared by content (they are short: thread/task/class
+// names and the like).
+inline uint64_t
+hash_slice_bytes(uint64_t hash, const ddog_CharSlice& slice)
+{
+    for (size_t i = 0; i < slice.len; ++i) {
+        hash = hash_combine(hash, static_cast<uint8_t>(slice.ptr[i]));
+    }
+    return hash;
+}
+
+inline bool
+slice_content_eq(const ddog_CharSlice& lhs, const ddog_CharSlice& rhs)
+{
+    return lhs.len == rhs.len && (lhs.len == 0 || std::memcmp(lhs.ptr, rhs.ptr, lhs.len) == 0);
+}
+
+inline uint64_t
+hash_sample_key(const ddog_prof_Sample& sample)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV offset basis
+    for (size_t i = 0; i < sample.locations.len; ++i) {
+        const auto& loc = sample.locations.ptr[i];
+        hash = hash_slice(hash, loc.function.name);
+        hash = hash_slice(hash, loc.function.filename);
+        hash = hash_combine(hash, loc.address);
+        hash = hash_combine(hash, static_cast<uint64_t>(loc.line));
+    }
+    for (size_t i = 0; i < sample.labels.len; ++i) {
+        const auto& label = sample.labels.ptr[i];
+        hash = hash_slice_bytes(hash, label.key);
+        hash = hash_slice_bytes(hash, label.str);
+        hash = hash_slice_bytes(hash, label.num_unit);
+        hash = hash_combine(hash, static_cast<uint64_t>(label.num));
+    }
+    return hash;
+}
+
+inline bool
+slice_eq(const ddog_CharSlice& lhs, const ddog_CharSlice& rhs)
+{
+    // Pointer comparison is sound for the same interning reason as above
+    return lhs.ptr == rhs.ptr && lhs.len == rhs.len;
+}
+
+inline bool
+locations_equal(const std::vector<ddog_prof_Location>& stored, const ddog_prof_Slice_Location& incoming)
+{
+    if (stored.size() != incoming.len) {
+        return false;
+    }
+    for (size_t i = 0; i < stored.size(); ++i) {
+        const auto& lhs = stored[i];
+        const auto& rhs = incoming.ptr[i];
+        if (!slice_eq(lhs.function.name, rhs.function.name) ||
+            !slice_eq(lhs.function.filename, rhs.function.filename) || lhs.address != rhs.address ||
+            lhs.line != rhs.line) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool
+labels_equal(const std::vector<ddog_prof_Label>& stored, const ddog_prof_Slice_Label& incoming)
+{
+    if (stored.size() != incoming.len) {
+        return false;
+    }
+    for (size_t i = 0; i < stored.size(); ++i) {
+        const auto& lhs = stored[i];
+        const auto& rhs = incoming.ptr[i];
+        if (!slice_content_eq(lhs.key, rhs.key) || !slice_content_eq(lhs.str, rhs.str) ||
+            !slice_content_eq(lhs.num_unit, rhs.num_unit) || lhs.num != rhs.num) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }
 
 bool
-Datadog::Profile::cycle_buffers()
+Datadog::Profile::collect_aggregated(const ddog_prof_Sample& sample, int64_t endtime_ns)
 {
     const std::lock_guard<std::mutex> lock(profile_mtx);
 
-    std::swap(last_profile, cur_profile);
+    // Timestamp-free samples go to the persistent cumulative table and are
+    // exported as per-cycle deltas; timestamped ones can never recur across
+    // cycles and stay in the per-window table.
+    auto& table = (endtime_ns == 0) ? cumulative_samples : aggregated_samples;
 
-    // Clear the profile before using it
-    auto res = ddog_prof_Profile_reset(&cur_profile, nullptr);
+    const uint64_t key = hash_combine(hash_sample_key(sample), static_cast<uint64_t>(endtime_ns));
+    auto& bucket = table[key];
+    for (auto& agg : bucket) {
+        if (agg.endtime_ns == endtime_ns && agg.values.size() == sample.values.len &&
+            locations_equal(agg.locations, sample.locations) && labels_equal(agg.labels, sample.labels)) {
+            for (size_t i = 0; i < agg.values.size(); ++i) {
+                agg.values[i] += sample.values.ptr[i];
+            }
+            return true;
+        }
+    }
+
+    // First time we see this stack in the current upload window.  Location
+    // slices stay valid because they point into interned storage.
+    if (!aggregated_freelist.empty()) {
+        bucket.emplace_back(std::move(aggregated_freelist.back()));
+        aggregated_freelist.pop_back();
+    } else {
+        bucket.emplace_back();
+    }
+    auto& agg = bucket.back();
+    agg.locations.assign(sample.locations.ptr, sample.locations.ptr + sample.locations.len);
+    agg.labels.assign(sample.labels.ptr, sample.labels.ptr + sample.labels.len);
+    agg.values.assign(sample.values.ptr, sample.values.ptr + sample.values.len);
+    agg.endtime_ns = endtime_ns;
+    if (endtime_ns == 0) {
+        // Nothing exported for this stack yet; the first flush emits the full
+        // accumulated values as its delta
+        agg.exported.assign(sample.values.len, 0);
+        agg.idle_cycles = 0;
+    }
+
+    // Label strings point into the sample's arena, which is recycled as soon
+    // as the sample is flushed; re-home them in the interned table so the
+    // aggregated entry survives until export.  This happens once per distinct
+    // stack per window, so it doesn't reintroduce the per-push interning cost.
+    for (auto& label : agg.labels) {
+        if (label.str.len > 0) {
+            label.str = to_slice(insert_or_get({ label.str.ptr, label.str.len }));
+        }
+        if (label.num_unit.len > 0) {
+            label.num_unit = to_slice(insert_or_get({ label.num_unit.ptr, label.num_unit.len }));
+        }
+    }
+    return true;
+}
+
+void
+Datadog::Profile::recycle_aggregated_locked(AggregatedSample& agg)
+{
+    // Keep the entry's vector storage for the next window; the first samples
+    // after an upload then find warm capacity instead of paying the table's
+    // allocation costs all over again
+    if (aggregated_freelist.size() >= g_aggregation_freelist_max) {
+        return;
+    }
+    agg.locations.clear();
+    agg.labels.clear();
+    agg.values.clear();
+    agg.exported.clear();
+    agg.idle_cycles = 0;
+    agg.endtime_ns = 0;
+    aggregated_freelist.emplace_back(std::move(agg));
+}
+
+bool
+Datadog::Profile::flush_aggregated_locked()
+{
+    bool ret = true;
+    for (auto& [key, bucket] : aggregated_samples) {
+        (void)key;
+        for (auto& agg : bucket) {
+            const ddog_prof_Sample sample = {
+                .locations = { agg.locations.data(), agg.locations.size() },
+                .values = { agg.values.data(), agg.values.size() },
+                .labels = { agg.labels.data(), agg.labels.size() },
+            };
+            auto res = ddog_prof_Profile_add(&cur_profile, sample, agg.endtime_ns);
+            if (!res.ok) {          // NOLINT (cppcoreguidelines-pro-type-union-access)
+                auto err = res.err; // NOLINT (cppcoreguidelines-pro-type-union-access)
+                const std::string errmsg = err_to_msg(&err, "Error adding aggregated sample to profile");
+                std::cerr << errmsg << std::endl;
+                ddog_Error_drop(&err);
+                ret = false;
+            }
+
+            recycle_aggregated_locked(agg);
+        }
+    }
+    // clear() keeps the map's bucket array, so the table itself stays warm too
+    aggregated_samples.clear();
+    return ret;
+}
+
+bool
+Datadog::Profile::flush_deltas_locked()
+{
+    // Persistent entries are not torn down at export: each cycle emits the
+    // difference between the accumulated values and what previous cycles
+    // already exported, so the per-cycle output is identical to rebuilding the
+    // table from scratch while the entry itself stays warm.
+    bool ret = true;
+    std::vector<int64_t> delta{};
+    for (auto bucket_it = cumulative_samples.begin(); bucket_it != cumulative_samples.end();) {
+        auto& bucket = bucket_it->second;
+        for (auto it = bucket.begin(); it != bucket.end();) {
+            auto& agg = *it;
+            delta.assign(agg.values.size(), 0);
+            bool changed = false;
+            for (size_t i = 0; i < agg.values.size(); ++i) {
+                delta[i] = agg.values[i] - agg.exported[i];
+                changed = changed || (delta[i] != 0);
+            }
+
+            if (!changed) {
+                // Stack stopped recurring; retire the entry once it has sat
+                // idle long enough that it's unlikely to come back
+                if (++agg.idle_cycles >= g_delta_retire_cycles) {
+                    recycle_aggregated_locked(agg);
+                    it = bucket.erase(it);
+                    continue;
+                }
+                ++it;
+                continue;
+            }
+
+            const ddog_prof_Sample sample = {
+                .locations = { agg.locations.data(), agg.locations.size() },
+                .values = { delta.data(), delta.size() },
+                .labels = { agg.labels.data(), agg.labels.size() },
+            };
+            auto res = ddog_prof_Profile_add(&cur_profile, sample, 0);
+            if (!res.ok) {          // NOLINT (cppcoreguidelines-pro-type-union-access)
+                auto err = res.err; // NOLINT (cppcoreguidelines-pro-type-union-access)
+                const std::string errmsg = err_to_msg(&err, "Error adding delta sample to profile");
+                std::cerr << errmsg << std::endl;
+                ddog_Error_drop(&err);
+                ret = false;
+            }
+            agg.exported = agg.values;
+            agg.idle_cycles = 0;
+            ++it;
+        }
+        if (bucket.empty()) {
+            bucket_it = cumulative_samples.erase(bucket_it);
+        } else {
+            ++bucket_it;
+        }
+    }
+    return ret;
+}
+
+bool
+Datadog::Profile::cycle_buffers()
+{
+    // Rotating swaps last_profile out from under any in-progress export, so
+    // exclude exports here as well (same lock order as profile_seal)
+    const std::lock_guard<std::mutex> upload_lock(upload_mtx);
+    const std::lock_guard<std::mutex> lock(profile_mtx);
+    return cycle_buffers_locked();
+}
+
+bool
+Datadog::Profile::reset_profile_locked(ddog_prof_Profile& profile)
+{
+    // In-place reset: libdatadog keeps its table allocations live, so this is
+    // a warm clear, not a rebuild
+    auto res = ddog_prof_Profile_reset(&profile, nullptr);
     if (!res.ok) {          // NOLINT (cppcoreguidelines-pro-type-union-access)
         auto err = res.err; // NOLINT (cppcoreguidelines-pro-type-union-access)
         const std::string errmsg = err_to_msg(&err, "Error resetting profile");
@@ -51,6 +322,24 @@ Datadog::Profile::cycle_buffers()
     return true;
 }
 
+bool
+Datadog::Profile::cycle_buffers_locked()
+{
+    // Hand the accumulated (stack, labels) entries to cur_profile before it
+    // becomes last_profile and gets exported
+    const bool agg_ok = flush_aggregated_locked();
+    const bool delta_ok = flush_deltas_locked();
+    const bool flush_ok = agg_ok && delta_ok;
+
+    std::swap(last_profile, cur_profile);
+
+    // Clear the profile before using it
+    if (!reset_profile_locked(cur_profile)) {
+        return false;
+    }
+    return flush_ok;
+}
+
 void
 Datadog::Profile::setup_samplers()
 {
@@ -89,6 +378,10 @@ Datadog::Profile::setup_samplers()
     if (0U != (type_mask & SampleType::Heap)) {
         val_idx.heap_space = get_value_idx("heap-space", "bytes");
     }
+    if (0U != (type_mask & SampleType::GILWait)) {
+        val_idx.gil_wait_time = get_value_idx("gil-wait-time", "nanoseconds");
+        val_idx.gil_wait_count = get_value_idx("gil-wait-samples", "count");
+    }
 
     // Whatever the first sampler happens to be is the default "period" for the profile
     // The value of 1 is a pointless default.
@@ -118,6 +411,29 @@ Datadog::Profile::profile_release()
     profile_mtx.unlock();
 }
 
+ddog_prof_Profile&
+Datadog::Profile::profile_seal()
+{
+    // Only other exports wait on this; samplers contend solely on the short
+    // profile_mtx critical section below.
+    upload_mtx.lock();
+    {
+        const std::lock_guard<std::mutex> lock(profile_mtx);
+        cycle_buffers_locked();
+    }
+
+    // last_profile is only touched during buffer rotation, which is excluded
+    // by upload_mtx until profile_unseal(), so the reference is stable even
+    // though profile_mtx is no longer held.
+    return last_profile;
+}
+
+void
+Datadog::Profile::profile_unseal()
+{
+    upload_mtx.unlock();
+}
+
 void
 Datadog::Profile::one_time_init(SampleType type, unsigned int _max_nframes)
 {
@@ -158,10 +474,53 @@ Datadog::Profile::one_time_init(SampleType type, unsigned int _max_nframes)
         return;
     }
 
+    // Seed the interned table while we're still single-threaded
+    prewarm_string_table();
+
     // We're done. Don't do this again.
     first_time.store(false);
 }
 
+void
+Datadog::Profile::prewarm_string_table()
+{
+    // Known-hot strings every Python profile ends up interning; seeding them
+    // here means the first samples after startup hit the table instead of
+    // growing it, and since the table is append-only and inherited across
+    // both buffer cycles and fork, the warmth is permanent.  Anything learned
+    // in one cycle stays interned for all later cycles by construction.
+    constexpr std::array<std::string_view, 10> well_known = {
+        "",          "<module>",   "<lambda>",          "__init__",     "__call__",
+        "<genexpr>", "_bootstrap", "_bootstrap_inner",  "threading.py", "runpy.py",
+    };
+    for (const auto str : well_known) {
+        insert_or_get(str);
+    }
+
+    // Label keys ride along with every sample
+    for (size_t i = 0; i < static_cast<size_t>(ExportLabelKey::Length_); ++i) {
+        insert_or_get(to_string(static_cast<ExportLabelKey>(i)));
+    }
+
+    // Caller-provided hot list (framework dispatch frames and the like)
+    for (const auto& str : user_prewarm) {
+        insert_or_get(str);
+    }
+    user_prewarm.clear();
+}
+
+void
+Datadog::Profile::add_prewarm_string(std::string_view str)
+{
+    if (!first_time.load()) {
+        // Already initialized; interning now has the same effect
+        insert_or_get(str);
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(profile_mtx);
+    user_prewarm.emplace_back(str);
+}
+
 std::string_view
 Datadog::Profile::insert_or_get(std::string_view str)
 {
@@ -177,6 +536,36 @@ Datadog::Profile::insert_or_get(std::string_view str)
     return string_storage.back();
 }
 
+uint64_t
+Datadog::Profile::intern_string_id(std::string_view str)
+{
+    // Interned views are stable for the life of the process (string_storage is
+    // append-only and survives buffer cycles), so the ids handed out here
+    // never dangle
+    const std::string_view interned = insert_or_get(str);
+
+    const std::lock_guard<std::mutex> lock(string_table_mtx); // Serialize access
+    auto id_it = id_by_string.find(interned);
+    if (id_it != id_by_string.end()) {
+        return id_it->second;
+    }
+
+    const uint64_t id = interned_by_id.size();
+    interned_by_id.push_back(interned);
+    id_by_string[interned] = id;
+    return id;
+}
+
+std::string_view
+Datadog::Profile::get_interned_string(uint64_t id)
+{
+    const std::lock_guard<std::mutex> lock(string_table_mtx); // Serialize access
+    if (id >= interned_by_id.size()) {
+        return {};
+    }
+    return interned_by_id[id];
+}
+
 const Datadog::ValueIndex&
 Datadog::Profile::val()
 {
@@ -201,6 +590,32 @@ Datadog::Profile::collect(const ddog_prof_Sample& sample, int64_t endtime_ns)
 void
 Datadog::Profile::postfork_child()
 {
+    upload_mtx.unlock();
     profile_mtx.unlock();
-    cycle_buffers();
+
+    // Warm reinitialization: the immutable half of the state (value types,
+    // samplers, interned strings, aggregation freelist) is inherited from the
+    // parent and stays valid, so the child only resets mutable accumulations.
+    // A 16-worker fork then pays 16x a pair of in-place resets, not 16x cold
+    // table setup.
+    const std::lock_guard<std::mutex> upload_lock(upload_mtx);
+    const std::lock_guard<std::mutex> lock(profile_mtx);
+
+    // The pending aggregation belongs to the parent's profile; recycle the
+    // entries rather than flushing them into the child's first export.  The
+    // cumulative table goes too: its counters (and export baselines) describe
+    // the parent process.
+    for (auto table : { &aggregated_samples, &cumulative_samples }) {
+        for (auto& [key, bucket] : *table) {
+            (void)key;
+            for (auto& agg : bucket) {
+                recycle_aggregated_locked(agg);
+            }
+        }
+        table->clear();
+    }
+
+    // Both halves hold parent samples; clear them in place instead of cycling
+    reset_profile_locked(cur_profile);
+    reset_profile_locked(last_profile);
 }
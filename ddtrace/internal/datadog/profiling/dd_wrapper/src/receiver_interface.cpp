@@ -1,5 +1,7 @@
 #include "receiver_interface.h"
 
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "datadog/crashtracker.h"
@@ -17,8 +19,17 @@ bool
 crashtracker_receiver_entry() // cppcheck-suppress unusedFunction
 {
     // Assumes that this will be called only in the receiver binary, which is a
-    // fresh process
-    ddog_crasht_Result new_result = ddog_crasht_receiver_entry_point_stdin();
+    // fresh process.  When the tracked process pre-spawned us at startup (see
+    // Crashtracker::spawn_receiver), it passes the socket to listen on through the
+    // environment; otherwise we were fork/exec'd at crash time and read from stdin.
+    ddog_crasht_Result new_result;
+    const char* socket_path = getenv("DD_CRASHTRACKER_RECEIVER_SOCKET");
+    if (socket_path != NULL && socket_path[0] != '\0') {
+        ddog_CharSlice socket_slice = { socket_path, strlen(socket_path) };
+        new_result = ddog_crasht_receiver_entry_point_unix_socket(socket_slice);
+    } else {
+        new_result = ddog_crasht_receiver_entry_point_stdin();
+    }
     if (new_result.tag != DDOG_CRASHT_RESULT_OK) {
         ddog_CharSlice message = ddog_Error_message(&new_result.err);
 
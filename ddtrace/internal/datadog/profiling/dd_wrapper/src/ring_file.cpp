@@ -0,0 +1,197 @@
+#include "ring_file.hpp"
+
+#include "telemetry_counters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace Datadog;
+
+namespace {
+
+constexpr char ring_magic[8] = { 'D', 'D', 'P', 'R', 'O', 'F', 'R', 'G' };
+constexpr uint32_t ring_version = 1;
+constexpr uint32_t ring_header_size = 4096;
+constexpr uint64_t record_header_size = 16; // u64 length + u64 timestamp
+
+// Header field offsets; see the layout comment in ring_file.hpp
+constexpr size_t off_magic = 0;
+constexpr size_t off_version = 8;
+constexpr size_t off_header_size = 12;
+constexpr size_t off_capacity = 16;
+constexpr size_t off_head = 24;
+constexpr size_t off_tail = 32;
+
+template<typename T>
+T
+load_field(const uint8_t* base, size_t off)
+{
+    T val;
+    std::memcpy(&val, base + off, sizeof(T));
+    return val;
+}
+
+template<typename T>
+void
+store_field(uint8_t* base, size_t off, T val)
+{
+    std::memcpy(base + off, &val, sizeof(T));
+}
+
+} // namespace
+
+std::variant<std::shared_ptr<RingFile>, std::string>
+Datadog::RingFile::open(std::string_view path, uint64_t capacity)
+{
+    // Whole pages only; a sub-page window isn't a useful flight recorder anyway
+    const auto page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    capacity = ((capacity + page_size - 1) / page_size) * page_size;
+    if (capacity == 0) {
+        return std::string("Ring file capacity must be nonzero");
+    }
+
+    // One writer per file: embed the pid the same way export_to_file does, so a
+    // forked child naturally opens its own ring instead of corrupting ours
+    std::ostringstream oss;
+    oss << path << "." << getpid() << ".ring";
+    const std::string filename = oss.str();
+
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return "Error opening ring file " + filename + ": " + strerror(errno);
+    }
+
+    const size_t mapping_size = ring_header_size + capacity;
+    if (ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+        std::string err = "Error sizing ring file " + filename + ": " + strerror(errno);
+        close(fd);
+        return err;
+    }
+
+    void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::string err = "Error mapping ring file " + filename + ": " + strerror(errno);
+        close(fd);
+        return err;
+    }
+
+    auto ring = std::shared_ptr<RingFile>(new RingFile());
+    ring->mapping = static_cast<uint8_t*>(mapping);
+    ring->mapping_size = mapping_size;
+    ring->capacity = capacity;
+    ring->fd = fd;
+
+    auto* base = ring->mapping;
+    const bool resumable = std::memcmp(base + off_magic, ring_magic, sizeof(ring_magic)) == 0 &&
+                           load_field<uint32_t>(base, off_version) == ring_version &&
+                           load_field<uint64_t>(base, off_capacity) == capacity;
+    if (resumable) {
+        // Same pid re-opening its own ring (restart of the uploader within one
+        // process); pick up where it left off and rebuild the record index
+        ring->head = load_field<uint64_t>(base, off_head);
+        ring->tail = load_field<uint64_t>(base, off_tail);
+        uint64_t pos = ring->tail;
+        while (pos + record_header_size <= ring->head) {
+            uint64_t len;
+            ring->wrap_read(pos, &len, sizeof(len));
+            const uint64_t record = record_header_size + len;
+            if (len > capacity || pos + record > ring->head) {
+                break; // torn tail from an unclean shutdown; stop indexing here
+            }
+            ring->record_sizes.push_back(record);
+            pos += record;
+        }
+        ring->head = pos;
+    } else {
+        std::memcpy(base + off_magic, ring_magic, sizeof(ring_magic));
+        store_field<uint32_t>(base, off_version, ring_version);
+        store_field<uint32_t>(base, off_header_size, ring_header_size);
+        store_field<uint64_t>(base, off_capacity, capacity);
+        ring->publish_cursors();
+    }
+    return ring;
+}
+
+Datadog::RingFile::~RingFile()
+{
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+void
+Datadog::RingFile::wrap_copy(uint64_t pos, const void* src, size_t len)
+{
+    uint8_t* data = mapping + ring_header_size;
+    const uint64_t start = pos % capacity;
+    const size_t first = static_cast<size_t>(std::min<uint64_t>(len, capacity - start));
+    std::memcpy(data + start, src, first);
+    if (first < len) {
+        std::memcpy(data, static_cast<const uint8_t*>(src) + first, len - first);
+    }
+}
+
+void
+Datadog::RingFile::wrap_read(uint64_t pos, void* dst, size_t len) const
+{
+    const uint8_t* data = mapping + ring_header_size;
+    const uint64_t start = pos % capacity;
+    const size_t first = static_cast<size_t>(std::min<uint64_t>(len, capacity - start));
+    std::memcpy(dst, data + start, first);
+    if (first < len) {
+        std::memcpy(static_cast<uint8_t*>(dst) + first, data, len - first);
+    }
+}
+
+void
+Datadog::RingFile::publish_cursors()
+{
+    // tail moves first (shrinking the valid window is always safe to observe),
+    // then head after the record bytes are in place.  The fence orders the
+    // record memcpy before the head store for a reader in another process.
+    store_field<uint64_t>(mapping, off_tail, tail);
+    std::atomic_thread_fence(std::memory_order_release);
+    store_field<uint64_t>(mapping, off_head, head);
+}
+
+bool
+Datadog::RingFile::append(const uint8_t* data, size_t len)
+{
+    const uint64_t record = record_header_size + len;
+    if (record > capacity) {
+        // A single profile bigger than the whole window; nothing sane to keep
+        static auto* oversized = Telemetry::register_counter("ring_file.oversized_records");
+        oversized->fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Step the tail over whole records until the new one fits
+    while (head + record - tail > capacity) {
+        tail += record_sizes.front();
+        record_sizes.pop_front();
+    }
+
+    const auto timestamp_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count());
+    wrap_copy(head, &len, sizeof(uint64_t));
+    wrap_copy(head + sizeof(uint64_t), &timestamp_ns, sizeof(uint64_t));
+    wrap_copy(head + record_header_size, data, len);
+
+    head += record;
+    record_sizes.push_back(record);
+    publish_cursors();
+    return true;
+}
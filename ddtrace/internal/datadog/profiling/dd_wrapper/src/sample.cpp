@@ -3,19 +3,36 @@
 #include "code_provenance.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
 #include <thread>
 
 Datadog::Sample::Sample(SampleType _type_mask, unsigned int _max_nframes)
   : max_nframes{ _max_nframes }
   , type_mask{ _type_mask }
 {
-    // Initialize values
-    values.resize(profile_state.get_sample_type_length());
-    std::fill(values.begin(), values.end(), 0);
+    // Initialize values; the enabled sample types are fixed at ddup_start, so
+    // the live slot count never changes after this
+    values_len = profile_state.get_sample_type_length();
+    values.fill(0);
 
     // Initialize other state
     locations.reserve(max_nframes + 1); // +1 for a "truncated frames" virtual frame
+    string_arena.reserve(g_sample_string_arena_capacity);
+}
+
+std::string_view
+Datadog::Sample::arena_store(std::string_view str)
+{
+    if (string_arena.size() + str.size() > string_arena.capacity()) {
+        // Growing would reallocate and dangle earlier views; oversized
+        // strings take the slow interned path instead
+        return profile_state.insert_or_get(str);
+    }
+    const size_t offset = string_arena.size();
+    string_arena.insert(string_arena.end(), str.begin(), str.end());
+    return { string_arena.data() + offset, str.size() };
 }
 
 void
@@ -24,12 +41,59 @@ Datadog::Sample::profile_clear_state()
     profile_state.cycle_buffers();
 }
 
+namespace {
+
+// Misconfigured callers can hit the push_* failure paths at sample rate; one
+// line per interval is plenty to notice, and keeps the failure storm from
+// doing IO per sample
+Datadog::LogRateLimiter bad_push_limiter{};
+
+// Per-thread direct-mapped cache in front of Profile::insert_or_get for the
+// frame strings. Nearly every frame of every sample repeats the same
+// name/filename objects, so the common case skips the string-table mutex and
+// hash entirely. The interned views point into Profile's append-only
+// string_storage, which lives for the whole process, so cached entries never
+// dangle.
+struct InternCacheEntry
+{
+    const char* key_ptr{ nullptr };
+    size_t key_len{ 0 };
+    std::string_view interned{};
+};
+
+constexpr size_t intern_cache_size = 512; // power of two, ~24 KiB per sampling thread
+
+// Callers pass views into Python-owned string buffers, and a freed buffer's
+// address can be reused for a different string; the memcmp against the cached
+// interned copy below makes such an aliased hit fall through to a miss
+// instead of returning the wrong string.
+thread_local std::array<InternCacheEntry, intern_cache_size> intern_cache{};
+
+std::string_view
+cached_insert_or_get(Datadog::Profile& profile_state, std::string_view str)
+{
+    if (str.empty()) {
+        return profile_state.insert_or_get(str);
+    }
+    const auto slot = (reinterpret_cast<uintptr_t>(str.data()) >> 4) & (intern_cache_size - 1);
+    auto& entry = intern_cache[slot]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    if (entry.key_ptr == str.data() && entry.key_len == str.size() &&
+        std::memcmp(entry.interned.data(), str.data(), str.size()) == 0) {
+        return entry.interned;
+    }
+    const auto interned = profile_state.insert_or_get(str);
+    entry = { str.data(), str.size(), interned };
+    return interned;
+}
+
+} // namespace
+
 void
 Datadog::Sample::push_frame_impl(std::string_view name, std::string_view filename, uint64_t address, int64_t line)
 {
     static const ddog_prof_Mapping null_mapping = { 0, 0, 0, to_slice(""), to_slice("") };
-    name = profile_state.insert_or_get(name);
-    filename = profile_state.insert_or_get(filename);
+    name = cached_insert_or_get(profile_state, name);
+    filename = cached_insert_or_get(profile_state, filename);
 
     CodeProvenance::get_instance().add_filename(filename);
 
@@ -59,6 +123,12 @@ Datadog::Sample::push_frame(std::string_view name, std::string_view filename, ui
     }
 }
 
+void
+Datadog::Sample::add_dropped_frames(int64_t count)
+{
+    dropped_frames += count;
+}
+
 bool
 Datadog::Sample::push_label(const ExportLabelKey key, std::string_view val)
 {
@@ -72,11 +142,33 @@ Datadog::Sample::push_label(const ExportLabelKey key, std::string_view val)
         return true;
     }
 
-    // Otherwise, persist the val string and add the label
-    val = profile_state.insert_or_get(val);
-    auto& label = labels.emplace_back();
+    // Otherwise, persist the val string in the sample arena (these values can
+    // be high-cardinality, so they don't belong in the interned table) and
+    // store the label in its slot
+    val = arena_store(val);
+    auto& label = label_slots[static_cast<size_t>(key)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    label = {};
     label.key = to_slice(key_sv);
     label.str = to_slice(val);
+    label_mask |= 1U << static_cast<uint32_t>(key);
+    return true;
+}
+
+bool
+Datadog::Sample::push_label_interned(const ExportLabelKey key, std::string_view val)
+{
+    const std::string_view key_sv = to_string(key);
+    if (val.empty() || key_sv.empty()) {
+        return true;
+    }
+
+    // The value already lives in the profile's interned table, which outlives
+    // the sample, so no arena copy is needed
+    auto& label = label_slots[static_cast<size_t>(key)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    label = {};
+    label.key = to_slice(key_sv);
+    label.str = to_slice(val);
+    label_mask |= 1U << static_cast<uint32_t>(key);
     return true;
 }
 
@@ -91,19 +183,22 @@ Datadog::Sample::push_label(const ExportLabelKey key, int64_t val)
         return true;
     }
 
-    auto& label = labels.emplace_back();
+    auto& label = label_slots[static_cast<size_t>(key)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    label = {};
     label.key = to_slice(key_sv);
     label.str = to_slice("");
     label.num = val;
     label.num_unit = to_slice("");
+    label_mask |= 1U << static_cast<uint32_t>(key);
     return true;
 }
 
 void
 Datadog::Sample::clear_buffers()
 {
-    std::fill(values.begin(), values.end(), 0);
-    labels.clear();
+    values.fill(0);
+    label_mask = 0; // stale slot contents are never read without their bit set
+    string_arena.clear();
     locations.clear();
     dropped_frames = 0;
 }
@@ -112,22 +207,41 @@ bool
 Datadog::Sample::flush_sample(bool reverse_locations)
 {
     if (dropped_frames > 0) {
-        const std::string name =
-          "<" + std::to_string(dropped_frames) + " frame" + (1 == dropped_frames ? "" : "s") + " omitted>";
-        Sample::push_frame_impl(name, "", 0, 0);
+        // Deep stacks sampled at high frequency drop the same number of frames
+        // sample after sample; remember the last rendered sentinel so the
+        // steady state doesn't rebuild and re-intern the string every flush
+        thread_local int64_t last_dropped_frames = -1;
+        thread_local std::string dropped_frames_name{};
+        if (dropped_frames != last_dropped_frames) {
+            dropped_frames_name =
+              "<" + std::to_string(dropped_frames) + " frame" + (1 == dropped_frames ? "" : "s") + " omitted>";
+            last_dropped_frames = dropped_frames;
+        }
+        Sample::push_frame_impl(dropped_frames_name, "", 0, 0);
     }
 
     if (reverse_locations) {
         std::reverse(locations.begin(), locations.end());
     }
 
+    // Compact the populated label slots, visiting only the set bits
+    std::array<ddog_prof_Label, num_label_slots> flush_labels; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    size_t num_labels = 0;
+    for (uint32_t mask = label_mask; mask != 0; mask &= mask - 1) {
+        const auto slot = static_cast<size_t>(__builtin_ctz(mask));
+        flush_labels[num_labels++] = label_slots[slot]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
     const ddog_prof_Sample sample = {
         .locations = { locations.data(), locations.size() },
-        .values = { values.data(), values.size() },
-        .labels = { labels.data(), labels.size() },
+        .values = { values.data(), values_len },
+        .labels = { flush_labels.data(), num_labels },
     };
 
-    const bool ret = profile_state.collect(sample, endtime_ns);
+    // Identical (stack, labels, quantized timestamp) tuples are accumulated
+    // and handed to libdatadog once per upload window instead of once per
+    // sample; without timeline the timestamp is simply always zero.
+    const bool ret = profile_state.collect_aggregated(sample, endtime_ns);
     clear_buffers();
     return ret;
 }
@@ -142,7 +256,9 @@ Datadog::Sample::push_cputime(int64_t cputime, int64_t count)
         values[profile_state.val().cpu_count] += count;
         return true;
     }
-    std::cout << "bad push cpu" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push cpu" << std::endl;
+    }
     return false;
 }
 
@@ -154,7 +270,9 @@ Datadog::Sample::push_walltime(int64_t walltime, int64_t count)
         values[profile_state.val().wall_count] += count;
         return true;
     }
-    std::cout << "bad push wall" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push wall" << std::endl;
+    }
     return false;
 }
 
@@ -166,7 +284,9 @@ Datadog::Sample::push_exceptioninfo(std::string_view exception_type, int64_t cou
         values[profile_state.val().exception_count] += count;
         return true;
     }
-    std::cout << "bad push except" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push except" << std::endl;
+    }
     return false;
 }
 
@@ -178,7 +298,9 @@ Datadog::Sample::push_acquire(int64_t acquire_time, int64_t count) // NOLINT (bu
         values[profile_state.val().lock_acquire_count] += count;
         return true;
     }
-    std::cout << "bad push acquire" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push acquire" << std::endl;
+    }
     return false;
 }
 
@@ -190,7 +312,9 @@ Datadog::Sample::push_release(int64_t lock_time, int64_t count) // NOLINT (bugpr
         values[profile_state.val().lock_release_count] += count;
         return true;
     }
-    std::cout << "bad push release" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push release" << std::endl;
+    }
     return false;
 }
 
@@ -198,7 +322,9 @@ bool
 Datadog::Sample::push_alloc(int64_t size, int64_t count) // NOLINT (bugprone-easily-swappable-parameters)
 {
     if (size < 0 || count < 0) {
-        std::cout << "bad push alloc (params)" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push alloc (params)" << std::endl;
+        }
         return false;
     }
 
@@ -207,7 +333,9 @@ Datadog::Sample::push_alloc(int64_t size, int64_t count) // NOLINT (bugprone-eas
         values[profile_state.val().alloc_count] += count;
         return true;
     }
-    std::cout << "bad push alloc" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push alloc" << std::endl;
+    }
     return false;
 }
 
@@ -215,7 +343,9 @@ bool
 Datadog::Sample::push_heap(int64_t size)
 {
     if (size < 0) {
-        std::cout << "bad push heap (params)" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push heap (params)" << std::endl;
+        }
         return false;
     }
 
@@ -223,7 +353,23 @@ Datadog::Sample::push_heap(int64_t size)
         values[profile_state.val().heap_space] += size;
         return true;
     }
-    std::cout << "bad push heap" << std::endl;
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push heap" << std::endl;
+    }
+    return false;
+}
+
+bool
+Datadog::Sample::push_gil_wait(int64_t wait_time, int64_t count)
+{
+    if (0U != (type_mask & SampleType::GILWait)) {
+        values[profile_state.val().gil_wait_time] += wait_time * count;
+        values[profile_state.val().gil_wait_count] += count;
+        return true;
+    }
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push gil_wait" << std::endl;
+    }
     return false;
 }
 
@@ -245,7 +391,9 @@ Datadog::Sample::push_threadinfo(int64_t thread_id, int64_t thread_native_id, st
     if (!push_label(ExportLabelKey::thread_id, thread_id) ||
         !push_label(ExportLabelKey::thread_native_id, thread_native_id) ||
         !push_label(ExportLabelKey::thread_name, thread_name)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -255,7 +403,9 @@ bool
 Datadog::Sample::push_task_id(int64_t task_id)
 {
     if (!push_label(ExportLabelKey::task_id, task_id)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -264,9 +414,148 @@ bool
 Datadog::Sample::push_task_name(std::string_view task_name)
 {
     if (!push_label(ExportLabelKey::task_name, task_name)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+uint64_t
+Datadog::Sample::intern_string(std::string_view str)
+{
+    return profile_state.intern_string_id(str);
+}
+
+bool
+Datadog::Sample::push_threadinfo_id(int64_t thread_id, int64_t thread_native_id, uint64_t thread_name_id)
+{
+    if (!push_label(ExportLabelKey::thread_id, thread_id) ||
+        !push_label(ExportLabelKey::thread_native_id, thread_native_id) ||
+        !push_label_interned(ExportLabelKey::thread_name, profile_state.get_interned_string(thread_name_id))) {
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool
+Datadog::Sample::push_task_name_id(uint64_t task_name_id)
+{
+    if (!push_label_interned(ExportLabelKey::task_name, profile_state.get_interned_string(task_name_id))) {
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool
+Datadog::Sample::push_trace_type_id(uint64_t trace_type_id)
+{
+    if (!push_label_interned(ExportLabelKey::trace_type, profile_state.get_interned_string(trace_type_id))) {
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool
+Datadog::Sample::push_exceptioninfo_id(uint64_t exception_type_id, int64_t count)
+{
+    if (0U != (type_mask & SampleType::Exception)) {
+        push_label_interned(ExportLabelKey::exception_type, profile_state.get_interned_string(exception_type_id));
+        values[profile_state.val().exception_count] += count;
+        return true;
+    }
+    if (bad_push_limiter.should_log()) {
+        std::cout << "bad push except" << std::endl;
+    }
+    return false;
+}
+
+uint64_t
+Datadog::Sample::labelset_new()
+{
+    const std::lock_guard<std::mutex> lock(labelsets_mtx);
+    labelsets.emplace_back();
+    return labelsets.size() - 1;
+}
+
+bool
+Datadog::Sample::labelset_add(uint64_t labelset_id, ExportLabelKey key, std::string_view val)
+{
+    const std::string_view key_sv = to_string(key);
+    if (val.empty() || key_sv.empty()) {
+        return true;
+    }
+
+    // The set outlives any individual sample, so the value is parked in the
+    // interned table rather than a sample arena.  Sets are built once per
+    // recurring context, so this doesn't reintroduce per-sample interning.
+    const std::string_view interned = profile_state.insert_or_get(val);
+
+    const std::lock_guard<std::mutex> lock(labelsets_mtx);
+    if (labelset_id >= labelsets.size()) {
+        return false;
+    }
+    auto& set = labelsets[labelset_id];
+    auto& label = set.slots[static_cast<size_t>(key)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    label = {};
+    label.key = to_slice(key_sv);
+    label.str = to_slice(interned);
+    set.mask |= 1U << static_cast<uint32_t>(key);
+    return true;
+}
+
+bool
+Datadog::Sample::labelset_add(uint64_t labelset_id, ExportLabelKey key, int64_t val)
+{
+    const std::string_view key_sv = to_string(key);
+    if (key_sv.empty()) {
+        return true;
+    }
+
+    const std::lock_guard<std::mutex> lock(labelsets_mtx);
+    if (labelset_id >= labelsets.size()) {
         return false;
     }
+    auto& set = labelsets[labelset_id];
+    auto& label = set.slots[static_cast<size_t>(key)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    label = {};
+    label.key = to_slice(key_sv);
+    label.str = to_slice("");
+    label.num = val;
+    label.num_unit = to_slice("");
+    set.mask |= 1U << static_cast<uint32_t>(key);
+    return true;
+}
+
+bool
+Datadog::Sample::push_labelset(uint64_t labelset_id)
+{
+    const std::lock_guard<std::mutex> lock(labelsets_mtx);
+    if (labelset_id >= labelsets.size()) {
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push labelset" << std::endl;
+        }
+        return false;
+    }
+
+    // Copy only the populated slots; later per-field pushes may still
+    // overwrite individual labels for this sample
+    const auto& set = labelsets[labelset_id];
+    for (uint32_t mask = set.mask; mask != 0; mask &= mask - 1) {
+        const auto slot = static_cast<size_t>(__builtin_ctz(mask));
+        label_slots[slot] = set.slots[slot]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+    label_mask |= set.mask;
     return true;
 }
 
@@ -278,7 +567,9 @@ Datadog::Sample::push_span_id(uint64_t span_id)
     const int64_t recoded_id =
       reinterpret_cast<int64_t&>(span_id); // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
     if (!push_label(ExportLabelKey::span_id, recoded_id)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -290,7 +581,9 @@ Datadog::Sample::push_local_root_span_id(uint64_t local_root_span_id)
     const int64_t recoded_id =
       reinterpret_cast<int64_t&>(local_root_span_id); // NOLINT (cppcoreguidelines-pro-type-reinterpret-cast)
     if (!push_label(ExportLabelKey::local_root_span_id, recoded_id)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -300,7 +593,9 @@ bool
 Datadog::Sample::push_trace_type(std::string_view trace_type)
 {
     if (!push_label(ExportLabelKey::trace_type, trace_type)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -310,7 +605,9 @@ bool
 Datadog::Sample::push_class_name(std::string_view class_name)
 {
     if (!push_label(ExportLabelKey::class_name, class_name)) {
-        std::cout << "bad push" << std::endl;
+        if (bad_push_limiter.should_log()) {
+            std::cout << "bad push" << std::endl;
+        }
         return false;
     }
     return true;
@@ -339,7 +636,16 @@ Datadog::Sample::push_monotonic_ns(int64_t _monotonic_ns)
 
     // If timeline is not enabled, then this is a no-op
     if (is_timeline_enabled()) {
-        endtime_ns = _monotonic_ns + offset;
+        // Quantize to the configured granularity: every distinct timestamp is
+        // a distinct pprof entry, so snapping samples to a shared grid lets
+        // consecutive samples of the same stack collapse in the aggregation
+        // table instead of exploding the serialized profile
+        const int64_t timestamp_ns = _monotonic_ns + offset;
+        if (timeline_granularity_ns > 1) {
+            endtime_ns = timestamp_ns - (timestamp_ns % timeline_granularity_ns);
+        } else {
+            endtime_ns = timestamp_ns;
+        }
     }
 
     return true;
@@ -351,6 +657,14 @@ Datadog::Sample::set_timeline(bool enabled)
     timeline_enabled = enabled;
 }
 
+void
+Datadog::Sample::set_timeline_granularity(int64_t granularity_ns)
+{
+    if (granularity_ns > 0) {
+        timeline_granularity_ns = granularity_ns;
+    }
+}
+
 bool
 Datadog::Sample::is_timeline_enabled() const
 {
@@ -369,6 +683,18 @@ Datadog::Sample::profile_release()
     profile_state.profile_release();
 }
 
+ddog_prof_Profile&
+Datadog::Sample::profile_seal()
+{
+    return profile_state.profile_seal();
+}
+
+void
+Datadog::Sample::profile_unseal()
+{
+    profile_state.profile_unseal();
+}
+
 void
 Datadog::Sample::postfork_child()
 {
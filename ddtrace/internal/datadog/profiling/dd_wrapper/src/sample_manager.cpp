@@ -27,6 +27,18 @@ Datadog::SampleManager::set_timeline(bool enable)
     Datadog::Sample::set_timeline(enable);
 }
 
+void
+Datadog::SampleManager::set_timeline_granularity(int64_t granularity_ns)
+{
+    Datadog::Sample::set_timeline_granularity(granularity_ns);
+}
+
+void
+Datadog::SampleManager::add_prewarm_string(std::string_view str)
+{
+    Datadog::Sample::profile_state.add_prewarm_string(str);
+}
+
 void
 Datadog::SampleManager::set_sample_pool_capacity(size_t capacity)
 {
@@ -70,6 +82,32 @@ Datadog::SampleManager::drop_sample(Datadog::Sample* sample)
     }
 }
 
+void
+Datadog::SampleManager::adjust_pool_capacity()
+{
+    if (sample_pool != nullptr) {
+        sample_pool->adjust_capacity();
+    }
+}
+
+uint64_t
+Datadog::SampleManager::get_pool_exhaustion_count()
+{
+    return sample_pool != nullptr ? sample_pool->get_exhaustion_count() : 0;
+}
+
+uint64_t
+Datadog::SampleManager::get_pool_overflow_count()
+{
+    return sample_pool != nullptr ? sample_pool->get_overflow_count() : 0;
+}
+
+size_t
+Datadog::SampleManager::get_pool_capacity()
+{
+    return sample_pool != nullptr ? sample_pool->get_capacity() : 0;
+}
+
 void
 Datadog::SampleManager::postfork_child()
 {
@@ -2,11 +2,47 @@
 
 #include "libdatadog_helpers.hpp"
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+
 extern "C"
 {
 #include "datadog/common.h"
 }
 
+namespace {
+
+// Small per-thread cache in front of the shared ddog_ArrayQueue.  The stack,
+// lock and memory profilers borrow and return samples from their own threads,
+// and funneling every exchange through the shared queue makes its head/tail a
+// contended CAS point.  With the cache, the steady-state borrow/return pair is
+// a thread-local push/pop touching no shared cache line; the shared queue is
+// only visited to refill an empty cache or drain a full one.
+constexpr size_t local_cache_capacity = 2;
+
+struct LocalSampleCache
+{
+    std::array<Datadog::Sample*, local_cache_capacity> samples{};
+    size_t count{ 0 };
+
+    ~LocalSampleCache()
+    {
+        // Thread exit; the shared pool may already be gone, so free directly
+        for (size_t i = 0; i < count; ++i) {
+            delete samples[i]; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    }
+};
+
+thread_local LocalSampleCache local_cache; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Queue errors on the borrow/return path would otherwise format and log once
+// per sample during a failure storm
+Datadog::LogRateLimiter pool_log_limiter{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
 namespace Datadog {
 
 void
@@ -15,7 +51,10 @@ sample_delete_fn(void* sample)
     delete static_cast<Sample*>(sample); // NOLINT(cppcoreguidelines-owning-memory)
 }
 
-SynchronizedSamplePool::SynchronizedSamplePool(size_t capacity)
+SynchronizedSamplePool::SynchronizedSamplePool(size_t _capacity)
+  : capacity{ _capacity }
+  , min_capacity{ _capacity }
+  , max_capacity{ _capacity * g_sample_pool_max_growth_factor }
 {
     ddog_ArrayQueue_NewResult array_queue_new_result = ddog_ArrayQueue_new(capacity, sample_delete_fn);
     if (array_queue_new_result.tag == DDOG_ARRAY_QUEUE_NEW_RESULT_OK) {
@@ -34,20 +73,50 @@ SynchronizedSamplePool::take_sample()
 {
     std::optional<Sample*> result = std::nullopt;
 
+    if (local_cache.count > 0) {
+        return local_cache.samples[--local_cache.count];
+    }
+
     // It's actually ok to call ddog_ArrayQueue_* methods with a nullptr,
     // they will return an error result, but we already have printed out
     // an error message in the constructor, so check for nullptr here to
     // avoid spamming the error message.
+    const std::shared_lock<std::shared_mutex> lock(pool_mtx);
     if (pool != nullptr) {
-        ddog_ArrayQueue_PopResult pop_result = ddog_ArrayQueue_pop(pool.get());
+        // Batched refill: pull one sample to hand out plus enough to fill the
+        // local cache, so a thread pays the shared-queue synchronization once
+        // per batch rather than once per borrow
+        for (size_t i = 0; i < local_cache_capacity + 1; ++i) {
+            ddog_ArrayQueue_PopResult pop_result = ddog_ArrayQueue_pop(pool.get());
 
-        if (pop_result.tag == DDOG_ARRAY_QUEUE_POP_RESULT_OK) {
-            result = static_cast<Sample*>(pop_result.ok);
-        } else if (pop_result.tag == DDOG_ARRAY_QUEUE_POP_RESULT_ERR) {
-            auto err = pop_result.err;
-            std::string errmsg = err_to_msg(&err, "Failed to get sample from pool");
-            std::cerr << errmsg << std::endl;
-            ddog_Error_drop(&err);
+            if (pop_result.tag == DDOG_ARRAY_QUEUE_POP_RESULT_OK) {
+                auto* sample = static_cast<Sample*>(pop_result.ok);
+                if (!result.has_value()) {
+                    result = sample;
+                } else {
+                    local_cache.samples[local_cache.count++] = sample;
+                }
+            } else {
+                if (pop_result.tag == DDOG_ARRAY_QUEUE_POP_RESULT_ERR) {
+                    auto err = pop_result.err;
+                    // Formatting allocates; only pay for it when the limiter
+                    // lets the message through.  The error itself is always
+                    // dropped.
+                    if (pool_log_limiter.should_log()) {
+                        std::cerr << err_to_msg(&err, "Failed to get sample from pool") << std::endl;
+                    }
+                    ddog_Error_drop(&err);
+                }
+                break;
+            }
+        }
+
+        if (!result.has_value()) {
+            // The caller falls back to a heap allocation; record the
+            // exhaustion so the next adjustment window can grow the pool and
+            // operators can see that sampling degraded
+            window_exhaustions.fetch_add(1, std::memory_order_relaxed);
+            total_exhaustions->fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -59,21 +128,106 @@ SynchronizedSamplePool::return_sample(Sample* sample)
 {
     std::optional<Sample*> result = std::nullopt;
 
+    if (local_cache.count < local_cache_capacity) {
+        local_cache.samples[local_cache.count++] = sample;
+        return result;
+    }
+
+    const std::shared_lock<std::shared_mutex> lock(pool_mtx);
     if (pool != nullptr) {
+        // The local cache is full: drain it to the shared queue in one batch
+        // so the next few returns are thread-local again.  Cached samples that
+        // don't fit are freed here; an overflow of the incoming sample is
+        // reported to the caller, matching the single-push behavior.
+        for (size_t i = 0; i < local_cache.count; ++i) {
+            ddog_ArrayQueue_PushResult push_result = ddog_ArrayQueue_push(pool.get(), local_cache.samples[i]);
+            if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_FULL) {
+                delete static_cast<Sample*>(push_result.full); // NOLINT(cppcoreguidelines-owning-memory)
+                window_overflows.fetch_add(1, std::memory_order_relaxed);
+                total_overflows->fetch_add(1, std::memory_order_relaxed);
+            } else if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_ERR) {
+                auto err = push_result.err;
+                if (pool_log_limiter.should_log()) {
+                    std::cerr << err_to_msg(&err, "Failed to return sample to pool") << std::endl;
+                }
+                ddog_Error_drop(&err);
+            }
+        }
+        local_cache.count = 0;
+
         ddog_ArrayQueue_PushResult push_result = ddog_ArrayQueue_push(pool.get(), sample);
 
         if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_OK) {
             // The sample was successfully returned to the pool.
         } else if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_FULL) {
             result = static_cast<Sample*>(push_result.full);
+            window_overflows.fetch_add(1, std::memory_order_relaxed);
+            total_overflows->fetch_add(1, std::memory_order_relaxed);
         } else if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_ERR) {
             auto err = push_result.err;
-            std::string errmsg = err_to_msg(&err, "Failed to return sample to pool");
-            std::cerr << errmsg << std::endl;
+            if (pool_log_limiter.should_log()) {
+                std::cerr << err_to_msg(&err, "Failed to return sample to pool") << std::endl;
+            }
             ddog_Error_drop(&err);
         }
+    } else {
+        // No shared queue to drain into; hand the sample back so the caller
+        // frees it instead of leaking
+        result = sample;
     }
 
     return result;
 }
+
+void
+SynchronizedSamplePool::adjust_capacity()
+{
+    const uint64_t exhaustions = window_exhaustions.exchange(0, std::memory_order_relaxed);
+    const uint64_t overflows = window_overflows.exchange(0, std::memory_order_relaxed);
+
+    // Grow after any exhaustion (takes fell back to the heap); shrink back
+    // toward the configured capacity only after a window with no pressure at
+    // all.  Overflow-only windows are left alone: they just mean the burst is
+    // over and the extra samples are draining.
+    size_t new_capacity = capacity;
+    if (exhaustions > 0) {
+        new_capacity = std::min(capacity * 2, max_capacity);
+    } else if (overflows == 0 && capacity > min_capacity) {
+        new_capacity = std::max(capacity / 2, min_capacity);
+    }
+
+    if (new_capacity == capacity || pool == nullptr) {
+        return;
+    }
+
+    ddog_ArrayQueue_NewResult array_queue_new_result = ddog_ArrayQueue_new(new_capacity, sample_delete_fn);
+    if (array_queue_new_result.tag != DDOG_ARRAY_QUEUE_NEW_RESULT_OK) {
+        auto err = array_queue_new_result.err;
+        std::string errmsg = err_to_msg(&err, "Failed to resize sample pool");
+        std::cerr << errmsg << std::endl;
+        ddog_Error_drop(&err);
+        return;
+    }
+    std::unique_ptr<ddog_ArrayQueue, Deleter> new_pool(array_queue_new_result.ok);
+
+    // Exclusive section: migrate the idle samples and swap the queues.  This
+    // runs once per export window at most, so the writer-side cost is noise.
+    const std::unique_lock<std::shared_mutex> lock(pool_mtx);
+    while (true) {
+        ddog_ArrayQueue_PopResult pop_result = ddog_ArrayQueue_pop(pool.get());
+        if (pop_result.tag != DDOG_ARRAY_QUEUE_POP_RESULT_OK) {
+            if (pop_result.tag == DDOG_ARRAY_QUEUE_POP_RESULT_ERR) {
+                auto err = pop_result.err;
+                ddog_Error_drop(&err);
+            }
+            break;
+        }
+        ddog_ArrayQueue_PushResult push_result = ddog_ArrayQueue_push(new_pool.get(), pop_result.ok);
+        if (push_result.tag == DDOG_ARRAY_QUEUE_PUSH_RESULT_FULL) {
+            delete static_cast<Sample*>(push_result.full); // NOLINT(cppcoreguidelines-owning-memory)
+        }
+    }
+    pool = std::move(new_pool);
+    capacity = new_capacity;
+}
 } // namespace Datadog
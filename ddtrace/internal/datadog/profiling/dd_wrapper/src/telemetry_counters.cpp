@@ -0,0 +1,71 @@
+#include "telemetry_counters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <string>
+
+namespace {
+
+struct Slot
+{
+    std::string name;
+    std::atomic<uint64_t> value{ 0 };
+};
+
+// Fixed storage; registration only ever appends, and the slots themselves
+// are never reallocated, so held cells stay valid for the process lifetime.
+std::array<Slot, Datadog::Telemetry::max_counters>& // NOLINT (cppcoreguidelines-avoid-non-const-global-variables)
+slots()
+{
+    static auto* storage = new std::array<Slot, Datadog::Telemetry::max_counters>();
+    return *storage;
+}
+
+std::mutex& // NOLINT (cppcoreguidelines-avoid-non-const-global-variables)
+registry_mtx()
+{
+    static auto* mtx = new std::mutex();
+    return *mtx;
+}
+
+size_t registered_count = 0; // NOLINT (cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace
+
+std::atomic<uint64_t>*
+Datadog::Telemetry::register_counter(std::string_view name)
+{
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+
+    for (size_t i = 0; i < registered_count; i++) {
+        if (slots()[i].name == name) {
+            return &slots()[i].value;
+        }
+    }
+
+    if (registered_count >= max_counters - 1) {
+        // Out of slots: the last slot is the shared spill cell, so the
+        // overflow shows up in snapshots instead of silently absorbing
+        // counts, and callers need no error handling.
+        slots()[max_counters - 1].name = "telemetry.overflow";
+        registered_count = max_counters;
+        return &slots()[max_counters - 1].value;
+    }
+
+    slots()[registered_count].name = std::string(name);
+    return &slots()[registered_count++].value;
+}
+
+size_t
+Datadog::Telemetry::snapshot(CounterEntry* entries, size_t max_entries)
+{
+    const std::lock_guard<std::mutex> lock(registry_mtx());
+
+    const size_t count = std::min(registered_count, max_entries);
+    for (size_t i = 0; i < count; i++) {
+        entries[i].name = slots()[i].name.c_str();
+        entries[i].value = slots()[i].value.load(std::memory_order_relaxed);
+    }
+    return count;
+}
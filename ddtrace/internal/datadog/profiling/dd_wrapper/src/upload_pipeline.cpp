@@ -0,0 +1,220 @@
+#include "upload_pipeline.hpp"
+
+#include "helper_threads.hpp"
+#include "telemetry_counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <utility>
+
+using namespace Datadog;
+
+void
+Datadog::UploadPipeline::schedule_retry(Payload&& payload)
+{
+    // Jittered exponential backoff: the delay ceiling doubles per attempt and
+    // the actual delay is drawn from its upper half, so a fleet of workers
+    // that failed together doesn't re-converge on a restarting agent.
+    static std::minstd_rand jitter_rng{ std::random_device{}() };
+    const uint64_t ceiling_ms = g_upload_retry_base_ms << (payload.attempts - 1);
+    const uint64_t delay_ms = ceiling_ms / 2 + jitter_rng() % (ceiling_ms / 2 + 1);
+    payload.not_before = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+
+    if (retry_queue.size() >= g_upload_retry_queue_depth) {
+        // Same drop-oldest policy as the main queue; a waiting payload holds
+        // its raw serialized profile, so the cap is deliberately small
+        static auto* retry_dropped = Telemetry::register_counter("upload_pipeline.retry_dropped");
+        retry_dropped->fetch_add(1, std::memory_order_relaxed);
+        ddog_prof_EncodedProfile_drop(&retry_queue.front().encoded);
+        retry_queue.pop_front();
+    }
+    retry_queue.push_back(std::move(payload));
+}
+
+void
+Datadog::UploadPipeline::drop_queued_locked()
+{
+    for (auto& payload : queue) {
+        ddog_prof_EncodedProfile_drop(&payload.encoded);
+    }
+    queue.clear();
+    for (auto& payload : retry_queue) {
+        ddog_prof_EncodedProfile_drop(&payload.encoded);
+    }
+    retry_queue.clear();
+}
+
+void
+Datadog::UploadPipeline::worker_loop()
+{
+    // The worker spends its life waiting on the queue or on the agent; it is
+    // never latency-critical, so deprioritize it by default
+    HelperThreads::apply_attributes("ddprof.upload", 10);
+
+    std::unique_lock<std::mutex> lock(queue_mtx);
+    while (true) {
+        if (queue.empty() && !retry_queue.empty() && !stopping) {
+            // Nothing fresh: sleep until the earliest retry comes due, or new
+            // work (or shutdown) arrives
+            auto earliest = retry_queue.front().not_before;
+            for (const auto& payload : retry_queue) {
+                earliest = std::min(earliest, payload.not_before);
+            }
+            queue_cv.wait_until(lock, earliest, [] { return stopping || !queue.empty(); });
+        } else {
+            queue_cv.wait(lock, [] { return stopping || !queue.empty() || !retry_queue.empty(); });
+        }
+        if (stopping) {
+            // Shutdown never waits out a backoff; whatever is left is dropped
+            // by shutdown() under this same lock discipline
+            return;
+        }
+
+        // Fresh payloads take priority; retries go when due
+        std::optional<Payload> payload;
+        if (!queue.empty()) {
+            payload.emplace(std::move(queue.front()));
+            queue.pop_front();
+        } else if (!retry_queue.empty()) {
+            auto due = std::find_if(retry_queue.begin(), retry_queue.end(), [](const Payload& p) {
+                return std::chrono::steady_clock::now() >= p.not_before;
+            });
+            if (due == retry_queue.end()) {
+                continue; // woke early; recompute the deadline above
+            }
+            payload.emplace(std::move(*due));
+            retry_queue.erase(due);
+        } else {
+            continue;
+        }
+
+        // The send can take arbitrarily long on a slow agent; never hold the
+        // queue lock across it.  The upload runs as two stages on this
+        // thread: compression (Request_build, which zstd-compresses the
+        // attachments) and then the send, so no compression work ever lands
+        // on the threads that touch samples and the wait on the agent holds
+        // compressed bytes only.  On a failed send the raw payload survives
+        // for the retry path.
+        sending = true;
+        lock.unlock();
+        bool retryable = false;
+        const bool ok = payload->uploader.upload_encoded_retryable(&payload->encoded, &retryable);
+        lock.lock();
+        sending = false;
+
+        if (!ok && retryable) {
+            payload->attempts++;
+            if (payload->attempts <= g_upload_retry_max_attempts && !stopping) {
+                static auto* retries = Telemetry::register_counter("upload_pipeline.retries");
+                retries->fetch_add(1, std::memory_order_relaxed);
+                schedule_retry(std::move(*payload));
+            } else {
+                static auto* abandoned = Telemetry::register_counter("upload_pipeline.retry_abandoned");
+                abandoned->fetch_add(1, std::memory_order_relaxed);
+                ddog_prof_EncodedProfile_drop(&payload->encoded);
+            }
+        }
+        drain_cv.notify_all();
+    }
+}
+
+void
+Datadog::UploadPipeline::ensure_worker()
+{
+    if (worker_started) {
+        return;
+    }
+    worker = std::thread(worker_loop);
+    worker_started = true;
+
+    // Drain whatever is queued at interpreter shutdown so the final profile
+    // of a short-lived process still goes out
+    static bool atexit_registered = false;
+    if (!atexit_registered) {
+        std::atexit([] { UploadPipeline::shutdown(); });
+        atexit_registered = true;
+    }
+}
+
+void
+Datadog::UploadPipeline::enqueue(Uploader&& uploader, ddog_prof_EncodedProfile encoded)
+{
+    {
+        const std::lock_guard<std::mutex> lock(queue_mtx);
+        if (stopping) {
+            ddog_prof_EncodedProfile_drop(&encoded);
+            return;
+        }
+        ensure_worker();
+
+        if (queue.size() >= g_upload_queue_depth) {
+            // The agent is falling behind our cadence; the newest window is
+            // worth more than the oldest, so shed from the front
+            static auto* dropped_payloads = Telemetry::register_counter("upload_pipeline.dropped_payloads");
+            dropped_payloads->fetch_add(1, std::memory_order_relaxed);
+            ddog_prof_EncodedProfile_drop(&queue.front().encoded);
+            queue.pop_front();
+        }
+        queue.push_back(Payload{ std::move(uploader), encoded });
+    }
+    queue_cv.notify_one();
+}
+
+void
+Datadog::UploadPipeline::shutdown()
+{
+    {
+        std::unique_lock<std::mutex> lock(queue_mtx);
+        if (!worker_started) {
+            return;
+        }
+
+        // Give the queue a bounded chance to drain (the final profile of a
+        // short-lived process is usually in it), then cut the cord: whatever
+        // is left is dropped and the in-flight send is cancelled, so exit
+        // latency never depends on agent timeouts
+        drain_cv.wait_for(lock, std::chrono::milliseconds(g_upload_shutdown_grace_ms), [] {
+            return queue.empty() && !sending;
+        });
+        stopping = true;
+        drop_queued_locked();
+    }
+    Uploader::cancel_inflight();
+    queue_cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void
+Datadog::UploadPipeline::prefork()
+{
+    // Quiesce the queue so the child doesn't inherit it mid-mutation
+    queue_mtx.lock();
+}
+
+void
+Datadog::UploadPipeline::postfork_parent()
+{
+    queue_mtx.unlock();
+}
+
+void
+Datadog::UploadPipeline::postfork_child()
+{
+    queue_mtx.unlock();
+
+    // The exporter thread does not survive the fork; forget its handle and
+    // drop the inherited payloads (they belong to the parent's profile), then
+    // let the next enqueue start a fresh worker
+    if (worker.joinable()) {
+        worker.detach();
+    }
+    worker_started = false;
+    stopping = false;
+    sending = false;
+    drop_queued_locked();
+}
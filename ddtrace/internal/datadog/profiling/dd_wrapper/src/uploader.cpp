@@ -3,12 +3,14 @@
 #include "code_provenance.hpp"
 #include "libdatadog_helpers.hpp"
 
+#include <chrono>  // milliseconds
 #include <errno.h> // errno
 #include <fstream> // ofstream
 #include <optional>
 #include <sstream>  // ostringstream
 #include <string.h> // strerror
 #include <unistd.h> // getpid
+#include <utility>  // move
 #include <vector>
 
 using namespace Datadog;
@@ -22,9 +24,12 @@ DdogCancellationTokenDeleter::operator()(ddog_CancellationToken* ptr) const
     }
 }
 
-Datadog::Uploader::Uploader(std::string_view _output_filename, ddog_prof_Exporter* _ddog_exporter)
+Datadog::Uploader::Uploader(std::string_view _output_filename,
+                            std::shared_ptr<ddog_prof_Exporter> _ddog_exporter,
+                            std::shared_ptr<RingFile> _ring_file)
   : output_filename{ _output_filename }
-  , ddog_exporter{ _ddog_exporter }
+  , ddog_exporter{ std::move(_ddog_exporter) }
+  , ring_file{ std::move(_ring_file) }
 {
     // Increment the upload sequence number every time we build an uploader.
     // Upoloaders are use-once-and-destroy.
@@ -52,8 +57,8 @@ Datadog::Uploader::export_to_file(ddog_prof_EncodedProfile* encoded)
     return true;
 }
 
-bool
-Datadog::Uploader::upload(ddog_prof_Profile& profile)
+std::optional<ddog_prof_EncodedProfile>
+Datadog::Uploader::serialize(ddog_prof_Profile& profile)
 {
     // Serialize the profile
     ddog_prof_Profile_SerializeResult result = ddog_prof_Profile_serialize(&profile, nullptr, nullptr, nullptr);
@@ -62,9 +67,31 @@ Datadog::Uploader::upload(ddog_prof_Profile& profile)
         errmsg = err_to_msg(&err, "Error serializing pprof");
         std::cerr << errmsg << std::endl;
         ddog_Error_drop(&err);
+        return std::nullopt;
+    }
+    return result.ok; // NOLINT (cppcoreguidelines-pro-type-union-access)
+}
+
+bool
+Datadog::Uploader::upload(ddog_prof_Profile& profile)
+{
+    auto encoded = serialize(profile);
+    if (!encoded.has_value()) {
         return false;
     }
-    ddog_prof_EncodedProfile* encoded = &result.ok; // NOLINT (cppcoreguidelines-pro-type-union-access)
+    return upload_encoded(&encoded.value());
+}
+
+bool
+Datadog::Uploader::upload_encoded(ddog_prof_EncodedProfile* encoded)
+{
+    if (ring_file) {
+        // Flight-recorder mode: one memcpy into the mapped window, no network,
+        // no per-cycle files
+        const bool ret = ring_file->append(encoded->buffer.ptr, encoded->buffer.len);
+        ddog_prof_EncodedProfile_drop(encoded);
+        return ret;
+    }
 
     if (!output_filename.empty()) {
         bool ret = export_to_file(encoded);
@@ -72,18 +99,55 @@ Datadog::Uploader::upload(ddog_prof_Profile& profile)
         return ret;
     }
 
+    ddog_prof_Exporter_Request* req = build_request(encoded);
+    if (req == nullptr) {
+        return false;
+    }
+    return send_request(req);
+}
+
+bool
+Datadog::Uploader::upload_encoded_retryable(ddog_prof_EncodedProfile* encoded, bool* retryable)
+{
+    *retryable = false;
+    if (ring_file || !output_filename.empty()) {
+        // Local targets: their failures are not transient agent blips, so
+        // there is nothing sensible to retry
+        return upload_encoded(encoded);
+    }
+
+    ddog_prof_Exporter_Request* req = build_request(encoded, /* consume_encoded */ false);
+    if (req == nullptr) {
+        // Build errors are deterministic, not transient; give up on the payload
+        ddog_prof_EncodedProfile_drop(encoded);
+        return false;
+    }
+    if (!send_request(req)) {
+        // The encoded profile is still intact; the caller decides whether to
+        // re-attempt the send later
+        *retryable = true;
+        return false;
+    }
+    ddog_prof_EncodedProfile_drop(encoded);
+    return true;
+}
+
+ddog_prof_Exporter_Request*
+Datadog::Uploader::build_request(ddog_prof_EncodedProfile* encoded, bool consume_encoded)
+{
     std::vector<ddog_prof_Exporter_File> files_to_send = { {
       .name = to_slice("auto.pprof"),
       .file = ddog_Vec_U8_as_slice(&encoded->buffer),
     } };
 
-    // DEV: This function is called with the profile_lock held, and the following
-    // function call acquires lock on CodeProvenance.
-    std::optional<std::string> json_str_opt = CodeProvenance::get_instance().try_serialize_to_json_str();
-    if (json_str_opt.has_value() and !json_str_opt.value().empty()) {
+    // DEV: The following function call acquires lock on CodeProvenance.  The
+    // returned buffer is shared with the cache and stays alive (and immutable)
+    // for the duration of the request build below.
+    std::shared_ptr<const std::string> json_str = CodeProvenance::get_instance().try_serialize_to_json_str();
+    if (json_str and !json_str->empty()) {
         files_to_send.push_back({
           .name = to_slice("code-provenance.json"),
-          .file = to_byte_slice(json_str_opt.value()),
+          .file = to_byte_slice(*json_str),
         });
     }
 
@@ -98,7 +162,13 @@ Datadog::Uploader::upload(ddog_prof_Profile& profile)
                                        encoded->endpoints_stats,
                                        nullptr,
                                        nullptr);
-    ddog_prof_EncodedProfile_drop(encoded);
+    // Request_build compressed (zstd) everything it attached; the raw serialized
+    // profile is dead weight from here on, so release it before the send stage.
+    // Retry callers keep it instead: rebuilding the request for a re-send needs
+    // the raw buffer back.
+    if (consume_encoded) {
+        ddog_prof_EncodedProfile_drop(encoded);
+    }
 
     if (build_res.tag ==
         DDOG_PROF_EXPORTER_REQUEST_BUILD_RESULT_ERR) { // NOLINT (cppcoreguidelines-pro-type-union-access)
@@ -106,9 +176,14 @@ Datadog::Uploader::upload(ddog_prof_Profile& profile)
         errmsg = err_to_msg(&err, "Error building request");
         std::cerr << errmsg << std::endl;
         ddog_Error_drop(&err);
-        return false;
+        return nullptr;
     }
+    return build_res.ok; // NOLINT (cppcoreguidelines-pro-type-union-access)
+}
 
+bool
+Datadog::Uploader::send_request(ddog_prof_Exporter_Request* req)
+{
     // If we're here, we're about to create a new upload, so cancel any inflight ones
     cancel_inflight();
 
@@ -116,17 +191,19 @@ Datadog::Uploader::upload(ddog_prof_Profile& profile)
     // since we're recreating the uploader fresh every time anyway, we recreate one more thing.
     // NB wrapping this in a unique_ptr to easily add RAII semantics; maybe should just wrap it in a
     // class instead
-    cancel.reset(ddog_CancellationToken_new());
     std::unique_ptr<ddog_CancellationToken, DdogCancellationTokenDeleter> cancel_for_request;
-    cancel_for_request.reset(ddog_CancellationToken_clone(cancel.get()));
+    {
+        const std::lock_guard<std::mutex> lock_guard(cancel_mtx);
+        cancel.reset(ddog_CancellationToken_new());
+        cancel_for_request.reset(ddog_CancellationToken_clone(cancel.get()));
+    }
 
     // The upload operation sets up some global state in libdatadog (the tokio runtime), so
     // we ensure exclusivity here.
     {
-        const std::lock_guard<std::mutex> lock_guard(upload_lock);
+        const std::lock_guard<std::timed_mutex> lock_guard(upload_lock);
 
         // Build and check the response object
-        ddog_prof_Exporter_Request* req = build_res.ok; // NOLINT (cppcoreguidelines-pro-type-union-access)
         ddog_prof_Exporter_SendResult res =
           ddog_prof_Exporter_send(ddog_exporter.get(), &req, cancel_for_request.get());
         if (res.tag == DDOG_PROF_EXPORTER_SEND_RESULT_ERR) { // NOLINT (cppcoreguidelines-pro-type-union-access)
@@ -157,24 +234,34 @@ Datadog::Uploader::unlock()
 void
 Datadog::Uploader::cancel_inflight()
 {
+    const std::lock_guard<std::mutex> lock_guard(cancel_mtx);
     cancel.reset();
 }
 
 void
 Datadog::Uploader::prefork()
 {
-    lock();
+    // Signal before waiting: the in-flight send observes the token and aborts,
+    // so the wait below is bounded by cancellation latency rather than by the
+    // agent timeout.  If the grace period expires anyway, fork without the
+    // lock; the child resets it and the parent's sender still owns it there.
     cancel_inflight();
+    prefork_locked.store(upload_lock.try_lock_for(std::chrono::milliseconds(g_upload_cancel_grace_ms)));
 }
 
 void
 Datadog::Uploader::postfork_parent()
 {
-    unlock();
+    if (prefork_locked.exchange(false)) {
+        unlock();
+    }
 }
 
 void
 Datadog::Uploader::postfork_child()
 {
+    // The sending thread does not exist in the child, so the lock state is
+    // inherited garbage either way; clear it unconditionally
+    prefork_locked.store(false);
     unlock();
 }
@@ -11,64 +11,79 @@
 void
 Datadog::UploaderBuilder::set_env(std::string_view _dd_env)
 {
-    if (!_dd_env.empty()) {
+    if (!_dd_env.empty() && dd_env != _dd_env) {
         dd_env = _dd_env;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_service(std::string_view _service)
 {
-    if (!_service.empty()) {
+    if (!_service.empty() && service != _service) {
         service = _service;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_version(std::string_view _version)
 {
-    if (!_version.empty()) {
+    if (!_version.empty() && version != _version) {
         version = _version;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_runtime(std::string_view _runtime)
 {
-    if (!_runtime.empty()) {
+    if (!_runtime.empty() && runtime != _runtime) {
         runtime = _runtime;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_runtime_id(std::string_view _runtime_id)
 {
-    if (!_runtime_id.empty()) {
+    if (!_runtime_id.empty() && runtime_id != _runtime_id) {
         runtime_id = _runtime_id;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_runtime_version(std::string_view _runtime_version)
 {
-    if (!_runtime_version.empty()) {
+    if (!_runtime_version.empty() && runtime_version != _runtime_version) {
         runtime_version = _runtime_version;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_profiler_version(std::string_view _profiler_version)
 {
-    if (!_profiler_version.empty()) {
+    if (!_profiler_version.empty() && profiler_version != _profiler_version) {
         profiler_version = _profiler_version;
+        invalidate_exporter();
+        invalidate_tags();
     }
 }
 
 void
 Datadog::UploaderBuilder::set_url(std::string_view _url)
 {
-    if (!_url.empty()) {
+    if (!_url.empty() && url != _url) {
         url = _url;
+        invalidate_exporter();
     }
 }
 
@@ -78,10 +93,49 @@ Datadog::UploaderBuilder::set_tag(std::string_view _key, std::string_view _val)
 
     if (!_key.empty() && !_val.empty()) {
         const std::lock_guard<std::mutex> lock(tag_mutex);
-        user_tags[std::string(_key)] = std::string(_val);
+        auto& entry = user_tags[std::string(_key)];
+        if (entry != _val) {
+            entry = std::string(_val);
+            invalidate_exporter();
+            invalidate_tags_locked();
+        }
+    }
+}
+
+void
+Datadog::UploaderBuilder::invalidate_exporter()
+{
+    const std::lock_guard<std::mutex> lock(exporter_mutex);
+    cached_exporter.reset();
+}
+
+void
+Datadog::UploaderBuilder::invalidate_tags()
+{
+    const std::lock_guard<std::mutex> lock(tag_mutex);
+    invalidate_tags_locked();
+}
+
+void
+Datadog::UploaderBuilder::invalidate_tags_locked()
+{
+    if (cached_tags) {
+        ddog_Vec_Tag_drop(*cached_tags);
+        cached_tags.reset();
     }
 }
 
+void
+Datadog::UploaderBuilder::postfork_child()
+{
+    // The inherited exporter's client state (connections, runtime) belongs to
+    // the parent; the child's first upload rebuilds its own.  Same story for
+    // the ring file: its path is pid-suffixed, so the child opens a fresh one.
+    invalidate_exporter();
+    const std::lock_guard<std::mutex> lock(exporter_mutex);
+    cached_ring_file.reset();
+}
+
 void
 Datadog::UploaderBuilder::set_output_filename(std::string_view _output_filename)
 {
@@ -90,6 +144,17 @@ Datadog::UploaderBuilder::set_output_filename(std::string_view _output_filename)
     }
 }
 
+void
+Datadog::UploaderBuilder::set_output_ringfile(std::string_view _path, uint64_t _capacity)
+{
+    if (!_path.empty()) {
+        ring_file_path = _path;
+        if (_capacity > 0) {
+            ring_file_capacity = _capacity;
+        }
+    }
+}
+
 std::string
 join(const std::vector<std::string>& vec, const std::string& delim)
 {
@@ -111,53 +176,82 @@ join(const std::vector<std::string>& vec, const std::string& delim)
 std::variant<Datadog::Uploader, std::string>
 Datadog::UploaderBuilder::build()
 {
-    // Setup the ddog_Exporter
-    ddog_Vec_Tag tags = ddog_Vec_Tag_new();
-
-    // Add the tags.  In the average case, the user has a structural problem with
-    // one of their tags, but it's really annoying to have to iteratively fix several
-    // tags, so we'll just collect all the reasons and report them all at once.
-    std::vector<std::string> reasons{};
-    const std::vector<std::pair<ExportTagKey, std::string_view>> tag_data = {
-        { ExportTagKey::dd_env, dd_env },
-        { ExportTagKey::service, service },
-        { ExportTagKey::version, version },
-        { ExportTagKey::language, language },
-        { ExportTagKey::runtime, runtime },
-        { ExportTagKey::runtime_id, runtime_id },
-        { ExportTagKey::runtime_version, runtime_version },
-        { ExportTagKey::profiler_version, profiler_version },
-    };
-
-    for (const auto& [tag, data] : tag_data) {
-        if (!data.empty()) {
-            std::string errmsg;
-            if (!add_tag(tags, tag, data, errmsg)) {
-                reasons.push_back(std::string(to_string(tag)) + ": " + errmsg);
+    // Flight-recorder mode: open (or reuse) the mapped ring that uploaders
+    // append to.  Failing to open it is a configuration error worth surfacing.
+    std::shared_ptr<RingFile> ring_file{};
+    if (!ring_file_path.empty()) {
+        const std::lock_guard<std::mutex> lock(exporter_mutex);
+        if (!cached_ring_file) {
+            auto ring_res = RingFile::open(ring_file_path, ring_file_capacity);
+            if (std::holds_alternative<std::string>(ring_res)) {
+                return std::get<std::string>(ring_res);
             }
+            cached_ring_file = std::get<std::shared_ptr<RingFile>>(ring_res);
         }
+        ring_file = cached_ring_file;
     }
 
-    // Add the user-defined tags, if any.
-    for (const auto& tag : user_tags) {
-        std::string errmsg;
-        if (!add_tag(tags, tag.first, tag.second, errmsg)) {
-            reasons.push_back(std::string(tag.first) + ": " + errmsg);
+    // Steady state: the configuration hasn't changed since the last cycle,
+    // so reuse the cached exporter and keep its connections alive
+    {
+        const std::lock_guard<std::mutex> lock(exporter_mutex);
+        if (cached_exporter) {
+            return Datadog::Uploader{ output_filename, cached_exporter, std::move(ring_file) };
         }
     }
 
-    if (!reasons.empty()) {
-        ddog_Vec_Tag_drop(tags);
-        return "Error initializing exporter, missing or bad configuration: " + join(reasons, ", ");
+    // Assemble the exporter tag set, unless a cached copy is still valid: rebuilds
+    // not caused by a tag change (post-fork, endpoint-only) reuse the vector as-is.
+    // ddog_prof_Exporter_new only borrows the vector, so the cache survives the call.
+    const std::lock_guard<std::mutex> tag_lock(tag_mutex);
+    if (!cached_tags) {
+        ddog_Vec_Tag tags = ddog_Vec_Tag_new();
+
+        // Add the tags.  In the average case, the user has a structural problem with
+        // one of their tags, but it's really annoying to have to iteratively fix several
+        // tags, so we'll just collect all the reasons and report them all at once.
+        std::vector<std::string> reasons{};
+        const std::vector<std::pair<ExportTagKey, std::string_view>> tag_data = {
+            { ExportTagKey::dd_env, dd_env },
+            { ExportTagKey::service, service },
+            { ExportTagKey::version, version },
+            { ExportTagKey::language, language },
+            { ExportTagKey::runtime, runtime },
+            { ExportTagKey::runtime_id, runtime_id },
+            { ExportTagKey::runtime_version, runtime_version },
+            { ExportTagKey::profiler_version, profiler_version },
+        };
+
+        for (const auto& [tag, data] : tag_data) {
+            if (!data.empty()) {
+                std::string errmsg;
+                if (!add_tag(tags, tag, data, errmsg)) {
+                    reasons.push_back(std::string(to_string(tag)) + ": " + errmsg);
+                }
+            }
+        }
+
+        // Add the user-defined tags, if any.
+        for (const auto& tag : user_tags) {
+            std::string errmsg;
+            if (!add_tag(tags, tag.first, tag.second, errmsg)) {
+                reasons.push_back(std::string(tag.first) + ": " + errmsg);
+            }
+        }
+
+        if (!reasons.empty()) {
+            ddog_Vec_Tag_drop(tags);
+            return "Error initializing exporter, missing or bad configuration: " + join(reasons, ", ");
+        }
+        cached_tags = tags;
     }
 
     // If we're here, the tags are good, so we can initialize the exporter
     ddog_prof_Exporter_NewResult res = ddog_prof_Exporter_new(to_slice("dd-trace-py"),
                                                               to_slice(profiler_version),
                                                               to_slice(family),
-                                                              &tags,
+                                                              &cached_tags.value(),
                                                               ddog_prof_Endpoint_agent(to_slice(url)));
-    ddog_Vec_Tag_drop(tags);
 
     auto ddog_exporter_result = Datadog::get_newexporter_result(res);
     ddog_prof_Exporter* ddog_exporter = nullptr;
@@ -184,5 +278,10 @@ Datadog::UploaderBuilder::build()
         return errmsg;
     }
 
-    return Datadog::Uploader{ output_filename, ddog_exporter };
+    std::shared_ptr<ddog_prof_Exporter> exporter{ ddog_exporter, DdogProfExporterDeleter{} };
+    {
+        const std::lock_guard<std::mutex> lock(exporter_mutex);
+        cached_exporter = exporter;
+    }
+    return Datadog::Uploader{ output_filename, std::move(exporter), std::move(ring_file) };
 }
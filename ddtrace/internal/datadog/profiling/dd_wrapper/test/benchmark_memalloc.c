@@ -0,0 +1,207 @@
+#include <Python.h>
+
+#include "_memalloc_heap.h"
+#include "_memalloc_reentrant.h"
+#include "_memalloc_tb.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* Microbenchmarks for the memalloc hot paths: allocator-hook overhead,
+   traceback capture latency by stack depth, heap-map track/untrack throughput
+   and snapshot pause times.  Like benchmark_throughput, this is not a
+   pass/fail test; it prints per-operation costs so changes to the reentrancy
+   guard, the heap tracker or traceback storage can be compared run to run.
+
+   This file is C rather than C++ because the collector headers are not
+   C++-clean.  The collector sources are compiled into this executable and
+   driven through an embedded interpreter: the hook benchmarks go through the
+   public _memalloc module surface, the rest call internal entry points
+   directly.
+
+   Two deliberate departures from the ideal measurement: the hooked allocator
+   domain (PYMEM_DOMAIN_OBJ) is GIL-serialized, so hook overhead is measured
+   single-threaded — a multi-threaded variant would measure the GIL, not the
+   hooks.  And the tracker caps live entries at TRACEBACK_ARRAY_MAX_COUNT, so
+   the map benchmarks run at that cap rather than "millions" of entries. */
+
+#define ALLOC_ITERS 2000000
+#define CAPTURE_ITERS 20000
+#define HEAP_ENTRIES 50000
+#define ALLOC_SIZE 512
+
+PyMODINIT_FUNC
+PyInit__memalloc(void);
+
+static double
+now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Paired PyObject_Malloc/PyObject_Free (the hooked domain), run once before
+   the hooks are installed and once after; the difference is the full
+   per-allocation cost of the profiler.  Called from a Python frame so sampled
+   captures walk a real stack, like production allocations do. */
+static PyObject*
+bench_alloc_pairs(PyObject* Py_UNUSED(module), PyObject* args)
+{
+    unsigned int iters;
+    if (!PyArg_ParseTuple(args, "I", &iters))
+        return NULL;
+
+    double start = now_s();
+    for (unsigned int i = 0; i < iters; i++) {
+        void* p = PyObject_Malloc(ALLOC_SIZE);
+        PyObject_Free(p);
+    }
+    return PyFloat_FromDouble((now_s() - start) * 1e9 / iters);
+}
+
+/* Called at the bottom of a Python recursion of known depth, so the frames
+   walked by memalloc_get_traceback are real interpreter frames.  The
+   reentrancy guard is set as the allocator hooks would before capturing. */
+static PyObject*
+bench_capture(PyObject* Py_UNUSED(module), PyObject* args)
+{
+    unsigned int iters;
+    if (!PyArg_ParseTuple(args, "I", &iters))
+        return NULL;
+
+    memalloc_set_reentrant(true);
+    double start = now_s();
+    for (unsigned int i = 0; i < iters; i++) {
+        traceback_t* tb = memalloc_get_traceback(64, (void*)(uintptr_t)0x1, ALLOC_SIZE, PYMEM_DOMAIN_OBJ);
+        if (tb)
+            traceback_free(tb);
+    }
+    double elapsed = now_s() - start;
+    memalloc_set_reentrant(false);
+
+    return PyFloat_FromDouble(elapsed * 1e9 / iters);
+}
+
+static PyObject*
+bench_heap(PyObject* module, PyObject* args);
+
+static PyMethodDef bench_methods[] = { { "capture", bench_capture, METH_VARARGS, NULL },
+                                       { "alloc_pairs", bench_alloc_pairs, METH_VARARGS, NULL },
+                                       { "heap", bench_heap, METH_VARARGS, NULL },
+                                       { NULL, NULL, 0, NULL } };
+
+static struct PyModuleDef bench_module = { PyModuleDef_HEAD_INIT, "memalloc_bench", NULL, -1, bench_methods,
+                                           NULL,                  NULL,             NULL, NULL };
+
+static PyObject*
+bench_module_init(void)
+{
+    return PyModule_Create(&bench_module);
+}
+
+/* Every benchmark body runs at the bottom of a Python recursion of known
+   depth: memalloc bails out of traceback capture when no frame is live, so a
+   bare C call stack would skip the very paths being measured. */
+static const char* bench_py = "import memalloc_bench\n"
+                              "def rec(n, fn, *args):\n"
+                              "    if n > 0:\n"
+                              "        return rec(n - 1, fn, *args)\n"
+                              "    return fn(*args)\n";
+
+static PyObject* bench_rec;
+
+static double
+call_at_depth(unsigned int depth, const char* fn_name, unsigned int iters)
+{
+    PyObject* bench = PyImport_ImportModule("memalloc_bench");
+    PyObject* fn = PyObject_GetAttrString(bench, fn_name);
+    PyObject* ns = PyObject_CallFunction(bench_rec, "IOI", depth, fn, iters);
+    double out = (ns && PyFloat_Check(ns)) ? PyFloat_AsDouble(ns) : -1.0;
+    Py_XDECREF(ns);
+    Py_XDECREF(fn);
+    Py_XDECREF(bench);
+    return out;
+}
+
+static void
+run_capture_benchmarks(void)
+{
+    static const unsigned int depths[] = { 4, 16, 64, 256 };
+
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++)
+        printf("traceback capture, depth %3u: %8.1f ns/op\n", depths[i], call_at_depth(depths[i], "capture", CAPTURE_ITERS));
+}
+
+static PyObject*
+bench_heap(PyObject* Py_UNUSED(module), PyObject* Py_UNUSED(args))
+{
+    /* A size far above the sampling interval makes every call cross the
+       sampling threshold, so each iteration exercises the full track path. */
+    const size_t tracked_size = (size_t)8 << 20;
+
+    double start = now_s();
+    for (unsigned int i = 0; i < HEAP_ENTRIES; i++)
+        memalloc_heap_track(16, (void*)(uintptr_t)(0x1000 + i * 16), tracked_size, PYMEM_DOMAIN_OBJ);
+    printf("heap track   (%u live):     %8.1f ns/op\n", HEAP_ENTRIES, (now_s() - start) * 1e9 / HEAP_ENTRIES);
+
+    start = now_s();
+    PyObject* snapshot = memalloc_heap();
+    printf("heap snapshot pause:         %8.3f ms\n", (now_s() - start) * 1e3);
+    Py_XDECREF(snapshot);
+
+    start = now_s();
+    PyObject* diff = memalloc_heap_diff();
+    printf("heap diff, first (full):     %8.3f ms\n", (now_s() - start) * 1e3);
+    Py_XDECREF(diff);
+
+    start = now_s();
+    diff = memalloc_heap_diff();
+    printf("heap diff, steady (empty):   %8.3f ms\n", (now_s() - start) * 1e3);
+    Py_XDECREF(diff);
+
+    start = now_s();
+    for (unsigned int i = 0; i < HEAP_ENTRIES; i++)
+        memalloc_heap_untrack((void*)(uintptr_t)(0x1000 + i * 16));
+    printf("heap untrack (%u live):     %8.1f ns/op\n", HEAP_ENTRIES, (now_s() - start) * 1e9 / HEAP_ENTRIES);
+
+    Py_RETURN_NONE;
+}
+
+int
+main(void)
+{
+    PyImport_AppendInittab("_memalloc", PyInit__memalloc);
+    PyImport_AppendInittab("memalloc_bench", bench_module_init);
+    Py_Initialize();
+
+#ifdef MEMALLOC_BENCH_PYPATH
+    /* Module init resolves ddtrace.profiling.event for the DDFrame class; make
+       the source checkout importable when ddtrace is not installed. */
+    PyRun_SimpleString("import sys; sys.path.insert(0, \"" MEMALLOC_BENCH_PYPATH "\")");
+#endif
+
+    PyObject* main_mod = PyImport_AddModule("__main__");
+    PyObject* globals = PyModule_GetDict(main_mod);
+    PyObject* result = PyRun_String(bench_py, Py_file_input, globals, globals);
+    Py_XDECREF(result);
+    bench_rec = PyDict_GetItemString(globals, "rec");
+
+    double unhooked = call_at_depth(8, "alloc_pairs", ALLOC_ITERS);
+    if (PyRun_SimpleString("import _memalloc; _memalloc.start(64, 16, 524288, 0, 0)") != 0) {
+        fprintf(stderr, "benchmark_memalloc: could not start _memalloc (is ddtrace importable?)\n");
+        return 1;
+    }
+    double hooked = call_at_depth(8, "alloc_pairs", ALLOC_ITERS);
+
+    printf("object malloc/free pair, unhooked: %6.1f ns/op\n", unhooked);
+    printf("object malloc/free pair, hooked:   %6.1f ns/op (+%.1f ns)\n", hooked, hooked - unhooked);
+
+    run_capture_benchmarks();
+    call_at_depth(0, "heap", 0);
+
+    PyRun_SimpleString("_memalloc.stop()");
+    Py_Finalize();
+    return 0;
+}
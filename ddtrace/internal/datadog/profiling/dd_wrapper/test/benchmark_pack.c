@@ -0,0 +1,436 @@
+#include <Python.h>
+
+#include "pack.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Microbenchmarks for the msgpack packer behind the trace encoders.  Each
+   scenario packs spans through the same call sequences MsgpackEncoderV04 and
+   MsgpackEncoderV05 in _encoding.pyx use -- fragment keys, kv_uint64 for the
+   fixed numeric fields, msgpack_pack_unicode for text, and the native string
+   table for v0.5 indices -- and reports bytes/sec and allocations per span,
+   so changes to the buffer pool, the bulk emitters or the string-id cache
+   can be compared run to run.  Like benchmark_throughput, this is not a
+   pass/fail test.
+
+   The span shapes vary along the axes that dominate production payloads:
+   tag count, string-heavy vs numeric-heavy content, and whether the encode
+   buffer starts cold (empty pool, so every run grows through realloc) or
+   warm (recycled from the pool at its steady size).  Strings are drawn from
+   small pools of distinct values, as service/name/resource and tag keys are
+   in practice; this is what gives the v0.5 string table its hit rate.
+
+   Allocations are counted by wrapping the PYMEM_DOMAIN_MEM allocator, which
+   is the domain the packer and the string table allocate from. */
+
+#define SPANS_PER_TRACE 100
+#define TRACES_PER_RUN 50
+#define RUNS 40
+
+#define ITEM_LIMIT ((long long)1 << 31)
+
+static double
+now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ---- allocation counting -------------------------------------------------- */
+
+static PyMemAllocatorEx prev_alloc;
+static uint64_t alloc_count;
+
+static void*
+count_malloc(void* ctx, size_t size)
+{
+    alloc_count++;
+    return prev_alloc.malloc(prev_alloc.ctx, size);
+}
+
+static void*
+count_calloc(void* ctx, size_t nelem, size_t elsize)
+{
+    alloc_count++;
+    return prev_alloc.calloc(prev_alloc.ctx, nelem, elsize);
+}
+
+static void*
+count_realloc(void* ctx, void* ptr, size_t size)
+{
+    alloc_count++;
+    return prev_alloc.realloc(prev_alloc.ctx, ptr, size);
+}
+
+static void
+count_free(void* ctx, void* ptr)
+{
+    prev_alloc.free(prev_alloc.ctx, ptr);
+}
+
+static void
+install_alloc_counter(void)
+{
+    PyMemAllocatorEx hooked = { NULL, count_malloc, count_calloc, count_realloc, count_free };
+    PyMem_GetAllocator(PYMEM_DOMAIN_MEM, &prev_alloc);
+    PyMem_SetAllocator(PYMEM_DOMAIN_MEM, &hooked);
+}
+
+/* ---- scenario data -------------------------------------------------------- */
+
+#define N_SERVICES 16
+#define N_NAMES 256
+#define N_RESOURCES 256
+#define MAX_TAGS 64
+#define N_TAG_VALUES 256
+#define MAX_METRICS 64
+
+static PyObject* services[N_SERVICES];
+static PyObject* names[N_NAMES];
+static PyObject* resources[N_RESOURCES];
+static PyObject* tag_keys[MAX_TAGS];
+static PyObject* tag_values[N_TAG_VALUES];
+
+static msgpack_fragment KEY_SERVICE, KEY_RESOURCE, KEY_NAME, KEY_TYPE, KEY_META, KEY_METRICS;
+
+static uint32_t rng_state = 1;
+
+static inline uint32_t
+rng_next(void)
+{
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 16;
+}
+
+static PyObject*
+random_string(size_t len)
+{
+    char buf[256];
+    if (len > sizeof(buf))
+        len = sizeof(buf);
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (char)('a' + rng_next() % 26);
+    return PyUnicode_FromStringAndSize(buf, (Py_ssize_t)len);
+}
+
+static void
+init_scenario_data(size_t tag_value_len)
+{
+    rng_state = 1;
+
+    for (int i = 0; i < N_SERVICES; i++)
+        services[i] = random_string(16);
+    for (int i = 0; i < N_NAMES; i++)
+        names[i] = random_string(16);
+    for (int i = 0; i < N_RESOURCES; i++)
+        resources[i] = random_string(16);
+    for (int i = 0; i < MAX_TAGS; i++)
+        tag_keys[i] = random_string(16);
+    for (int i = 0; i < N_TAG_VALUES; i++)
+        tag_values[i] = random_string(tag_value_len);
+
+    msgpack_fragment_init_str(&KEY_SERVICE, "service", 7);
+    msgpack_fragment_init_str(&KEY_RESOURCE, "resource", 8);
+    msgpack_fragment_init_str(&KEY_NAME, "name", 4);
+    msgpack_fragment_init_str(&KEY_TYPE, "type", 4);
+    msgpack_fragment_init_str(&KEY_META, "meta", 4);
+    msgpack_fragment_init_str(&KEY_METRICS, "metrics", 7);
+}
+
+static void
+free_scenario_data(void)
+{
+    for (int i = 0; i < N_SERVICES; i++)
+        Py_CLEAR(services[i]);
+    for (int i = 0; i < N_NAMES; i++)
+        Py_CLEAR(names[i]);
+    for (int i = 0; i < N_RESOURCES; i++)
+        Py_CLEAR(resources[i]);
+    for (int i = 0; i < MAX_TAGS; i++)
+        Py_CLEAR(tag_keys[i]);
+    for (int i = 0; i < N_TAG_VALUES; i++)
+        Py_CLEAR(tag_values[i]);
+}
+
+/* Free every recycled buffer so the next packer init starts from a cold
+   4 KiB allocation and grows through the realloc path, the way the first
+   payload after process start does. */
+static void
+drain_buffer_pool(void)
+{
+    for (int c = 0; c < MSGPACK_POOL_CLASS_COUNT; c++) {
+        while (msgpack_pool_count[c] > 0)
+            PyMem_Free(msgpack_pool[c][--msgpack_pool_count[c]]);
+    }
+}
+
+/* ---- span packing, v0.4 shape --------------------------------------------- */
+
+/* Same field sequence as MsgpackEncoderV04.pack_span: a map with the fixed
+   fields through kv_uint64/fragments, then meta and metrics sub-maps. */
+static int
+pack_span_v04(msgpack_packer* pk, uint64_t span_id, int ntags, int nmetrics)
+{
+    int ret = msgpack_pack_map(pk, (size_t)(7 + (ntags > 0) + (nmetrics > 0)));
+    if (ret != 0)
+        return ret;
+
+    if ((ret = msgpack_pack_kv_uint64(pk, "trace_id", 8, span_id ^ 0x5a5a5a5a5a5a5a5aULL)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_kv_uint64(pk, "span_id", 7, span_id)) != 0)
+        return ret;
+
+    if ((ret = msgpack_pack_fragment(pk, &KEY_SERVICE)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_unicode(pk, services[rng_next() % N_SERVICES], ITEM_LIMIT)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_fragment(pk, &KEY_RESOURCE)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_unicode(pk, resources[rng_next() % N_RESOURCES], ITEM_LIMIT)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_fragment(pk, &KEY_NAME)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_unicode(pk, names[rng_next() % N_NAMES], ITEM_LIMIT)) != 0)
+        return ret;
+
+    if ((ret = msgpack_pack_kv_uint64(pk, "start", 5, 1700000000000000000ULL + span_id)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_kv_uint64(pk, "duration", 8, 1000000ULL + (span_id & 0xffff))) != 0)
+        return ret;
+
+    if (ntags > 0) {
+        if ((ret = msgpack_pack_fragment(pk, &KEY_META)) != 0)
+            return ret;
+        if ((ret = msgpack_pack_map(pk, (size_t)ntags)) != 0)
+            return ret;
+        for (int i = 0; i < ntags; i++) {
+            if ((ret = msgpack_pack_unicode(pk, tag_keys[i], ITEM_LIMIT)) != 0)
+                return ret;
+            if ((ret = msgpack_pack_unicode(pk, tag_values[rng_next() % N_TAG_VALUES], ITEM_LIMIT)) != 0)
+                return ret;
+        }
+    }
+
+    if (nmetrics > 0) {
+        if ((ret = msgpack_pack_fragment(pk, &KEY_METRICS)) != 0)
+            return ret;
+        if ((ret = msgpack_pack_map(pk, (size_t)nmetrics)) != 0)
+            return ret;
+        for (int i = 0; i < nmetrics; i++) {
+            if ((ret = msgpack_pack_unicode(pk, tag_keys[i % MAX_TAGS], ITEM_LIMIT)) != 0)
+                return ret;
+            if ((ret = msgpack_pack_double(pk, (double)(rng_next() % 100000) / 100.0)) != 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+/* ---- span packing, v0.5 shape --------------------------------------------- */
+
+/* The v0.5 string table: strings live once in a side buffer, spans carry
+   indices.  The id cache sits in front, the way MsgpackStringTable uses it:
+   a hit emits canned index bytes, a miss appends the string to the table
+   buffer, assigns the next id and caches it. */
+typedef struct v05_table
+{
+    msgpack_strtable cache;
+    msgpack_packer strings;
+    uint32_t next_id;
+} v05_table;
+
+static int
+v05_table_init(v05_table* t)
+{
+    if (msgpack_strtable_init(&t->cache) != 0)
+        return -1;
+    if (msgpack_packer_init(&t->strings, 1 << 12) != 0) {
+        msgpack_strtable_destroy(&t->cache);
+        return -1;
+    }
+    t->next_id = 0;
+    return 0;
+}
+
+static void
+v05_table_destroy(v05_table* t)
+{
+    msgpack_strtable_destroy(&t->cache);
+    msgpack_packer_destroy(&t->strings);
+}
+
+static int
+v05_pack_string(v05_table* t, msgpack_packer* pk, PyObject* s)
+{
+    int ret = msgpack_strtable_pack(&t->cache, pk, s);
+    if (ret != 1)
+        return ret;
+
+    uint32_t id = t->next_id++;
+    if (msgpack_pack_unicode(&t->strings, s, ITEM_LIMIT) != 0)
+        return -1;
+    if (msgpack_strtable_insert(&t->cache, s, id) != 0)
+        return -1;
+    return msgpack_strtable_pack(&t->cache, pk, s);
+}
+
+/* Same 12-element array as MsgpackEncoderV05.pack_span */
+static int
+pack_span_v05(v05_table* t, msgpack_packer* pk, uint64_t span_id, int ntags, int nmetrics)
+{
+    int ret = msgpack_pack_array(pk, 12);
+    if (ret != 0)
+        return ret;
+
+    if ((ret = v05_pack_string(t, pk, services[rng_next() % N_SERVICES])) != 0)
+        return ret;
+    if ((ret = v05_pack_string(t, pk, names[rng_next() % N_NAMES])) != 0)
+        return ret;
+    if ((ret = v05_pack_string(t, pk, resources[rng_next() % N_RESOURCES])) != 0)
+        return ret;
+
+    if ((ret = msgpack_pack_uint64(pk, span_id ^ 0x5a5a5a5a5a5a5a5aULL)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_uint64(pk, span_id)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_uint64(pk, span_id >> 1)) != 0)
+        return ret;
+    if ((ret = msgpack_pack_int64(pk, (int64_t)(1700000000000000000ULL + span_id))) != 0)
+        return ret;
+    if ((ret = msgpack_pack_int64(pk, (int64_t)(1000000ULL + (span_id & 0xffff)))) != 0)
+        return ret;
+    if ((ret = msgpack_pack_int32(pk, 0)) != 0)
+        return ret;
+
+    if ((ret = msgpack_pack_map(pk, (size_t)ntags)) != 0)
+        return ret;
+    for (int i = 0; i < ntags; i++) {
+        if ((ret = v05_pack_string(t, pk, tag_keys[i])) != 0)
+            return ret;
+        if ((ret = v05_pack_string(t, pk, tag_values[rng_next() % N_TAG_VALUES])) != 0)
+            return ret;
+    }
+
+    if ((ret = msgpack_pack_map(pk, (size_t)nmetrics)) != 0)
+        return ret;
+    for (int i = 0; i < nmetrics; i++) {
+        if ((ret = v05_pack_string(t, pk, tag_keys[i % MAX_TAGS])) != 0)
+            return ret;
+        if ((ret = msgpack_pack_double(pk, (double)(rng_next() % 100000) / 100.0)) != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+/* ---- harness -------------------------------------------------------------- */
+
+typedef struct scenario
+{
+    const char* name;
+    int v05;
+    int ntags;
+    size_t tag_value_len;
+    int nmetrics;
+    int cold;
+} scenario;
+
+static int
+run_scenario(const scenario* s)
+{
+    init_scenario_data(s->tag_value_len);
+
+    const uint64_t spans = (uint64_t)RUNS * TRACES_PER_RUN * SPANS_PER_TRACE;
+    uint64_t bytes = 0;
+    uint64_t span_id = 1;
+    int ret = 0;
+
+    /* One throwaway run so the warm variants measure the pool steady state */
+    drain_buffer_pool();
+
+    uint64_t allocs_before = 0;
+    double start = 0.0;
+
+    for (int run = -1; run < RUNS && ret == 0; run++) {
+        if (run == 0) {
+            alloc_count = 0;
+            allocs_before = alloc_count;
+            start = now_s();
+        }
+        if (s->cold)
+            drain_buffer_pool();
+
+        msgpack_packer pk;
+        if (msgpack_packer_init(&pk, 1 << 12) != 0)
+            return -1;
+
+        v05_table table;
+        if (s->v05 && v05_table_init(&table) != 0) {
+            msgpack_packer_destroy(&pk);
+            return -1;
+        }
+
+        for (int t = 0; t < TRACES_PER_RUN && ret == 0; t++) {
+            ret = msgpack_pack_array(&pk, SPANS_PER_TRACE);
+            for (int i = 0; i < SPANS_PER_TRACE && ret == 0; i++, span_id++)
+                ret = s->v05 ? pack_span_v05(&table, &pk, span_id, s->ntags, s->nmetrics)
+                             : pack_span_v04(&pk, span_id, s->ntags, s->nmetrics);
+        }
+
+        if (run >= 0)
+            bytes += pk.length + (s->v05 ? table.strings.length : 0);
+        if (s->v05)
+            v05_table_destroy(&table);
+        msgpack_packer_destroy(&pk);
+    }
+
+    double elapsed = now_s() - start;
+    uint64_t allocs = alloc_count - allocs_before;
+
+    free_scenario_data();
+
+    if (ret != 0) {
+        fprintf(stderr, "benchmark_pack: scenario %s failed\n", s->name);
+        return -1;
+    }
+
+    printf("%-28s %8.1f ns/span  %7.1f MB/s  %6.3f allocs/span\n",
+           s->name,
+           elapsed * 1e9 / (double)spans,
+           (double)bytes / elapsed / 1e6,
+           (double)allocs / (double)spans);
+    return 0;
+}
+
+int
+main(void)
+{
+    Py_Initialize();
+    install_alloc_counter();
+
+    static const scenario scenarios[] = {
+        { "v0.4 bare", 0, 0, 16, 0, 0 },
+        { "v0.4 10 tags, warm", 0, 10, 16, 0, 0 },
+        { "v0.4 10 tags, cold", 0, 10, 16, 0, 1 },
+        { "v0.4 string-heavy", 0, 10, 128, 0, 0 },
+        { "v0.4 numeric-heavy", 0, 0, 16, 48, 0 },
+        { "v0.5 bare", 1, 0, 16, 0, 0 },
+        { "v0.5 10 tags, warm", 1, 10, 16, 0, 0 },
+        { "v0.5 10 tags, cold", 1, 10, 16, 0, 1 },
+        { "v0.5 string-heavy", 1, 10, 128, 0, 0 },
+        { "v0.5 numeric-heavy", 1, 0, 16, 48, 0 },
+    };
+
+    int ret = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]) && ret == 0; i++)
+        ret = run_scenario(&scenarios[i]);
+
+    drain_buffer_pool();
+    Py_Finalize();
+    return ret == 0 ? 0 : 1;
+}
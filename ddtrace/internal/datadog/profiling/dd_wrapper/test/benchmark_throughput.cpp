@@ -0,0 +1,91 @@
+#include "ddup_interface.hpp"
+#include "test_utils.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Throughput benchmark for the sampling hot path: start_sample -> push_frame
+// x64 -> flush_sample, across 1-16 threads.  This is not a pass/fail test; it
+// prints samples/second per configuration so pool, aggregation and interning
+// changes (and libdatadog bumps) can be compared release to release.
+
+constexpr unsigned int frames_per_sample = 64;
+constexpr unsigned int samples_per_thread = 20000;
+
+struct Frame
+{
+    std::string name;
+    std::string filename;
+};
+
+// A realistic stack repeats mostly the same frames sample to sample, with
+// names/paths shaped like real Python code.  Build them once per thread so the
+// benchmark measures the sampler, not std::string concatenation.
+std::vector<Frame>
+make_frames()
+{
+    std::vector<Frame> frames;
+    frames.reserve(frames_per_sample);
+    for (unsigned int i = 0; i < frames_per_sample; i++) {
+        std::string pkg = get_name();
+        Frame frame;
+        frame.name = pkg + ".process_request_" + std::to_string(i);
+        frame.filename = "/app/venv/lib/python3.10/site-packages/" + pkg + "/handlers.py";
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+void
+sampler_thread(unsigned int thread_id)
+{
+    const std::vector<Frame> frames = make_frames();
+    const std::string thread_name = "sampler-" + std::to_string(thread_id);
+
+    for (unsigned int i = 0; i < samples_per_thread; i++) {
+        auto* h = ddup_start_sample();
+        ddup_push_walltime(h, 10000, 1);
+        ddup_push_cputime(h, 5000, 1);
+        ddup_push_threadinfo(h, thread_id, thread_id, thread_name);
+        for (const auto& frame : frames) {
+            ddup_push_frame(h, frame.name, frame.filename, 0, static_cast<int64_t>(i % 500));
+        }
+        ddup_flush_sample(h);
+        ddup_drop_sample(h);
+    }
+}
+
+double
+run_benchmark(unsigned int num_threads)
+{
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.emplace_back(sampler_thread, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double elapsed_s = std::chrono::duration<double>(end - start).count();
+    const double total_samples = static_cast<double>(num_threads) * samples_per_thread;
+    return total_samples / elapsed_s;
+}
+
+int
+main()
+{
+    configure("my_test_service", "my_test_env", "0.0.1", "https://localhost:8126", "cpython", "3.10.6", "3.100", 256);
+
+    std::printf("%8s %16s %20s\n", "threads", "samples/s", "samples/s/thread");
+    for (const unsigned int num_threads : { 1U, 2U, 4U, 8U, 16U }) {
+        const double rate = run_benchmark(num_threads);
+        std::printf("%8u %16.0f %20.0f\n", num_threads, rate, rate / num_threads);
+    }
+
+    return 0;
+}
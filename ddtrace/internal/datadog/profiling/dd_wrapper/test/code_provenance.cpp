@@ -38,6 +38,25 @@ TEST_F(CodeProvenanceTest, SingletonInstance)
     ASSERT_EQ(&cp, &cp2);
 }
 
+TEST_F(CodeProvenanceTest, ClassifyPathUsesLongestPrefix)
+{
+    // First sight of a directory pays the scan and interns the prefix
+    EXPECT_STREQ(cp.classify_path("/usr/lib/python3.10/os.py"), "stdlib");
+
+    // The interned interpreter prefix must not swallow the site-packages tree
+    // living beneath it; the deeper package prefix wins
+    EXPECT_STREQ(cp.classify_path("/usr/lib/python3.10/site-packages/requests/models.py"), "requests");
+    EXPECT_STREQ(cp.classify_path("/usr/lib/python3.10/site-packages/urllib3/util/retry.py"), "urllib3");
+
+    // Unregistered distributions stay unclassified
+    EXPECT_EQ(cp.classify_path("/usr/lib/python3.10/site-packages/notinstalled/x.py"), nullptr);
+
+    // Results are interned: repeated classification returns the same pointer
+    const char* first = cp.classify_path("/usr/lib/python3.10/site-packages/requests/api.py");
+    const char* second = cp.classify_path("/usr/lib/python3.10/site-packages/requests/sessions.py");
+    EXPECT_EQ(first, second);
+}
+
 TEST_F(CodeProvenanceTest, SerializeJsonStr)
 {
 
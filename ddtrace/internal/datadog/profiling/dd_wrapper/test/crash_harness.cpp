@@ -0,0 +1,339 @@
+#include "crashtracker_interface.hpp"
+#include "test_utils.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+// Fault-injection and latency harness for the crash handling path.
+//
+// Each scenario runs in a disposable process tree (EXPECT_EXIT keeps the
+// crashtracker's signal handlers out of the gtest process): the outer child
+// configures the crashtracker against a file:// endpoint in a fresh temp
+// directory, forks a grandchild that arms a fault and crashes, and then
+// measures two things the pre-spawned receiver and preallocated alt stack
+// exist to defend:
+//   - handler latency: wall time from the faulting instruction (stamped into
+//     shared memory right before the crash) to the grandchild's exit, an
+//     upper bound on handler + receiver hand-off since nothing else runs in
+//     between;
+//   - delivery: whether a non-empty crash report landed in the endpoint
+//     directory.
+// The numbers are printed per scenario so regressions show up in CI logs,
+// with a deliberately loose latency ceiling as the hard assertion.
+//
+// The receiver binary lives outside this test target; the harness takes its
+// path from DD_CRASHTRACKER_TEST_RECEIVER and skips when it is not set.
+
+// Allocation-failure injection: a strong malloc/calloc definition for the
+// whole process that forwards to glibc until the flag flips.  This is what
+// the handler sees under OOM, without the flakiness of actually exhausting
+// memory.
+extern "C" void*
+__libc_malloc(size_t size);
+extern "C" void*
+__libc_calloc(size_t nelem, size_t elsize);
+
+static std::atomic<bool> fail_allocations{ false };
+
+extern "C" void*
+malloc(size_t size)
+{
+    if (fail_allocations.load(std::memory_order_relaxed))
+        return nullptr;
+    return __libc_malloc(size);
+}
+
+extern "C" void*
+calloc(size_t nelem, size_t elsize)
+{
+    if (fail_allocations.load(std::memory_order_relaxed))
+        return nullptr;
+    return __libc_calloc(nelem, elsize);
+}
+
+static uint64_t
+now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Stamped by the grandchild immediately before the faulting instruction,
+// read by the parent after waitpid; MAP_SHARED so it survives the crash.
+static uint64_t* crash_armed_ns = nullptr;
+
+static void
+setup_crashtracker(const std::string& report_dir)
+{
+    const char* receiver = std::getenv("DD_CRASHTRACKER_TEST_RECEIVER");
+    crashtracker_set_receiver_binary_path(receiver != nullptr ? receiver : "");
+    crashtracker_set_url("file://" + report_dir + "/crash_report");
+    crashtracker_set_service("crash_harness");
+    crashtracker_set_env("test");
+    crashtracker_set_version("0.0.1");
+    crashtracker_set_runtime("cpython");
+    crashtracker_set_runtime_version("3.10.6");
+    crashtracker_set_runtime_id("00000000-0000-0000-0000-000000000000");
+    crashtracker_set_library_version("harness");
+    crashtracker_set_stdout_filename(report_dir + "/receiver_stdout");
+    crashtracker_set_stderr_filename(report_dir + "/receiver_stderr");
+    crashtracker_set_alt_stack(true);
+    crashtracker_set_wait_for_receiver(true);
+    crashtracker_set_resolve_frames_safe();
+    crashtracker_start();
+}
+
+// A delivered report is any non-empty regular file in the endpoint directory
+// besides the receiver's stdio captures
+static bool
+report_delivered(const std::string& report_dir)
+{
+    DIR* dir = opendir(report_dir.c_str());
+    if (dir == nullptr)
+        return false;
+
+    bool found = false;
+    for (struct dirent* entry = readdir(dir); entry != nullptr && !found; entry = readdir(dir)) {
+        if (strncmp(entry->d_name, "receiver_", strlen("receiver_")) == 0)
+            continue;
+        struct stat st;
+        std::string path = report_dir + "/" + entry->d_name;
+        if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+            found = true;
+    }
+    closedir(dir);
+    return found;
+}
+
+static std::string
+make_report_dir()
+{
+    char tmpl[] = "/tmp/dd_crash_harness_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    return dir != nullptr ? std::string(dir) : std::string("/tmp");
+}
+
+// --- faults -----------------------------------------------------------------
+
+[[noreturn]] static void
+fault_segv()
+{
+    *crash_armed_ns = now_ns();
+    *(volatile int*)1 = 42; // NOLINT: the point
+    __builtin_unreachable();
+}
+
+[[noreturn]] static void
+fault_segv_while_profiling()
+{
+    // Crash with every profiling-state flag raised, the way a crash inside
+    // the profiler itself would present
+    crashtracker_profiling_state_sampling_start();
+    crashtracker_profiling_state_unwinding_start();
+    crashtracker_profiling_state_serializing_start();
+    fault_segv();
+}
+
+[[noreturn]] static void
+fault_segv_corrupted_heap()
+{
+    // Scribble over freed allocator metadata before crashing, so the handler
+    // runs on a heap it cannot trust (and must therefore not use)
+    for (int i = 0; i < 64; i++) {
+        char* block = (char*)__libc_malloc(64);
+        free(block);
+        memset(block, 0xAB, 96); // past the end, over the freelist links
+    }
+    fault_segv();
+}
+
+[[noreturn]] static void
+fault_segv_no_allocation()
+{
+    // Every malloc/calloc from here on fails, handler included; delivery
+    // depends on the pre-spawned receiver and preallocated buffers
+    fail_allocations.store(true);
+    fault_segv();
+}
+
+static int
+overflow_stack(int depth)
+{
+    volatile char pad[4096];
+    pad[0] = (char)depth;
+    if (depth == 0)
+        *crash_armed_ns = now_ns();
+    return overflow_stack(depth + 1) + pad[0];
+}
+
+[[noreturn]] static void
+fault_stack_overflow()
+{
+    // Faults on the guard page; the handler must run on the alternate stack
+    std::exit(overflow_stack(0)); // never reached
+}
+
+// --- harness ----------------------------------------------------------------
+
+struct CrashOutcome
+{
+    bool delivered;
+    uint64_t latency_ns;
+};
+
+// Fork a grandchild that sets up the crashtracker and runs `fault`; measure
+// time from the armed stamp to its exit and check the endpoint directory.
+static CrashOutcome
+run_crash_scenario(const char* name, void (*fault)())
+{
+    std::string report_dir = make_report_dir();
+    *crash_armed_ns = 0;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        setup_crashtracker(report_dir);
+        fault();
+        _exit(1); // fault() must not return
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    uint64_t exited_ns = now_ns();
+
+    CrashOutcome outcome;
+    outcome.delivered = report_delivered(report_dir);
+    outcome.latency_ns = (*crash_armed_ns != 0 && exited_ns > *crash_armed_ns) ? exited_ns - *crash_armed_ns : 0;
+
+    // Stderr so EXPECT_EXIT surfaces it; these are the harness's numbers
+    fprintf(stderr,
+            "[crash_harness] scenario=%s signaled=%d delivered=%d latency_us=%llu\n",
+            name,
+            WIFSIGNALED(status) ? WTERMSIG(status) : 0,
+            outcome.delivered ? 1 : 0,
+            (unsigned long long)(outcome.latency_ns / 1000));
+    return outcome;
+}
+
+// Generous by design: the assertion is a tripwire for hangs and lost
+// reports, the printed numbers are the real output
+constexpr uint64_t g_harness_latency_ceiling_ns = 10ULL * 1000 * 1000 * 1000;
+
+[[noreturn]] static void
+single_fault_scenario(const char* name, void (*fault)())
+{
+    CrashOutcome outcome = run_crash_scenario(name, fault);
+    bool ok = outcome.delivered && outcome.latency_ns > 0 && outcome.latency_ns < g_harness_latency_ceiling_ns;
+    std::exit(ok ? 0 : 1);
+}
+
+// Fork storm: several grandchildren crash concurrently; delivery is counted
+// rather than required to be perfect, the exit criterion is the rate
+[[noreturn]] static void
+crash_storm_scenario(unsigned int num_children)
+{
+    unsigned int delivered = 0;
+    std::vector<pid_t> children;
+    std::vector<std::string> dirs;
+
+    for (unsigned int i = 0; i < num_children; i++) {
+        dirs.push_back(make_report_dir());
+        pid_t pid = fork();
+        if (pid == 0) {
+            setup_crashtracker(dirs.back());
+            fault_segv();
+        }
+        children.push_back(pid);
+    }
+
+    for (unsigned int i = 0; i < num_children; i++) {
+        int status;
+        waitpid(children[i], &status, 0);
+        if (report_delivered(dirs[i]))
+            delivered++;
+    }
+
+    fprintf(stderr, "[crash_harness] scenario=crash_storm delivered=%u/%u\n", delivered, num_children);
+
+    // All-but-one tolerates scheduler unfairness without masking a real
+    // delivery regression
+    std::exit(delivered + 1 >= num_children ? 0 : 1);
+}
+
+class CrashHarnessTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        if (std::getenv("DD_CRASHTRACKER_TEST_RECEIVER") == nullptr) {
+            GTEST_SKIP() << "DD_CRASHTRACKER_TEST_RECEIVER not set; skipping crash harness";
+        }
+        crash_armed_ns =
+          (uint64_t*)mmap(nullptr, sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        ASSERT_NE(crash_armed_ns, MAP_FAILED);
+    }
+
+    void TearDown() override
+    {
+        if (crash_armed_ns != nullptr && crash_armed_ns != MAP_FAILED) {
+            munmap(crash_armed_ns, sizeof(uint64_t));
+            crash_armed_ns = nullptr;
+        }
+    }
+};
+
+TEST_F(CrashHarnessTest, SegvBaseline)
+{
+    EXPECT_EXIT(single_fault_scenario("segv", fault_segv), ::testing::ExitedWithCode(0), ".*");
+}
+
+TEST_F(CrashHarnessTest, SegvWhileProfiling)
+{
+    EXPECT_EXIT(single_fault_scenario("segv_profiling", fault_segv_while_profiling),
+                ::testing::ExitedWithCode(0),
+                ".*");
+}
+
+TEST_F(CrashHarnessTest, SegvCorruptedHeap)
+{
+    EXPECT_EXIT(single_fault_scenario("segv_corrupted_heap", fault_segv_corrupted_heap),
+                ::testing::ExitedWithCode(0),
+                ".*");
+}
+
+TEST_F(CrashHarnessTest, SegvAllocationFailure)
+{
+    EXPECT_EXIT(single_fault_scenario("segv_no_alloc", fault_segv_no_allocation),
+                ::testing::ExitedWithCode(0),
+                ".*");
+}
+
+TEST_F(CrashHarnessTest, StackOverflow)
+{
+    EXPECT_EXIT(single_fault_scenario("stack_overflow", fault_stack_overflow), ::testing::ExitedWithCode(0), ".*");
+}
+
+TEST_F(CrashHarnessTest, CrashStorm)
+{
+    EXPECT_EXIT(crash_storm_scenario(8), ::testing::ExitedWithCode(0), ".*");
+}
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    (void)(::testing::GTEST_FLAG(death_test_style) = "threadsafe");
+    return RUN_ALL_TESTS();
+}
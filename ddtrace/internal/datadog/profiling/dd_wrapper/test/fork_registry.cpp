@@ -0,0 +1,90 @@
+#include "fork_registry.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// The registry callbacks are plain function pointers, so the test records
+// execution order through file-level state.
+namespace {
+
+std::vector<std::string> prefork_log;
+std::vector<std::string> parent_log;
+std::vector<std::string> child_log;
+
+void
+restart_prefork()
+{
+    prefork_log.push_back("restart");
+}
+void
+restart_child()
+{
+    child_log.push_back("restart");
+}
+
+void
+stop_prefork()
+{
+    prefork_log.push_back("stop");
+}
+void
+stop_parent()
+{
+    parent_log.push_back("stop");
+}
+
+void
+reset_child()
+{
+    child_log.push_back("reset");
+}
+
+bool
+is_exit_normal(int status)
+{
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+// Handlers run in phase order regardless of registration order, prefork on
+// both sides of the fork, parent/child callbacks on their own side only.
+TEST(ForkRegistry, PhasesRunInDeclaredOrder)
+{
+    using Datadog::ForkRegistry;
+
+    // Registered out of phase order on purpose
+    ForkRegistry::register_handlers(ForkRegistry::Phase::Restart, { restart_prefork, nullptr, restart_child });
+    ForkRegistry::register_handlers(ForkRegistry::Phase::StopThreads, { stop_prefork, stop_parent, nullptr });
+    ForkRegistry::register_handlers(ForkRegistry::Phase::ResetState, { nullptr, nullptr, reset_child });
+
+    // Duplicate registration must not stack a second set of callbacks
+    ForkRegistry::register_handlers(ForkRegistry::Phase::Restart, { restart_prefork, nullptr, restart_child });
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Child: prefork ran phase-ordered, then the child-side phases
+        bool ok = prefork_log == std::vector<std::string>{ "stop", "restart" } &&
+                  child_log == std::vector<std::string>{ "reset", "restart" } && parent_log.empty();
+        std::exit(ok ? 0 : 1);
+    }
+
+    ASSERT_GT(pid, 0);
+    int status = -1;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(is_exit_normal(status));
+
+    EXPECT_EQ(prefork_log, (std::vector<std::string>{ "stop", "restart" }));
+    EXPECT_EQ(parent_log, (std::vector<std::string>{ "stop" }));
+    EXPECT_TRUE(child_log.empty());
+}
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
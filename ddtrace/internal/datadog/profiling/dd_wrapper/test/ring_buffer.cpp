@@ -0,0 +1,134 @@
+#include "ring_buffer.hpp"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using Datadog::MPSCRingBuffer;
+using Datadog::SPSCRingBuffer;
+
+TEST(RingBuffer, SpscBatchRoundtripAndBackpressure)
+{
+    SPSCRingBuffer<int> ring(6); // rounds up to 8
+    EXPECT_EQ(ring.capacity(), 8U);
+    EXPECT_TRUE(ring.empty());
+
+    size_t shed = 0;
+    ring.set_backpressure_callback([&shed](size_t n) { shed += n; });
+
+    int items[12];
+    for (int i = 0; i < 12; i++) {
+        items[i] = i;
+    }
+    EXPECT_EQ(ring.push_batch(items, 12), 8U);
+    EXPECT_EQ(shed, 4U);
+    EXPECT_FALSE(ring.push(99));
+    EXPECT_EQ(shed, 5U);
+
+    int out[12];
+    EXPECT_EQ(ring.pop_batch(out, 12), 8U);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(out[i], i);
+    }
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.pop_batch(out, 12), 0U);
+}
+
+TEST(RingBuffer, SpscStreamsInOrderAcrossThreads)
+{
+    SPSCRingBuffer<uint64_t> ring(64);
+    constexpr uint64_t num_items = 100000;
+
+    std::thread producer([&ring]() {
+        for (uint64_t i = 0; i < num_items;) {
+            if (ring.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t batch[16];
+    while (expected < num_items) {
+        const size_t popped = ring.pop_batch(batch, 16);
+        for (size_t i = 0; i < popped; i++) {
+            ASSERT_EQ(batch[i], expected++);
+        }
+        if (popped == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBuffer, MpscDeliversEveryItemExactlyOnce)
+{
+    MPSCRingBuffer<uint64_t> ring(128);
+    constexpr unsigned int num_producers = 4;
+    constexpr uint64_t per_producer = 20000;
+
+    std::atomic<bool> done{ false };
+    std::vector<std::thread> producers;
+    for (unsigned int p = 0; p < num_producers; p++) {
+        producers.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < per_producer;) {
+                if (ring.push(p * per_producer + i)) {
+                    i++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> seen(num_producers * per_producer, 0);
+    std::thread consumer([&ring, &done, &seen]() {
+        uint64_t item;
+        for (;;) {
+            if (ring.pop(item)) {
+                seen[item]++;
+            } else if (!done.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            } else {
+                // done is set after the producers join, so everything is
+                // published; drain whatever was in flight when the empty
+                // check above ran
+                while (ring.pop(item)) {
+                    seen[item]++;
+                }
+                break;
+            }
+        }
+    });
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    for (uint64_t count : seen) {
+        ASSERT_EQ(count, 1U);
+    }
+}
+
+TEST(RingBuffer, MpscReportsBackpressureWhenFull)
+{
+    MPSCRingBuffer<int> ring(4);
+    size_t shed = 0;
+    ring.set_backpressure_callback([&shed](size_t n) { shed += n; });
+
+    int items[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    EXPECT_EQ(ring.push_batch(items, 8), 4U);
+    EXPECT_EQ(shed, 4U);
+
+    // Draining makes room again
+    int out[8];
+    EXPECT_EQ(ring.pop_batch(out, 8), 4U);
+    EXPECT_TRUE(ring.push(42));
+}
@@ -0,0 +1,136 @@
+#include "ring_file.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <variant>
+#include <vector>
+
+using Datadog::RingFile;
+
+namespace {
+
+// Mirrors the header/record layout documented in ring_file.hpp
+constexpr size_t header_size = 4096;
+constexpr size_t record_header_size = 16;
+
+std::string
+ring_path(const std::string& base)
+{
+    return base + "." + std::to_string(getpid()) + ".ring";
+}
+
+std::vector<uint8_t>
+slurp(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+uint64_t
+read_u64(const std::vector<uint8_t>& buf, size_t off)
+{
+    uint64_t val;
+    std::memcpy(&val, buf.data() + off, sizeof(val));
+    return val;
+}
+
+// Walks the [tail, head) window the way the reader tool does and returns the
+// payload sizes of the intact records, oldest first
+std::vector<uint64_t>
+record_sizes(const std::string& filename)
+{
+    const auto buf = slurp(filename);
+    const uint64_t capacity = read_u64(buf, 16);
+    const uint64_t head = read_u64(buf, 24);
+    const uint64_t tail = read_u64(buf, 32);
+
+    auto wrap_u64 = [&](uint64_t pos) -> uint64_t {
+        uint8_t tmp[sizeof(uint64_t)];
+        for (size_t i = 0; i < sizeof(uint64_t); i++) {
+            tmp[i] = buf[header_size + ((pos + i) % capacity)];
+        }
+        uint64_t val;
+        std::memcpy(&val, tmp, sizeof(val));
+        return val;
+    };
+
+    std::vector<uint64_t> sizes;
+    uint64_t pos = tail;
+    while (pos + record_header_size <= head) {
+        const uint64_t len = wrap_u64(pos);
+        if (len > capacity || pos + record_header_size + len > head) {
+            break;
+        }
+        sizes.push_back(len);
+        pos += record_header_size + len;
+    }
+    return sizes;
+}
+
+} // namespace
+
+TEST(RingFile, RecordsRoundtripWithWraparound)
+{
+    const std::string base = "/tmp/dd_wrapper_ring_file_test";
+    const std::string filename = ring_path(base);
+    unlink(filename.c_str());
+
+    auto opened = RingFile::open(base, 4096); // one page of data
+    ASSERT_TRUE(std::holds_alternative<std::shared_ptr<RingFile>>(opened));
+    auto ring = std::get<std::shared_ptr<RingFile>>(opened);
+
+    // More bytes than the window holds, so the oldest records are evicted
+    const std::vector<size_t> payload_sizes = { 100, 900, 1500, 700, 2000, 300 };
+    for (const size_t size : payload_sizes) {
+        std::vector<uint8_t> payload(size, static_cast<uint8_t>(size & 0xFF));
+        EXPECT_TRUE(ring->append(payload.data(), payload.size()));
+    }
+
+    // The same eviction arithmetic as the writer: keep the newest records
+    // whose framed sizes fit in the window
+    const auto sizes = record_sizes(filename);
+    const std::vector<uint64_t> expected = { 700, 2000, 300 };
+    EXPECT_EQ(sizes, expected);
+
+    // A record larger than the whole window is refused outright
+    std::vector<uint8_t> oversized(8192, 0);
+    EXPECT_FALSE(ring->append(oversized.data(), oversized.size()));
+    EXPECT_EQ(record_sizes(filename), expected);
+
+    ring.reset();
+    unlink(filename.c_str());
+}
+
+TEST(RingFile, ResumesExistingRing)
+{
+    const std::string base = "/tmp/dd_wrapper_ring_file_resume";
+    const std::string filename = ring_path(base);
+    unlink(filename.c_str());
+
+    {
+        auto opened = RingFile::open(base, 4096);
+        ASSERT_TRUE(std::holds_alternative<std::shared_ptr<RingFile>>(opened));
+        auto ring = std::get<std::shared_ptr<RingFile>>(opened);
+        std::vector<uint8_t> payload(64, 0xAA);
+        EXPECT_TRUE(ring->append(payload.data(), payload.size()));
+    }
+
+    // Re-open within the same process: the record index is rebuilt from the
+    // window, and new appends land after the surviving records
+    auto reopened = RingFile::open(base, 4096);
+    ASSERT_TRUE(std::holds_alternative<std::shared_ptr<RingFile>>(reopened));
+    auto ring = std::get<std::shared_ptr<RingFile>>(reopened);
+    std::vector<uint8_t> payload(32, 0xBB);
+    EXPECT_TRUE(ring->append(payload.data(), payload.size()));
+
+    const std::vector<uint64_t> expected = { 64, 32 };
+    EXPECT_EQ(record_sizes(filename), expected);
+
+    ring.reset();
+    unlink(filename.c_str());
+}
@@ -0,0 +1,70 @@
+#include "telemetry_counters.hpp"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using Datadog::Telemetry::CounterEntry;
+using Datadog::Telemetry::max_counters;
+using Datadog::Telemetry::register_counter;
+using Datadog::Telemetry::snapshot;
+
+static uint64_t
+snapshot_value(const char* name)
+{
+    CounterEntry entries[max_counters];
+    const size_t count = snapshot(entries, max_counters);
+    for (size_t i = 0; i < count; i++) {
+        if (std::string(entries[i].name) == name) {
+            return entries[i].value;
+        }
+    }
+    return UINT64_MAX;
+}
+
+TEST(Telemetry, RegisterIsIdempotentAndCountersAccumulate)
+{
+    auto* counter = register_counter("test.counter");
+    ASSERT_NE(counter, nullptr);
+    EXPECT_EQ(register_counter("test.counter"), counter);
+
+    counter->fetch_add(3, std::memory_order_relaxed);
+    EXPECT_EQ(snapshot_value("test.counter"), 3U);
+}
+
+TEST(Telemetry, ConcurrentIncrementsAreLossless)
+{
+    auto* counter = register_counter("test.concurrent");
+    constexpr unsigned int num_threads = 8;
+    constexpr uint64_t per_thread = 10000;
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.emplace_back([counter]() {
+            for (uint64_t j = 0; j < per_thread; j++) {
+                counter->fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(snapshot_value("test.concurrent"), num_threads * per_thread);
+}
+
+TEST(Telemetry, SlotExhaustionSpillsIntoOverflowCell)
+{
+    // Fill the registry; registrations past capacity all share the spill
+    // cell, which shows up in snapshots under its own name
+    std::atomic<uint64_t>* last = nullptr;
+    for (size_t i = 0; i < max_counters + 8; i++) {
+        last = register_counter("test.filler." + std::to_string(i));
+        ASSERT_NE(last, nullptr);
+    }
+
+    EXPECT_EQ(register_counter("test.one.more"), last);
+    last->fetch_add(1, std::memory_order_relaxed);
+    EXPECT_NE(snapshot_value("telemetry.overflow"), UINT64_MAX);
+}
@@ -2,14 +2,35 @@
 # In ddtrace/settings/profiling.py, this module is imported and the is_available attribute is checked to determine
 # whether the feature is available. If not, then the feature is disabled and all downstream consumption is
 # suppressed.
-is_available = False
-failure_msg = ""
+#
+# The native module statically links the whole libdatadog payload, and merely importing it pays for loading and
+# relocating that payload.  To keep `import ddtrace` cheap when profiling is disabled, the import is deferred until
+# the first attribute access on this module (PEP 562) -- typically the is_available check made when profiling is
+# actually being enabled.
+_loaded = False
 
 
-try:
-    from ._ddup import *  # noqa: F403, F401
+def _load():
+    global _loaded
+    _loaded = True
 
-    is_available = True
+    try:
+        from . import _ddup
 
-except Exception as e:
-    failure_msg = str(e)
+        for _name in dir(_ddup):
+            if not _name.startswith("_"):
+                globals()[_name] = getattr(_ddup, _name)
+
+        globals()["is_available"] = True
+        globals()["failure_msg"] = ""
+    except Exception as e:
+        globals()["is_available"] = False
+        globals()["failure_msg"] = str(e)
+
+
+def __getattr__(name):
+    if not _loaded:
+        _load()
+        if name in globals():
+            return globals()[name]
+    raise AttributeError("module %r has no attribute %r" % (__name__, name))
@@ -1,4 +1,5 @@
 from typing import Dict
+from typing import List
 from typing import Optional
 from typing import Union
 from .._types import StringType
@@ -13,17 +14,23 @@ def config(
     url: Optional[str],
     timeline_enabled: Optional[bool],
     output_filename: Optional[str],
+    output_ringfile: Optional[str],
+    output_ringfile_capacity: Optional[int],
     sample_pool_capacity: Optional[int],
+    helper_thread_niceness: Optional[int],
+    helper_thread_cpu_affinity: Optional[List[int]],
     enable_code_provenance: Optional[bool],
 ) -> None: ...
 def start() -> None: ...
 def upload() -> None: ...
+def counter_snapshot() -> Dict[str, int]: ...
 
 class SampleHandle:
     def push_cputime(self, value: int, count: int) -> None: ...
     def push_walltime(self, value: int, count: int) -> None: ...
     def push_acquire(self, value: int, count: int) -> None: ...
     def push_release(self, value: int, count: int) -> None: ...
+    def push_gil_wait(self, value: int, count: int) -> None: ...
     def push_alloc(self, value: int, count: int) -> None: ...
     def push_heap(self, value: int) -> None: ...
     def push_lock_name(self, lock_name: StringType) -> None: ...
@@ -36,3 +43,21 @@ class SampleHandle:
     def push_span(self, span: Optional[Span]) -> None: ...
     def push_monotonic_ns(self, monotonic_ns: int) -> None: ...
     def flush_sample(self) -> None: ...
+
+class LockEventBatch:
+    def __init__(self, capacity: int = ..., max_nframes: int = ...) -> None: ...
+    def add_lock_event(
+        self,
+        lock_name: StringType,
+        acquire_time: int,
+        release_time: int,
+        monotonic_ns: int,
+        thread_id: Optional[int],
+        thread_native_id: Optional[int],
+        thread_name: StringType,
+        task_id: Optional[int],
+        task_name: StringType,
+        span: Optional[Span],
+        frames: List,
+    ) -> None: ...
+    def flush(self) -> None: ...
@@ -3,16 +3,22 @@
 
 import sysconfig
 from typing import Dict
+from typing import List
 from typing import Optional
 from typing import Union
 
 from cpython.unicode cimport PyUnicode_AsUTF8AndSize
+from libc.stdlib cimport free
+from libc.stdlib cimport malloc
+from libc.string cimport memset
 from libcpp.map cimport map
 from libcpp.unordered_map cimport unordered_map
 from libcpp.utility cimport pair
+from libcpp.vector cimport vector
 
 import ddtrace
 import platform
+import weakref
 from .._types import StringType
 from ..util import sanitize_string
 from ddtrace.internal.constants import DEFAULT_SERVICE_NAME
@@ -31,6 +37,7 @@ cdef extern from "stdint.h":
 
 cdef extern from "<string_view>" namespace "std" nogil:
     cdef cppclass string_view:
+        string_view()
         string_view(const char* s, size_t count)
 
 cdef extern from "sample.hpp" namespace "Datadog":
@@ -48,7 +55,10 @@ cdef extern from "ddup_interface.hpp":
     void ddup_config_max_nframes(int max_nframes)
     void ddup_config_timeline(bint enable)
     void ddup_config_output_filename(string_view output_filename)
+    void ddup_config_output_ringfile(string_view filename, uint64_t capacity)
     void ddup_config_sample_pool_capacity(uint64_t sample_pool_capacity)
+    void ddup_config_helper_thread_niceness(int niceness)
+    void ddup_config_helper_thread_cpu_affinity(const int* cpus, size_t ncpus)
 
     void ddup_config_user_tag(string_view key, string_view val)
     void ddup_config_sample_type(unsigned int type)
@@ -66,6 +76,7 @@ cdef extern from "ddup_interface.hpp":
     void ddup_push_release(Sample *sample, int64_t release_time, int64_t count)
     void ddup_push_alloc(Sample *sample, int64_t size, int64_t count)
     void ddup_push_heap(Sample *sample, int64_t size)
+    void ddup_push_gil_wait(Sample *sample, int64_t wait_time, int64_t count)
     void ddup_push_lock_name(Sample *sample, string_view lock_name)
     void ddup_push_threadinfo(Sample *sample, int64_t thread_id, int64_t thread_native_id, string_view thread_name)
     void ddup_push_task_id(Sample *sample, int64_t task_id)
@@ -80,6 +91,39 @@ cdef extern from "ddup_interface.hpp":
     void ddup_flush_sample(Sample *sample)
     void ddup_drop_sample(Sample *sample)
 
+    # Partial declarations: the full structs live in ddup_interface.hpp and
+    # zero/empty fields are simply not pushed, so only the fields the batch
+    # path fills need to be visible here
+    ctypedef struct ddup_FrameSpec:
+        string_view name
+        string_view filename
+        uint64_t address
+        int64_t line
+
+    ctypedef struct ddup_SampleSpec:
+        int64_t count
+        int64_t thread_id
+        int64_t thread_native_id
+        string_view thread_name
+        int64_t task_id
+        string_view task_name
+        uint64_t span_id
+        uint64_t local_root_span_id
+        string_view trace_type
+        string_view lock_name
+        int64_t lock_acquire_time
+        int64_t lock_release_time
+        int64_t monotonic_ns
+        const ddup_FrameSpec* frames
+        size_t nframes
+
+    void ddup_push_batch(const ddup_SampleSpec* specs, size_t nspecs)
+
+    ctypedef struct ddup_CounterEntry:
+        const char* name
+        uint64_t value
+    size_t ddup_counter_snapshot(ddup_CounterEntry* entries, size_t max_entries)
+
 cdef extern from "code_provenance_interface.hpp":
     void code_provenance_enable(bint enable)
     void code_provenance_set_runtime_version(string_view runtime_version)
@@ -342,8 +386,13 @@ def config(
         url: StringType = None,
         timeline_enabled: Optional[bool] = None,
         output_filename: StringType = None,
+        output_ringfile: StringType = None,
+        output_ringfile_capacity: Optional[int] = None,
         sample_pool_capacity: Optional[int] = None,
+        helper_thread_niceness: Optional[int] = None,
+        helper_thread_cpu_affinity: Optional[List[int]] = None,
         enable_code_provenance: bool = None) -> None:
+    cdef vector[int] helper_cpus
 
     # Try to provide a ddtrace-specific default service if one is not given
     service = service or DEFAULT_SERVICE_NAME
@@ -358,6 +407,14 @@ def config(
         call_func_with_str(ddup_config_url, url)
     if output_filename:
         call_func_with_str(ddup_config_output_filename, output_filename)
+    if output_ringfile:
+        # Flight-recorder mode: profiles land in a fixed-size mapped ring file
+        # instead of being uploaded (read back with profiling.ring_reader)
+        ringfile_bytes = output_ringfile if isinstance(output_ringfile, bytes) else output_ringfile.encode("utf-8")
+        ddup_config_output_ringfile(
+            string_view(<const char*>ringfile_bytes, len(ringfile_bytes)),
+            clamp_to_uint64_unsigned(output_ringfile_capacity) if output_ringfile_capacity else 0,
+        )
 
     # Inherited
     call_func_with_str(ddup_config_runtime, platform.python_implementation())
@@ -376,6 +433,13 @@ def config(
     if sample_pool_capacity:
         ddup_config_sample_pool_capacity(clamp_to_uint64_unsigned(sample_pool_capacity))
 
+    if helper_thread_niceness is not None:
+        ddup_config_helper_thread_niceness(helper_thread_niceness)
+    if helper_thread_cpu_affinity:
+        for cpu in helper_thread_cpu_affinity:
+            helper_cpus.push_back(cpu)
+        ddup_config_helper_thread_cpu_affinity(helper_cpus.data(), helper_cpus.size())
+
     if enable_code_provenance:
         code_provenance_enable(enable_code_provenance)
         call_func_with_str(code_provenance_set_runtime_version, platform.python_version())
@@ -388,7 +452,19 @@ def start() -> None:
     ddup_start()
 
 
+def counter_snapshot() -> Dict[str, int]:
+    # One call snapshots every counter registered in the shared native
+    # telemetry registry (sample pool pressure, upload drops, ...)
+    cdef ddup_CounterEntry entries[64]
+    cdef size_t count = ddup_counter_snapshot(entries, 64)
+    return {entries[i].name.decode("utf-8"): entries[i].value for i in range(count)}
+
+
 def upload() -> None:
+    # Drain any batched events first so they land in this profile window
+    for batch in list(_live_batches):
+        batch.flush()
+
     call_func_with_str(ddup_set_runtime_id, get_runtime_id())
 
     processor = ddtrace.tracer._endpoint_call_counter_span_processor
@@ -428,6 +504,10 @@ cdef class SampleHandle:
         if self.ptr is not NULL:
             ddup_push_release(self.ptr, clamp_to_int64_unsigned(value), clamp_to_int64_unsigned(count))
 
+    def push_gil_wait(self, value: int, count: int) -> None:
+        if self.ptr is not NULL:
+            ddup_push_gil_wait(self.ptr, clamp_to_int64_unsigned(value), clamp_to_int64_unsigned(count))
+
     def push_alloc(self, value: int, count: int) -> None:
         if self.ptr is not NULL:
             ddup_push_alloc(self.ptr, clamp_to_int64_unsigned(value), clamp_to_int64_unsigned(count))
@@ -507,3 +587,137 @@ cdef class SampleHandle:
             ddup_flush_sample(self.ptr)
             ddup_drop_sample(self.ptr)
             self.ptr = NULL
+
+
+# Live event batches; drained before each upload so batched events always land
+# in the profile window they were recorded in.  Weak references, so a collector
+# dropping its batch unregisters it automatically.
+_live_batches = weakref.WeakSet()
+
+
+cdef class LockEventBatch:
+    """Accumulator for lock-profiler events.
+
+    The lock collector records one sample per sampled acquire/release, and with
+    SampleHandle each sample pays a full borrow/push/flush round trip across the
+    native boundary.  This class instead stores compact event records (times,
+    ids, and views into the event's strings) in a preallocated array and crosses
+    the boundary once per drain via ddup_push_batch.  The Python strings backing
+    the views are kept alive in a reference list until the drain, since the
+    native side only reads the views at push time.
+
+    All methods must be called with the GIL held (any Python-level call
+    qualifies); the batch performs no locking of its own.
+    """
+    cdef ddup_SampleSpec* specs
+    cdef ddup_FrameSpec* frame_pool
+    cdef size_t spec_capacity
+    cdef size_t frame_capacity
+    cdef size_t max_nframes
+    cdef size_t nspecs
+    cdef size_t nframes_used
+    cdef list refs
+    cdef object __weakref__
+
+    def __cinit__(self, capacity: int = 64, max_nframes: int = 64):
+        self.spec_capacity = clamp_to_uint64_unsigned(capacity) or 64
+        self.max_nframes = clamp_to_uint64_unsigned(max_nframes) or 64
+        self.frame_capacity = self.spec_capacity * self.max_nframes
+        self.specs = <ddup_SampleSpec*>malloc(self.spec_capacity * sizeof(ddup_SampleSpec))
+        self.frame_pool = <ddup_FrameSpec*>malloc(self.frame_capacity * sizeof(ddup_FrameSpec))
+        if self.specs == NULL or self.frame_pool == NULL:
+            raise MemoryError()
+        self.nspecs = 0
+        self.nframes_used = 0
+        self.refs = []
+        _live_batches.add(self)
+
+    def __dealloc__(self):
+        free(self.specs)
+        free(self.frame_pool)
+
+    cdef string_view _sv(self, s):
+        # Returns a view into the string's utf-8 buffer and keeps the owning
+        # object alive until the next drain; empty view when unavailable
+        cdef const char* utf8_data
+        cdef Py_ssize_t utf8_size
+        if not s:
+            return string_view()
+        if isinstance(s, bytes):
+            self.refs.append(s)
+            return string_view(<const char*>s, len(s))
+        utf8_data = PyUnicode_AsUTF8AndSize(s, &utf8_size)
+        if utf8_data == NULL:
+            return string_view()
+        self.refs.append(s)
+        return string_view(utf8_data, utf8_size)
+
+    def add_lock_event(
+        self,
+        lock_name: StringType,
+        acquire_time: int,
+        release_time: int,
+        monotonic_ns: int,
+        thread_id: Optional[int],
+        thread_native_id: Optional[int],
+        thread_name: StringType,
+        task_id: Optional[int],
+        task_name: StringType,
+        span: Optional[Span],
+        frames,
+    ) -> None:
+        if self.nspecs >= self.spec_capacity:
+            self.flush()
+
+        cdef ddup_SampleSpec* spec = &self.specs[self.nspecs]
+        memset(spec, 0, sizeof(ddup_SampleSpec))
+        spec.count = 1
+        spec.lock_name = self._sv(lock_name)
+        if acquire_time:
+            spec.lock_acquire_time = clamp_to_int64_unsigned(acquire_time)
+        if release_time:
+            spec.lock_release_time = clamp_to_int64_unsigned(release_time)
+        spec.monotonic_ns = clamp_to_int64_unsigned(monotonic_ns)
+        if thread_id is not None:
+            spec.thread_id = clamp_to_int64_unsigned(thread_id)
+        if thread_native_id is not None:
+            spec.thread_native_id = clamp_to_int64_unsigned(thread_native_id)
+        spec.thread_name = self._sv(thread_name)
+        if task_id is not None:
+            spec.task_id = clamp_to_int64_unsigned(task_id)
+        if task_name is not None:
+            spec.task_name = self._sv(task_name)
+        # Mirrors SampleHandle.push_span
+        if span is not None and span.span_id:
+            spec.span_id = clamp_to_uint64_unsigned(span.span_id)
+            if span._local_root:
+                if span._local_root.span_id:
+                    spec.local_root_span_id = clamp_to_uint64_unsigned(span._local_root.span_id)
+                if span._local_root.span_type:
+                    spec.trace_type = self._sv(span._local_root.span_type)
+
+        cdef size_t start = self.nframes_used
+        cdef size_t nframes = 0
+        for frame in frames:
+            if self.nframes_used >= self.frame_capacity or nframes >= self.max_nframes:
+                break
+            # Customers report the strings may be unexpected objects, so sanitize
+            # like SampleHandle.push_frame does
+            self.frame_pool[self.nframes_used].name = self._sv(sanitize_string(frame.function_name))
+            self.frame_pool[self.nframes_used].filename = self._sv(sanitize_string(frame.file_name))
+            self.frame_pool[self.nframes_used].address = 0
+            self.frame_pool[self.nframes_used].line = clamp_to_int64_unsigned(frame.lineno)
+            self.nframes_used += 1
+            nframes += 1
+        spec.frames = &self.frame_pool[start]
+        spec.nframes = nframes
+        self.nspecs += 1
+
+    def flush(self) -> None:
+        # Runs under the GIL on purpose: a concurrent add_lock_event must not
+        # observe the arrays mid-drain
+        if self.nspecs > 0:
+            ddup_push_batch(self.specs, self.nspecs)
+        self.nspecs = 0
+        self.nframes_used = 0
+        del self.refs[:]
@@ -0,0 +1,103 @@
+"""Reader for the profiling ring-file export format.
+
+The native uploader's flight-recorder mode (``ddup_config_output_ringfile``)
+appends sealed pprof payloads to a fixed-size memory-mapped file as
+length-prefixed records with wraparound; see ``dd_wrapper/include/ring_file.hpp``
+for the on-disk layout.  This module extracts whatever intact records the
+window currently holds, either as a library (:func:`read_records`) or from the
+command line::
+
+    python -m ddtrace.internal.datadog.profiling.ring_reader capture.1234.ring -o out/
+
+which writes one ``<timestamp_ns>.pprof`` per record.
+
+The writer may still be appending while we read: records are copied out and
+then validated against a re-read of the tail cursor, so a record overwritten
+mid-copy is discarded rather than returned torn.
+"""
+
+import os
+import struct
+import typing as t
+
+
+MAGIC = b"DDPROFRG"
+VERSION = 1
+HEADER_SIZE = 4096
+RECORD_HEADER_SIZE = 16  # u64 payload length + u64 wall-clock timestamp (ns)
+
+
+class Record(t.NamedTuple):
+    timestamp_ns: int
+    payload: bytes
+
+
+def _read_cursors(buf: bytes) -> t.Tuple[int, int]:
+    head, tail = struct.unpack_from("<QQ", buf, 24)
+    return head, tail
+
+
+def read_records(path: str) -> t.List[Record]:
+    """Return the intact records currently in the ring, oldest first."""
+    with open(path, "rb") as f:
+        buf = f.read()
+
+    if len(buf) < HEADER_SIZE or buf[:8] != MAGIC:
+        raise ValueError("%s is not a profiling ring file" % path)
+    version, header_size = struct.unpack_from("<II", buf, 8)
+    if version != VERSION or header_size != HEADER_SIZE:
+        raise ValueError("%s: unsupported ring file version %d" % (path, version))
+    (capacity,) = struct.unpack_from("<Q", buf, 16)
+    if len(buf) < HEADER_SIZE + capacity:
+        raise ValueError("%s: truncated ring file" % path)
+
+    data = buf[HEADER_SIZE : HEADER_SIZE + capacity]
+
+    def wrap_read(pos: int, length: int) -> bytes:
+        start = pos % capacity
+        first = min(length, capacity - start)
+        chunk = data[start : start + first]
+        if first < length:
+            chunk += data[: length - first]
+        return chunk
+
+    head, tail = _read_cursors(buf)
+    records = []
+    pos = tail
+    while pos + RECORD_HEADER_SIZE <= head:
+        (length,) = struct.unpack("<Q", wrap_read(pos, 8))
+        if length > capacity or pos + RECORD_HEADER_SIZE + length > head:
+            break  # torn tail record from an unclean shutdown
+        (timestamp_ns,) = struct.unpack("<Q", wrap_read(pos + 8, 8))
+        payload = wrap_read(pos + RECORD_HEADER_SIZE, length)
+        records.append((pos, Record(timestamp_ns, payload)))
+        pos += RECORD_HEADER_SIZE + length
+
+    # The writer may have advanced over the oldest records while we were
+    # copying; anything now behind the tail is suspect, so drop it
+    with open(path, "rb") as f:
+        live_tail = struct.unpack("<Q", f.read(HEADER_SIZE)[32:40])[0] if os.path.getsize(path) >= HEADER_SIZE else tail
+    return [record for start, record in records if start >= live_tail]
+
+
+def main(argv: t.Optional[t.List[str]] = None) -> int:
+    import argparse
+
+    parser = argparse.ArgumentParser(description="Extract pprof payloads from a profiling ring file")
+    parser.add_argument("ring_file", help="path to the ring file (as written, including the pid suffix)")
+    parser.add_argument("-o", "--output-dir", default=".", help="directory to write <timestamp_ns>.pprof files into")
+    args = parser.parse_args(argv)
+
+    records = read_records(args.ring_file)
+    os.makedirs(args.output_dir, exist_ok=True)
+    for record in records:
+        out_path = os.path.join(args.output_dir, "%d.pprof" % record.timestamp_ns)
+        with open(out_path, "wb") as out:
+            out.write(record.payload)
+        print(out_path)
+    print("%d record(s) extracted" % len(records))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
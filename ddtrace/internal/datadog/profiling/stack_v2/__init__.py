@@ -1,25 +1,45 @@
 # See ../ddup/__init__.py for some discussion on the is_available attribute.
 # This component is also loaded in ddtrace/settings/profiling.py
-is_available = False
-failure_msg = ""
+#
+# As with ddup, the native module is imported lazily on the first attribute access so that merely importing this
+# package does not load the libdatadog payload when the feature is disabled.
+_loaded = False
 
 
-try:
-    import typing
+def _load():
+    global _loaded
+    _loaded = True
 
-    from ddtrace._trace import context
-    from ddtrace._trace import span as ddspan
+    try:
+        import typing
 
-    from ._stack_v2 import *  # noqa: F403, F401
+        from ddtrace._trace import context
+        from ddtrace._trace import span as ddspan
 
-    is_available = True
+        from . import _stack_v2
 
-    def link_span(span: typing.Optional[typing.Union[context.Context, ddspan.Span]]):
-        if isinstance(span, ddspan.Span):
-            span_id = span.span_id
-            local_root_span_id = span._local_root.span_id
-            local_root_span_type = span._local_root.span_type
-            _stack_v2.link_span(span_id, local_root_span_id, local_root_span_type)  # type: ignore # noqa: F405
+        for _name in dir(_stack_v2):
+            if not _name.startswith("_"):
+                globals()[_name] = getattr(_stack_v2, _name)
 
-except Exception as e:
-    failure_msg = str(e)
+        def link_span(span: typing.Optional[typing.Union[context.Context, ddspan.Span]]):
+            if isinstance(span, ddspan.Span):
+                span_id = span.span_id
+                local_root_span_id = span._local_root.span_id
+                local_root_span_type = span._local_root.span_type
+                _stack_v2.link_span(span_id, local_root_span_id, local_root_span_type)
+
+        globals()["link_span"] = link_span
+        globals()["is_available"] = True
+        globals()["failure_msg"] = ""
+    except Exception as e:
+        globals()["is_available"] = False
+        globals()["failure_msg"] = str(e)
+
+
+def __getattr__(name):
+    if not _loaded:
+        _load()
+        if name in globals():
+            return globals()[name]
+    raise AttributeError("module %r has no attribute %r" % (__name__, name))
@@ -8,3 +8,40 @@ constexpr double g_default_sampling_period_s = g_default_sampling_period_us / 1e
 
 // Echion maintains a cache of frames--the size of this cache is specified up-front.
 constexpr unsigned int g_default_echion_frame_cache_size = 1024;
+
+// A thread whose rendered stack has been identical for this many consecutive sampled passes is
+// considered idle, and the sampler skips alternate unwinds for it (deferring the wall time).
+constexpr unsigned int g_stack_stable_streak = 2;
+
+// Bound on the stack-stability bookkeeping; thread ids are recycled by the OS, so rather than
+// plumbing thread-exit notifications into the renderer the table is simply dropped (and streaks
+// rebuilt) if it ever grows past this.
+constexpr unsigned int g_stack_stability_max_entries = 512;
+
+// Capacity (in samples) of the handoff ring between the sampling thread and the flush thread.
+// Must be a power of two.  A pass produces one sample per thread/task, so this covers several
+// passes of headroom; when the ring is full the sampler falls back to flushing inline.
+constexpr unsigned int g_flush_queue_capacity = 256;
+
+// How long the flush thread sleeps when the handoff ring is empty.  Flush latency is invisible
+// next to the upload period, so this only trades idle wakeups against ring occupancy.
+constexpr unsigned int g_flush_queue_idle_sleep_us = 1000;
+
+// Idle governor: after this many consecutive passes in which no thread's stack changed, the
+// sampler starts backing its wakeup interval off exponentially...
+constexpr unsigned int g_idle_backoff_threshold_passes = 10;
+// ...doubling per idle pass up to interval << max_shift (16x, so 160 ms at the default 100 Hz).
+// Activity or a thread registration snaps the interval back instantly.
+constexpr unsigned int g_idle_backoff_max_shift = 4;
+
+// Span-aware sampling: cap on how many passes an unlinked thread can go between unwinds, no
+// matter how small the configured fraction is.  Wall time is banked while a thread is skipped,
+// so the cap bounds attribution staleness (and the size of a single repaid sample) rather than
+// correctness.
+constexpr unsigned int g_span_aware_max_unlinked_period = 16;
+
+// Failsafe bound on the task parent-link map.  Completed tasks are pruned by a done-callback on
+// the Python side, but if that hook is ever bypassed the map is cleared rather than allowed to
+// grow without bound; losing parent links degrades task nesting in the profile, leaking does not
+// degrade anything until it OOMs the process.
+constexpr unsigned int g_task_link_map_max = 16384;
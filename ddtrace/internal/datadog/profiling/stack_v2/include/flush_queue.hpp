@@ -0,0 +1,63 @@
+#pragma once
+
+#include "constants.hpp"
+
+#include "dd_wrapper/include/ddup_interface.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace Datadog {
+
+// SPSC handoff between the sampling thread and a low-priority flush thread.  A rendered Sample
+// is self-contained--every string is copied into the sample's arena as it is pushed--so the
+// completed Sample* is the handoff unit: the sampling thread only pays for the arena writes,
+// while interning, aggregation, and everything else behind flush_sample rides the consumer
+// thread (and whatever idle core the scheduler finds for it).  This bounds the sampler-thread
+// cost of a pass, which is what the interval-accuracy machinery in the sampler assumes.
+//
+// The ring is a fixed power-of-two array with head owned by the producer and tail by the
+// consumer; no locks anywhere.  When the ring is full the producer flushes inline, so a slow
+// consumer degrades to the old synchronous behavior rather than dropping data.
+class FlushQueue
+{
+  public:
+    static FlushQueue& get()
+    {
+        static FlushQueue instance;
+        return instance;
+    }
+
+    FlushQueue(FlushQueue const&) = delete;
+    FlushQueue& operator=(FlushQueue const&) = delete;
+
+    // Hand a rendered sample to the flush thread.  Returns false (and takes no ownership) when
+    // the ring is full or the consumer is not running; the caller must then flush inline.
+    // Producer side only (the sampling thread).
+    bool push(Sample* sample);
+
+    // Launch the consumer thread; idempotent.  The thread is detached and runs for the life of
+    // the process, the same lifecycle the sampling thread has.
+    void start();
+
+    // The consumer thread does not survive a fork; reset the ring so the child relaunches it
+    // on the next start().  Samples in flight at fork time are leaked in the child, matching
+    // the note in SampleManager::start_sample about forking with samples checked out.
+    static void postfork_child();
+
+  private:
+    static_assert((g_flush_queue_capacity & (g_flush_queue_capacity - 1)) == 0,
+                  "flush queue capacity must be a power of two");
+
+    std::array<Sample*, g_flush_queue_capacity> ring{};
+    alignas(64) std::atomic<size_t> head{ 0 }; // next write; producer only
+    alignas(64) std::atomic<size_t> tail{ 0 }; // next read; consumer only
+    std::atomic<bool> running{ false };
+
+    void consumer_loop();
+
+    FlushQueue() = default;
+    ~FlushQueue() = default;
+};
+
+} // namespace Datadog
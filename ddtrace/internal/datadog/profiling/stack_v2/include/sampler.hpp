@@ -3,6 +3,8 @@
 #include "stack_renderer.hpp"
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace Datadog {
 
@@ -25,6 +27,42 @@ class Sampler
     // Parameters
     uint64_t echion_frame_cache_size = g_default_echion_frame_cache_size;
 
+    // Set once one_time_setup has run; echion's frame cache is sized at init and cannot be
+    // resized afterwards, so configuration attempts after this point are ignored
+    std::atomic<bool> setup_complete{ false };
+
+    // Achieved-rate accounting.  A sampling pass that takes longer than the
+    // interval silently lowers the effective sample rate (the sleep just
+    // vanishes); these counters make that visible from Python.
+    std::atomic<uint64_t> sampling_passes{ 0 };
+    std::atomic<uint64_t> overrun_passes{ 0 };
+    std::atomic<uint64_t> last_pass_us{ 0 };
+    std::atomic<uint64_t> max_pass_us{ 0 };
+    // Cumulative scheduler-wakeup lateness; the closed-loop correction in
+    // sampling_thread keeps it from compounding, this makes it reportable
+    std::atomic<uint64_t> total_drift_us{ 0 };
+
+    // Exception sampling.  When enabled, each pass also inspects the visited thread's
+    // propagating-exception state (tstate->exc_info) and attributes the exception type to the
+    // thread's sample; off by default since the exported values only make sense when the
+    // Exception sample type is configured on the dd_wrapper side.
+    std::atomic<bool> exception_sampling{ false };
+
+    // Span-aware sampling.  When non-zero, threads with no span link are unwound only every
+    // Nth pass (staggered by thread id), with the skipped passes' wall time banked and repaid
+    // on the next unwind; span-linked threads are sampled at full rate.  Zero disables the
+    // policy and every thread is sampled every pass.
+    std::atomic<uint32_t> span_aware_unlinked_period{ 0 };
+
+    // Loop wakeup.  The sampling thread sleeps on wake_cv for both the nominal timed wait and
+    // the idle governor's backed-off wait.  stop() and set_interval() notify it so shutdown
+    // and interval changes act within microseconds instead of waiting out the current sleep,
+    // and register_thread (the earliest sign of new activity) sets the hint and pokes it so
+    // the full rate is restored without waiting out a long backed-off sleep.
+    std::atomic<bool> activity_hint{ false };
+    std::mutex wake_cv_mtx;
+    std::condition_variable wake_cv;
+
     // Helper function; implementation of the echion sampling thread
     void sampling_thread(const uint64_t seq_num);
 
@@ -46,12 +84,49 @@ class Sampler
                       PyObject* _asyncio_scheduled_tasks,
                       PyObject* _asyncio_eager_tasks);
     void link_tasks(PyObject* parent, PyObject* child);
+    void unlink_tasks(PyObject* child);
+
+    // Greenlet support, same shape as the asyncio tracking above: the Python-side greenlet
+    // trace hook reports switches, echion keeps the per-greenlet bookkeeping, and the thread
+    // walk unwinds suspended greenlets from their saved frames so their wall time is
+    // attributed to the greenlet (with task-style labels) instead of vanishing into the hub.
+    // The frame is NULL for a running greenlet, which is unwound from the live thread stack.
+    void track_greenlet(uintptr_t greenlet_id, const char* name, PyObject* frame);
+    void untrack_greenlet(uintptr_t greenlet_id);
+    void link_greenlets(uintptr_t parent, uintptr_t child);
+    void update_greenlet_frame(uintptr_t greenlet_id, PyObject* frame);
 
     // The Python side dynamically adjusts the sampling rate based on overhead, so we need to be able to update our
     // own intervals accordingly.  Rather than a preemptive measure, we assume the rate is ~fairly stable and just
     // update the next rate with the latest interval. This is not perfect because the adjustment is based on
     // self-time, and we're not currently accounting for the echion self-time.
     void set_interval(double new_interval);
+
+    // Toggle pass-time exception sampling; safe at any point, the sampling thread reads the
+    // flag per pass
+    void set_exception_sampling(bool enable);
+
+    // Span-aware sampling policy: sample span-linked threads at full rate and unlinked ones
+    // at roughly `unlinked_fraction` of it.  A fraction outside (0, 1) disables the policy.
+    // Safe at any point, the sampling thread reads the derived period per pass.
+    void set_span_aware_sampling(double unlinked_fraction);
+
+    // Frame cache capacity; only effective before the first start() (echion sizes the cache
+    // once, at init).  Requests after setup are ignored.
+    void set_frame_cache_size(uint64_t size);
+    uint64_t get_frame_cache_size() const { return echion_frame_cache_size; }
+
+    // Snapshot of the achieved-rate counters; all loads are relaxed, the
+    // values are diagnostics, not synchronization
+    struct SamplingStats
+    {
+        uint64_t passes;
+        uint64_t overruns;
+        uint64_t last_pass_us;
+        uint64_t max_pass_us;
+        uint64_t drift_us;
+    };
+    SamplingStats get_sampling_stats() const;
 };
 
 } // namespace Datadog
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "python_headers.hpp"
@@ -24,17 +26,78 @@ struct ThreadState
     // process tasks, it needs to place thread-level information in the Sample.
     uintptr_t id = 0;
     unsigned long native_id = 0;
-    std::string name;
+    uint64_t name_id = 0; // interned handle for the thread name, from the renderer's threadinfo cache
     microsecond_t wall_time_ns = 0;
     microsecond_t cpu_time_ns = 0;
     int64_t now_time_ns = 0;
 };
 
+// Frame-identity reuse counters, maintained by the renderer's memoized utf-8 validation.  The
+// memo is keyed by the string pointers handed out by echion's frame cache, so its hit rate is a
+// direct proxy for how often the cache serves a repeat frame: a thrashing cache hands out fresh
+// pointers and shows up here as a miss rate.  Lookups are counted per string (two per frame).
+uint64_t renderer_memo_hits();
+uint64_t renderer_memo_lookups();
+
 class StackRenderer : public RendererInterface
 {
     Sample* sample = nullptr;
     ThreadState thread_state = {};
 
+    // Per-thread cached threadinfo labels.  A thread's id, native id, and name are stable for
+    // its lifetime, so the name is interned in the profile's string table once and every
+    // sample pushes the handle instead of re-copying the string.  Entries are validated
+    // against the identity observed on each sample and rebuilt on mismatch (a thread
+    // re-registered under a new name); the renderer never sees thread teardown, so a stale
+    // entry for a dead thread is simply never consulted again.  Sampling-thread only.
+    struct ThreadInfoCache
+    {
+        unsigned long native_id = 0;
+        std::string name;     // kept only to validate the cache against the observed name
+        uint64_t name_id = 0; // interned handle pushed per sample
+    };
+    std::unordered_map<uintptr_t, ThreadInfoCache> threadinfo_cache;
+
+    // Returns the interned name handle for the thread, building or rebuilding the cache
+    // entry when the observed identity does not match
+    uint64_t cached_thread_name_id(uintptr_t thread_id, unsigned long native_id, std::string_view name);
+
+    // Stack-stability tracking.  Idle threads render the same stack pass after pass; the
+    // sampler uses these fingerprints to skip alternate unwinds for such threads (crediting
+    // the skipped wall time on the next sample).  The fingerprint is a hash of the frame
+    // string pointers and lines as they stream through render_python_frame--the strings come
+    // out of echion's frame cache, so pointer identity is a faithful frame identity.  All of
+    // this state is touched only from the sampling thread, so no synchronization is needed.
+    struct StackStability
+    {
+        uint64_t hash = 0;
+        uint32_t streak = 0; // consecutive sampled passes with an identical stack
+    };
+    std::unordered_map<uintptr_t, StackStability> stack_stability;
+    uint64_t pass_stack_hash = 0;
+    uintptr_t pass_thread_id = 0;
+    bool pass_thread_open = false;
+
+    // How many threads' stacks changed in the current/previous pass; the sampler's idle
+    // governor reads the previous-pass count after finish_pass().  Sampling-thread only.
+    uint32_t pass_changed_threads = 0;
+    uint32_t prev_pass_changed_threads = 0;
+
+    // Exception type propagating on the thread about to be rendered, set by the sampler just
+    // before the unwind and consumed (then cleared) by render_thread_begin; nullptr when no
+    // exception is in flight.  Points at a type object's tp_name, so no ownership or copying
+    // is involved.  Sampling-thread only.
+    const char* pending_exception_type = nullptr;
+
+    // Timestamp for every sample of the current pass, read once in begin_pass().  Threads in
+    // one pass are visited microseconds apart, so a single read costs nothing in accuracy and
+    // turns N clock_gettime syscalls per pass into one.  Sampling-thread only.
+    int64_t pass_time_ns = 0;
+
+    // Fold the just-rendered thread's fingerprint into stack_stability; called when the next
+    // thread begins and, via finish_pass(), for the last thread of a pass
+    void finalize_thread_fingerprint();
+
     virtual void render_message(std::string_view msg) override;
     virtual void render_thread_begin(PyThreadState* tstate,
                                      std::string_view name,
@@ -48,6 +111,27 @@ class StackRenderer : public RendererInterface
     virtual void render_cpu_time(uint64_t cpu_time_us) override;
     virtual void render_stack_end() override;
     virtual bool is_valid() override;
+
+  public:
+    // Capture the pass timestamp; the sampler calls this before walking the interpreters so
+    // every sample in the pass shares one clock read
+    void begin_pass();
+
+    // Stage the propagating exception's type for the thread about to be rendered (nullptr
+    // clears); the next render_thread_begin attaches it to the sample
+    void set_pending_exception(const char* type_name) { pending_exception_type = type_name; }
+
+    // True when the thread's stack was identical across recent sampled passes; the sampler
+    // may then skip this thread's unwind and defer its wall time.  Sampling-thread only.
+    bool is_thread_stack_stable(uintptr_t thread_id) const;
+
+    // Finalize the fingerprint of the last thread visited in a pass; the sampler calls this
+    // after iterating all interpreters
+    void finish_pass();
+
+    // Number of threads whose stack changed in the last completed pass; zero means the whole
+    // process looked idle.  Sampling-thread only.
+    uint32_t last_pass_changed_threads() const { return prev_pass_changed_threads; }
 };
 
 } // namespace Datadog
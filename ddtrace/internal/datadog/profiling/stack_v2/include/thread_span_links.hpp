@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -45,14 +47,48 @@ class ThreadSpanLinks
 
     void link_span(uint64_t thread_id, uint64_t span_id, uint64_t local_root_span_id, std::string span_type);
     const std::optional<Span> get_active_span_from_thread_id(uint64_t thread_id);
+    // Whether the thread has ever been linked to a span.  A presence check on the snapshot
+    // only--no seqlock read, no copies--so the sampling pass can consult it per thread.
+    bool has_span_link(uint64_t thread_id);
     void unlink_span(uint64_t thread_id);
     void reset();
 
     static void postfork_child();
 
   private:
+    // The sampling thread looks up every registered thread once per pass, while the tracer
+    // calls link_span on every span start/finish.  Guarding both sides with one mutex means
+    // span bookkeeping can delay the sampling pass and vice versa, so the read path is
+    // lock-free instead:
+    //   - Each entry is a seqlock.  link_span bumps the sequence to odd, updates the fields
+    //     in place, and bumps it back to even; the reader copies the fields out and retries
+    //     if the sequence was odd or changed underneath it.  The span type lives in a fixed
+    //     inline buffer so a torn read yields garbage bytes (discarded on retry), never a
+    //     dangling pointer the way a concurrently-reallocated std::string would.
+    //   - The map itself is an immutable snapshot published through an atomically-exchanged
+    //     shared_ptr.  Only insert/erase (thread creation/exit, which is rare) copies the
+    //     map; the common link_span path updates the existing entry without republishing.
+    // Writers still serialize on the mutex; readers never touch it.
+    static constexpr size_t span_type_capacity = 128;
+
+    struct SeqlockSpan
+    {
+        std::atomic<uint32_t> seq{ 0 };
+        uint64_t span_id{ 0 };
+        uint64_t local_root_span_id{ 0 };
+        char span_type[span_type_capacity];
+        size_t span_type_len{ 0 };
+    };
+
+    using SpanMap = std::unordered_map<uint64_t, std::shared_ptr<SeqlockSpan>>;
+
+    // Serializes writers (link/unlink/reset) only
     std::mutex mtx;
-    std::unordered_map<uint64_t, std::unique_ptr<Span>> thread_id_to_span;
+    // Current snapshot; accessed with std::atomic_load/std::atomic_store
+    std::shared_ptr<const SpanMap> snapshot;
+
+    // Seqlock write protocol for an existing entry; caller must hold mtx
+    static void write_entry(SeqlockSpan& entry, uint64_t span_id, uint64_t local_root_span_id, const std::string& span_type);
 
     // Private Constructor/Destructor
     ThreadSpanLinks() = default;
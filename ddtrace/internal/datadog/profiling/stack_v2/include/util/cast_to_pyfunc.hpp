@@ -9,3 +9,11 @@ cast_to_pycfunction(PyObject* (*func)(PyObject*, PyObject*, PyObject*))
     // Direct C-style cast
     return (PyCFunction)(func);
 }
+
+// Same contract for METH_FASTCALL entry points
+inline static PyCFunction
+cast_to_pycfunction(PyObject* (*func)(PyObject*, PyObject* const*, Py_ssize_t))
+{
+    // Direct C-style cast
+    return (PyCFunction)(func);
+}
@@ -1,11 +1,49 @@
 #pragma once
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Returns the length of the leading pure-ASCII run of the string.  Function and file names are
+// overwhelmingly plain ASCII, so the validator below skips this prefix in 16-byte vector chunks
+// before falling back to the scalar state machine for anything multibyte.  SSE2 is part of the
+// x86-64 baseline and vmaxvq is baseline AArch64 NEON, so no runtime dispatch is required.
+inline static int
+utf8_ascii_prefix_len(const char* str, int len)
+{
+    int i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+    for (; i + 16 <= len; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        if (_mm_movemask_epi8(chunk) != 0) {
+            break;
+        }
+    }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    for (; i + 16 <= len; i += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(str + i));
+        if (vmaxvq_u8(chunk) > 0x7f) {
+            break;
+        }
+    }
+#endif
+    while (i < len && (unsigned char)str[i] <= 0x7f) {
+        ++i;
+    }
+    return i;
+}
+
 // From https://gist.github.com/ichramm/3ffeaf7ba4f24853e9ecaf176da84566
+// Modified to skip the leading ASCII run with the vectorized scan above; ASCII bytes can neither
+// start nor continue a multibyte sequence, so resuming the state machine at the first non-ASCII
+// byte is equivalent to scanning from the beginning.
 inline static bool
 utf8_check_is_valid(const char* str, int len)
 {
     int n;
-    for (int i = 0; i < len; ++i) {
+    for (int i = utf8_ascii_prefix_len(str, len); i < len; ++i) {
         unsigned char c = (unsigned char)str[i];
         // if (c==0x09 || c==0x0a || c==0x0d || (0x20 <= c && c <= 0x7e) ) n = 0; // is_printable_ascii
         if (0x00 <= c && c <= 0x7f) {
@@ -0,0 +1,65 @@
+#include "flush_queue.hpp"
+
+#include "dd_wrapper/include/helper_threads.hpp"
+#include "dd_wrapper/include/telemetry_counters.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace Datadog;
+
+bool
+FlushQueue::push(Sample* sample)
+{
+    if (!running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= g_flush_queue_capacity) {
+        static auto* queue_full = Telemetry::register_counter("stack_v2.flush_queue_full");
+        queue_full->fetch_add(1, std::memory_order_relaxed);
+        return false; // full; caller flushes inline
+    }
+    ring[h & (g_flush_queue_capacity - 1)] = sample; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+void
+FlushQueue::start()
+{
+    if (running.exchange(true)) {
+        return;
+    }
+    std::thread t(&FlushQueue::consumer_loop, this);
+    t.detach();
+}
+
+void
+FlushQueue::consumer_loop()
+{
+    // Flush latency is invisible next to the upload period; deprioritize this thread so it
+    // yields to application threads and only soaks up idle cycles
+    HelperThreads::apply_attributes("ddprof.flush", 10);
+
+    while (true) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(g_flush_queue_idle_sleep_us));
+            continue;
+        }
+        Sample* sample = ring[t & (g_flush_queue_capacity - 1)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        ddup_flush_sample_v2(sample);
+        ddup_drop_sample(sample);
+        tail.store(t + 1, std::memory_order_release);
+    }
+}
+
+void
+FlushQueue::postfork_child()
+{
+    auto& instance = get();
+    instance.head.store(0, std::memory_order_relaxed);
+    instance.tail.store(0, std::memory_order_relaxed);
+    instance.running.store(false, std::memory_order_relaxed);
+}
@@ -1,32 +1,197 @@
 #include "sampler.hpp"
 
+#include "flush_queue.hpp"
 #include "thread_span_links.hpp"
 
+#include "dd_wrapper/include/fork_registry.hpp"
+#include "dd_wrapper/include/helper_threads.hpp"
+
+#include "echion/greenlets.h"
 #include "echion/interp.h"
 #include "echion/tasks.h"
 #include "echion/threads.h"
 
+#include <algorithm>
+#include <cmath>
 #include <pthread.h>
+#include <unordered_map>
 
 using namespace Datadog;
 
+namespace {
+
+// Type name of the exception currently propagating on the thread, or nullptr when none is.
+// This is the same class of GIL-free inspection echion performs on the frame stack: the
+// thread walk holds echion's thread lock so tstate stays valid, and the worst a racing
+// thread can cause is a missed or spurious attribution for a single pass.  tp_name points
+// into the type object, which outlives the exception instance for any type that can still
+// be propagating.
+const char*
+propagating_exception_name(PyThreadState* tstate)
+{
+    _PyErr_StackItem* exc_info = tstate->exc_info;
+    if (exc_info == nullptr) {
+        return nullptr;
+    }
+    PyObject* exc = exc_info->exc_value;
+    if (exc == nullptr || exc == Py_None) {
+        return nullptr;
+    }
+    return Py_TYPE(exc)->tp_name;
+}
+
+// Essentially every real deployment runs exactly one interpreter, yet each
+// pass goes through for_each_interp's generic iteration with its type-erased
+// callback.  Cache the interpreter pointer from the last pass and dispatch
+// directly when it is still the only one; the validity check is two pointer
+// reads (Head unchanged, no Next), so a second interpreter appearing -- or
+// the cached one going away -- is noticed on the very next pass and falls
+// back to the generic walk, which re-seeds the cache once the runtime is
+// back to a single interpreter.
+PyInterpreterState* single_interp_cache = nullptr;
+
+template<typename Callback>
+void
+for_each_interp_cached(Callback&& cb)
+{
+    PyInterpreterState* cached = single_interp_cache;
+    if (cached != nullptr && PyInterpreterState_Head() == cached && PyInterpreterState_Next(cached) == nullptr) {
+        cb(cached);
+        return;
+    }
+
+    // Cold start, or no longer a single interpreter: take the generic walk
+    // and re-derive the cache from what it actually visits
+    int interp_count = 0;
+    PyInterpreterState* only = nullptr;
+    for_each_interp([&](PyInterpreterState* interp) -> void {
+        interp_count++;
+        only = interp;
+        cb(interp);
+    });
+    single_interp_cache = (interp_count == 1) ? only : nullptr;
+}
+
+} // namespace
+
 void
 Sampler::sampling_thread(const uint64_t seq_num)
 {
+    // Name the thread and apply any configured cpuset/niceness.  Unlike the
+    // flush and upload helpers there is no default niceness here: deprioritizing
+    // the sampler skews the wall-time cadence under load.
+    HelperThreads::apply_attributes("ddprof.sample");
+
     using namespace std::chrono;
     auto sample_time_prev = steady_clock::now();
 
+    // Closed-loop sleep correction.  sleep_until reliably wakes late on busy
+    // systems; track how late (EWMA, 1/8 gain like TCP RTT smoothing) and aim
+    // the next deadline earlier by that much, so the achieved interval
+    // converges on the nominal one instead of sitting above it.
+    int64_t overshoot_ewma_us = 0;
+    auto next_deadline = sample_time_prev;
+    bool have_deadline = false;
+
+    // Idle governor state: consecutive passes with no stack change anywhere, and the current
+    // backoff shift (sleep interval is nominal << shift)
+    unsigned int idle_passes = 0;
+    unsigned int backoff_shift = 0;
+
+    // Wall time owed to threads whose unwind was skipped on the previous pass (see below);
+    // only this thread touches it.  Entries are erased as they are repaid, so the map only
+    // ever holds the currently-skipped threads.
+    std::unordered_map<unsigned long, microsecond_t> deferred_wall_us;
+
+    // Pass ordinal for the span-aware round-robin below; only this thread touches it
+    uint64_t pass_index = 0;
+
     while (seq_num == thread_seq_num.load()) {
+        pass_index++;
         auto sample_time_now = steady_clock::now();
         auto wall_time_us = duration_cast<microseconds>(sample_time_now - sample_time_prev).count();
         sample_time_prev = sample_time_now;
 
-        // Perform the sample
-        for_each_interp([&](PyInterpreterState* interp) -> void {
+        if (have_deadline) {
+            const int64_t overshoot_us =
+              std::max<int64_t>(0, duration_cast<microseconds>(sample_time_now - next_deadline).count());
+            overshoot_ewma_us += (overshoot_us - overshoot_ewma_us) / 8;
+            total_drift_us.fetch_add(static_cast<uint64_t>(overshoot_us), std::memory_order_relaxed);
+        }
+
+        // Perform the sample.  Threads whose rendered stack has been identical for several
+        // passes (idle workers, mostly) are unwound only every other pass: the skipped
+        // pass's wall time is banked and credited when the thread is next sampled, so
+        // wall-time attribution stays exact while the unwind cost for idle threads halves.
+        // Staleness is bounded to one interval--a thread that wakes is sampled again on the
+        // very next pass, since skips are never issued back-to-back.
+        // Span-aware policy: threads that have never carried a span (framework idle threads,
+        // mostly) are unwound only every `unlinked_period`th pass, staggered by thread id so
+        // the unlinked population spreads across passes instead of piling onto one.  The
+        // skipped passes' wall time is banked in deferred_wall_us and repaid in full on the
+        // thread's next unwind, so attribution stays exact rather than statistically
+        // upscaled; CPU time is measured from the thread's own clock delta since its last
+        // sample, so it accrues across skips on its own.  The span-link lookup is the
+        // lock-free snapshot read, consulted once per thread per pass.
+        const uint32_t unlinked_period = span_aware_unlinked_period.load(std::memory_order_relaxed);
+
+        renderer_ptr->begin_pass();
+        for_each_interp_cached([&](PyInterpreterState* interp) -> void {
             for_each_thread(interp, [&](PyThreadState* tstate, ThreadInfo& thread) {
-                thread.sample(interp->id, tstate, wall_time_us);
+                const unsigned long tid = tstate->thread_id;
+                if (unlinked_period > 1 && (tid + pass_index) % unlinked_period != 0 &&
+                    !ThreadSpanLinks::get_instance().has_span_link(tid)) {
+                    deferred_wall_us[tid] += wall_time_us;
+                    return;
+                }
+                auto deferred = deferred_wall_us.find(tid);
+                if (deferred == deferred_wall_us.end() && renderer_ptr->is_thread_stack_stable(tid)) {
+                    deferred_wall_us[tid] = wall_time_us;
+                    return;
+                }
+                microsecond_t effective_wall_us = wall_time_us;
+                if (deferred != deferred_wall_us.end()) {
+                    effective_wall_us += deferred->second;
+                    deferred_wall_us.erase(deferred);
+                }
+                // Exception sampling rides the wall/cpu pass: if an exception is propagating
+                // on this thread right now, its type is attached to the sample about to be
+                // rendered, so the raise-site stack comes for free from the same unwind
+                if (exception_sampling.load(std::memory_order_relaxed)) {
+                    renderer_ptr->set_pending_exception(propagating_exception_name(tstate));
+                }
+                thread.sample(interp->id, tstate, effective_wall_us);
             });
         });
+        renderer_ptr->finish_pass();
+
+        // Achieved-rate accounting.  When a pass overruns the interval the
+        // sleep below is a no-op and the effective rate quietly drops; count
+        // it so the degradation shows up in the stats instead of nowhere.
+        const auto pass_us =
+          static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now() - sample_time_now).count());
+        last_pass_us.store(pass_us, std::memory_order_relaxed);
+        sampling_passes.fetch_add(1, std::memory_order_relaxed);
+        if (pass_us >= static_cast<uint64_t>(sample_interval_us.load())) {
+            overrun_passes.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint64_t prev_max = max_pass_us.load(std::memory_order_relaxed);
+        while (pass_us > prev_max && !max_pass_us.compare_exchange_weak(prev_max, pass_us, std::memory_order_relaxed)) {
+        }
+
+        // Idle governor: when no thread's stack changed for a stretch of passes the process is
+        // idle, and waking at full rate just burns CPU.  Back the wakeup interval off
+        // exponentially; any observed change (or the activity hint from register_thread)
+        // restores the nominal rate immediately.
+        if (renderer_ptr->last_pass_changed_threads() == 0 && !activity_hint.exchange(false)) {
+            idle_passes++;
+            if (idle_passes >= g_idle_backoff_threshold_passes && backoff_shift < g_idle_backoff_max_shift) {
+                backoff_shift++;
+            }
+        } else {
+            idle_passes = 0;
+            backoff_shift = 0;
+        }
 
         // Before sleeping, check whether the user has called for this thread to die.
         if (seq_num != thread_seq_num.load()) {
@@ -36,16 +201,82 @@ Sampler::sampling_thread(const uint64_t seq_num)
         // Sleep for the remainder of the interval, get it atomically
         // Generally speaking system "sleep" times will wait _at least_ as long as the specified time, so
         // in actual fact the duration may be more than we indicated.  This tends to be more true on busy
-        // systems.
-        std::this_thread::sleep_until(sample_time_now + microseconds(sample_interval_us.load()));
+        // systems.  Compensate by aiming earlier by the expected overshoot,
+        // bounded to half the interval so a pathological estimate can never
+        // turn the loop into a spin.
+        const auto interval_us = static_cast<int64_t>(sample_interval_us.load());
+        if (backoff_shift > 0) {
+            // Backed off: the long sleep can be cut short by register_thread's activity hint
+            // or by stop().  The overshoot correction is tuned for the nominal rate, so it
+            // neither applies here nor learns from these wakeups.
+            have_deadline = false;
+            std::unique_lock<std::mutex> lock(wake_cv_mtx);
+            wake_cv.wait_for(lock, microseconds(interval_us << backoff_shift), [&]() {
+                return activity_hint.load() || seq_num != thread_seq_num.load();
+            });
+        } else {
+            const int64_t correction_us = std::min(std::max<int64_t>(0, overshoot_ewma_us), interval_us / 2);
+            next_deadline = sample_time_now + microseconds(interval_us - correction_us);
+            have_deadline = true;
+            // Timed wait rather than a bare sleep_until: stop() and set_interval() notify the
+            // condition variable, so shutdown and interval changes interrupt the sleep
+            // instead of waiting out up to a full interval.  An interval change wakes into an
+            // immediate pass; wall time is measured, not assumed, so the short interval
+            // attributes exactly.
+            std::unique_lock<std::mutex> lock(wake_cv_mtx);
+            wake_cv.wait_until(lock, next_deadline, [&]() {
+                return seq_num != thread_seq_num.load() || sample_interval_us.load() != interval_us;
+            });
+        }
     }
 }
 
+Sampler::SamplingStats
+Sampler::get_sampling_stats() const
+{
+    return SamplingStats{
+        sampling_passes.load(std::memory_order_relaxed),
+        overrun_passes.load(std::memory_order_relaxed),
+        last_pass_us.load(std::memory_order_relaxed),
+        max_pass_us.load(std::memory_order_relaxed),
+        total_drift_us.load(std::memory_order_relaxed),
+    };
+}
+
 void
 Sampler::set_interval(double new_interval_s)
 {
     microsecond_t new_interval_us = static_cast<microsecond_t>(new_interval_s * 1e6);
     sample_interval_us.store(new_interval_us);
+
+    // Wake a sleeping sampler so the new interval takes effect now rather than after the old
+    // one has been slept out.  Taking (and immediately releasing) the lock first closes the
+    // window where the sampler has checked the predicate but not yet gone to sleep.
+    {
+        const std::lock_guard<std::mutex> lock(wake_cv_mtx);
+    }
+    wake_cv.notify_all();
+}
+
+void
+Sampler::set_exception_sampling(bool enable)
+{
+    exception_sampling.store(enable);
+}
+
+void
+Sampler::set_span_aware_sampling(double unlinked_fraction)
+{
+    // The fraction is applied as a skip period: unlinked threads are unwound every
+    // round(1/fraction)th pass.  Fractions at or above 1 (or non-positive ones) disable the
+    // policy; very small fractions are clamped so an unlinked thread is never more than
+    // g_span_aware_max_unlinked_period passes stale.
+    uint32_t period = 0;
+    if (unlinked_fraction > 0.0 && unlinked_fraction < 1.0) {
+        period = static_cast<uint32_t>(std::lround(1.0 / unlinked_fraction));
+        period = std::min(period, g_span_aware_max_unlinked_period);
+    }
+    span_aware_unlinked_period.store(period);
 }
 
 Sampler::Sampler()
@@ -67,6 +298,7 @@ _stack_v2_atfork_child()
     // so we don't even reveal this function to the user
     _set_pid(getpid());
     ThreadSpanLinks::postfork_child();
+    FlushQueue::postfork_child();
 }
 
 __attribute__((constructor)) void
@@ -75,16 +307,30 @@ _stack_v2_init()
     _stack_v2_atfork_child();
 }
 
+void
+Sampler::set_frame_cache_size(uint64_t size)
+{
+    // The cache is sized at echion init; after that the setting would silently do nothing, so
+    // make the no-op explicit here rather than pretending a live resize happened
+    if (size > 0 && !setup_complete.load()) {
+        echion_frame_cache_size = size;
+    }
+}
+
 void
 Sampler::one_time_setup()
 {
     _set_cpu(true);
     init_frame_cache(echion_frame_cache_size);
+    setup_complete.store(true);
 
     // It is unlikely, but possible, that the caller has forked since application startup, but before starting echion.
     // Run the atfork handler to ensure that we're tracking the correct process
     _stack_v2_atfork_child();
-    pthread_atfork(nullptr, nullptr, _stack_v2_atfork_child);
+    // PID propagation and span-link/flush-queue cleanup is reset-state work;
+    // the shared registry orders it against the uploader's fork handlers.
+    Datadog::ForkRegistry::register_handlers(Datadog::ForkRegistry::Phase::ResetState,
+                                             { nullptr, nullptr, _stack_v2_atfork_child });
 
     // Register our rendering callbacks with echion's Renderer singleton
     Renderer::get().set_renderer(renderer_ptr);
@@ -93,40 +339,48 @@ Sampler::one_time_setup()
 void
 Sampler::register_thread(uint64_t id, uint64_t native_id, const char* name)
 {
-    // Registering threads requires coordinating with one of echion's global locks, which we take here.
-    const std::lock_guard<std::mutex> thread_info_guard{ thread_info_map_lock };
-
-    static bool has_errored = false;
-    auto it = thread_info_map.find(id);
-    if (it == thread_info_map.end()) {
-        try {
-            thread_info_map.emplace(id, std::make_unique<ThreadInfo>(id, native_id, name));
-        } catch (const ThreadInfo::Error& e) {
-            if (!has_errored) {
-                has_errored = true;
-                std::cerr << "Failed to register thread: " << std::hex << id << std::dec << " (" << native_id << ") "
-                          << name << std::endl;
-            }
-        }
-    } else {
-        try {
-            it->second = std::make_unique<ThreadInfo>(id, native_id, name);
-        } catch (const ThreadInfo::Error& e) {
-            if (!has_errored) {
-                has_errored = true;
-                std::cerr << "Failed to register thread: " << std::hex << id << std::dec << " (" << native_id << ") "
-                          << name << std::endl;
-            }
+    // Registering threads requires coordinating with one of echion's global locks--the same
+    // lock the sampling pass holds while walking every thread, so on thread-churny workloads
+    // each instruction spent under it stalls thread creation behind in-progress passes.
+    // Construct the ThreadInfo (which does real work: clock setup and friends) before taking
+    // the lock, leaving only the map insert inside the critical section.
+    static std::atomic<bool> has_errored{ false };
+    std::unique_ptr<ThreadInfo> info;
+    try {
+        info = std::make_unique<ThreadInfo>(id, native_id, name);
+    } catch (const ThreadInfo::Error& e) {
+        if (!has_errored.exchange(true)) {
+            std::cerr << "Failed to register thread: " << std::hex << id << std::dec << " (" << native_id << ") "
+                      << name << std::endl;
         }
+        return;
     }
+
+    {
+        const std::lock_guard<std::mutex> thread_info_guard{ thread_info_map_lock };
+        thread_info_map[id] = std::move(info); // insert or replace
+    }
+
+    // A new thread is the earliest sign of activity; wake the sampler if the idle governor
+    // has it backed off
+    activity_hint.store(true);
+    wake_cv.notify_one();
 }
 
 void
 Sampler::unregister_thread(uint64_t id)
 {
-    // unregistering threads requires coordinating with one of echion's global locks, which we take here.
-    const std::lock_guard<std::mutex> thread_info_guard{ thread_info_map_lock };
-    thread_info_map.erase(id);
+    // Unregistering threads coordinates with the same echion lock; move the ThreadInfo out of
+    // the map under the lock but run its destructor after releasing it.
+    std::unique_ptr<ThreadInfo> retired;
+    {
+        const std::lock_guard<std::mutex> thread_info_guard{ thread_info_map_lock };
+        auto it = thread_info_map.find(id);
+        if (it != thread_info_map.end()) {
+            retired = std::move(it->second);
+            thread_info_map.erase(it);
+        }
+    }
 }
 
 void
@@ -135,6 +389,9 @@ Sampler::start()
     static std::once_flag once;
     std::call_once(once, [this]() { this->one_time_setup(); });
 
+    // Launch (or, after a fork, relaunch) the flush thread before samples start flowing
+    FlushQueue::get().start();
+
     // Launch the sampling thread.
     // Thread lifetime is bounded by the value of the sequence number.  When it is changed from the value the thread was
     // launched with, the thread will exit.
@@ -148,6 +405,14 @@ Sampler::stop()
     // Modifying the thread sequence number will cause the sampling thread to exit when it completes
     // a sampling loop.  Currently there is no mechanism to force stuck threads, should they get locked.
     ++thread_seq_num;
+
+    // The sampling thread checks the sequence number in its wait predicates, so waking it
+    // turns shutdown latency from up-to-one-interval into microseconds (same lock discipline
+    // as set_interval)
+    {
+        const std::lock_guard<std::mutex> lock(wake_cv_mtx);
+    }
+    wake_cv.notify_all();
 }
 
 void
@@ -178,5 +443,75 @@ void
 Sampler::link_tasks(PyObject* parent, PyObject* child)
 {
     std::lock_guard<std::mutex> guard(task_link_map_lock);
+    // Completed tasks are unlinked by a done-callback, but that hook can be bypassed (e.g. a
+    // task collected without ever running its callbacks).  If the map still manages to grow
+    // past the failsafe bound, dropping the links is preferable to leaking: stale entries are
+    // not just dead weight, a recycled PyObject address could match one and attribute a bogus
+    // parent to an unrelated task.
+    if (task_link_map.size() >= g_task_link_map_max && task_link_map.find(child) == task_link_map.end()) {
+        task_link_map.clear();
+    }
     task_link_map[child] = parent;
 }
+
+void
+Sampler::unlink_tasks(PyObject* child)
+{
+    std::lock_guard<std::mutex> guard(task_link_map_lock);
+    task_link_map.erase(child); // no-op if the task was never linked
+}
+
+void
+Sampler::track_greenlet(uintptr_t greenlet_id, const char* name, PyObject* frame)
+{
+    // The name has to live in echion's string table before the sampling thread can render
+    // it.  If interning fails the greenlet just stays untracked for now, and its time folds
+    // into the owning thread as before; the next switch retries.
+    StringTable::Key name_key;
+    try {
+        name_key = string_table.key(name);
+    } catch (StringTable::Error&) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(greenlet_info_map_lock);
+    auto entry = greenlet_info_map.find(greenlet_id);
+    if (entry != greenlet_info_map.end()) {
+        // Already tracked: refresh the saved frame (the name never changes)
+        entry->second->frame = frame;
+    } else {
+        greenlet_info_map.emplace(greenlet_id, std::make_unique<GreenletInfo>(greenlet_id, frame, name_key));
+    }
+
+    // track_greenlet is called from the thread that is running the greenlet, so this also
+    // marks it as the thread's current greenlet
+    greenlet_thread_map[PyThread_get_thread_native_id()] = greenlet_id;
+}
+
+void
+Sampler::untrack_greenlet(uintptr_t greenlet_id)
+{
+    std::lock_guard<std::mutex> guard(greenlet_info_map_lock);
+    greenlet_info_map.erase(greenlet_id);
+    greenlet_parent_map.erase(greenlet_id);
+}
+
+void
+Sampler::link_greenlets(uintptr_t parent, uintptr_t child)
+{
+    std::lock_guard<std::mutex> guard(greenlet_info_map_lock);
+    greenlet_parent_map[child] = parent;
+}
+
+void
+Sampler::update_greenlet_frame(uintptr_t greenlet_id, PyObject* frame)
+{
+    // Called for the greenlet that just suspended; the saved frame is where the thread walk
+    // starts unwinding it.  Intentionally does not touch greenlet_thread_map: the switch
+    // target's track_greenlet call is what moves the thread's current-greenlet marker.
+    std::lock_guard<std::mutex> guard(greenlet_info_map_lock);
+    auto entry = greenlet_info_map.find(greenlet_id);
+    if (entry != greenlet_info_map.end()) {
+        entry->second->frame = frame;
+    }
+}
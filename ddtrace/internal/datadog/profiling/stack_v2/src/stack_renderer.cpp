@@ -1,10 +1,112 @@
 #include "stack_renderer.hpp"
 
+#include "constants.hpp"
+#include "flush_queue.hpp"
 #include "thread_span_links.hpp"
 #include "utf8_validate.hpp"
 
+#include "dd_wrapper/include/coarse_clock.hpp"
+
+#include <array>
+#include <atomic>
+
 using namespace Datadog;
 
+namespace {
+
+// FNV-1a, used for the per-thread stack fingerprints
+constexpr uint64_t fnv_offset_basis = 0xcbf29ce484222325ULL;
+
+void
+fnv_mix(uint64_t& hash, uint64_t value)
+{
+    hash ^= value;
+    hash *= 1099511628211ULL;
+}
+
+// The strings handed to render_python_frame come out of echion's frame cache,
+// so consecutive samples overwhelmingly repeat the same (pointer, length)
+// pairs.  Memoize the utf-8 validation verdict in a small direct-mapped table
+// so the steady state skips the O(length) scan; the rendering thread is the
+// only caller, so no synchronization is needed.  Downstream string interning
+// is already memoized the same way on the dd_wrapper side.
+struct Utf8MemoEntry
+{
+    const char* ptr{ nullptr };
+    size_t len{ 0 };
+    bool valid{ false };
+};
+
+constexpr size_t utf8_memo_size = 1024; // power of two, ~24 KiB
+std::array<Utf8MemoEntry, utf8_memo_size> utf8_memo{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Hit/lookup counters over the memo; written by the rendering thread, read from Python, so
+// atomic (relaxed--these are diagnostics, not synchronization)
+std::atomic<uint64_t> utf8_memo_hit_count{ 0 };    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<uint64_t> utf8_memo_lookup_count{ 0 }; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Task names get the same treatment one level further: beyond the validation
+// verdict, memoize the interned-string handle so a repeated task name is
+// pushed by id with no per-sample string traffic at all.  The names come out
+// of echion's task cache, so pointer identity is stable while a task lives; a
+// completed task's entry simply ages out of the direct-mapped table, and a
+// collision only costs a re-intern (the profile's string table dedups by
+// content, so handles for equal names are identical).
+struct TaskNameMemoEntry
+{
+    const char* ptr{ nullptr };
+    size_t len{ 0 };
+    uint64_t name_id{ 0 };
+};
+
+constexpr size_t task_name_memo_size = 256; // power of two
+std::array<TaskNameMemoEntry, task_name_memo_size> task_name_memo{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+uint64_t
+memoized_task_name_id(std::string_view name)
+{
+    const auto slot = (reinterpret_cast<uintptr_t>(name.data()) >> 4) & (task_name_memo_size - 1);
+    auto& entry = task_name_memo[slot]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    if (entry.ptr == name.data() && entry.len == name.size()) {
+        return entry.name_id;
+    }
+    const uint64_t name_id = ddup_intern_string(name);
+    entry = { name.data(), name.size(), name_id };
+    return name_id;
+}
+
+bool
+memoized_utf8_valid(std::string_view str)
+{
+    if (str.empty()) {
+        return true;
+    }
+    utf8_memo_lookup_count.fetch_add(1, std::memory_order_relaxed);
+    const auto slot = (reinterpret_cast<uintptr_t>(str.data()) >> 4) & (utf8_memo_size - 1);
+    auto& entry = utf8_memo[slot]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    if (entry.ptr == str.data() && entry.len == str.size()) {
+        utf8_memo_hit_count.fetch_add(1, std::memory_order_relaxed);
+        return entry.valid;
+    }
+    const bool valid = utf8_check_is_valid(str.data(), str.size());
+    entry = { str.data(), str.size(), valid };
+    return valid;
+}
+
+} // namespace
+
+uint64_t
+Datadog::renderer_memo_hits()
+{
+    return utf8_memo_hit_count.load(std::memory_order_relaxed);
+}
+
+uint64_t
+Datadog::renderer_memo_lookups()
+{
+    return utf8_memo_lookup_count.load(std::memory_order_relaxed);
+}
+
 void
 StackRenderer::render_message(std::string_view msg)
 {
@@ -12,6 +114,33 @@ StackRenderer::render_message(std::string_view msg)
     (void)msg;
 }
 
+void
+StackRenderer::begin_pass()
+{
+    // Get the current time in ns in a way compatible with python's time.monotonic_ns(), which is backed by
+    // clock_gettime(CLOCK_MONOTONIC) on linux and mach_absolute_time() on macOS.  The coarse reader shares
+    // that timeline at scheduler-tick resolution, and the tick error disappears entirely into the timeline
+    // quantization applied downstream (samples are snapped to a 10 ms grid by default).
+    pass_time_ns = coarse_monotonic_ns();
+}
+
+uint64_t
+StackRenderer::cached_thread_name_id(uintptr_t thread_id, unsigned long native_id, std::string_view name)
+{
+    auto it = threadinfo_cache.find(thread_id);
+    if (it != threadinfo_cache.end() && it->second.native_id == native_id && it->second.name == name) {
+        return it->second.name_id;
+    }
+
+    // First sample from this thread, or the thread was re-registered under a new identity.
+    // Intern the name once--falling back to the thread id for empty names, matching what
+    // ddup_push_threadinfo would substitute--and remember the handle.
+    const uint64_t name_id =
+      name.empty() ? ddup_intern_string(std::to_string(thread_id)) : ddup_intern_string(name);
+    threadinfo_cache[thread_id] = { native_id, std::string(name), name_id };
+    return name_id;
+}
+
 void
 StackRenderer::render_thread_begin(PyThreadState* tstate,
                                    std::string_view name,
@@ -20,6 +149,13 @@ StackRenderer::render_thread_begin(PyThreadState* tstate,
                                    unsigned long native_id)
 {
     (void)tstate;
+
+    // Close out the previous thread's stack fingerprint and start this one's
+    finalize_thread_fingerprint();
+    pass_thread_id = thread_id;
+    pass_stack_hash = fnv_offset_basis;
+    pass_thread_open = true;
+
     static bool failed = false;
     if (failed) {
         return;
@@ -31,30 +167,35 @@ StackRenderer::render_thread_begin(PyThreadState* tstate,
         return;
     }
 
-    // Get the current time in ns in a way compatible with python's time.monotonic_ns(), which is backed by
-    // clock_gettime(CLOCK_MONOTONIC) on linux and mach_absolute_time() on macOS.
-    // This is not the same as std::chrono::steady_clock, which is backed by clock_gettime(CLOCK_MONOTONIC_RAW)
-    // (although this is underspecified in the standard)
-    int64_t now_ns = 0;
-    timespec ts;
-    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
-        now_ns = static_cast<int64_t>(ts.tv_sec) * 1'000'000'000LL + static_cast<int64_t>(ts.tv_nsec);
+    // The pass timestamp was read once in begin_pass(); every thread visited in the pass
+    // shares it, saving a clock_gettime syscall per thread
+    const int64_t now_ns = pass_time_ns;
+    if (now_ns != 0) {
         ddup_push_monotonic_ns(sample, now_ns);
     }
 
     // Save the thread information in case we observe a task on the thread
     thread_state.id = thread_id;
     thread_state.native_id = native_id;
-    thread_state.name = std::string(name);
+    thread_state.name_id = cached_thread_name_id(thread_id, native_id, name);
     thread_state.now_time_ns = now_ns;
     thread_state.wall_time_ns = 1000LL * wall_time_us;
     thread_state.cpu_time_ns = 0; // Walltime samples are guaranteed, but CPU times are not. Initialize to 0
                                   // since we don't know if we'll get a CPU time here.
 
-    // Finalize the thread information we have
-    ddup_push_threadinfo(sample, static_cast<int64_t>(thread_id), static_cast<int64_t>(native_id), name);
+    // Finalize the thread information we have; the name goes in by interned handle, so the
+    // steady state pays no per-sample string copy for it
+    ddup_push_threadinfo_id(
+      sample, static_cast<int64_t>(thread_id), static_cast<int64_t>(native_id), thread_state.name_id);
     ddup_push_walltime(sample, thread_state.wall_time_ns, 1);
 
+    // An exception propagating on this thread at sampling time is attributed here, so the
+    // raise-site stack about to be rendered comes from the unwind we were doing anyway
+    if (pending_exception_type != nullptr) {
+        ddup_push_exceptioninfo(sample, std::string_view(pending_exception_type), 1);
+        pending_exception_type = nullptr;
+    }
+
     const std::optional<Span> active_span = ThreadSpanLinks::get_instance().get_active_span_from_thread_id(thread_id);
     if (active_span) {
         ddup_push_span_id(sample, active_span->span_id);
@@ -66,6 +207,9 @@ StackRenderer::render_thread_begin(PyThreadState* tstate,
 void
 StackRenderer::render_task_begin(std::string_view name)
 {
+    fnv_mix(pass_stack_hash, reinterpret_cast<uintptr_t>(name.data()));
+    fnv_mix(pass_stack_hash, name.size());
+
     static bool failed = false;
     if (failed) {
         return;
@@ -82,16 +226,23 @@ StackRenderer::render_task_begin(std::string_view name)
         }
 
         // Add the thread context into the sample
-        ddup_push_threadinfo(sample,
-                             static_cast<int64_t>(thread_state.id),
-                             static_cast<int64_t>(thread_state.native_id),
-                             thread_state.name);
+        ddup_push_threadinfo_id(sample,
+                                static_cast<int64_t>(thread_state.id),
+                                static_cast<int64_t>(thread_state.native_id),
+                                thread_state.name_id);
         ddup_push_walltime(sample, thread_state.wall_time_ns, 1);
         ddup_push_cputime(sample, thread_state.cpu_time_ns, 1); // initialized to 0, so possibly a no-op
         ddup_push_monotonic_ns(sample, thread_state.now_time_ns);
     }
 
-    ddup_push_task_name(sample, name);
+    // Task names repeat across samples, so the memoized verdict means a given cached name is
+    // only ever scanned once no matter how many samples it appears in; the interned-handle
+    // memo then pushes it by id, so the steady state copies nothing either
+    static const std::string_view invalid = "<invalid_utf8>";
+    if (!memoized_utf8_valid(name)) {
+        name = invalid;
+    }
+    ddup_push_task_name_id(sample, memoized_task_name_id(name));
 }
 
 void
@@ -103,6 +254,11 @@ StackRenderer::render_stack_begin()
 void
 StackRenderer::render_python_frame(std::string_view name, std::string_view file, uint64_t line)
 {
+    // The strings live in echion's frame cache, so their addresses identify the frame
+    fnv_mix(pass_stack_hash, reinterpret_cast<uintptr_t>(name.data()));
+    fnv_mix(pass_stack_hash, reinterpret_cast<uintptr_t>(file.data()));
+    fnv_mix(pass_stack_hash, line);
+
     if (sample == nullptr) {
         std::cerr << "Received a new frame without sample storage.  Some profiling data has been lost." << std::endl;
         return;
@@ -113,10 +269,10 @@ StackRenderer::render_python_frame(std::string_view name, std::string_view file,
     // This is rare, but blowing some cycles on early validation allows the sample to be retained by
     // libdatadog, so we can evaluate the actual impact of this scenario in live scenarios.
     static const std::string_view invalid = "<invalid_utf8>";
-    if (!utf8_check_is_valid(name.data(), name.size())) {
+    if (!memoized_utf8_valid(name)) {
         name = invalid;
     }
-    if (!utf8_check_is_valid(file.data(), file.size())) {
+    if (!memoized_utf8_valid(file)) {
         file = invalid;
     }
     ddup_push_frame(sample, name, file, 0, line);
@@ -125,10 +281,27 @@ StackRenderer::render_python_frame(std::string_view name, std::string_view file,
 void
 StackRenderer::render_native_frame(std::string_view name, std::string_view file, uint64_t line)
 {
-    // This function is part of the necessary API, but it is unused by the Datadog profiler for now.
-    (void)name;
-    (void)file;
-    (void)line;
+    // Only reached when the extension is built with native unwinding (see the NATIVE_UNWINDING
+    // option in CMakeLists.txt); echion splices these below the Python frames at the boundary,
+    // so pushing them through the same pipeline lands a merged native+Python stack in the
+    // sample.  Treated identically to Python frames, fingerprinting included.
+    fnv_mix(pass_stack_hash, reinterpret_cast<uintptr_t>(name.data()));
+    fnv_mix(pass_stack_hash, reinterpret_cast<uintptr_t>(file.data()));
+    fnv_mix(pass_stack_hash, line);
+
+    if (sample == nullptr) {
+        std::cerr << "Received a native frame without sample storage.  Some profiling data has been lost." << std::endl;
+        return;
+    }
+
+    static const std::string_view invalid = "<invalid_utf8>";
+    if (!memoized_utf8_valid(name)) {
+        name = invalid;
+    }
+    if (!memoized_utf8_valid(file)) {
+        file = invalid;
+    }
+    ddup_push_frame(sample, name, file, 0, line);
 }
 
 void
@@ -153,11 +326,54 @@ StackRenderer::render_stack_end()
         return;
     }
 
-    ddup_flush_sample_v2(sample);
-    ddup_drop_sample(sample);
+    // Hand the completed sample to the flush thread; the strings were all copied into the
+    // sample's arena on the way in, so nothing here still references echion's caches.  If the
+    // ring is full (or the consumer is not up), fall back to the old synchronous flush.
+    if (!FlushQueue::get().push(sample)) {
+        ddup_flush_sample_v2(sample);
+        ddup_drop_sample(sample);
+    }
     sample = nullptr;
 }
 
+void
+StackRenderer::finalize_thread_fingerprint()
+{
+    if (!pass_thread_open) {
+        return;
+    }
+    pass_thread_open = false;
+
+    if (stack_stability.size() > g_stack_stability_max_entries) {
+        stack_stability.clear();
+    }
+    auto& entry = stack_stability[pass_thread_id];
+    if (entry.hash == pass_stack_hash) {
+        if (entry.streak < UINT32_MAX) {
+            entry.streak++;
+        }
+    } else {
+        entry.hash = pass_stack_hash;
+        entry.streak = 0;
+        pass_changed_threads++;
+    }
+}
+
+bool
+StackRenderer::is_thread_stack_stable(uintptr_t thread_id) const
+{
+    auto it = stack_stability.find(thread_id);
+    return it != stack_stability.end() && it->second.streak >= g_stack_stable_streak;
+}
+
+void
+StackRenderer::finish_pass()
+{
+    finalize_thread_fingerprint();
+    prev_pass_changed_threads = pass_changed_threads;
+    pass_changed_threads = 0;
+}
+
 bool
 StackRenderer::is_valid()
 {
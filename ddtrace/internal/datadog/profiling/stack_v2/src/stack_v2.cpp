@@ -12,15 +12,17 @@ static PyObject*
 _stack_v2_start(PyObject* self, PyObject* args, PyObject* kwargs)
 {
     (void)self;
-    static const char* const_kwlist[] = { "min_interval", NULL };
+    static const char* const_kwlist[] = { "min_interval", "frame_cache_size", NULL };
     static char** kwlist = const_cast<char**>(const_kwlist);
     double min_interval_s = g_default_sampling_period_s;
+    unsigned long long frame_cache_size = 0; // 0 keeps the default
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|d", kwlist, &min_interval_s)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|dK", kwlist, &min_interval_s, &frame_cache_size)) {
         return NULL; // If an error occurs during argument parsing
     }
 
     Sampler::get().set_interval(min_interval_s);
+    Sampler::get().set_frame_cache_size(frame_cache_size);
     Sampler::get().start();
     Py_RETURN_NONE;
 }
@@ -55,6 +57,30 @@ stack_v2_set_interval(PyObject* self, PyObject* args)
     Py_RETURN_NONE;
 }
 
+static PyObject*
+stack_v2_set_exception_sampling(PyObject* self, PyObject* args)
+{
+    (void)self;
+    int enable;
+    if (!PyArg_ParseTuple(args, "p", &enable)) {
+        return NULL;
+    }
+    Sampler::get().set_exception_sampling(enable != 0);
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_set_span_aware_sampling(PyObject* self, PyObject* args)
+{
+    (void)self;
+    double unlinked_fraction;
+    if (!PyArg_ParseTuple(args, "d", &unlinked_fraction)) {
+        return NULL;
+    }
+    Sampler::get().set_span_aware_sampling(unlinked_fraction);
+    Py_RETURN_NONE;
+}
+
 // Echion needs us to propagate information about threads, usually at thread start by patching the threading module
 // We reference some data structures here which are internal to echion (but global in scope)
 static PyObject*
@@ -127,6 +153,84 @@ _stack_v2_link_span(PyObject* self, PyObject* args, PyObject* kwargs)
 
 PyCFunction stack_v2_link_span = cast_to_pycfunction(_stack_v2_link_span);
 
+// Extracts one span record's scalars and hands them to ThreadSpanLinks; shared by the
+// fastcall and batched entry points.  span_type may be None (the tracer passes None for
+// typeless spans), which links an empty type like the keyword entry point does.
+static bool
+link_span_from_scalars(PyObject* thread_id_obj, PyObject* span_id_obj, PyObject* local_root_obj, PyObject* type_obj)
+{
+    const uint64_t thread_id = PyLong_AsUnsignedLongLong(thread_id_obj);
+    const uint64_t span_id = PyLong_AsUnsignedLongLong(span_id_obj);
+    const uint64_t local_root_span_id = PyLong_AsUnsignedLongLong(local_root_obj);
+    if (PyErr_Occurred()) {
+        return false;
+    }
+
+    std::string span_type;
+    if (type_obj != Py_None) {
+        Py_ssize_t size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(type_obj, &size);
+        if (data == nullptr) {
+            return false;
+        }
+        span_type.assign(data, static_cast<size_t>(size));
+    }
+
+    ThreadSpanLinks::get_instance().link_span(thread_id, span_id, local_root_span_id, std::move(span_type));
+    return true;
+}
+
+static PyObject*
+_stack_v2_link_span_fast(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+{
+    // Positional-only fast path: no tuple packing, no keyword parsing, no format strings.
+    // The thread id is explicit (unlike link_span, which reads the calling thread's), so the
+    // tracer can update any thread's link from wherever it happens to run.
+    (void)self;
+    if (nargs != 4) {
+        PyErr_SetString(PyExc_TypeError, "link_span_fast expects (thread_id, span_id, local_root_span_id, span_type)");
+        return NULL;
+    }
+    if (!link_span_from_scalars(args[0], args[1], args[2], args[3])) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyCFunction stack_v2_link_span_fast = cast_to_pycfunction(_stack_v2_link_span_fast);
+
+static PyObject*
+stack_v2_link_span_batch(PyObject* self, PyObject* arg)
+{
+    // Bulk form: one boundary crossing for a whole flush worth of updates.  Each item is a
+    // (thread_id, span_id, local_root_span_id, span_type) tuple.
+    (void)self;
+    PyObject* seq = PySequence_Fast(arg, "link_span_batch expects a sequence of 4-tuples");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    const Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+    for (Py_ssize_t i = 0; i < n; i++) {
+        PyObject* item = PySequence_Fast_GET_ITEM(seq, i); // borrowed
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 4) {
+            PyErr_SetString(PyExc_TypeError,
+                            "link_span_batch items must be (thread_id, span_id, local_root_span_id, span_type)");
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (!link_span_from_scalars(PyTuple_GET_ITEM(item, 0),
+                                    PyTuple_GET_ITEM(item, 1),
+                                    PyTuple_GET_ITEM(item, 2),
+                                    PyTuple_GET_ITEM(item, 3))) {
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    Py_RETURN_NONE;
+}
+
 static PyObject*
 stack_v2_track_asyncio_loop(PyObject* self, PyObject* args)
 {
@@ -175,20 +279,158 @@ stack_v2_link_tasks(PyObject* self, PyObject* args)
     Py_RETURN_NONE;
 }
 
+static PyObject*
+stack_v2_unlink_tasks(PyObject* self, PyObject* args)
+{
+    (void)self;
+    PyObject* child;
+
+    if (!PyArg_ParseTuple(args, "O", &child)) {
+        return NULL;
+    }
+
+    Sampler::get().unlink_tasks(child);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_track_greenlet(PyObject* self, PyObject* args)
+{
+    (void)self;
+    uintptr_t greenlet_id;
+    const char* name;
+    PyObject* frame;
+
+    if (!PyArg_ParseTuple(args, "KsO", &greenlet_id, &name, &frame)) {
+        return NULL;
+    }
+
+    // A running greenlet has no saved frame; None from Python means "unwind the live stack"
+    Sampler::get().track_greenlet(greenlet_id, name, (frame != Py_None) ? frame : NULL);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_untrack_greenlet(PyObject* self, PyObject* args)
+{
+    (void)self;
+    uintptr_t greenlet_id;
+
+    if (!PyArg_ParseTuple(args, "K", &greenlet_id)) {
+        return NULL;
+    }
+
+    Sampler::get().untrack_greenlet(greenlet_id);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_link_greenlets(PyObject* self, PyObject* args)
+{
+    (void)self;
+    uintptr_t parent, child;
+
+    if (!PyArg_ParseTuple(args, "KK", &parent, &child)) {
+        return NULL;
+    }
+
+    Sampler::get().link_greenlets(parent, child);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_update_greenlet_frame(PyObject* self, PyObject* args)
+{
+    (void)self;
+    uintptr_t greenlet_id;
+    PyObject* frame;
+
+    if (!PyArg_ParseTuple(args, "KO", &greenlet_id, &frame)) {
+        return NULL;
+    }
+
+    Sampler::get().update_greenlet_frame(greenlet_id, (frame != Py_None) ? frame : NULL);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stack_v2_frame_cache_stats(PyObject* self, PyObject* args)
+{
+    (void)self;
+    (void)args;
+    // memo_hits/memo_lookups proxy echion's frame-cache effectiveness: the renderer's memo is
+    // keyed by the cache's string pointers, so a thrashing cache shows up as a low hit rate
+    return Py_BuildValue("{s:K,s:K,s:K}",
+                         "capacity",
+                         static_cast<unsigned long long>(Sampler::get().get_frame_cache_size()),
+                         "memo_hits",
+                         static_cast<unsigned long long>(renderer_memo_hits()),
+                         "memo_lookups",
+                         static_cast<unsigned long long>(renderer_memo_lookups()));
+}
+
+static PyObject*
+stack_v2_sampling_stats(PyObject* self, PyObject* args)
+{
+    (void)self;
+    (void)args;
+    const auto stats = Sampler::get().get_sampling_stats();
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K}",
+                         "passes",
+                         static_cast<unsigned long long>(stats.passes),
+                         "overruns",
+                         static_cast<unsigned long long>(stats.overruns),
+                         "last_pass_us",
+                         static_cast<unsigned long long>(stats.last_pass_us),
+                         "max_pass_us",
+                         static_cast<unsigned long long>(stats.max_pass_us),
+                         "drift_us",
+                         static_cast<unsigned long long>(stats.drift_us));
+}
+
 static PyMethodDef _stack_v2_methods[] = {
     { "start", reinterpret_cast<PyCFunction>(stack_v2_start), METH_VARARGS | METH_KEYWORDS, "Start the sampler" },
     { "stop", stack_v2_stop, METH_VARARGS, "Stop the sampler" },
     { "register_thread", stack_v2_thread_register, METH_VARARGS, "Register a thread" },
     { "unregister_thread", stack_v2_thread_unregister, METH_VARARGS, "Unregister a thread" },
     { "set_interval", stack_v2_set_interval, METH_VARARGS, "Set the sampling interval" },
+    { "set_exception_sampling",
+      stack_v2_set_exception_sampling,
+      METH_VARARGS,
+      "Enable or disable pass-time exception sampling" },
+    { "set_span_aware_sampling",
+      stack_v2_set_span_aware_sampling,
+      METH_VARARGS,
+      "Sample threads without a span link at the given fraction of the nominal rate" },
+    { "sampling_stats", stack_v2_sampling_stats, METH_VARARGS, "Achieved-rate statistics for the sampling thread" },
+    { "frame_cache_stats", stack_v2_frame_cache_stats, METH_VARARGS, "Frame cache capacity and reuse statistics" },
     { "link_span",
       reinterpret_cast<PyCFunction>(stack_v2_link_span),
       METH_VARARGS | METH_KEYWORDS,
       "Link a span to a thread" },
+    { "link_span_fast",
+      reinterpret_cast<PyCFunction>(stack_v2_link_span_fast),
+      METH_FASTCALL,
+      "Link a span to a thread; positional scalars only" },
+    { "link_span_batch", stack_v2_link_span_batch, METH_O, "Link a batch of spans to their threads" },
     // asyncio task support
     { "track_asyncio_loop", stack_v2_track_asyncio_loop, METH_VARARGS, "Map the name of a task with its identifier" },
     { "init_asyncio", stack_v2_init_asyncio, METH_VARARGS, "Initialise asyncio tracking" },
     { "link_tasks", stack_v2_link_tasks, METH_VARARGS, "Link two tasks" },
+    { "unlink_tasks", stack_v2_unlink_tasks, METH_VARARGS, "Drop the parent link of a completed task" },
+    // greenlet support, same shape as the asyncio entries above
+    { "track_greenlet", stack_v2_track_greenlet, METH_VARARGS, "Start tracking a greenlet" },
+    { "untrack_greenlet", stack_v2_untrack_greenlet, METH_VARARGS, "Stop tracking a greenlet" },
+    { "link_greenlets", stack_v2_link_greenlets, METH_VARARGS, "Link a greenlet to the one that spawned it" },
+    { "update_greenlet_frame",
+      stack_v2_update_greenlet_frame,
+      METH_VARARGS,
+      "Update the saved frame of a suspended greenlet" },
     { NULL, NULL, 0, NULL }
 };
 
@@ -1,5 +1,8 @@
 #include "thread_span_links.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <mutex>
 #include <optional>
@@ -7,32 +10,93 @@
 #include <string>
 
 namespace Datadog {
+
+void
+ThreadSpanLinks::write_entry(SeqlockSpan& entry,
+                             uint64_t span_id,
+                             uint64_t local_root_span_id,
+                             const std::string& span_type)
+{
+    // Single writer (mtx is held), so plain increments suffice; the fences order the
+    // field stores between the two sequence bumps for the lock-free reader.
+    entry.seq.fetch_add(1, std::memory_order_relaxed); // now odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.span_id = span_id;
+    entry.local_root_span_id = local_root_span_id;
+    const size_t len = std::min(span_type.size(), span_type_capacity);
+    std::memcpy(entry.span_type, span_type.data(), len); // NOLINT(bugprone-not-null-terminated-result)
+    entry.span_type_len = len;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.seq.fetch_add(1, std::memory_order_relaxed); // even again: write complete
+}
+
 void
 ThreadSpanLinks::link_span(uint64_t thread_id, uint64_t span_id, uint64_t local_root_span_id, std::string span_type)
 {
     std::lock_guard<std::mutex> lock(mtx);
 
-    auto it = thread_id_to_span.find(thread_id);
-    if (it == thread_id_to_span.end()) {
-        thread_id_to_span[thread_id] = std::make_unique<Span>(span_id, local_root_span_id, span_type);
-    } else {
-        it->second->span_id = span_id;
-        it->second->local_root_span_id = local_root_span_id;
-        it->second->span_type = span_type;
+    auto snap = std::atomic_load(&snapshot);
+    if (snap) {
+        auto it = snap->find(thread_id);
+        if (it != snap->end()) {
+            // Common case: the thread already has an entry, update it in place.  The
+            // snapshot does not change, so nothing needs to be republished.
+            write_entry(*it->second, span_id, local_root_span_id, span_type);
+            return;
+        }
     }
+
+    // New thread: copy the map (shallow--entries are shared), insert, republish
+    auto next = snap ? std::make_shared<SpanMap>(*snap) : std::make_shared<SpanMap>();
+    auto entry = std::make_shared<SeqlockSpan>();
+    write_entry(*entry, span_id, local_root_span_id, span_type);
+    (*next)[thread_id] = std::move(entry);
+    std::atomic_store(&snapshot, std::shared_ptr<const SpanMap>(std::move(next)));
 }
 
 const std::optional<Span>
 ThreadSpanLinks::get_active_span_from_thread_id(uint64_t thread_id)
 {
-    std::lock_guard<std::mutex> lock(mtx);
+    auto snap = std::atomic_load(&snapshot);
+    if (!snap) {
+        return std::nullopt;
+    }
+    auto it = snap->find(thread_id);
+    if (it == snap->end()) {
+        return std::nullopt;
+    }
+
+    // Seqlock read: copy the fields out, then confirm no write raced with us.  A handful
+    // of retries is plenty--the write side is a few stores under a held mutex--and if a
+    // pathological storm of updates keeps invalidating the read, dropping the label for
+    // this sample beats stalling the sampling pass.
+    const SeqlockSpan& entry = *it->second;
+    for (int attempt = 0; attempt < 8; attempt++) {
+        const uint32_t seq_before = entry.seq.load(std::memory_order_acquire);
+        if (seq_before & 1) {
+            continue; // write in progress
+        }
+        const uint64_t span_id = entry.span_id;
+        const uint64_t local_root_span_id = entry.local_root_span_id;
+        char span_type[span_type_capacity];
+        const size_t len = std::min(entry.span_type_len, span_type_capacity);
+        std::memcpy(span_type, entry.span_type, len);
 
-    std::optional<Span> span;
-    auto it = thread_id_to_span.find(thread_id);
-    if (it != thread_id_to_span.end()) {
-        span = *(it->second);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.seq.load(std::memory_order_relaxed) == seq_before) {
+            return Span(span_id, local_root_span_id, std::string(span_type, len));
+        }
     }
-    return span;
+    return std::nullopt;
+}
+
+bool
+ThreadSpanLinks::has_span_link(uint64_t thread_id)
+{
+    auto snap = std::atomic_load(&snapshot);
+    return snap && snap->find(thread_id) != snap->end();
 }
 
 void
@@ -40,14 +104,20 @@ ThreadSpanLinks::unlink_span(uint64_t thread_id)
 {
     std::lock_guard<std::mutex> lock(mtx);
 
-    thread_id_to_span.erase(thread_id); // This is a no-op if the key is not found
+    auto snap = std::atomic_load(&snapshot);
+    if (!snap || snap->find(thread_id) == snap->end()) {
+        return; // Match the old erase(): a no-op if the key is not found
+    }
+    auto next = std::make_shared<SpanMap>(*snap);
+    next->erase(thread_id);
+    std::atomic_store(&snapshot, std::shared_ptr<const SpanMap>(std::move(next)));
 }
 
 void
 ThreadSpanLinks::reset()
 {
     std::lock_guard<std::mutex> lock(mtx);
-    thread_id_to_span.clear();
+    std::atomic_store(&snapshot, std::shared_ptr<const SpanMap>());
 }
 
 void
@@ -13,7 +13,7 @@ from .compat import ensure_text
 from .logger import get_logger
 
 
-__all__ = ["MsgpackEncoderV04", "MsgpackEncoderV05", "ListStringTable", "MSGPACK_ENCODERS"]
+__all__ = ["MsgpackEncoderV04", "MsgpackEncoderV05", "ListStringTable", "MSGPACK_ENCODERS", "json_encode"]
 
 
 if TYPE_CHECKING:  # pragma: no cover
@@ -22,6 +22,29 @@ if TYPE_CHECKING:  # pragma: no cover
 log = get_logger(__name__)
 
 
+try:
+    from ._encoding import json_encode as _json_encode_native
+except ImportError:
+    _json_encode_native = None
+
+
+def json_encode(obj):
+    # type: (Any) -> bytes
+    """Encode ``obj`` as compact UTF-8 JSON bytes.
+
+    Prefers the native encoder from ``_encoding`` and falls back to
+    ``json.dumps`` if it is unavailable or fails, so a telemetry payload is
+    never lost to the fast path. Both produce compact separators, raw UTF-8
+    for non-ASCII text and the stdlib NaN/Infinity spellings.
+    """
+    if _json_encode_native is not None:
+        try:
+            return _json_encode_native(obj)
+        except Exception:
+            log.debug("native JSON encoding failed, falling back to json.dumps", exc_info=True)
+    return json.dumps(obj, separators=(",", ":"), ensure_ascii=False).encode("utf-8")
+
+
 class _EncoderBase(object):
     """
     Encoder interface that provides the logic to encode traces and service.
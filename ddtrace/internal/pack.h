@@ -35,6 +35,86 @@ typedef struct msgpack_packer
 
 typedef struct Packer Packer;
 
+/* Recycled buffer pool. Encode buffers grow towards the workload's steady
+ * payload size, so recycling them across packers means new encoders start
+ * from a warm, right-sized buffer instead of growing through a series of
+ * realloc+memcpy on every run. Buffers are size-classed by power of two;
+ * sizes are kept powers of two throughout (acquisition rounds up, growth
+ * doubles) so a buffer always sits in exactly one class. Every caller holds
+ * the GIL, which serializes access to the pool. */
+#define MSGPACK_POOL_MIN_SHIFT 12 /* 4 KiB */
+#define MSGPACK_POOL_MAX_SHIFT 24 /* 16 MiB; larger buffers are freed, not pooled */
+#define MSGPACK_POOL_CLASS_COUNT (MSGPACK_POOL_MAX_SHIFT - MSGPACK_POOL_MIN_SHIFT + 1)
+#define MSGPACK_POOL_PER_CLASS 4
+
+static char* msgpack_pool[MSGPACK_POOL_CLASS_COUNT][MSGPACK_POOL_PER_CLASS];
+static int msgpack_pool_count[MSGPACK_POOL_CLASS_COUNT];
+
+/* Round up to the smallest poolable power of two */
+static inline size_t
+msgpack_pool_roundup(size_t n)
+{
+    size_t size = (size_t)1 << MSGPACK_POOL_MIN_SHIFT;
+    while (size < n)
+        size <<= 1;
+    return size;
+}
+
+/* Size class of a pooled buffer size, or -1 if it is not poolable */
+static inline int
+msgpack_pool_class(size_t size)
+{
+    for (int c = 0; c < MSGPACK_POOL_CLASS_COUNT; c++) {
+        if (size == (size_t)1 << (MSGPACK_POOL_MIN_SHIFT + c))
+            return c;
+    }
+    return -1;
+}
+
+/* Set up a packer with a buffer of at least `min_size` bytes, taking the
+ * smallest suitable recycled buffer if the pool has one. Returns -1 without
+ * setting an exception on allocation failure. */
+static inline int
+msgpack_packer_init(msgpack_packer* pk, size_t min_size)
+{
+    size_t size = msgpack_pool_roundup(min_size);
+
+    pk->length = 0;
+
+    for (int c = msgpack_pool_class(size); c >= 0 && c < MSGPACK_POOL_CLASS_COUNT; c++) {
+        if (msgpack_pool_count[c] > 0) {
+            pk->buf = msgpack_pool[c][--msgpack_pool_count[c]];
+            pk->buf_size = (size_t)1 << (MSGPACK_POOL_MIN_SHIFT + c);
+            return 0;
+        }
+    }
+
+    pk->buf = (char*)PyMem_Malloc(size);
+    if (pk->buf == NULL) {
+        pk->buf_size = 0;
+        return -1;
+    }
+    pk->buf_size = size;
+    return 0;
+}
+
+/* Release a packer's buffer back to the pool, or free it if its class is
+ * already fully stocked (or it is too large to be worth keeping around) */
+static inline void
+msgpack_packer_destroy(msgpack_packer* pk)
+{
+    if (pk->buf != NULL) {
+        int c = msgpack_pool_class(pk->buf_size);
+        if (c >= 0 && msgpack_pool_count[c] < MSGPACK_POOL_PER_CLASS)
+            msgpack_pool[c][msgpack_pool_count[c]++] = pk->buf;
+        else
+            PyMem_Free(pk->buf);
+        pk->buf = NULL;
+    }
+    pk->buf_size = 0;
+    pk->length = 0;
+}
+
 static inline int
 msgpack_pack_write(msgpack_packer* pk, const char* data, size_t l)
 {
@@ -43,7 +123,8 @@ msgpack_pack_write(msgpack_packer* pk, const char* data, size_t l)
     size_t len = pk->length;
 
     if (len + l > bs) {
-        bs = (len + l) * 2;
+        /* Power-of-two growth keeps buffer sizes poolable */
+        bs = msgpack_pool_roundup(len + l);
         buf = (char*)PyMem_Realloc(buf, bs);
         if (!buf) {
             PyErr_NoMemory();
@@ -59,10 +140,316 @@ msgpack_pack_write(msgpack_packer* pk, const char* data, size_t l)
     return 0;
 }
 
+/* Ensure capacity for `l` more bytes without writing anything; callers then
+ * emit directly into pk->buf + pk->length. This is what lets the bulk
+ * emitters in pack_template.h pay a single bounds check for a whole batch. */
+static inline int
+msgpack_pack_reserve(msgpack_packer* pk, size_t l)
+{
+    if (pk->length + l > pk->buf_size) {
+        size_t bs = msgpack_pool_roundup(pk->length + l);
+        char* buf = (char*)PyMem_Realloc(pk->buf, bs);
+        if (!buf) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        pk->buf = buf;
+        pk->buf_size = bs;
+    }
+    return 0;
+}
+
 #define msgpack_pack_append_buffer(user, buf, len) return msgpack_pack_write(user, (const char*)buf, len)
 
 #include "pack_template.h"
 
+/*
+ * JSON emission on the packer buffer
+ */
+
+/* The telemetry intake speaks JSON rather than msgpack, but its payloads are
+ * the same shape of work: many small strings and numbers appended to one
+ * growing buffer. These helpers emit JSON scalars straight into a
+ * msgpack_packer so the telemetry encoder gets the pooled, reservation-based
+ * buffer machinery for free; the container recursion lives with the other
+ * encoders in _encoding.pyx. */
+
+/* Quoted, escaped JSON string from a unicode object. Non-ASCII passes
+ * through as raw UTF-8 (valid JSON, and smaller than \u escapes); only
+ * quotes, backslashes and control characters are escaped, matching what the
+ * stdlib encoder produces for ASCII input. */
+static inline int
+json_pack_str(msgpack_packer* pk, PyObject* o)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    Py_ssize_t len;
+    const char* buf;
+
+    if (PyUnicode_IS_COMPACT_ASCII(o)) {
+        len = PyUnicode_GET_LENGTH(o);
+        buf = (const char*)PyUnicode_1BYTE_DATA(o);
+    } else {
+        buf = PyUnicode_AsUTF8AndSize(o, &len);
+        if (buf == NULL)
+            return -1;
+    }
+
+    /* Worst case: every byte escapes to \u00xx, plus the quotes */
+    if (msgpack_pack_reserve(pk, 2 + (size_t)len * 6) != 0)
+        return -1;
+
+    char* p = pk->buf + pk->length;
+    *p++ = '"';
+    for (Py_ssize_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)buf[i];
+        if (c == '"' || c == '\\') {
+            *p++ = '\\';
+            *p++ = (char)c;
+        } else if (c >= 0x20) {
+            *p++ = (char)c;
+        } else {
+            *p++ = '\\';
+            switch (c) {
+                case '\b':
+                    *p++ = 'b';
+                    break;
+                case '\t':
+                    *p++ = 't';
+                    break;
+                case '\n':
+                    *p++ = 'n';
+                    break;
+                case '\f':
+                    *p++ = 'f';
+                    break;
+                case '\r':
+                    *p++ = 'r';
+                    break;
+                default:
+                    *p++ = 'u';
+                    *p++ = '0';
+                    *p++ = '0';
+                    *p++ = hex[c >> 4];
+                    *p++ = hex[c & 0xf];
+            }
+        }
+    }
+    *p++ = '"';
+    pk->length = (size_t)(p - pk->buf);
+    return 0;
+}
+
+static inline int
+json_pack_ll(msgpack_packer* pk, long long v)
+{
+    char buf[24];
+    char* p = buf + sizeof(buf);
+    unsigned long long u = v < 0 ? (unsigned long long)-(v + 1) + 1 : (unsigned long long)v;
+
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (v < 0)
+        *--p = '-';
+    return msgpack_pack_write(pk, p, (size_t)(buf + sizeof(buf) - p));
+}
+
+/* Match the stdlib encoder: repr-shortest float formatting, and its
+ * (non-standard) NaN/Infinity spellings */
+static inline int
+json_pack_double(msgpack_packer* pk, double d)
+{
+    if (Py_IS_NAN(d))
+        return msgpack_pack_write(pk, "NaN", 3);
+    if (Py_IS_INFINITY(d))
+        return d > 0 ? msgpack_pack_write(pk, "Infinity", 8) : msgpack_pack_write(pk, "-Infinity", 9);
+
+    char* s = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+    if (s == NULL)
+        return -1;
+    int ret = msgpack_pack_write(pk, s, strlen(s));
+    PyMem_Free(s);
+    return ret;
+}
+
+/*
+ * Native string-id cache for the v0.5 string table
+ */
+
+/* Open-addressing map from Python string objects to their string-table index,
+ * with the msgpack encoding of the index pre-computed at insert time. The
+ * v0.5 encoder resolves a handful of distinct strings tens of thousands of
+ * times per payload (tag keys, service/resource names are almost always the
+ * same interned objects); a hit here is one pointer probe plus one canned-
+ * bytes copy, with no dict lookup and no boxed integer in between. Identity
+ * is the match criterion, so the cache sits in front of the dict-backed
+ * table rather than replacing it: value-equal but distinct objects miss and
+ * fall back to the dict, which stays the source of truth for ids. Entries
+ * hold a strong reference to their key so the pointer can never be reused by
+ * another object while cached. Every caller holds the GIL. */
+typedef struct msgpack_strtable_entry
+{
+    PyObject* key; /* strong reference; NULL marks an empty slot */
+    uint32_t id;
+    uint8_t canned_len;
+    char canned[5]; /* pre-encoded msgpack uint of `id` */
+} msgpack_strtable_entry;
+
+typedef struct msgpack_strtable
+{
+    msgpack_strtable_entry* slots;
+    size_t mask; /* slot count - 1; the slot count is a power of two */
+    size_t count;
+} msgpack_strtable;
+
+#define MSGPACK_STRTABLE_MIN_SLOTS 512
+
+/* Multiplicative hash on the object address with linear probing; returns the
+ * entry holding `key`, or the empty slot where it would go */
+static inline msgpack_strtable_entry*
+msgpack_strtable_probe(msgpack_strtable* t, PyObject* key)
+{
+    size_t i = (size_t)(((uintptr_t)key >> 4) * (uintptr_t)2654435761UL) & t->mask;
+    while (t->slots[i].key != NULL && t->slots[i].key != key)
+        i = (i + 1) & t->mask;
+    return &t->slots[i];
+}
+
+/* Returns -1 without setting an exception on allocation failure */
+static inline int
+msgpack_strtable_init(msgpack_strtable* t)
+{
+    t->slots = (msgpack_strtable_entry*)PyMem_Calloc(MSGPACK_STRTABLE_MIN_SLOTS, sizeof(msgpack_strtable_entry));
+    if (t->slots == NULL)
+        return -1;
+    t->mask = MSGPACK_STRTABLE_MIN_SLOTS - 1;
+    t->count = 0;
+    return 0;
+}
+
+static inline void
+msgpack_strtable_clear(msgpack_strtable* t)
+{
+    for (size_t i = 0; i <= t->mask; i++) {
+        Py_XDECREF(t->slots[i].key);
+        t->slots[i].key = NULL;
+    }
+    t->count = 0;
+}
+
+static inline void
+msgpack_strtable_destroy(msgpack_strtable* t)
+{
+    if (t->slots != NULL) {
+        msgpack_strtable_clear(t);
+        PyMem_Free(t->slots);
+        t->slots = NULL;
+    }
+    t->mask = 0;
+    t->count = 0;
+}
+
+static inline int
+msgpack_strtable_grow(msgpack_strtable* t)
+{
+    size_t old_n = t->mask + 1;
+    msgpack_strtable_entry* old = t->slots;
+    msgpack_strtable_entry* slots = (msgpack_strtable_entry*)PyMem_Calloc(old_n * 2, sizeof(msgpack_strtable_entry));
+    if (slots == NULL)
+        return -1;
+    t->slots = slots;
+    t->mask = old_n * 2 - 1;
+    for (size_t i = 0; i < old_n; i++) {
+        if (old[i].key != NULL)
+            *msgpack_strtable_probe(t, old[i].key) = old[i];
+    }
+    PyMem_Free(old);
+    return 0;
+}
+
+/* Record `key` -> `id`, pre-encoding the msgpack uint for `id` so later hits
+ * are a single canned-bytes copy. Takes a new reference to `key`. Returns -1
+ * without setting an exception on allocation failure. */
+static inline int
+msgpack_strtable_insert(msgpack_strtable* t, PyObject* key, uint32_t id)
+{
+    /* Keep the load factor under 3/4 so probe chains stay short */
+    if ((t->count + 1) * 4 > (t->mask + 1) * 3 && msgpack_strtable_grow(t) != 0)
+        return -1;
+
+    msgpack_strtable_entry* e = msgpack_strtable_probe(t, key);
+    if (e->key == NULL) {
+        Py_INCREF(key);
+        e->key = key;
+        t->count++;
+    }
+    e->id = id;
+
+    unsigned char* p = (unsigned char*)e->canned;
+    if (id < (1U << 7)) {
+        *p++ = (uint8_t)id;
+    } else if (id < (1U << 8)) {
+        *p++ = 0xcc;
+        *p++ = (uint8_t)id;
+    } else if (id < (1U << 16)) {
+        *p++ = 0xcd;
+        _msgpack_store16(p, (uint16_t)id);
+        p += 2;
+    } else {
+        *p++ = 0xce;
+        _msgpack_store32(p, id);
+        p += 4;
+    }
+    e->canned_len = (uint8_t)(p - (unsigned char*)e->canned);
+    return 0;
+}
+
+/* Emit the canned index bytes for `key` if it is cached. Returns 1 on a
+ * miss, so the caller can resolve the id through the Python-level table and
+ * then insert it here. */
+static inline int
+msgpack_strtable_pack(msgpack_strtable* t, msgpack_packer* pk, PyObject* key)
+{
+    msgpack_strtable_entry* e = msgpack_strtable_probe(t, key);
+    if (e->key == NULL)
+        return 1;
+    return msgpack_pack_write(pk, e->canned, e->canned_len);
+}
+
+/* Drop every entry whose id is at or past `first_id`: a rollback un-assigns
+ * those ids, and stale canned bytes would alias whatever string claims the
+ * id next. Open addressing cannot delete in place, so the live entries are
+ * rehashed into a fresh array; if that allocation fails, dropping the whole
+ * cache is always safe. */
+static inline void
+msgpack_strtable_evict_from(msgpack_strtable* t, uint32_t first_id)
+{
+    size_t n = t->mask + 1;
+    msgpack_strtable_entry* old = t->slots;
+    msgpack_strtable_entry* slots = (msgpack_strtable_entry*)PyMem_Calloc(n, sizeof(msgpack_strtable_entry));
+
+    if (slots == NULL) {
+        msgpack_strtable_clear(t);
+        return;
+    }
+
+    t->slots = slots;
+    t->count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (old[i].key == NULL)
+            continue;
+        if (old[i].id < first_id) {
+            *msgpack_strtable_probe(t, old[i].key) = old[i];
+            t->count++;
+        } else {
+            Py_DECREF(old[i].key);
+        }
+    }
+    PyMem_Free(old);
+}
+
 // return -2 when o is too long
 static inline int
 msgpack_pack_unicode(msgpack_packer* pk, PyObject* o, long long limit)
@@ -71,19 +458,37 @@ msgpack_pack_unicode(msgpack_packer* pk, PyObject* o, long long limit)
     assert(PyUnicode_Check(o));
 
     Py_ssize_t len;
-    const char* buf = PyUnicode_AsUTF8AndSize(o, &len);
-    if (buf == NULL)
-        return -1;
+    const char* buf;
+
+    /* Compact ASCII data is its own UTF-8, so the in-object bytes can be
+     * copied straight into the stream. Nearly all tag data lands here; only
+     * non-ASCII (and legacy non-compact) strings go through
+     * PyUnicode_AsUTF8AndSize, which encodes into the object's cached UTF-8
+     * representation on first use. */
+    if (PyUnicode_IS_COMPACT_ASCII(o)) {
+        len = PyUnicode_GET_LENGTH(o);
+        buf = (const char*)PyUnicode_1BYTE_DATA(o);
+    } else {
+        buf = PyUnicode_AsUTF8AndSize(o, &len);
+        if (buf == NULL)
+            return -1;
+    }
 
     if (len > limit) {
         return -2;
     }
 
-    int ret = msgpack_pack_raw(pk, len);
-    if (ret)
-        return ret;
+    /* Header and body in one reservation: one bounds check per string
+     * instead of two */
+    size_t h = msgpack_pack_raw_header_size((size_t)len);
+    if (msgpack_pack_reserve(pk, h + (size_t)len) != 0)
+        return -1;
 
-    return msgpack_pack_raw_body(pk, buf, len);
+    unsigned char* p = (unsigned char*)pk->buf + pk->length;
+    p += msgpack_pack_raw_header_at(p, (size_t)len);
+    memcpy(p, buf, (size_t)len);
+    pk->length += h + (size_t)len;
+    return 0;
 #else
     PyObject* bytes;
     Py_ssize_t len;
@@ -727,6 +727,144 @@ msgpack_pack_raw_body(msgpack_packer* x, const void* b, size_t l)
     return 0;
 }
 
+/*
+ * Bulk emission
+ */
+
+typedef struct msgpack_string_view
+{
+    const char* data;
+    size_t length;
+} msgpack_string_view;
+
+/* Encoded size of the str header for a string of length l */
+static inline size_t
+msgpack_pack_raw_header_size(size_t l)
+{
+    return l < 32 ? 1 : l < 256 ? 2 : l < 65536 ? 3 : 5;
+}
+
+/* Write a str header at p, unchecked; returns the header size */
+static inline size_t
+msgpack_pack_raw_header_at(unsigned char* p, size_t l)
+{
+    if (l < 32) {
+        p[0] = 0xa0 | (uint8_t)l;
+        return 1;
+    } else if (l < 256) {
+        p[0] = 0xd9;
+        p[1] = (uint8_t)l;
+        return 2;
+    } else if (l < 65536) {
+        p[0] = 0xda;
+        _msgpack_store16(&p[1], (uint16_t)l);
+        return 3;
+    } else {
+        p[0] = 0xdb;
+        _msgpack_store32(&p[1], (uint32_t)l);
+        return 5;
+    }
+}
+
+/* Pack an array of strings as consecutive str values in one call: total
+ * encoded length is computed up front, the buffer reserved once, and headers
+ * and bodies written back to back. Emitting span tag key/value pairs this way
+ * replaces a bounds-checked write per string with one per batch. The output
+ * is byte-identical to packing each string through msgpack_pack_raw. */
+static inline int
+msgpack_pack_str_array(msgpack_packer* x, const msgpack_string_view* views, size_t n)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+        total += msgpack_pack_raw_header_size(views[i].length) + views[i].length;
+
+    if (msgpack_pack_reserve(x, total) != 0)
+        return -1;
+
+    unsigned char* p = (unsigned char*)x->buf + x->length;
+    for (size_t i = 0; i < n; i++) {
+        p += msgpack_pack_raw_header_at(p, views[i].length);
+        memcpy(p, views[i].data, views[i].length);
+        p += views[i].length;
+    }
+    x->length += total;
+    return 0;
+}
+
+/* Emit a fixstr key (length < 32) followed by an unsigned value with a single
+ * reservation and back-to-back stores: the fixed per-span numeric fields
+ * (span/trace ids, timestamps) pay one bounds check instead of four. The
+ * value keeps the minimal encoding the generic packer would pick. */
+static inline int
+msgpack_pack_kv_uint64(msgpack_packer* x, const char* key, size_t key_len, uint64_t d)
+{
+    if (key_len >= 32)
+        return -1;
+    if (msgpack_pack_reserve(x, 1 + key_len + 9) != 0)
+        return -1;
+
+    unsigned char* p = (unsigned char*)x->buf + x->length;
+    *p++ = 0xa0 | (uint8_t)key_len;
+    memcpy(p, key, key_len);
+    p += key_len;
+
+    if (d < (1ULL << 7)) {
+        *p++ = (uint8_t)d;
+    } else if (d < (1ULL << 8)) {
+        *p++ = 0xcc;
+        *p++ = (uint8_t)d;
+    } else if (d < (1ULL << 16)) {
+        *p++ = 0xcd;
+        _msgpack_store16(p, (uint16_t)d);
+        p += 2;
+    } else if (d < (1ULL << 32)) {
+        *p++ = 0xce;
+        _msgpack_store32(p, (uint32_t)d);
+        p += 4;
+    } else {
+        *p++ = 0xcf;
+        _msgpack_store64(p, d);
+        p += 8;
+    }
+
+    x->length = (size_t)((char*)p - x->buf);
+    return 0;
+}
+
+/*
+ * Pre-encoded fragments
+ */
+
+/* A canned msgpack value, encoded once and then copied into the stream with a
+ * single memcpy. Sized for a fixstr/str 8 header plus the longest of the
+ * well-known span map keys; interned keys and common static values are
+ * encoded into fragments at module init instead of re-encoding the same
+ * bytes for every span. */
+typedef struct msgpack_fragment
+{
+    size_t length;
+    char bytes[40];
+} msgpack_fragment;
+
+/* Encode a str value into a fragment; returns -1 if it does not fit */
+static inline int
+msgpack_fragment_init_str(msgpack_fragment* f, const char* s, size_t l)
+{
+    size_t h = msgpack_pack_raw_header_size(l);
+    if (h + l > sizeof(f->bytes))
+        return -1;
+    msgpack_pack_raw_header_at((unsigned char*)f->bytes, l);
+    memcpy(f->bytes + h, s, l);
+    f->length = h + l;
+    return 0;
+}
+
+static inline int
+msgpack_pack_fragment(msgpack_packer* x, const msgpack_fragment* f)
+{
+    return msgpack_pack_write(x, f->bytes, f->length);
+}
+
 #undef msgpack_pack_append_buffer
 
 #undef TAKE8_8
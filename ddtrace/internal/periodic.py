@@ -6,6 +6,12 @@ from ddtrace.internal import forksafe
 from ddtrace.internal import service
 from ddtrace.internal._threads import PeriodicThread
 from ddtrace.internal._threads import periodic_threads
+from ddtrace.internal._threads import shutdown as _shutdown_periodic_threads
+
+
+# Upper bound on the native shutdown wait, in seconds. Threads still running
+# when it expires are abandoned rather than holding up interpreter exit.
+SHUTDOWN_TIMEOUT = 5.0
 
 
 @atexit.register
@@ -16,8 +22,10 @@ def _():
     # the acquiring thread to be terminated with pthread_exit (on Linux). This
     # causes a SIGABRT with GCC that cannot be caught, so we need to avoid
     # getting to that stage.
-    for thread in periodic_threads.values():
-        thread._atexit()
+    # All threads are signalled to stop first and then waited on against a
+    # single deadline, so the total wait is bounded by the slowest callback
+    # still in flight instead of the sum of the individual joins.
+    _shutdown_periodic_threads(timeout=SHUTDOWN_TIMEOUT)
 
 
 @forksafe.register
@@ -31,6 +39,12 @@ def _():
 class PeriodicService(service.Service):
     """A service that runs periodically."""
 
+    # Scheduling slack, in seconds. The shared scheduler may run the periodic
+    # function this much ahead of its deadline to batch it with other due
+    # tasks under a single GIL acquisition. Services that need precise
+    # intervals should set this to 0.
+    _slack = 0.05
+
     def __init__(self, interval: float = 0.0) -> None:
         super().__init__()
         self._interval = interval
@@ -60,6 +74,7 @@ class PeriodicService(service.Service):
             target=self.periodic,
             name="%s:%s" % (self.__class__.__module__, self.__class__.__name__),
             on_shutdown=self.on_shutdown,
+            slack=self._slack,
         )
         self._worker.start()
 
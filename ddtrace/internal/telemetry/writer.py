@@ -20,7 +20,7 @@ from ...internal import forksafe
 from ..agent import get_connection
 from ..agent import get_trace_url
 from ..compat import get_connection_response
-from ..encoding import JSONEncoderV2
+from ..encoding import json_encode
 from ..periodic import PeriodicService
 from ..runtime import container
 from ..runtime import get_runtime_id
@@ -87,7 +87,6 @@ class _TelemetryClient:
         # type: (bool) -> None
         self._telemetry_url = self.get_host(_TelemetryConfig.SITE, agentless)
         self._endpoint = self.get_endpoint(agentless)
-        self._encoder = JSONEncoderV2()
         self._agentless = agentless
 
         self._headers = {
@@ -108,7 +107,7 @@ class _TelemetryClient:
         resp = None
         conn = None
         try:
-            rb_json, _ = self._encoder.encode(request)
+            rb_json = json_encode(request)
             headers = self.get_headers(request)
             with StopWatch() as sw:
                 conn = get_connection(self._telemetry_url)
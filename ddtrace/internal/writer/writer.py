@@ -40,6 +40,13 @@ from .writer_client import AgentWriterClientV4
 from .writer_client import WriterClientBase
 
 
+try:
+    from .._spool import Spool
+except ImportError:
+    # Windows, or the extension was not built
+    Spool = None  # type: ignore[assignment,misc]
+
+
 if TYPE_CHECKING:  # pragma: no cover
     from typing import Any  # noqa:F401
     from typing import Tuple  # noqa:F401
@@ -175,6 +182,13 @@ class HTTPWriter(periodic.PeriodicService, TraceWriter):
         # force a flush with `flush_queue()`.
         self._conn_lck: threading.RLock = threading.RLock()
 
+        # Disk spool for payloads that failed to send; set up by subclasses
+        # that opt in (see AgentWriter). Locked for the same reason as the
+        # connection: flush_queue() may race with the periodic thread.
+        self._spool = None
+        self._spool_path: Optional[str] = None
+        self._spool_lck: threading.Lock = threading.Lock()
+
         self._send_payload_with_backoff = fibonacci_backoff_with_jitter(  # type ignore[assignment]
             attempts=self.RETRY_ATTEMPTS,
             initial_wait=0.618 * self.interval / (1.618**self.RETRY_ATTEMPTS) / 2,
@@ -380,21 +394,78 @@ class HTTPWriter(periodic.PeriodicService, TraceWriter):
             self._send_payload_with_backoff(encoded, n_traces, client)
         except Exception:
             self._metrics_dist("http.errors", tags=["type:err"])
-            self._metrics_dist("http.dropped.bytes", len(encoded))
-            self._metrics_dist("http.dropped.traces", n_traces)
+            if not self._spool_payload(encoded, n_traces):
+                self._metrics_dist("http.dropped.bytes", len(encoded))
+                self._metrics_dist("http.dropped.traces", n_traces)
+                if not raise_exc:
+                    log.error(
+                        "failed to send, dropping %d traces to intake at %s after %d retries",
+                        n_traces,
+                        self._intake_endpoint(client),
+                        self.RETRY_ATTEMPTS,
+                    )
             if raise_exc:
                 raise
-            else:
-                log.error(
-                    "failed to send, dropping %d traces to intake at %s after %d retries",
-                    n_traces,
-                    self._intake_endpoint(client),
-                    self.RETRY_ATTEMPTS,
-                )
+        else:
+            # The intake is reachable again: replay anything parked on disk
+            self._drain_spool(client)
         finally:
             self._metrics_dist("http.sent.bytes", len(encoded))
             self._metrics_dist("http.sent.traces", n_traces)
 
+    def _spool_payload(self, encoded: bytes, n_traces: int) -> bool:
+        """Park an unsendable payload on disk; return whether it was spooled."""
+        if self._spool is None:
+            return False
+        try:
+            with self._spool_lck:
+                evicted = self._spool.append(encoded, n_traces)
+        except (ValueError, OSError):
+            log.error("failed to spool %d traces to %s", n_traces, self._spool_path, exc_info=True)
+            return False
+        if evicted:
+            self._metrics_dist("spool.evicted.payloads", evicted)
+        self._metrics_dist("spool.appended.bytes", len(encoded))
+        log.warning(
+            "failed to send %d traces to intake at %s after %d retries, spooled to disk",
+            n_traces,
+            self._intake_endpoint(),
+            self.RETRY_ATTEMPTS,
+        )
+        return True
+
+    def _drain_spool(self, client: WriterClientBase) -> None:
+        if self._spool is None:
+            return
+        while True:
+            with self._spool_lck:
+                record = self._spool.peek()
+            if record is None:
+                return
+            payload, count = record
+            try:
+                self._send_payload_with_backoff(payload, count, client)
+            except Exception:
+                # The intake went away again; keep the record for the next cycle
+                return
+            with self._spool_lck:
+                self._spool.drop()
+            self._metrics_dist("spool.drained.bytes", len(payload))
+
+    def _close_spool(self) -> None:
+        if self._spool is None:
+            return
+        with self._spool_lck:
+            try:
+                empty = len(self._spool) == 0
+                self._spool.close()
+                # An empty spool has nothing to offer a future process
+                if empty and self._spool_path is not None:
+                    os.unlink(self._spool_path)
+            except (ValueError, OSError):
+                log.debug("failed to close trace spool at %s", self._spool_path, exc_info=True)
+            self._spool = None
+
     def periodic(self):
         self.flush_queue(raise_exc=False)
 
@@ -411,6 +482,7 @@ class HTTPWriter(periodic.PeriodicService, TraceWriter):
             self.periodic()
         finally:
             self._reset_connection()
+            self._close_spool()
 
 
 class AgentResponse(object):
@@ -502,6 +574,7 @@ class AgentWriter(HTTPWriter):
             _headers.update(parse_tags_str(additional_header_str))
         self._response_cb = response_callback
         self._report_metrics = report_metrics
+        self._spool_dir = config._trace_writer_spool_dir
         super(AgentWriter, self).__init__(
             intake_url=agent_url,
             clients=[client],
@@ -515,6 +588,22 @@ class AgentWriter(HTTPWriter):
             headers=_headers,
             report_metrics=report_metrics,
         )
+        if self._spool_dir and Spool is not None:
+            # One spool file per process: the MAP_SHARED mapping cannot be
+            # shared safely across processes, and the name keys the payload
+            # encoding so a reopened spool only replays compatible records.
+            # After a fork the writer is recreated, so the child derives its
+            # own file from its own PID.
+            self._spool_path = os.path.join(
+                self._spool_dir, "ddtrace-%s-%s.spool" % (os.getpid(), self._api_version)
+            )
+            try:
+                self._spool = Spool(self._spool_path, config._trace_writer_spool_size)
+            except (ValueError, OSError):
+                log.warning(
+                    "failed to open trace spool at %s, disk spooling disabled", self._spool_path, exc_info=True
+                )
+                self._spool_path = None
 
     def recreate(self):
         # type: () -> HTTPWriter
@@ -542,6 +631,10 @@ class AgentWriter(HTTPWriter):
     def _downgrade(self, response, client):
         if client.ENDPOINT == "v0.5/traces":
             self._clients = [AgentWriterClientV4(self._buffer_size, self._max_payload_size)]
+            if self._spool is not None:
+                # Spooled payloads are v0.5-encoded and can no longer be replayed
+                with self._spool_lck:
+                    self._spool.clear()
             # Since we have to change the encoding in this case, the payload
             # would need to be converted to the downgraded encoding before
             # sending it, but we chuck it away instead.
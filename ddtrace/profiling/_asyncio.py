@@ -29,6 +29,15 @@ def _task_get_name(task):
     return "Task-%d" % id(task)
 
 
+def _unlink_task(task):
+    # Done-callback for gathered tasks; drops the native parent link so completed tasks
+    # do not accumulate in the sampler for the lifetime of the process.
+    try:
+        stack_v2.unlink_tasks(task)
+    except Exception:
+        pass
+
+
 @ModuleWatchdog.after_module_imported("asyncio")
 def _(asyncio):
     # type: (ModuleType) -> None
@@ -79,6 +88,7 @@ def _(asyncio):
                 parent = globals()["current_task"](loop)
                 for child in children:
                     stack_v2.link_tasks(parent, child)
+                    child.add_done_callback(_unlink_task)
 
         if sys.hexversion >= 0x030C0000:
             scheduled_tasks = asyncio.tasks._scheduled_tasks.data
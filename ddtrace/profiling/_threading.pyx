@@ -70,11 +70,13 @@ cpdef get_thread_by_id(thread_id):
 
 
 cpdef get_thread_name(thread_id):
-    try:
-        return periodic_threads[thread_id].name
-    except KeyError:
-        thread = get_thread_by_id(thread_id)
-        return thread.name if thread is not None else None
+    # periodic_threads is keyed by object identity since all the periodic
+    # tasks share one native thread, so match on the reported ident instead
+    name = next((pt.name for pt in periodic_threads.values() if pt.ident == thread_id), None)
+    if name is not None:
+        return name
+    thread = get_thread_by_id(thread_id)
+    return thread.name if thread is not None else None
 
 
 cpdef get_thread_native_id(thread_id):
@@ -94,6 +94,7 @@ class _ProfiledLock(wrapt.ObjectProxy):
         capture_sampler: collector.CaptureSampler,
         endpoint_collection_enabled: bool,
         export_libdd_enabled: bool,
+        batch: typing.Optional[typing.Any] = None,
     ) -> None:
         wrapt.ObjectProxy.__init__(self, wrapped)
         self._self_recorder = recorder
@@ -102,6 +103,9 @@ class _ProfiledLock(wrapt.ObjectProxy):
         self._self_capture_sampler = capture_sampler
         self._self_endpoint_collection_enabled = endpoint_collection_enabled
         self._self_export_libdd_enabled = export_libdd_enabled
+        # Shared with every lock the collector wraps; events are appended here
+        # and cross the native boundary in batches instead of one flush per event
+        self._self_batch = batch
         frame = sys._getframe(2 if WRAPT_C_EXT else 3)
         code = frame.f_code
         self._self_init_loc = "%s:%d" % (os.path.basename(code.co_filename), frame.f_lineno)
@@ -139,20 +143,35 @@ class _ProfiledLock(wrapt.ObjectProxy):
 
                 if self._self_export_libdd_enabled:
                     thread_native_id = _threading.get_thread_native_id(thread_id)
-
-                    handle = ddup.SampleHandle()
-                    handle.push_monotonic_ns(end)
-                    handle.push_lock_name(lock_name)
-                    handle.push_acquire(end - start, 1)  # AFAICT, capture_pct does not adjust anything here
-                    handle.push_threadinfo(thread_id, thread_native_id, thread_name)
-                    handle.push_task_id(task_id)
-                    handle.push_task_name(task_name)
-
-                    if self._self_tracer is not None:
-                        handle.push_span(self._self_tracer.current_span())
-                    for frame in frames:
-                        handle.push_frame(frame.function_name, frame.file_name, 0, frame.lineno)
-                    handle.flush_sample()
+                    span = self._self_tracer.current_span() if self._self_tracer is not None else None
+
+                    if self._self_batch is not None:
+                        # AFAICT, capture_pct does not adjust anything here
+                        self._self_batch.add_lock_event(
+                            lock_name,
+                            end - start,
+                            0,
+                            end,
+                            thread_id,
+                            thread_native_id,
+                            thread_name,
+                            task_id,
+                            task_name,
+                            span,
+                            frames,
+                        )
+                    else:
+                        handle = ddup.SampleHandle()
+                        handle.push_monotonic_ns(end)
+                        handle.push_lock_name(lock_name)
+                        handle.push_acquire(end - start, 1)  # AFAICT, capture_pct does not adjust anything here
+                        handle.push_threadinfo(thread_id, thread_native_id, thread_name)
+                        handle.push_task_id(task_id)
+                        handle.push_task_name(task_name)
+                        handle.push_span(span)
+                        for frame in frames:
+                            handle.push_frame(frame.function_name, frame.file_name, 0, frame.lineno)
+                        handle.flush_sample()
                 else:
                     event = self.ACQUIRE_EVENT_CLASS(
                         lock_name=lock_name,
@@ -202,22 +221,37 @@ class _ProfiledLock(wrapt.ObjectProxy):
 
                         if self._self_export_libdd_enabled:
                             thread_native_id = _threading.get_thread_native_id(thread_id)
-
-                            handle = ddup.SampleHandle()
-                            handle.push_monotonic_ns(end)
-                            handle.push_lock_name(lock_name)
-                            handle.push_release(
-                                end - self._self_acquired_at, 1
-                            )  # AFAICT, capture_pct does not adjust anything here
-                            handle.push_threadinfo(thread_id, thread_native_id, thread_name)
-                            handle.push_task_id(task_id)
-                            handle.push_task_name(task_name)
-
-                            if self._self_tracer is not None:
-                                handle.push_span(self._self_tracer.current_span())
-                            for frame in frames:
-                                handle.push_frame(frame.function_name, frame.file_name, 0, frame.lineno)
-                            handle.flush_sample()
+                            span = self._self_tracer.current_span() if self._self_tracer is not None else None
+
+                            if self._self_batch is not None:
+                                # AFAICT, capture_pct does not adjust anything here
+                                self._self_batch.add_lock_event(
+                                    lock_name,
+                                    0,
+                                    end - self._self_acquired_at,
+                                    end,
+                                    thread_id,
+                                    thread_native_id,
+                                    thread_name,
+                                    task_id,
+                                    task_name,
+                                    span,
+                                    frames,
+                                )
+                            else:
+                                handle = ddup.SampleHandle()
+                                handle.push_monotonic_ns(end)
+                                handle.push_lock_name(lock_name)
+                                handle.push_release(
+                                    end - self._self_acquired_at, 1
+                                )  # AFAICT, capture_pct does not adjust anything here
+                                handle.push_threadinfo(thread_id, thread_native_id, thread_name)
+                                handle.push_task_id(task_id)
+                                handle.push_task_name(task_name)
+                                handle.push_span(span)
+                                for frame in frames:
+                                    handle.push_frame(frame.function_name, frame.file_name, 0, frame.lineno)
+                                handle.flush_sample()
                         else:
                             event = self.RELEASE_EVENT_CLASS(
                                 lock_name=lock_name,
@@ -336,6 +370,10 @@ class LockCollector(collector.CaptureSamplerCollector):
         # Check if libdd is available, if not, disable the feature
         if self.export_libdd_enabled and not ddup.is_available:
             self.export_libdd_enabled = False
+        # One event batch shared by every lock this collector wraps; appends
+        # are GIL-serialized and the batch drains to the native side when full
+        # and before each upload
+        self._batch = ddup.LockEventBatch(max_nframes=self.nframes) if self.export_libdd_enabled else None
 
     @abc.abstractmethod
     def _get_original(self):
@@ -361,6 +399,8 @@ class LockCollector(collector.CaptureSamplerCollector):
         """Stop collecting lock usage."""
         super(LockCollector, self)._stop_service()
         self.unpatch()
+        if self._batch is not None:
+            self._batch.flush()
 
     def patch(self):
         # type: (...) -> None
@@ -379,6 +419,7 @@ class LockCollector(collector.CaptureSamplerCollector):
                 self._capture_sampler,
                 self.endpoint_collection_enabled,
                 self.export_libdd_enabled,
+                self._batch,
             )
 
         self._set_original(FunctionWrapper(self.original, _allocate_lock))
@@ -1,6 +1,9 @@
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
@@ -20,6 +23,14 @@ typedef struct
     uint16_t max_events;
     /* The maximum number of frames collected in stack traces */
     uint16_t max_nframe;
+    /* Target number of captured allocation events per second; 0 captures
+       every allocation */
+    uint32_t events_per_sec;
+    /* Byte budget for traceback storage; 0 means unbounded. The event count
+       cap alone makes memory usage depend on stack depth; this caps it at an
+       absolute figure, evicting the least recently seen events when a new
+       capture would go over. */
+    uint64_t max_alloc_bytes;
 } memalloc_context_t;
 
 /* We only support being started once, so we use a global context for the whole
@@ -35,6 +46,17 @@ typedef struct
     traceback_array_t allocs;
     /* Total number of allocations */
     uint64_t alloc_count;
+    /* Number of allocations captured in `allocs`, counting merged duplicates */
+    uint64_t capture_count;
+    /* Open-addressing index over `allocs`, keyed by traceback content hash.
+       Values are the slot in `allocs` plus one; 0 is an empty bucket and
+       TRACKER_INDEX_TOMBSTONE a deleted one. NULL if we could not allocate it,
+       in which case deduplication is disabled. */
+    uint32_t* index;
+    /* Size of `index`, a power of two */
+    uint32_t index_size;
+    /* Number of non-empty buckets, tombstones included; triggers a rebuild */
+    uint32_t index_used;
 } alloc_tracker_t;
 
 /* A string containing "object" */
@@ -42,8 +64,254 @@ static PyObject* object_string = NULL;
 
 #define ALLOC_TRACKER_MAX_COUNT UINT64_MAX
 
+#define TRACKER_INDEX_TOMBSTONE UINT32_MAX
+
 static alloc_tracker_t* global_alloc_tracker;
 
+/* Sampling rate controller: when an events-per-second budget is configured,
+   capture every `stride`-th allocation (randomized) instead of every one, and
+   adjust the stride to the observed allocation throughput so a batch job
+   allocating orders of magnitude more than a web service stays within the
+   same budget.  Each captured event records the number of allocations it
+   stands for, so exported weights remain statistically correct whatever the
+   stride was at capture time.
+
+   The stride and window state are GIL-guarded globals, updated only on
+   capture.  The skip decision itself is a per-thread countdown drawn from a
+   geometric distribution at each capture, so the common case — an allocation
+   that is not sampled — is a single thread-local decrement-and-branch, with
+   no RNG, division, or shared-state traffic at all.  Geometric gaps are
+   memoryless, so a countdown left over from before a stride adjustment (or a
+   stop/start cycle) is as valid a draw as a fresh one; the recorded weight
+   counts the skips that actually happened either way. */
+#define MEMALLOC_RATE_WINDOW 4096
+#define MEMALLOC_RATE_MAX_STRIDE 65536
+
+static struct
+{
+    /* Capture 1 in `stride` allocations, on average */
+    uint64_t stride;
+    /* alloc_count at the start of the current control window */
+    uint64_t window_start_allocs;
+    uint64_t window_start_ns;
+} alloc_rate;
+
+/* Allocations this thread still skips before its next capture, and the gap
+   that countdown started from (plus the capture itself, it becomes the weight
+   of the captured event) */
+static MEMALLOC_TLS uint64_t alloc_skip_countdown = 0;
+static MEMALLOC_TLS uint64_t alloc_skip_drawn = 0;
+
+/* Size-class histogram mode.  Full traceback capture answers "where from?"
+   but is too expensive to run at high rates; what triage usually needs first
+   is "what sizes, how many".  In histogram mode every allocation is binned
+   into power-of-two size classes — two counter bumps, no sampling, no storage
+   growth — so the counts are exact rather than sampled.  With hist_nframe set
+   to 1 or 2, sampled allocations additionally go through the regular
+   traceback path capped at that many frames, giving shallow "from which top
+   frames" attribution for a fraction of full traceback cost.  The mode is
+   flipped at runtime for drill-down: histogram in steady state, back to full
+   tracebacks when a size class looks suspicious.  The allocator hooks for
+   PYMEM_DOMAIN_OBJ run with the GIL held, so plain globals are race-free. */
+#define MEMALLOC_SIZE_CLASSES 48
+
+static struct
+{
+    bool enabled;
+    /* Top frames attributed to sampled allocations while the histogram is
+       enabled; 0 captures no tracebacks at all */
+    uint16_t hist_nframe;
+    /* Class N holds allocations of [2^N, 2^(N+1)[ bytes; the last class
+       absorbs everything larger */
+    uint64_t count[MEMALLOC_SIZE_CLASSES];
+    uint64_t bytes[MEMALLOC_SIZE_CLASSES];
+} alloc_histogram;
+
+static int
+memalloc_size_class(size_t size)
+{
+    int cls = 0;
+    while (size >>= 1)
+        cls++;
+    return cls < MEMALLOC_SIZE_CLASSES ? cls : MEMALLOC_SIZE_CLASSES - 1;
+}
+
+static uint64_t
+memalloc_now_ns(void)
+{
+#ifdef MS_WINDOWS
+    return (uint64_t)GetTickCount64() * 1000000ULL;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void
+memalloc_rate_reset(void)
+{
+    alloc_rate.stride = 1;
+    alloc_rate.window_start_allocs = 0;
+    alloc_rate.window_start_ns = memalloc_now_ns();
+}
+
+/* Re-derive the stride from the allocation throughput observed since the last
+   window boundary.  Runs only on capture: the window length comes from the
+   alloc_count the tracker bumps anyway, so skipped allocations pay nothing
+   for rate control. */
+static void
+memalloc_rate_adjust(const memalloc_context_t* ctx)
+{
+    uint64_t seen = global_alloc_tracker->alloc_count - alloc_rate.window_start_allocs;
+
+    if (seen < MEMALLOC_RATE_WINDOW)
+        return;
+
+    uint64_t now = memalloc_now_ns();
+    uint64_t elapsed_ns = now - alloc_rate.window_start_ns;
+
+    if (elapsed_ns > 0) {
+        double allocs_per_sec = (double)seen * 1e9 / (double)elapsed_ns;
+        uint64_t stride = (uint64_t)(allocs_per_sec / ctx->events_per_sec);
+
+        if (stride < 1)
+            stride = 1;
+        if (stride > MEMALLOC_RATE_MAX_STRIDE)
+            stride = MEMALLOC_RATE_MAX_STRIDE;
+        alloc_rate.stride = stride;
+    } else {
+        /* The window fit under the clock resolution: the allocation rate is
+           too high to measure, back off multiplicatively */
+        alloc_rate.stride = Py_MIN(alloc_rate.stride * 2, MEMALLOC_RATE_MAX_STRIDE);
+    }
+
+    alloc_rate.window_start_ns = now;
+    alloc_rate.window_start_allocs = global_alloc_tracker->alloc_count;
+}
+
+/* Draw the gap to the next captured allocation from a geometric distribution
+   with mean `stride`, via the inverse CDF of its exponential approximation —
+   the same scheme heap_tracker_next_sample_size uses for heap sampling. */
+static uint64_t
+memalloc_rate_draw_gap(void)
+{
+    double q = (double)rand() / ((double)RAND_MAX + 1);
+
+    if (q <= 0)
+        return alloc_rate.stride;
+
+    return (uint64_t)(-log2(q) * log(2) * (double)alloc_rate.stride);
+}
+
+/* Find the slot in `allocs` holding a traceback identical to `tb`, or
+   UINT32_MAX if there is none */
+static uint32_t
+alloc_tracker_index_find(alloc_tracker_t* alloc_tracker, const traceback_t* tb)
+{
+    if (alloc_tracker->index == NULL)
+        return UINT32_MAX;
+
+    uint32_t mask = alloc_tracker->index_size - 1;
+
+    for (uint32_t i = (uint32_t)tb->hash & mask;; i = (i + 1) & mask) {
+        uint32_t v = alloc_tracker->index[i];
+
+        if (v == 0)
+            return UINT32_MAX;
+        if (v != TRACKER_INDEX_TOMBSTONE && traceback_identical(alloc_tracker->allocs.tab[v - 1], tb))
+            return v - 1;
+    }
+}
+
+static void
+alloc_tracker_index_insert(alloc_tracker_t* alloc_tracker, uint32_t slot)
+{
+    if (alloc_tracker->index == NULL)
+        return;
+
+    uint32_t mask = alloc_tracker->index_size - 1;
+    uint64_t hash = alloc_tracker->allocs.tab[slot]->hash;
+
+    for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask) {
+        uint32_t v = alloc_tracker->index[i];
+
+        if (v == 0 || v == TRACKER_INDEX_TOMBSTONE) {
+            alloc_tracker->index[i] = slot + 1;
+            if (v == 0)
+                alloc_tracker->index_used++;
+            return;
+        }
+    }
+}
+
+static void
+alloc_tracker_index_delete(alloc_tracker_t* alloc_tracker, uint32_t slot)
+{
+    if (alloc_tracker->index == NULL)
+        return;
+
+    uint32_t mask = alloc_tracker->index_size - 1;
+    uint64_t hash = alloc_tracker->allocs.tab[slot]->hash;
+
+    for (uint32_t i = (uint32_t)hash & mask;; i = (i + 1) & mask) {
+        uint32_t v = alloc_tracker->index[i];
+
+        if (v == 0)
+            return;
+        if (v == slot + 1) {
+            /* Tombstone rather than empty so probe chains running through this
+               bucket stay intact */
+            alloc_tracker->index[i] = TRACKER_INDEX_TOMBSTONE;
+            return;
+        }
+    }
+}
+
+/* Re-index `allocs` from scratch, dropping the tombstones left behind by
+   reservoir replacement so probe chains stay short and lookups always
+   terminate on an empty bucket */
+static void
+alloc_tracker_index_rebuild(alloc_tracker_t* alloc_tracker)
+{
+    memset(alloc_tracker->index, 0, alloc_tracker->index_size * sizeof(uint32_t));
+    alloc_tracker->index_used = 0;
+
+    for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < alloc_tracker->allocs.count; i++)
+        alloc_tracker_index_insert(alloc_tracker, i);
+}
+
+/* Evict the event least recently captured or merged into, recycling its
+   storage. The evicted weight leaves `capture_count`, so downstream upscaling
+   treats those allocations as if they had never been captured; the remaining
+   entries stay statistically correct. Returns false if the buffer is empty. */
+static bool
+alloc_tracker_evict_lru(alloc_tracker_t* alloc_tracker)
+{
+    if (alloc_tracker->allocs.count == 0)
+        return false;
+
+    uint32_t victim = 0;
+    for (uint32_t i = 1; i < alloc_tracker->allocs.count; i++) {
+        if (alloc_tracker->allocs.tab[i]->lru_seq < alloc_tracker->allocs.tab[victim]->lru_seq)
+            victim = i;
+    }
+
+    alloc_tracker_index_delete(alloc_tracker, victim);
+    alloc_tracker->capture_count -= alloc_tracker->allocs.tab[victim]->count;
+    traceback_free(alloc_tracker->allocs.tab[victim]);
+
+    uint32_t last = alloc_tracker->allocs.count - 1;
+    if (victim != last) {
+        alloc_tracker_index_delete(alloc_tracker, last);
+        alloc_tracker->allocs.tab[victim] = alloc_tracker->allocs.tab[last];
+        alloc_tracker_index_insert(alloc_tracker, victim);
+    }
+    alloc_tracker->allocs.count = (TRACEBACK_ARRAY_COUNT_TYPE)last;
+
+    return true;
+}
+
 static void
 memalloc_add_event(memalloc_context_t* ctx, void* ptr, size_t size)
 {
@@ -57,31 +325,105 @@ memalloc_add_event(memalloc_context_t* ctx, void* ptr, size_t size)
     if (memalloc_get_reentrant())
         return;
 
+    if (alloc_histogram.enabled) {
+        /* Histogram mode: bin the allocation and, unless shallow attribution
+           is on, skip the traceback machinery entirely */
+        int cls = memalloc_size_class(size);
+        alloc_histogram.count[cls]++;
+        alloc_histogram.bytes[cls] += size;
+        if (alloc_histogram.hist_nframe == 0)
+            return;
+    }
+
+    /* Rate control: skip this event, or make it stand for the allocations
+       this thread skipped since its last captured one */
+    uint64_t weight = 1;
+    if (ctx->events_per_sec) {
+        if (alloc_skip_countdown > 0) {
+            alloc_skip_countdown--;
+            return;
+        }
+        weight = alloc_skip_drawn + 1;
+        memalloc_rate_adjust(ctx);
+        alloc_skip_drawn = alloc_rate.stride > 1 ? memalloc_rate_draw_gap() : 0;
+        alloc_skip_countdown = alloc_skip_drawn;
+    }
+
     /* Determine if we can capture or if we need to sample */
-    if (global_alloc_tracker->allocs.count < ctx->max_events) {
-        /* set a barrier so we don't loop as getting a traceback allocates memory */
-        memalloc_set_reentrant(true);
-        /* Buffer is not full, fill it */
-        traceback_t* tb = memalloc_get_traceback(ctx->max_nframe, ptr, size, ctx->domain);
-        memalloc_set_reentrant(false);
-        if (tb)
-            traceback_array_append(&global_alloc_tracker->allocs, tb);
-    } else {
+    bool full = global_alloc_tracker->allocs.count >= ctx->max_events;
+    uint64_t r = 0;
+
+    if (full) {
         /* Sampling mode using a reservoir sampling algorithm: replace a random
          * traceback with this one */
-        uint64_t r = random_range(global_alloc_tracker->alloc_count);
+        r = random_range(global_alloc_tracker->alloc_count);
+        if (r >= ctx->max_events)
+            return;
+    }
 
-        if (r < ctx->max_events) {
-            /* set a barrier so we don't loop as getting a traceback allocates memory */
-            memalloc_set_reentrant(true);
-            /* Replace a random traceback with this one */
-            traceback_t* tb = memalloc_get_traceback(ctx->max_nframe, ptr, size, ctx->domain);
-            memalloc_set_reentrant(false);
-            if (tb) {
-                traceback_free(global_alloc_tracker->allocs.tab[r]);
-                global_alloc_tracker->allocs.tab[r] = tb;
-            }
-        }
+    /* Shallow attribution in histogram mode: the capture goes through the
+       regular traceback path, just capped to the configured top frames */
+    uint16_t max_nframe = ctx->max_nframe;
+    if (alloc_histogram.enabled && alloc_histogram.hist_nframe < max_nframe)
+        max_nframe = alloc_histogram.hist_nframe;
+
+    /* set a barrier so we don't loop as getting a traceback allocates memory */
+    memalloc_set_reentrant(true);
+    traceback_t* tb = memalloc_get_traceback(max_nframe, ptr, size, ctx->domain);
+    if (tb == NULL && ctx->max_alloc_bytes) {
+        /* The byte budget refused the capture: evict the least recently seen
+           event so its slot returns to the arena freelist and retry once.
+           The retry can still fail if the evicted traceback was a fallback
+           allocation rather than an arena slot; the event is then dropped. */
+        if (alloc_tracker_evict_lru(global_alloc_tracker))
+            tb = memalloc_get_traceback(max_nframe, ptr, size, ctx->domain);
+    }
+    memalloc_set_reentrant(false);
+
+    if (tb == NULL)
+        return;
+
+    /* Most workloads allocate from a small set of code paths, so the buffer
+       fills with byte-identical tracebacks. Merge this event into the
+       canonical traceback for its content if there is one: duplicates then
+       cost an accumulator bump instead of a buffer slot, which multiplies the
+       effective event capacity. */
+    /* Weight the event by the allocations it stands for, so downstream
+       upscaling stays statistically correct whatever the current stride */
+    tb->size = size * weight;
+    tb->count = weight;
+    /* The allocation counter doubles as the logical clock for LRU eviction */
+    tb->lru_seq = global_alloc_tracker->alloc_count;
+
+    uint32_t slot = alloc_tracker_index_find(global_alloc_tracker, tb);
+    if (slot != UINT32_MAX) {
+        traceback_t* canonical = global_alloc_tracker->allocs.tab[slot];
+        canonical->size += tb->size;
+        canonical->count += weight;
+        canonical->lru_seq = tb->lru_seq;
+        global_alloc_tracker->capture_count += weight;
+        traceback_free(tb);
+        return;
+    }
+
+    if (!full) {
+        /* Buffer is not full, fill it */
+        traceback_array_append(&global_alloc_tracker->allocs, tb);
+        alloc_tracker_index_insert(global_alloc_tracker, global_alloc_tracker->allocs.count - 1);
+        global_alloc_tracker->capture_count += weight;
+        if (global_alloc_tracker->index_used * 4 > global_alloc_tracker->index_size * 3)
+            alloc_tracker_index_rebuild(global_alloc_tracker);
+    } else {
+        /* Replace a random traceback with this one */
+        traceback_t* evicted = global_alloc_tracker->allocs.tab[r];
+        alloc_tracker_index_delete(global_alloc_tracker, (uint32_t)r);
+        global_alloc_tracker->capture_count -= evicted->count;
+        traceback_free(evicted);
+        global_alloc_tracker->allocs.tab[r] = tb;
+        alloc_tracker_index_insert(global_alloc_tracker, (uint32_t)r);
+        global_alloc_tracker->capture_count += weight;
+        if (global_alloc_tracker->index_used * 4 > global_alloc_tracker->index_size * 3)
+            alloc_tracker_index_rebuild(global_alloc_tracker);
     }
 }
 
@@ -98,11 +440,8 @@ memalloc_free(void* ctx, void* ptr)
     alloc->free(alloc->ctx, ptr);
 }
 
-#ifdef _PY37_AND_LATER
-Py_tss_t memalloc_reentrant_key = Py_tss_NEEDS_INIT;
-#else
-int memalloc_reentrant_key = -1;
-#endif
+/* Per-thread reentrancy flag; see _memalloc_reentrant.h */
+MEMALLOC_TLS bool _memalloc_reentrant_flag = false;
 
 static void*
 memalloc_alloc(int use_calloc, void* ctx, size_t nelem, size_t elsize)
@@ -151,11 +490,25 @@ memalloc_realloc(void* ctx, void* ptr, size_t new_size)
 }
 
 static alloc_tracker_t*
-alloc_tracker_new()
+alloc_tracker_new(uint16_t max_events)
 {
     alloc_tracker_t* alloc_tracker = PyMem_RawMalloc(sizeof(alloc_tracker_t));
+    if (alloc_tracker == NULL)
+        return NULL;
     alloc_tracker->alloc_count = 0;
+    alloc_tracker->capture_count = 0;
     traceback_array_init(&alloc_tracker->allocs);
+
+    /* Size the index so a full buffer loads it at 25% at most, leaving room
+       for replacement tombstones between rebuilds */
+    uint32_t index_size = 64;
+    while (index_size < 4 * (uint32_t)max_events)
+        index_size <<= 1;
+
+    alloc_tracker->index = PyMem_RawCalloc(index_size, sizeof(uint32_t));
+    alloc_tracker->index_size = alloc_tracker->index ? index_size : 0;
+    alloc_tracker->index_used = 0;
+
     return alloc_tracker;
 }
 
@@ -163,11 +516,12 @@ static void
 alloc_tracker_free(alloc_tracker_t* alloc_tracker)
 {
     traceback_array_wipe(&alloc_tracker->allocs);
+    PyMem_RawFree(alloc_tracker->index);
     PyMem_RawFree(alloc_tracker);
 }
 
 PyDoc_STRVAR(memalloc_start__doc__,
-             "start($module, max_nframe, max_events, heap_sample_size)\n"
+             "start($module, max_nframe, max_events, heap_sample_size, events_per_sec=0, max_alloc_bytes=0)\n"
              "--\n"
              "\n"
              "Start tracing Python memory allocations.\n"
@@ -175,7 +529,13 @@ PyDoc_STRVAR(memalloc_start__doc__,
              "Sets the maximum number of frames stored in the traceback of a\n"
              "trace to max_nframe and the maximum number of events to max_events.\n"
              "Set heap_sample_size to the granularity of the heap profiler, in bytes.\n"
-             "If heap_sample_size is set to 0, it is disabled entirely.\n");
+             "If heap_sample_size is set to 0, it is disabled entirely.\n"
+             "If events_per_sec is positive, the sampling rate adapts to the\n"
+             "allocation throughput to capture about that many events per second,\n"
+             "weighting each captured event by the allocations it stands for.\n"
+             "If max_alloc_bytes is positive, traceback storage is capped at that\n"
+             "many bytes, evicting the least recently seen events when a new\n"
+             "capture would exceed it.\n");
 static PyObject*
 memalloc_start(PyObject* Py_UNUSED(module), PyObject* args)
 {
@@ -186,9 +546,12 @@ memalloc_start(PyObject* Py_UNUSED(module), PyObject* args)
 
     long max_nframe, max_events;
     long long int heap_sample_size;
+    long events_per_sec = 0;
+    long long int max_alloc_bytes = 0;
 
     /* Store short ints in ints so we're sure they fit */
-    if (!PyArg_ParseTuple(args, "llL", &max_nframe, &max_events, &heap_sample_size))
+    if (!PyArg_ParseTuple(
+          args, "llL|lL", &max_nframe, &max_events, &heap_sample_size, &events_per_sec, &max_alloc_bytes))
         return NULL;
 
     if (max_nframe < 1 || max_nframe > TRACEBACK_MAX_NFRAME) {
@@ -210,7 +573,28 @@ memalloc_start(PyObject* Py_UNUSED(module), PyObject* args)
         return NULL;
     }
 
-    if (memalloc_tb_init(global_memalloc_ctx.max_nframe) < 0)
+    if (events_per_sec < 0 || (unsigned long long)events_per_sec > UINT32_MAX) {
+        PyErr_Format(PyExc_ValueError, "the number of events per second must be in range [0; %lu]", UINT32_MAX);
+        return NULL;
+    }
+
+    global_memalloc_ctx.events_per_sec = (uint32_t)events_per_sec;
+    memalloc_rate_reset();
+
+    /* The histogram mode flags survive a stop/start cycle (they are a mode,
+       not state), but counters from a previous run do not */
+    memset(alloc_histogram.count, 0, sizeof(alloc_histogram.count));
+    memset(alloc_histogram.bytes, 0, sizeof(alloc_histogram.bytes));
+
+    if (max_alloc_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "the maximum number of bytes must be positive or 0");
+        return NULL;
+    }
+
+    global_memalloc_ctx.max_alloc_bytes = (uint64_t)max_alloc_bytes;
+
+    if (memalloc_tb_init(
+          global_memalloc_ctx.max_nframe, global_memalloc_ctx.max_events, global_memalloc_ctx.max_alloc_bytes) < 0)
         return NULL;
 
     if (object_string == NULL) {
@@ -233,7 +617,12 @@ memalloc_start(PyObject* Py_UNUSED(module), PyObject* args)
 
     global_memalloc_ctx.domain = PYMEM_DOMAIN_OBJ;
 
-    global_alloc_tracker = alloc_tracker_new();
+    global_alloc_tracker = alloc_tracker_new(global_memalloc_ctx.max_events);
+    if (global_alloc_tracker == NULL) {
+        memalloc_heap_tracker_deinit();
+        memalloc_tb_deinit();
+        return PyErr_NoMemory();
+    }
 
     PyMem_GetAllocator(PYMEM_DOMAIN_OBJ, &global_memalloc_ctx.pymem_allocator_obj);
     PyMem_SetAllocator(PYMEM_DOMAIN_OBJ, &alloc);
@@ -282,6 +671,134 @@ memalloc_heap_py(PyObject* Py_UNUSED(module), PyObject* Py_UNUSED(args))
     return memalloc_heap();
 }
 
+PyDoc_STRVAR(memalloc_heap_diff_py__doc__,
+             "heap_diff($module, /)\n"
+             "--\n"
+             "\n"
+             "Get the sampled heap changes since the previous call, as a tuple\n"
+             "(new_entries, freed_seqs). Each new entry is (traceback, size, seq);\n"
+             "freed_seqs lists the seq values of previously-reported entries that\n"
+             "have been freed. The first call reports the whole live set as new.\n");
+static PyObject*
+memalloc_heap_diff_py(PyObject* Py_UNUSED(module), PyObject* Py_UNUSED(args))
+{
+    if (!global_alloc_tracker) {
+        PyErr_SetString(PyExc_RuntimeError, "the memalloc module was not started");
+        return NULL;
+    }
+
+    return memalloc_heap_diff();
+}
+
+PyDoc_STRVAR(memalloc_stats_py__doc__,
+             "stats($module, /)\n"
+             "--\n"
+             "\n"
+             "Get memory usage statistics of the profiler itself, as a dict with\n"
+             "the bytes currently reserved for traceback storage and the\n"
+             "high-water mark of that figure.\n");
+static PyObject*
+memalloc_stats_py(PyObject* Py_UNUSED(module), PyObject* Py_UNUSED(args))
+{
+    PyObject* stats = PyDict_New();
+    if (stats == NULL)
+        return NULL;
+
+    PyObject* reserved = PyLong_FromSize_t(memalloc_tb_bytes_reserved());
+    PyObject* high_water = PyLong_FromSize_t(memalloc_tb_bytes_high_water());
+
+    if (reserved == NULL || high_water == NULL || PyDict_SetItemString(stats, "bytes_reserved", reserved) < 0 ||
+        PyDict_SetItemString(stats, "bytes_high_water", high_water) < 0) {
+        Py_XDECREF(reserved);
+        Py_XDECREF(high_water);
+        Py_DECREF(stats);
+        return NULL;
+    }
+
+    Py_DECREF(reserved);
+    Py_DECREF(high_water);
+
+    return stats;
+}
+
+PyDoc_STRVAR(memalloc_set_histogram__doc__,
+             "set_histogram($module, nframe, /)\n"
+             "--\n"
+             "\n"
+             "Switch the allocation profiler between traceback and histogram mode.\n"
+             "\n"
+             "A negative nframe restores full traceback mode. Otherwise every\n"
+             "allocation is binned into power-of-two size-class counters; with\n"
+             "nframe 0 no tracebacks are captured at all, with nframe 1 or 2\n"
+             "sampled allocations are additionally attributed to that many top\n"
+             "frames. The switch takes effect immediately, so the mode can be\n"
+             "flipped at runtime for drill-down.\n");
+static PyObject*
+memalloc_set_histogram(PyObject* Py_UNUSED(module), PyObject* args)
+{
+    long nframe;
+
+    if (!PyArg_ParseTuple(args, "l", &nframe))
+        return NULL;
+
+    if (nframe > 2) {
+        PyErr_SetString(PyExc_ValueError, "histogram attribution is limited to 2 frames");
+        return NULL;
+    }
+
+    alloc_histogram.enabled = nframe >= 0;
+    alloc_histogram.hist_nframe = nframe > 0 ? (uint16_t)nframe : 0;
+
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(memalloc_histogram__doc__,
+             "histogram($module, /)\n"
+             "--\n"
+             "\n"
+             "Get and reset the size-class histogram, as a list of\n"
+             "(size_class, count, bytes) tuples where the class holds allocations\n"
+             "of [2**size_class, 2**(size_class+1)) bytes. Empty classes are\n"
+             "omitted. Counts are exact, not sampled.\n");
+static PyObject*
+memalloc_histogram_py(PyObject* Py_UNUSED(module), PyObject* Py_UNUSED(args))
+{
+    if (!global_alloc_tracker) {
+        PyErr_SetString(PyExc_RuntimeError, "the memalloc module was not started");
+        return NULL;
+    }
+
+    PyObject* classes = PyList_New(0);
+    if (classes == NULL)
+        return NULL;
+
+    /* The list operations below allocate through the tracked allocator; the
+       reentrancy barrier keeps them out of the histogram we are draining */
+    memalloc_set_reentrant(true);
+
+    for (int i = 0; i < MEMALLOC_SIZE_CLASSES; i++) {
+        if (alloc_histogram.count[i] == 0)
+            continue;
+
+        PyObject* entry = Py_BuildValue(
+          "iKK", i, (unsigned long long)alloc_histogram.count[i], (unsigned long long)alloc_histogram.bytes[i]);
+        if (entry == NULL || PyList_Append(classes, entry) < 0) {
+            Py_XDECREF(entry);
+            Py_DECREF(classes);
+            memalloc_set_reentrant(false);
+            return NULL;
+        }
+        Py_DECREF(entry);
+
+        alloc_histogram.count[i] = 0;
+        alloc_histogram.bytes[i] = 0;
+    }
+
+    memalloc_set_reentrant(false);
+
+    return classes;
+}
+
 typedef struct
 {
     PyObject_HEAD alloc_tracker_t* alloc_tracker;
@@ -293,8 +810,10 @@ PyDoc_STRVAR(iterevents__doc__,
              "--\n"
              "\n"
              "Returns a tuple with 3 items:\n:"
-             "1. an iterator of memory allocation traced so far\n"
-             "2. the number of items in the iterator\n"
+             "1. an iterator of memory allocation traced so far; entries with\n"
+             "   identical tracebacks are merged, so each item carries the\n"
+             "   number of allocations it stands for and their total size\n"
+             "2. the number of allocations captured by the iterator\n"
              "3. the total number of allocations since last reset\n"
              "\n"
              "Also reset the traces of memory blocks allocated by Python.");
@@ -306,18 +825,28 @@ iterevents_new(PyTypeObject* type, PyObject* Py_UNUSED(args), PyObject* Py_UNUSE
         return NULL;
     }
 
+    /* Build the replacement buffer before detaching the current one, so the
+       swap itself is a plain pointer exchange: writers never see a window
+       without a buffer installed, and an allocation failure here leaves the
+       current buffer untouched */
+    alloc_tracker_t* fresh = alloc_tracker_new(global_memalloc_ctx.max_events);
+    if (fresh == NULL)
+        return PyErr_NoMemory();
+
     IterEventsState* iestate = (IterEventsState*)type->tp_alloc(type, 0);
-    if (!iestate)
+    if (!iestate) {
+        alloc_tracker_free(fresh);
         return NULL;
+    }
 
     iestate->alloc_tracker = global_alloc_tracker;
     /* reset the current traceback list */
-    global_alloc_tracker = alloc_tracker_new();
+    global_alloc_tracker = fresh;
     iestate->seq_index = 0;
 
     PyObject* iter_and_count = PyTuple_New(3);
     PyTuple_SET_ITEM(iter_and_count, 0, (PyObject*)iestate);
-    PyTuple_SET_ITEM(iter_and_count, 1, PyLong_FromUnsignedLong(iestate->alloc_tracker->allocs.count));
+    PyTuple_SET_ITEM(iter_and_count, 1, PyLong_FromUnsignedLongLong(iestate->alloc_tracker->capture_count));
     PyTuple_SET_ITEM(iter_and_count, 2, PyLong_FromUnsignedLongLong(iestate->alloc_tracker->alloc_count));
 
     return iter_and_count;
@@ -337,7 +866,7 @@ iterevents_next(IterEventsState* iestate)
         traceback_t* tb = iestate->alloc_tracker->allocs.tab[iestate->seq_index];
         iestate->seq_index++;
 
-        PyObject* tb_size_domain = PyTuple_New(3);
+        PyObject* tb_size_domain = PyTuple_New(4);
         PyTuple_SET_ITEM(tb_size_domain, 0, traceback_to_tuple(tb));
         PyTuple_SET_ITEM(tb_size_domain, 1, PyLong_FromSize_t(tb->size));
 
@@ -350,6 +879,9 @@ iterevents_next(IterEventsState* iestate)
             Py_INCREF(Py_None);
         }
 
+        /* Number of allocations merged into this entry */
+        PyTuple_SET_ITEM(tb_size_domain, 3, PyLong_FromUnsignedLongLong(tb->count));
+
         return tb_size_domain;
     }
 
@@ -418,6 +950,19 @@ static PyTypeObject MemallocIterEvents_Type = {
 static PyMethodDef module_methods[] = { { "start", (PyCFunction)memalloc_start, METH_VARARGS, memalloc_start__doc__ },
                                         { "stop", (PyCFunction)memalloc_stop, METH_NOARGS, memalloc_stop__doc__ },
                                         { "heap", (PyCFunction)memalloc_heap_py, METH_NOARGS, memalloc_heap_py__doc__ },
+                                        { "heap_diff",
+                                          (PyCFunction)memalloc_heap_diff_py,
+                                          METH_NOARGS,
+                                          memalloc_heap_diff_py__doc__ },
+                                        { "stats", (PyCFunction)memalloc_stats_py, METH_NOARGS, memalloc_stats_py__doc__ },
+                                        { "set_histogram",
+                                          (PyCFunction)memalloc_set_histogram,
+                                          METH_VARARGS,
+                                          memalloc_set_histogram__doc__ },
+                                        { "histogram",
+                                          (PyCFunction)memalloc_histogram_py,
+                                          METH_NOARGS,
+                                          memalloc_histogram__doc__ },
                                         /* sentinel */
                                         { NULL, NULL, 0, NULL } };
 
@@ -442,20 +987,6 @@ PyInit__memalloc(void)
         return NULL;
     }
 
-#ifdef _PY37_AND_LATER
-    if (PyThread_tss_create(&memalloc_reentrant_key) != 0) {
-#else
-    memalloc_reentrant_key = PyThread_create_key();
-    if (memalloc_reentrant_key == -1) {
-#endif
-#ifdef MS_WINDOWS
-        PyErr_SetFromWindowsErr(0);
-#else
-        PyErr_SetFromErrno(PyExc_OSError);
-#endif
-        return NULL;
-    }
-
     if (PyType_Ready(&MemallocIterEvents_Type) < 0)
         return NULL;
     Py_INCREF((PyObject*)&MemallocIterEvents_Type);
@@ -12,4 +12,5 @@ TracebackType = typing.Tuple[StackType, int, int]
 def start(max_nframe: int, max_events: int, heap_sample_size: int) -> None: ...
 def stop() -> None: ...
 def heap() -> typing.List[typing.Tuple[TracebackType, int]]: ...
+def heap_diff() -> typing.Tuple[typing.List[typing.Tuple[TracebackType, int, int]], typing.List[int]]: ...
 def iter_events() -> typing.Iterator[typing.Tuple[TracebackType, int]]: ...
@@ -6,6 +6,27 @@
 #include "_memalloc_reentrant.h"
 #include "_memalloc_tb.h"
 
+/* Open-addressing index over the tracked allocations, keyed by pointer, so
+   memalloc_heap_untrack stays O(1) however many sampled objects are live.
+   Bucket values are the slot in `allocs` plus one; 0 is an empty bucket and
+   HEAP_INDEX_TOMBSTONE a deleted one. NULL buckets (allocation failure) fall
+   back to the linear scan. */
+typedef struct
+{
+    uint32_t* buckets;
+    /* Number of buckets, a power of two */
+    uint32_t size;
+    /* Non-empty buckets, tombstones included; triggers a rebuild */
+    uint32_t used;
+} ptr_index_t;
+
+#define HEAP_INDEX_TOMBSTONE UINT32_MAX
+#define HEAP_INDEX_MIN_SIZE 256
+
+/* Sequence ids of previously-exported entries freed since the last diff
+   export; plain integers, nothing to free */
+DO_ARRAY(uint64_t, seq, uint32_t, DO_NOTHING)
+
 typedef struct
 {
     /* Granularity of the heap profiler in bytes */
@@ -14,10 +35,20 @@ typedef struct
     uint32_t current_sample_size;
     /* Tracked allocations */
     traceback_array_t allocs;
+    /* Pointer-keyed index over `allocs` for the free() path */
+    ptr_index_t index;
     /* Allocated memory counter in bytes */
     uint32_t allocated_memory;
     /* True if the heap tracker is frozen */
     bool frozen;
+    /* Incremental export state: the next sequence id to assign, the highest id
+       covered by the last diff export, and the ids of previously-exported
+       entries freed since then.  Freed ids are only recorded once a diff
+       consumer has armed the mode, so the full-snapshot path pays nothing. */
+    uint64_t next_seq;
+    uint64_t last_export_seq;
+    seq_array_t freed;
+    bool diff_armed;
     /* Contains the ongoing heap allocation/deallocation while frozen */
     struct
     {
@@ -28,6 +59,80 @@ typedef struct
 
 static heap_tracker_t global_heap_tracker;
 
+static uint32_t
+ptr_index_first_bucket(const ptr_index_t* index, void* ptr)
+{
+    /* Fibonacci hashing: multiply and keep the top bits, which mixes the
+       mostly-aligned low pointer bits well */
+    uint64_t h = (uint64_t)(uintptr_t)ptr * 11400714819323198485ULL;
+    return (uint32_t)(h >> 32) & (index->size - 1);
+}
+
+static void
+ptr_index_insert_bucket(ptr_index_t* index, void* ptr, uint32_t slot)
+{
+    for (uint32_t i = ptr_index_first_bucket(index, ptr);; i = (i + 1) & (index->size - 1)) {
+        uint32_t v = index->buckets[i];
+
+        if (v == 0 || v == HEAP_INDEX_TOMBSTONE) {
+            index->buckets[i] = slot + 1;
+            if (v == 0)
+                index->used++;
+            return;
+        }
+    }
+}
+
+/* Re-index the first `nslots` entries of `allocs` into a table of `size`
+   buckets, shedding the tombstones left behind by untracking so probes always
+   terminate on an empty bucket.  `nslots` is the number of slots indexed so
+   far rather than allocs.count: during a thaw the spliced-in entries are
+   indexed one by one, and covering them here too would double-index them —
+   duplicate buckets for one slot misdirect the swap-remove retargeting later. */
+static void
+heap_tracker_index_rebuild(heap_tracker_t* heap_tracker, uint32_t size, uint32_t nslots)
+{
+    ptr_index_t* index = &heap_tracker->index;
+
+    PyMem_RawFree(index->buckets);
+    index->buckets = PyMem_RawCalloc(size, sizeof(uint32_t));
+    index->used = 0;
+
+    if (index->buckets == NULL) {
+        /* Degrade to linear scans */
+        index->size = 0;
+        return;
+    }
+
+    index->size = size;
+
+    for (uint32_t i = 0; i < nslots; i++)
+        ptr_index_insert_bucket(index, heap_tracker->allocs.tab[i]->ptr, i);
+}
+
+static void
+heap_tracker_index_insert(heap_tracker_t* heap_tracker, uint32_t slot)
+{
+    ptr_index_t* index = &heap_tracker->index;
+
+    if (index->buckets == NULL)
+        return;
+
+    if ((index->used + 1) * 4 > index->size * 3) {
+        /* Rebuild to shed tombstones, doubling if live entries actually fill
+           half the table.  Only slots below the one being inserted are indexed
+           at this point (callers insert in ascending slot order). */
+        uint32_t new_size = index->size;
+        if ((uint32_t)heap_tracker->allocs.count * 2 >= index->size)
+            new_size <<= 1;
+        heap_tracker_index_rebuild(heap_tracker, new_size, slot);
+        if (index->buckets == NULL)
+            return;
+    }
+
+    ptr_index_insert_bucket(index, heap_tracker->allocs.tab[slot]->ptr, slot);
+}
+
 static uint32_t
 heap_tracker_next_sample_size(uint32_t sample_size)
 {
@@ -44,10 +149,18 @@ heap_tracker_init(heap_tracker_t* heap_tracker)
     traceback_array_init(&heap_tracker->allocs);
     traceback_array_init(&heap_tracker->freezer.allocs);
     ptr_array_init(&heap_tracker->freezer.frees);
+    heap_tracker->index.buckets = NULL;
+    heap_tracker->index.size = 0;
+    heap_tracker->index.used = 0;
+    heap_tracker_index_rebuild(heap_tracker, HEAP_INDEX_MIN_SIZE, 0);
     heap_tracker->allocated_memory = 0;
     heap_tracker->frozen = false;
     heap_tracker->sample_size = 0;
     heap_tracker->current_sample_size = 0;
+    heap_tracker->next_seq = 0;
+    heap_tracker->last_export_seq = 0;
+    seq_array_init(&heap_tracker->freed);
+    heap_tracker->diff_armed = false;
 }
 
 static void
@@ -56,6 +169,11 @@ heap_tracker_wipe(heap_tracker_t* heap_tracker)
     traceback_array_wipe(&heap_tracker->allocs);
     traceback_array_wipe(&heap_tracker->freezer.allocs);
     ptr_array_wipe(&heap_tracker->freezer.frees);
+    seq_array_wipe(&heap_tracker->freed);
+    PyMem_RawFree(heap_tracker->index.buckets);
+    heap_tracker->index.buckets = NULL;
+    heap_tracker->index.size = 0;
+    heap_tracker->index.used = 0;
 }
 
 static void
@@ -64,27 +182,85 @@ heap_tracker_freeze(heap_tracker_t* heap_tracker)
     heap_tracker->frozen = true;
 }
 
+/* Record that a previously-exported entry is gone, so the next diff export can
+   report it freed.  Entries never covered by a diff export need no record: the
+   consumer has never heard of them. */
 static void
-heap_tracker_untrack_thawed(heap_tracker_t* heap_tracker, void* ptr)
+heap_tracker_record_freed(heap_tracker_t* heap_tracker, traceback_t* tb)
 {
-    /* This search is O(n) where `n` is the number of tracked traceback,
-       which is linearly linked to the heap size. This search could probably be
-       optimized in a couple of ways:
+    if (heap_tracker->diff_armed && tb->heap_seq != 0 && tb->heap_seq <= heap_tracker->last_export_seq)
+        seq_array_append(&heap_tracker->freed, tb->heap_seq);
+}
 
-       - sort the traceback in allocs by ptr so we can find the ptr in O(log2 n)
-       - use a Bloom filter?
+static void
+heap_tracker_untrack_thawed(heap_tracker_t* heap_tracker, void* ptr)
+{
+    ptr_index_t* index = &heap_tracker->index;
+
+    if (index->buckets) {
+        uint32_t mask = index->size - 1;
+
+        for (uint32_t i = ptr_index_first_bucket(index, ptr);; i = (i + 1) & mask) {
+            uint32_t v = index->buckets[i];
+
+            /* Most frees are of pointers we never sampled: that probe ends at
+               the first empty bucket, which the load factor keeps close */
+            if (v == 0)
+                return;
+
+            if (v != HEAP_INDEX_TOMBSTONE && ptr == heap_tracker->allocs.tab[v - 1]->ptr) {
+                uint32_t slot = v - 1;
+                uint32_t last = (uint32_t)heap_tracker->allocs.count - 1;
+                traceback_t* found = heap_tracker->allocs.tab[slot];
+
+                index->buckets[i] = HEAP_INDEX_TOMBSTONE;
+                heap_tracker_record_freed(heap_tracker, found);
+
+                /* Move the last element into the hole so the array stays
+                   dense, and retarget its bucket. The bucket is found by
+                   value, not pointer: duplicate pointers can coexist briefly
+                   across a freeze/thaw cycle. */
+                if (slot != last) {
+                    traceback_t* moved = heap_tracker->allocs.tab[last];
+
+                    heap_tracker->allocs.tab[slot] = moved;
+                    for (uint32_t j = ptr_index_first_bucket(index, moved->ptr);; j = (j + 1) & mask) {
+                        uint32_t w = index->buckets[j];
+
+                        if (w == last + 1) {
+                            index->buckets[j] = slot + 1;
+                            break;
+                        }
+                        if (w == 0)
+                            break;
+                    }
+                }
+                heap_tracker->allocs.count--;
+
+                /* Free last: freeing the traceback decrefs its cached export
+                   tuple and code objects, and those deallocations go through
+                   the hooked allocators — which can reenter this function.
+                   The map must already be consistent at that point. */
+                traceback_free(found);
+                return;
+            }
+        }
+    }
 
-       That being said, we start iterating at the end of the array because most
-       of the time this is where the untracked ptr is (the most recent object
-       get de-allocated first usually). This might be a good enough
-       trade-off. */
+    /* The index could not be allocated: fall back to scanning from the end of
+       the array, where the untracked ptr usually is (the most recent object
+       gets de-allocated first usually) */
     for (TRACEBACK_ARRAY_COUNT_TYPE i = heap_tracker->allocs.count; i > 0; i--) {
         traceback_t** tb = &heap_tracker->allocs.tab[i - 1];
 
         if (ptr == (*tb)->ptr) {
-            /* Free the traceback */
-            traceback_free(*tb);
+            traceback_t* found = *tb;
+
+            heap_tracker_record_freed(heap_tracker, found);
             traceback_array_remove(&heap_tracker->allocs, tb);
+            /* Free last: traceback_free can reenter this function through the
+               allocator hooks (see the index path above) */
+            traceback_free(found);
             break;
         }
     }
@@ -93,6 +269,8 @@ heap_tracker_untrack_thawed(heap_tracker_t* heap_tracker, void* ptr)
 static void
 heap_tracker_thaw(heap_tracker_t* heap_tracker)
 {
+    TRACEBACK_ARRAY_COUNT_TYPE first_new = heap_tracker->allocs.count;
+
     /* Add the frozen allocs at the end */
     traceback_array_splice(&heap_tracker->allocs,
                            heap_tracker->allocs.count,
@@ -100,6 +278,10 @@ heap_tracker_thaw(heap_tracker_t* heap_tracker)
                            heap_tracker->freezer.allocs.tab,
                            heap_tracker->freezer.allocs.count);
 
+    /* Index the spliced-in allocs before we handle the frees */
+    for (TRACEBACK_ARRAY_COUNT_TYPE i = first_new; i < heap_tracker->allocs.count; i++)
+        heap_tracker_index_insert(heap_tracker, i);
+
     /* Handle the frees: we need to handle the frees after we merge the allocs
        array together to be sure that there's no free in the freezer matching
        an alloc that is also in the freezer; heap_tracker_untrack_thawed does
@@ -178,10 +360,13 @@ memalloc_heap_track(uint16_t max_nframe, void* ptr, size_t size, PyMemAllocatorD
     memalloc_set_reentrant(false);
 
     if (tb) {
+        tb->heap_seq = ++global_heap_tracker.next_seq;
         if (global_heap_tracker.frozen)
             traceback_array_append(&global_heap_tracker.freezer.allocs, tb);
-        else
+        else {
             traceback_array_append(&global_heap_tracker.allocs, tb);
+            heap_tracker_index_insert(&global_heap_tracker, global_heap_tracker.allocs.count - 1);
+        }
 
         /* Reset the counter to 0 */
         global_heap_tracker.allocated_memory = 0;
@@ -200,18 +385,137 @@ memalloc_heap()
 {
     heap_tracker_freeze(&global_heap_tracker);
 
-    PyObject* heap_list = PyList_New(global_heap_tracker.allocs.count);
+    TRACEBACK_ARRAY_COUNT_TYPE count = global_heap_tracker.allocs.count;
+
+    /* Live allocations are tracked per pointer, but most come from a handful
+       of code paths: merge entries with identical tracebacks at export time,
+       accumulating their sizes into the first entry of each group, so the
+       GIL-held tuple conversion is paid once per unique stack instead of once
+       per pointer. If we cannot allocate the scratch tables, fall back to the
+       unmerged representation. */
+    uint32_t table_size = 64;
+    while (table_size < 2 * (uint32_t)count + 1)
+        table_size <<= 1;
+
+    uint32_t* group = PyMem_RawMalloc(count * sizeof(uint32_t));
+    size_t* sizes = PyMem_RawMalloc(count * sizeof(size_t));
+    uint32_t* table = PyMem_RawCalloc(table_size, sizeof(uint32_t));
+
+    PyObject* heap_list;
+
+    if (group && sizes && table) {
+        uint32_t mask = table_size - 1;
+        TRACEBACK_ARRAY_COUNT_TYPE unique = 0;
+
+        for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < count; i++) {
+            traceback_t* tb = global_heap_tracker.allocs.tab[i];
+
+            for (uint32_t j = (uint32_t)tb->hash & mask;; j = (j + 1) & mask) {
+                uint32_t v = table[j];
+
+                if (v == 0) {
+                    table[j] = i + 1;
+                    group[i] = i;
+                    sizes[i] = tb->size;
+                    unique++;
+                    break;
+                }
+                if (traceback_identical(global_heap_tracker.allocs.tab[v - 1], tb)) {
+                    group[i] = v - 1;
+                    sizes[v - 1] += tb->size;
+                    break;
+                }
+            }
+        }
 
-    for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < global_heap_tracker.allocs.count; i++) {
-        traceback_t* tb = global_heap_tracker.allocs.tab[i];
+        heap_list = PyList_New(unique);
+
+        TRACEBACK_ARRAY_COUNT_TYPE item = 0;
+        for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < count; i++) {
+            if (group[i] != i)
+                continue;
+
+            PyObject* tb_and_size = PyTuple_New(2);
+            PyTuple_SET_ITEM(tb_and_size, 0, traceback_to_tuple(global_heap_tracker.allocs.tab[i]));
+            PyTuple_SET_ITEM(tb_and_size, 1, PyLong_FromSize_t(sizes[i]));
+            PyList_SET_ITEM(heap_list, item++, tb_and_size);
+        }
+    } else {
+        heap_list = PyList_New(count);
+
+        for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < count; i++) {
+            traceback_t* tb = global_heap_tracker.allocs.tab[i];
 
-        PyObject* tb_and_size = PyTuple_New(2);
-        PyTuple_SET_ITEM(tb_and_size, 0, traceback_to_tuple(tb));
-        PyTuple_SET_ITEM(tb_and_size, 1, PyLong_FromSize_t(tb->size));
-        PyList_SET_ITEM(heap_list, i, tb_and_size);
+            PyObject* tb_and_size = PyTuple_New(2);
+            PyTuple_SET_ITEM(tb_and_size, 0, traceback_to_tuple(tb));
+            PyTuple_SET_ITEM(tb_and_size, 1, PyLong_FromSize_t(tb->size));
+            PyList_SET_ITEM(heap_list, i, tb_and_size);
+        }
     }
 
+    PyMem_RawFree(group);
+    PyMem_RawFree(sizes);
+    PyMem_RawFree(table);
+
     heap_tracker_thaw(&global_heap_tracker);
 
     return heap_list;
 }
+
+PyObject*
+memalloc_heap_diff()
+{
+    heap_tracker_freeze(&global_heap_tracker);
+
+    /* Allocations made while we convert tracebacks below (tuple building goes
+       through the hooked allocators) land in the freezer with ids greater than
+       this, so they are naturally deferred to the next diff. */
+    uint64_t export_seq = global_heap_tracker.next_seq;
+
+    TRACEBACK_ARRAY_COUNT_TYPE count = global_heap_tracker.allocs.count;
+    TRACEBACK_ARRAY_COUNT_TYPE new_count = 0;
+
+    for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < count; i++) {
+        if (global_heap_tracker.allocs.tab[i]->heap_seq > global_heap_tracker.last_export_seq)
+            new_count++;
+    }
+
+    /* Entries are not merged by traceback here: the per-entry sequence id is
+       what lets the consumer retire them individually when they are freed. */
+    PyObject* new_list = PyList_New(new_count);
+    TRACEBACK_ARRAY_COUNT_TYPE item = 0;
+
+    for (TRACEBACK_ARRAY_COUNT_TYPE i = 0; i < count; i++) {
+        traceback_t* tb = global_heap_tracker.allocs.tab[i];
+
+        if (tb->heap_seq <= global_heap_tracker.last_export_seq)
+            continue;
+
+        PyObject* entry = PyTuple_New(3);
+        PyTuple_SET_ITEM(entry, 0, traceback_to_tuple(tb));
+        PyTuple_SET_ITEM(entry, 1, PyLong_FromSize_t(tb->size));
+        PyTuple_SET_ITEM(entry, 2, PyLong_FromUnsignedLongLong(tb->heap_seq));
+        PyList_SET_ITEM(new_list, item++, entry);
+    }
+
+    PyObject* freed_list = PyList_New(global_heap_tracker.freed.count);
+
+    for (uint32_t i = 0; i < global_heap_tracker.freed.count; i++)
+        PyList_SET_ITEM(freed_list, i, PyLong_FromUnsignedLongLong(global_heap_tracker.freed.tab[i]));
+
+    global_heap_tracker.freed.count = 0;
+
+    /* Arm freed-id recording and advance the export watermark before thawing,
+       so entries reported new above and then freed during the freeze window
+       are recorded for the next diff when the thaw replays the frees. */
+    global_heap_tracker.last_export_seq = export_seq;
+    global_heap_tracker.diff_armed = true;
+
+    heap_tracker_thaw(&global_heap_tracker);
+
+    PyObject* diff = PyTuple_New(2);
+    PyTuple_SET_ITEM(diff, 0, new_list);
+    PyTuple_SET_ITEM(diff, 1, freed_list);
+
+    return diff;
+}
@@ -20,6 +20,14 @@ memalloc_heap_tracker_deinit(void);
 PyObject*
 memalloc_heap();
 
+/* Incremental form of memalloc_heap: returns (new_entries, freed_seqs), where
+   new_entries holds the allocations tracked since the previous call (with
+   their sequence ids) and freed_seqs the ids of previously-reported entries
+   freed since then.  The first call arms freed-id recording and reports the
+   whole live set as new. */
+PyObject*
+memalloc_heap_diff();
+
 bool
 memalloc_heap_track(uint16_t max_nframe, void* ptr, size_t size, PyMemAllocatorDomain domain);
 void
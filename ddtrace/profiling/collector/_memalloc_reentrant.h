@@ -1,50 +1,37 @@
 #ifndef _DDTRACE_MEMALLOC_REENTRANT_H
 #define _DDTRACE_MEMALLOC_REENTRANT_H
 
-#include "_pymacro.h"
 #include <stdbool.h>
 
-#ifndef _PY37_AND_LATER
-#include <pythread.h>
-#endif
-
-#ifdef _PY37_AND_LATER
-extern Py_tss_t memalloc_reentrant_key;
+/* The reentrancy guard is checked on every traced allocation, so it lives in a
+   native thread-local instead of Python TSS: PyThread_tss_get ends up in
+   pthread_getspecific (a library call) where a plain TLS load suffices.  The
+   flag is per-thread state with no shared-memory traffic at all.  Defined in
+   _memalloc.c.
+
+   C11 _Thread_local is preferred; the compiler-specific spellings cover MSVC
+   and pre-C11 GCC/Clang.  Every platform this module builds for has native
+   TLS, so no Python-TSS fallback is kept. */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define MEMALLOC_TLS _Thread_local
+#elif defined(_MSC_VER)
+#define MEMALLOC_TLS __declspec(thread)
 #else
-extern int memalloc_reentrant_key;
+#define MEMALLOC_TLS __thread
 #endif
 
-/* Any non-NULL pointer can be used */
-#define _MEMALLOC_REENTRANT_VALUE Py_True
+extern MEMALLOC_TLS bool _memalloc_reentrant_flag;
 
 static inline void
 memalloc_set_reentrant(bool reentrant)
 {
-    if (reentrant)
-#ifdef _PY37_AND_LATER
-        PyThread_tss_set(&memalloc_reentrant_key, _MEMALLOC_REENTRANT_VALUE);
-#else
-        PyThread_set_key_value(memalloc_reentrant_key, _MEMALLOC_REENTRANT_VALUE);
-#endif
-    else
-#ifdef _PY37_AND_LATER
-        PyThread_tss_set(&memalloc_reentrant_key, NULL);
-#else
-        PyThread_set_key_value(memalloc_reentrant_key, NULL);
-#endif
+    _memalloc_reentrant_flag = reentrant;
 }
 
 static inline bool
 memalloc_get_reentrant(void)
 {
-#ifdef _PY37_AND_LATER
-    if (PyThread_tss_get(&memalloc_reentrant_key))
-#else
-    if (PyThread_get_key_value(memalloc_reentrant_key))
-#endif
-        return true;
-
-    return false;
+    return _memalloc_reentrant_flag;
 }
 
 #endif
@@ -18,6 +18,167 @@ static PyObject* empty_string = NULL;
 
 #define TRACEBACK_SIZE(NFRAME) (sizeof(traceback_t) + sizeof(frame_t) * (NFRAME - 1))
 
+/* Arena of fixed-size traceback slots, so that capturing and evicting events
+   does not itself churn the allocator. Slots are carved out of slabs allocated
+   as the live set grows and recycled through a freelist, making capture
+   allocation-free at steady state. Every slot is prefixed with a pointer to
+   its owning arena; fallback allocations (taken when the arena is at capacity,
+   e.g. a large live heap-tracker set) carry a NULL prefix so traceback_free
+   can tell them apart.
+
+   The arena cannot be torn down eagerly in memalloc_tb_deinit: the iterator
+   returned by iter_events and the heap tracker may still hold tracebacks
+   pointing into it. Instead it is retired and freed once the last traceback
+   is returned. */
+
+#define TRACEBACK_ARENA_SLAB_SLOTS 64
+
+/* Byte accounting over all traceback storage (arena slabs, retired arenas
+   included, and fallback allocations), so the profiler's own footprint can be
+   capped at an absolute byte budget instead of an event count.  When the
+   budget would be exceeded, traceback_slot_alloc refuses to reserve more
+   memory and returns NULL; the event tracker reacts by evicting and
+   recycling a slot. */
+static size_t tb_bytes_reserved = 0;
+static size_t tb_bytes_high_water = 0;
+/* 0 means unbounded */
+static size_t tb_byte_budget = 0;
+
+static void
+tb_bytes_add(size_t bytes)
+{
+    tb_bytes_reserved += bytes;
+    if (tb_bytes_reserved > tb_bytes_high_water)
+        tb_bytes_high_water = tb_bytes_reserved;
+}
+
+size_t
+memalloc_tb_bytes_reserved(void)
+{
+    return tb_bytes_reserved;
+}
+
+size_t
+memalloc_tb_bytes_high_water(void)
+{
+    return tb_bytes_high_water;
+}
+
+typedef struct traceback_slab
+{
+    struct traceback_slab* next;
+    /* Slot storage follows the header */
+} traceback_slab_t;
+
+typedef struct
+{
+    /* Size of one slot, including the arena back-pointer prefix */
+    size_t slot_size;
+    /* Maximum number of slots we carve before falling back to PyMem_RawMalloc */
+    size_t slot_cap;
+    /* Number of slots carved so far */
+    size_t slot_count;
+    /* Number of slots currently handed out */
+    size_t in_use;
+    /* Set by memalloc_tb_deinit; the arena frees itself when in_use drops to 0 */
+    bool retired;
+    /* Free slots, linked through their first word */
+    void* freelist;
+    traceback_slab_t* slabs;
+} traceback_arena_t;
+
+static traceback_arena_t* traceback_arena = NULL;
+
+static void
+traceback_arena_destroy(traceback_arena_t* arena)
+{
+    size_t slab_bytes = sizeof(traceback_slab_t) + TRACEBACK_ARENA_SLAB_SLOTS * arena->slot_size;
+    traceback_slab_t* slab = arena->slabs;
+    while (slab) {
+        traceback_slab_t* next = slab->next;
+        PyMem_RawFree(slab);
+        tb_bytes_reserved -= slab_bytes;
+        slab = next;
+    }
+    PyMem_RawFree(arena);
+}
+
+static bool
+traceback_arena_grow(traceback_arena_t* arena)
+{
+    if (arena->slot_count >= arena->slot_cap)
+        return false;
+
+    size_t slab_bytes = sizeof(traceback_slab_t) + TRACEBACK_ARENA_SLAB_SLOTS * arena->slot_size;
+    if (tb_byte_budget && tb_bytes_reserved + slab_bytes > tb_byte_budget)
+        return false;
+
+    traceback_slab_t* slab = PyMem_RawMalloc(slab_bytes);
+    if (slab == NULL)
+        return false;
+    tb_bytes_add(slab_bytes);
+
+    slab->next = arena->slabs;
+    arena->slabs = slab;
+
+    char* slots = (char*)(slab + 1);
+    for (size_t i = 0; i < TRACEBACK_ARENA_SLAB_SLOTS; i++) {
+        void* slot = slots + i * arena->slot_size;
+        *(void**)slot = arena->freelist;
+        arena->freelist = slot;
+    }
+    arena->slot_count += TRACEBACK_ARENA_SLAB_SLOTS;
+
+    return true;
+}
+
+static traceback_t*
+traceback_slot_alloc(size_t traceback_size)
+{
+    traceback_arena_t* arena = traceback_arena;
+
+    if (arena && (arena->freelist || traceback_arena_grow(arena))) {
+        void* slot = arena->freelist;
+        arena->freelist = *(void**)slot;
+        arena->in_use++;
+        *(traceback_arena_t**)slot = arena;
+        return (traceback_t*)((char*)slot + sizeof(traceback_arena_t*));
+    }
+
+    /* Arena at capacity (or not initialized): fall back to the allocator */
+    size_t fallback_bytes = sizeof(traceback_arena_t*) + traceback_size;
+    if (tb_byte_budget && tb_bytes_reserved + fallback_bytes > tb_byte_budget)
+        return NULL;
+    void* mem = PyMem_RawMalloc(fallback_bytes);
+    if (mem == NULL)
+        return NULL;
+    tb_bytes_add(fallback_bytes);
+    *(traceback_arena_t**)mem = NULL;
+    return (traceback_t*)((char*)mem + sizeof(traceback_arena_t*));
+}
+
+static void
+traceback_slot_free(traceback_t* tb)
+{
+    void* slot = (char*)tb - sizeof(traceback_arena_t*);
+    traceback_arena_t* arena = *(traceback_arena_t**)slot;
+
+    if (arena == NULL) {
+        /* Fallback allocations are sized exactly for their frame count, so
+           the reserved bytes can be recomputed from the traceback itself */
+        tb_bytes_reserved -= sizeof(traceback_arena_t*) + TRACEBACK_SIZE(tb->nframe);
+        PyMem_RawFree(slot);
+        return;
+    }
+
+    *(void**)slot = arena->freelist;
+    arena->freelist = slot;
+    arena->in_use--;
+
+    if (arena->retired && arena->in_use == 0)
+        traceback_arena_destroy(arena);
+}
+
 static PyObject* ddframe_class = NULL;
 
 bool
@@ -52,8 +213,12 @@ memalloc_ddframe_class_init()
 }
 
 int
-memalloc_tb_init(uint16_t max_nframe)
+memalloc_tb_init(uint16_t max_nframe, uint16_t max_events, uint64_t max_bytes)
 {
+    /* Retired arenas from a previous run keep their bytes reserved until the
+       last borrowed traceback is returned; the budget applies to the total. */
+    tb_byte_budget = (size_t)max_bytes;
+
     if (unknown_name == NULL) {
         unknown_name = PyUnicode_FromString("<unknown>");
         if (unknown_name == NULL)
@@ -75,6 +240,27 @@ memalloc_tb_init(uint16_t max_nframe)
     if (traceback_buffer == NULL)
         return -1;
 
+    traceback_arena_t* arena = PyMem_RawMalloc(sizeof(traceback_arena_t));
+    if (arena == NULL) {
+        PyMem_RawFree(traceback_buffer);
+        traceback_buffer = NULL;
+        return -1;
+    }
+
+    /* Slots are sized for the largest traceback so any capture fits in any
+       slot. The cap is twice the event buffer: one buffer's worth of live
+       events, plus headroom for the reservoir's replace-before-evict step and
+       for the iterator holding the previous buffer while a new one fills. */
+    arena->slot_size = sizeof(traceback_arena_t*) + TRACEBACK_SIZE(max_nframe);
+    arena->slot_cap = 2 * (size_t)max_events;
+    arena->slot_count = 0;
+    arena->in_use = 0;
+    arena->retired = false;
+    arena->freelist = NULL;
+    arena->slabs = NULL;
+
+    traceback_arena = arena;
+
     return 0;
 }
 
@@ -82,60 +268,83 @@ void
 memalloc_tb_deinit(void)
 {
     PyMem_RawFree(traceback_buffer);
+    traceback_buffer = NULL;
+
+    traceback_arena_t* arena = traceback_arena;
+    traceback_arena = NULL;
+
+    if (arena) {
+        if (arena->in_use == 0)
+            traceback_arena_destroy(arena);
+        else
+            arena->retired = true;
+    }
 }
 
 void
 traceback_free(traceback_t* tb)
 {
-    for (uint16_t nframe = 0; nframe < tb->nframe; nframe++) {
-        Py_DECREF(tb->frames[nframe].filename);
-        Py_DECREF(tb->frames[nframe].name);
-    }
-    PyMem_RawFree(tb);
+    for (uint16_t nframe = 0; nframe < tb->nframe; nframe++)
+        Py_XDECREF(tb->frames[nframe].code);
+    Py_XDECREF(tb->export_tuple);
+    traceback_slot_free(tb);
 }
 
-/* Convert PyFrameObject to a frame_t that we can store in memory */
-static void
-memalloc_convert_frame(PyFrameObject* pyframe, frame_t* frame)
+/* FNV-1a over the frame array and the identity fields. frame_t is packed, so
+   hashing the raw frame bytes sees no padding; frames referencing the same
+   code objects hash (and compare) byte-identical. */
+static uint64_t
+traceback_hash(traceback_t* tb)
 {
-    int lineno = PyFrame_GetLineNumber(pyframe);
-    if (lineno < 0)
-        lineno = 0;
+    uint64_t hash = 0xcbf29ce484222325ULL;
 
-    frame->lineno = (unsigned int)lineno;
+#define HASH_BYTES(PTR, LEN)                                                                                           \
+    do {                                                                                                               \
+        const unsigned char* bytes = (const unsigned char*)(PTR);                                                      \
+        for (size_t b = 0; b < (LEN); b++)                                                                             \
+            hash = (hash ^ bytes[b]) * 1099511628211ULL;                                                               \
+    } while (0)
 
-    PyObject *filename, *name;
+    HASH_BYTES(tb->frames, tb->nframe * sizeof(frame_t));
+    HASH_BYTES(&tb->total_nframe, sizeof(tb->total_nframe));
+    HASH_BYTES(&tb->thread_id, sizeof(tb->thread_id));
+    HASH_BYTES(&tb->domain, sizeof(tb->domain));
 
-#ifdef _PY39_AND_LATER
-    PyCodeObject* code = PyFrame_GetCode(pyframe);
-#else
-    PyCodeObject* code = pyframe->f_code;
-#endif
-
-    if (code == NULL) {
-        filename = unknown_name;
-        name = unknown_name;
-    } else {
-        filename = code->co_filename;
-        name = code->co_name;
-    }
+#undef HASH_BYTES
 
-    if (name)
-        frame->name = name;
-    else
-        frame->name = unknown_name;
-
-    Py_INCREF(frame->name);
+    return hash;
+}
 
-    if (filename)
-        frame->filename = filename;
-    else
-        frame->filename = unknown_name;
+bool
+traceback_identical(const traceback_t* a, const traceback_t* b)
+{
+    return a->hash == b->hash && a->nframe == b->nframe && a->total_nframe == b->total_nframe &&
+           a->thread_id == b->thread_id && a->domain == b->domain &&
+           memcmp(a->frames, b->frames, a->nframe * sizeof(frame_t)) == 0;
+}
 
-    Py_INCREF(frame->filename);
+/* Convert PyFrameObject to a frame_t that we can store in memory.
 
+   This runs inside the traced allocation, so it does the bare minimum: a
+   reference to the code object and the instruction offset, a few pointer
+   stores.  Filename, function name and line number are resolved from those in
+   traceback_to_tuple, at export time: most sampled events are evicted before
+   they are ever exported, so resolving eagerly would be wasted work. */
+static void
+memalloc_convert_frame(PyFrameObject* pyframe, frame_t* frame)
+{
 #ifdef _PY39_AND_LATER
-    Py_XDECREF(code);
+    /* New reference */
+    frame->code = PyFrame_GetCode(pyframe);
+#else
+    frame->code = pyframe->f_code;
+    Py_XINCREF(frame->code);
+#endif
+
+#if PY_VERSION_HEX >= 0x030B0000
+    frame->lasti = PyFrame_GetLasti(pyframe);
+#else
+    frame->lasti = pyframe->f_lasti;
 #endif
 }
 
@@ -164,7 +373,7 @@ memalloc_frame_to_traceback(PyFrameObject* pyframe, uint16_t max_nframe)
     }
 
     size_t traceback_size = TRACEBACK_SIZE(traceback_buffer->nframe);
-    traceback_t* traceback = PyMem_RawMalloc(traceback_size);
+    traceback_t* traceback = traceback_slot_alloc(traceback_size);
 
     if (traceback)
         memcpy(traceback, traceback_buffer, traceback_size);
@@ -204,6 +413,11 @@ memalloc_get_traceback(uint16_t max_nframe, void* ptr, size_t size, PyMemAllocat
 #endif
 
     traceback->domain = domain;
+    traceback->count = 1;
+    traceback->lru_seq = 0;
+    traceback->heap_seq = 0;
+    traceback->export_tuple = NULL;
+    traceback->hash = traceback_hash(traceback);
 
     return traceback;
 }
@@ -211,6 +425,16 @@ memalloc_get_traceback(uint16_t max_nframe, void* ptr, size_t size, PyMemAllocat
 PyObject*
 traceback_to_tuple(traceback_t* tb)
 {
+    /* Long-lived tracebacks -- heap tracker entries above all -- are exported
+       again on every snapshot, so the conversion is done once and cached: a
+       big heap pays the GIL-held tuple construction only for tracebacks it
+       has not exported before.  The frames are immutable once captured, so
+       the cache never needs invalidating. */
+    if (tb->export_tuple) {
+        Py_INCREF(tb->export_tuple);
+        return tb->export_tuple;
+    }
+
     /* Convert stack into a tuple of tuple */
     PyObject* stack = PyTuple_New(tb->nframe);
 
@@ -218,12 +442,21 @@ traceback_to_tuple(traceback_t* tb)
         PyObject* frame_tuple = PyTuple_New(4);
 
         frame_t* frame = &tb->frames[nframe];
-
-        PyTuple_SET_ITEM(frame_tuple, 0, frame->filename);
-        Py_INCREF(frame->filename);
-        PyTuple_SET_ITEM(frame_tuple, 1, PyLong_FromUnsignedLong(frame->lineno));
-        PyTuple_SET_ITEM(frame_tuple, 2, frame->name);
-        Py_INCREF(frame->name);
+        PyCodeObject* code = frame->code;
+
+        /* Lazy resolution: frames only store the code object and instruction
+           offset, so names and line numbers are computed here, at export */
+        PyObject* filename = code && code->co_filename ? code->co_filename : unknown_name;
+        PyObject* name = code && code->co_name ? code->co_name : unknown_name;
+        int lineno = code ? PyCode_Addr2Line(code, frame->lasti) : 0;
+        if (lineno < 0)
+            lineno = 0;
+
+        PyTuple_SET_ITEM(frame_tuple, 0, filename);
+        Py_INCREF(filename);
+        PyTuple_SET_ITEM(frame_tuple, 1, PyLong_FromLong(lineno));
+        PyTuple_SET_ITEM(frame_tuple, 2, name);
+        Py_INCREF(name);
         /* Class name */
         PyTuple_SET_ITEM(frame_tuple, 3, empty_string);
         Py_INCREF(empty_string);
@@ -247,5 +480,9 @@ traceback_to_tuple(traceback_t* tb)
     PyTuple_SET_ITEM(tuple, 0, stack);
     PyTuple_SET_ITEM(tuple, 1, PyLong_FromUnsignedLong(tb->total_nframe));
     PyTuple_SET_ITEM(tuple, 2, PyLong_FromUnsignedLong(tb->thread_id));
+
+    tb->export_tuple = tuple;
+    Py_INCREF(tb->export_tuple);
+
     return tuple;
 }
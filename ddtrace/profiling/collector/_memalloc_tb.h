@@ -15,9 +15,10 @@ typedef struct
 #pragma pack(push, 4)
 #endif
 {
-    PyObject* filename;
-    PyObject* name;
-    unsigned int lineno;
+    /* Code object executing in this frame; names are resolved at export */
+    PyCodeObject* code;
+    /* Instruction offset in `code`, resolved to a line number at export */
+    int lasti;
 } frame_t;
 #if defined(_MSC_VER)
 #pragma pack(pop)
@@ -37,6 +38,19 @@ typedef struct
     PyMemAllocatorDomain domain;
     /* Thread ID */
     unsigned long thread_id;
+    /* Content hash of the frames, thread ID and domain */
+    uint64_t hash;
+    /* Number of sampled events this traceback stands for (1 unless merged) */
+    uint64_t count;
+    /* Allocation counter value the last time this traceback was captured or
+       merged into; used as the recency key when evicting under a byte budget */
+    uint64_t lru_seq;
+    /* Monotonic id assigned when the heap tracker records this allocation;
+       identifies the entry across incremental heap exports (0 when the entry
+       is not heap-tracked) */
+    uint64_t heap_seq;
+    /* Cached export tuple, built by the first traceback_to_tuple call */
+    PyObject* export_tuple;
     /* List of frames, top frame first */
     frame_t frames[1];
 } traceback_t;
@@ -48,13 +62,23 @@ bool
 memalloc_ddframe_class_init();
 
 int
-memalloc_tb_init(uint16_t max_nframe);
+memalloc_tb_init(uint16_t max_nframe, uint16_t max_events, uint64_t max_bytes);
 void
 memalloc_tb_deinit();
 
+/* Bytes currently reserved for traceback storage (arena slabs, fallback
+   allocations), and the highest that figure has reached in this process */
+size_t
+memalloc_tb_bytes_reserved(void);
+size_t
+memalloc_tb_bytes_high_water(void);
+
 void
 traceback_free(traceback_t* tb);
 
+bool
+traceback_identical(const traceback_t* a, const traceback_t* b);
+
 traceback_t*
 memalloc_get_traceback(uint16_t max_nframe, void* ptr, size_t size, PyMemAllocatorDomain domain);
 
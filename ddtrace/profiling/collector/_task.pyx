@@ -4,6 +4,9 @@ import weakref
 
 from wrapt.importer import when_imported
 
+from ddtrace.internal.datadog.profiling import stack_v2
+from ddtrace.settings.profiling import config
+
 from .. import _asyncio
 from .. import _threading
 
@@ -25,6 +28,8 @@ def install_greenlet_tracer(gevent):
         # We don't seem to have the required dependencies.
         return 
 
+    use_stack_v2 = config.stack.v2_enabled and stack_v2.is_available
+
     class DDGreenletTracer(object):
         def __init__(self, gevent):
             # type: (ModuleType) -> None
@@ -40,7 +45,23 @@ def install_greenlet_tracer(gevent):
                 greenlet,  # type: greenlet.greenlet
         ):
             # type: (...) -> None
-            self.greenlets[gevent.thread.get_ident(greenlet)] = greenlet
+            ident = gevent.thread.get_ident(greenlet)
+            first_seen = ident not in self.greenlets
+            self.greenlets[ident] = greenlet
+            if use_stack_v2:
+                # Register (or refresh) the greenlet with the native sampler.  gr_frame is
+                # None while the greenlet runs, which tells the sampler to unwind the live
+                # thread stack; a suspended greenlet is unwound from its saved frame.
+                stack_v2.track_greenlet(
+                    ident, _threading.get_thread_name(ident) or type(greenlet).__name__, greenlet.gr_frame
+                )
+                if first_seen:
+                    parent = getattr(greenlet, "parent", None)
+                    if parent is not None:
+                        stack_v2.link_greenlets(gevent.thread.get_ident(parent), ident)
+                    # Greenlet ids are memory addresses and get recycled; drop the native
+                    # entry with the object so a recycled id cannot inherit stale state.
+                    weakref.finalize(greenlet, stack_v2.untrack_greenlet, ident)
 
         def __call__(self, event, args):
             if event in ('switch', 'throw'):
@@ -51,6 +72,14 @@ def install_greenlet_tracer(gevent):
                     self.active_greenlet = args[1]
                     self._store_greenlet(args[1])
 
+                if use_stack_v2:
+                    # The origin greenlet just suspended.  The trace hook runs in the target,
+                    # so origin.gr_frame is already its saved stack top; publish it so the
+                    # sampler can unwind the greenlet while it waits (the Hub included --
+                    # the native side still needs to know the thread moved off it).
+                    origin = args[0]
+                    stack_v2.update_greenlet_frame(gevent.thread.get_ident(origin), origin.gr_frame)
+
             if self.previous_trace_function is not None:
                 self.previous_trace_function(event, args)
 
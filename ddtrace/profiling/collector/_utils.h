@@ -22,14 +22,20 @@ random_range(uint64_t max)
         (p) = PyMem_RawRealloc((p), sizeof(*p) * (count));                                                             \
     } while (0)
 
+/* The over-allocated size is computed in size_t: for arrays with narrow size
+   types (e.g. uint16_t counts) the 1.5x growth can exceed the type's range,
+   and assigning the truncated value back would shrink the allocation under a
+   nearly-full array.  Clamp to the size type's maximum instead; growth stops
+   there, which is as far as the count can go anyway. */
 #define p_grow(p, goalnb, allocnb)                                                                                     \
     do {                                                                                                               \
         if ((goalnb) > *(allocnb)) {                                                                                   \
-            if (p_alloc_nr(*(allocnb)) < (goalnb)) {                                                                   \
-                *(allocnb) = (goalnb);                                                                                 \
-            } else {                                                                                                   \
-                *(allocnb) = p_alloc_nr(*(allocnb));                                                                   \
-            }                                                                                                          \
+            size_t p_grow__nb = p_alloc_nr((size_t)*(allocnb));                                                        \
+            if (p_grow__nb < (size_t)(goalnb))                                                                         \
+                p_grow__nb = (size_t)(goalnb);                                                                         \
+            *(allocnb) = p_grow__nb;                                                                                   \
+            if ((size_t)*(allocnb) != p_grow__nb)                                                                      \
+                *(allocnb) = -1; /* unsigned size type: clamp to its maximum */                                        \
             p_realloc(p, *(allocnb));                                                                                  \
         }                                                                                                              \
     } while (0)
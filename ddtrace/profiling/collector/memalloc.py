@@ -73,7 +73,12 @@ class MemoryCollector(collector.PeriodicCollector):
         _max_events: Optional[int] = None,
         max_nframe: Optional[int] = None,
         heap_sample_size: Optional[int] = None,
+        events_per_sec: Optional[int] = None,
+        max_alloc_bytes: Optional[int] = None,
         ignore_profiler: Optional[bool] = None,
+        heap_diff_enabled: Optional[bool] = None,
+        histogram_enabled: Optional[bool] = None,
+        histogram_frames: Optional[int] = None,
         _export_libdd_enabled: Optional[bool] = None,
     ):
         super().__init__(recorder=recorder)
@@ -82,10 +87,22 @@ class MemoryCollector(collector.PeriodicCollector):
         self._max_events: int = _max_events if _max_events is not None else config.memory.events_buffer
         self.max_nframe: int = max_nframe if max_nframe is not None else config.max_frames
         self.heap_sample_size: int = heap_sample_size if heap_sample_size is not None else config.heap.sample_size
+        self.events_per_sec: int = events_per_sec if events_per_sec is not None else config.memory.events_per_sec
+        self.max_alloc_bytes: int = max_alloc_bytes if max_alloc_bytes is not None else config.memory.max_alloc_bytes
         self.ignore_profiler: bool = ignore_profiler if ignore_profiler is not None else config.ignore_profiler
+        self.heap_diff_enabled: bool = heap_diff_enabled if heap_diff_enabled is not None else config.heap.diff_enabled
+        self.histogram_enabled: bool = (
+            histogram_enabled if histogram_enabled is not None else config.memory.histogram_enabled
+        )
+        self.histogram_frames: int = (
+            histogram_frames if histogram_frames is not None else config.memory.histogram_frames
+        )
         self._export_libdd_enabled: bool = (
             _export_libdd_enabled if _export_libdd_enabled is not None else config.export.libdd_enabled
         )
+        # Live heap entries accumulated across incremental exports, keyed by the
+        # sequence id assigned by _memalloc. Only used when heap_diff_enabled.
+        self._heap_live: typing.Dict[int, typing.Any] = {}
 
     def _start_service(self):
         # type: (...) -> None
@@ -94,13 +111,24 @@ class MemoryCollector(collector.PeriodicCollector):
             raise collector.CollectorUnavailable
 
         try:
-            _memalloc.start(self.max_nframe, self._max_events, self.heap_sample_size)
+            _memalloc.start(
+                self.max_nframe, self._max_events, self.heap_sample_size, self.events_per_sec, self.max_alloc_bytes
+            )
         except RuntimeError:
             # This happens on fork because we don't call the shutdown hook since
             # the thread responsible for doing so is not running in the child
             # process. Therefore we stop and restart the collector instead.
             _memalloc.stop()
-            _memalloc.start(self.max_nframe, self._max_events, self.heap_sample_size)
+            _memalloc.start(
+                self.max_nframe, self._max_events, self.heap_sample_size, self.events_per_sec, self.max_alloc_bytes
+            )
+
+        if self.histogram_enabled:
+            _memalloc.set_histogram(self.histogram_frames)
+
+        # The C-side tracker starts from scratch; any accumulated incremental
+        # state refers to the previous tracker (e.g. the parent process').
+        self._heap_live.clear()
 
         super(MemoryCollector, self)._start_service()
 
@@ -127,7 +155,18 @@ class MemoryCollector(collector.PeriodicCollector):
         thread_id_ignore_set = self._get_thread_id_ignore_set()
 
         try:
-            events = _memalloc.heap()
+            if self.heap_diff_enabled and self._export_libdd_enabled:
+                # Incremental export: only entries allocated or freed since the
+                # last snapshot cross the C boundary; the live set is maintained
+                # here since exported profiles are reset every upload window.
+                new_entries, freed_seqs = _memalloc.heap_diff()
+                for seq in freed_seqs:
+                    self._heap_live.pop(seq, None)
+                for traceback, size, seq in new_entries:
+                    self._heap_live[seq] = (traceback, size)
+                events = list(self._heap_live.values())
+            else:
+                events = _memalloc.heap()
         except RuntimeError:
             # DEV: This can happen if either _memalloc has not been started or has been stopped.
             LOG.debug("Unable to collect heap events from process %d", os.getpid(), exc_info=True)
@@ -168,6 +207,33 @@ class MemoryCollector(collector.PeriodicCollector):
             )
 
     def collect(self):
+        if self.histogram_enabled and self.histogram_frames == 0 and self._export_libdd_enabled:
+            # Pure histogram mode: no tracebacks are captured at all, the
+            # size-class counters are the whole export. Counts are exact,
+            # so no upscaling; a synthetic frame names the size class.
+            try:
+                size_classes = _memalloc.histogram()
+            except RuntimeError:
+                LOG.debug("Unable to collect the size histogram from process %d", os.getpid(), exc_info=True)
+                return tuple()
+            for size_class, count, size in size_classes:
+                handle = ddup.SampleHandle()
+                handle.push_monotonic_ns(compat.monotonic_ns())
+                handle.push_alloc(size, count)
+                handle.push_frame(
+                    "<alloc %d-%d bytes>" % (2**size_class, 2 ** (size_class + 1) - 1),
+                    "<memory size histogram>",
+                    0,
+                    0,
+                )
+                handle.flush_sample()
+            return tuple()
+
+        # With shallow attribution (histogram_frames > 0) the sampled,
+        # frame-capped tracebacks below are the export; the native histogram
+        # keeps counting and stays available for programmatic drill-down, but
+        # exporting it too would double-count the allocations.
+
         # TODO: The event timestamp is slightly off since it's going to be the time we copy the data from the
         # _memalloc buffer to our Recorder. This is fine for now, but we might want to store the nanoseconds
         # timestamp in C and then return it via iter_events.
@@ -185,12 +251,17 @@ class MemoryCollector(collector.PeriodicCollector):
         thread_id_ignore_set = self._get_thread_id_ignore_set()
 
         if self._export_libdd_enabled:
-            for (frames, nframes, thread_id), size, _domain in events:
+            for (frames, nframes, thread_id), size, _domain, nevents in events:
                 if thread_id in thread_id_ignore_set:
                     continue
                 handle = ddup.SampleHandle()
                 handle.push_monotonic_ns(compat.monotonic_ns())
-                handle.push_alloc(int((ceil(size) * alloc_count) / count), count)  # Roundup to help float precision
+                # Entries are merged by traceback: size is the sum over the nevents allocations
+                # captured for this stack. Upscale both by the capture rate.
+                handle.push_alloc(
+                    int((ceil(size) * alloc_count) / count),  # Roundup to help float precision
+                    int(ceil((nevents * alloc_count) / count)),
+                )
                 handle.push_threadinfo(
                     thread_id, _threading.get_thread_native_id(thread_id), _threading.get_thread_name(thread_id)
                 )
@@ -216,7 +287,7 @@ class MemoryCollector(collector.PeriodicCollector):
                         capture_pct=capture_pct,
                         nevents=alloc_count,
                     )
-                    for (frames, nframes, thread_id), size, domain in events
+                    for (frames, nframes, thread_id), size, domain, nevents in events
                     if not self.ignore_profiler or thread_id not in thread_id_ignore_set
                 ),
             )
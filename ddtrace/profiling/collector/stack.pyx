@@ -296,9 +296,14 @@ cdef stack_collect(ignore_profiler, thread_time, max_nframes, interval, wall_tim
     # Also collect the native threads, that are not registered with the built-in
     # threading module, to keep backward compatibility with the previous
     # pure-Python implementation of periodic threads.
+    # periodic_threads is keyed by object identity since all the periodic
+    # tasks share a single native thread, so the ignore list is derived from
+    # the thread ID each task reports.
     thread_id_ignore_list = {
         thread_id
-        for thread_id, thread in chain(periodic_threads.items(), ddtrace_threading._active.items())
+        for thread_id, thread in chain(
+            ((t.ident, t) for t in periodic_threads.values()), ddtrace_threading._active.items()
+        )
         if getattr(thread, "_ddtrace_profiling_ignore", False)
     } if ignore_profiler else set()
 
@@ -536,6 +541,11 @@ class StackCollector(collector.PeriodicCollector):
             # itself, but it's a little bit fiddly and it's easier to make it correct here.
             # TODO take the `threading` import out of here and just handle it in v2 startup
             threading.init_stack_v2()
+            # Opt-in span-aware policy: threads without a span link are sampled at a
+            # fraction of the nominal rate, concentrating the budget on request-serving
+            # threads. Only meaningful when span linking is active, i.e. with a tracer.
+            if config.stack.v2_span_aware_enabled and self.tracer is not None:
+                stack_v2.set_span_aware_sampling(config.stack.v2_unlinked_sample_fraction)
             stack_v2.start()
 
     def _start_service(self):
@@ -242,6 +242,8 @@ class _ProfilerInstance(service.Service):
                     timeline_enabled=profiling_config.timeline_enabled,
                     output_filename=profiling_config.output_pprof,
                     sample_pool_capacity=profiling_config.sample_pool_capacity,
+                    helper_thread_niceness=profiling_config.helper_thread_niceness,
+                    helper_thread_cpu_affinity=profiling_config.helper_thread_cpu_affinity,
                     enable_code_provenance=profiling_config.code_provenance,
                 )
                 ddup.start()
@@ -1,5 +1,7 @@
 # -*- encoding: utf-8 -*-
 import logging
+import os
+import random
 from typing import Any  # noqa F401
 from typing import Callable
 from typing import Dict  # noqa F401
@@ -25,6 +27,11 @@ LOG = logging.getLogger(__name__)
 class Scheduler(periodic.PeriodicService):
     """Schedule export of recorded data."""
 
+    # The interval is adjusted on every run to account for the time spent
+    # exporting, so keep the schedule precise instead of letting the shared
+    # scheduler pull runs ahead of their deadline.
+    _slack = 0.0
+
     def __init__(
         self,
         recorder: Optional[Recorder] = None,
@@ -39,11 +46,21 @@ class Scheduler(periodic.PeriodicService):
         self._configured_interval: float = self.interval
         self._last_export: int = 0  # Overridden in _start_service
         self._export_libdd_enabled: bool = config.export.libdd_enabled
+        # Phase randomization. Workers forked together otherwise flush on the
+        # same cadence from the same instant, and their uploads hit the agent
+        # as one spike. Seeding with the PID makes the offset stable for this
+        # process while differing across forked workers (the profiler is
+        # rebuilt in the child, so the child re-derives from its own PID).
+        self._rng: random.Random = random.Random(os.getpid())
+        self._phase_offset: float = self._rng.uniform(0, self._configured_interval)
 
     def _start_service(self):
         # type: (...) -> None
         """Start the scheduler."""
         LOG.debug("Starting scheduler")
+        # First flush at the phase offset; periodic() then settles into the
+        # configured cadence, so processes stay spread across the cycle.
+        self.interval = self._phase_offset
         super(Scheduler, self)._start_service()
         self._last_export = compat.time_ns()
         LOG.debug("Scheduler started")
@@ -90,7 +107,13 @@ class Scheduler(periodic.PeriodicService):
         try:
             self.flush()
         finally:
-            self.interval = max(0, self._configured_interval - (compat.monotonic() - start_time))
+            interval = self._configured_interval - (compat.monotonic() - start_time)
+            if config.upload_jitter > 0:
+                # Per-cycle jitter keeps workers that drift into phase with each
+                # other (e.g. after an agent stall delays everyone's flush by
+                # the same amount) from staying aligned.
+                interval += self._configured_interval * self._rng.uniform(-config.upload_jitter, config.upload_jitter)
+            self.interval = max(0, interval)
 
 
 class ServerlessScheduler(Scheduler):
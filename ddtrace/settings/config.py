@@ -26,6 +26,7 @@ from ..internal.constants import DEFAULT_MAX_PAYLOAD_SIZE
 from ..internal.constants import DEFAULT_PROCESSING_INTERVAL
 from ..internal.constants import DEFAULT_REUSE_CONNECTIONS
 from ..internal.constants import DEFAULT_SAMPLING_RATE_LIMIT
+from ..internal.constants import DEFAULT_SPOOL_SIZE
 from ..internal.constants import DEFAULT_TIMEOUT
 from ..internal.constants import PROPAGATION_STYLE_ALL
 from ..internal.constants import PROPAGATION_STYLE_B3_SINGLE
@@ -443,6 +444,10 @@ class Config(object):
             "DD_TRACE_WRITER_REUSE_CONNECTIONS", DEFAULT_REUSE_CONNECTIONS, asbool
         )
         self._trace_writer_log_err_payload = _get_config("_DD_TRACE_WRITER_LOG_ERROR_PAYLOADS", False, asbool)
+        # Directory for the on-disk payload spool; unset disables spooling and
+        # payloads that cannot be sent are dropped as before
+        self._trace_writer_spool_dir = _get_config("DD_TRACE_WRITER_SPOOL_DIR")
+        self._trace_writer_spool_size = _get_config("DD_TRACE_WRITER_SPOOL_SIZE_BYTES", DEFAULT_SPOOL_SIZE, int)
 
         self._trace_agent_hostname = _get_config(["DD_AGENT_HOST", "DD_TRACE_AGENT_HOSTNAME"])
         self._trace_agent_port = _get_config(["DD_AGENT_PORT", "DD_TRACE_AGENT_PORT"])
@@ -135,6 +135,14 @@ def _check_for_injected():
     return _profiling_injected
 
 
+def _parse_cpu_list(raw: str):
+    try:
+        return [int(tok) for tok in raw.split(",") if tok.strip()]
+    except ValueError:
+        logger.warning("Invalid cpu list %r; ignoring", raw)
+        return []
+
+
 def _update_git_metadata_tags(tags):
     """
     Update profiler tags with git metadata
@@ -225,6 +233,17 @@ class ProfilingConfig(En):
         help="The interval in seconds to wait before flushing out recorded events",
     )
 
+    upload_jitter = En.v(
+        float,
+        "upload_jitter",
+        default=0.05,
+        help_type="Float",
+        help="Per-cycle random jitter applied to the upload interval, as a fraction of the "
+        "interval. Together with the per-process phase offset this keeps uploads from "
+        "workers started together spread across the cycle instead of hitting the agent "
+        "at the same instant. Set to 0 for a strict cadence.",
+    )
+
     capture_pct = En.v(
         float,
         "capture_pct",
@@ -313,6 +332,27 @@ class ProfilingConfig(En):
         "and deallocating Sample objects.",
     )
 
+    helper_thread_niceness = En.v(
+        t.Optional[int],
+        "helper_thread_niceness",
+        default=None,
+        help_type="Integer",
+        help="Niceness (-20 to 19) applied to the profiler's native helper threads (sampler, flush, "
+        "upload). Higher values make the helpers yield to application threads. By default the "
+        "flush and upload helpers already run at niceness 10 and the sampler at normal priority.",
+    )
+
+    helper_thread_cpu_affinity = En.v(
+        list,
+        "helper_thread_cpu_affinity",
+        parser=_parse_cpu_list,
+        default=[],
+        help_type="String",
+        help="Comma-separated list of CPU ids (e.g. ``14,15``) the profiler's native helper threads "
+        "are confined to, so profiling overhead stays off latency-critical cores. By default the "
+        "helpers can run on any core.",
+    )
+
 
 class ProfilingConfigStack(En):
     __item__ = __prefix__ = "stack"
@@ -333,8 +373,30 @@ class ProfilingConfigStack(En):
         help="Whether to enable the v2 stack profiler. Also enables the libdatadog collector.",
     )
 
-    # V2 can't be enabled if stack collection is disabled or if pre-requisites are not met
-    v2_enabled = En.d(bool, lambda c: _check_for_stack_v2_available() and c._v2_enabled and c.enabled)
+    # V2 can't be enabled if stack collection is disabled or if pre-requisites are not met.
+    # Check the configuration knobs first: probing for availability imports the native
+    # modules, which is too expensive to pay at import time when the feature is off.
+    v2_enabled = En.d(bool, lambda c: c._v2_enabled and c.enabled and _check_for_stack_v2_available())
+
+    v2_span_aware_enabled = En.v(
+        bool,
+        "v2_span_aware_enabled",
+        default=False,
+        help_type="Boolean",
+        help="Whether the v2 stack profiler should concentrate its sampling budget on threads "
+        "carrying active spans, sampling the remaining threads at a reduced rate. Only "
+        "effective with the v2 stack profiler.",
+    )
+
+    v2_unlinked_sample_fraction = En.v(
+        float,
+        "v2_unlinked_sample_fraction",
+        default=0.25,
+        help_type="Float",
+        help="Fraction of the nominal sampling rate applied to threads without an active span "
+        "when span-aware sampling is enabled. Wall time is preserved exactly; only the "
+        "unwind frequency of span-less threads is reduced.",
+    )
 
 
 class ProfilingConfigLock(En):
@@ -377,6 +439,48 @@ class ProfilingConfigMemory(En):
         help="",
     )
 
+    events_per_sec = En.v(
+        int,
+        "events_per_sec",
+        default=0,
+        help_type="Integer",
+        help="Target number of allocation events captured per second. When positive, the sampling rate "
+        "adapts to the allocation throughput to stay within this budget, weighting each captured event "
+        "by the allocations it stands for. When 0, every allocation is considered for capture.",
+    )
+
+    max_alloc_bytes = En.v(
+        int,
+        "max_alloc_bytes",
+        default=0,
+        help_type="Integer",
+        help="Maximum memory, in bytes, the memory profiler may use to store allocation tracebacks. "
+        "When positive, the least recently seen events are evicted when a new capture would exceed "
+        "the budget, with the statistical weight of evicted events corrected for. When 0, storage "
+        "is only bounded by the event count cap.",
+    )
+
+    histogram_enabled = En.v(
+        bool,
+        "histogram_enabled",
+        default=False,
+        help_type="Boolean",
+        help="Whether to run the allocation profiler in size-class histogram mode: every allocation "
+        "is binned into power-of-two size-class counters instead of capturing tracebacks, for a "
+        "fraction of the overhead. Exported allocation samples then carry a synthetic frame naming "
+        "the size class instead of a stack.",
+    )
+
+    histogram_frames = En.v(
+        int,
+        "histogram_frames",
+        default=0,
+        help_type="Integer",
+        help="Number of top frames (at most 2) attributed to sampled allocations in histogram mode. "
+        "When 0, histogram mode captures no tracebacks at all; when 1 or 2, sampled allocations are "
+        "additionally captured with that many frames and exported in place of the raw histogram.",
+    )
+
 
 class ProfilingConfigHeap(En):
     __item__ = __prefix__ = "heap"
@@ -398,6 +502,15 @@ class ProfilingConfigHeap(En):
     )
     sample_size = En.d(int, _derive_default_heap_sample_size)
 
+    diff_enabled = En.v(
+        bool,
+        "diff_enabled",
+        default=False,
+        help_type="Boolean",
+        help="Whether to export the heap profile incrementally, transferring only entries "
+        "allocated or freed since the previous export instead of the whole live set",
+    )
+
 
 class ProfilingConfigExport(En):
     __item__ = __prefix__ = "export"
@@ -509,6 +509,8 @@ if not IS_PYSTON:
         Extension(
             "ddtrace.internal._threads",
             sources=["ddtrace/internal/_threads.cpp"],
+            # For the shared coarse-clock header (dd_wrapper/include/coarse_clock.hpp)
+            include_dirs=["ddtrace/internal/datadog/profiling"],
             extra_compile_args=["-std=c++17", "-Wall", "-Wextra"] if CURRENT_OS != "Windows" else ["/std:c++20", "/MT"],
         ),
     ]
@@ -524,6 +526,14 @@ if not IS_PYSTON:
             )
         )
 
+        ext_modules.append(
+            Extension(
+                "ddtrace.internal._spool",
+                sources=["ddtrace/internal/_spool.c"],
+                extra_compile_args=debug_compile_args,
+            )
+        )
+
         ext_modules.append(CMakeExtension("ddtrace.appsec._iast._taint_tracking._native", source_dir=IAST_DIR))
 
     if (
@@ -151,3 +151,30 @@ def test_forksafe_awakeable_periodic_service():
     _, status = os.waitpid(pid, 0)
     exit_code = os.WEXITSTATUS(status)
     assert exit_code == 42
+
+
+def test_shutdown():
+    from ddtrace.internal import _threads
+
+    x = {}
+
+    started = [Event() for _ in range(4)]
+
+    def _on_shutdown():
+        x["DOWN"] = True
+
+    threads = [periodic.PeriodicThread(0.001, started[i].set, on_shutdown=_on_shutdown) for i in range(4)]
+    for t in threads:
+        t.start()
+    for e in started:
+        e.wait()
+
+    _threads.shutdown(timeout=5)
+
+    # All the threads have stopped so the joins return immediately
+    for t in threads:
+        t.join()
+
+    # This is the interpreter shutdown path, so the shutdown callbacks are
+    # not invoked
+    assert "DOWN" not in x
@@ -0,0 +1,113 @@
+import os
+
+import pytest
+
+
+_spool = pytest.importorskip("ddtrace.internal._spool")
+
+
+@pytest.fixture
+def spool_path(tmp_path):
+    return str(tmp_path / "test.spool")
+
+
+def test_append_peek_drop_fifo(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    try:
+        assert len(s) == 0
+        assert s.peek() is None
+        s.drop()  # no-op on an empty spool
+
+        assert s.append(b"payload-one", 3) == 0
+        assert s.append(b"payload-two", 7) == 0
+        assert len(s) == 2
+        assert s.peek() == (b"payload-one", 3)
+        s.drop()
+        assert s.peek() == (b"payload-two", 7)
+        s.drop()
+        assert len(s) == 0
+        assert s.size == 0
+    finally:
+        s.close()
+
+
+def test_eviction_is_oldest_first_across_wrap(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    try:
+        payloads = [(bytes([i % 256]) * (17 + 31 * (i % 11)), i) for i in range(200)]
+        evicted = sum(s.append(payload, count) for payload, count in payloads)
+        assert evicted > 0
+
+        survivors = []
+        while (record := s.peek()) is not None:
+            survivors.append(record)
+            s.drop()
+        # The survivors are exactly the newest payloads, still in order,
+        # even though the ring wrapped many times
+        assert survivors == payloads[len(payloads) - len(survivors) :]
+    finally:
+        s.close()
+
+
+def test_payload_larger_than_capacity(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    try:
+        with pytest.raises(ValueError):
+            s.append(b"x" * 8192, 1)
+        assert len(s) == 0
+    finally:
+        s.close()
+
+
+def test_records_survive_reopen(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    s.append(b"durable", 9)
+    s.close()
+
+    s = _spool.Spool(spool_path, 4096)
+    try:
+        assert s.peek() == (b"durable", 9)
+    finally:
+        s.close()
+
+
+def test_capacity_change_resets(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    s.append(b"stale", 1)
+    s.close()
+
+    s = _spool.Spool(spool_path, 8192)
+    try:
+        assert len(s) == 0
+    finally:
+        s.close()
+
+
+def test_corrupt_header_resets(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    s.append(b"record", 1)
+    s.close()
+
+    with open(spool_path, "r+b") as f:
+        f.seek(16)  # the head field
+        f.write((1 << 40).to_bytes(8, "little"))
+
+    s = _spool.Spool(spool_path, 4096)
+    try:
+        assert len(s) == 0
+    finally:
+        s.close()
+
+
+def test_clear_and_close(spool_path):
+    s = _spool.Spool(spool_path, 4096)
+    s.append(b"a", 1)
+    s.append(b"b", 2)
+    s.clear()
+    assert len(s) == 0
+    assert s.size == 0
+    s.close()
+    s.close()  # idempotent
+    with pytest.raises(ValueError):
+        s.append(b"x", 1)
+    assert os.path.exists(spool_path)
@@ -74,12 +74,13 @@ def test_iter_events():
     # Watchout: if we dropped samples the test will likely fail
 
     object_count = 0
-    for (stack, nframe, thread_id), size, domain in events:
+    for (stack, nframe, thread_id), size, domain, nevents in events:
         assert domain == "object"
         assert 0 < len(stack) <= max_nframe
         assert nframe >= len(stack)
         last_call = stack[0]
         assert size >= 1  # size depends on the object size
+        assert nevents >= 1
         if last_call == DDFrame(
             __file__,
             _ALLOC_LINE_NUMBER,
@@ -89,7 +90,8 @@ def test_iter_events():
             assert thread_id == threading.main_thread().ident
             if sys.version_info < (3, 12):
                 assert stack[1] == (__file__, _ALLOC_LINE_NUMBER, "_allocate_1k", "")
-            object_count += 1
+            # Identical tracebacks are merged into a single weighted entry
+            object_count += nevents
 
     assert object_count >= 1000
 
@@ -101,8 +103,46 @@ def test_iter_events_dropped():
     events, count, alloc_count = _memalloc.iter_events()
     _memalloc.stop()
 
-    assert count == 100
-    assert alloc_count >= 1000
+    # Identical tracebacks are merged into weighted entries, so a hot
+    # allocation site does not overflow a small buffer anymore: the entries
+    # stay within the buffer size while the captured count keeps up with the
+    # allocation count.
+    assert len(list(events)) <= 100
+    assert count >= 1000
+    assert alloc_count >= count
+
+
+def test_iter_events_rate_limited():
+    max_nframe = 32
+    _memalloc.start(max_nframe, 10000, 512 * 1024, 1)
+    for _ in range(10):
+        _allocate_1k()
+    events, count, alloc_count = _memalloc.iter_events()
+    _memalloc.stop()
+
+    # Whatever stride the rate controller settled on, each captured event
+    # carries the weight of the allocations it stands for, so the weights sum
+    # back to the captured count
+    assert alloc_count >= 10000
+    assert 0 < count <= alloc_count
+    assert sum(nevents for _, _, _, nevents in events) == count
+
+
+def test_iter_events_byte_budget():
+    max_nframe = 32
+    budget = 256 * 1024
+    _memalloc.start(max_nframe, 10000, 512 * 1024, 0, budget)
+    _allocate_1k()
+    stats = _memalloc.stats()
+    events, count, alloc_count = _memalloc.iter_events()
+    _memalloc.stop()
+
+    # Traceback storage stays within the byte budget, and evictions keep the
+    # captured count consistent with the weights of the surviving entries
+    assert 0 < stats["bytes_reserved"] <= budget
+    assert stats["bytes_high_water"] >= stats["bytes_reserved"]
+    assert sum(nevents for _, _, _, nevents in events) == count
+    assert alloc_count >= count
 
 
 def test_iter_events_not_started():
@@ -127,7 +167,7 @@ def test_iter_events_multi_thread():
 
     count_object = 0
     count_thread = 0
-    for (stack, nframe, thread_id), size, domain in events:
+    for (stack, nframe, thread_id), size, domain, nevents in events:
         assert domain == "object"
         assert 0 < len(stack) <= max_nframe
         assert nframe >= len(stack)
@@ -140,11 +180,11 @@ def test_iter_events_multi_thread():
             "",
         ):
             if thread_id == threading.main_thread().ident:
-                count_object += 1
+                count_object += nevents
                 if sys.version_info < (3, 12):
                     assert stack[1] == (__file__, _ALLOC_LINE_NUMBER, "_allocate_1k", "")
             elif thread_id == t.ident:
-                count_thread += 1
+                count_thread += nevents
                 entry = 2 if sys.version_info < (3, 12) else 1
                 assert stack[entry][0] == threading.__file__
                 assert stack[entry][1] > 0
@@ -74,3 +74,18 @@ def test_serverless_periodic(mock_periodic):
     assert s._profiled_intervals == 0
     assert s.interval == 1
     mock_periodic.assert_called()
+
+
+def test_upload_phase_offset():
+    r = recorder.Recorder()
+    s = scheduler.Scheduler(r, [exporter.NullExporter()], interval=60.0)
+    # The offset is derived from the PID: within the cycle, and stable for
+    # this process
+    assert 0 <= s._phase_offset <= 60.0
+    assert s._phase_offset == scheduler.Scheduler(r, [exporter.NullExporter()], interval=60.0)._phase_offset
+    s.start()
+    try:
+        # The first flush is scheduled at the phase offset
+        assert s.interval == s._phase_offset
+    finally:
+        s.stop()
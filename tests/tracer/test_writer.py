@@ -676,6 +676,30 @@ def test_flush_queue_raise(writer_class):
             writer.flush_queue(raise_exc=True)
 
 
+def test_spool_on_failure_and_drain_on_recovery(tmp_path):
+    pytest.importorskip("ddtrace.internal._spool")
+    with override_global_config(dict(_trace_writer_spool_dir=str(tmp_path))):
+        writer = AgentWriter("http://dne:1234", sync_mode=True)
+        assert writer._spool is not None
+        spool_path = writer._spool_path
+
+        # The agent is unreachable: the payload must be parked, not dropped
+        writer.write([Span("name")])
+        assert len(writer._spool) == 1
+
+        # The agent comes back: the next flush replays the spooled payload
+        writer._send_payload_with_backoff = mock.Mock()
+        writer.write([Span("other")])
+        assert len(writer._spool) == 0
+        # The fresh payload plus the spooled one
+        assert writer._send_payload_with_backoff.call_count == 2
+
+        # Shutdown removes the now-empty spool file
+        writer.on_shutdown()
+        assert writer._spool is None
+        assert not os.path.exists(spool_path)
+
+
 @pytest.mark.parametrize("writer_class", (AgentWriter,))
 def test_racing_start(writer_class):
     writer = writer_class("http://dne:1234")
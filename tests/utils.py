@@ -149,6 +149,8 @@ def override_global_config(values):
         "_trace_writer_interval_seconds",
         "_trace_writer_connection_reuse",
         "_trace_writer_log_err_payload",
+        "_trace_writer_spool_dir",
+        "_trace_writer_spool_size",
         "_span_traceback_max_size",
         "_propagation_http_baggage_enabled",
         "_telemetry_enabled",